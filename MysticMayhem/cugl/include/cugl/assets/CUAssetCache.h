@@ -0,0 +1,328 @@
+//
+//  CUAssetCache.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an on-disk cache of decoded assets. Decoding a PNG,
+//  rasterizing a font atlas, or decompressing an OGG is the bulk of the work
+//  of loading an asset, and it produces the same result every launch. This
+//  cache stores that result in the save directory, so that a warm start only
+//  has to read it back.
+//
+//  Entries are content addressed. The key is a hash of the source file
+//  together with the loader settings that affect the result. Changing either
+//  changes the key, so there is no need to invalidate anything. Entries are
+//  memory mapped when read, and validated against their header and checksum
+//  before use. An entry that fails validation is deleted and treated as a
+//  miss.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#ifndef __CU_ASSET_CACHE_H__
+#define __CU_ASSET_CACHE_H__
+#include <cugl/base/CUBase.h>
+#include <cugl/io/CUMappedFile.h>
+#include <initializer_list>
+#include <string>
+#include <memory>
+#include <atomic>
+
+namespace cugl {
+
+/**
+ * This class is an on-disk cache of decoded assets.
+ *
+ * A loader with an attached cache computes a key with {@link #getKey} before
+ * decoding an asset. If {@link #read} finds an entry for that key, the loader
+ * rebuilds the asset from the entry. Otherwise, it decodes the asset as usual
+ * and stores the result with {@link #write}. The payload of an entry is up to
+ * the loader; the cache only guarantees that it gets back exactly the bytes
+ * it wrote. Payloads are stored in native byte order, as the cache is never
+ * shared between devices.
+ *
+ * The cache lives in a directory of the save directory. It is safe to delete
+ * this directory (or call {@link #clear}) at any time the game is not
+ * loading; the next launch simply rebuilds the entries.
+ *
+ * Entries are never invalidated, so the entries of old versions of an asset
+ * stay behind. To bound this, the cache has a size limit. It is checked with
+ * {@link #prune} when the cache is initialized, and if the directory is over
+ * the limit, every entry is deleted. As entries are content addressed, there
+ * is no way to tell the stale ones from the live ones, and the live ones are
+ * rebuilt on the next launch anyway.
+ *
+ * The read and write methods are thread safe, and are intended to be called
+ * from the asset loader worker threads.
+ */
+class AssetCache {
+public:
+    /**
+     * This enum identifies the kind of asset stored in an entry.
+     *
+     * The kind is recorded in the entry header, so that an entry is never
+     * mistaken for that of another loader.
+     */
+    enum class Kind : Uint32 {
+        /** Decoded texture pixels */
+        TEXTURE = 1,
+        /** A font atlas with its glyph metrics */
+        FONT    = 2,
+        /** In-memory audio samples */
+        SOUND   = 3
+    };
+
+    /** The default limit on the size of the cache directory (in bytes) */
+    static const Uint64 DEFAULT_LIMIT;
+
+    /**
+     * This class is a single entry read from the cache.
+     *
+     * The payload points into the mapped cache file, which this object keeps
+     * open. The payload is valid as long as this object is.
+     */
+    class Entry {
+    public:
+        /** The mapped cache file */
+        std::shared_ptr<MappedFile> file;
+        /** The start of the payload (16 byte aligned) */
+        const Uint8* data;
+        /** The number of bytes in the payload */
+        size_t size;
+    };
+
+    /**
+     * This class is a segment of a payload to write.
+     *
+     * A payload is written as a list of segments so that a loader can store
+     * a header and a pixel buffer (for example) without copying them into a
+     * single buffer first.
+     */
+    class Segment {
+    public:
+        /** The start of the segment */
+        const void* data;
+        /** The number of bytes in the segment */
+        size_t size;
+    };
+
+private:
+    /** The (full) path of the cache directory, ending in a separator */
+    std::string _directory;
+    /** The size (in bytes) above which the entries are deleted */
+    Uint64 _limit;
+    /** A counter to give every temporary file a unique name */
+    std::atomic<Uint32> _writes;
+    /** The number of reads that found a valid entry */
+    std::atomic<Uint32> _hits;
+    /** The number of reads that did not */
+    std::atomic<Uint32> _misses;
+
+    /**
+     * Returns the path of the entry with the given key
+     *
+     * @param key   The entry key
+     *
+     * @return the path of the entry with the given key
+     */
+    std::string getPath(Uint64 key) const;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates a degenerate cache with no directory.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    AssetCache();
+
+    /**
+     * Deletes this cache, releasing all resources.
+     *
+     * The entries on disk are not affected.
+     */
+    ~AssetCache() { dispose(); }
+
+    /**
+     * Releases this cache. The entries on disk are not affected.
+     *
+     * This object may be safely reinitialized.
+     */
+    void dispose();
+
+    /**
+     * Initializes a cache in the given directory.
+     *
+     * If the directory is a relative path, it is relative to the application
+     * save directory {@see Application#getSaveDirectory()}. The directory is
+     * created if it does not exist. If it exists, it is pruned to the given
+     * size limit.
+     *
+     * @param directory The cache directory
+     * @param limit     The size limit of the cache directory (in bytes)
+     *
+     * @return true if the cache is initialized properly, false otherwise.
+     */
+    bool init(const std::string& directory, Uint64 limit=DEFAULT_LIMIT);
+
+    /**
+     * Returns a newly allocated cache in the given directory.
+     *
+     * If the directory is a relative path, it is relative to the application
+     * save directory {@see Application#getSaveDirectory()}. The directory is
+     * created if it does not exist. If it exists, it is pruned to the given
+     * size limit.
+     *
+     * @param directory The cache directory
+     * @param limit     The size limit of the cache directory (in bytes)
+     *
+     * @return a newly allocated cache in the given directory.
+     */
+    static std::shared_ptr<AssetCache> alloc(const std::string& directory, Uint64 limit=DEFAULT_LIMIT) {
+        std::shared_ptr<AssetCache> result = std::make_shared<AssetCache>();
+        return (result->init(directory,limit) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Cache Access
+    /**
+     * Returns the key for the given source file and loader settings.
+     *
+     * The key is a hash of the file contents and the settings string. The
+     * settings should include everything that affects the decoded result
+     * (such as the pixel format or the font size), together with a version
+     * number for the payload layout. This method returns 0 if the file
+     * cannot be read; 0 is never a valid key.
+     *
+     * @param file      The (full) path to the source file
+     * @param settings  The loader settings
+     *
+     * @return the key for the given source file and loader settings.
+     */
+    Uint64 getKey(const std::string& file, const std::string& settings) const;
+
+    /**
+     * Returns true if there is a valid entry for the given key.
+     *
+     * If the entry exists but is not valid (because it was truncated, or it
+     * is of a different kind), it is deleted and this method returns false.
+     *
+     * @param key   The entry key
+     * @param kind  The kind of asset expected
+     * @param entry The entry to store the result
+     *
+     * @return true if there is a valid entry for the given key.
+     */
+    bool read(Uint64 key, Kind kind, Entry& entry);
+
+    /**
+     * Stores an entry with the given key, returning true on success.
+     *
+     * The payload is the concatenation of the segments. The entry is written
+     * to a temporary file and then renamed, so a concurrent (or interrupted)
+     * write never leaves a partial entry behind.
+     *
+     * @param key       The entry key
+     * @param kind      The kind of asset stored
+     * @param segments  The payload segments
+     *
+     * @return true if the entry was stored.
+     */
+    bool write(Uint64 key, Kind kind, std::initializer_list<Segment> segments);
+
+    /**
+     * Deletes every entry in this cache.
+     *
+     * This method should not be called while assets are loading.
+     */
+    void clear();
+
+    /**
+     * Deletes every entry if the cache is over its size limit.
+     *
+     * This also deletes any temporary files left behind by an interrupted
+     * write. It returns the number of bytes used by the entries that remain.
+     * This method is called when the cache is initialized, and should not be
+     * called while assets are loading.
+     *
+     * @return the number of bytes used by the entries that remain.
+     */
+    Uint64 prune();
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns the (full) path of the cache directory.
+     *
+     * @return the (full) path of the cache directory.
+     */
+    const std::string& getDirectory() const { return _directory; }
+
+    /**
+     * Returns the size (in bytes) above which the entries are deleted.
+     *
+     * @return the size (in bytes) above which the entries are deleted.
+     */
+    Uint64 getLimit() const { return _limit; }
+
+    /**
+     * Returns the number of reads that found a valid entry.
+     *
+     * @return the number of reads that found a valid entry.
+     */
+    Uint32 getHits() const { return _hits.load(); }
+
+    /**
+     * Returns the number of reads that did not find a valid entry.
+     *
+     * @return the number of reads that did not find a valid entry.
+     */
+    Uint32 getMisses() const { return _misses.load(); }
+
+    /**
+     * Returns a 64 bit hash of the given data.
+     *
+     * This hash is not cryptographic. It is only intended to detect changes
+     * to a file, and corruption of a cache entry.
+     *
+     * @param data  The data to hash
+     * @param size  The number of bytes to hash
+     * @param seed  The initial hash value
+     *
+     * @return a 64 bit hash of the given data.
+     */
+    static Uint64 hash(const void* data, size_t size, Uint64 seed=0);
+};
+
+}
+#endif /* __CU_ASSET_CACHE_H__ */
@@ -51,7 +51,10 @@
 #include <cugl/util/CUDebug.h>
 #include <cugl/assets/CULoader.h>
 #include <typeinfo>
-#include <atomic>
+#include <functional>
+#include <vector>
+#include <map>
+#include <cstdint>
 
 
 namespace cugl {
@@ -77,6 +80,40 @@ namespace cugl {
  * still be used after an asset manager is destroyed, provided that they still
  * have a smart pointer referencing them.
  *
+ * Asynchronous loads share a pool of worker threads, sized to the number of
+ * cores by default. Independent assets are decoded in parallel, so there is
+ * no guarantee on the order in which they finish. If an asset is built from
+ * other assets (e.g. a scene graph from its textures), it must be given a
+ * {@link Dependency} on each of them. The asset is not queued for loading
+ * until all of its dependencies have finished. Asset directories add these
+ * dependencies for scene graphs automatically.
+ *
+ * A scene graph in an asset directory may also have an integer "priority"
+ * attribute. The textures it depends on are then uploaded ahead of those with
+ * a lower priority (see {@link TextureLoader#setPriority}). Give the first
+ * visible scene the highest priority so that it is ready as soon as possible.
+ *
+ * An asset manager may also have an {@link AssetCache}. The texture, font, and
+ * sound loaders store their decoded assets in this cache, so that later
+ * launches read the decoded result instead of decoding the source again.
+ *
+ * An asset directory may also declare asset groups in a "groups" entry. Each
+ * group lists the keys of its assets by category, as in
+ *
+ *      "groups": {
+ *          "menu": { "textures": ["title", "play"], "scene2s": ["menu"] }
+ *      }
+ *
+ * The assets in a group are not loaded with the rest of the directory.
+ * Instead, each one is loaded the first time that {@link #get} asks for it,
+ * or ahead of time with {@link #prefetch}. A scene should {@link #acquire}
+ * the groups that it uses, and {@link #release} them when it is done. Once
+ * no scene holds a group, its assets may be unloaded to make room for other
+ * assets. This happens whenever an asset is about to load and the assets
+ * held only by such idle groups exceed the memory budget. Groups are unloaded
+ * least recently used first. Assets outside of any group stay resident as
+ * before.
+ *
  * IMPORTANT: This class is not even remotely thread-safe.  Do not call any of
  * these methods outside of the main CUGL thread.
  */
@@ -85,18 +122,70 @@ private:
     /** This macro disables the copy constructor (not allowed on assets) */
     CU_DISALLOW_COPY_AND_ASSIGN(AssetManager);
     
+public:
+    /**
+     * A dependency on another asset.
+     *
+     * A dependency is the hash of the asset type together with the asset
+     * key. Use {@link AssetManager#dependency} to create one.
+     */
+    typedef std::pair<size_t,std::string> Dependency;
+
 #pragma mark Internal Helpers
 protected:
+    /** A load that must wait for other assets to finish */
+    typedef struct {
+        /** The assets that must finish before this load starts */
+        std::vector<Dependency> edges;
+        /** The function to start the load */
+        std::function<void()> task;
+    } Dependent;
+
     /** The individual loaders for each type */
     std::unordered_map<size_t,std::shared_ptr<BaseLoader>> _handlers;
-    /** The central thread for managing all of the loaders */
+    /** The worker threads shared by all of the loaders */
     std::shared_ptr<ThreadPool> _workers;
+    /** The decoded asset cache shared by all of the loaders (may be null) */
+    std::shared_ptr<AssetCache> _cache;
 
     /** State variable to manage reading JSON directories */
     bool _preload;
     
-    /** Wait variable to create a load barrier for directories. */
-    std::atomic<bool> _wait;
+    /** The loads waiting on their dependencies */
+    std::vector<Dependent> _dependents;
+    /** Whether the dependents are checked every animation frame */
+    bool _polling;
+    
+    /** An asset that is loaded on first access */
+    typedef struct {
+        /** The directory entry for the asset (nullptr if it has a source) */
+        std::shared_ptr<JsonValue> entry;
+        /** The directory declaring the asset (for the scene dependencies) */
+        std::shared_ptr<JsonValue> directory;
+        /** The source file for the asset (if there is no directory entry) */
+        std::string source;
+        /** The number of acquired groups that contain this asset */
+        Uint32 refs;
+    } Deferred;
+    
+    /** A named collection of assets that are loaded on first access */
+    typedef struct {
+        /** The assets in this group */
+        std::vector<Dependency> assets;
+        /** The number of times this group is acquired */
+        Uint32 refs;
+        /** When this group was last used (for the eviction order) */
+        Uint64 stamp;
+    } Group;
+    
+    /** The assets that are loaded on first access */
+    std::map<Dependency,Deferred> _deferred;
+    /** The asset groups declared by the asset directories */
+    std::unordered_map<std::string,Group> _groups;
+    /** The memory budget (in bytes) for the groups that are not acquired */
+    size_t _budget;
+    /** A counter to order the group releases */
+    Uint64 _clock;
 
     /**
      * Synchronously reads an asset category from a JSON file
@@ -115,6 +204,9 @@ protected:
      * contains an asset for which there is no attached asset manager, those 
      * specific assets will not be loaded.
      *
+     * Assets that belong to a group in the "groups" entry are skipped, as
+     * they are loaded on first access instead.
+     *
      * @param hash  The hash of the asset type
      * @param json  The child of asset directory with these assets
      *
@@ -139,6 +231,9 @@ protected:
      * contains an asset for which there is no attached asset manager, those
      * specific assets will not be loaded.
      *
+     * Assets that belong to a group in the "groups" entry are skipped, as
+     * they are loaded on first access instead.
+     *
      * As an asynchronous read, all asset loading will take place outside of
      * the main thread.  However, assets such as fonts and textures will need
      * the OpenGL context to complete, so part of their asset loading may take
@@ -173,32 +268,128 @@ protected:
     bool purgeCategory(size_t hash, const std::shared_ptr<JsonValue>& json);
 
     /**
-     * Synchronizes the asset manager to wait until all assets have finished.
+     * Returns the dependencies of a scene graph in an asset directory
+     *
+     * A scene graph depends on every texture, font or widget in the directory
+     * whose key appears as a string in the scene JSON. The contents of a
+     * widget are not known until it is loaded. So if the scene uses a widget,
+     * it also depends on all of the textures and fonts in the directory.
+     *
+     * @param scene     The JSON for the scene graph
+     * @param directory The JSON asset directory
+     *
+     * @return the dependencies of a scene graph in an asset directory
+     */
+    std::vector<Dependency> getDependencies(const std::shared_ptr<JsonValue>& scene,
+                                            const std::shared_ptr<JsonValue>& directory) const;
+
+    /**
+     * Assigns upload priorities to the textures of prioritized scene graphs
+     *
+     * A scene graph with an integer "priority" attribute passes that priority
+     * to every texture it depends on, unless the texture already has a higher
+     * one. This has no effect if the attached texture loader is not a
+     * {@link TextureLoader}.
      *
-     * This method is necessary for assets whose construction depends on
-     * previously loaded assets (e.g. scene graphs).  In the current architecture,
-     * this method is only correct if the asset manager loads assets in a
-     * single thread.
+     * @param directory The JSON asset directory
      */
-    void sync();
-    
+    void prioritize(const std::shared_ptr<JsonValue>& directory);
+
     /**
-     * Blocks the asset manager until the next animation frame.
+     * Returns true if the given dependency is still loading.
+     *
+     * A dependency on an asset that is not pending (because it has already
+     * loaded, it failed, or it was never requested) is resolved.
      *
-     * Any assets queued after a block will not be added to thread pool
-     * until at least one animation frame has passed.  This method is used
-     * to implement the {@link sync()} method.
+     * @param edge  The dependency to check
+     *
+     * @return true if the given dependency is still loading.
      */
-    void block();
+    bool isPending(const Dependency& edge) const;
 
     /**
-     * Resumes a previously blocked the asset manager.
+     * Starts the given load once all of its dependencies have finished.
+     *
+     * If the dependencies are already resolved, the load starts immediately.
+     * Otherwise it is checked at the start of each animation frame.
+     *
+     * @param edges The assets that must finish before the load starts
+     * @param task  The function to start the load
+     */
+    void defer(const std::vector<Dependency>& edges, const std::function<void()>& task);
+
+    /**
+     * Starts any deferred loads whose dependencies have finished.
+     *
+     * This method is scheduled with {@link Application#schedule}, and so it
+     * returns true as long as there are loads still waiting.
+     *
+     * @return true if there are loads still waiting on dependencies
+     */
+    bool resolve();
+    
+    /**
+     * Returns the type hash for the given asset directory category.
+     *
+     * This method returns 0 if the category name is not recognized.
+     *
+     * @param name  The category name (e.g. "textures")
+     *
+     * @return the type hash for the given asset directory category.
+     */
+    static size_t category(const std::string& name);
+    
+    /**
+     * Records the asset groups declared by the given asset directory.
+     *
+     * Every asset in a group is marked to load on first access, so that it
+     * is skipped when the rest of the directory is loaded.
+     *
+     * @param directory The JSON asset directory
+     */
+    void declareGroups(const std::shared_ptr<JsonValue>& directory);
+    
+    /**
+     * Returns true if the given asset is loaded on first access.
+     *
+     * @param hash  The hash of the asset type
+     * @param key   The asset key
+     *
+     * @return true if the given asset is loaded on first access.
+     */
+    bool isDeferred(size_t hash, const std::string& key) const {
+        return _deferred.find(Dependency(hash,key)) != _deferred.end();
+    }
+    
+    /**
+     * Synchronously loads an asset that is loaded on first access.
+     *
+     * The key may also belong to a descendant of a scene graph, or to a
+     * subtexture of an atlas. In that case, the parent asset is loaded. This
+     * method fails if the asset is unknown, already loaded, or still loading
+     * asynchronously.
      *
-     * Any assets queued after a block will not be added to thread pool
-     * until at least one animation frame has passed.  This method is used
-     * to implement the {@link sync()} method.
+     * @param hash  The hash of the asset type
+     * @param key   The asset key
+     *
+     * @return true if an asset was loaded
      */
-    void resume();
+    bool fetch(size_t hash, const std::string& key) const;
+    
+    /**
+     * Unloads groups that are not acquired until memory is within budget.
+     *
+     * The budget applies to {@link #getIdleMemory}, so the assets of the
+     * acquired groups do not count against it. Groups are unloaded least
+     * recently used first. An asset is never unloaded while an acquired
+     * group contains it, and a group is never unloaded while any of its
+     * assets are still loading.
+     *
+     * This method is called before any asset is loaded on first access,
+     * and so it must be const like {@link #get}. It only changes the state
+     * of the loaders.
+     */
+    void trim() const;
     
     
 #pragma mark -
@@ -210,7 +401,7 @@ public:
      * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an asset 
      * manager on the heap, use one of the static constructors instead.
      */
-    AssetManager() : _preload(false), _wait(false) {}
+    AssetManager() : _preload(false), _polling(false), _budget(SIZE_MAX), _clock(0) {}
     
     /**
      * Deletes this asset manager, disposing of all resources.
@@ -227,11 +418,12 @@ public:
     void dispose();
 
     /**
-     * Initializes a new asset manager with two auxiliary threads.
+     * Initializes a new asset manager with a thread for each spare core.
      *
-     * The asset manager will have a thread pool of size 2, giving it two 
-     * threads to load assets asynchronously.  These threads have no effect on 
-     * synchronous loading and will sleep when no assets are being loaded.
+     * The asset manager will have one thread for each core, less the core
+     * used by the main thread (but always at least one).  These threads have 
+     * no effect on synchronous loading and will sleep when no assets are 
+     * being loaded.
      *
      * This initializer does not attach any loaders.  It simply creates an 
      * object that is ready to accept loader objects.
@@ -240,63 +432,74 @@ public:
      */
     bool init();
 
-    //
-    // Initializes a new asset manager with the given number of auxiliary threads.
-    //
-    // The asset manager will have a thread pool of the given size, allowing it
-    // load assets asynchronously.  These threads have no effect on synchronous
-    // loading and will sleep when no assets are being loaded.  If threads is
-    // 0, all assets must be loaded synchronously.
-    //
-    // This initializer does not attach any loaders.  It simply creates an
-    // object that is ready to accept loader objects.
-    //
-    // @param threads   The number of threads for asynchronous loading
-    //
-    // @return true if the asset manager was initialized successfully
-    //
-    // TODO: This class must be refactored for this to be safe to use.
-    // bool init(unsigned int threads);
+    /**
+     * Initializes a new asset manager with the given number of auxiliary threads.
+     *
+     * The asset manager will have a thread pool of the given size, allowing it
+     * load assets asynchronously.  These threads have no effect on synchronous
+     * loading and will sleep when no assets are being loaded.  If threads is
+     * 0, all assets must be loaded synchronously.
+     *
+     * This initializer does not attach any loaders.  It simply creates an
+     * object that is ready to accept loader objects.
+     *
+     * @param threads   The number of threads for asynchronous loading
+     *
+     * @return true if the asset manager was initialized successfully
+     */
+    bool init(unsigned int threads);
     
 #pragma mark -
 #pragma mark Static Constructors
     /**
-     * Returns a newly allocated asset manager with two auxiliary threads.
+     * Returns a newly allocated asset manager with a thread for each spare core.
      *
-     * The asset manager will have a thread pool of size 2, giving it two
-     * threads to load assets asynchronously.  These threads have no effect on
-     * synchronous loading and will sleep when no assets are being loaded.
+     * The asset manager will have one thread for each core, less the core
+     * used by the main thread (but always at least one).  These threads have
+     * no effect on synchronous loading and will sleep when no assets are
+     * being loaded.
      *
      * This constructor does not attach any loaders.  It simply creates an
      * object that is ready to accept loader objects.
      *
-     * @return a newly allocated asset manager with two auxiliary threads.
+     * @return a newly allocated asset manager with a thread for each spare core.
      */
     static std::shared_ptr<AssetManager> alloc() {
         std::shared_ptr<AssetManager> result = std::make_shared<AssetManager>();
         return (result->init() ? result : nullptr);
     }
     
-    //
-    // Returns a newly allocated asset manager with the given number of auxiliary threads.
-    //
-    // The asset manager will have a thread pool of the given size, allowing it
-    // load assets asynchronously.  These threads have no effect on synchronous
-    // loading and will sleep when no assets are being loaded.  If threads is
-    // 0, all assets must be loaded synchronously.
-    //
-    // This constructor does not attach any loaders.  It simply creates an
-    // object that is ready to accept loader objects.
-    //
-    // @param threads   The number of threads for asynchronous loading
-    //
-    // @return a newly allocated asset manager with the given number of auxiliary threads.
-    //
-    // TODO: This class must be refactored for this to be safe to use.
-    // static std::shared_ptr<AssetManager> alloc(unsigned int threads) {
-    //     std::shared_ptr<AssetManager> result = std::make_shared<AssetManager>();
-    //     return (result->init(threads) ? result : nullptr);
-    // }
+    /**
+     * Returns a newly allocated asset manager with the given number of auxiliary threads.
+     *
+     * The asset manager will have a thread pool of the given size, allowing it
+     * load assets asynchronously.  These threads have no effect on synchronous
+     * loading and will sleep when no assets are being loaded.  If threads is
+     * 0, all assets must be loaded synchronously.
+     *
+     * This constructor does not attach any loaders.  It simply creates an
+     * object that is ready to accept loader objects.
+     *
+     * @param threads   The number of threads for asynchronous loading
+     *
+     * @return a newly allocated asset manager with the given number of auxiliary threads.
+     */
+    static std::shared_ptr<AssetManager> alloc(unsigned int threads) {
+        std::shared_ptr<AssetManager> result = std::make_shared<AssetManager>();
+        return (result->init(threads) ? result : nullptr);
+    }
+
+    /**
+     * Returns a dependency on the asset of type T with the given key.
+     *
+     * @param key   The key identifying the asset
+     *
+     * @return a dependency on the asset of type T with the given key.
+     */
+    template<typename T>
+    static Dependency dependency(const std::string& key) {
+        return Dependency(typeid(T).hash_code(),key);
+    }
 
 #pragma mark -
 #pragma mark Loader Management
@@ -321,6 +524,9 @@ public:
         }
         
         loader->setThreadPool(_workers);
+        if (_cache != nullptr) {
+            loader->setCache(_cache);
+        }
         _handlers[hash] = loader;
         loader->setManager(this);
         return true;
@@ -392,6 +598,31 @@ public:
         
         return std::dynamic_pointer_cast<Loader<T>>(it->second);
     }
+
+    /**
+     * Returns the decoded asset cache shared by the loaders
+     *
+     * If this value is nullptr, every asset is decoded from its source.
+     *
+     * @return the decoded asset cache shared by the loaders
+     */
+    std::shared_ptr<AssetCache> getCache() const { return _cache; }
+
+    /**
+     * Sets the decoded asset cache shared by the loaders
+     *
+     * The cache is given to every attached loader, and to every loader
+     * attached afterwards. It is unsafe to call this method while assets
+     * are loading.
+     *
+     * @param cache The decoded asset cache shared by the loaders
+     */
+    void setCache(const std::shared_ptr<AssetCache>& cache) {
+        _cache = cache;
+        for(auto it = _handlers.begin(); it != _handlers.end(); ++it) {
+            it->second->setCache(cache);
+        }
+    }
     
 #pragma mark -
 #pragma mark Progress Monitoring
@@ -416,7 +647,8 @@ public:
      * loading process has not yet finished. This method counts each asset
      * equally regardless of the memory requirements of each asset.
      *
-     * The value returned is the sum of the waitCount for all attached loaders.
+     * The value returned is the sum of the waitCount for all attached loaders,
+     * plus the number of loads still waiting on their dependencies.
      *
      * @return the number of assets waiting to load.
      */
@@ -450,6 +682,43 @@ public:
         size_t size = loadCount()+waitCount();
         return (size == 0 ? 0.0f : ((float)loadCount())/size);
     }
+    
+    /**
+     * Returns the number of bytes used by the assets of the given type.
+     *
+     * The type of the asset is specified by the template parameter T. This
+     * is an estimate of the memory held by the attached loader (see
+     * {@link BaseLoader#getMemoryUsage}). It is 0 if there is no loader for
+     * the type.
+     *
+     * @return the number of bytes used by the assets of the given type.
+     */
+    template<typename T>
+    size_t getMemoryUsage() const {
+        auto it = _handlers.find(typeid(T).hash_code());
+        return (it == _handlers.end() ? 0 : it->second->getMemoryUsage());
+    }
+    
+    /**
+     * Returns the number of bytes used by all of the loaded assets.
+     *
+     * This is the sum of the memory used by every attached loader.
+     *
+     * @return the number of bytes used by all of the loaded assets.
+     */
+    size_t getMemoryUsage() const;
+    
+    /**
+     * Returns the number of bytes used by the assets of idle groups.
+     *
+     * An idle group is one that is not acquired. This counts the loaded
+     * assets of the idle groups that no acquired group also contains, each
+     * asset once. These are the assets that may be unloaded, and this is the
+     * value compared against the memory budget.
+     *
+     * @return the number of bytes used by the assets of idle groups.
+     */
+    size_t getIdleMemory() const;
 
     
 #pragma mark -
@@ -461,6 +730,10 @@ public:
      * the method is parameterized by the type, it is safe to reuse keys for
      * different types.  However, this is not recommended.
      *
+     * If the asset belongs to a group, or was declared with {@link #declare},
+     * and is not yet loaded, it is loaded synchronously by this method. This
+     * method returns nullptr if the asset is still loading asynchronously.
+     *
      * @param  key  The key to identify the given asset
      *
      * @return the asset for the given key.
@@ -475,7 +748,11 @@ public:
         }
         
         std::shared_ptr<Loader<T>> loader = std::dynamic_pointer_cast<Loader<T>>(it->second);
-        return loader->get(key);
+        std::shared_ptr<T> result = loader->get(key);
+        if (result == nullptr && !_deferred.empty() && fetch(hash,key)) {
+            result = loader->get(key);
+        }
+        return result;
     }
     
     /**
@@ -721,6 +998,36 @@ public:
         loadAsync<T>(std::string(key),std::string(source),callback);
     }
     
+    /**
+     * Adds a new asset to the loading queue after its dependencies.
+     *
+     * This method is the same as {@link #loadAsync}, except that the asset is
+     * not queued until every asset in edges has finished loading (whether or
+     * not it was successful). Until then, the asset counts towards 
+     * {@link #waitCount}. Use this for assets whose preload accesses other 
+     * assets of this manager.
+     *
+     * @param key       The key to access the asset after loading
+     * @param source    The pathname to the asset source
+     * @param callback  An optional callback for when the asset is loaded.
+     * @param edges     The assets that must finish loading first
+     */
+    template<typename T>
+    void loadAsync(const std::string& key, const std::string& source, LoaderCallback callback,
+                   const std::vector<Dependency>& edges) {
+        size_t hash = typeid(T).hash_code();
+        auto it = _handlers.find(hash);
+        if (it != _handlers.end()) {
+            std::shared_ptr<BaseLoader> loader = it->second;
+            defer(edges,[=](void) {
+                loader->loadAsync(key,source,callback);
+            });
+            return;
+        }
+        
+        CUAssertLog(false, "No loader assigned for given type");
+    }
+    
     /**
      * Unloads the asset for the given key.
      *
@@ -780,6 +1087,136 @@ public:
         }
     }
     
+#pragma mark -
+#pragma mark Residency
+    /**
+     * Declares an asset that is loaded the first time it is accessed.
+     *
+     * The type of the asset is specified by the template parameter T. The
+     * asset is not loaded by this method. Instead, the first call to
+     * {@link #get} for this key loads it synchronously from the given source.
+     * If the asset is unloaded later, the next call to {@link #get} loads it
+     * again.
+     *
+     * @param  key      The key to access the asset after loading
+     * @param  source   The pathname to the asset source
+     */
+    template<typename T>
+    void declare(const std::string& key, const std::string& source) {
+        Deferred& asset = _deferred[Dependency(typeid(T).hash_code(),key)];
+        asset.entry = nullptr;
+        asset.directory = nullptr;
+        asset.source = source;
+    }
+    
+    /**
+     * Acquires the asset group with the given name.
+     *
+     * A group is acquired by the scenes that use it, and its assets are not
+     * unloaded until every acquire has a matching {@link #release}. This
+     * method does not load anything; the assets are loaded on first access
+     * (or by {@link #prefetch}).
+     *
+     * A scene should acquire all of its groups before accessing any assets.
+     * That way, the first asset load can evict the groups of the previous
+     * scene without touching those of this one.
+     *
+     * @param group The name of the asset group
+     *
+     * @return true if the group exists
+     */
+    bool acquire(const std::string& group);
+    
+    /**
+     * Releases the asset group with the given name.
+     *
+     * Once a group is released as many times as it was acquired, its assets
+     * may be unloaded to stay within the memory budget. This does not happen
+     * immediately, but the next time that an asset is loaded. Groups are
+     * unloaded least recently used first, so recently used groups are the
+     * most likely to stay resident.
+     *
+     * @param group The name of the asset group
+     *
+     * @return true if the group was acquired
+     */
+    bool release(const std::string& group);
+    
+    /**
+     * Asynchronously loads the assets of the given group.
+     *
+     * This is a hint that the group will be needed soon (such as the next
+     * scene). Prefetching does not acquire the group. If the group is not
+     * acquired before it is evicted, it is simply loaded again on access.
+     * If the group is not declared yet because an asset directory is still
+     * being read, the prefetch starts once it is read.
+     *
+     * The optional callback function will be called each time an individual
+     * asset loads or fails to load.
+     *
+     * @param group     The name of the asset group
+     * @param callback  An optional callback after each asset is loaded
+     *
+     * @return true if the group exists
+     */
+    bool prefetch(const std::string& group, LoaderCallback callback=nullptr);
+    
+    /**
+     * Returns true if no asset of the given group is still loading.
+     *
+     * Once this method is true, {@link #get} may safely be called on any
+     * asset in the group, as any asset that is not loaded is loaded on the
+     * spot.
+     *
+     * @param group The name of the asset group
+     *
+     * @return true if no asset of the given group is still loading.
+     */
+    bool isReady(const std::string& group) const;
+    
+    /**
+     * Returns true if the given group is acquired.
+     *
+     * @param group The name of the asset group
+     *
+     * @return true if the given group is acquired.
+     */
+    bool isAcquired(const std::string& group) const {
+        auto it = _groups.find(group);
+        return it != _groups.end() && it->second.refs > 0;
+    }
+    
+    /**
+     * Returns the memory budget in bytes.
+     *
+     * Groups that are not acquired are unloaded before an asset loads if
+     * {@link getIdleMemory} exceeds this budget. Acquired groups and assets
+     * outside of any group do not count against the budget, and are never
+     * unloaded. So the total {@link getMemoryUsage} is at most the budget
+     * plus the size of those assets. The default budget is unlimited, so
+     * groups stay resident once loaded.
+     *
+     * @return the memory budget in bytes.
+     */
+    size_t getMemoryBudget() const { return _budget; }
+    
+    /**
+     * Sets the memory budget in bytes.
+     *
+     * Groups that are not acquired are unloaded before an asset loads if
+     * {@link getIdleMemory} exceeds this budget. Acquired groups and assets
+     * outside of any group do not count against the budget, and are never
+     * unloaded. So the total {@link getMemoryUsage} is at most the budget
+     * plus the size of those assets. The default budget is unlimited, so
+     * groups stay resident once loaded.
+     *
+     * @param bytes The memory budget in bytes
+     */
+    void setMemoryBudget(size_t bytes) {
+        _budget = bytes;
+        trim();
+    }
+    
 #pragma mark -
 #pragma mark Directory Support
     /**
@@ -799,6 +1236,9 @@ public:
      * contains an asset for which there is no attached asset manager, those
      * specific assets will not be loaded.
      *
+     * Assets that belong to a group in the "groups" entry are skipped, as
+     * they are loaded on first access instead.
+     *
      * This method will try to load as many assets from the directory as it 
      * can.  If any asset fails to load, it will return false.  However, some
      * assets may still be loaded and safe to access.
@@ -826,6 +1266,9 @@ public:
      * contains an asset for which there is no attached asset manager, those
      * specific assets will not be loaded.
      *
+     * Assets that belong to a group in the "groups" entry are skipped, as
+     * they are loaded on first access instead.
+     *
      * This method will try to load as many assets from the directory as it
      * can.  If any asset fails to load, it will return false.  However, some
      * assets may still be loaded and safe to access.
@@ -853,6 +1296,9 @@ public:
      * contains an asset for which there is no attached asset manager, those
      * specific assets will not be loaded.
      *
+     * Assets that belong to a group in the "groups" entry are skipped, as
+     * they are loaded on first access instead.
+     *
      * This method will try to load as many assets from the directory as it
      * can.  If any asset fails to load, it will return false.  However, some
      * assets may still be loaded and safe to access.
@@ -882,6 +1328,9 @@ public:
      * contains an asset for which there is no attached asset manager, those
      * specific assets will not be loaded.
      *
+     * Assets that belong to a group in the "groups" entry are skipped, as
+     * they are loaded on first access instead.
+     *
      * As an asynchronous load, all asset loading will take place outside of
      * the main thread.  However, assets such as fonts and textures will need
      * the OpenGL context to complete, so part of their asset loading may take
@@ -916,6 +1365,9 @@ public:
      * contains an asset for which there is no attached asset manager, those
      * specific assets will not be loaded.
      *
+     * Assets that belong to a group in the "groups" entry are skipped, as
+     * they are loaded on first access instead.
+     *
      * As an asynchronous load, all asset loading will take place outside of
      * the main thread.  However, assets such as fonts and textures will need
      * the OpenGL context to complete, so part of their asset loading may take
@@ -950,6 +1402,9 @@ public:
      * contains an asset for which there is no attached asset manager, those
      * specific assets will not be loaded.
      *
+     * Assets that belong to a group in the "groups" entry are skipped, as
+     * they are loaded on first access instead.
+     *
      * As an asynchronous load, all asset loading will take place outside of
      * the main thread.  However, assets such as fonts and textures will need
      * the OpenGL context to complete, so part of their asset loading may take
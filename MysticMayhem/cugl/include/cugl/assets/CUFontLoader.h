@@ -66,6 +66,15 @@ namespace cugl {
  * {@link Application#schedule}.  This is a good template for asset loaders in
  * general.
  *
+ * Rasterizing the atlas is the expensive part of loading a font. If the
+ * loader has an {@link AssetCache}, the atlas is stored in it, and later
+ * loads of the same font with the same settings skip rasterization.
+ *
+ * A font entry may also ask for a distance field atlas. All distance field
+ * fonts of the same file and character set share a single atlas, which is
+ * rasterized once at a reference size. Hence a font that is loaded at many
+ * sizes only pays for rasterization once.
+ *
  * As with all of our loaders, this loader is designed to be attached to an
  * asset manager. Use the method {@link getHook()} to get the appropriate
  * pointer for attaching the loader.
@@ -80,6 +89,8 @@ protected:
     int _fontsize;
     /** The default atlas character set ("" for ASCII) */
     std::string _charset;
+    /** The distance field reference fonts, keyed by path and character set (not owned) */
+    std::unordered_map<std::string, std::weak_ptr<Font>> _fields;
     
 #pragma mark Asset Loading
     /**
@@ -90,13 +101,41 @@ protected:
      * Hence this method does the maximum amount of work that can be done in 
      * asynchronous font loading.
      *
+     * If there is an asset cache, the atlas image and glyph metrics are read
+     * from the cache when it has an entry for this font. Otherwise they are
+     * stored in the cache once the atlas is built.
+     *
+     * If distance is true, the font shares a distance field atlas with every
+     * other distance field font of the same file and character set. That atlas
+     * is rasterized once, at a reference size, and only the glyph metrics are
+     * computed for this size.
+     *
      * @param source    The pathname to the asset
      * @param charset   The atlas character set
      * @param size      The font size
+     * @param distance  Whether to use a distance field atlas
      *
      * @return the font asset with no generated atlas
      */
-    std::shared_ptr<Font> preload(const std::string& source, const std::string& charset, int size);
+    std::shared_ptr<Font> preload(const std::string& source, const std::string& charset,
+                                  int size, bool distance);
+    
+    /**
+     * Returns the distance field reference font for the given file
+     *
+     * The reference font is created (and its atlas built) the first time it is
+     * requested. It is shared by every distance field font with the same file
+     * and character set, regardless of their size. This loader does not own
+     * the reference font. It is released with the last font that shares it,
+     * and is built again (or read from the asset cache) if it is requested
+     * after that. The caller must hold the font lock.
+     *
+     * @param path      The (full) path to the font file
+     * @param charset   The atlas character set
+     *
+     * @return the distance field reference font for the given file
+     */
+    std::shared_ptr<Font> preloadField(const std::string& path, const std::string& charset);
     
     /**
      * Creates an atlas for the font asset, and assigns it the given key.
@@ -179,6 +218,7 @@ protected:
      *      "file":         The path to the asset
      *      "size":         This font size (int)
      *      "charset":      The set of characters for the font atlas (string)
+     *      "distance":     Whether to share a distance field atlas (bool)
      *
      * @param json      The directory entry for the asset
      * @param callback  An optional callback for asynchronous loading
@@ -188,6 +228,17 @@ protected:
      */
     bool read(const std::shared_ptr<JsonValue>& json, LoaderCallback callback, bool async) override;
     
+    /**
+     * Returns the number of bytes used by the font for the given key.
+     *
+     * This is the size of the font atlas texture. A distance field font
+     * reports the size of the atlas that it shares.
+     *
+     * @param key   The key associated with the font
+     *
+     * @return the number of bytes used by the font for the given key.
+     */
+    virtual size_t measure(const std::string& key) const override;
     
 public:
 #pragma mark -
@@ -213,6 +264,7 @@ public:
      */
     void dispose() override {
         _assets.clear();
+        _fields.clear();
         _loader = nullptr;
     }
 
@@ -487,6 +539,18 @@ public:
      * @param charset   The default atlas character set
      */
     void setCharacterSet(const std::string& charset) { _charset = charset; }
+    
+#pragma mark -
+#pragma mark Memory Usage
+    /**
+     * Returns the number of bytes used by all of the loaded fonts.
+     *
+     * This is the size of the font atlas textures. An atlas shared by
+     * several distance field fonts is only counted once.
+     *
+     * @return the number of bytes used by all of the loaded fonts.
+     */
+    size_t getMemoryUsage() const override;
 };
 
 }
@@ -47,6 +47,7 @@
 #include <cJSON/cJSON.h>
 #include <vector>
 #include <string>
+#include <string_view>
 
 namespace cugl {
 
@@ -108,6 +109,39 @@ public:
     
     /** The children of this node (only non-empty if array or object) */
     std::vector<std::shared_ptr<JsonValue>> _children;
+    /** The hash table of child positions (+1) by key (only for large objects) */
+    std::vector<Uint32> _index;
+
+#pragma mark -
+#pragma mark Key Index
+    /**
+     * Returns the position of the child with the given key (or -1 if none)
+     *
+     * Objects with many children use a hash index, while small objects are
+     * searched linearly. If there is more than one child with the key, this
+     * returns the first one.
+     *
+     * @param key   The key identifying the child
+     *
+     * @return the position of the child with the given key (or -1 if none)
+     */
+    int find(std::string_view key) const;
+
+    /**
+     * Rebuilds the hash index of the children
+     *
+     * This must be called whenever the children are reordered or rekeyed.
+     * The index is discarded if this node is not a large object.
+     */
+    void reindex();
+
+    /**
+     * Adds the last child to the hash index
+     *
+     * This should be called after appending a child. It is cheaper than
+     * a call to {@link #reindex}, unless the index must grow.
+     */
+    void indexLast();
 
 #pragma mark -
 #pragma mark cJSON Conversions
@@ -840,7 +874,20 @@ public:
      *
      * @return true if a child with the specified name exists.
      */
-    bool has(const std::string& name) const;
+    bool has(std::string_view name) const;
+    
+    /** 
+     * Returns true if a child with the specified name exists. 
+     *
+     * This method will always return false if the node is not an object type
+     *
+     * @param name  The key identifying the child
+     *
+     * @return true if a child with the specified name exists.
+     */
+    bool has(const std::string& name) const {
+        return has(std::string_view(name));
+    }
     
     /**
      * Returns true if a child with the specified name exists.
@@ -852,7 +899,7 @@ public:
      * @return true if a child with the specified name exists.
      */
     bool has(const char* name) const {
-        return has(std::string(name));
+        return has(std::string_view(name));
     }
 
     /**
@@ -891,7 +938,37 @@ public:
      *
      * @return the child with the specified key.
      */
-    std::shared_ptr<JsonValue> get(const std::string& name);
+    std::shared_ptr<JsonValue> get(std::string_view name);
+    
+    /** 
+     * Returns the child with the specified key.
+     *
+     * This method will fail if the node is not an object type. If there is no
+     * child with this key, the method returns nullptr.  If the node is somehow
+     * corrupted and there is more than one child of this name, it will return
+     * the first one.
+     *
+     * @param name  The key identifying the child.
+     *
+     * @return the child with the specified key.
+     */
+    std::shared_ptr<JsonValue> get(const std::string& name) {
+        return get(std::string_view(name));
+    }
+    
+    /**
+     * Returns the child with the specified key.
+     *
+     * This method will fail if the node is not an object type. If there is no
+     * child with this key, the method returns nullptr.  If the node is somehow
+     * corrupted and there is more than one child of this name, it will return
+     * the first one.
+     *
+     * @param name  The key identifying the child.
+     *
+     * @return the child with the specified key.
+     */
+    const std::shared_ptr<JsonValue> get(std::string_view name) const;
     
     /**
      * Returns the child with the specified key.
@@ -905,7 +982,9 @@ public:
      *
      * @return the child with the specified key.
      */
-    const std::shared_ptr<JsonValue> get(const std::string& name) const;
+    const std::shared_ptr<JsonValue> get(const std::string& name) const {
+        return get(std::string_view(name));
+    }
 
     /**
      * Returns the child with the specified key.
@@ -920,7 +999,7 @@ public:
      * @return the child with the specified key.
      */
     std::shared_ptr<JsonValue> get(const char* name) {
-        return get(std::string(name));
+        return get(std::string_view(name));
     }
     
     /**
@@ -936,7 +1015,7 @@ public:
      * @return the child with the specified key.
      */
     const std::shared_ptr<JsonValue> get(const char* name) const {
-        return get(std::string(name));
+        return get(std::string_view(name));
     }
     
     
@@ -956,7 +1035,43 @@ public:
      *
      * @return the string value of the child with the specified key.
      */
-    const std::string getString (const std::string& key, const std::string& defaultValue) const;
+    const std::string getString (std::string_view key, const std::string& defaultValue) const;
+    
+    /** 
+     * Returns the string value of the child with the specified key. 
+     *
+     * If there is no child with the given key, or if that child cannot be
+     * represented as a string value, it returns the default value instead.
+     *
+     * Note this is not the same behavior as get(key).asString(defaultValue),
+     * since it will not fail if the child is an array or object.
+     *
+     * @param key  			The key identifying the child.
+     * @param defaultValue  The value to use if child does not exist or is not a string
+     *
+     * @return the string value of the child with the specified key.
+     */
+    const std::string getString (std::string_view key, const char* defaultValue="") const {
+        return getString(key,std::string(defaultValue));
+    }
+    
+    /** 
+     * Returns the string value of the child with the specified key. 
+     *
+     * If there is no child with the given key, or if that child cannot be
+     * represented as a string value, it returns the default value instead.
+     *
+     * Note this is not the same behavior as get(key).asString(defaultValue),
+     * since it will not fail if the child is an array or object.
+     *
+     * @param key  			The key identifying the child.
+     * @param defaultValue  The value to use if child does not exist or is not a string
+     *
+     * @return the string value of the child with the specified key.
+     */
+    const std::string getString (const std::string& key, const std::string& defaultValue) const {
+        return getString(std::string_view(key),defaultValue);
+    }
     
     /**
      * Returns the string value of the child with the specified key.
@@ -973,7 +1088,7 @@ public:
      * @return the string value of the child with the specified key.
      */
     const std::string getString (const char* key, const char* defaultValue="") const {
-        return getString(std::string(key),std::string(defaultValue));
+        return getString(std::string_view(key),std::string(defaultValue));
     }
     
     /**
@@ -991,7 +1106,7 @@ public:
      * @return the string value of the child with the specified key.
      */
     const std::string getString (const std::string& key, const char* defaultValue="") const {
-        return getString(key,std::string(defaultValue));
+        return getString(std::string_view(key),std::string(defaultValue));
     }
     
     /**
@@ -1009,7 +1124,7 @@ public:
      * @return the string value of the child with the specified key.
      */
     const std::string getString (const char* key, const std::string& defaultValue) const {
-        return getString(std::string(key),defaultValue);
+        return getString(std::string_view(key),defaultValue);
     }
     
     /**
@@ -1026,7 +1141,25 @@ public:
      *
      * @return the float value of the child with the specified key.
      */
-    float getFloat(const std::string& key, float defaultValue=0.0f) const;
+    float getFloat(std::string_view key, float defaultValue=0.0f) const;
+    
+    /**
+     * Returns the float value of the child with the specified key.
+     *
+     * If there is no child with the given key, or if that child cannot be
+     * represented as a numeric value, it returns the default value instead.
+     *
+     * Note this is not the same behavior as get(key).asFloat(defaultValue),
+     * since it will not fail if the child is an array or object.
+     *
+     * @param key  			The key identifying the child.
+     * @param defaultValue  The value to use if child does not exist or is not a number
+     *
+     * @return the float value of the child with the specified key.
+     */
+    float getFloat(const std::string& key, float defaultValue=0.0f) const {
+        return getFloat(std::string_view(key),defaultValue);
+    }
     
     /**
      * Returns the float value of the child with the specified key.
@@ -1043,7 +1176,7 @@ public:
      * @return the float value of the child with the specified key.
      */
     float getFloat(const char* key, float defaultValue=0.0f) const {
-        return getFloat(std::string(key),defaultValue);
+        return getFloat(std::string_view(key),defaultValue);
     }
     
     /**
@@ -1060,7 +1193,25 @@ public:
      *
      * @return the double value of the child with the specified key.
      */
-    double getDouble(const std::string& key, double defaultValue=0.0) const;
+    double getDouble(std::string_view key, double defaultValue=0.0) const;
+    
+    /**
+     * Returns the double value of the child with the specified key.
+     *
+     * If there is no child with the given key, or if that child cannot be
+     * represented as a numeric value, it returns the default value instead.
+     *
+     * Note this is not the same behavior as get(key).asDouble(defaultValue),
+     * since it will not fail if the child is an array or object.
+     *
+     * @param key  			The key identifying the child.
+     * @param defaultValue  The value to use if child does not exist or is not a number
+     *
+     * @return the double value of the child with the specified key.
+     */
+    double getDouble(const std::string& key, double defaultValue=0.0) const {
+        return getDouble(std::string_view(key),defaultValue);
+    }
     
     /**
      * Returns the double value of the child with the specified key.
@@ -1077,7 +1228,7 @@ public:
      * @return the double value of the child with the specified key.
      */
     double getDouble(const char* key, double defaultValue=0.0) const {
-        return getDouble(std::string(key),defaultValue);
+        return getDouble(std::string_view(key),defaultValue);
     }
     
     /**
@@ -1094,7 +1245,25 @@ public:
      *
      * @return the long value of the child with the specified key.
      */
-    long getLong(const std::string& key, long defaultValue=0L) const;
+    long getLong(std::string_view key, long defaultValue=0L) const;
+    
+    /**
+     * Returns the long value of the child with the specified key.
+     *
+     * If there is no child with the given key, or if that child cannot be
+     * represented as a numeric value, it returns the default value instead.
+     *
+     * Note this is not the same behavior as get(key).asLong(defaultValue),
+     * since it will not fail if the child is an array or object.
+     *
+     * @param key  			The key identifying the child.
+     * @param defaultValue  The value to use if child does not exist or is not a number
+     *
+     * @return the long value of the child with the specified key.
+     */
+    long getLong(const std::string& key, long defaultValue=0L) const {
+        return getLong(std::string_view(key),defaultValue);
+    }
     
     /**
      * Returns the long value of the child with the specified key.
@@ -1111,7 +1280,7 @@ public:
      * @return the long value of the child with the specified key.
      */
     long getLong(const char* key, long defaultValue=0L) const {
-        return getLong(std::string(key),defaultValue);
+        return getLong(std::string_view(key),defaultValue);
     }
     
     /**
@@ -1128,7 +1297,25 @@ public:
      *
      * @return the int value of the child with the specified key.
      */
-    int getInt(const std::string& key, int defaultValue=0) const;
+    int getInt(std::string_view key, int defaultValue=0) const;
+    
+    /**
+     * Returns the int value of the child with the specified key.
+     *
+     * If there is no child with the given key, or if that child cannot be
+     * represented as a numeric value, it returns the default value instead.
+     *
+     * Note this is not the same behavior as get(key).asInt(defaultValue),
+     * since it will not fail if the child is an array or object.
+     *
+     * @param key  			The key identifying the child.
+     * @param defaultValue  The value to use if child does not exist or is not a number
+     *
+     * @return the int value of the child with the specified key.
+     */
+    int getInt(const std::string& key, int defaultValue=0) const {
+        return getInt(std::string_view(key),defaultValue);
+    }
     
     /**
      * Returns the int value of the child with the specified key.
@@ -1145,7 +1332,7 @@ public:
      * @return the int value of the child with the specified key.
      */
     int getInt(const char* key, int defaultValue=0) const {
-        return getInt(std::string(key),defaultValue);
+        return getInt(std::string_view(key),defaultValue);
     }
     
     /**
@@ -1162,7 +1349,25 @@ public:
      *
      * @return the boolean value of the child with the specified key.
      */
-    bool getBool(const std::string& key, bool defaultValue=false) const;
+    bool getBool(std::string_view key, bool defaultValue=false) const;
+    
+    /**
+     * Returns the boolean value of the child with the specified key.
+     *
+     * If there is no child with the given key, or if that child cannot be
+     * represented as a boolean value, it returns the default value instead.
+     *
+     * Note this is not the same behavior as get(key).asBool(defaultValue),
+     * since it will not fail if the child is an array or object.
+     *
+     * @param key  			The key identifying the child.
+     * @param defaultValue  The value to use if child does not exist or is not a boolean
+     *
+     * @return the boolean value of the child with the specified key.
+     */
+    bool getBool(const std::string& key, bool defaultValue=false) const {
+        return getBool(std::string_view(key),defaultValue);
+    }
 
     /**
      * Returns the boolean value of the child with the specified key.
@@ -1179,7 +1384,7 @@ public:
      * @return the boolean value of the child with the specified key.
      */
     bool getBool(const char* key, bool defaultValue=false) const {
-        return getBool(std::string(key),defaultValue);
+        return getBool(std::string_view(key),defaultValue);
     }
     
 #pragma mark -
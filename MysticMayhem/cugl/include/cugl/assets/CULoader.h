@@ -58,6 +58,8 @@ namespace cugl {
 
 /** Forward reference to the asset manager */
 class AssetManager;
+/** Forward reference to the decoded asset cache */
+class AssetCache;
 
 /**
  * @typedef LoaderCallback
@@ -110,6 +112,14 @@ protected:
      * This is a weak reference to avoid cycles.
      */
     AssetManager* _manager;
+
+    /**
+     * The on-disk cache of decoded assets (may be null)
+     *
+     * Loaders that support the cache use it to skip decoding on a warm
+     * start. Loaders that do not support it ignore it.
+     */
+    std::shared_ptr<AssetCache> _cache;
     
     /**
      * Internal method to support asset loading.
@@ -209,6 +219,24 @@ protected:
      * @return true if the key maps to a loaded asset.
      */
     virtual bool verify(const std::string& key) const { return false; }
+    
+    /**
+     * Returns the number of bytes used by the asset for the given key.
+     *
+     * This is an estimate of the memory (CPU or GPU) that is released when
+     * the asset is unloaded and no longer referenced. It is 0 if the key
+     * does not map to a loaded asset. You will notice that this method is
+     * essentially identical to getAssetMemory.  We separated the methods
+     * because overloading and virtual methods do not place nice.
+     *
+     * This method should be overridden in child classes whose assets use a
+     * significant amount of memory. By default it returns 0.
+     *
+     * @param key   The key associated with the asset
+     *
+     * @return the number of bytes used by the asset for the given key.
+     */
+    virtual size_t measure(const std::string& /*key*/) const { return 0; }
    
     
 public:
@@ -324,6 +352,29 @@ public:
     void setThreadPool(const std::shared_ptr<ThreadPool>& threads) {
         _loader = threads;
     }
+
+    /**
+     * Returns the decoded asset cache attached to this loader
+     *
+     * If this value is nullptr, every asset is decoded from its source.
+     *
+     * @return the decoded asset cache attached to this loader
+     */
+    std::shared_ptr<AssetCache> getCache() const { return _cache; }
+
+    /**
+     * Sets the decoded asset cache attached to this loader
+     *
+     * Loaders that support the cache check it before decoding an asset, and
+     * store the decoded result in it afterwards. Multiple asset loaders can
+     * share the same cache. It is unsafe to call this method if the loader
+     * is actively loading assets.
+     *
+     * @param cache The decoded asset cache attached to this loader
+     */
+    void setCache(const std::shared_ptr<AssetCache>& cache) {
+        _cache = cache;
+    }
     
     /**
      * Sets the asset manager for this loader.
@@ -681,6 +732,35 @@ public:
      */
     virtual size_t loadCount() const { return 0; }
     
+    /**
+     * Returns the number of bytes used by the asset for the given key.
+     *
+     * This is an estimate of the memory (CPU or GPU) that is released when
+     * the asset is unloaded and no longer referenced. It is 0 if the key
+     * does not map to a loaded asset.
+     *
+     * @param key   The key associated with the asset
+     *
+     * @return the number of bytes used by the asset for the given key.
+     */
+    size_t getAssetMemory(const std::string& key) const {
+        return measure(key);
+    }
+    
+    /**
+     * Returns the number of bytes used by all of the loaded assets.
+     *
+     * This is an estimate of the memory (CPU or GPU) held by this loader.
+     * Like {@link loadCount}, it does not include assets that are still
+     * loading.
+     *
+     * This method is abstract and should be overridden in child classes to
+     * support the appropriate asset type.
+     *
+     * @return the number of bytes used by all of the loaded assets.
+     */
+    virtual size_t getMemoryUsage() const { return 0; }
+    
     /**
      * Returns the number of assets waiting to load.
      *
@@ -696,6 +776,22 @@ public:
      */
     virtual size_t waitCount() const { return 0; }
     
+    /**
+     * Returns true if the asset with the given key is waiting to load.
+     *
+     * An asset is pending if it has been loaded asychronously, and the
+     * loading process has not yet finished. Once loading finishes, this
+     * method returns false whether or not the load was successful.
+     *
+     * This method is abstract and should be overridden in child classes to
+     * support the appropriate asset type.
+     *
+     * @param key   The key identifying the asset
+     *
+     * @return true if the asset with the given key is waiting to load.
+     */
+    virtual bool isPending(const std::string& /*key*/) const { return false; }
+    
     /**
      * Returns true if the loader has finished loading all assets.
      *
@@ -871,6 +967,22 @@ public:
      */
     size_t loadCount() const override { return _assets.size(); }
     
+    /**
+     * Returns the number of bytes used by all of the loaded assets.
+     *
+     * This is an estimate of the memory (CPU or GPU) held by this loader.
+     * It is the sum of {@link getAssetMemory} for each loaded asset.
+     *
+     * @return the number of bytes used by all of the loaded assets.
+     */
+    size_t getMemoryUsage() const override {
+        size_t result = 0;
+        for(auto it = _assets.begin(); it != _assets.end(); ++it) {
+            result += measure(it->first);
+        }
+        return result;
+    }
+    
     /**
      * Returns the number of textures waiting to load.
      *
@@ -883,6 +995,21 @@ public:
      */
     size_t waitCount() const override { return _queue.size(); }
 
+    /**
+     * Returns true if the asset with the given key is waiting to load.
+     *
+     * An asset is pending if it has been loaded asychronously, and the
+     * loading process has not yet finished. Once loading finishes, this
+     * method returns false whether or not the load was successful.
+     *
+     * @param key   The key identifying the asset
+     *
+     * @return true if the asset with the given key is waiting to load.
+     */
+    bool isPending(const std::string& key) const override {
+        return _queue.find(key) != _queue.end();
+    }
+
     /**
      * Unloads all assets present in this loader.
      *
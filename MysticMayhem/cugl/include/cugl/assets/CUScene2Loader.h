@@ -232,6 +232,25 @@ protected:
      */
     virtual bool purge(const std::shared_ptr<JsonValue>& json) override;
     
+    /**
+     * Unloads the asset for the given key
+     *
+     * An asset may still be available if it is referenced by a smart pointer.
+     * See the description of the specific implementation for how assets
+     * are released.
+     *
+     * Unloading a scene also unloads all of its descendants, as they are
+     * stored under keys that start with the key of the scene. You will
+     * notice that this method is essentially identical to unload.  We
+     * separated the methods because overloading and virtual methods do not
+     * place nice.
+     *
+     * @param key       The key associated with the asset
+     *
+     * @return true if the asset was successfully unloaded
+     */
+    virtual bool purge(const std::string& key) override;
+    
     /**
      * Attaches all generate nodes to the asset dictionary.
      *
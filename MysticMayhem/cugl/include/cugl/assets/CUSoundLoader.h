@@ -47,6 +47,7 @@
 #define __CU_SOUND_LOADER_H__
 #include <cugl/assets/CULoader.h>
 #include <cugl/audio/CUSound.h>
+#include <cugl/audio/CUAudioSample.h>
 
 namespace cugl {
     
@@ -63,6 +64,11 @@ namespace cugl {
  * off the remainder of asset loading using {@link Application#schedule}.  This
  * is a good template for asset loaders in general.
  *
+ * If the loader has an {@link AssetCache}, in-memory audio samples are stored
+ * in it once decoded. Later loads of the same file with the same encoding
+ * copy the samples from the cache instead of decoding the file again.
+ * Streamed samples are never cached.
+ *
  * As with all of our loaders, this loader is designed to be attached to an
  * asset manager. Use the method {@link getHook()} to get the appropriate
  * pointer for attaching the loader.
@@ -77,6 +83,22 @@ protected:
     float _volume;
     
 #pragma mark Asset Loading
+    /**
+     * Loads an audio sample, using the asset cache if there is one.
+     *
+     * This method is safe to call outside of the main thread. It returns
+     * nullptr if the file is not a supported audio file, or if it cannot be
+     * loaded.
+     *
+     * @param source    The pathname to the asset
+     * @param stream    Whether to stream the audio from the file
+     * @param encoding  The storage format for an in-memory sample
+     *
+     * @return the audio sample for the given file
+     */
+    std::shared_ptr<AudioSample> preload(const std::string& source, bool stream,
+                                         AudioSample::Encoding encoding);
+
     /**
      * Finishes loading the sound file, setting its default volume.
      *
@@ -142,6 +164,17 @@ protected:
     virtual bool read(const std::shared_ptr<JsonValue>& json,
                       LoaderCallback callback, bool async) override;
     
+    /**
+     * Returns the number of bytes used by the sound for the given key.
+     *
+     * This is the size of the decoded samples of an in-memory audio sample.
+     * Streamed samples and waveforms use no significant memory.
+     *
+     * @param key   The key associated with the sound
+     *
+     * @return the number of bytes used by the sound for the given key.
+     */
+    virtual size_t measure(const std::string& key) const override;
     
 public:
 #pragma mark -
@@ -47,6 +47,8 @@
 #define __CU_TEXTURE_LOADER_H__
 #include <cugl/assets/CULoader.h>
 #include <cugl/render/CUTexture.h>
+#include <unordered_map>
+#include <atomic>
 
 namespace cugl {
 
@@ -66,6 +68,27 @@ namespace cugl {
  * remainder of asset loading using {@link Application#schedule}.  This is a
  * good template for asset loaders in general.
  *
+ * Creating a texture copies every pixel to the graphics card, so the second
+ * phase is not free. Decoded images are placed in an upload queue, and the
+ * queue is drained once per animation frame until the upload budget (in
+ * bytes or in time) is spent. Larger images are never split, but at least
+ * one texture is created each frame. Uploads with a higher priority go
+ * first, so the textures for the next visible scene are not stuck behind
+ * the rest of the directory. Optionally, the pixels may be staged in a pixel
+ * buffer object by a worker thread, so that the driver can transfer them
+ * without stalling the main thread.
+ *
+ * If compression is enabled (the default), the loader looks for a compiled
+ * KTX2 or KTX container next to each image file, with the same name. For
+ * example, "textures/tiles.png" may be paired with "textures/tiles.ktx2"
+ * (say ASTC) and "textures/tiles.ktx" (say ETC2). The first container in a
+ * format the graphics card supports is uploaded as is, using a fraction of
+ * the memory. If there is none, the original image file is decoded instead.
+ *
+ * If the loader has an {@link AssetCache}, decoded images are stored in it.
+ * Later loads of an unchanged image file copy the pixels from the cache
+ * rather than decoding the file again.
+ *
  * As with all of our loaders, this loader is designed to be attached to an
  * asset manager. Use the method {@link getHook()} to get the appropriate
  * pointer for attaching the loader.
@@ -87,6 +110,63 @@ protected:
     /** The default support for mipmaps */
     bool _mipmaps;
     
+    /**
+     * A decoded image waiting for its OpenGL texture
+     *
+     * The staged flag is the only attribute touched outside the main thread.
+     */
+    class Upload {
+    public:
+        /** The key to access the asset after loading */
+        std::string key;
+        /** The asset directory entry (nullptr if loaded from a source file) */
+        std::shared_ptr<JsonValue> json;
+        /** The decoded image (nullptr if decoding failed) */
+        SDL_Surface* surface;
+        /** The compressed image (nullptr if the image was decoded) */
+        std::shared_ptr<CompressedImage> image;
+        /** The optional callback for asynchronous loading */
+        LoaderCallback callback;
+        /** The upload priority; larger values are uploaded first */
+        int priority;
+        /** The order this upload was queued (to break ties) */
+        Uint64 order;
+        /** The pixel buffer holding the staged image (0 if not staged) */
+        GLuint buffer;
+        /** Whether the pixels have been copied into the pixel buffer */
+        std::atomic<bool> staged;
+        
+        /** Creates an empty upload */
+        Upload() : surface(nullptr), priority(0), order(0), buffer(0), staged(false) {}
+        
+        /** Returns the number of bytes to upload */
+        size_t size() const {
+            if (image != nullptr) {
+                return image->getByteSize();
+            }
+            return surface == nullptr ? 0 : (size_t)surface->pitch*(size_t)surface->h;
+        }
+    };
+    
+    /** The decoded images waiting for an OpenGL texture */
+    std::vector<std::shared_ptr<Upload>> _uploads;
+    /** The number of uploads queued so far */
+    Uint64 _uploadCount;
+    /** Whether the upload queue is scheduled with the application */
+    bool _pumping;
+    /** The maximum bytes to upload each frame (0 for no limit) */
+    size_t _uploadBytes;
+    /** The maximum microseconds to spend uploading each frame (0 for no limit) */
+    Uint64 _uploadMicros;
+    /** Whether to stage uploads in pixel buffer objects */
+    bool _staging;
+    /** The number of bytes currently held in pixel buffer objects */
+    size_t _stagedBytes;
+    /** The upload priorities assigned by key */
+    std::unordered_map<std::string,int> _priorities;
+    /** Whether to look for compressed containers next to image files */
+    bool _compression;
+    
 #pragma mark Asset Loading
     /**
      * Extracts any subtextures specified in an atlas
@@ -109,12 +189,71 @@ protected:
      * we need to create an OpenGL texture.  Hence this method does the maximum
      * amount of work that can be done in asynchronous texture loading.
      *
+     * If there is an asset cache, the pixels are read from the cache when it
+     * has an entry for this file. Otherwise they are stored in the cache once
+     * decoded.
+     *
      * @param source    The pathname to the asset
      *
      * @return the SDL_Surface with the texture information
      */
     SDL_Surface* preload(const std::string& source);
     
+    /**
+     * Returns the compressed image for the given source, if there is one.
+     *
+     * If the source is a KTX or KTX2 container, this method loads it directly.
+     * Otherwise, if compression is enabled, it looks for a container with the
+     * same name as the source, preferring KTX2 over KTX. A container is only
+     * returned if the graphics card supports its format. This method is safe
+     * to call outside the main thread.
+     *
+     * @param source    The pathname to the asset
+     *
+     * @return the compressed image for the given source, if there is one.
+     */
+    std::shared_ptr<CompressedImage> preloadImage(const std::string& source);
+    
+    /**
+     * Adds a decoded image to the upload queue.
+     *
+     * This method must be called on the main thread. The image will be
+     * materialized by a later call to {@link pump}, in priority order.
+     *
+     * @param key       The key to access the asset after loading
+     * @param json      The asset directory entry (nullptr if none)
+     * @param surface   The decoded image (nullptr if decoding failed)
+     * @param image     The compressed image (nullptr if none)
+     * @param callback  An optional callback for asynchronous loading
+     */
+    void enqueue(const std::string& key, const std::shared_ptr<JsonValue>& json,
+                 SDL_Surface* surface, const std::shared_ptr<CompressedImage>& image,
+                 LoaderCallback callback);
+    
+    /**
+     * Copies the pixels of the given upload into a pixel buffer object.
+     *
+     * The buffer is mapped on the main thread, but the copy is performed by
+     * the loader thread pool. The upload is ready once its staged flag is set.
+     * If the buffer cannot be mapped, the upload is marked as staged with no
+     * buffer, and its pixels are uploaded directly.
+     *
+     * @param upload    The upload to stage
+     */
+    void stage(const std::shared_ptr<Upload>& upload);
+    
+    /**
+     * Materializes queued images until the upload budget is spent.
+     *
+     * This method is scheduled with {@link Application#schedule}, and so it
+     * returns true as long as there are uploads still waiting. It always
+     * materializes at least one image (if one is ready), so that large
+     * images cannot stall the queue.
+     *
+     * @return true if there are uploads still waiting
+     */
+    bool pump();
+    
     /**
      * Creates an OpenGL texture from the SDL_Surface, and assigns it the given key.
      *
@@ -128,11 +267,17 @@ protected:
      * This method supports an optional callback function which reports whether
      * the asset was successfully materialized.
      *
+     * If buffer is not 0, the pixels are read from that pixel buffer object
+     * instead of the surface. The buffer is deleted by this method.
+     *
      * @param key       The key to access the asset after loading
      * @param surface   The SDL_Surface to convert
+     * @param image     The compressed image to use instead (or nullptr)
+     * @param buffer    The pixel buffer staging the surface (or 0)
      * @param callback  An optional callback for asynchronous loading
      */
-    void materialize(const std::string& key, SDL_Surface* surface, LoaderCallback callback);
+    void materialize(const std::string& key, SDL_Surface* surface, const std::shared_ptr<CompressedImage>& image,
+                     GLuint buffer, LoaderCallback callback);
     
     /**
      * Creates an OpenGL texture from the SDL_Surface accoring to the directory entry.
@@ -152,17 +297,25 @@ protected:
      *      "magfilter":    The name of the min filter ("nearest" or "linear")
      *      "wrapS":        The s-coord wrap rule ("clamp", "repeat", or "mirrored")
      *      "wrapT":        The t-coord wrap rule ("clamp", "repeat", or "mirrored")
+ *      "priority":     The upload priority (int; larger values are uploaded first)
+     *      "priority":     The upload priority (int; larger values are uploaded first)
      *
      * The asset key is the key for the JSON directory entry
      *
      * This method supports an optional callback function which reports whether
      * the asset was successfully materialized.
      *
+     * If buffer is not 0, the pixels are read from that pixel buffer object
+     * instead of the surface. The buffer is deleted by this method.
+     *
      * @param json      The asset directory entry
      * @param surface   The SDL_Surface to convert
+     * @param image     The compressed image to use instead (or nullptr)
+     * @param buffer    The pixel buffer staging the surface (or 0)
      * @param callback  An optional callback for asynchronous loading
      */
-    void materialize(const std::shared_ptr<JsonValue>& json, SDL_Surface* surface, LoaderCallback callback);
+    void materialize(const std::shared_ptr<JsonValue>& json, SDL_Surface* surface, const std::shared_ptr<CompressedImage>& image,
+                     GLuint buffer, LoaderCallback callback);
     
 
     /**
@@ -208,6 +361,8 @@ protected:
      *      "magfilter":    The name of the min filter ("nearest" or "linear")
      *      "wrapS":        The s-coord wrap rule ("clamp", "repeat", or "mirrored")
      *      "wrapT":        The t-coord wrap rule ("clamp", "repeat", or "mirrored")
+ *      "priority":     The upload priority (int; larger values are uploaded first)
+     *      "priority":     The upload priority (int; larger values are uploaded first)
      *
      * @param json      The directory entry for the asset
      * @param callback  An optional callback for asynchronous loading
@@ -236,6 +391,20 @@ protected:
      */
     virtual bool purge(const std::shared_ptr<JsonValue>& json) override;
     
+    /**
+     * Returns the number of bytes used by the texture for the given key.
+     *
+     * This is the size of the texture in graphics memory, including any
+     * mipmaps. Block-compressed textures are measured by their blocks. A
+     * subtexture of an atlas uses no memory of its own, as it shares the
+     * memory of its parent.
+     *
+     * @param key   The key associated with the texture
+     *
+     * @return the number of bytes used by the texture for the given key.
+     */
+    virtual size_t measure(const std::string& key) const override;
+    
 public:
 #pragma mark -
 #pragma mark Constructors
@@ -257,11 +426,10 @@ public:
      *
      * Once the loader is disposed, any attempts to load a new asset will
      * fail.  You must reinitialize the loader to begin loading assets again.
+     * Any images still waiting to be uploaded are discarded, and their
+     * callbacks are not called.
      */
-    void dispose() override {
-        _assets.clear();
-        _loader = nullptr;
-    }
+    void dispose() override;
     
     /**
      * Returns a newly allocated texture loader.
@@ -404,6 +572,147 @@ public:
      * @param flag  Whether this loader generates mipmaps by default.
      */
     void setMipMaps(bool flag) { _mipmaps = flag; }
+    
+    /**
+     * Returns true if this loader looks for compressed containers.
+     *
+     * If this is true, the loader looks for a KTX2 or KTX container with the
+     * same name as each image file, and uploads it instead if the graphics
+     * card supports its format. Mipmaps for such a texture come from the
+     * container, and are not built at load time. The default is true.
+     *
+     * @return true if this loader looks for compressed containers.
+     */
+    bool hasCompression() const { return _compression; }
+    
+    /**
+     * Sets whether this loader looks for compressed containers.
+     *
+     * If this is true, the loader looks for a KTX2 or KTX container with the
+     * same name as each image file, and uploads it instead if the graphics
+     * card supports its format. Mipmaps for such a texture come from the
+     * container, and are not built at load time. The default is true.
+     *
+     * @param flag  Whether this loader looks for compressed containers.
+     */
+    void setCompression(bool flag) { _compression = flag; }
+    
+#pragma mark -
+#pragma mark Upload Budget
+    /**
+     * Returns the maximum number of bytes to upload each frame.
+     *
+     * Asynchronous loads queue their decoded images, and create textures
+     * from them at the start of each animation frame until this budget is
+     * spent. A value of 0 means there is no limit. The default is 0.
+     *
+     * An image is never split, and at least one image is uploaded each frame.
+     * So a single image may exceed this budget.
+     *
+     * @return the maximum number of bytes to upload each frame.
+     */
+    size_t getUploadBudget() const { return _uploadBytes; }
+    
+    /**
+     * Sets the maximum number of bytes to upload each frame.
+     *
+     * Asynchronous loads queue their decoded images, and create textures
+     * from them at the start of each animation frame until this budget is
+     * spent. A value of 0 means there is no limit. The default is 0.
+     *
+     * An image is never split, and at least one image is uploaded each frame.
+     * So a single image may exceed this budget.
+     *
+     * @param bytes The maximum number of bytes to upload each frame.
+     */
+    void setUploadBudget(size_t bytes) { _uploadBytes = bytes; }
+    
+    /**
+     * Returns the maximum time to spend uploading each frame.
+     *
+     * This budget is measured in microseconds, and includes mipmap generation.
+     * A value of 0 means there is no limit. The default is 4000 (a quarter of
+     * a 60 fps frame). At least one image is uploaded each frame, no matter
+     * how long it takes.
+     *
+     * @return the maximum time to spend uploading each frame.
+     */
+    Uint64 getUploadTime() const { return _uploadMicros; }
+    
+    /**
+     * Sets the maximum time to spend uploading each frame.
+     *
+     * This budget is measured in microseconds, and includes mipmap generation.
+     * A value of 0 means there is no limit. The default is 4000 (a quarter of
+     * a 60 fps frame). At least one image is uploaded each frame, no matter
+     * how long it takes.
+     *
+     * @param micros    The maximum time to spend uploading each frame.
+     */
+    void setUploadTime(Uint64 micros) { _uploadMicros = micros; }
+    
+    /**
+     * Returns true if uploads are staged in pixel buffer objects.
+     *
+     * When staging, a decoded image is copied by a worker thread into a
+     * mapped pixel buffer object, and the texture is created from that
+     * buffer. This lets the driver transfer the pixels without blocking the
+     * main thread. If a buffer cannot be mapped (e.g. there is no graphics
+     * context), the image is uploaded directly. At most one frame of uploads
+     * (or 8 MB if there is no byte budget) is staged at a time. The default
+     * is false.
+     *
+     * @return true if uploads are staged in pixel buffer objects.
+     */
+    bool isStaging() const { return _staging; }
+    
+    /**
+     * Sets whether uploads are staged in pixel buffer objects.
+     *
+     * When staging, a decoded image is copied by a worker thread into a
+     * mapped pixel buffer object, and the texture is created from that
+     * buffer. This lets the driver transfer the pixels without blocking the
+     * main thread. If a buffer cannot be mapped (e.g. there is no graphics
+     * context), the image is uploaded directly. At most one frame of uploads
+     * (or 8 MB if there is no byte budget) is staged at a time. The default
+     * is false.
+     *
+     * @param flag  Whether to stage uploads in pixel buffer objects.
+     */
+    void setStaging(bool flag) { _staging = flag; }
+    
+    /**
+     * Returns the upload priority assigned to the given key.
+     *
+     * Queued images with a higher priority are uploaded first. If no priority
+     * was assigned, this method returns 0. In that case, an image loaded from
+     * a directory entry uses the "priority" attribute of that entry instead.
+     *
+     * @param key   The asset key
+     *
+     * @return the upload priority for the given key.
+     */
+    int getPriority(const std::string& key) const;
+    
+    /**
+     * Sets the upload priority for the given key.
+     *
+     * Queued images with a higher priority are uploaded first. Images with
+     * the same priority are uploaded in the order they finished decoding.
+     * This value overrides the "priority" attribute of a directory entry,
+     * and applies to an image that is already waiting in the queue.
+     *
+     * @param key       The asset key
+     * @param priority  The upload priority
+     */
+    void setPriority(const std::string& key, int priority);
+    
+    /**
+     * Returns the number of decoded images waiting to be uploaded.
+     *
+     * @return the number of decoded images waiting to be uploaded.
+     */
+    size_t uploadCount() const { return _uploads.size(); }
 
 };
 
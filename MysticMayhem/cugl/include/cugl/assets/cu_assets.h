@@ -31,6 +31,7 @@
 
 #include "CUJsonValue.h"
 #include "CUWidgetValue.h"
+#include "CUAssetCache.h"
 #include "CUAssetManager.h"
 #include "CUTextureLoader.h"
 #include "CUFontLoader.h"
@@ -36,6 +36,8 @@
 #ifndef __CU_AUDIO_DEVICES_H__
 #define __CU_AUDIO_DEVICES_H__
 #include <SDL/SDL.h>
+#include <cugl/audio/CUAudioStreamer.h>
+#include <cugl/audio/CUAudioProfiler.h>
 #include <unordered_map>
 #include <vector>
 #include <memory>
@@ -95,6 +97,10 @@ private:
     std::unordered_map<std::string, std::shared_ptr<audio::AudioOutput>> _outputs;
     /** The list of all active input devices */
     std::unordered_map<std::string, std::shared_ptr<audio::AudioInput>>  _inputs;
+    /** The background decoder for streamed samples */
+    std::shared_ptr<audio::AudioStreamer> _streamer;
+    /** The audio thread profiler */
+    std::shared_ptr<audio::AudioProfiler> _profiler;
 
 #pragma mark -
 #pragma mark Constructors (Private)
@@ -297,6 +303,30 @@ public:
      */
     Uint32 getWriteSize() const { return _input; }
 
+    /**
+     * Returns the background decoder for streamed samples.
+     *
+     * Every {@link audio::AudioPlayer} for a streamed {@link AudioSample}
+     * attaches its page cache to this streamer, so that codec work never
+     * happens on the audio thread. The streamer is started with this manager
+     * and stopped when the manager is disposed.
+     *
+     * @return the background decoder for streamed samples.
+     */
+    const std::shared_ptr<audio::AudioStreamer>& getStreamer() const { return _streamer; }
+
+    /**
+     * Returns the audio thread profiler.
+     *
+     * The profiler is disabled by default. When enabled, it records the
+     * time of each output callback (and of the mixer, spinner, fader and
+     * resampler nodes), along with overruns, stream underruns and voice
+     * counts. Use it to tune the buffer size for a device.
+     *
+     * @return the audio thread profiler.
+     */
+    const std::shared_ptr<audio::AudioProfiler>& getProfiler() const { return _profiler; }
+
     /**
      * Returns true if the audio device manager is active.
      *
@@ -92,6 +92,13 @@ namespace cugl {
  * panning, early termination, etc.).  This key eliminates any need for tracking
  * the slot assigned to an effect.
  *
+ * Keys are optional. An effect that never needs to be referenced by name can
+ * be played with {@link #playVoice}, which returns an integer voice handle
+ * instead. Voices are allocated from a free list, so starting a sound takes
+ * constant time no matter how many sounds are playing. When every slot is in
+ * use, a new sound may steal the slot of the oldest sound with the lowest
+ * priority, provided that its own priority is higher.
+ *
  * Music is treated separately because seamless playback requires the ability
  * to queue up audio assets in order. As a result, this is supported through
  * the {@link AudioQueue} interface.  However, queues are owned by and acquired
@@ -147,10 +154,40 @@ private:
     /** Active music queues */
     std::vector<std::shared_ptr<AudioQueue>> _queues;
     
-    /** Map keys to identifiers */
-    std::unordered_map<std::string,std::shared_ptr<audio::AudioFader>> _actives;
-    /** A queue for slot eviction if necessary */
-    std::deque<std::string> _evicts;
+    /**
+     * An inner class representing a sound effect voice.
+     *
+     * There is one voice for each sound effect slot. A voice is free if it
+     * has no fader. The generation distinguishes successive sounds in the
+     * same slot, so that a stale voice handle never refers to a new sound.
+     */
+    class Voice {
+    public:
+        /** The wrapped instance playing in this voice (nullptr if free) */
+        std::shared_ptr<audio::AudioFader> fader;
+        /** The key for this voice (empty if the sound has no key) */
+        std::string key;
+        /** The start order of this voice (for age-based stealing) */
+        Uint64 stamp;
+        /** The number of sounds played in this voice */
+        Uint32 generation;
+        /** The priority of the current sound */
+        Sint32 priority;
+        
+        /**
+         * Creates a free voice
+         */
+        Voice() : stamp(0), generation(0), priority(0) {}
+    };
+    
+    /** The sound effect voices, one per slot */
+    std::vector<Voice> _voices;
+    /** The stack of free voice slots */
+    std::vector<Uint32> _freeVoices;
+    /** Map keys to voice slots (only for keyed sound effects) */
+    std::unordered_map<std::string,Uint32> _keys;
+    /** The number of voices started so far (used to order voices by age) */
+    Uint64 _clock;
 
     /** An object pool of faders for individual sound instances */
     std::deque<std::shared_ptr<audio::AudioFader>>  _fadePool;
@@ -222,6 +259,91 @@ private:
      */
     void removeKey(const std::string key);
 
+    /**
+     * Returns the slot of a voice for a sound of the given priority.
+     *
+     * If there is a free voice, this method takes constant time. Otherwise
+     * it looks for a voice to steal. Voices that have finished or are fading
+     * out are always available. Otherwise, the method picks the oldest voice
+     * of the lowest priority, and steals it only if that priority is less
+     * than the given one (or if force is true). The key of a stolen voice is
+     * released immediately.
+     *
+     * @param priority  The priority of the new sound
+     * @param force     Whether to steal a voice regardless of priority
+     *
+     * @return the slot of an available voice, or -1 if there is none
+     */
+    Sint32 acquireVoice(Sint32 priority, bool force);
+
+    /**
+     * Returns a handle to a new sound playing the given instance.
+     *
+     * This method is the shared implementation of all of the play methods.
+     * It returns 0 if the sound could not be played.
+     *
+     * @param  key      The reference key for the sound effect (may be empty)
+     * @param  instance The audio instance to play
+     * @param  loop     Whether to loop the sound effect continuously
+     * @param  volume   The music volume (relative to the default instance volume)
+     * @param  priority The priority for voice stealing
+     * @param  force    Whether to force another sound to stop.
+     * @param  time     The sample time to start the sound (0 for immediately)
+     *
+     * @return a handle to a new sound playing the given instance.
+     */
+    Uint64 playInstance(const std::string& key, const std::shared_ptr<audio::AudioNode>& instance,
+                        bool loop, float volume, Sint32 priority, bool force, Uint64 time=0);
+
+    /**
+     * Returns the voice in the given slot to the free list.
+     *
+     * This method also releases the key (if any) for that voice.
+     *
+     * @param slot  The voice slot
+     */
+    void releaseVoice(Uint32 slot);
+
+    /**
+     * Returns the fader for the sound effect with the given key.
+     *
+     * This method returns nullptr if there is no such sound effect.
+     *
+     * @param key   The reference key for the sound effect
+     *
+     * @return the fader for the sound effect with the given key.
+     */
+    std::shared_ptr<audio::AudioFader> getFader(const std::string& key) const;
+
+    /**
+     * Returns the fader for the sound effect with the given voice handle.
+     *
+     * This method returns nullptr if the handle does not refer to an active
+     * sound effect.
+     *
+     * @param voice The voice handle for the sound effect
+     *
+     * @return the fader for the sound effect with the given voice handle.
+     */
+    std::shared_ptr<audio::AudioFader> getFader(Uint64 voice) const;
+
+    /**
+     * Returns the playback state of the sound effect with the given fader.
+     *
+     * @param fader The fader for the sound effect
+     *
+     * @return the playback state of the sound effect with the given fader.
+     */
+    State getState(const std::shared_ptr<audio::AudioFader>& fader) const;
+
+    /**
+     * Sets the stereo pan of the sound effect with the given fader.
+     *
+     * @param fader The fader for the sound effect
+     * @param pan   The stereo pan of the sound effect
+     */
+    void setPanFactor(const std::shared_ptr<audio::AudioFader>& fader, float pan);
+
     /**
      * Returns a playable audio node for a given audio instance
      *
@@ -498,7 +620,7 @@ public:
      * @return the number of slots available for sound effects.
      */
     size_t getAvailableSlots() const {
-        return _capacity-_actives.size();
+        return _freeVoices.size();
     }
 
     /**
@@ -521,7 +643,7 @@ public:
      * @return true if the key is associated with an active sound.
      */
     bool isActive(const std::string key) const {
-        return _actives.find(key) != _actives.end();
+        return _keys.find(key) != _keys.end();
     }
 
     /**
@@ -779,6 +901,9 @@ public:
      * terminated manually.  However, the second parameter can be used to
      * distinguish the two cases.
      *
+     * Sound effects started with {@link #playVoice} have no key, and so this
+     * function is not called for them.
+     *
      * @param callback  The callback for sound effects
      */
     void setListener(std::function<void(const std::string key,bool)> callback) {
@@ -799,6 +924,141 @@ public:
         return _callback;
     }
 
+#pragma mark -
+#pragma mark Voice Management
+    /**
+     * Plays the given sound without a key, returning a voice handle.
+     *
+     * This method is for sound effects that are not referenced by name, such
+     * as short one-shot effects. It avoids the cost of managing a key. The
+     * handle returned can be used with the other voice methods. A handle is
+     * never 0, and it becomes invalid once the sound is finished; it will not
+     * refer to a later sound in the same slot.
+     *
+     * If all slots are in use, this sound steals the slot of the oldest
+     * sound with the lowest priority, provided that its priority is lower
+     * than this one. Keyed sounds played with {@link #play} have priority 0.
+     *
+     * If time is not 0, the sound starts at that frame of {@link #getSampleTime},
+     * rather than at the start of the next audio buffer.
+     *
+     * @param  sound    The sound effect to play
+     * @param  loop     Whether to loop the sound effect continuously
+     * @param  volume   The music volume (relative to the default asset volume)
+     * @param  priority The priority for voice stealing
+     * @param  time     The sample time to start the sound (0 for immediately)
+     *
+     * @return a voice handle for the sound, or 0 if it could not be played
+     */
+    Uint64 playVoice(const std::shared_ptr<Sound>& sound, bool loop=false,
+                     float volume=1.0f, Sint32 priority=0, Uint64 time=0);
+
+    /**
+     * Plays the given audio node without a key, returning a voice handle.
+     *
+     * This method is for sound effects that are not referenced by name, such
+     * as short one-shot effects. It avoids the cost of managing a key. The
+     * handle returned can be used with the other voice methods. A handle is
+     * never 0, and it becomes invalid once the sound is finished; it will not
+     * refer to a later sound in the same slot.
+     *
+     * If all slots are in use, this sound steals the slot of the oldest
+     * sound with the lowest priority, provided that its priority is lower
+     * than this one. Keyed sounds played with {@link #play} have priority 0.
+     *
+     * If time is not 0, the sound starts at that frame of {@link #getSampleTime},
+     * rather than at the start of the next audio buffer.
+     *
+     * @param  graph    The audio graph to play
+     * @param  loop     Whether to loop the sound effect continuously
+     * @param  volume   The music volume (relative to the default instance volume)
+     * @param  priority The priority for voice stealing
+     * @param  time     The sample time to start the sound (0 for immediately)
+     *
+     * @return a voice handle for the sound, or 0 if it could not be played
+     */
+    Uint64 playVoice(const std::shared_ptr<audio::AudioNode>& graph, bool loop=false,
+                     float volume=1.0f, Sint32 priority=0, Uint64 time=0);
+
+    /**
+     * Returns the current sample time of the output device.
+     *
+     * This is an estimate of the frame of the output clock at this instant
+     * (see {@link audio::AudioClock#estimate}). A sound played with this time
+     * starts exactly one audio buffer from now, no matter when in the buffer
+     * the request was made. Adding an offset schedules the sound that many
+     * frames later. Use {@link #getSampleRate} to convert from seconds.
+     *
+     * @return the current sample time of the output device.
+     */
+    Uint64 getSampleTime() const;
+
+    /**
+     * Returns the sample rate of the output device.
+     *
+     * @return the sample rate of the output device.
+     */
+    Uint32 getSampleRate() const;
+
+    /**
+     * Returns true if the voice handle refers to an active sound.
+     *
+     * @param  voice    the voice handle for the sound effect
+     *
+     * @return true if the voice handle refers to an active sound.
+     */
+    bool isVoiceActive(Uint64 voice) const {
+        return getFader(voice) != nullptr;
+    }
+
+    /**
+     * Returns the current state of the sound effect for the given voice.
+     *
+     * If the handle does not refer to an active sound effect, it returns
+     * State::INACTIVE.
+     *
+     * @param  voice    the voice handle for the sound effect
+     *
+     * @return the current state of the sound effect for the given voice.
+     */
+    State getVoiceState(Uint64 voice) const;
+
+    /**
+     * Sets the current volume of the sound effect for the given voice.
+     *
+     * If the handle does not refer to an active sound effect, this method
+     * does nothing.
+     *
+     * @param  voice    the voice handle for the sound effect
+     * @param  volume   the current volume of the sound effect
+     */
+    void setVoiceVolume(Uint64 voice, float volume);
+
+    /**
+     * Sets the stereo pan of the sound effect for the given voice.
+     *
+     * See {@link #setPanFactor} for a description of the pan value. If the
+     * handle does not refer to an active sound effect, this method does
+     * nothing.
+     *
+     * @param  voice    the voice handle for the sound effect
+     * @param  pan      the stereo pan of the sound effect
+     */
+    void setVoicePan(Uint64 voice, float pan);
+
+    /**
+     * Stops the sound effect for the given voice.
+     *
+     * If the argument is 0, it will halt the sound immediately. Otherwise
+     * it will fade to completion over the given number of seconds (or until
+     * the end of the effect). If the handle does not refer to an active
+     * sound effect, this method does nothing.
+     *
+     * @param  voice    the voice handle for the sound effect
+     * @param  fade     the number of seconds to fade out
+     */
+    void stopVoice(Uint64 voice, float fade=DEFAULT_FADE);
+
 #pragma mark -
 #pragma mark Global Management
     /**
@@ -0,0 +1,476 @@
+//
+//  CUAudioProfiler.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides instrumentation for the audio thread. It records how
+//  long each output callback takes, how close that is to the deadline set by
+//  the buffer size, and how much of that time is spent in the mixer, spinner,
+//  fader and resampler nodes. It also counts stream underruns and the number
+//  of voices mixed. This is the information needed to tune the buffer size
+//  for a particular device.
+//
+//  All recording is lock-free and allocation-free, so it is safe for the
+//  audio thread. The main thread reads the results with a snapshot, and can
+//  optionally drain a per-callback trace to a BinaryWriter.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#ifndef __CU_AUDIO_PROFILER_H__
+#define __CU_AUDIO_PROFILER_H__
+#include <SDL/SDL.h>
+#include <cugl/util/CURingQueue.h>
+#include <cugl/util/CUTimestamp.h>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace cugl {
+    /** Forward reference to the binary writer */
+    class BinaryWriter;
+
+    namespace audio {
+
+/**
+ * This class collects timing statistics for the audio thread.
+ *
+ * There is one profiler for the audio device manager, which is accessed with
+ * {@link AudioDevices#getProfiler}. It is disabled by default, in which case
+ * recording does nothing beyond checking an atomic flag.
+ *
+ * When enabled, each {@link AudioOutput} callback records its total time in
+ * the profiler. The mixer, spinner, fader and resampler nodes also time their
+ * read methods. These times are inclusive (a mixer includes the time of its
+ * inputs), and are summed over all nodes of that type during the callback.
+ * The profiler keeps a histogram of each of these stages, with buckets that
+ * are powers of two in microseconds.
+ *
+ * The profiler also tracks the load of each callback, which is the callback
+ * time divided by the time that the buffer takes to play. A callback with a
+ * load over 100% is an overrun, and will cause an audible glitch. Stream
+ * underruns (where a streamed sample is not decoded in time) and the number
+ * of voices mixed per callback are recorded as well.
+ *
+ * Recording is lock-free and may happen on the audio thread. Counters are
+ * atomic, so {@link #snapshot} may be called at any time from the main
+ * thread, though a snapshot taken mid-callback may be off by one callback.
+ *
+ * If tracing is enabled, every callback also pushes a {@link Trace} record to
+ * a bounded queue. The main thread drains this queue with {@link #dump}.
+ * Records are dropped (and counted) if the queue is full. The trace queue
+ * assumes a single output device.
+ */
+class AudioProfiler {
+public:
+    /**
+     * The stages timed by this profiler
+     */
+    enum class Stage : int {
+        /** The entire output callback */
+        OUTPUT    = 0,
+        /** The read methods of {@link AudioMixer} */
+        MIXER     = 1,
+        /** The read methods of {@link AudioSpinner} */
+        SPINNER   = 2,
+        /** The read methods of {@link AudioFader} */
+        FADER     = 3,
+        /** The read methods of {@link AudioResampler} */
+        RESAMPLER = 4
+    };
+
+    /** The number of timed stages */
+    static const Uint32 STAGES = 5;
+    /** The number of time buckets (bucket b is less than 2^b microseconds) */
+    static const Uint32 TIME_BUCKETS = 24;
+    /** The number of load buckets (10% each, with the last one overruns) */
+    static const Uint32 LOAD_BUCKETS = 11;
+    /** The number of voice buckets (one per voice, with the last for more) */
+    static const Uint32 VOICE_BUCKETS = 33;
+    /** The default number of trace records buffered between dumps */
+    static const Uint32 DEFAULT_TRACE;
+
+    /**
+     * The timing histogram of a single stage
+     */
+    struct Histogram {
+        /** The number of callbacks recorded */
+        Uint64 count;
+        /** The total time in microseconds */
+        Uint64 total;
+        /** The longest time in microseconds */
+        Uint64 peak;
+        /** The callbacks in each bucket (bucket b is less than 2^b microseconds) */
+        Uint64 buckets[TIME_BUCKETS];
+
+        /**
+         * Returns the average time in microseconds
+         *
+         * @return the average time in microseconds
+         */
+        double getAverage() const {
+            return count ? (double)total/count : 0;
+        }
+
+        /**
+         * Returns an upper bound of the given percentile in microseconds
+         *
+         * The result is the upper limit of the bucket containing the
+         * percentile, so it is accurate to within a factor of two.
+         *
+         * @param percent   The percentile in [0,1]
+         *
+         * @return an upper bound of the given percentile in microseconds
+         */
+        Uint64 getPercentile(double percent) const;
+    };
+
+    /**
+     * A copy of the profiler statistics
+     */
+    struct Snapshot {
+        /** The number of output callbacks recorded */
+        Uint64 callbacks;
+        /** The timing histogram of each stage */
+        Histogram stages[STAGES];
+        /** The callbacks in each load bucket (10% each, the last is over 100%) */
+        Uint64 load[LOAD_BUCKETS];
+        /** The callbacks that exceeded their deadline */
+        Uint64 overruns;
+        /** The stream underruns (reads that outran the streamer) */
+        Uint64 underruns;
+        /** The callbacks with each voice count (the last bucket is 32 or more) */
+        Uint64 voices[VOICE_BUCKETS];
+        /** The largest number of voices in a single callback */
+        Uint32 peakVoices;
+        /** The trace records dropped because the queue was full */
+        Uint64 dropped;
+
+        /**
+         * Returns the histogram for the given stage
+         *
+         * @param stage The stage to query
+         *
+         * @return the histogram for the given stage
+         */
+        const Histogram& get(Stage stage) const {
+            return stages[(int)stage];
+        }
+    };
+
+    /**
+     * The record of a single output callback
+     *
+     * All times are in microseconds. The record is written by {@link #dump}
+     * as the fields in order: time (Uint64), then frames, deadline, the
+     * {@link #STAGES} stage times, voices and underruns (all Uint32).
+     */
+    struct Trace {
+        /** The time the callback ended, measured from profiler creation */
+        Uint64 time;
+        /** The number of frames in the callback */
+        Uint32 frames;
+        /** The time to play those frames */
+        Uint32 deadline;
+        /** The time of each stage */
+        Uint32 stages[STAGES];
+        /** The number of voices mixed */
+        Uint32 voices;
+        /** The number of stream underruns */
+        Uint32 underruns;
+    };
+
+    /**
+     * A scoped timer for a single stage
+     *
+     * The timer records the time between its creation and destruction. It
+     * does nothing if the profiler is null or disabled. In that case the
+     * clock is never read.
+     */
+    class Scope {
+    private:
+        /** The profiler to record to (null if disabled) */
+        AudioProfiler* _profiler;
+        /** The stage to record */
+        Stage _stage;
+        /** The start of the timer (only set if the profiler is enabled) */
+        timestamp_t _start;
+
+    public:
+        /**
+         * Starts a timer for the given stage
+         *
+         * @param profiler  The profiler to record to (may be null)
+         * @param stage     The stage to time
+         */
+        Scope(AudioProfiler* profiler, Stage stage) :
+        _profiler(profiler && profiler->isEnabled() ? profiler : nullptr),
+        _stage(stage) {
+            if (_profiler) {
+                _start = cuclock_t::now();
+            }
+        }
+
+        /**
+         * Records the time for this stage
+         */
+        ~Scope() {
+            if (_profiler) {
+                auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(cuclock_t::now()-_start);
+                _profiler->record(_stage,(Uint64)nanos.count());
+            }
+        }
+    };
+
+private:
+    /** The atomic counters for a single stage histogram */
+    struct Counters {
+        /** The number of callbacks recorded */
+        std::atomic<Uint64> count;
+        /** The total time in microseconds */
+        std::atomic<Uint64> total;
+        /** The longest time in microseconds */
+        std::atomic<Uint64> peak;
+        /** The callbacks in each bucket */
+        std::atomic<Uint64> buckets[TIME_BUCKETS];
+    };
+
+    /** Whether the profiler is recording */
+    std::atomic<bool> _enabled;
+    /** Whether the profiler is recording a trace */
+    std::atomic<bool> _tracing;
+
+    /** The time of each stage (in nanoseconds) in the current callback */
+    std::atomic<Uint64> _current[STAGES];
+    /** The voices mixed in the current callback */
+    std::atomic<Uint32> _currvoices;
+    /** The stream underruns in the current callback */
+    std::atomic<Uint32> _currunders;
+
+    /** The number of output callbacks recorded */
+    std::atomic<Uint64> _callbacks;
+    /** The timing histogram of each stage */
+    Counters _stages[STAGES];
+    /** The callbacks in each load bucket */
+    std::atomic<Uint64> _load[LOAD_BUCKETS];
+    /** The callbacks in each voice bucket */
+    std::atomic<Uint64> _voices[VOICE_BUCKETS];
+    /** The largest number of voices in a single callback */
+    std::atomic<Uint32> _peakvoices;
+    /** The total stream underruns */
+    std::atomic<Uint64> _underruns;
+    /** The trace records dropped because the queue was full */
+    std::atomic<Uint64> _dropped;
+
+    /** The queue of trace records */
+    RingQueue<Trace> _trace;
+    /** The creation time of this profiler */
+    Timestamp _start;
+
+    /**
+     * Adds a time to the given histogram
+     *
+     * @param counters  The histogram counters
+     * @param micros    The time in microseconds
+     */
+    static void accumulate(Counters& counters, Uint64 micros);
+
+public:
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized profiler.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a profiler
+     * on the heap, use one of the static constructors instead.
+     */
+    AudioProfiler();
+
+    /**
+     * Deletes this profiler, disposing all resources
+     */
+    ~AudioProfiler() { dispose(); }
+
+    /**
+     * Initializes a disabled profiler with the given trace capacity.
+     *
+     * @param capacity  The number of trace records buffered between dumps
+     *
+     * @return true if initialization was successful
+     */
+    bool init(Uint32 capacity=DEFAULT_TRACE);
+
+    /**
+     * Disposes all resources of this profiler.
+     *
+     * This method must not be called while an audio thread is recording.
+     */
+    void dispose();
+
+    /**
+     * Returns a newly allocated disabled profiler.
+     *
+     * @param capacity  The number of trace records buffered between dumps
+     *
+     * @return a newly allocated disabled profiler.
+     */
+    static std::shared_ptr<AudioProfiler> alloc(Uint32 capacity=DEFAULT_TRACE) {
+        std::shared_ptr<AudioProfiler> result = std::make_shared<AudioProfiler>();
+        return (result->init(capacity) ? result : nullptr);
+    }
+
+#pragma mark Settings
+    /**
+     * Returns true if this profiler is recording.
+     *
+     * @return true if this profiler is recording.
+     */
+    bool isEnabled() const {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Sets whether this profiler is recording.
+     *
+     * @param value Whether this profiler is recording.
+     */
+    void setEnabled(bool value) {
+        _enabled.store(value,std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns true if this profiler is recording a trace.
+     *
+     * A trace is only recorded if the profiler is also enabled.
+     *
+     * @return true if this profiler is recording a trace.
+     */
+    bool isTracing() const {
+        return _tracing.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Sets whether this profiler is recording a trace.
+     *
+     * A trace is only recorded if the profiler is also enabled. The trace
+     * must be drained regularly with {@link #dump}, or records are dropped.
+     *
+     * @param value Whether this profiler is recording a trace.
+     */
+    void setTracing(bool value) {
+        _tracing.store(value,std::memory_order_relaxed);
+    }
+
+#pragma mark Recording
+    /**
+     * Adds the given time to a stage of the current callback
+     *
+     * AUDIO THREAD ONLY: This method is generally called by {@link Scope}.
+     *
+     * @param stage The stage to record
+     * @param nanos The time in nanoseconds
+     */
+    void record(Stage stage, Uint64 nanos) {
+        _current[(int)stage].fetch_add(nanos,std::memory_order_relaxed);
+    }
+
+    /**
+     * Adds the given number of voices to the current callback
+     *
+     * AUDIO THREAD ONLY: This method is called by {@link AudioMixer}.
+     *
+     * @param count The number of voices mixed
+     */
+    void recordVoices(Uint32 count) {
+        if (isEnabled()) {
+            _currvoices.fetch_add(count,std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Records a stream underrun in the current callback
+     *
+     * AUDIO THREAD ONLY: This method is called by {@link AudioPlayer}.
+     */
+    void recordUnderrun() {
+        if (isEnabled()) {
+            _currunders.fetch_add(1,std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Completes the statistics for an output callback
+     *
+     * AUDIO THREAD ONLY: This method is called by {@link AudioOutput}. It
+     * adds the per-callback values to the histograms, and pushes a trace
+     * record if tracing.
+     *
+     * @param nanos     The total callback time in nanoseconds
+     * @param frames    The number of frames in the callback
+     * @param rate      The sample rate of the output device
+     */
+    void endCallback(Uint64 nanos, Uint32 frames, Uint32 rate);
+
+#pragma mark Reporting
+    /**
+     * Returns a copy of the current statistics.
+     *
+     * @return a copy of the current statistics.
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * Resets all statistics to zero.
+     *
+     * This does not clear the trace queue.
+     */
+    void reset();
+
+    /**
+     * Returns a human-readable summary of the current statistics
+     *
+     * The summary gives the average, 99th percentile and peak of each stage,
+     * the load distribution, and the overrun, underrun and voice counts.
+     *
+     * @return a human-readable summary of the current statistics
+     */
+    std::string report() const;
+
+    /**
+     * Writes all pending trace records to the given writer.
+     *
+     * MAIN THREAD ONLY: The records are removed from the queue as they are
+     * written. See {@link Trace} for the record format. This method does not
+     * flush the writer.
+     *
+     * @param writer    The writer to store the trace
+     *
+     * @return the number of records written
+     */
+    size_t dump(const std::shared_ptr<BinaryWriter>& writer);
+
+    /** Profilers may not be copied */
+    AudioProfiler(const AudioProfiler&) = delete;
+    /** Profilers may not be copied */
+    AudioProfiler& operator=(const AudioProfiler&) = delete;
+};
+
+    }
+}
+#endif /* __CU_AUDIO_PROFILER_H__ */
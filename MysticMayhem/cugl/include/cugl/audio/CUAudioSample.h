@@ -54,6 +54,8 @@ namespace  cugl {
     namespace audio {
 	    /** Forward reference to a decoder type */
         class AudioDecoder;
+        /** Forward reference to the background decoder */
+        class AudioStreamer;
     }
     
 /**
@@ -68,10 +70,17 @@ namespace  cugl {
  * MP3, Ogg (Vorbis), and Flac.  As a general rule, we prefer WAV for sound 
  * effects and Ogg for music.
  *
- * All audio samples consist of float-formated PCM data. We assume channels are
- * interleaved.  We support up to 32 channels, though it is unlikely for that
+ * All audio samples are played as float-formated PCM data. We assume channels
+ * are interleaved.  We support up to 32 channels, though it is unlikely for that
  * many channels to be encoded in a sound file.  SDL itself only supports 8
  * channels for (7.1 surround) playback.
+ *
+ * By default, an in-memory sample is stored as floats. To save memory, it may
+ * instead be stored with a compact {@link Encoding}, in which case it is
+ * converted to floats as it is read. A 16 bit sample uses half the memory,
+ * and an IMA ADPCM sample uses less than a seventh. The {@link audio::AudioStreamer}
+ * keeps decoded copies of the most recently played ADPCM samples, up to a
+ * fixed memory budget, so that popular sounds are not decoded repeatedly.
  */
 class AudioSample : public Sound {
 public:
@@ -98,6 +107,23 @@ public:
         IN_MEMORY = 4
     };
 
+    /**
+     * This enum represents the storage format of an in-memory sample.
+     *
+     * The encoding has no effect on streamed samples.
+     */
+    enum class Encoding : int {
+        /** 32 bit float samples (no conversion on playback) */
+        FLOAT = 0,
+        /** 16 bit signed integer samples (half the size of FLOAT) */
+        PCM16 = 1,
+        /** 4 bit IMA ADPCM blocks (lossy, about an eighth the size of FLOAT) */
+        ADPCM = 2
+    };
+
+    /** The number of frames in a single ADPCM block */
+    static const Uint32 ADPCM_BLOCK;
+
 protected:
     /** The number of frames in this audio sample */
     Uint64 _frames;
@@ -110,6 +136,32 @@ protected:
 
     /** The in-memory sound buffer for this sound source (OPTIONAL) */
     float* _buffer;
+
+    /** The storage format of the in-memory samples */
+    Encoding _encoding;
+    /** The 16 bit samples (PCM16 ENCODING) */
+    Sint16* _pcm16;
+    /** The compressed sample blocks (ADPCM ENCODING) */
+    Uint8* _adpcm;
+    /** A decoded copy of the ADPCM blocks, managed by the streamer (OPTIONAL) */
+    std::atomic<float*> _decoded;
+    /** The number of playbacks started since the streamer last checked */
+    std::atomic<Uint32> _starts;
+    /** Whether this sample has been registered with the streamer */
+    bool _tracked;
+
+    /** Allow the streamer to manage the decoded copy */
+    friend class audio::AudioStreamer;
+
+    /**
+     * Returns a newly allocated float copy of the ADPCM blocks
+     *
+     * The copy is allocated with SDL_malloc and contains channels * frames
+     * elements. This method returns nullptr if the sample is not ADPCM.
+     *
+     * @return a newly allocated float copy of the ADPCM blocks
+     */
+    float* decodeADPCM() const;
     
 public:
 #pragma mark Constructors
@@ -131,29 +183,33 @@ public:
      *
      * The choice of buffered or streaming is independent of the file type.
      * If the file is streamed, it will not be loaded into memory.  Otherwise,
-     * this initializer will allocate memory to read the asset into memory.
+     * this initializer will allocate memory to read the asset into memory,
+     * storing it with the given encoding.
      *
      * @param file      The source file for the audio sample
      * @param stream    Wether to stream the audio from the file.
+     * @param encoding  The storage format for an in-memory sample
      *
      * @return true if the sound source was initialized successfully
      */
-    bool init(const char* file, bool stream=false);
+    bool init(const char* file, bool stream=false, Encoding encoding=Encoding::FLOAT);
     
     /**
      * Initializes a new audio sample for the given file.
      *
      * The choice of buffered or streaming is independent of the file type.
      * If the file is streamed, it will not be loaded into memory.  Otherwise,
-     * this initializer will allocate memory to read the asset into memory.
+     * this initializer will allocate memory to read the asset into memory,
+     * storing it with the given encoding.
      *
      * @param file      The source file for the audio sample
      * @param stream    Wether to stream the audio from the file.
+     * @param encoding  The storage format for an in-memory sample
      *
      * @return true if the sound source was initialized successfully
      */
-    bool init(const std::string& file, bool stream=false) {
-        return init(file.c_str(),stream);
+    bool init(const std::string& file, bool stream=false, Encoding encoding=Encoding::FLOAT) {
+        return init(file.c_str(),stream,encoding);
     }
     
     /**
@@ -170,6 +226,28 @@ public:
      * @return true if the audio sample was initialized successfully
      */
     bool init(Uint8 channels, Uint32 rate, Uint32 frames);
+
+    /**
+     * Initializes an in-memory audio sample from previously decoded samples.
+     *
+     * The samples must be in the given storage format, as returned by
+     * {@link getSamples} for a sample with the same encoding, channels and
+     * frames. They are copied, so the data may be released afterwards. The
+     * file is only recorded as the source; it is not read. This method fails
+     * if the size does not match the channels, frames and encoding.
+     *
+     * @param file      The source file for the audio sample
+     * @param channels  The number of audio channels
+     * @param rate      The sampling rate of this source
+     * @param frames    The number of frames in this source
+     * @param encoding  The storage format of the samples
+     * @param data      The samples in the storage format
+     * @param size      The number of bytes of samples
+     *
+     * @return true if the audio sample was initialized successfully
+     */
+    bool initWithSamples(const std::string& file, Uint8 channels, Uint32 rate, Uint64 frames,
+                         Encoding encoding, const void* data, size_t size);
     
     /**
      * Deletes the sample resources and resets all attributes.
@@ -211,16 +289,19 @@ public:
      *
      * The choice of buffered or streaming is independent of the file type.
      * If the file is streamed, it will not be loaded into memory.  Otherwise,
-     * this initializer will allocate memory to read the asset into memory.
+     * this initializer will allocate memory to read the asset into memory,
+     * storing it with the given encoding.
      *
      * @param file      The source file for the audio sample
      * @param stream    Wether to stream the audio from the file.
+     * @param encoding  The storage format for an in-memory sample
      *
      * @return a newly allocated audio sample for the given file.
      */
-    static std::shared_ptr<AudioSample> alloc(const char* file, bool stream=false) {
+    static std::shared_ptr<AudioSample> alloc(const char* file, bool stream=false,
+                                              Encoding encoding=Encoding::FLOAT) {
         std::shared_ptr<AudioSample> result = std::make_shared<AudioSample>();
-        return (result->init(file,stream) ? result : nullptr);
+        return (result->init(file,stream,encoding) ? result : nullptr);
     }
     
     /**
@@ -228,15 +309,18 @@ public:
      *
      * The choice of buffered or streaming is independent of the file type.
      * If the file is streamed, it will not be loaded into memory.  Otherwise,
-     * this initializer will allocate memory to read the asset into memory.
+     * this initializer will allocate memory to read the asset into memory,
+     * storing it with the given encoding.
      *
      * @param file      The source file for the audio sample
      * @param stream    Wether to stream the audio from the file.
+     * @param encoding  The storage format for an in-memory sample
      *
      * @return a newly allocated audio sample for the given file.
      */
-    static std::shared_ptr<AudioSample> alloc(const std::string& file, bool stream=false) {
-        return alloc(file.c_str(), stream);
+    static std::shared_ptr<AudioSample> alloc(const std::string& file, bool stream=false,
+                                              Encoding encoding=Encoding::FLOAT) {
+        return alloc(file.c_str(), stream, encoding);
     }
     
     /**
@@ -266,11 +350,13 @@ public:
      *
      *      "file":     The path to the source, relative to the asset directory
      *      "stream":   A boolean, indicating whether to stream the sample
+     *      "encoding": One of "float", "pcm16", or "adpcm" (in-memory only)
      *      "volume":   A float, representing the volume
      *
      * All attributes are optional.  There are no required attributes. By default,
      * audio samples are not streamed, meaning they are fully loaded into memory.
-     * This is recommended for sound effects, but not for music.
+     * This is recommended for sound effects, but not for music. In-memory
+     * samples are stored as floats unless another encoding is specified.
      *
      * @param data      The JSON object specifying the audio sample
      *
@@ -278,6 +364,44 @@ public:
      */
     static std::shared_ptr<AudioSample> allocWithData(const std::shared_ptr<JsonValue>& data);
 
+    /**
+     * Returns a newly allocated in-memory audio sample from decoded samples.
+     *
+     * The samples must be in the given storage format, as returned by
+     * {@link getSamples} for a sample with the same encoding, channels and
+     * frames. They are copied, so the data may be released afterwards. The
+     * file is only recorded as the source; it is not read. This method fails
+     * if the size does not match the channels, frames and encoding.
+     *
+     * @param file      The source file for the audio sample
+     * @param channels  The number of audio channels
+     * @param rate      The sampling rate of this source
+     * @param frames    The number of frames in this source
+     * @param encoding  The storage format of the samples
+     * @param data      The samples in the storage format
+     * @param size      The number of bytes of samples
+     *
+     * @return a newly allocated in-memory audio sample from decoded samples.
+     */
+    static std::shared_ptr<AudioSample> allocWithSamples(const std::string& file, Uint8 channels,
+                                                         Uint32 rate, Uint64 frames,
+                                                         Encoding encoding, const void* data, size_t size) {
+        std::shared_ptr<AudioSample> result = std::make_shared<AudioSample>();
+        return (result->initWithSamples(file,channels,rate,frames,encoding,data,size) ? result : nullptr);
+    }
+
+    /**
+     * Returns the encoding with the given name.
+     *
+     * The name is one of "float", "pcm16", or "adpcm", as used by the JSON
+     * specification of {@link allocWithData}. Any other name is FLOAT.
+     *
+     * @param name  The encoding name
+     *
+     * @return the encoding with the given name.
+     */
+    static Encoding parseEncoding(const std::string& name);
+
         
 #pragma mark Attributes
     /**
@@ -297,6 +421,25 @@ public:
      * @return the encoding type for this audio sample
      */
     Type getType() const { return _type; }
+
+    /**
+     * Returns the storage format of this audio sample
+     *
+     * Streamed samples and empty samples are always FLOAT.
+     *
+     * @return the storage format of this audio sample
+     */
+    Encoding getEncoding() const { return _encoding; }
+
+    /**
+     * Returns the number of bytes of sample data resident in memory.
+     *
+     * This includes the decoded copy of an ADPCM sample, if the streamer
+     * currently holds one. Streamed samples have no resident data.
+     *
+     * @return the number of bytes of sample data resident in memory.
+     */
+    size_t getMemoryUsage() const;
     
     /**
      * Returns the frame length of this audio sample.
@@ -316,17 +459,60 @@ public:
      */
     virtual double getDuration() const override { return (double)_frames/(double)_rate; }
     
+    /**
+     * Returns the in-memory samples in their storage format.
+     *
+     * Depending on the encoding, this is an array of floats, an array of 16
+     * bit integers, or a sequence of ADPCM blocks. It is nullptr if the sample
+     * is streamed. The samples may be passed to {@link initWithSamples} to
+     * recreate this sample without decoding the file again.
+     *
+     * @return the in-memory samples in their storage format.
+     */
+    const void* getSamples() const;
+
+    /**
+     * Returns the number of bytes returned by {@link getSamples}.
+     *
+     * Unlike {@link getMemoryUsage}, this does not include the decoded copy
+     * of an ADPCM sample.
+     *
+     * @return the number of bytes returned by {@link getSamples}.
+     */
+    size_t getSampleBytes() const;
+    
 #pragma mark Playback Support
     /**
      * Returns the underlying PCM data buffer.
      *
-     * This pointer will be null if the sample is streamed.  Otherwise, the
-     * the buffer will contain channels * frames many elements. It is okay to
-     * write data to the buffer, but it cannot be resized or reassigned.
+     * This pointer will be null if the sample is streamed or has a compact
+     * encoding.  Otherwise, the buffer will contain channels * frames many
+     * elements. It is okay to write data to the buffer, but it cannot be
+     * resized or reassigned.
      *
      * @return the underlying PCM data buffer.
      */
     float* getBuffer() { return _buffer; }
+
+    /**
+     * Reads frames from an in-memory sample, converting them to floats.
+     *
+     * This method is safe to call from the audio thread. It never allocates
+     * memory. If the sample has a compact encoding, the frames are converted
+     * as they are copied (unless the streamer holds a decoded copy). Reading
+     * from the start of the sample counts as a playback for the purposes of
+     * the decoded copy cache.
+     *
+     * The buffer must have room for frames * channels elements. This method
+     * does nothing if the sample is streamed.
+     *
+     * @param buffer    The buffer to store the frames
+     * @param frame     The absolute position of the first frame to read
+     * @param frames    The maximum number of frames to read
+     *
+     * @return the number of frames read
+     */
+    Uint32 read(float* buffer, Uint64 frame, Uint32 frames);
         
     /**
      * Returns a new decoder for this audio sample
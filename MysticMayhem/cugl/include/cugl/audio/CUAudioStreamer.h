@@ -0,0 +1,495 @@
+//
+//  CUAudioStreamer.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides support for decoding streamed audio samples off the
+//  audio thread. A streamed sample (such as OGG or MP3 music) is not loaded
+//  into memory. Previously, each player decoded its pages on demand inside
+//  of the audio callback, which meant that codec work (and file access) could
+//  cause the callback to miss its deadline.
+//
+//  Instead, each streamed player now owns a page cache. The cache holds a
+//  fixed number of decoded pages in a wait-free ring, filled ahead of the
+//  read position by a single background streamer thread. The audio thread
+//  only ever copies decoded frames out of the cache. The first few pages of
+//  the sample are decoded once (when the cache is created) and kept resident,
+//  so that loops and queued tracks can start without waiting on the decoder.
+//
+//  These classes use our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#ifndef __CU_AUDIO_STREAMER_H__
+#define __CU_AUDIO_STREAMER_H__
+#include <SDL/SDL.h>
+#include <cugl/audio/codecs/CUAudioDecoder.h>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cugl {
+
+/** Forward reference to an in-memory sample */
+class AudioSample;
+
+    /**
+     * The audio graph classes.
+     *
+     * This internal namespace is for the audio graph clases.  It was chosen
+     * to distinguish this graph from other graph class collections, such as the
+     * scene graph collections in {@link scene2}.
+     */
+    namespace audio {
+
+#pragma mark -
+#pragma mark Page Cache
+/**
+ * This class is a read-ahead cache of decoded pages for a streamed sample.
+ *
+ * A page cache is created for every {@link AudioPlayer} of a streamed
+ * {@link cugl::AudioSample}. It is a single-producer, single-consumer structure.
+ * The producer is the {@link AudioStreamer} thread, which calls {@link #fill}
+ * to decode pages ahead of the read position. The consumer is the audio
+ * thread, which calls {@link #read} to copy decoded frames. Neither method
+ * ever blocks on the other thread, and {@link #read} never touches the
+ * decoder.
+ *
+ * The cache has two parts. The anchor is the first few pages of the sample,
+ * which are decoded when the cache is initialized and never released. This
+ * allows a player to start (or loop back to the beginning) immediately. The
+ * ring holds the pages after the read position. Its size is computed from
+ * the page size of the decoder so that it covers a fixed read-ahead time.
+ * Hence the memory used by a streamed sample is bounded regardless of the
+ * length of the sample.
+ *
+ * Reading out of order requires a call to {@link #seek}. This discards any
+ * pages in the ring and restarts decoding at the new position. Seeking to
+ * a position inside of the anchor takes effect immediately.
+ */
+class AudioPageCache {
+private:
+    /**
+     * An inner class storing the metadata of a single ring slot.
+     */
+    class Slot {
+    public:
+        /** The decoder page stored in this slot */
+        Uint64 page;
+        /** The number of frames in this page (less than a full page at the end) */
+        Uint32 frames;
+        /** The seek epoch that produced this page */
+        Uint32 epoch;
+    };
+
+    /** The decoder for this cache (PRODUCER THREAD ONLY after initialization) */
+    std::shared_ptr<AudioDecoder> _decoder;
+    /** The number of channels in the stream */
+    Uint32 _channels;
+    /** The number of frames in a single page */
+    Uint32 _pagesize;
+
+    /** The decoded frames at the start of the stream */
+    float* _anchor;
+    /** The number of frames in the anchor */
+    Uint64 _anchorsize;
+    /** The number of pages in the anchor */
+    Uint64 _anchorpages;
+
+    /** The decoded frames of the ring, one page per slot */
+    float* _pages;
+    /** The metadata for each ring slot */
+    Slot* _slots;
+    /** The number of slots in the ring */
+    Uint32 _capacity;
+    /** The next slot to read (written only by the consumer) */
+    std::atomic<Uint32> _head;
+    /** The next slot to write (written only by the producer) */
+    std::atomic<Uint32> _tail;
+
+    /** The requested read position, packed with the seek epoch */
+    std::atomic<Uint64> _request;
+    /** The first frame past the end of the stream (if known) */
+    std::atomic<Uint64> _endframe;
+    /** The number of reads that ran ahead of the producer */
+    std::atomic<Uint32> _underruns;
+
+    /** The epoch of the current producer position (PRODUCER ONLY) */
+    Uint32 _epoch;
+    /** The next page to decode (PRODUCER ONLY) */
+    Uint64 _nextpage;
+    /** Whether the producer has reached the end of the stream (PRODUCER ONLY) */
+    bool _finished;
+
+public:
+    /** The default read-ahead time of the ring in seconds */
+    static const double DEFAULT_READAHEAD;
+    /** The minimum number of pages in the ring or anchor */
+    static const Uint32 MIN_PAGES;
+
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized page cache.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a cache on
+     * the heap, use one of the static constructors instead.
+     */
+    AudioPageCache();
+
+    /**
+     * Deletes this page cache, releasing all resources.
+     */
+    ~AudioPageCache() { dispose(); }
+
+    /**
+     * Disposes this page cache, releasing all resources.
+     *
+     * This method is not thread-safe, and should only be called when no
+     * other thread is accessing the cache.
+     */
+    void dispose();
+
+    /**
+     * Initializes a page cache for the given decoder.
+     *
+     * The cache takes ownership of the decoder, which should not be used by
+     * any other object. Both the anchor and the ring are sized to hold the
+     * given read-ahead time (but never fewer than {@link #MIN_PAGES} pages).
+     * The anchor is decoded immediately, so this method should be called on
+     * the main thread and not the audio thread.
+     *
+     * @param decoder   The decoder for the streamed sample
+     * @param readahead The read-ahead time in seconds
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(const std::shared_ptr<AudioDecoder>& decoder, double readahead=DEFAULT_READAHEAD);
+
+    /**
+     * Returns a newly allocated page cache for the given decoder.
+     *
+     * The cache takes ownership of the decoder, which should not be used by
+     * any other object. Both the anchor and the ring are sized to hold the
+     * given read-ahead time (but never fewer than {@link #MIN_PAGES} pages).
+     * The anchor is decoded immediately, so this method should be called on
+     * the main thread and not the audio thread.
+     *
+     * @param decoder   The decoder for the streamed sample
+     * @param readahead The read-ahead time in seconds
+     *
+     * @return a newly allocated page cache for the given decoder.
+     */
+    static std::shared_ptr<AudioPageCache> alloc(const std::shared_ptr<AudioDecoder>& decoder,
+                                                 double readahead=DEFAULT_READAHEAD) {
+        std::shared_ptr<AudioPageCache> result = std::make_shared<AudioPageCache>();
+        return (result->init(decoder,readahead) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Consumer Methods
+    /**
+     * Copies up to the given number of frames starting at the given position.
+     *
+     * AUDIO THREAD ONLY: This method should only be called by the consumer.
+     *
+     * The frames are interleaved into the buffer, which must have room for
+     * frames * channels elements. Reads must be sequential: the position
+     * should be the end of the previous read unless {@link #seek} was called
+     * in between.
+     *
+     * This method never decodes. If the producer has not yet decoded the
+     * requested frames, it copies as many as are available and returns early.
+     * Use {@link #isEnded} to distinguish this from the end of the stream.
+     *
+     * @param buffer    The buffer to store the frames
+     * @param frame     The absolute position of the first frame to read
+     * @param frames    The maximum number of frames to read
+     *
+     * @return the number of frames copied
+     */
+    Uint32 read(float* buffer, Uint64 frame, Uint32 frames);
+
+    /**
+     * Returns true if the given position is at or past the end of the stream.
+     *
+     * The end of the stream is only known once the producer has decoded the
+     * final page. Until then, this method returns false.
+     *
+     * @param frame     The absolute frame position
+     *
+     * @return true if the given position is at or past the end of the stream.
+     */
+    bool isEnded(Uint64 frame) const {
+        return frame >= _endframe.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Requests that future reads start at the given position.
+     *
+     * This method may be called from any thread. It discards all pages in the
+     * ring, and the producer restarts decoding at the page containing the
+     * given frame. If the frame is in the anchor, reads resume immediately.
+     *
+     * @param frame     The absolute frame position
+     */
+    void seek(Uint64 frame);
+
+    /**
+     * Returns the number of reads that ran ahead of the producer.
+     *
+     * Each underrun is a read that could not be completely satisfied from
+     * the cache before the end of the stream. A non-zero value means the
+     * read-ahead time is too short for the current load.
+     *
+     * @return the number of reads that ran ahead of the producer.
+     */
+    Uint32 getUnderruns() const { return _underruns.load(std::memory_order_relaxed); }
+
+#pragma mark -
+#pragma mark Producer Methods
+    /**
+     * Decodes at most one page into the ring.
+     *
+     * STREAMER THREAD ONLY: This method should only be called by the producer.
+     *
+     * If the read position was changed by {@link #seek}, the decoder is
+     * repositioned first. This method does nothing if the ring is full or
+     * the stream is finished.
+     *
+     * @return true if a page was decoded
+     */
+    bool fill();
+
+    /** Caches may not be copied (the threads would not share the copy) */
+    AudioPageCache(const AudioPageCache&) = delete;
+    /** Caches may not be copied (the threads would not share the copy) */
+    AudioPageCache& operator=(const AudioPageCache&) = delete;
+};
+
+#pragma mark -
+#pragma mark Streamer
+/**
+ * This class is a background thread for decoding streamed samples.
+ *
+ * The streamer fills the {@link AudioPageCache} of every streamed player,
+ * taking one page from each cache in turn so that no stream can starve the
+ * others. When every cache is full, the thread sleeps until a new cache is
+ * attached or a short poll interval passes (to pick up seeks and consumed
+ * pages, which the audio thread cannot signal without a lock).
+ *
+ * A streamer does not keep caches alive. Once a cache is released by its
+ * player, the streamer drops it on the next pass, disposing the decoder on
+ * the streamer thread.
+ *
+ * The streamer also manages the decoded copies of ADPCM samples (see
+ * {@link AudioSample#Encoding}). It tracks how recently each sample was
+ * played, and keeps float copies of the most recently played samples that
+ * fit in the cache budget. This is a least-recently-used cache: when the
+ * budget is exceeded, the copies of the samples played longest ago are
+ * released. The audio thread may be reading a copy at the moment it is
+ * released, so released copies are only freed after a grace period.
+ *
+ * There is normally one streamer, owned by {@link cugl::AudioDevices}. Caches
+ * and samples should only be attached from the main thread.
+ */
+class AudioStreamer {
+private:
+    /** The streamer thread */
+    SDL_Thread* _thread;
+    /** The mutex protecting the pending caches */
+    std::mutex _mutex;
+    /** The condition to wake the streamer thread */
+    std::condition_variable _condition;
+    /** The caches attached since the last pass */
+    std::vector<std::shared_ptr<AudioPageCache>> _pending;
+    /** The caches being filled (STREAMER THREAD ONLY) */
+    std::vector<std::shared_ptr<AudioPageCache>> _active;
+    /** Whether the streamer thread should keep running */
+    std::atomic<bool> _running;
+
+    /**
+     * An inner class storing the recency of an ADPCM sample.
+     */
+    class Entry {
+    public:
+        /** The tracked sample (which may be deleted at any time) */
+        std::weak_ptr<AudioSample> sample;
+        /** The pass when this sample was last played (0 if never) */
+        Uint64 stamp;
+    };
+
+    /**
+     * An inner class storing a decoded copy waiting to be freed.
+     */
+    class Retired {
+    public:
+        /** The decoded copy */
+        float* buffer;
+        /** The time when the copy was released (in milliseconds) */
+        Uint64 time;
+    };
+
+    /** The samples tracked since the last pass */
+    std::vector<std::shared_ptr<AudioSample>> _fresh;
+    /** The tracked samples in least-recently-used order (STREAMER THREAD ONLY) */
+    std::vector<Entry> _samples;
+    /** The released copies not yet freed (STREAMER THREAD ONLY) */
+    std::vector<Retired> _retired;
+    /** The memory budget for decoded copies in bytes */
+    std::atomic<size_t> _budget;
+    /** The number of cache passes so far (STREAMER THREAD ONLY) */
+    Uint64 _passes;
+    /** The time of the last cache pass in milliseconds (STREAMER THREAD ONLY) */
+    Uint64 _lastpass;
+
+    /**
+     * The body function of the streamer thread.
+     *
+     * @param streamer  The streamer object
+     *
+     * @return the thread exit status
+     */
+    static int threadFunc(void* streamer);
+
+    /**
+     * Runs the fill loop until this streamer is disposed.
+     */
+    void run();
+
+    /**
+     * Updates the decoded copies of the tracked samples.
+     *
+     * This method decodes the most recently played samples that fit in the
+     * budget, and releases the rest. It also frees any released copies that
+     * are past the grace period.
+     *
+     * @param now   The current time in milliseconds
+     */
+    void update(Uint64 now);
+
+public:
+    /** The default memory budget for decoded copies in bytes */
+    static const size_t DEFAULT_CACHE_BUDGET;
+
+#pragma mark Constructors
+    /**
+     * Creates an inactive streamer.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a streamer on
+     * the heap, use one of the static constructors instead.
+     */
+    AudioStreamer();
+
+    /**
+     * Deletes this streamer, stopping the thread.
+     */
+    ~AudioStreamer() { dispose(); }
+
+    /**
+     * Disposes this streamer, stopping the thread.
+     *
+     * This method blocks until the thread has finished. Any attached caches
+     * stop filling, though they remain valid for their players.
+     */
+    void dispose();
+
+    /**
+     * Initializes this streamer, starting the thread.
+     *
+     * @return true if initialization was successful.
+     */
+    bool init();
+
+    /**
+     * Returns a newly allocated streamer with a running thread.
+     *
+     * @return a newly allocated streamer with a running thread.
+     */
+    static std::shared_ptr<AudioStreamer> alloc() {
+        std::shared_ptr<AudioStreamer> result = std::make_shared<AudioStreamer>();
+        return (result->init() ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Cache Management
+    /**
+     * Attaches a page cache to this streamer.
+     *
+     * The streamer will start filling the cache immediately. The streamer
+     * only holds the cache until it is released by its owner.
+     *
+     * @param cache The page cache to fill
+     */
+    void attach(const std::shared_ptr<AudioPageCache>& cache);
+
+#pragma mark -
+#pragma mark Sample Cache
+    /**
+     * Tracks an ADPCM sample for the decoded copy cache.
+     *
+     * Once tracked, the streamer keeps a decoded copy of the sample while it
+     * is among the most recently played samples that fit in the budget. The
+     * streamer does not keep the sample alive. Tracking a sample twice, or
+     * tracking a sample that is not ADPCM, has no effect.
+     *
+     * @param sample    The sample to track
+     */
+    void track(const std::shared_ptr<AudioSample>& sample);
+
+    /**
+     * Returns the memory budget for decoded copies in bytes.
+     *
+     * @return the memory budget for decoded copies in bytes.
+     */
+    size_t getCacheBudget() const { return _budget.load(std::memory_order_relaxed); }
+
+    /**
+     * Sets the memory budget for decoded copies in bytes.
+     *
+     * A budget of 0 disables the cache, so that ADPCM samples are always
+     * decoded as they are played. The new budget takes effect on the next
+     * pass of the streamer thread.
+     *
+     * @param bytes The memory budget for decoded copies in bytes.
+     */
+    void setCacheBudget(size_t bytes) { _budget.store(bytes,std::memory_order_relaxed); }
+
+    /** Streamers may not be copied */
+    AudioStreamer(const AudioStreamer&) = delete;
+    /** Streamers may not be copied */
+    AudioStreamer& operator=(const AudioStreamer&) = delete;
+};
+
+    }
+}
+
+#endif /* __CU_AUDIO_STREAMER_H__ */
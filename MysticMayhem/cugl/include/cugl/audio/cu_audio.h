@@ -32,8 +32,10 @@
 
 #include "CUAudioDevices.h"
 #include "CUAudioEngine.h"
+#include "CUAudioProfiler.h"
 #include "CUAudioQueue.h"
 #include "CUAudioSample.h"
+#include "CUAudioStreamer.h"
 #include "CUAudioWaveform.h"
 #include "CUSound.h"
 
@@ -0,0 +1,177 @@
+//
+//  CUAudioClock.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a sample clock for an audio graph. The clock counts
+//  the frames pulled from the graph by its terminal node (an AudioOutput or
+//  an AudioRenderer). Nodes such as AudioScheduler use this clock to start
+//  and swap audio at an exact sample, instead of at the start of the next
+//  buffer. The main thread uses the same clock to timestamp those events.
+//
+//  The clock is advanced by the audio thread once per buffer. The main thread
+//  can estimate the time between buffers, as the clock also records the wall
+//  time of each advance. All access is lock-free.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#ifndef __CU_AUDIO_CLOCK_H__
+#define __CU_AUDIO_CLOCK_H__
+#include <SDL/SDL.h>
+#include <cugl/util/CUTimestamp.h>
+#include <atomic>
+#include <memory>
+
+namespace cugl {
+    namespace audio {
+
+/**
+ * This class is a sample clock shared by the nodes of an audio graph.
+ *
+ * The time of the clock is measured in frames at the sample rate of the
+ * graph. During a read of the graph, {@link #getFrames} is the time of the
+ * first frame of the buffer being read. After the read, the terminal node
+ * calls {@link #advance} with the size of the buffer. Hence a node can place
+ * an event at an exact position in the buffer, as long as the event has a
+ * timestamp on this clock.
+ *
+ * The main thread cannot see the position within the current buffer, as the
+ * clock only moves once a buffer. Instead, {@link #estimate} adds the time
+ * since the last advance (up to one buffer). Events stamped with this
+ * estimate have a constant delay of one buffer, rather than a delay that
+ * varies with the time of the request.
+ *
+ * Only one thread may advance the clock, but any thread may read it.
+ */
+class AudioClock {
+private:
+    /** The sample rate of the clock */
+    Uint32 _rate;
+    /** The creation time of the clock */
+    Timestamp _origin;
+    /** The sequence number protecting the values below (odd when writing) */
+    std::atomic<Uint32> _sequence;
+    /** The number of frames since the clock was started */
+    std::atomic<Uint64> _frames;
+    /** The nanoseconds from creation to the last advance */
+    std::atomic<Uint64> _stamp;
+    /** The number of frames in the last advance */
+    std::atomic<Uint32> _block;
+
+public:
+#pragma mark Constructors
+    /**
+     * Creates a clock with no sample rate.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a clock on
+     * the heap, use the static constructor instead.
+     */
+    AudioClock();
+
+    /**
+     * Deletes this clock, disposing of all resources
+     */
+    ~AudioClock() {}
+
+    /**
+     * Initializes a clock at time 0 for the given sample rate.
+     *
+     * @param rate  The sample rate (frequency) in HZ
+     *
+     * @return true if initialization was successful
+     */
+    bool init(Uint32 rate);
+
+    /**
+     * Returns a newly allocated clock at time 0 for the given sample rate.
+     *
+     * @param rate  The sample rate (frequency) in HZ
+     *
+     * @return a newly allocated clock at time 0 for the given sample rate.
+     */
+    static std::shared_ptr<AudioClock> alloc(Uint32 rate) {
+        std::shared_ptr<AudioClock> result = std::make_shared<AudioClock>();
+        return (result->init(rate) ? result : nullptr);
+    }
+
+#pragma mark Time
+    /**
+     * Returns the sample rate of this clock
+     *
+     * @return the sample rate of this clock
+     */
+    Uint32 getRate() const { return _rate; }
+
+    /**
+     * Returns the current time of this clock in frames.
+     *
+     * During a read of the audio graph, this is the time of the first frame
+     * in the read buffer.
+     *
+     * @return the current time of this clock in frames.
+     */
+    Uint64 getFrames() const {
+        return _frames.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns the estimated time of this clock in frames.
+     *
+     * This value adds the wall time since the last advance to the current
+     * time. The addition is limited to the size of the last buffer, so the
+     * estimate never passes the start of the next buffer.
+     *
+     * @return the estimated time of this clock in frames.
+     */
+    Uint64 estimate() const;
+
+    /**
+     * Converts a time in seconds to frames at the rate of this clock
+     *
+     * @param seconds   The time in seconds
+     *
+     * @return the time in frames
+     */
+    Uint64 toFrames(double seconds) const {
+        return seconds > 0 ? (Uint64)(seconds*_rate+0.5) : 0;
+    }
+
+    /**
+     * Advances the clock by the given number of frames.
+     *
+     * AUDIO THREAD ONLY: This method should only be called by the terminal
+     * node of the audio graph, after it has read the given number of frames.
+     *
+     * @param frames    The number of frames read
+     */
+    void advance(Uint32 frames);
+
+    /**
+     * Resets the clock to time 0.
+     *
+     * This should only be called when the audio graph is not being read.
+     */
+    void reset();
+};
+
+    }
+}
+#endif /* __CU_AUDIO_CLOCK_H__ */
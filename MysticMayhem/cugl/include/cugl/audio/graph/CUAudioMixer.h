@@ -10,6 +10,12 @@
 //  results may exceed the range [-1,1], causing clipping.  The mixer provides
 //  a "soft-knee" option for confining the results to the range [-1,1].
 //
+//  The audio thread never blocks on the main thread in this node. Changes to
+//  the inputs are posted to a wait-free command queue and applied at the start
+//  of the next buffer. Operations that must touch the inputs directly use a
+//  short exclusive section in which the audio thread outputs silence rather
+//  than waiting.
+//
 //  CUGL MIT License:
 //
 //     This software is provided 'as-is', without any express or implied
@@ -36,7 +42,7 @@
 #ifndef __CU_AUDIO_MIXER_H__
 #define __CU_AUDIO_MIXER_H__
 #include "CUAudioNode.h"
-#include <mutex>
+#include <cugl/util/CURingQueue.h>
 
 namespace cugl {
 
@@ -65,25 +71,54 @@ namespace cugl {
  * The audio graph should only be accessed in the main thread.  In addition,
  * no methods marked as AUDIO THREAD ONLY should ever be accessed by the user.
  *
+ * The mixer keeps two copies of its inputs: one for the main thread and one
+ * for the audio thread. The methods {@link #attach} and {@link #detach} update
+ * the main thread copy immediately, and post the change to a wait-free queue.
+ * The audio thread applies these changes at the start of its next buffer.
+ * Nodes removed by the audio thread are handed back to the main thread, so
+ * that they are never deleted on the audio thread.
+ *
  * This class does not support any actions for the {@link AudioNode#setCallback}.
  */
 class AudioMixer : public AudioNode {
 private:
-    /** The input nodes to be mixed */
+    /**
+     * An inner class representing a change to an input slot.
+     */
+    class Command {
+    public:
+        /** The node to place in the slot (nullptr to detach) */
+        std::shared_ptr<AudioNode> node;
+        /** The slot to change */
+        Uint8 slot;
+    };
+    
+    /** The input nodes to be mixed (AUDIO THREAD ONLY) */
     std::shared_ptr<AudioNode>* _inputs;
+    /** The input nodes as seen by the main thread */
+    std::shared_ptr<AudioNode>* _attached;
     /** The number of input nodes supported by this mixer */
     Uint8 _width;
+    
+    /** The input changes waiting for the audio thread */
+    RingQueue<Command> _commands;
+    /** The input nodes removed by the audio thread, waiting for deletion */
+    RingQueue<std::shared_ptr<AudioNode>> _retired;
+    /** Whether the audio thread is currently reading the inputs */
+    std::atomic<bool> _reading;
+    /** Whether the main thread has exclusive access to the inputs */
+    std::atomic<bool> _editing;
 
-    /** The intermediate buffer for the mixed result */
+    /** The intermediate buffers for the inputs (one slice per slot) */
     float* _buffer;
-    /** The capacity of the intermediate buffer */
+    /** The slices of the intermediate buffer read this pass (AUDIO THREAD ONLY) */
+    float** _sources;
+    /** The capacity (in frames) of each intermediate buffer slice */
     Uint32 _capacity;
     
     /** The knee value for clamping */
     std::atomic<float>  _knee;
 
-    /** This class needs a proper lock guard; too many race conditions */
-    std::mutex _mutex;
     /** The current read position */
     std::atomic<Uint64> _offset;
     /** The last marked position (starts at 0) */
@@ -95,6 +130,8 @@ public:
     static const Uint8 DEFAULT_WIDTH;
     /** The standard knee value for preventing clipping */
     static const float DEFAULT_KNEE;
+    /** The number of input changes that may be pending at once */
+    static const Uint32 COMMAND_CAPACITY;
 
     /**
      * Creates a degenerate mizer that takes no inputs
@@ -171,6 +208,28 @@ public:
      * @return true if initialization was successful
      */
     bool init(Uint8 width, Uint8 channels, Uint32 rate);
+
+    /**
+     * Initializes the mixer with the given channels, sample rate and capacity
+     *
+     * These values determine the buffer the structure for all {@link read}
+     * operations.  In addition, they also detemine exactly which audio nodes
+     * are supported by this mixer.  A mixer can only mix nodes that agree
+     * on both sample rate and frequency.
+     *
+     * The capacity is the largest number of frames the mixer will produce in
+     * a single read. The other initializers use the read size of the audio
+     * device manager. Graphs that are not attached to a device (such as one
+     * read by an {@link AudioRenderer}) should use this initializer instead.
+     *
+     * @param width     The number of audio nodes that may be attached to this mixer
+     * @param channels  The number of audio channels
+     * @param rate      The sample rate (frequency) in HZ
+     * @param capacity  The maximum number of frames in a single read
+     *
+     * @return true if initialization was successful
+     */
+    bool init(Uint8 width, Uint8 channels, Uint32 rate, Uint32 capacity);
     
     /**
      * Disposes any resources allocated for this mixer
@@ -220,6 +279,30 @@ public:
         std::shared_ptr<AudioMixer> result = std::make_shared<AudioMixer>();
         return (result->init(width,channels, rate) ? result : nullptr);
     }
+
+    /**
+     * Returns a newly allocated mixer with the given channels, sample rate and capacity
+     *
+     * These values determine the buffer the structure for all {@link read}
+     * operations.  In addition, they also detemine exactly which audio nodes
+     * are supported by this mixer.  A mixer can only mix nodes that agree
+     * on both sample rate and frequency.
+     *
+     * The capacity is the largest number of frames the mixer will produce in
+     * a single read. Use this allocator for graphs that are not attached to
+     * a device, such as one read by an {@link AudioRenderer}.
+     *
+     * @param width     The number of audio nodes that may be attached to this mixer
+     * @param channels  The number of audio channels
+     * @param rate      The sample rate (frequency) in HZ
+     * @param capacity  The maximum number of frames in a single read
+     *
+     * @return a newly allocated mixer with the given channels, sample rate and capacity
+     */
+    static std::shared_ptr<AudioMixer> alloc(Uint8 width, Uint8 channels, Uint32 rate, Uint32 capacity) {
+        std::shared_ptr<AudioMixer> result = std::make_shared<AudioMixer>();
+        return (result->init(width,channels,rate,capacity) ? result : nullptr);
+    }
     
 #pragma mark -
 #pragma mark Audio Graph Methods
@@ -279,13 +362,16 @@ public:
     /**
      * Sets the width of this mixer.
      *
-     * The width is the number of supported input slots. This method will only
-     * succeed if the mixer is paused.  Otherwise, it will fail.
+     * The width is the number of supported input slots. This method may be
+     * called at any time. The audio thread outputs silence for (at most) one
+     * buffer while the inputs are reallocated.
      *
      * Once the width is adjusted, the children will be reassigned in order.
      * If the new width is less than the old width, children at the end of
      * the mixer will be dropped.
      *
+     * @param width The number of supported input slots
+     *
      * @return true if the mixer width was reset
      */
     bool setWidth(Uint8 width);
@@ -507,7 +593,55 @@ public:
      * @return the new remaining time in seconds.
      */
     virtual double setRemaining(double time) override;
-    
+
+private:
+#pragma mark -
+#pragma mark Internal Helpers
+    /**
+     * Places the node in the given slot of the audio thread inputs.
+     *
+     * The node previously in that slot is passed back to the main thread for
+     * deletion. This method may only be called by the audio thread, or by the
+     * main thread inside of an exclusive section.
+     *
+     * @param slot  The slot to change
+     * @param node  The node to place in the slot
+     */
+    void assign(Uint8 slot, std::shared_ptr<AudioNode>& node);
+
+    /**
+     * Applies all pending input changes to the audio thread inputs.
+     *
+     * This method may only be called by the audio thread, or by the main
+     * thread inside of an exclusive section.
+     */
+    void applyCommands();
+
+    /**
+     * Releases all input nodes removed by the audio thread.
+     *
+     * This method should only be called in the main thread. It guarantees
+     * that the last reference to a node is never dropped on the audio thread.
+     */
+    void collect();
+
+    /**
+     * Begins an exclusive section for the main thread.
+     *
+     * This method waits for the current read (if any) to finish. Until the
+     * matching call to {@link #endEdit}, the audio thread will output silence
+     * instead of reading the inputs. Hence this method never causes the audio
+     * thread to block. Pending input changes are applied before this method
+     * returns, so the audio thread inputs are up to date.
+     */
+    void beginEdit();
+
+    /**
+     * Ends an exclusive section for the main thread.
+     *
+     * This method also releases any input nodes removed in the section.
+     */
+    void endEdit();
 };
     }
 }
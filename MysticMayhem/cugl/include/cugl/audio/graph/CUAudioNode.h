@@ -44,6 +44,7 @@
 #ifndef __CU_AUDIO_NODE_H__
 #define __CU_AUDIO_NODE_H__
 #include <SDL/SDL.h>
+#include <cugl/audio/CUAudioProfiler.h>
 #include <atomic>
 #include <memory>
 #include <functional>
@@ -163,6 +164,9 @@ protected:
     Callback _callback;
     /** An atomic to mark that the callback is active (to give lock-free safety) */
     std::atomic<bool> _calling;
+    
+    /** The audio thread profiler of the device manager */
+    std::shared_ptr<AudioProfiler> _profiler;
 
     /** An identifying integer */
     Sint32 _tag;
@@ -48,7 +48,9 @@
 #define __CU_AUDIO_OUTPUT_H__
 #include <SDL/SDL.h>
 #include "CUAudioNode.h"
+#include "CUAudioClock.h"
 #include <cugl/math/dsp/CUBiquadIIR.h>
+#include <cugl/math/dsp/CUPolyphaseResampler.h>
 #include <unordered_set>
 #include <string>
 #include <memory>
@@ -130,8 +132,12 @@ private:
 
     /** The terminal node of the audio graph. This pulls data from the sources */
     std::shared_ptr<AudioNode> _input;
+    /** The sample clock of the audio graph */
+    std::shared_ptr<AudioClock> _clock;
     
-    /** Conversion resampler (if needed) */
+    /** Rate converter (if only the sample rate differs from the device) */
+    std::shared_ptr<dsp::PolyphaseResampler> _polyphase;
+    /** Format and channel converter (if needed) */
     SDL_AudioStream* _resampler;
     /** The intermediate sampling buffer */
     float* _cvtbuffer;
@@ -139,6 +145,8 @@ private:
     float  _cvtratio;
     /** The native bitrate for this output device */
     size_t _bitrate;
+    /** The largest number of frames to read from the graph at once */
+    Uint32 _readsize;
 
 #pragma mark -
 #pragma mark AudioManager Methods
@@ -406,6 +414,17 @@ public:
      * @return the terminal node of the audio graph
      */
     std::shared_ptr<AudioNode> getInput() { return _input; }
+
+    /**
+     * Returns the sample clock of the audio graph
+     *
+     * The clock counts the frames read from the audio graph, at the sample
+     * rate of the graph (not the device). Nodes such as {@link AudioScheduler}
+     * can share this clock to place events at an exact frame.
+     *
+     * @return the sample clock of the audio graph
+     */
+    const std::shared_ptr<AudioClock>& getClock() const { return _clock; }
     
 #pragma mark -
 #pragma mark Playback Control
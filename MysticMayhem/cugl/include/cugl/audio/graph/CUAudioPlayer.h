@@ -40,6 +40,7 @@
 #define __CU_AUDIO_PLAYER_H__
 #include <SDL/SDL.h>
 #include <cugl/audio/CUAudioSample.h>
+#include <cugl/audio/CUAudioStreamer.h>
 #include "CUAudioNode.h"
 #include <functional>
 #include <string>
@@ -75,6 +76,13 @@ namespace  cugl {
  * memory pool of preallocated players (which are reinitialized) than to
  * construct them on the fly.
  *
+ * A player for a streamed sample never decodes on the audio thread. Instead,
+ * it reads from an {@link AudioPageCache} that is filled ahead of the read
+ * position by the {@link AudioStreamer} of {@link AudioDevices}. If the
+ * streamer falls behind, the player outputs silence rather than blocking.
+ * Streamed players decode on the audio thread only if the device manager
+ * has not been started.
+ *
  * A player is always associated with a node in the audio graph. As such, it
  * should only be accessed in the main thread.  In addition, no methods marked
  * as AUDIO THREAD ONLY should ever be accessed by the user. The only exception
@@ -109,6 +117,8 @@ protected:
     Uint32 _chklimt;
     /** The number of the last read frame in the chunk */
     Uint32 _chklast;
+    /** The decoded pages, filled by the audio streamer (STREAMING ACCESS) */
+    std::shared_ptr<AudioPageCache> _cache;
         
     /** Whether or not we need to reposition (STREAMING ACCESS) */
     std::atomic<bool> _dirty;
@@ -312,6 +322,17 @@ public:
     
 private:
 #pragma mark Stream Decoding
+    /**
+     * Repositions the stream decoding at the given frame.
+     *
+     * If this player reads from a page cache, the cache is asked to seek
+     * immediately so that the streamer can decode ahead of the new position.
+     * Otherwise, the decoder is repositioned on the next read.
+     *
+     * @param frame    The absolute frame to skip to
+     */
+    void reposition(Uint64 frame);
+
     /**
      * Decodes the audio stream up to the given position.
      *
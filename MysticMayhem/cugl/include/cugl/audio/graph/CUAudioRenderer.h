@@ -0,0 +1,344 @@
+//
+//  CUAudioRenderer.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an offline terminal node for an audio graph. It plays
+//  the same role as AudioOutput, except that it has no device. Instead, the
+//  graph is pulled on the calling thread as fast as possible, and the result
+//  is written to a memory buffer or to a WAV file. This makes the output of
+//  the graph deterministic, which is useful for benchmarks and for comparing
+//  the mixer output against a reference file.
+//
+//  Because there is no audio thread, the graph attached to this node must not
+//  also be attached to an active output device. The main thread is the only
+//  thread that reads from it.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#ifndef __CU_AUDIO_RENDERER_H__
+#define __CU_AUDIO_RENDERER_H__
+#include "CUAudioNode.h"
+#include "CUAudioClock.h"
+#include <string>
+#include <memory>
+#include <vector>
+
+namespace cugl {
+    namespace audio {
+
+/**
+ * This class provides a graph node for rendering an audio graph offline.
+ *
+ * This node is a substitute for {@link AudioOutput} when there is no device.
+ * It has a fixed sample rate and buffer size, just like a device. However,
+ * the graph is only read when the programmer calls {@link #render} or
+ * {@link #save}, and then it is read as fast as possible. The graph is pulled
+ * one buffer at a time, so the nodes see exactly the same sequence of reads
+ * that they would on a device with that buffer size. As long as the input
+ * nodes are deterministic, the output is identical from one run to the next.
+ *
+ * Each buffer is reported to the {@link AudioProfiler} (if it is enabled) as
+ * if it were a device callback. The profiler load then measures how much of
+ * the real time budget the graph would use on a device.
+ *
+ * The graph attached to this node must not be attached to an output device
+ * at the same time. All methods of this class, including the reads, are
+ * intended for the main thread.
+ *
+ * This class does not support any actions for the {@link AudioNode#setCallback}.
+ */
+class AudioRenderer : public AudioNode {
+private:
+    /** The audio graph attached to this renderer */
+    std::shared_ptr<AudioNode> _input;
+    /** The sample clock of the audio graph */
+    std::shared_ptr<AudioClock> _clock;
+    /** The number of frames in each read of the input */
+    Uint32 _capacity;
+    /** The buffer for writing to a file */
+    std::vector<float> _buffer;
+    /** The number of frames rendered since the last reset */
+    Uint64 _rendered;
+    /** The number of nanoseconds spent rendering since the last reset */
+    Uint64 _elapsed;
+
+public:
+#pragma mark Constructors
+    /**
+     * Creates a degenerate audio renderer.
+     *
+     * The node has not been initialized, so it is not active.  The node
+     * must be initialized to be used.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a node on
+     * the heap, use one of the static constructors instead.
+     */
+    AudioRenderer();
+
+    /**
+     * Deletes the audio renderer, disposing of all resources
+     */
+    ~AudioRenderer() { dispose(); }
+
+    /**
+     * Initializes a renderer with 2 channels at 48000 Hz.
+     *
+     * The buffer size is {@link AudioDevices#DEFAULT_OUTPUT_BUFFER}.
+     *
+     * @return true if initialization was successful
+     */
+    virtual bool init() override;
+
+    /**
+     * Initializes a renderer with the given channels and sample rate.
+     *
+     * The buffer size is {@link AudioDevices#DEFAULT_OUTPUT_BUFFER}.
+     *
+     * @param channels  The number of audio channels
+     * @param rate      The sample rate (frequency) in HZ
+     *
+     * @return true if initialization was successful
+     */
+    virtual bool init(Uint8 channels, Uint32 rate) override;
+
+    /**
+     * Initializes a renderer with the given channels, sample rate and buffer.
+     *
+     * The buffer size is the number of frames pulled from the graph at a
+     * time. It should match the buffer size of the device being modeled.
+     *
+     * @param channels  The number of audio channels
+     * @param rate      The sample rate (frequency) in HZ
+     * @param buffer    The number of frames in each read of the graph
+     *
+     * @return true if initialization was successful
+     */
+    bool init(Uint8 channels, Uint32 rate, Uint32 buffer);
+
+    /**
+     * Disposes any resources allocated for this renderer
+     *
+     * The state of the node is reset to that of an uninitialized constructor.
+     * Unlike the destructor, this method allows the node to be reinitialized.
+     */
+    virtual void dispose() override;
+
+#pragma mark Static Constructors
+    /**
+     * Returns a newly allocated renderer with 2 channels at 48000 Hz.
+     *
+     * The buffer size is {@link AudioDevices#DEFAULT_OUTPUT_BUFFER}.
+     *
+     * @return a newly allocated renderer with 2 channels at 48000 Hz.
+     */
+    static std::shared_ptr<AudioRenderer> alloc() {
+        std::shared_ptr<AudioRenderer> result = std::make_shared<AudioRenderer>();
+        return (result->init() ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated renderer with the given settings.
+     *
+     * The buffer size is the number of frames pulled from the graph at a
+     * time. It should match the buffer size of the device being modeled.
+     *
+     * @param channels  The number of audio channels
+     * @param rate      The sample rate (frequency) in HZ
+     * @param buffer    The number of frames in each read of the graph
+     *
+     * @return a newly allocated renderer with the given settings.
+     */
+    static std::shared_ptr<AudioRenderer> alloc(Uint8 channels, Uint32 rate, Uint32 buffer) {
+        std::shared_ptr<AudioRenderer> result = std::make_shared<AudioRenderer>();
+        return (result->init(channels,rate,buffer) ? result : nullptr);
+    }
+
+#pragma mark Audio Graph
+    /**
+     * Returns the number of frames in each read of the graph.
+     *
+     * @return the number of frames in each read of the graph.
+     */
+    Uint32 getCapacity() const { return _capacity; }
+
+    /**
+     * Attaches an audio graph to this renderer.
+     *
+     * This method will fail if the channels or sample rate of the audio graph
+     * do not agree with this node.
+     *
+     * @param node  The terminal node of the audio graph
+     *
+     * @return true if the attachment was successful
+     */
+    bool attach(const std::shared_ptr<AudioNode>& node);
+
+    /**
+     * Detaches an audio graph from this renderer.
+     *
+     * If the method succeeds, it returns the terminal node of the audio graph.
+     *
+     * @return  the terminal node of the audio graph (or null if failed)
+     */
+    std::shared_ptr<AudioNode> detach();
+
+    /**
+     * Returns the terminal node of the audio graph
+     *
+     * @return the terminal node of the audio graph
+     */
+    std::shared_ptr<AudioNode> getInput() { return _input; }
+
+    /**
+     * Returns the sample clock of the audio graph
+     *
+     * The clock counts the frames rendered from the audio graph. Nodes such
+     * as {@link AudioScheduler} can share this clock to place events at an
+     * exact frame.
+     *
+     * @return the sample clock of the audio graph
+     */
+    const std::shared_ptr<AudioClock>& getClock() const { return _clock; }
+
+    /**
+     * Returns true if this audio node has no more data.
+     *
+     * This is the case if there is no attached graph, or the graph is
+     * completed.
+     *
+     * @return true if this audio node has no more data.
+     */
+    virtual bool completed() override;
+
+#pragma mark Rendering
+    /**
+     * Reads the given number of frames into the given buffer
+     *
+     * The graph is read one buffer at a time. A short read from the graph is
+     * followed by further reads until the buffer is full or the graph produces
+     * nothing, and only then is the remainder filled with silence. Hence this
+     * method always returns frames. The buffer should have enough room to
+     * store frames * channels elements.
+     *
+     * @param buffer    The read buffer to store the results
+     * @param frames    The number of frames to read
+     *
+     * @return the number of frames read
+     */
+    virtual Uint32 read(float* buffer, Uint32 frames) override;
+
+    /**
+     * Renders the given number of frames into the given buffer
+     *
+     * This is the same as {@link #read}, except that the number of frames
+     * may exceed 32 bits.
+     *
+     * @param buffer    The buffer to store the results
+     * @param frames    The number of frames to render
+     *
+     * @return the number of frames rendered
+     */
+    Uint64 render(float* buffer, Uint64 frames);
+
+    /**
+     * Returns the given duration of the audio graph as a new buffer
+     *
+     * The result has the frames interleaved.
+     *
+     * @param seconds   The number of seconds to render
+     *
+     * @return the given duration of the audio graph as a new buffer
+     */
+    std::vector<float> render(double seconds);
+
+    /**
+     * Renders the given number of frames to a WAV file
+     *
+     * The file is written one buffer at a time, so the memory used does not
+     * depend on the length of the file. The samples are stored as 32 bit IEEE
+     * floats, or as 16 bit PCM if pcm16 is true. Either format can be read
+     * back by {@link WAVDecoder}.
+     *
+     * @param file      The path to the WAV file
+     * @param frames    The number of frames to render
+     * @param pcm16     Whether to store the samples as 16 bit PCM
+     *
+     * @return true if the file was written successfully
+     */
+    bool save(const std::string& file, Uint64 frames, bool pcm16=false);
+
+#pragma mark Statistics
+    /**
+     * Returns the number of frames rendered since the last reset.
+     *
+     * @return the number of frames rendered since the last reset.
+     */
+    Uint64 getRendered() const { return _rendered; }
+
+    /**
+     * Returns the number of microseconds spent rendering since the last reset.
+     *
+     * This does not include the time to write to a file.
+     *
+     * @return the number of microseconds spent rendering since the last reset.
+     */
+    Uint64 getRenderTime() const { return _elapsed/1000; }
+
+    /**
+     * Returns the number of seconds of audio rendered per second of work
+     *
+     * A value of 1 means that the graph renders in exactly real time. The
+     * value is 0 if nothing has been rendered.
+     *
+     * @return the number of seconds of audio rendered per second of work
+     */
+    double getSpeed() const;
+
+    /**
+     * Resets the render statistics to zero.
+     */
+    void resetStatistics() { _rendered = 0; _elapsed = 0; }
+
+    /**
+     * Returns a summary of the time to mix the given number of voices.
+     *
+     * This method builds a graph of sine wave players, each with its own
+     * fader, feeding a single mixer. It renders the given number of seconds
+     * offline, and reports both the cost per second of audio and the speed
+     * relative to real time. No device is used, so the audio device manager
+     * does not need to be active.
+     *
+     * @param voices    The number of voices to mix (at most 255)
+     * @param seconds   The number of seconds of audio to render
+     * @param channels  The number of audio channels
+     * @param rate      The sample rate (frequency) in HZ
+     * @param buffer    The number of frames in each read of the graph
+     *
+     * @return a summary of the time to mix the given number of voices.
+     */
+    static std::string benchmark(Uint32 voices, double seconds, Uint8 channels=2,
+                                 Uint32 rate=48000, Uint32 buffer=512);
+};
+
+    }
+}
+#endif /* __CU_AUDIO_RENDERER_H__ */
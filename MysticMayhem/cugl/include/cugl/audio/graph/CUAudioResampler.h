@@ -3,7 +3,7 @@
 //  Cornell University Game Library (CUGL)
 //
 //  This module provides a graph node for converting from one sample rate to
-//  another.  It uses SDL_AudioStream to perform continuous resampling on a
+//  another.  It uses a polyphase filter to perform continuous resampling on a
 //  potentially infinite audio stream.  This is is necessary for cross-platform
 //  reasons as iPhones are very stubborn about delivering any requested sampling
 //  rates other than 48000.
@@ -34,9 +34,10 @@
 #ifndef __CU_AUDIO_RESAMPLER_H__
 #define __CU_AUDIO_RESAMPLER_H__
 #include <cugl/audio/graph/CUAudioNode.h>
+#include <cugl/math/dsp/CUPolyphaseResampler.h>
 #include <SDL/SDL.h>
-#include <mutex>
 #include <atomic>
+#include <string>
 
 namespace cugl {
     
@@ -51,14 +52,18 @@ namespace cugl {
 /**
  * This class provides a graph node for converting from one sample rate to another.
  *
- * The node uses SDL_AudioStream to perform continuous resampling on a
- * potentially infinite audio stream.  This is is necessary for cross-platform
- * reasons as iPhones are very stubborn about delivering any requested sampling
- * rates other than 48000.
+ * The node uses a {@link dsp::PolyphaseResampler} to perform continuous
+ * resampling on a potentially infinite audio stream.  This is is necessary for
+ * cross-platform reasons as iPhones are very stubborn about delivering any
+ * requested sampling rates other than 48000. The input is read directly into
+ * the filter history, so there is no intermediate copy, and the filter never
+ * locks the audio thread.
  *
  * This is a dynamic resampler.  While the output sampling rate is fixed, the
  * input is not.  It will readjust the conversion filter to match the sampling
- * rate of the input node whenever the input node changes.
+ * rate of the input node whenever the input node changes. The quality of the
+ * filter trades off CPU cost and latency against aliasing, and can be set
+ * with {@link #setQuality}.
  *
  * The audio graph should only be accessed in the main thread.  In addition,
  * no methods marked as AUDIO THREAD ONLY should ever be accessed by the
@@ -68,22 +73,27 @@ namespace cugl {
  */
 class AudioResampler : public AudioNode {
 private:
-    /** Mutex to protect more sophisticated synchronization */
-    mutable std::mutex _buffmtex;
-
     /** The input node to resample from */
     std::shared_ptr<AudioNode> _input;
     
     /** Conversion resampler (if needed) */
-    SDL_AudioStream* _resampler;
+    std::shared_ptr<dsp::PolyphaseResampler> _resampler;
     /** The currently support input sample rate */
     Uint32 _inputrate;
-    /** The intermediate sampling buffer */
-    float* _cvtbuffer;
-    /** The capacity of the sampling buffer */
-    size_t _capacity;
+    /** The resampling filter quality */
+    dsp::PolyphaseResampler::Quality _quality;
     /** The conversion ratio */
     std::atomic<float>  _cvtratio;
+    /** The silent input frames still needed to flush the filter at the end of the input */
+    std::atomic<Uint32> _tail;
+    
+    /**
+     * Replaces the conversion resampler to match the current input rate.
+     *
+     * The new resampler starts with a silent history. It is null if the
+     * input rate matches the output rate.
+     */
+    void rebuild();
     
 public:
 #pragma mark -
@@ -201,6 +211,59 @@ public:
      */
     std::shared_ptr<AudioNode> getInput() const { return _input; }
     
+#pragma mark -
+#pragma mark Resampling
+    /**
+     * Returns the quality of the resampling filter.
+     *
+     * The default quality is MEDIUM.
+     *
+     * @return the quality of the resampling filter.
+     */
+    dsp::PolyphaseResampler::Quality getQuality() const { return _quality; }
+    
+    /**
+     * Sets the quality of the resampling filter.
+     *
+     * Higher qualities have less aliasing, but cost more CPU time and have
+     * more latency. Changing the quality while a node is attached replaces
+     * the filter, which will discard its history. So this should be set
+     * before the input is attached.
+     *
+     * @param quality   The quality of the resampling filter
+     */
+    void setQuality(dsp::PolyphaseResampler::Quality quality);
+    
+    /**
+     * Returns the latency of this resampler in output frames.
+     *
+     * This is the delay added by the resampling filter. It is 0 if the input
+     * rate matches the output rate.
+     *
+     * @return the latency of this resampler in output frames.
+     */
+    Uint32 getLatency() const;
+    
+    /**
+     * Returns a report comparing this resampler to SDL_AudioStream
+     *
+     * This method converts the given number of seconds of noise between the
+     * two rates, in blocks of the default read size. It reports the CPU time
+     * (in milliseconds) per second of audio, and the latency in output frames
+     * measured from an impulse, for SDL_AudioStream and for each quality of
+     * the polyphase filter.
+     *
+     * This method does not require an audio device.
+     *
+     * @param inrate    The input sample rate
+     * @param outrate   The output sample rate
+     * @param channels  The number of audio channels
+     * @param seconds   The number of seconds of audio to convert
+     *
+     * @return a report comparing this resampler to SDL_AudioStream
+     */
+    static std::string benchmark(Uint32 inrate, Uint32 outrate, Uint8 channels, double seconds);
+    
 #pragma mark -
 #pragma mark Playback Control
     /**
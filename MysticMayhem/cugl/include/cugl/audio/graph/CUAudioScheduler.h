@@ -35,6 +35,7 @@
 #include <SDL/SDL.h>
 #include "CUAudioNode.h"
 #include "CUAudioPlayer.h"
+#include "CUAudioClock.h"
 #include <functional>
 #include <deque>
 
@@ -64,6 +65,10 @@ namespace cugl {
  * This queue does not have a lot of bells and whistles because it is only
  * intended for thread synchronization.  We expect the user to maintain what
  * has and has not been appended to the queue.
+ *
+ * Entries are only deleted by the producer (when it next pushes an entry).
+ * Hence a node removed by the audio thread is never deleted on the audio
+ * thread unless the audio thread drops the last reference itself.
  */
 class AudioNodeQueue {
 private:
@@ -77,6 +82,8 @@ private:
         std::shared_ptr<AudioNode> value;
         /** Whether to loop this audio node */
         Sint32 loops;
+        /** The clock time to start this node (0 for when it is reached) */
+        Uint64 time;
         /** THe next entry in the queue (or null if at end) */
         Entry* next;
         
@@ -90,9 +97,10 @@ private:
          *
          * @param node  The audio node
          * @param loop  The number of times to loop the audio
+         * @param start The clock time to start the node
          */
-        Entry(const std::shared_ptr<AudioNode>& node, Sint32 loop) :
-            value(node), loops(loop), next(nullptr) { }
+        Entry(const std::shared_ptr<AudioNode>& node, Sint32 loop, Uint64 start) :
+            value(node), loops(loop), time(start), next(nullptr) { }
     };
     
     /** THe first element int the queue */
@@ -124,7 +132,9 @@ public:
      *
      * @return true if the queue is empty.
      */
-    bool empty() const { return _divide == _last; }
+    bool empty() const {
+        return _divide.load(std::memory_order_acquire) == _last.load(std::memory_order_acquire);
+    }
     
     /**
      * Adds an entry to the end of this queue.
@@ -134,12 +144,16 @@ public:
      * (additional) times.  If it is negative, the audio node will be
      * looped indefinitely until it is stopped.
      *
+     * The time is the clock time at which the node should start. If it is 0,
+     * the node starts as soon as it reaches the front of the queue.
+     *
      * This method is thread-safe
      *
      * @param node  The node to be scheduled
      * @param loops	The number of times to loop the audio
+     * @param time  The clock time to start the node
      */
-    void push(const std::shared_ptr<AudioNode>& node, Sint32 loops=0);
+    void push(const std::shared_ptr<AudioNode>& node, Sint32 loops=0, Uint64 time=0);
 
     /**
      * Looks at the front element this queue.
@@ -172,6 +186,35 @@ public:
      * @return true if the operation was successful
      */
     bool pop(std::shared_ptr<AudioNode>& node, Sint32& loop);
+
+    /**
+     * Removes an entry from the front of this queue.
+     *
+     * This version of the method also stores the start time of the entry.
+     * If there is nothing to remove, the pointer will store null and the
+     * method will return false.
+     *
+     * This method is thread-safe
+     *
+     * @param node  the pointer to store the audio node
+     * @param loop  the pointer to store the number of loops
+     * @param time  the pointer to store the start time
+     *
+     * @return true if the operation was successful
+     */
+    bool pop(std::shared_ptr<AudioNode>& node, Sint32& loop, Uint64& time);
+
+    /**
+     * Returns the start time of the front element of this queue.
+     *
+     * This method returns 0 if the queue is empty, or if the front element
+     * starts as soon as it is reached.
+     *
+     * This method is thread-safe
+     *
+     * @return the start time of the front element of this queue.
+     */
+    Uint64 peekTime() const;
     
     /**
      * Stores all values in the provided dequeue.
@@ -191,7 +234,8 @@ public:
     /**
      * Clears all elements in this queue.
      *
-     * This method is thread-safe
+     * This is a consumer method. It should only be called in the audio
+     * thread (or when the audio thread is known not to be reading).
      */
     void clear();
 };
@@ -215,6 +259,11 @@ public:
  * user to look at the contents of the queue.  The user can only look at
  * the currently playing node.
  *
+ * Nodes may also be scheduled at a time on an {@link AudioClock}, which is
+ * typically shared with the output device. The scheduler splits each read
+ * at these times, so a timed node starts (or replaces the active node) at
+ * the exact frame requested, rather than at the start of the next buffer.
+ *
  * The audio graph should only be accessed in the main thread.  In addition,
  * no methods marked as AUDIO THREAD ONLY should ever be accessed by the user.
  *
@@ -238,11 +287,19 @@ private:
 
     /** The queue of all sources waiting to be played next */
     AudioNodeQueue _queue;
+    /** The clock time to start the current node (AUDIO THREAD ONLY) */
+    Uint64 _start;
+    /** The sample clock for timed events */
+    std::shared_ptr<AudioClock> _clock;
+    /** The private clock, used (and advanced by this node) if none is shared */
+    std::shared_ptr<AudioClock> _local;
     
     /** Counter to track queue size */
     std::atomic<Uint32> _qsize;
     /** Counter to track queue skips (for clearing or advancement) */
     std::atomic<Uint32> _qskip;
+    /** Counter to track queue trims (-1 to trim everything) */
+    std::atomic<Sint32> _qtrim;
 
     /** Stored results after a mark is set */
     std::deque<std::shared_ptr<AudioNode>> _memory;
@@ -292,6 +349,26 @@ public:
      */
     virtual bool init(Uint8 channels, Uint32 rate) override;
     
+    /**
+     * Initializes the scheduler with the given channels, sample rate and capacity
+     *
+     * These values determine the buffer the structure for all {@link read}
+     * operations.  In addition, they also detemine whether this node can
+     * serve as an input to other nodes in the audio graph.
+     *
+     * The capacity is the largest number of frames the scheduler will produce
+     * in a single read. The other initializers use the read size of the audio
+     * device manager. Graphs that are not attached to a device (such as one
+     * read by an {@link AudioRenderer}) should use this initializer instead.
+     *
+     * @param channels  The number of audio channels
+     * @param rate      The sample rate (frequency) in HZ
+     * @param capacity  The maximum number of frames in a single read
+     *
+     * @return true if initialization was successful
+     */
+    bool init(Uint8 channels, Uint32 rate, Uint32 capacity);
+    
     /**
      * Disposes any resources allocated for this node
      *
@@ -320,6 +397,28 @@ public:
         std::shared_ptr<AudioScheduler> result = std::make_shared<AudioScheduler>();
         return (result->init(channels, rate) ? result : nullptr);
     }
+
+    /**
+     * Returns an allocated scheduler with the given channels, sample rate and capacity
+     *
+     * These values determine the buffer the structure for all {@link read}
+     * operations.  In addition, they also detemine what types of sources that
+     * the scheduler can support.
+     *
+     * The capacity is the largest number of frames the scheduler will produce
+     * in a single read. Use this allocator for graphs that are not attached to
+     * a device, such as one read by an {@link AudioRenderer}.
+     *
+     * @param channels  The number of audio channels
+     * @param rate      The sample rate (frequency) in HZ
+     * @param capacity  The maximum number of frames in a single read
+     *
+     * @return an allocated scheduler with the given channels, sample rate and capacity
+     */
+    static std::shared_ptr<AudioScheduler> alloc(Uint8 channels, Uint32 rate, Uint32 capacity) {
+        std::shared_ptr<AudioScheduler> result = std::make_shared<AudioScheduler>();
+        return (result->init(channels, rate, capacity) ? result : nullptr);
+    }
     
 #pragma mark Queue Management
     /**
@@ -338,14 +437,20 @@ public:
      * (additional) times.  If it is negative, the audio node will be
      * looped indefinitely until it is stopped.
      *
+     * If time is not 0, the node does not start until that time on the
+     * {@link #getClock} (the scheduler is silent until then). The previous
+     * node is still removed at the next render frame. To replace the active
+     * node at an exact time, use {@link #append} with a time instead.
+     *
      * If the user has provided an optional callback function, this will be
      * called when the node is removed, either because it completed (defined
      * by {@link AudioNode#completed()}) or is interrupted.
      *
      * @param node  The audio node for playback
      * @param loop  The number of times to loop the audio
+     * @param time  The clock time to start the node (0 for immediately)
      */
-    void play(const std::shared_ptr<AudioNode>& node, Sint32 loop = 0);
+    void play(const std::shared_ptr<AudioNode>& node, Sint32 loop = 0, Uint64 time = 0);
     
     /**
      * Appends a new audio node for playback.
@@ -364,14 +469,49 @@ public:
      * (additional) times.  If it is negative, the audio node will be
      * looped indefinitely until it is stopped.
      *
+     * If time is not 0, the node starts at that time on the {@link #getClock},
+     * accurate to the frame. If the node reaches the front of the queue
+     * before then, the scheduler is silent until that time. If the active
+     * node is still playing at that time, it is interrupted at that frame.
+     * Timed nodes still respect the order of the queue; they cannot start
+     * until all earlier nodes have started.
+     *
      * If the user has provided an optional callback function, this will be
      * called when the node is removed, either because it completed (defined
      * by {@link AudioNode#completed()}) or is interrupted.
      *
      * @param node  The audio node for playback
      * @param loop  The number of times to loop the audio
+     * @param time  The clock time to start the node (0 for when it is reached)
      */
-    void append(const std::shared_ptr<AudioNode>& node, Sint32 loop = 0);
+    void append(const std::shared_ptr<AudioNode>& node, Sint32 loop = 0, Uint64 time = 0);
+
+    /**
+     * Returns the sample clock for timed playback.
+     *
+     * The times given to {@link #play} and {@link #append} are frames on
+     * this clock. By default, a scheduler has its own clock, which counts
+     * the frames read from this node. To place events relative to the
+     * output, this should be the clock of the {@link AudioOutput}.
+     *
+     * @return the sample clock for timed playback.
+     */
+    std::shared_ptr<AudioClock> getClock() const;
+
+    /**
+     * Sets the sample clock for timed playback.
+     *
+     * The times given to {@link #play} and {@link #append} are frames on
+     * this clock. This should typically be the clock of the terminal node
+     * of the audio graph (an {@link AudioOutput} or {@link AudioRenderer}),
+     * which must have the same sample rate. If the clock is null, the
+     * scheduler reverts to its own clock.
+     *
+     * This method should be called before any timed events are scheduled.
+     *
+     * @param clock The sample clock for timed playback
+     */
+    void setClock(const std::shared_ptr<AudioClock>& clock);
     
     /**
      * Returns the audio node currently being played.
@@ -413,7 +553,9 @@ public:
      *
      * The optional force argument allows for sounds to be purged immediately
      * (such as during clean-up).  However, doing so will not invoke the callback
-     * function, even if it is provided.
+     * function, even if it is provided. A forced clear waits for the current
+     * read (if any) to finish, and the audio thread outputs silence until the
+     * purge is complete.
      *
      * @param force whether to delete the queue immediately, in the current thread
      */
@@ -423,7 +565,13 @@ public:
      * Empties the queue without stopping the current playback.
      *
      * This method is useful when we want to clear the queue, but to smoothly
-     * fade-out the current playback.
+     * fade-out the current playback. If size is non-negative, only that many
+     * elements are removed from the front of the queue.
+     *
+     * Like {@link #clear}, this method only posts a request. The elements are
+     * removed by the audio thread at its next read.
+     *
+     * @param size  The number of elements to remove (-1 for all)
      */
     void trim(Sint32 size = -1);
     
@@ -740,6 +888,14 @@ private:
      * @return the next audio instance for playback
      */
     std::shared_ptr<AudioNode> acquire(Sint32& loop, Uint32 skip=0, Action action=Action::COMPLETE);
+
+    /**
+     * Removes the elements requested by {@link #trim} from the queue.
+     *
+     * AUDIO THREAD ONLY: This is an internal method for queue management.
+     * Only the audio thread is allowed to delete from the playback queue.
+     */
+    void applyTrim();
 };
     }
 }
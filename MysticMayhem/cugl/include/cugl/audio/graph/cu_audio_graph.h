@@ -31,7 +31,9 @@
 #define __CU_AUDIO_GRAPH_PKG_H__
 
 #include "CUAudioNode.h"
+#include "CUAudioClock.h"
 #include "CUAudioOutput.h"
+#include "CUAudioRenderer.h"
 #include "CUAudioInput.h"
 #include "CUAudioResampler.h"
 #include "CUAudioPlayer.h"
@@ -17,6 +17,9 @@
 //  have proper file systems.  You should confine all files to either the asset
 //  or the save directory.
 //
+//  A reader may also map the file into memory rather than read it in chunks.
+//  Mapped readers are best for assets that are read from start to finish.
+//
 //  This class uses our standard shared-pointer architecture.
 //
 //  1. The constructor does not perform any initialization; it just sets all
@@ -55,9 +58,13 @@
 #include <cugl/base/CUBase.h>
 #include <SDL/SDL.h>
 #include <string>
+#include <memory>
 
 namespace cugl {
 
+/** Forward reference to a mapped file */
+class MappedFile;
+
 /**
  * Simple cross-platform reader for binary files.
  *
@@ -75,6 +82,12 @@ namespace cugl {
  * for the file name.  Keep in mind that absolute paths are very dangerous on
  * mobile devices, because they do not have proper file systems.  You should
  * confine all files to either the asset or the save directory.
+ *
+ * A reader may either be buffered or mapped. A buffered reader reads the file
+ * in chunks of a fixed capacity. A mapped reader maps the entire file into
+ * memory {@see MappedFile}, so that every read is a copy out of the mapping
+ * with no intermediate buffer. Mapped readers are preferable for asset files
+ * that are read from start to finish.
  */
 class BinaryReader {
 protected:
@@ -87,7 +100,7 @@ protected:
     /** The cursor into the SDL I/O stream */
     Sint64      _scursor;
     
-    /** The temporary transfer buffer */
+    /** The temporary transfer buffer (or the file contents if mapped) */
     char*       _buffer;
     /** The buffer capacity */
     Uint32      _capacity;
@@ -96,6 +109,11 @@ protected:
     /** The current offset in the read buffer */
     Sint32      _bufoff;
     
+    /** The file mapping (nullptr if this reader is buffered) */
+    std::shared_ptr<MappedFile> _mapping;
+    /** Whether this reader maps the file instead of buffering it */
+    bool        _mapped;
+    
 #pragma mark -
 #pragma mark Internal Methods
     /**
@@ -108,6 +126,44 @@ protected:
      */
     void fill(unsigned int bytes=1);
     
+    /**
+     * Maps the file {@link #_name} into memory, returning true on success.
+     *
+     * The mapping takes the place of the read buffer, so that it holds the
+     * entire file.
+     *
+     * @return true if the file was mapped
+     */
+    bool map();
+    
+    /**
+     * Copies up to the given number of bytes from the stream to the buffer.
+     *
+     * Unlike the buffer refill, this method is not limited by the capacity.
+     * Once the buffer is empty, any request of at least the capacity is read
+     * directly into the destination.
+     *
+     * @param buffer    The array to store the data when read
+     * @param bytes     The number of bytes to read
+     *
+     * @return the number of bytes read
+     */
+    size_t copy(Uint8* buffer, size_t bytes);
+    
+    /**
+     * Copies whole elements of the given size from the stream to the buffer.
+     *
+     * This method reads as many elements as remain in the stream, up to
+     * the given maximum. It does not marshall the elements.
+     *
+     * @param buffer    The array to store the data when read
+     * @param size      The number of bytes in an element
+     * @param maximum   The maximum number of elements to read from the stream
+     *
+     * @return the number of elements read
+     */
+    size_t copy(Uint8* buffer, size_t size, size_t maximum);
+    
     
 #pragma mark -
 #pragma mark Constructors
@@ -119,7 +175,8 @@ public:
      * the heap, use one of the static constructors instead.
      */
     BinaryReader() : _name(""), _stream(nullptr), _ssize(-1), _scursor(-1),
-                     _buffer(nullptr), _capacity(0), _bufoff(-1), _bufsize(0) {}
+                     _buffer(nullptr), _capacity(0), _bufoff(-1), _bufsize(0),
+                     _mapped(false) {}
     
     /**
      * Deletes this reader and all of its resources.
@@ -190,6 +247,41 @@ public:
      */
     bool initWithAsset(const std::string file, unsigned int capacity);
     
+    /**
+     * Initializes a mapped reader for the given file.
+     *
+     * A mapped reader has no read buffer. Instead, the entire file is mapped
+     * into memory {@see MappedFile}, and every read copies directly out of
+     * the mapping.
+     *
+     * If the file is a relative path, this reader will look for the file in
+     * the application save directory {@see Application#getSaveDirectory()}.
+     * If you wish to read a file in any other directory, you must provide
+     * an absolute path.
+     *
+     * @param file  the path (absolute or relative) to the file
+     *
+     * @return true if the reader is initialized properly, false otherwise.
+     */
+    bool initMapped(const std::string file);
+    
+    /**
+     * Initializes a mapped reader for the given file.
+     *
+     * A mapped reader has no read buffer. Instead, the entire file is mapped
+     * into memory {@see MappedFile}, and every read copies directly out of
+     * the mapping.
+     *
+     * This initializer assumes that the file name is a relative path. It will
+     * search the application assert directory {@see Application#getAssetDirectory()}
+     * for the file and return false if it cannot find it there.
+     *
+     * @param file  the relative path to the file
+     *
+     * @return true if the reader is initialized properly, false otherwise.
+     */
+    bool initMappedWithAsset(const std::string file);
+    
     
 #pragma mark -
 #pragma mark Static Constructors
@@ -268,6 +360,47 @@ public:
         return (result->initWithAsset(file,capacity) ? result : nullptr);
     }
     
+    /**
+     * Returns a newly allocated mapped reader for the given file.
+     *
+     * A mapped reader has no read buffer. Instead, the entire file is mapped
+     * into memory {@see MappedFile}, and every read copies directly out of
+     * the mapping.
+     *
+     * If the file is a relative path, this reader will look for the file in
+     * the application save directory {@see Application#getSaveDirectory()}.
+     * If you wish to read a file in any other directory, you must provide
+     * an absolute path.
+     *
+     * @param file  the path (absolute or relative) to the file
+     *
+     * @return a newly allocated mapped reader for the given file.
+     */
+    static std::shared_ptr<BinaryReader> allocMapped(const std::string file) {
+        std::shared_ptr<BinaryReader> result = std::make_shared<BinaryReader>();
+        return (result->initMapped(file) ? result : nullptr);
+    }
+    
+    /**
+     * Returns a newly allocated mapped reader for the given file.
+     *
+     * A mapped reader has no read buffer. Instead, the entire file is mapped
+     * into memory {@see MappedFile}, and every read copies directly out of
+     * the mapping.
+     *
+     * This initializer assumes that the file name is a relative path. It will
+     * search the application assert directory {@see Application#getAssetDirectory()}
+     * for the file and return false if it cannot find it there.
+     *
+     * @param file  the relative path to the file
+     *
+     * @return a newly allocated mapped reader for the given file.
+     */
+    static std::shared_ptr<BinaryReader> allocMappedWithAsset(const std::string file) {
+        std::shared_ptr<BinaryReader> result = std::make_shared<BinaryReader>();
+        return (result->initMappedWithAsset(file) ? result : nullptr);
+    }
+    
     
 #pragma mark -
 #pragma mark Stream Management
@@ -299,6 +432,13 @@ public:
      */
     bool ready(unsigned int bytes=1) const;
     
+    /**
+     * Returns true if this reader maps the file instead of buffering it.
+     *
+     * @return true if this reader maps the file instead of buffering it.
+     */
+    bool isMapped() const { return _mapped; }
+    
     
 #pragma mark -
 #pragma mark Single Element Reads
@@ -433,8 +573,9 @@ public:
      * The function will attempt to read up to maximum number of elements.
      * It will return the actual number of elements read (which may be 0).
      *
-     * The values are marshalled from network order, ensuring that the binary 
-     * file is compatible against all platforms.
+     * The values are marshalled from network order, ensuring that the binary
+     * file is compatible against all platforms. The values are swapped in
+     * bulk after they are read, and only on little-endian platforms.
      *
      * @param buffer    The array to store the data when read
      * @param maximum   The maximum number of elements to read from the stream
@@ -451,7 +592,8 @@ public:
      * It will return the actual number of elements read (which may be 0).
      *
      * The values are marshalled from network order, ensuring that the binary
-     * file is compatible against all platforms.
+     * file is compatible against all platforms. The values are swapped in
+     * bulk after they are read, and only on little-endian platforms.
      *
      * @param buffer    The array to store the data when read
      * @param maximum   The maximum number of elements to read from the stream
@@ -468,7 +610,8 @@ public:
      * It will return the actual number of elements read (which may be 0).
      *
      * The values are marshalled from network order, ensuring that the binary
-     * file is compatible against all platforms.
+     * file is compatible against all platforms. The values are swapped in
+     * bulk after they are read, and only on little-endian platforms.
      *
      * @param buffer    The array to store the data when read
      * @param maximum   The maximum number of elements to read from the stream
@@ -485,7 +628,8 @@ public:
      * It will return the actual number of elements read (which may be 0).
      *
      * The values are marshalled from network order, ensuring that the binary
-     * file is compatible against all platforms.
+     * file is compatible against all platforms. The values are swapped in
+     * bulk after they are read, and only on little-endian platforms.
      *
      * @param buffer    The array to store the data when read
      * @param maximum   The maximum number of elements to read from the stream
@@ -502,7 +646,8 @@ public:
      * It will return the actual number of elements read (which may be 0).
      *
      * The values are marshalled from network order, ensuring that the binary
-     * file is compatible against all platforms.
+     * file is compatible against all platforms. The values are swapped in
+     * bulk after they are read, and only on little-endian platforms.
      *
      * @param buffer    The array to store the data when read
      * @param maximum   The maximum number of elements to read from the stream
@@ -519,7 +664,8 @@ public:
      * It will return the actual number of elements read (which may be 0).
      *
      * The values are marshalled from network order, ensuring that the binary
-     * file is compatible against all platforms.
+     * file is compatible against all platforms. The values are swapped in
+     * bulk after they are read, and only on little-endian platforms.
      *
      * @param buffer    The array to store the data when read
      * @param maximum   The maximum number of elements to read from the stream
@@ -536,7 +682,8 @@ public:
      * It will return the actual number of elements read (which may be 0).
      *
      * The values are marshalled from network order, ensuring that the binary
-     * file is compatible against all platforms.
+     * file is compatible against all platforms. The values are swapped in
+     * bulk after they are read, and only on little-endian platforms.
      *
      * @param buffer    The array to store the data when read
      * @param maximum   The maximum number of elements to read from the stream
@@ -553,7 +700,8 @@ public:
      * It will return the actual number of elements read (which may be 0).
      *
      * The values are marshalled from network order, ensuring that the binary
-     * file is compatible against all platforms.
+     * file is compatible against all platforms. The values are swapped in
+     * bulk after they are read, and only on little-endian platforms.
      *
      * @param buffer    The array to store the data when read
      * @param maximum   The maximum number of elements to read from the stream
@@ -0,0 +1,476 @@
+//
+//  CUJsonParser.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a single pass, streaming JSON parser. It is a pull
+//  parser: the programmer asks for one token at a time, and string tokens are
+//  views into the source text wherever possible. This allows a large file to
+//  be consumed without building the entire JSON tree. When a tree is needed
+//  (for the whole file or just a single value), the parser builds JsonValue
+//  nodes directly, without the intermediate cJSON tree. These nodes are
+//  allocated from an arena that belongs to the document.
+//
+//  By default, this module (and every module in the io package) accesses the
+//  application save directory.  If you want to access another directory, you
+//  will need to specify an absolute path for the file name.  Keep in mind that
+//  absolute paths are very dangerous on mobile devices, because they do not
+//  have proper file systems.  You should confine all files to either the asset
+//  or the save directory.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#ifndef __CU_JSON_PARSER_H__
+#define __CU_JSON_PARSER_H__
+#include <cugl/assets/CUJsonValue.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+
+namespace  cugl {
+
+/** The arena storing the nodes of a parsed document (opaque) */
+class JsonArena;
+
+/**
+ * This class is a streaming (pull) parser for JSON text.
+ *
+ * Each call to {@link #next} advances the parser to the next token of the
+ * document, which is one of the values in {@link Token}. If the token is
+ * inside of an object, {@link #key} is the key for that value. String values
+ * and keys are returned as views into the source text, unless they contain
+ * escape characters. These views are only valid until the next call to
+ * {@link #next}.
+ *
+ * This makes it possible to process a large file with no allocation beyond
+ * the source text. For example, an array of points can be read one number at
+ * a time. If a part of the document is easier to process as a tree, the
+ * method {@link #readValue} builds a {@link JsonValue} for the current value
+ * (and all of its descendants). The nodes of this tree are allocated from an
+ * arena owned by the document, which is released when the last node is
+ * deleted.
+ *
+ * The parser reads the first value in the text, which is typically an object.
+ * Any text after that value is ignored, and its position is reported by
+ * {@link #getOffset}.
+ *
+ * By default, this class (and every class in the io package) accesses the
+ * application save directory {@see Application#getSaveDirectory()}.  If you
+ * want to access another directory, you will need to specify an absolute path
+ * for the file name.  Keep in mind that absolute paths are very dangerous on
+ * mobile devices, because they do not have proper file systems.  You should
+ * confine all files to either the asset or the save directory.
+ */
+class JsonParser {
+public:
+    /**
+     * This enum represents the tokens of a JSON document
+     */
+    enum class Token : int {
+        /** The parser has not started, or the document is finished */
+        End = 0,
+        /** The start of an object */
+        BeginObject = 1,
+        /** The end of an object */
+        EndObject = 2,
+        /** The start of an array */
+        BeginArray = 3,
+        /** The end of an array */
+        EndArray = 4,
+        /** A string value */
+        String = 5,
+        /** A numeric value */
+        Number = 6,
+        /** A boolean value */
+        Bool = 7,
+        /** A null value */
+        Null = 8,
+        /** The text is not valid JSON */
+        Error = 9
+    };
+
+private:
+    /** The JSON text, if owned by this parser */
+    std::string _source;
+    /** The start of the JSON text */
+    const char* _begin;
+    /** The current read position */
+    const char* _pos;
+    /** The end of the JSON text */
+    const char* _end;
+
+    /** The current token */
+    Token _token;
+    /** The key of the current token (empty if not in an object) */
+    std::string_view _key;
+    /** The string value of the current token */
+    std::string_view _string;
+    /** The numeric value of the current token */
+    double _number;
+    /** The boolean value of the current token */
+    bool _bool;
+
+    /** The open containers ('{' or '[') */
+    std::vector<char> _scopes;
+    /** Whether the current container has no values yet */
+    bool _first;
+    /** Whether the root value has been read */
+    bool _done;
+
+    /** The unescaped key (if the key has escape characters) */
+    std::string _keyspace;
+    /** The unescaped string (if the string has escape characters) */
+    std::string _stringspace;
+    /** The description of the parse error (if any) */
+    std::string _error;
+
+    /** The arena for the nodes built by this parser */
+    std::shared_ptr<JsonArena> _arena;
+
+#pragma mark Internal Helpers
+    /**
+     * Advances the read position past any whitespace
+     */
+    void skipSpace();
+
+    /**
+     * Reads a string literal at the current position.
+     *
+     * The result is a view into the source text if possible. Otherwise it is
+     * a view of the scratch string.
+     *
+     * @param result    The view to store the string
+     * @param scratch   The buffer for unescaped strings
+     *
+     * @return true if the string was read successfully
+     */
+    bool readString(std::string_view& result, std::string& scratch);
+
+    /**
+     * Reads the value at the current position, setting the current token.
+     *
+     * @return the current token
+     */
+    Token readToken();
+
+    /**
+     * Marks the parser as failed with the given message
+     *
+     * @param message   The description of the error
+     *
+     * @return Token::Error
+     */
+    Token fail(const char* message);
+
+    /**
+     * Returns a newly allocated JsonValue node from the document arena
+     *
+     * @return a newly allocated JsonValue node from the document arena
+     */
+    std::shared_ptr<JsonValue> allocNode();
+
+#pragma mark Constructors
+public:
+    /**
+     * Creates a parser with no text.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    JsonParser();
+
+    /**
+     * Deletes this parser, releasing all resources.
+     *
+     * Any trees built by this parser are still valid.
+     */
+    ~JsonParser() { dispose(); }
+
+    /**
+     * Releases all resources of this parser.
+     *
+     * Any trees built by this parser are still valid.
+     */
+    void dispose();
+
+    /**
+     * Initializes a parser with a copy of the given JSON text.
+     *
+     * @param json  The JSON text
+     *
+     * @return true if the parser was initialized successfully
+     */
+    bool init(const std::string& json);
+
+    /**
+     * Initializes a parser for the given JSON text.
+     *
+     * The parser does not copy the text. It must remain valid for as long
+     * as the parser is in use. Trees built by {@link #readValue} do not
+     * reference the text, and may outlive it.
+     *
+     * @param json      The JSON text
+     * @param length    The number of characters in the text
+     *
+     * @return true if the parser was initialized successfully
+     */
+    bool initWithBuffer(const char* json, size_t length);
+
+    /**
+     * Initializes a parser for the given file.
+     *
+     * The file is read into memory in its entirety. By default, this method
+     * accesses the application save directory. If you want to access another
+     * directory, you will need to specify an absolute path for the file name.
+     *
+     * @param file  The path to the JSON file
+     *
+     * @return true if the parser was initialized successfully
+     */
+    bool initWithFile(const std::string& file);
+
+    /**
+     * Initializes a parser for the given asset.
+     *
+     * The file is read into memory in its entirety. The file name is
+     * relative to the application asset directory.
+     *
+     * @param file  The path to the JSON asset
+     *
+     * @return true if the parser was initialized successfully
+     */
+    bool initWithAsset(const std::string& file);
+
+#pragma mark Static Constructors
+    /**
+     * Returns a newly allocated parser with a copy of the given JSON text.
+     *
+     * @param json  The JSON text
+     *
+     * @return a newly allocated parser with a copy of the given JSON text.
+     */
+    static std::shared_ptr<JsonParser> alloc(const std::string& json) {
+        std::shared_ptr<JsonParser> result = std::make_shared<JsonParser>();
+        return (result->init(json) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated parser for the given file.
+     *
+     * The file is read into memory in its entirety. By default, this method
+     * accesses the application save directory. If you want to access another
+     * directory, you will need to specify an absolute path for the file name.
+     *
+     * @param file  The path to the JSON file
+     *
+     * @return a newly allocated parser for the given file.
+     */
+    static std::shared_ptr<JsonParser> allocWithFile(const std::string& file) {
+        std::shared_ptr<JsonParser> result = std::make_shared<JsonParser>();
+        return (result->initWithFile(file) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated parser for the given asset.
+     *
+     * The file is read into memory in its entirety. The file name is
+     * relative to the application asset directory.
+     *
+     * @param file  The path to the JSON asset
+     *
+     * @return a newly allocated parser for the given asset.
+     */
+    static std::shared_ptr<JsonParser> allocWithAsset(const std::string& file) {
+        std::shared_ptr<JsonParser> result = std::make_shared<JsonParser>();
+        return (result->initWithAsset(file) ? result : nullptr);
+    }
+
+#pragma mark Streaming
+    /**
+     * Advances to the next token, and returns it.
+     *
+     * Once the root value is finished, this method returns Token::End. If
+     * the text is not valid JSON, it returns Token::Error, and will continue
+     * to do so.
+     *
+     * @return the next token
+     */
+    Token next();
+
+    /**
+     * Returns the current token.
+     *
+     * @return the current token.
+     */
+    Token token() const { return _token; }
+
+    /**
+     * Returns the key of the current token.
+     *
+     * The key is empty if the current token is not a value in an object.
+     * The view is only valid until the next call to {@link #next}.
+     *
+     * @return the key of the current token.
+     */
+    std::string_view key() const { return _key; }
+
+    /**
+     * Returns the nesting depth of the current token.
+     *
+     * The root value has depth 0. The values inside of it have depth 1, and
+     * so on. The begin and end tokens of a container have the same depth.
+     *
+     * @return the nesting depth of the current token.
+     */
+    size_t depth() const;
+
+    /**
+     * Returns the string value of the current token.
+     *
+     * If the token is not a string, this returns the empty string. The view
+     * is only valid until the next call to {@link #next}.
+     *
+     * @return the string value of the current token.
+     */
+    std::string_view asString() const { return _string; }
+
+    /**
+     * Returns the numeric value of the current token.
+     *
+     * If the token is not a number, this returns the default value.
+     *
+     * @param defaultValue  The value to use if the token is not a number
+     *
+     * @return the numeric value of the current token.
+     */
+    double asDouble(double defaultValue=0.0) const {
+        return _token == Token::Number ? _number : defaultValue;
+    }
+
+    /**
+     * Returns the numeric value of the current token as a float.
+     *
+     * If the token is not a number, this returns the default value.
+     *
+     * @param defaultValue  The value to use if the token is not a number
+     *
+     * @return the numeric value of the current token as a float.
+     */
+    float asFloat(float defaultValue=0.0f) const {
+        return _token == Token::Number ? (float)_number : defaultValue;
+    }
+
+    /**
+     * Returns the numeric value of the current token as an int.
+     *
+     * If the token is not a number, this returns the default value.
+     *
+     * @param defaultValue  The value to use if the token is not a number
+     *
+     * @return the numeric value of the current token as an int.
+     */
+    int asInt(int defaultValue=0) const {
+        return _token == Token::Number ? (int)_number : defaultValue;
+    }
+
+    /**
+     * Returns the boolean value of the current token.
+     *
+     * If the token is not a boolean, this returns the default value.
+     *
+     * @param defaultValue  The value to use if the token is not a boolean
+     *
+     * @return the boolean value of the current token.
+     */
+    bool asBool(bool defaultValue=false) const {
+        return _token == Token::Bool ? _bool : defaultValue;
+    }
+
+    /**
+     * Skips over the current value.
+     *
+     * If the current token begins an object or array, this advances to the
+     * matching end token. Otherwise it does nothing.
+     *
+     * @return false if there was a parse error
+     */
+    bool skip();
+
+    /**
+     * Returns a newly allocated JsonValue for the current value.
+     *
+     * If the current token begins an object or array, the parser advances to
+     * the matching end token, and the result contains all of the descendants.
+     * The nodes are allocated from the document arena. The result has no
+     * parent, and its key is empty.
+     *
+     * If there is a parsing error, this method will return nullptr.
+     *
+     * @return a newly allocated JsonValue for the current value.
+     */
+    std::shared_ptr<JsonValue> readValue();
+
+    /**
+     * Stores the current value in the given node.
+     *
+     * This method is the same as {@link #readValue}, except that the root of
+     * the tree is the given node (which is not in the document arena). Any
+     * children of the node are replaced.
+     *
+     * @param node  The node to store the value
+     *
+     * @return false if there was a parse error
+     */
+    bool readValue(JsonValue* node);
+
+#pragma mark Errors
+    /**
+     * Returns the number of characters consumed from the text.
+     *
+     * @return the number of characters consumed from the text.
+     */
+    size_t getOffset() const { return _pos-_begin; }
+
+    /**
+     * Returns a description of the parse error.
+     *
+     * The description includes the line number and the offending line. If
+     * there is no error, this returns the empty string.
+     *
+     * @return a description of the parse error.
+     */
+    const std::string& getError() const { return _error; }
+};
+
+}
+#endif /* __CU_JSON_PARSER_H__ */
@@ -146,6 +146,47 @@ public:
         std::shared_ptr<JsonReader> result = std::make_shared<JsonReader>();
         return (result->initWithAsset(file,capacity) ? result : nullptr);
     }
+
+    /**
+     * Returns a newly allocated mapped reader for the given file.
+     *
+     * A mapped reader has no read buffer. Instead, the entire file is mapped
+     * into memory {@see MappedFile}, and {@link #readJson} parses the JSON
+     * directly from the mapping, without copying the text.
+     *
+     * If the file is a relative path, this reader will look for the file in
+     * the application save directory {@see Application#getSaveDirectory()}.
+     * If you wish to read a file in any other directory, you must provide
+     * an absolute path.
+     *
+     * @param file  the path (absolute or relative) to the file
+     *
+     * @return a newly allocated mapped reader for the given file.
+     */
+    static std::shared_ptr<JsonReader> allocMapped(const std::string file) {
+        std::shared_ptr<JsonReader> result = std::make_shared<JsonReader>();
+        return (result->initMapped(file) ? result : nullptr);
+    }
+    
+    /**
+     * Returns a newly allocated mapped reader for the given file.
+     *
+     * A mapped reader has no read buffer. Instead, the entire file is mapped
+     * into memory {@see MappedFile}, and {@link #readJson} parses the JSON
+     * directly from the mapping, without copying the text.
+     *
+     * This initializer assumes that the file name is a relative path. It will
+     * search the application assert directory {@see Application#getAssetDirectory()}
+     * for the file and return false if it cannot find it there.
+     *
+     * @param file  the relative path to the file
+     *
+     * @return a newly allocated mapped reader for the given file.
+     */
+    static std::shared_ptr<JsonReader> allocMappedWithAsset(const std::string file) {
+        std::shared_ptr<JsonReader> result = std::make_shared<JsonReader>();
+        return (result->initMappedWithAsset(file) ? result : nullptr);
+    }
     
     
 #pragma mark -
@@ -166,16 +207,19 @@ public:
     std::string readJsonString();
 
     /**
-     * Returns a newly allocated JsonValue for the next available JSON string.
-     * 
-     * This method uses {@link readJsonString()} to extract the next available
-     * JSON string and constructs a JsonValue from that.
+     * Returns a newly allocated JsonValue for the next available JSON value.
+     *
+     * This method parses the first JSON value in the remainder of the stream
+     * in a single pass with {@link JsonParser}. A buffered reader reads the
+     * rest of the stream into memory first. A mapped reader parses the mapping
+     * in place. Either way, any text after that value is left in the stream,
+     * so it can still be read.
      *
      * If there is a parsing error, this  method will return nullptr.  Detailed
      * information about the parsing error will be passed to an assert.  Hence
      * error messages are suppressed if asserts are turned off.
      *
-     * @return a newly allocated JsonValue for the next available JSON string.
+     * @return a newly allocated JsonValue for the next available JSON value.
      */
     std::shared_ptr<JsonValue> readJson();
     
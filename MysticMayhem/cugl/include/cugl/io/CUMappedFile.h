@@ -0,0 +1,244 @@
+//
+//  CUMappedFile.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides read-only access to the contents of a file as a
+//  single block of memory. Where the platform supports it, the file is mapped
+//  into the address space of the application, so nothing is read until it is
+//  touched, and the pages are shared with the OS file cache. Otherwise (e.g.
+//  for assets inside an Android APK), the file is read into a buffer in one
+//  pass. Either way the programmer sees the same pointer and size.
+//
+//  This is intended for files in a fixed binary layout that can be used in
+//  place, without parsing.
+//
+//  By default, this module (and every module in the io package) accesses the
+//  application save directory.  If you want to access another directory, you
+//  will need to specify an absolute path for the file name.  Keep in mind that
+//  absolute paths are very dangerous on mobile devices, because they do not
+//  have proper file systems.  You should confine all files to either the asset
+//  or the save directory.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#ifndef __CU_MAPPED_FILE_H__
+#define __CU_MAPPED_FILE_H__
+#include <cugl/base/CUBase.h>
+#include <SDL/SDL.h>
+#include <string>
+#include <memory>
+
+namespace cugl {
+
+/**
+ * This class provides read-only access to a file as a block of memory.
+ *
+ * On platforms with a file system (macOS, iOS, Windows, Linux) the file is
+ * memory mapped. The data is then paged in on demand, and the memory is
+ * shared with the OS file cache. On Android, assets live in a compressed
+ * archive and cannot be mapped. In that case (or if mapping fails for any
+ * other reason) the file is read into a buffer owned by this object. The
+ * method {@link #isMapped} reports which strategy was used.
+ *
+ * The contents are read-only, and remain valid until this object is disposed.
+ * The start of the data is page aligned when mapped, and aligned for any
+ * fundamental type otherwise.
+ *
+ * By default, this class (and every class in the io package) accesses the
+ * application save directory {@see Application#getSaveDirectory()}.  If you
+ * want to access another directory, you will need to specify an absolute path
+ * for the file name.  Keep in mind that absolute paths are very dangerous on
+ * mobile devices, because they do not have proper file systems.  You should
+ * confine all files to either the asset or the save directory.
+ */
+class MappedFile {
+private:
+    /** The (full) path for the file */
+    std::string _name;
+    /** The start of the file contents */
+    const Uint8* _data;
+    /** The number of bytes in the file */
+    size_t _size;
+    /** Whether the contents are memory mapped (as opposed to buffered) */
+    bool _mapped;
+    /** The file contents, if they are not memory mapped */
+    std::unique_ptr<Uint8[]> _buffer;
+#if defined (__WINDOWS__)
+    /** The Windows file handle */
+    void* _file;
+    /** The Windows file mapping handle */
+    void* _mapping;
+#endif
+
+    /**
+     * Returns true if the file was memory mapped successfully
+     *
+     * @param path  The normalized path to the file
+     *
+     * @return true if the file was memory mapped successfully
+     */
+    bool map(const std::string& path);
+
+    /**
+     * Returns true if the file was read into memory successfully
+     *
+     * @param path  The normalized path to the file
+     *
+     * @return true if the file was read into memory successfully
+     */
+    bool buffer(const std::string& path);
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates a mapped file with no assigned file.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    MappedFile();
+
+    /**
+     * Deletes this mapped file and all of its resources.
+     */
+    ~MappedFile() { dispose(); }
+
+    /**
+     * Initializes the contents with the given file.
+     *
+     * If the file is a relative path, this method will look for the file in
+     * the application save directory {@see Application#getSaveDirectory()}.
+     * If you wish to read a file in any other directory, you must provide
+     * an absolute path.
+     *
+     * @param file  the path (absolute or relative) to the file
+     *
+     * @return true if the file is initialized properly, false otherwise.
+     */
+    bool init(const std::string& file);
+
+    /**
+     * Initializes the contents with the given asset.
+     *
+     * This initializer assumes that the file name is a relative path. It will
+     * search the application asset directory {@see Application#getAssetDirectory()}
+     * for the file and return false if it cannot find it there.
+     *
+     * @param file  the relative path to the file
+     *
+     * @return true if the file is initialized properly, false otherwise.
+     */
+    bool initWithAsset(const std::string& file);
+
+    /**
+     * Releases the file contents.
+     *
+     * Any pointers into the contents are invalid after this call. This object
+     * may be safely reinitialized.
+     */
+    void dispose();
+
+#pragma mark -
+#pragma mark Static Constructors
+    /**
+     * Returns a newly allocated mapping of the given file.
+     *
+     * If the file is a relative path, this method will look for the file in
+     * the application save directory {@see Application#getSaveDirectory()}.
+     * If you wish to read a file in any other directory, you must provide
+     * an absolute path.
+     *
+     * @param file  the path (absolute or relative) to the file
+     *
+     * @return a newly allocated mapping of the given file.
+     */
+    static std::shared_ptr<MappedFile> alloc(const std::string& file) {
+        std::shared_ptr<MappedFile> result = std::make_shared<MappedFile>();
+        return (result->init(file) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated mapping of the given asset.
+     *
+     * This allocator assumes that the file name is a relative path. It will
+     * search the application asset directory {@see Application#getAssetDirectory()}
+     * for the file and return nullptr if it cannot find it there.
+     *
+     * @param file  the relative path to the file
+     *
+     * @return a newly allocated mapping of the given asset.
+     */
+    static std::shared_ptr<MappedFile> allocWithAsset(const std::string& file) {
+        std::shared_ptr<MappedFile> result = std::make_shared<MappedFile>();
+        return (result->initWithAsset(file) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns the start of the file contents.
+     *
+     * The contents are read-only. They are valid until this object is
+     * disposed.
+     *
+     * @return the start of the file contents.
+     */
+    const Uint8* data() const { return _data; }
+
+    /**
+     * Returns the number of bytes in the file.
+     *
+     * @return the number of bytes in the file.
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * Returns true if the contents are memory mapped.
+     *
+     * If this is false, the contents were read into a buffer instead.
+     *
+     * @return true if the contents are memory mapped.
+     */
+    bool isMapped() const { return _mapped; }
+
+    /**
+     * Returns the (full) path of the file.
+     *
+     * @return the (full) path of the file.
+     */
+    const std::string& getPath() const { return _name; }
+};
+
+}
+#endif /* __CU_MAPPED_FILE_H__ */
@@ -13,6 +13,9 @@
 //  have proper file systems.  You should confine all files to either the asset
 //  or the save directory.
 //
+//  A reader may also map the file into memory, in which case lines can be
+//  read as views into the mapping without copying them.
+//
 //  This class uses our standard shared-pointer architecture.
 //
 //  1. The constructor does not perform any initialization; it just sets all
@@ -51,9 +54,14 @@
 #include <cugl/base/CUBase.h>
 #include <SDL/SDL.h>
 #include <string>
+#include <string_view>
+#include <memory>
 
 namespace  cugl {
 
+/** Forward reference to a mapped file */
+class MappedFile;
+
 #pragma mark -
 #pragma mark TextReader
 
@@ -70,6 +78,11 @@ namespace  cugl {
  * for the file name.  Keep in mind that absolute paths are very dangerous on 
  * mobile devices, because they do not have proper file systems.  You should 
  * confine all files to either the asset or the save directory.
+ *
+ * A reader may either be buffered or mapped. A buffered reader reads the file
+ * in chunks of a fixed capacity. A mapped reader maps the entire file into
+ * memory {@see MappedFile}, so that {@link #readLineView} can return lines
+ * without copying them.
  */
 class TextReader {
 protected:
@@ -90,6 +103,11 @@ protected:
     Uint32      _capacity;
     /** The current offset in the read buffer */
     Sint32      _bufoff;
+    
+    /** The file mapping (nullptr if this reader is buffered) */
+    std::shared_ptr<MappedFile> _mapping;
+    /** Whether this reader maps the file instead of buffering it */
+    bool        _mapped;
 
 #pragma mark -
 #pragma mark Internal Methods
@@ -101,6 +119,23 @@ protected:
      */
     void fill();
     
+    /**
+     * Maps the file {@link #_name} into memory, returning true on success.
+     *
+     * @return true if the file was mapped
+     */
+    bool map();
+    
+    /**
+     * Returns the unread data available without another read from the file.
+     *
+     * For a mapped reader, this is the entire file. The offset {@link #_bufoff}
+     * is an index into this window. The window is invalidated by {@link #fill}.
+     *
+     * @return the unread data available without another read from the file.
+     */
+    std::string_view window() const;
+    
 #pragma mark -
 #pragma mark Constructors
 public:
@@ -111,7 +146,8 @@ public:
      * the heap, use one of the static constructors instead.
      */
     TextReader() : _name(""), _stream(nullptr), _ssize(-1), _scursor(-1),
-                   _sbuffer(""), _cbuffer(nullptr), _capacity(0), _bufoff(-1) {}
+                   _sbuffer(""), _cbuffer(nullptr), _capacity(0), _bufoff(-1),
+                   _mapped(false) {}
     
     /**
      * Deletes this reader and all of its resources.
@@ -183,6 +219,41 @@ public:
      */
     bool initWithAsset(const std::string file, unsigned int capacity);
     
+    /**
+     * Initializes a mapped reader for the given file.
+     *
+     * A mapped reader has no read buffer. Instead, the entire file is mapped
+     * into memory {@see MappedFile}, and lines are read directly from the
+     * mapping.
+     *
+     * If the file is a relative path, this reader will look for the file in
+     * the application save directory {@see Application#getSaveDirectory()}.
+     * If you wish to read a file in any other directory, you must provide
+     * an absolute path.
+     *
+     * @param file  the path (absolute or relative) to the file
+     *
+     * @return true if the reader is initialized properly, false otherwise.
+     */
+    bool initMapped(const std::string file);
+    
+    /**
+     * Initializes a mapped reader for the given file.
+     *
+     * A mapped reader has no read buffer. Instead, the entire file is mapped
+     * into memory {@see MappedFile}, and lines are read directly from the
+     * mapping.
+     *
+     * This initializer assumes that the file name is a relative path. It will
+     * search the application assert directory {@see Application#getAssetDirectory()}
+     * for the file and return false if it cannot find it there.
+     *
+     * @param file  the relative path to the file
+     *
+     * @return true if the reader is initialized properly, false otherwise.
+     */
+    bool initMappedWithAsset(const std::string file);
+    
     
 #pragma mark -
 #pragma mark Static Constructors
@@ -260,6 +331,47 @@ public:
         std::shared_ptr<TextReader> result = std::make_shared<TextReader>();
         return (result->initWithAsset(file,capacity) ? result : nullptr);
     }
+    
+    /**
+     * Returns a newly allocated mapped reader for the given file.
+     *
+     * A mapped reader has no read buffer. Instead, the entire file is mapped
+     * into memory {@see MappedFile}, and lines are read directly from the
+     * mapping.
+     *
+     * If the file is a relative path, this reader will look for the file in
+     * the application save directory {@see Application#getSaveDirectory()}.
+     * If you wish to read a file in any other directory, you must provide
+     * an absolute path.
+     *
+     * @param file  the path (absolute or relative) to the file
+     *
+     * @return a newly allocated mapped reader for the given file.
+     */
+    static std::shared_ptr<TextReader> allocMapped(const std::string file) {
+        std::shared_ptr<TextReader> result = std::make_shared<TextReader>();
+        return (result->initMapped(file) ? result : nullptr);
+    }
+    
+    /**
+     * Returns a newly allocated mapped reader for the given file.
+     *
+     * A mapped reader has no read buffer. Instead, the entire file is mapped
+     * into memory {@see MappedFile}, and lines are read directly from the
+     * mapping.
+     *
+     * This initializer assumes that the file name is a relative path. It will
+     * search the application assert directory {@see Application#getAssetDirectory()}
+     * for the file and return false if it cannot find it there.
+     *
+     * @param file  the relative path to the file
+     *
+     * @return a newly allocated mapped reader for the given file.
+     */
+    static std::shared_ptr<TextReader> allocMappedWithAsset(const std::string file) {
+        std::shared_ptr<TextReader> result = std::make_shared<TextReader>();
+        return (result->initMappedWithAsset(file) ? result : nullptr);
+    }
 
     
 #pragma mark -
@@ -287,7 +399,14 @@ public:
      *
      * @return true if there is still data to read
      */
-    bool ready() const { return _bufoff < _sbuffer.size() || _scursor < _ssize; }
+    bool ready() const { return (_bufoff >= 0 && (size_t)_bufoff < window().size()) || _scursor < _ssize; }
+    
+    /**
+     * Returns true if this reader maps the file instead of buffering it.
+     *
+     * @return true if this reader maps the file instead of buffering it.
+     */
+    bool isMapped() const { return _mapped; }
     
     
 #pragma mark -
@@ -373,6 +492,19 @@ public:
      */
     std::string& readLine(std::string& data);
     
+    /**
+     * Returns a single line for text from the stream, without copying it.
+     *
+     * This method is identical to {@link #readLine}, except that the line is
+     * a view into the reader. For a mapped reader, the view is valid until the
+     * reader is closed or reset. For a buffered reader, the view is only valid
+     * until the next read, and the buffer grows past its capacity if a line
+     * does not fit.
+     *
+     * @return a single line for text from the stream
+     */
+    std::string_view readLineView();
+    
     /**
      * Returns the unread remainder of the stream
      *
@@ -30,9 +30,11 @@
 
 #include "CUTextReader.h"
 #include "CUTextWriter.h"
+#include "CUJsonParser.h"
 #include "CUJsonReader.h"
 #include "CUJsonWriter.h"
 #include "CUBinaryReader.h"
+#include "CUMappedFile.h"
 #include "CUBinaryWriter.h"
 
 #endif /* __CU_IO_PKG_H__ */
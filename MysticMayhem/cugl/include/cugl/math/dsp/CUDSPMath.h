@@ -3,11 +3,11 @@
 //  Cornell University Game Library (CUGL)
 //
 //  This class is represents a class of static methods for performing basic
-//  DSP calculations, like addition and multiplication.  As with the DSP
-//  filters, this class supports vector optimizations for SSE and Neon 64.
-//  Our implementation is limited to 128-bit words.  While 256-bit (e.g. AVX)
-//  are more performant, they are not better for DSP filters and so we keep
-//  the optimizations at the same level.
+//  DSP calculations, like addition and multiplication.  These methods are on
+//  the critical path of the audio thread, so they are vectorized with SSE2,
+//  AVX2, or Neon 64.  The vector backend is chosen at runtime from the
+//  features of the current CPU.  Unlike the DSP filters, these methods are
+//  simple enough to benefit from 256-bit (AVX) words.
 //
 //  CUGL MIT License:
 //      This software is provided 'as-is', without any express or implied
@@ -34,6 +34,7 @@
 #ifndef __CU_DSP_MATH_H__
 #define __CU_DSP_MATH_H__
 #include "../CUMathBase.h"
+#include <string>
 
 namespace cugl {
     namespace dsp {
@@ -41,17 +42,39 @@ namespace cugl {
 /**
  * This class is a collection of static methods for basic DSP calculations
  *
- * As with the DSP filters, this class supports vector optimizations for SSE
- * and Neon 64. Our implementation is limited to 128-bit words.  While 256-bit
- * (e.g. AVX) are more performant, they are not better for DSP filters and so
- * we keep the optimizations at the same level.
+ * This class supports vector optimizations for SSE2, AVX2 and Neon 64. The
+ * best backend supported by the CPU is chosen when the program starts. On x86
+ * processors, this is AVX2 if the CPU supports it (and SSE2 otherwise). The
+ * backend may be changed with {@link #setBackend} to compare against the
+ * scalar algorithms, as in {@link #benchmark}.
+ *
+ * Vectorized methods use unaligned loads, so the buffers do not need any
+ * special alignment.
  *
  * This class is not thread safe.  External locking may be required when
  * the filter is shared between multiple threads (such as between an audio
  * thread and the main thread).
  */
 class DSPMath {
+public:
+    /**
+     * The vector instruction sets supported by this class
+     */
+    enum class Backend : int {
+        /** The scalar algorithms (no vectorization) */
+        SCALAR = 0,
+        /** The 128-bit SSE2 instructions (all x86-64 processors) */
+        SSE2   = 1,
+        /** The 256-bit AVX2 and FMA instructions (most x86-64 processors) */
+        AVX2   = 2,
+        /** The 128-bit Neon 64 instructions (all 64-bit ARM processors) */
+        NEON   = 3
+    };
+
 private:
+    /** The active vector backend (Access not thread safe) */
+    static Backend _backend;
+    
     /**
      * Default constructor (does nothing)
      */
@@ -67,6 +90,52 @@ public:
     /** Whether to use a vectorization algorithm (Access not thread safe) */
     static bool VECTORIZE;
     
+#pragma mark Vector Backends
+    /**
+     * Returns the best vector backend supported by this CPU
+     *
+     * This is the backend chosen when the program starts. It is SCALAR if
+     * the platform has no supported vector instructions.
+     *
+     * @return the best vector backend supported by this CPU
+     */
+    static Backend getNativeBackend();
+
+    /**
+     * Returns the active vector backend
+     *
+     * The backend is ignored (and the scalar algorithms are used) if
+     * {@link #VECTORIZE} is false.
+     *
+     * @return the active vector backend
+     */
+    static Backend getBackend() { return _backend; }
+
+    /**
+     * Returns true if the given vector backend is supported by this CPU
+     *
+     * The scalar backend is always supported. On x86 processors, SSE2 is
+     * supported whenever AVX2 is supported.
+     *
+     * @param backend   The vector backend to test
+     *
+     * @return true if the given vector backend is supported by this CPU
+     */
+    static bool isSupported(Backend backend);
+
+    /**
+     * Sets the active vector backend
+     *
+     * If the backend is not supported by this CPU, this method does nothing
+     * and returns false. This method is not thread safe, and should not be
+     * called while the audio thread is running.
+     *
+     * @param backend   The vector backend to use
+     *
+     * @return true if the backend was changed
+     */
+    static bool setBackend(Backend backend);
+
 #pragma mark Arithmetic Methods
     /**
      * Adds two input signals together, storing the result in output
@@ -124,6 +193,40 @@ public:
      * @return the number of elements successfully processed
      */
     static size_t scale_add(float* input1, float* input2, float scalar, float* output, size_t size);
+
+    /**
+     * Adds several input signals together and scales the sum, storing the result in output
+     *
+     * This method is equivalent to repeated calls to {@link #add} followed
+     * by {@link #scale}. However, it makes a single pass over the output
+     * buffer, which is much faster when mixing many signals. If count is 0,
+     * the output is filled with zeroes.
+     *
+     * It is safe for output to be the same as one of the input buffers.
+     *
+     * @param inputs    The array of input buffers
+     * @param count     The number of input buffers
+     * @param gain      The scalar to multiply the sum by
+     * @param output    The output buffer
+     * @param size      The number of elements to process
+     *
+     * @return the number of elements successfully processed
+     */
+    static size_t mix(float** inputs, size_t count, float gain, float* output, size_t size);
+
+    /**
+     * Converts signed 16 bit PCM samples to floats, storing the result in output
+     *
+     * Each sample is divided by 32768, so that the output is in the range
+     * [-1,1). This is used to play compact in-memory audio samples.
+     *
+     * @param input     The input buffer of 16 bit samples
+     * @param output    The output buffer
+     * @param size      The number of elements to process
+     *
+     * @return the number of elements successfully processed
+     */
+    static size_t convert(const Sint16* input, float* output, size_t size);
     
 #pragma mark Fade-In/Out Methods
     /**
@@ -187,6 +290,8 @@ public:
      *
      *     y = (bound*x - knee+knee*knee)/x
      *
+     * for positive x (the clamp is symmetric for negative x).
+     *
      * @param data      The stream buffer
      * @param bound     The asymptotic bound
      * @param knee      The soft knee bound
@@ -198,6 +303,29 @@ public:
 
     // TODO: Add convolution
 
+#pragma mark Benchmarking
+    /**
+     * Returns a report comparing the vector backends to the scalar algorithms
+     *
+     * This method times each of the methods in this class, as well as the
+     * calculate methods of {@link BiquadIIR}, {@link OnePoleIIR}, and
+     * {@link TwoPoleIIR}. Each method is timed on every supported backend
+     * (including the scalar backend). The report has one line per method,
+     * giving the throughput in frames per microsecond. The {@link #mix}
+     * method is timed with four inputs.
+     *
+     * The active backend and vectorization flags are restored when this
+     * method returns. This method is not thread safe, and should not be
+     * called while the audio thread is running.
+     *
+     * @param frames    The number of frames in each buffer
+     * @param channels  The number of interleaved channels
+     * @param trials    The number of times to run each method
+     *
+     * @return a report comparing the vector backends to the scalar algorithms
+     */
+    static std::string benchmark(Uint32 frames, Uint32 channels, Uint32 trials);
+
 };
     }
 }
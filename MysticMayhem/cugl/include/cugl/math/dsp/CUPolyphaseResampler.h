@@ -0,0 +1,323 @@
+//
+//  CUPolyphaseResampler.h
+//  Cornell University Game Library (CUGL)
+//
+//  This class is a streaming sample rate converter. It implements a polyphase
+//  windowed-sinc filter, which is the standard high quality algorithm for
+//  rational rate conversion (such as 44100 Hz to 48000 Hz). The filter bank
+//  for each conversion ratio is computed once and shared by all resamplers
+//  with that ratio, so creating a resampler is cheap.
+//
+//  The inner loop of the filter is a dot product, which is vectorized for
+//  SSE2, AVX2 and Neon 64 using the backend chosen by DSPMath. The number of
+//  filter taps is determined by a quality setting, which trades off CPU cost
+//  and latency against the quality of the anti-aliasing filter.
+//
+//  This class is NOT THREAD SAFE.  This is by design, for performance reasons.
+//  External locking may be required when the resampler is shared between
+//  multiple threads (such as between an audio thread and the main thread).
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#ifndef __CU_POLYPHASE_RESAMPLER_H__
+#define __CU_POLYPHASE_RESAMPLER_H__
+#include <cugl/math/CUMathBase.h>
+#include <memory>
+#include <vector>
+
+namespace cugl {
+    namespace dsp {
+
+/**
+ * This class implements a streaming polyphase sample rate converter.
+ *
+ * The conversion ratio is reduced to a fraction L/M, where L is the output
+ * rate and M is the input rate divided by their greatest common divisor
+ * (so 44100 Hz to 48000 Hz is 160/147). Each output frame is the dot product
+ * of a window of input frames with one of L phases of a Kaiser-windowed sinc
+ * filter. If L exceeds {@link #MAX_PHASES}, the bank instead has that many
+ * phases, and the resampler interpolates between adjacent phases. The timing
+ * is always exact; only the filter coefficients are approximated.
+ *
+ * The filter banks are computed once per conversion ratio, channel count and
+ * quality, and are shared by all resamplers with those settings. They are
+ * stored with each coefficient repeated once per channel, so that the dot
+ * product runs directly on interleaved input. This dot product is vectorized
+ * for SSE2, AVX2 and Neon 64 whenever the number of channels divides the
+ * vector width (1, 2, 4 and, on AVX2, 8 channels). It respects the backend
+ * and vectorization settings of {@link DSPMath}.
+ *
+ * The resampler is a pull stream. Call {@link #getInputNeeded} to learn how
+ * much input is required for the next output, write that input to
+ * {@link #getInputBuffer} and {@link #commit} it, and then {@link #pull} the
+ * output. This allows an audio node to read input directly into the resampler
+ * without an intermediate copy. The latency of the filter is half the number
+ * of taps, measured in input frames.
+ *
+ * This class is not thread safe.  External locking may be required when
+ * the resampler is shared between multiple threads (such as between an audio
+ * thread and the main thread).
+ */
+class PolyphaseResampler {
+public:
+    /**
+     * The quality of the anti-aliasing filter
+     *
+     * Higher qualities have more taps, which increases both the CPU cost and
+     * the latency of the resampler.
+     */
+    enum class Quality : int {
+        /** 16 taps with a soft rolloff (8 frames of latency) */
+        LOW    = 0,
+        /** 32 taps with a moderate rolloff (16 frames of latency) */
+        MEDIUM = 1,
+        /** 64 taps with a sharp rolloff (32 frames of latency) */
+        HIGH   = 2
+    };
+
+    /** The maximum number of phases in a filter bank */
+    static const Uint32 MAX_PHASES;
+
+private:
+    /** The number of channels to support */
+    Uint32 _channels;
+    /** The input sample rate */
+    Uint32 _inrate;
+    /** The output sample rate */
+    Uint32 _outrate;
+    /** The filter quality */
+    Quality _quality;
+    /** The number of taps in each phase */
+    Uint32 _taps;
+    /** The reduced output rate (L) */
+    Uint32 _upsample;
+    /** The reduced input rate (M) */
+    Uint32 _downsample;
+    /** The number of phases in the filter bank (excluding any guard phase) */
+    Uint32 _phases;
+
+    /** The shared filter bank (one row of taps*channels per phase) */
+    std::shared_ptr<const std::vector<float>> _bank;
+    /** The interleaved input history */
+    std::vector<float> _history;
+    /** The results of the second phase when interpolating */
+    std::vector<float> _scratch;
+    /** The capacity of the history in frames */
+    Uint32 _capacity;
+    /** The number of frames in the history */
+    Uint32 _avail;
+    /** The history frame of the first tap of the next output */
+    Uint32 _index;
+    /** The phase of the next output, as a numerator of L */
+    Uint32 _phase;
+
+public:
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized resampler.
+     *
+     * The resampler must be initialized before use.
+     */
+    PolyphaseResampler();
+
+    /**
+     * Creates a resampler with the given settings.
+     *
+     * The capacity is the largest number of frames that will be pulled at
+     * once. The resampler can still output more, but will need several calls
+     * to {@link #pull}.
+     *
+     * @param channels  The number of channels
+     * @param inrate    The input sample rate
+     * @param outrate   The output sample rate
+     * @param quality   The filter quality
+     * @param capacity  The maximum number of output frames per pull
+     */
+    PolyphaseResampler(Uint32 channels, Uint32 inrate, Uint32 outrate,
+                       Quality quality, Uint32 capacity);
+
+    /**
+     * Destroys the resampler, releasing all resources.
+     */
+    ~PolyphaseResampler() {}
+
+    /**
+     * Initializes a resampler with the given settings.
+     *
+     * The capacity is the largest number of frames that will be pulled at
+     * once. The resampler can still output more, but will need several calls
+     * to {@link #pull}.
+     *
+     * This method allocates memory, and should not be called on the audio
+     * thread.
+     *
+     * @param channels  The number of channels
+     * @param inrate    The input sample rate
+     * @param outrate   The output sample rate
+     * @param quality   The filter quality
+     * @param capacity  The maximum number of output frames per pull
+     *
+     * @return true if initialization was successful
+     */
+    bool init(Uint32 channels, Uint32 inrate, Uint32 outrate,
+              Quality quality, Uint32 capacity);
+
+    /**
+     * Precomputes the filter bank for the given settings.
+     *
+     * Filter banks are computed the first time that they are needed. This
+     * method allows an application to compute the banks for common ratios
+     * (such as 44100 Hz to 48000 Hz) at start-up instead.
+     *
+     * @param channels  The number of channels
+     * @param inrate    The input sample rate
+     * @param outrate   The output sample rate
+     * @param quality   The filter quality
+     */
+    static void precompute(Uint32 channels, Uint32 inrate, Uint32 outrate, Quality quality);
+
+#pragma mark Attributes
+    /**
+     * Returns the number of channels for this resampler
+     *
+     * @return the number of channels for this resampler
+     */
+    Uint32 getChannels() const { return _channels; }
+
+    /**
+     * Returns the input sample rate
+     *
+     * @return the input sample rate
+     */
+    Uint32 getInputRate() const { return _inrate; }
+
+    /**
+     * Returns the output sample rate
+     *
+     * @return the output sample rate
+     */
+    Uint32 getOutputRate() const { return _outrate; }
+
+    /**
+     * Returns the filter quality
+     *
+     * @return the filter quality
+     */
+    Quality getQuality() const { return _quality; }
+
+    /**
+     * Returns the number of filter taps for this resampler
+     *
+     * @return the number of filter taps for this resampler
+     */
+    Uint32 getTaps() const { return _taps; }
+
+    /**
+     * Returns the number of filter taps for the given quality
+     *
+     * @param quality   The filter quality
+     *
+     * @return the number of filter taps for the given quality
+     */
+    static Uint32 getTaps(Quality quality);
+
+    /**
+     * Returns the latency of this resampler in output frames
+     *
+     * This is the delay between an input frame and the output frame centered
+     * upon it, which is half the filter taps (converted to the output rate).
+     *
+     * @return the latency of this resampler in output frames
+     */
+    Uint32 getLatency() const;
+
+#pragma mark Streaming
+    /**
+     * Clears the input history.
+     *
+     * The history is replaced with silence, so the next output frame is
+     * centered on the next input frame.
+     */
+    void clear();
+
+    /**
+     * Returns the number of input frames needed to produce the given output
+     *
+     * The result is limited by the free space in the input buffer, so it may
+     * take several rounds to produce a large output.
+     *
+     * @param frames    The number of output frames desired
+     *
+     * @return the number of input frames needed to produce the given output
+     */
+    Uint32 getInputNeeded(Uint32 frames) const;
+
+    /**
+     * Returns the buffer for the next input frames
+     *
+     * The buffer has room for the (interleaved) frames returned by
+     * {@link #getInputNeeded}. The frames are not added to the stream until
+     * they are committed.
+     *
+     * @return the buffer for the next input frames
+     */
+    float* getInputBuffer() {
+        return _history.data()+(size_t)_avail*_channels;
+    }
+
+    /**
+     * Adds the given number of frames from the input buffer to the stream
+     *
+     * @param frames    The number of frames written to the input buffer
+     */
+    void commit(Uint32 frames);
+
+    /**
+     * Copies the given input frames into the stream
+     *
+     * This is a convenience method that copies to {@link #getInputBuffer} and
+     * commits the result. It only accepts as many frames as fit in the input
+     * buffer.
+     *
+     * @param input     The interleaved input frames
+     * @param frames    The number of input frames
+     *
+     * @return the number of frames accepted
+     */
+    Uint32 push(const float* input, Uint32 frames);
+
+    /**
+     * Writes up to the given number of output frames
+     *
+     * This method produces as many frames as the current input allows. The
+     * frames are interleaved into the output buffer.
+     *
+     * @param output    The buffer to store the output
+     * @param frames    The maximum number of frames to write
+     *
+     * @return the number of frames written
+     */
+    Uint32 pull(float* output, Uint32 frames);
+};
+    }
+}
+#endif /* __CU_POLYPHASE_RESAMPLER_H__ */
@@ -37,6 +37,7 @@
 #include "CUTwoPoleIIR.h"
 #include "CUPoleZeroIIR.h"
 #include "CUBiquadIIR.h"
+#include "CUPolyphaseResampler.h"
 
 #endif /* __CU_DSP_PKG_H__ */
 
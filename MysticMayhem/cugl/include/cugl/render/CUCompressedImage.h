@@ -0,0 +1,361 @@
+//
+//  CUCompressedImage.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides support for block-compressed images stored in KTX
+//  (version 1) and KTX2 containers. These images are uploaded to the graphics
+//  card as is, without decoding, so they use a fraction of the memory of an
+//  RGBA texture. We support the ETC2 formats (standard on OpenGLES 3) and the
+//  ASTC formats (common on mobile devices).
+//
+//  The container is memory mapped where possible, and each mipmap level is a
+//  pointer into the mapping. Loading an image therefore reads nothing that is
+//  not uploaded, and is safe to do outside of the main thread. Only the upload
+//  itself (see Texture) requires the OpenGL context.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#ifndef __CU_COMPRESSED_IMAGE_H__
+#define __CU_COMPRESSED_IMAGE_H__
+#include <cugl/base/CUBase.h>
+#include <cugl/io/CUMappedFile.h>
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace cugl {
+
+/**
+ * This class is a block-compressed image read from a KTX or KTX2 container.
+ *
+ * Only two-dimensional images are supported. That is, the container may not
+ * hold an array, a cube map, or a volume. KTX2 containers may not use
+ * supercompression. The payload must be one of the ETC2 or ASTC formats;
+ * see {@link #getBlockWidth} for the list.
+ *
+ * CUGL does not use sRGB textures. The sRGB variant of a format has the same
+ * block encoding as the linear one, so {@link #getFormat} always reports the
+ * linear variant. This matches how PNG files are loaded.
+ *
+ * A container is validated when it is initialized. If it is not valid, the
+ * initializer logs the reason and fails. Afterwards the level pointers are
+ * valid as long as this object is.
+ */
+class CompressedImage {
+private:
+    /** The mapped container (nullptr if this points at a buffer) */
+    std::shared_ptr<MappedFile> _file;
+    /** The OpenGL internal format of the blocks */
+    GLenum _format;
+    /** The width of the base level in pixels */
+    Uint32 _width;
+    /** The height of the base level in pixels */
+    Uint32 _height;
+    /** The start of each mipmap level (the base level first) */
+    std::vector<const Uint8*> _levels;
+    /** The number of bytes in each mipmap level */
+    std::vector<size_t> _sizes;
+    /** The name of the container, for error messages */
+    std::string _name;
+
+    /**
+     * Returns true if the data is a valid KTX (version 1) container.
+     *
+     * @param data  The container contents
+     * @param size  The number of bytes in the container
+     *
+     * @return true if the data is a valid KTX (version 1) container.
+     */
+    bool parseKTX(const Uint8* data, size_t size);
+
+    /**
+     * Returns true if the data is a valid KTX2 container.
+     *
+     * @param data  The container contents
+     * @param size  The number of bytes in the container
+     *
+     * @return true if the data is a valid KTX2 container.
+     */
+    bool parseKTX2(const Uint8* data, size_t size);
+
+    /**
+     * Returns true if the given level is the correct size for the format.
+     *
+     * @param level The mipmap level
+     * @param size  The number of bytes in the level
+     *
+     * @return true if the given level is the correct size for the format.
+     */
+    bool checkLevel(Uint32 level, size_t size) const;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates an empty compressed image.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    CompressedImage();
+
+    /**
+     * Deletes this image, releasing all resources.
+     */
+    ~CompressedImage() { dispose(); }
+
+    /**
+     * Releases the image contents.
+     *
+     * Any level pointers are invalid after this call. This object may be
+     * safely reinitialized.
+     */
+    void dispose();
+
+    /**
+     * Initializes this image from a container in memory.
+     *
+     * The image points into the given data, which must outlive this object.
+     *
+     * @param data  The container contents
+     * @param size  The number of bytes in the container
+     *
+     * @return true if the container is valid.
+     */
+    bool initWithData(const Uint8* data, size_t size);
+
+    /**
+     * Initializes this image from the given container file.
+     *
+     * If the file is a relative path, this method will look for the file in
+     * the application save directory {@see Application#getSaveDirectory()}.
+     * If you wish to read a file in any other directory, you must provide
+     * an absolute path.
+     *
+     * This method fails quietly if the file does not exist, but logs an
+     * error if it exists and is not valid.
+     *
+     * @param file  the path (absolute or relative) to the container
+     *
+     * @return true if the container is valid.
+     */
+    bool init(const std::string& file);
+
+    /**
+     * Initializes this image from the given container asset.
+     *
+     * This initializer assumes that the file name is a relative path. It will
+     * search the application asset directory {@see Application#getAssetDirectory()}
+     * for the file and return false if it cannot find it there.
+     *
+     * This method fails quietly if the file does not exist, but logs an
+     * error if it exists and is not valid.
+     *
+     * @param file  the relative path to the container
+     *
+     * @return true if the container is valid.
+     */
+    bool initWithAsset(const std::string& file);
+
+#pragma mark -
+#pragma mark Static Constructors
+    /**
+     * Returns a newly allocated image from a container in memory.
+     *
+     * The image points into the given data, which must outlive this object.
+     *
+     * @param data  The container contents
+     * @param size  The number of bytes in the container
+     *
+     * @return a newly allocated image from a container in memory.
+     */
+    static std::shared_ptr<CompressedImage> allocWithData(const Uint8* data, size_t size) {
+        std::shared_ptr<CompressedImage> result = std::make_shared<CompressedImage>();
+        return (result->initWithData(data,size) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated image from the given container file.
+     *
+     * If the file is a relative path, this method will look for the file in
+     * the application save directory {@see Application#getSaveDirectory()}.
+     * If you wish to read a file in any other directory, you must provide
+     * an absolute path.
+     *
+     * @param file  the path (absolute or relative) to the container
+     *
+     * @return a newly allocated image from the given container file.
+     */
+    static std::shared_ptr<CompressedImage> alloc(const std::string& file) {
+        std::shared_ptr<CompressedImage> result = std::make_shared<CompressedImage>();
+        return (result->init(file) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated image from the given container asset.
+     *
+     * This allocator assumes that the file name is a relative path. It will
+     * search the application asset directory {@see Application#getAssetDirectory()}
+     * for the file and return nullptr if it cannot find it there.
+     *
+     * @param file  the relative path to the container
+     *
+     * @return a newly allocated image from the given container asset.
+     */
+    static std::shared_ptr<CompressedImage> allocWithAsset(const std::string& file) {
+        std::shared_ptr<CompressedImage> result = std::make_shared<CompressedImage>();
+        return (result->initWithAsset(file) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns the OpenGL internal format of this image.
+     *
+     * This is always the linear (not sRGB) variant of the format.
+     *
+     * @return the OpenGL internal format of this image.
+     */
+    GLenum getFormat() const { return _format; }
+
+    /**
+     * Returns the width of the base level in pixels.
+     *
+     * @return the width of the base level in pixels.
+     */
+    Uint32 getWidth() const { return _width; }
+
+    /**
+     * Returns the height of the base level in pixels.
+     *
+     * @return the height of the base level in pixels.
+     */
+    Uint32 getHeight() const { return _height; }
+
+    /**
+     * Returns the number of mipmap levels, including the base level.
+     *
+     * @return the number of mipmap levels, including the base level.
+     */
+    Uint32 getLevelCount() const { return (Uint32)_levels.size(); }
+
+    /**
+     * Returns the blocks of the given mipmap level.
+     *
+     * Level 0 is the base level.
+     *
+     * @param level The mipmap level
+     *
+     * @return the blocks of the given mipmap level.
+     */
+    const Uint8* getLevel(Uint32 level) const { return _levels[level]; }
+
+    /**
+     * Returns the number of bytes in the given mipmap level.
+     *
+     * Level 0 is the base level.
+     *
+     * @param level The mipmap level
+     *
+     * @return the number of bytes in the given mipmap level.
+     */
+    size_t getLevelSize(Uint32 level) const { return _sizes[level]; }
+
+    /**
+     * Returns the number of bytes in all of the mipmap levels.
+     *
+     * This is the amount of graphics memory the image uses once uploaded.
+     *
+     * @return the number of bytes in all of the mipmap levels.
+     */
+    size_t getByteSize() const;
+
+    /**
+     * Returns true if this image has an alpha channel.
+     *
+     * @return true if this image has an alpha channel.
+     */
+    bool hasAlpha() const;
+
+#pragma mark -
+#pragma mark Formats
+    /**
+     * Returns the width of a block in the given format, or 0 if unsupported.
+     *
+     * The supported formats are the (linear and sRGB) variants of
+     *
+     *      GL_COMPRESSED_RGB8_ETC2
+     *      GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+     *      GL_COMPRESSED_RGBA8_ETC2_EAC
+     *      GL_COMPRESSED_RGBA_ASTC_4x4 through GL_COMPRESSED_RGBA_ASTC_12x12
+     *
+     * @param format    The OpenGL internal format
+     *
+     * @return the width of a block in the given format, or 0 if unsupported.
+     */
+    static Uint32 getBlockWidth(GLenum format);
+
+    /**
+     * Returns the height of a block in the given format, or 0 if unsupported.
+     *
+     * @param format    The OpenGL internal format
+     *
+     * @return the height of a block in the given format, or 0 if unsupported.
+     */
+    static Uint32 getBlockHeight(GLenum format);
+
+    /**
+     * Returns the number of bytes in a block in the given format, or 0 if unsupported.
+     *
+     * @param format    The OpenGL internal format
+     *
+     * @return the number of bytes in a block in the given format, or 0 if unsupported.
+     */
+    static Uint32 getBlockBytes(GLenum format);
+
+    /**
+     * Returns true if the graphics card can sample the given format.
+     *
+     * This method queries the OpenGL context the first time it is called,
+     * and caches the answer. Therefore, the first call must happen on the
+     * rendering thread. Afterwards, it is safe to call from any thread.
+     *
+     * @param format    The OpenGL internal format
+     *
+     * @return true if the graphics card can sample the given format.
+     */
+    static bool isSupported(GLenum format);
+};
+
+}
+#endif /* __CU_COMPRESSED_IMAGE_H__ */
@@ -6,6 +6,10 @@
 //  systems we decided to merge fonts and font atlases because it helps with
 //  asset management.
 //
+//  An atlas may also store signed distance fields instead of coverage. A
+//  distance field atlas renders cleanly at any scale, so one atlas can serve
+//  every size of the same font face.
+//
 //  This module makes heavy use of the cross-platform UTF8 utilities by
 //  Nemanja Trifunovic ( https://github.com/nemtrif/utfcpp ).
 //
@@ -56,8 +60,12 @@
 #include <cugl/render/CUSpriteVertex.h>
 #include <cugl/render/CUMesh.h>
 #include <SDL/SDL_ttf.h>
+#include <memory>
 
 namespace cugl {
+
+/** Forward reference to a thread pool */
+class ThreadPool;
     
 /**
  * This class represents a true type font at a fixed size.
@@ -270,6 +278,14 @@ protected:
     std::shared_ptr<Texture> _texture;
     /** A (temporary) SDL surface for computing the atlas texture */
     SDL_Surface* _surface;
+    /** Whether the atlas stores signed distance fields instead of coverage */
+    bool _distance;
+    /** The padding around each glyph for its distance field (0 if none) */
+    int _spread;
+    /** The ratio of this font size to the size of the atlas glyphs */
+    float _atlasScale;
+    /** The font whose atlas this font shares (nullptr if it is its own) */
+    std::shared_ptr<Font> _atlasSource;
 
     
 public:
@@ -782,6 +798,109 @@ public:
      */
     bool buildAtlasAsync(const std::string charset);
 
+    /**
+     * Creates a signed distance field atlas for the ASCII characters in this font.
+     *
+     * Each glyph in a distance field atlas stores the distance to the glyph
+     * outline rather than its coverage. A {@link SpriteBatch} in distance
+     * field mode turns that distance back into a sharp edge at any scale.
+     * So other sizes of the same font face may share this atlas with
+     * {@link shareAtlas} instead of rasterizing their own.
+     *
+     * Computing the distance fields is much more expensive than rasterizing
+     * the glyphs. If a thread pool is provided, the glyphs are divided among
+     * its threads and the calling thread. The pool may be the one that is
+     * running this method.
+     *
+     * This method does not generate the OpenGL texture, and so it is thread
+     * safe (like {@link buildAtlasAsync}).
+     *
+     * @param threads   The thread pool to compute the distance fields
+     *
+     * @return true if the atlas was successfully created.
+     */
+    bool buildDistanceAtlasAsync(const std::shared_ptr<ThreadPool>& threads=nullptr);
+
+    /**
+     * Creates a signed distance field atlas for the given character set.
+     *
+     * Each glyph in a distance field atlas stores the distance to the glyph
+     * outline rather than its coverage. A {@link SpriteBatch} in distance
+     * field mode turns that distance back into a sharp edge at any scale.
+     * So other sizes of the same font face may share this atlas with
+     * {@link shareAtlas} instead of rasterizing their own.
+     *
+     * Computing the distance fields is much more expensive than rasterizing
+     * the glyphs. If a thread pool is provided, the glyphs are divided among
+     * its threads and the calling thread. The pool may be the one that is
+     * running this method.
+     *
+     * This method does not generate the OpenGL texture, and so it is thread
+     * safe (like {@link buildAtlasAsync}).
+     *
+     * @param charset   The set of characters in the atlas
+     * @param threads   The thread pool to compute the distance fields
+     *
+     * @return true if the atlas was successfully created.
+     */
+    bool buildDistanceAtlasAsync(const std::string charset,
+                                 const std::shared_ptr<ThreadPool>& threads=nullptr);
+
+    /**
+     * Uses the distance field atlas of another font, returning true on success.
+     *
+     * The other font should have the same font file and style as this one,
+     * but it may have any size. The glyphs of the atlas are scaled to the size
+     * of this font, while the metrics and kerning still come from this font.
+     * No glyphs are rasterized, and the OpenGL texture is shared.
+     *
+     * This method fails if the other font does not have a distance field
+     * atlas. It is thread safe, provided that the other font has finished
+     * building its atlas.
+     *
+     * @param font  The font with the distance field atlas
+     *
+     * @return true if the atlas is now shared.
+     */
+    bool shareAtlas(const std::shared_ptr<Font>& font);
+
+    /**
+     * Stores the atlas in the given buffer, returning true on success.
+     *
+     * The buffer contains the glyph set, the glyph metrics and positions, the
+     * kerning, and the atlas image. It can be passed to {@link decodeAtlas}
+     * to restore the atlas without rasterizing any glyphs. The buffer is in
+     * native byte order, and so is not portable between devices.
+     *
+     * This method must be called after {@link buildAtlasAsync} but before
+     * the first call to {@link getAtlas()}, as it needs the atlas image.
+     * Like {@link buildAtlasAsync}, it is thread safe.
+     *
+     * @param data  The buffer to store the atlas
+     *
+     * @return true if the atlas was stored.
+     */
+    bool encodeAtlas(std::vector<Uint8>& data) const;
+
+    /**
+     * Restores an atlas stored by {@link encodeAtlas}, returning true on success.
+     *
+     * This method replaces any existing atlas. It is an alternative to
+     * {@link buildAtlasAsync}, and only valid for a font with the same file,
+     * size, style, hinting, and resolution as the one that stored the atlas.
+     * Like {@link buildAtlasAsync}, it does not create the OpenGL texture,
+     * and so it is thread safe.
+     *
+     * If the data is malformed, this method fails and the font is left with
+     * no atlas.
+     *
+     * @param data  The stored atlas
+     * @param size  The number of bytes in the stored atlas
+     *
+     * @return true if the atlas was restored.
+     */
+    bool decodeAtlas(const Uint8* data, size_t size);
+
     /**
      * Returns the OpenGL texture for the associated atlas.
      *
@@ -802,6 +921,16 @@ public:
      * @return true if this font has an active atlas.
      */
     bool hasAtlas() const { return _hasAtlas; }
+
+    /**
+     * Returns true if the atlas stores signed distance fields.
+     *
+     * A mesh from a distance field atlas must be drawn with a {@link SpriteBatch}
+     * in distance field mode {@see SpriteBatch#setDistanceField}.
+     *
+     * @return true if the atlas stores signed distance fields.
+     */
+    bool isDistanceField() const { return _distance; }
     
 #pragma mark -
 #pragma mark Rendering
@@ -1462,6 +1591,18 @@ protected:
      * @return a blank surface of the given size.
      */
     SDL_Surface* allocSurface(int width, int height);
+
+    /**
+     * Replaces the coverage of each glyph in the atlas with its distance field.
+     *
+     * The glyphs occupy disjoint regions of the surface, so they may be
+     * computed in parallel. If a thread pool is provided, the glyphs are
+     * divided among its threads and the calling thread. This method does
+     * not return until every glyph is done.
+     *
+     * @param threads   The thread pool to compute the distance fields
+     */
+    void generateDistanceFields(const std::shared_ptr<ThreadPool>& threads);
 };
     
 #pragma mark -
@@ -0,0 +1,540 @@
+//
+//  CURecordingBackend.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a render backend that records the graphics commands
+//  issued by the render classes. It can either forward these commands to
+//  OpenGL (to profile a running game) or drop them entirely (to exercise the
+//  render code on a machine with no graphics context). In the latter case it
+//  emulates just enough of the OpenGL state for the render classes to work:
+//  object names, bindings, and successful shader compilation.
+//
+//  The backend gathers statistics per frame. These include the number of
+//  draw calls, the number of indices drawn, buffer and texture uploads, and
+//  the number of state changes (with redundant changes counted separately).
+//  It also measures the CPU time spent between beginFrame and endFrame.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+#ifndef __CU_RECORDING_BACKEND_H__
+#define __CU_RECORDING_BACKEND_H__
+#include <cugl/render/CURenderBackend.h>
+#include <cugl/util/CUTimestamp.h>
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+namespace cugl {
+
+/**
+ * This class is a collection of render statistics.
+ *
+ * These statistics are gathered by a {@link RecordingBackend}, either for
+ * a single frame or accumulated over several frames.
+ */
+class RenderStats {
+public:
+    /** The number of draw calls (instanced or not) */
+    Uint32 drawCalls;
+    /** The number of indices drawn (multiplied by the instance count) */
+    Uint64 indices;
+    /** The number of instances drawn by instanced draw calls */
+    Uint64 instances;
+    /** The number of buffer uploads (both full and partial) */
+    Uint32 bufferUploads;
+    /** The number of bytes uploaded to buffers */
+    Uint64 bufferBytes;
+    /** The number of texture uploads */
+    Uint32 textureUploads;
+    /** The number of bytes uploaded to textures */
+    Uint64 textureBytes;
+    /** The number of uniform updates */
+    Uint32 uniformUpdates;
+    /** The number of state changes that altered the state */
+    Uint32 stateChanges;
+    /** The number of state changes that left the state as it was */
+    Uint32 redundantChanges;
+    /** The number of framebuffer clears */
+    Uint32 clears;
+    /** The CPU time in microseconds */
+    Uint64 micros;
+
+    /**
+     * Creates a collection of statistics with all values zero.
+     */
+    RenderStats() { reset(); }
+
+    /**
+     * Resets all statistics to zero.
+     */
+    void reset();
+
+    /**
+     * Adds the given statistics to this one.
+     *
+     * @param stats The statistics to add
+     *
+     * @return this object, after modification
+     */
+    RenderStats& operator+=(const RenderStats& stats);
+
+    /**
+     * Divides all statistics by the given number of frames.
+     *
+     * This method is used to compute the average of accumulated statistics.
+     * It does nothing if frames is 0.
+     *
+     * @param frames    The number of frames
+     *
+     * @return this object, after modification
+     */
+    RenderStats& operator/=(Uint32 frames);
+
+    /**
+     * Returns a string representation of these statistics.
+     *
+     * The string is a single line, suitable for logging or for comparing
+     * the output of two benchmark runs.
+     *
+     * @return a string representation of these statistics.
+     */
+    std::string toString() const;
+};
+
+/**
+ * This class is a render backend that records graphics commands.
+ *
+ * A recording backend can run in one of two modes. In passthrough mode,
+ * every command is forwarded to OpenGL after it is recorded. This is useful
+ * for profiling a running application. Otherwise, the commands are recorded
+ * and then dropped. In this mode the backend emulates the OpenGL state that
+ * the render classes query: object names, buffer and texture bindings, the
+ * viewport, and shader compilation (which always succeeds). Uniform and
+ * attribute locations are assigned by name, but uniform blocks are never
+ * found. This is enough for a {@link SpriteBatch} to run without any
+ * graphics context at all.
+ *
+ * Statistics are gathered per frame, where a frame is delimited by calls to
+ * {@link #beginFrame} and {@link #endFrame}. Optionally, the backend can also
+ * keep a log of the commands in the current frame. This log is useful for
+ * render regression tests, as two logs can be compared line by line.
+ *
+ * To use this backend, allocate it and pass it to {@link RenderBackend#set}
+ * before allocating any graphics objects.
+ */
+class RecordingBackend : public RenderBackend {
+public:
+    /**
+     * This inner class is a single entry in the command log.
+     */
+    class Command {
+    public:
+        /** The name of the OpenGL function (a static string) */
+        const char* name;
+        /** The most relevant argument of the command (e.g. a size or an object name) */
+        Sint64 value;
+    };
+
+    /** The number of texture units emulated by this backend */
+    static const GLuint MAX_TEXTURE_UNITS = 16;
+    /** The number of uniform buffer bind points emulated by this backend */
+    static const GLuint MAX_BINDPOINTS = 32;
+
+private:
+    /** Whether to forward commands to OpenGL */
+    bool _passthrough;
+    /** Whether to keep a log of the commands */
+    bool _logging;
+    /** The commands recorded in the current frame (if logging) */
+    std::vector<Command> _log;
+
+    /** The statistics for the current frame */
+    RenderStats _current;
+    /** The statistics for the last completed frame */
+    RenderStats _last;
+    /** The statistics accumulated over all completed frames */
+    RenderStats _total;
+    /** The number of completed frames */
+    Uint32 _frames;
+    /** The start of the current frame */
+    Timestamp _start;
+
+    /** The last object name generated (when not forwarding) */
+    GLuint _names;
+    /** The uniform and attribute locations assigned by name */
+    std::unordered_map<std::string,GLint> _locations;
+    /** The enabled capabilities (as a bitmask) */
+    Uint32 _caps;
+    /** The current viewport */
+    GLint _viewport[4];
+    /** The current shader program */
+    GLuint _program;
+    /** The active texture unit */
+    GLuint _unit;
+    /** The texture bound to each texture unit */
+    GLuint _textures[MAX_TEXTURE_UNITS];
+    /** The array, element, and uniform buffer bindings */
+    GLuint _buffers[3];
+    /** The uniform buffer bound to each bind point */
+    GLuint _bindpoints[MAX_BINDPOINTS];
+    /** The current vertex array */
+    GLuint _vertarray;
+    /** The current framebuffer */
+    GLuint _framebuffer;
+    /** The current blend equation */
+    GLenum _blendEquation;
+    /** The current source blend factor */
+    GLenum _srcFactor;
+    /** The current destination blend factor */
+    GLenum _dstFactor;
+    /** The current depth function */
+    GLenum _depthFunc;
+    /** The current depth mask */
+    GLboolean _depthMask;
+
+public:
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized recording backend.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a backend on
+     * the heap, use one of the static constructors instead.
+     */
+    RecordingBackend();
+
+    /**
+     * Deletes this backend, disposing all resources
+     */
+    ~RecordingBackend() { dispose(); }
+
+    /**
+     * Disposes all of the resources used by this backend.
+     *
+     * A disposed backend can be safely reinitialized.
+     */
+    void dispose();
+
+    /**
+     * Initializes a recording backend.
+     *
+     * If passthrough is true, every command is forwarded to OpenGL after it
+     * is recorded. Otherwise, the commands are dropped and the backend can
+     * be used without a graphics context.
+     *
+     * @param passthrough   Whether to forward commands to OpenGL
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(bool passthrough=false);
+
+    /**
+     * Returns a newly allocated recording backend.
+     *
+     * If passthrough is true, every command is forwarded to OpenGL after it
+     * is recorded. Otherwise, the commands are dropped and the backend can
+     * be used without a graphics context.
+     *
+     * @param passthrough   Whether to forward commands to OpenGL
+     *
+     * @return a newly allocated recording backend.
+     */
+    static std::shared_ptr<RecordingBackend> alloc(bool passthrough=false) {
+        std::shared_ptr<RecordingBackend> result = std::make_shared<RecordingBackend>();
+        return (result->init(passthrough) ? result : nullptr);
+    }
+
+    /**
+     * Returns true if this backend forwards its commands to OpenGL.
+     *
+     * @return true if this backend forwards its commands to OpenGL.
+     */
+    virtual bool isHardware() const override { return _passthrough; }
+
+#pragma mark -
+#pragma mark Statistics
+    /**
+     * Starts a new frame.
+     *
+     * This resets the statistics (and log) of the current frame and marks
+     * the start of the CPU time measurement.
+     */
+    void beginFrame();
+
+    /**
+     * Completes the current frame.
+     *
+     * The statistics of the current frame are measured and added to the
+     * accumulated statistics.
+     */
+    void endFrame();
+
+    /**
+     * Returns the number of completed frames.
+     *
+     * @return the number of completed frames.
+     */
+    Uint32 getFrameCount() const { return _frames; }
+
+    /**
+     * Returns the statistics of the frame in progress.
+     *
+     * The CPU time of these statistics is not set until the frame ends.
+     *
+     * @return the statistics of the frame in progress.
+     */
+    const RenderStats& getCurrentStats() const { return _current; }
+
+    /**
+     * Returns the statistics of the last completed frame.
+     *
+     * @return the statistics of the last completed frame.
+     */
+    const RenderStats& getFrameStats() const { return _last; }
+
+    /**
+     * Returns the statistics accumulated over all completed frames.
+     *
+     * @return the statistics accumulated over all completed frames.
+     */
+    const RenderStats& getTotalStats() const { return _total; }
+
+    /**
+     * Returns the average statistics per completed frame.
+     *
+     * @return the average statistics per completed frame.
+     */
+    RenderStats getAverageStats() const;
+
+    /**
+     * Resets all statistics, including the frame count.
+     */
+    void resetStats();
+
+#pragma mark -
+#pragma mark Command Log
+    /**
+     * Returns true if this backend keeps a log of the commands.
+     *
+     * @return true if this backend keeps a log of the commands.
+     */
+    bool isLogging() const { return _logging; }
+
+    /**
+     * Sets whether this backend keeps a log of the commands.
+     *
+     * The log is cleared at the start of every frame. It is off by default,
+     * as it adds some overhead to every command.
+     *
+     * @param value Whether this backend keeps a log of the commands.
+     */
+    void setLogging(bool value);
+
+    /**
+     * Returns the commands recorded in the current frame.
+     *
+     * This log is empty if logging is disabled.
+     *
+     * @return the commands recorded in the current frame.
+     */
+    const std::vector<Command>& getLog() const { return _log; }
+
+    /**
+     * Returns the command log as a string, with one command per line.
+     *
+     * @return the command log as a string, with one command per line.
+     */
+    std::string getTrace() const;
+
+#pragma mark -
+#pragma mark Backend Overrides
+    // Each method below records the command and forwards it to the OpenGL
+    // backend if this is a passthrough backend. See RenderBackend for the
+    // semantics of each method.
+    virtual void genBuffers(GLsizei n, GLuint* buffers) override;
+    virtual void deleteBuffers(GLsizei n, const GLuint* buffers) override;
+    virtual void genVertexArrays(GLsizei n, GLuint* arrays) override;
+    virtual void deleteVertexArrays(GLsizei n, const GLuint* arrays) override;
+    virtual void genTextures(GLsizei n, GLuint* textures) override;
+    virtual void deleteTextures(GLsizei n, const GLuint* textures) override;
+    virtual void genFramebuffers(GLsizei n, GLuint* framebuffers) override;
+    virtual void deleteFramebuffers(GLsizei n, const GLuint* framebuffers) override;
+    virtual void genRenderbuffers(GLsizei n, GLuint* renderbuffers) override;
+    virtual void deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) override;
+    virtual GLenum getError() override;
+    virtual void getIntegerv(GLenum pname, GLint* data) override;
+    virtual void getIntegeri_v(GLenum target, GLuint index, GLint* data) override;
+    virtual void enable(GLenum cap) override;
+    virtual void disable(GLenum cap) override;
+    virtual void blendEquation(GLenum mode) override;
+    virtual void blendFunc(GLenum sfactor, GLenum dfactor) override;
+    virtual void depthFunc(GLenum func) override;
+    virtual void depthMask(GLboolean flag) override;
+    virtual void viewport(GLint x, GLint y, GLsizei width, GLsizei height) override;
+    virtual void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) override;
+    virtual void clear(GLbitfield mask) override;
+    virtual void bindBuffer(GLenum target, GLuint buffer) override;
+    virtual void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) override;
+    virtual void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) override;
+    virtual void* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) override;
+    virtual GLboolean unmapBuffer(GLenum target) override;
+    virtual void bindBufferBase(GLenum target, GLuint index, GLuint buffer) override;
+    virtual void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) override;
+    virtual void bindVertexArray(GLuint array) override;
+    virtual void enableVertexAttribArray(GLuint index) override;
+    virtual void disableVertexAttribArray(GLuint index) override;
+    virtual void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) override;
+    virtual void vertexAttribDivisor(GLuint index, GLuint divisor) override;
+    virtual void drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) override;
+    virtual void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount) override;
+    virtual void activeTexture(GLenum texture) override;
+    virtual void bindTexture(GLenum target, GLuint texture) override;
+    virtual void texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) override;
+    virtual void compressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data) override;
+    virtual void texParameteri(GLenum target, GLenum pname, GLint param) override;
+    virtual void generateMipmap(GLenum target) override;
+    virtual void getTexImage(GLenum target, GLint level, GLenum format, GLenum type, void* pixels) override;
+    virtual void bindFramebuffer(GLenum target, GLuint framebuffer) override;
+    virtual void bindRenderbuffer(GLenum target, GLuint renderbuffer) override;
+    virtual void renderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) override;
+    virtual void framebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) override;
+    virtual void framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) override;
+    virtual void drawBuffers(GLsizei n, const GLenum* bufs) override;
+    virtual GLenum checkFramebufferStatus(GLenum target) override;
+    virtual GLuint createProgram() override;
+    virtual GLuint createShader(GLenum type) override;
+    virtual void shaderSource(GLuint shader, GLsizei count, const GLchar* const* sources, const GLint* length) override;
+    virtual void compileShader(GLuint shader) override;
+    virtual void attachShader(GLuint program, GLuint shader) override;
+    virtual void linkProgram(GLuint program) override;
+    virtual void deleteShader(GLuint shader) override;
+    virtual void useProgram(GLuint program) override;
+    virtual GLboolean isShader(GLuint shader) override;
+    virtual GLboolean isProgram(GLuint program) override;
+    virtual void getShaderiv(GLuint shader, GLenum pname, GLint* params) override;
+    virtual void getProgramiv(GLuint program, GLenum pname, GLint* params) override;
+    virtual void getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) override;
+    virtual void getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) override;
+    virtual void getActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name) override;
+    virtual void getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name) override;
+    virtual void getActiveUniformBlockName(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name) override;
+    virtual void getActiveUniformBlockiv(GLuint program, GLuint index, GLenum pname, GLint* params) override;
+    virtual GLint getAttribLocation(GLuint program, const GLchar* name) override;
+    virtual GLint getUniformLocation(GLuint program, const GLchar* name) override;
+    virtual GLint getFragDataLocation(GLuint program, const GLchar* name) override;
+    virtual GLuint getUniformBlockIndex(GLuint program, const GLchar* name) override;
+    virtual void uniformBlockBinding(GLuint program, GLuint index, GLuint binding) override;
+    virtual void uniformfv(GLint location, GLint components, GLsizei count, const GLfloat* value) override;
+    virtual void uniformiv(GLint location, GLint components, GLsizei count, const GLint* value) override;
+    virtual void uniformuiv(GLint location, GLint components, GLsizei count, const GLuint* value) override;
+    virtual void uniformMatrixfv(GLint location, GLint columns, GLint rows, GLsizei count,
+                                 GLboolean transpose, const GLfloat* value) override;
+    virtual void getUniformfv(GLuint program, GLint location, GLfloat* params) override;
+    virtual void getUniformiv(GLuint program, GLint location, GLint* params) override;
+    virtual void getUniformuiv(GLuint program, GLint location, GLuint* params) override;
+
+private:
+#pragma mark -
+#pragma mark Internal Helpers
+    /**
+     * Records a command in the log (if logging).
+     *
+     * @param name  The name of the OpenGL function
+     * @param value The most relevant argument of the command
+     */
+    void record(const char* name, Sint64 value) {
+        if (_logging) {
+            _log.push_back({name, value});
+        }
+    }
+
+    /**
+     * Records a state change command.
+     *
+     * @param changed   Whether the command altered the state
+     * @param name      The name of the OpenGL function
+     * @param value     The most relevant argument of the command
+     */
+    void change(bool changed, const char* name, Sint64 value) {
+        if (changed) {
+            _current.stateChanges++;
+        } else {
+            _current.redundantChanges++;
+        }
+        record(name, value);
+    }
+
+    /**
+     * Returns true if the given capability is enabled.
+     *
+     * Capabilities not tracked by this backend are always reported as
+     * disabled, so that every change to them counts as a state change.
+     *
+     * @param cap   The capability to query
+     *
+     * @return true if the given capability is enabled.
+     */
+    bool capability(GLenum cap) const;
+
+    /**
+     * Sets whether the given capability is enabled.
+     *
+     * @param cap   The capability to modify
+     * @param value Whether the capability is enabled
+     */
+    void setCapability(GLenum cap, bool value);
+
+    /**
+     * Returns the binding slot for the given buffer target.
+     *
+     * This method returns nullptr if the target is not tracked.
+     *
+     * @param target    The buffer target
+     *
+     * @return the binding slot for the given buffer target.
+     */
+    GLuint* bufferSlot(GLenum target);
+
+    /**
+     * Returns the emulated location of the given uniform or attribute.
+     *
+     * Locations are assigned by name, in the order they are first queried.
+     *
+     * @param name  The uniform or attribute name
+     *
+     * @return the emulated location of the given uniform or attribute.
+     */
+    GLint location(const GLchar* name);
+};
+
+}
+
+#endif /* __CU_RECORDING_BACKEND_H__ */
@@ -0,0 +1,859 @@
+//
+//  CURenderBackend.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an indirection layer between the render classes and
+//  OpenGL. Every OpenGL call made by SpriteBatch, VertexBuffer, UniformBuffer,
+//  Shader, Texture, and RenderTarget goes through the active backend. The
+//  default backend simply forwards each call to OpenGL. However, the backend
+//  can be swapped out for one that records (or ignores) these calls. This
+//  allows the render code to be exercised and measured on a machine with no
+//  graphics context.
+//
+//  The methods of this class mirror the OpenGL functions of the same name
+//  (minus the gl prefix), so that they have the same semantics. The uniform
+//  setters are the exception. They are funneled through four generic methods
+//  so that a backend does not need to override each variant separately.
+//
+//  This class is a singleton in spirit, but it is not managed by the
+//  shared-pointer architecture. The active backend is accessed with the
+//  static method get(), which is cheap enough to call for every command.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+#ifndef __CU_RENDER_BACKEND_H__
+#define __CU_RENDER_BACKEND_H__
+#include <cugl/base/CUBase.h>
+#include <memory>
+
+namespace cugl {
+
+/**
+ * This class is the interface between the render classes and OpenGL.
+ *
+ * The base class forwards every method to the OpenGL function of the same
+ * name. Subclasses may override any of these methods to record, filter, or
+ * replace the commands. See {@link RecordingBackend} for an example.
+ *
+ * The active backend is global, and should only be changed when there are
+ * no live graphics objects (e.g. before the sprite batch is allocated). An
+ * object created under one backend must not be used or disposed under
+ * another one, as the object names are not shared between backends.
+ *
+ * Like OpenGL itself, a backend is not thread safe, and should only be
+ * used on the rendering thread.
+ */
+class RenderBackend {
+private:
+    /** The active backend (never nullptr) */
+    static RenderBackend* _active;
+    /** The owner of the active backend (nullptr for the OpenGL backend) */
+    static std::shared_ptr<RenderBackend> _owner;
+
+public:
+#pragma mark Backend Management
+    /**
+     * Creates a backend that forwards all commands to OpenGL.
+     */
+    RenderBackend() {}
+
+    /**
+     * Deletes this backend, releasing all resources
+     */
+    virtual ~RenderBackend() {}
+
+    /**
+     * Returns the active render backend.
+     *
+     * This method never returns nullptr. If no backend has been set, it
+     * returns the default backend, which forwards to OpenGL.
+     *
+     * @return the active render backend.
+     */
+    static RenderBackend* get() { return _active; }
+
+    /**
+     * Sets the active render backend.
+     *
+     * If backend is nullptr, this restores the default OpenGL backend. This
+     * method should only be called when there are no live graphics objects,
+     * as the object names are not shared between backends.
+     *
+     * @param backend   The new render backend
+     */
+    static void set(const std::shared_ptr<RenderBackend>& backend);
+
+    /**
+     * Returns true if this backend forwards its commands to OpenGL.
+     *
+     * Code that needs a graphics context for something other than rendering
+     * (such as reading back the contents of a texture) can use this to fail
+     * gracefully.
+     *
+     * @return true if this backend forwards its commands to OpenGL.
+     */
+    virtual bool isHardware() const { return true; }
+
+
+#pragma mark -
+#pragma mark Object Management
+    /**
+     * Generates buffer object names.
+     *
+     * This method mirrors {@code glGenBuffers}.
+     */
+    virtual void genBuffers(GLsizei n, GLuint* buffers);
+
+    /**
+     * Deletes the named buffer objects.
+     *
+     * This method mirrors {@code glDeleteBuffers}.
+     */
+    virtual void deleteBuffers(GLsizei n, const GLuint* buffers);
+
+    /**
+     * Generates vertex array object names.
+     *
+     * This method mirrors {@code glGenVertexArrays}.
+     */
+    virtual void genVertexArrays(GLsizei n, GLuint* arrays);
+
+    /**
+     * Deletes the named vertex array objects.
+     *
+     * This method mirrors {@code glDeleteVertexArrays}.
+     */
+    virtual void deleteVertexArrays(GLsizei n, const GLuint* arrays);
+
+    /**
+     * Generates texture names.
+     *
+     * This method mirrors {@code glGenTextures}.
+     */
+    virtual void genTextures(GLsizei n, GLuint* textures);
+
+    /**
+     * Deletes the named textures.
+     *
+     * This method mirrors {@code glDeleteTextures}.
+     */
+    virtual void deleteTextures(GLsizei n, const GLuint* textures);
+
+    /**
+     * Generates framebuffer object names.
+     *
+     * This method mirrors {@code glGenFramebuffers}.
+     */
+    virtual void genFramebuffers(GLsizei n, GLuint* framebuffers);
+
+    /**
+     * Deletes the named framebuffer objects.
+     *
+     * This method mirrors {@code glDeleteFramebuffers}.
+     */
+    virtual void deleteFramebuffers(GLsizei n, const GLuint* framebuffers);
+
+    /**
+     * Generates renderbuffer object names.
+     *
+     * This method mirrors {@code glGenRenderbuffers}.
+     */
+    virtual void genRenderbuffers(GLsizei n, GLuint* renderbuffers);
+
+    /**
+     * Deletes the named renderbuffer objects.
+     *
+     * This method mirrors {@code glDeleteRenderbuffers}.
+     */
+    virtual void deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers);
+
+
+#pragma mark -
+#pragma mark State Queries
+    /**
+     * Returns (and clears) the current error flag.
+     *
+     * This method mirrors {@code glGetError}.
+     */
+    virtual GLenum getError();
+
+    /**
+     * Returns the value of the given integer parameter.
+     *
+     * This method mirrors {@code glGetIntegerv}.
+     */
+    virtual void getIntegerv(GLenum pname, GLint* data);
+
+    /**
+     * Returns the value of the given indexed integer parameter.
+     *
+     * This method mirrors {@code glGetIntegeri_v}.
+     */
+    virtual void getIntegeri_v(GLenum target, GLuint index, GLint* data);
+
+
+#pragma mark -
+#pragma mark Render State
+    /**
+     * Enables the given server-side capability.
+     *
+     * This method mirrors {@code glEnable}.
+     */
+    virtual void enable(GLenum cap);
+
+    /**
+     * Disables the given server-side capability.
+     *
+     * This method mirrors {@code glDisable}.
+     */
+    virtual void disable(GLenum cap);
+
+    /**
+     * Sets the blending equation.
+     *
+     * This method mirrors {@code glBlendEquation}.
+     */
+    virtual void blendEquation(GLenum mode);
+
+    /**
+     * Sets the blending function.
+     *
+     * This method mirrors {@code glBlendFunc}.
+     */
+    virtual void blendFunc(GLenum sfactor, GLenum dfactor);
+
+    /**
+     * Sets the depth comparison function.
+     *
+     * This method mirrors {@code glDepthFunc}.
+     */
+    virtual void depthFunc(GLenum func);
+
+    /**
+     * Enables or disables writing to the depth buffer.
+     *
+     * This method mirrors {@code glDepthMask}.
+     */
+    virtual void depthMask(GLboolean flag);
+
+    /**
+     * Sets the viewport.
+     *
+     * This method mirrors {@code glViewport}.
+     */
+    virtual void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    /**
+     * Sets the clear color.
+     *
+     * This method mirrors {@code glClearColor}.
+     */
+    virtual void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+
+    /**
+     * Clears the given buffers of the current framebuffer.
+     *
+     * This method mirrors {@code glClear}.
+     */
+    virtual void clear(GLbitfield mask);
+
+
+#pragma mark -
+#pragma mark Buffers
+    /**
+     * Binds a buffer object to the given target.
+     *
+     * This method mirrors {@code glBindBuffer}.
+     */
+    virtual void bindBuffer(GLenum target, GLuint buffer);
+
+    /**
+     * Creates and initializes the data store of the bound buffer.
+     *
+     * This method mirrors {@code glBufferData}.
+     */
+    virtual void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+
+    /**
+     * Updates a subset of the data store of the bound buffer.
+     *
+     * This method mirrors {@code glBufferSubData}.
+     */
+    virtual void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+
+    /**
+     * Maps a range of the bound buffer into client memory.
+     *
+     * The pointer may be written from any thread, but the buffer must be
+     * unmapped (on the rendering thread) before OpenGL uses it. A backend
+     * without a graphics context may return nullptr.
+     *
+     * This method mirrors {@code glMapBufferRange}.
+     */
+    virtual void* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+
+    /**
+     * Releases the mapping of the bound buffer.
+     *
+     * This method mirrors {@code glUnmapBuffer}.
+     */
+    virtual GLboolean unmapBuffer(GLenum target);
+
+    /**
+     * Binds a buffer object to an indexed target.
+     *
+     * This method mirrors {@code glBindBufferBase}.
+     */
+    virtual void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+    /**
+     * Binds a range of a buffer object to an indexed target.
+     *
+     * This method mirrors {@code glBindBufferRange}.
+     */
+    virtual void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    /**
+     * Binds a vertex array object.
+     *
+     * This method mirrors {@code glBindVertexArray}.
+     */
+    virtual void bindVertexArray(GLuint array);
+
+    /**
+     * Enables the given vertex attribute array.
+     *
+     * This method mirrors {@code glEnableVertexAttribArray}.
+     */
+    virtual void enableVertexAttribArray(GLuint index);
+
+    /**
+     * Disables the given vertex attribute array.
+     *
+     * This method mirrors {@code glDisableVertexAttribArray}.
+     */
+    virtual void disableVertexAttribArray(GLuint index);
+
+    /**
+     * Defines the layout of the given vertex attribute.
+     *
+     * This method mirrors {@code glVertexAttribPointer}.
+     */
+    virtual void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+
+    /**
+     * Sets the instance divisor of the given vertex attribute.
+     *
+     * This method mirrors {@code glVertexAttribDivisor}.
+     */
+    virtual void vertexAttribDivisor(GLuint index, GLuint divisor);
+
+
+#pragma mark -
+#pragma mark Drawing
+    /**
+     * Draws primitives from the bound index buffer.
+     *
+     * This method mirrors {@code glDrawElements}.
+     */
+    virtual void drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+
+    /**
+     * Draws multiple instances of primitives from the bound index buffer.
+     *
+     * This method mirrors {@code glDrawElementsInstanced}.
+     */
+    virtual void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount);
+
+
+#pragma mark -
+#pragma mark Textures
+    /**
+     * Selects the active texture unit.
+     *
+     * This method mirrors {@code glActiveTexture}.
+     */
+    virtual void activeTexture(GLenum texture);
+
+    /**
+     * Binds a texture to the active texture unit.
+     *
+     * This method mirrors {@code glBindTexture}.
+     */
+    virtual void bindTexture(GLenum target, GLuint texture);
+
+    /**
+     * Specifies the image of the bound texture.
+     *
+     * This method mirrors {@code glTexImage2D}.
+     */
+    virtual void texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels);
+
+    /**
+     * Specifies a compressed image of the bound texture.
+     *
+     * This method mirrors {@code glCompressedTexImage2D}.
+     */
+    virtual void compressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data);
+
+    /**
+     * Sets a parameter of the bound texture.
+     *
+     * This method mirrors {@code glTexParameteri}.
+     */
+    virtual void texParameteri(GLenum target, GLenum pname, GLint param);
+
+    /**
+     * Generates the mipmaps of the bound texture.
+     *
+     * This method mirrors {@code glGenerateMipmap}.
+     */
+    virtual void generateMipmap(GLenum target);
+
+    /**
+     * Reads back the image of the bound texture (not available in OpenGLES).
+     *
+     * This method mirrors {@code glGetTexImage}.
+     */
+    virtual void getTexImage(GLenum target, GLint level, GLenum format, GLenum type, void* pixels);
+
+
+#pragma mark -
+#pragma mark Framebuffers
+    /**
+     * Binds a framebuffer object.
+     *
+     * This method mirrors {@code glBindFramebuffer}.
+     */
+    virtual void bindFramebuffer(GLenum target, GLuint framebuffer);
+
+    /**
+     * Binds a renderbuffer object.
+     *
+     * This method mirrors {@code glBindRenderbuffer}.
+     */
+    virtual void bindRenderbuffer(GLenum target, GLuint renderbuffer);
+
+    /**
+     * Allocates the storage of the bound renderbuffer.
+     *
+     * This method mirrors {@code glRenderbufferStorage}.
+     */
+    virtual void renderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
+
+    /**
+     * Attaches a texture to the bound framebuffer.
+     *
+     * This method mirrors {@code glFramebufferTexture2D}.
+     */
+    virtual void framebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+
+    /**
+     * Attaches a renderbuffer to the bound framebuffer.
+     *
+     * This method mirrors {@code glFramebufferRenderbuffer}.
+     */
+    virtual void framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+
+    /**
+     * Sets the draw buffers of the bound framebuffer.
+     *
+     * This method mirrors {@code glDrawBuffers}.
+     */
+    virtual void drawBuffers(GLsizei n, const GLenum* bufs);
+
+    /**
+     * Returns the completeness status of the bound framebuffer.
+     *
+     * This method mirrors {@code glCheckFramebufferStatus}.
+     */
+    virtual GLenum checkFramebufferStatus(GLenum target);
+
+
+#pragma mark -
+#pragma mark Shader Programs
+    /**
+     * Creates an empty program object.
+     *
+     * This method mirrors {@code glCreateProgram}.
+     */
+    virtual GLuint createProgram();
+
+    /**
+     * Creates an empty shader object.
+     *
+     * This method mirrors {@code glCreateShader}.
+     */
+    virtual GLuint createShader(GLenum type);
+
+    /**
+     * Sets the source code of the given shader.
+     *
+     * This method mirrors {@code glShaderSource}.
+     */
+    virtual void shaderSource(GLuint shader, GLsizei count, const GLchar* const* sources, const GLint* length);
+
+    /**
+     * Compiles the given shader.
+     *
+     * This method mirrors {@code glCompileShader}.
+     */
+    virtual void compileShader(GLuint shader);
+
+    /**
+     * Attaches a shader to the given program.
+     *
+     * This method mirrors {@code glAttachShader}.
+     */
+    virtual void attachShader(GLuint program, GLuint shader);
+
+    /**
+     * Links the given program.
+     *
+     * This method mirrors {@code glLinkProgram}.
+     */
+    virtual void linkProgram(GLuint program);
+
+    /**
+     * Deletes the given shader object.
+     *
+     * This method mirrors {@code glDeleteShader}.
+     */
+    virtual void deleteShader(GLuint shader);
+
+    /**
+     * Installs the given program as part of the current render state.
+     *
+     * This method mirrors {@code glUseProgram}.
+     */
+    virtual void useProgram(GLuint program);
+
+    /**
+     * Returns true if the name is a shader object.
+     *
+     * This method mirrors {@code glIsShader}.
+     */
+    virtual GLboolean isShader(GLuint shader);
+
+    /**
+     * Returns true if the name is a program object.
+     *
+     * This method mirrors {@code glIsProgram}.
+     */
+    virtual GLboolean isProgram(GLuint program);
+
+    /**
+     * Returns a parameter of the given shader.
+     *
+     * This method mirrors {@code glGetShaderiv}.
+     */
+    virtual void getShaderiv(GLuint shader, GLenum pname, GLint* params);
+
+    /**
+     * Returns a parameter of the given program.
+     *
+     * This method mirrors {@code glGetProgramiv}.
+     */
+    virtual void getProgramiv(GLuint program, GLenum pname, GLint* params);
+
+    /**
+     * Returns the information log of the given shader.
+     *
+     * This method mirrors {@code glGetShaderInfoLog}.
+     */
+    virtual void getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+
+    /**
+     * Returns the information log of the given program.
+     *
+     * This method mirrors {@code glGetProgramInfoLog}.
+     */
+    virtual void getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+
+    /**
+     * Returns information about an active attribute.
+     *
+     * This method mirrors {@code glGetActiveAttrib}.
+     */
+    virtual void getActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name);
+
+    /**
+     * Returns information about an active uniform.
+     *
+     * This method mirrors {@code glGetActiveUniform}.
+     */
+    virtual void getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name);
+
+    /**
+     * Returns the name of an active uniform block.
+     *
+     * This method mirrors {@code glGetActiveUniformBlockName}.
+     */
+    virtual void getActiveUniformBlockName(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name);
+
+    /**
+     * Returns a parameter of an active uniform block.
+     *
+     * This method mirrors {@code glGetActiveUniformBlockiv}.
+     */
+    virtual void getActiveUniformBlockiv(GLuint program, GLuint index, GLenum pname, GLint* params);
+
+    /**
+     * Returns the location of the given attribute.
+     *
+     * This method mirrors {@code glGetAttribLocation}.
+     */
+    virtual GLint getAttribLocation(GLuint program, const GLchar* name);
+
+    /**
+     * Returns the location of the given uniform.
+     *
+     * This method mirrors {@code glGetUniformLocation}.
+     */
+    virtual GLint getUniformLocation(GLuint program, const GLchar* name);
+
+    /**
+     * Returns the location of the given fragment output.
+     *
+     * This method mirrors {@code glGetFragDataLocation}.
+     */
+    virtual GLint getFragDataLocation(GLuint program, const GLchar* name);
+
+    /**
+     * Returns the index of the given uniform block.
+     *
+     * This method mirrors {@code glGetUniformBlockIndex}.
+     */
+    virtual GLuint getUniformBlockIndex(GLuint program, const GLchar* name);
+
+    /**
+     * Assigns a bind point to a uniform block.
+     *
+     * This method mirrors {@code glUniformBlockBinding}.
+     */
+    virtual void uniformBlockBinding(GLuint program, GLuint index, GLuint binding);
+
+
+#pragma mark -
+#pragma mark Uniforms
+    /**
+     * Sets the value of a float uniform (or uniform array).
+     *
+     * The value of components is the vector size, from 1 to 4. This method
+     * stands in for {@code glUniform1fv} through {@code glUniform4fv}. All of
+     * the float uniform setters below are funneled through this method.
+     *
+     * @param location      The uniform location
+     * @param components    The number of components (1 to 4)
+     * @param count         The number of array elements
+     * @param value         The uniform value
+     */
+    virtual void uniformfv(GLint location, GLint components, GLsizei count, const GLfloat* value);
+
+    /**
+     * Sets the value of an int uniform (or uniform array).
+     *
+     * The value of components is the vector size, from 1 to 4. This method
+     * stands in for {@code glUniform1iv} through {@code glUniform4iv}. All of
+     * the int uniform setters below are funneled through this method.
+     *
+     * @param location      The uniform location
+     * @param components    The number of components (1 to 4)
+     * @param count         The number of array elements
+     * @param value         The uniform value
+     */
+    virtual void uniformiv(GLint location, GLint components, GLsizei count, const GLint* value);
+
+    /**
+     * Sets the value of an unsigned int uniform (or uniform array).
+     *
+     * The value of components is the vector size, from 1 to 4. This method
+     * stands in for {@code glUniform1uiv} through {@code glUniform4uiv}. All
+     * of the unsigned uniform setters below are funneled through this method.
+     *
+     * @param location      The uniform location
+     * @param components    The number of components (1 to 4)
+     * @param count         The number of array elements
+     * @param value         The uniform value
+     */
+    virtual void uniformuiv(GLint location, GLint components, GLsizei count, const GLuint* value);
+
+    /**
+     * Sets the value of a matrix uniform (or uniform array).
+     *
+     * The matrix dimensions are given as columns by rows, following the
+     * OpenGL naming scheme (so {@code glUniformMatrix2x3fv} has 2 columns and
+     * 3 rows). This method stands in for all of the matrix uniform setters.
+     *
+     * @param location      The uniform location
+     * @param columns       The number of matrix columns (2 to 4)
+     * @param rows          The number of matrix rows (2 to 4)
+     * @param count         The number of array elements
+     * @param transpose     Whether to transpose the matrix
+     * @param value         The uniform value
+     */
+    virtual void uniformMatrixfv(GLint location, GLint columns, GLint rows, GLsizei count,
+                                 GLboolean transpose, const GLfloat* value);
+
+    /**
+     * Returns the value of a float uniform.
+     *
+     * This method mirrors {@code glGetUniformfv}.
+     */
+    virtual void getUniformfv(GLuint program, GLint location, GLfloat* params);
+
+    /**
+     * Returns the value of an int uniform.
+     *
+     * This method mirrors {@code glGetUniformiv}.
+     */
+    virtual void getUniformiv(GLuint program, GLint location, GLint* params);
+
+    /**
+     * Returns the value of an unsigned int uniform.
+     *
+     * This method mirrors {@code glGetUniformuiv}.
+     */
+    virtual void getUniformuiv(GLuint program, GLint location, GLuint* params);
+
+#pragma mark -
+#pragma mark Uniform Conveniences
+    // These methods mirror the OpenGL uniform setters of the same name.
+    // They are not virtual; a backend should override the generic methods.
+    void uniform1f(GLint location, GLfloat v0) {
+        GLfloat value[1] = { v0 };
+        uniformfv(location, 1, 1, value);
+    }
+    void uniform2f(GLint location, GLfloat v0, GLfloat v1) {
+        GLfloat value[2] = { v0, v1 };
+        uniformfv(location, 2, 1, value);
+    }
+    void uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) {
+        GLfloat value[3] = { v0, v1, v2 };
+        uniformfv(location, 3, 1, value);
+    }
+    void uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {
+        GLfloat value[4] = { v0, v1, v2, v3 };
+        uniformfv(location, 4, 1, value);
+    }
+    void uniform1fv(GLint location, GLsizei count, const GLfloat* value) {
+        uniformfv(location, 1, count, value);
+    }
+    void uniform2fv(GLint location, GLsizei count, const GLfloat* value) {
+        uniformfv(location, 2, count, value);
+    }
+    void uniform3fv(GLint location, GLsizei count, const GLfloat* value) {
+        uniformfv(location, 3, count, value);
+    }
+    void uniform4fv(GLint location, GLsizei count, const GLfloat* value) {
+        uniformfv(location, 4, count, value);
+    }
+    void uniform1i(GLint location, GLint v0) {
+        GLint value[1] = { v0 };
+        uniformiv(location, 1, 1, value);
+    }
+    void uniform2i(GLint location, GLint v0, GLint v1) {
+        GLint value[2] = { v0, v1 };
+        uniformiv(location, 2, 1, value);
+    }
+    void uniform3i(GLint location, GLint v0, GLint v1, GLint v2) {
+        GLint value[3] = { v0, v1, v2 };
+        uniformiv(location, 3, 1, value);
+    }
+    void uniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3) {
+        GLint value[4] = { v0, v1, v2, v3 };
+        uniformiv(location, 4, 1, value);
+    }
+    void uniform1iv(GLint location, GLsizei count, const GLint* value) {
+        uniformiv(location, 1, count, value);
+    }
+    void uniform2iv(GLint location, GLsizei count, const GLint* value) {
+        uniformiv(location, 2, count, value);
+    }
+    void uniform3iv(GLint location, GLsizei count, const GLint* value) {
+        uniformiv(location, 3, count, value);
+    }
+    void uniform4iv(GLint location, GLsizei count, const GLint* value) {
+        uniformiv(location, 4, count, value);
+    }
+    void uniform1ui(GLint location, GLuint v0) {
+        GLuint value[1] = { v0 };
+        uniformuiv(location, 1, 1, value);
+    }
+    void uniform2ui(GLint location, GLuint v0, GLuint v1) {
+        GLuint value[2] = { v0, v1 };
+        uniformuiv(location, 2, 1, value);
+    }
+    void uniform3ui(GLint location, GLuint v0, GLuint v1, GLuint v2) {
+        GLuint value[3] = { v0, v1, v2 };
+        uniformuiv(location, 3, 1, value);
+    }
+    void uniform4ui(GLint location, GLuint v0, GLuint v1, GLuint v2, GLuint v3) {
+        GLuint value[4] = { v0, v1, v2, v3 };
+        uniformuiv(location, 4, 1, value);
+    }
+    void uniform1uiv(GLint location, GLsizei count, const GLuint* value) {
+        uniformuiv(location, 1, count, value);
+    }
+    void uniform2uiv(GLint location, GLsizei count, const GLuint* value) {
+        uniformuiv(location, 2, count, value);
+    }
+    void uniform3uiv(GLint location, GLsizei count, const GLuint* value) {
+        uniformuiv(location, 3, count, value);
+    }
+    void uniform4uiv(GLint location, GLsizei count, const GLuint* value) {
+        uniformuiv(location, 4, count, value);
+    }
+    void uniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+        uniformMatrixfv(location, 2, 2, count, transpose, value);
+    }
+    void uniformMatrix2x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+        uniformMatrixfv(location, 2, 3, count, transpose, value);
+    }
+    void uniformMatrix2x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+        uniformMatrixfv(location, 2, 4, count, transpose, value);
+    }
+    void uniformMatrix3x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+        uniformMatrixfv(location, 3, 2, count, transpose, value);
+    }
+    void uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+        uniformMatrixfv(location, 3, 3, count, transpose, value);
+    }
+    void uniformMatrix3x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+        uniformMatrixfv(location, 3, 4, count, transpose, value);
+    }
+    void uniformMatrix4x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+        uniformMatrixfv(location, 4, 2, count, transpose, value);
+    }
+    void uniformMatrix4x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+        uniformMatrixfv(location, 4, 3, count, transpose, value);
+    }
+    void uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+        uniformMatrixfv(location, 4, 4, count, transpose, value);
+    }
+
+    /** This macro disables the copy constructor (not allowed on backends) */
+    CU_DISALLOW_COPY_AND_ASSIGN(RenderBackend);
+};
+
+}
+
+#endif /* __CU_RENDER_BACKEND_H__ */
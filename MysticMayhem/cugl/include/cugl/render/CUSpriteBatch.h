@@ -181,6 +181,12 @@ private:
     std::shared_ptr<VertexBuffer>  _vertbuff;
     /** The vertex buffer for this sprite batch */
     std::shared_ptr<UniformBuffer> _unifbuff;
+    /** The shader for instanced sprites (allocated on demand) */
+    std::shared_ptr<Shader> _instShader;
+    /** The vertex buffer for instanced sprites (allocated on demand) */
+    std::shared_ptr<VertexBuffer>  _instbuff;
+    /** Whether instancing failed to initialize (so we must fall back) */
+    bool _instFailed;
     
     /** The sprite batch vertex mesh */
     SpriteVertex3* _vertData;
@@ -212,6 +218,8 @@ private:
     std::shared_ptr<Gradient> _gradient;
     /** The active scissor mask */
     std::shared_ptr<Scissor>  _scissor;
+    /** The storage for the active scissor mask (reused to prevent allocation) */
+    std::shared_ptr<Scissor>  _scissorCache;
 
     // Monitoring values
     /** The number of vertices drawn in this pass (so far) */
@@ -648,6 +656,31 @@ public:
      */
     std::shared_ptr<Scissor> getScissor() const;
     
+    /**
+     * Sets the active scissor mask of this sprite batch
+     *
+     * This method is identical to {@link #setScissor(const std::shared_ptr<Scissor>&)}
+     * except that it takes a scissor by reference. The scissor is copied
+     * into storage owned by the sprite batch, so this method does not
+     * allocate any memory once a scissor mask has been used.
+     *
+     * @param scissor   The active scissor mask for this sprite batch
+     */
+    void setScissor(const Scissor& scissor);
+    
+    /**
+     * Copies the active scissor mask of this sprite batch into dst
+     *
+     * This method is an allocation-free alternative to {@link #getScissor()}.
+     * If there is no active scissor mask, dst is unchanged and this method
+     * returns false.
+     *
+     * @param dst   The scissor mask to store the result
+     *
+     * @return true if there is an active scissor mask
+     */
+    bool getScissor(Scissor* dst) const;
+    
     /**
      * Sets the blending function for this sprite batch
      *
@@ -804,6 +837,36 @@ public:
      * @return the blur step in pixels (0 if there is no blurring).
      */
     GLuint getBlurStep() const { return _context->blurstep; }
+
+    /**
+     * Sets whether textures are drawn as signed distance fields.
+     *
+     * In this mode, the alpha channel of the texture is the distance to an
+     * edge, with the edge itself at 0.5. The sprite batch draws a sharp,
+     * antialiased edge at any scale. This is the mode for the distance field
+     * font atlases {@see Font#buildDistanceAtlasAsync}. It has no effect on
+     * drawing without a texture.
+     *
+     * This value is false by default.
+     *
+     * @param value Whether textures are drawn as signed distance fields
+     */
+    void setDistanceField(bool value);
+
+    /**
+     * Returns true if textures are drawn as signed distance fields.
+     *
+     * In this mode, the alpha channel of the texture is the distance to an
+     * edge, with the edge itself at 0.5. The sprite batch draws a sharp,
+     * antialiased edge at any scale. This is the mode for the distance field
+     * font atlases {@see Font#buildDistanceAtlasAsync}. It has no effect on
+     * drawing without a texture.
+     *
+     * This value is false by default.
+     *
+     * @return true if textures are drawn as signed distance fields.
+     */
+    bool isDistanceField() const;
     
 
 #pragma mark -
@@ -1107,6 +1170,70 @@ public:
     void fill(const Mesh<SpriteVertex3>& mesh, const Mat4& transform, bool tint = true);
 
 
+#pragma mark -
+#pragma mark Instanced Sprites
+    /**
+     * Fills many copies of the given rectangle with the current texture.
+     *
+     * Each copy is described by a {@link SpriteInstance}, which is applied
+     * to the rectangle in local space (scaled, then rotated, then offset)
+     * before the transform is applied. The instance frame selects the region
+     * of the texture for that copy, and the instance color is multiplied by
+     * the current active color. The texture is applied to the rectangle in
+     * the same way as {@link #fill(Rect)}.
+     *
+     * Unlike the other fill methods, the copies are not added to the vertex
+     * buffer. Instead, this method flushes the sprite batch and draws all
+     * copies with a single instanced draw call, uploading only one quad and
+     * 40 bytes per instance. This is significantly faster for large numbers
+     * of identical sprites, like pickups or tiles. Because of the flush, it
+     * should be used for groups of sprites, not single sprites.
+     *
+     * The current blend state, depth and scissor mask are respected. Gradients
+     * and blur are not supported, and are ignored. If instancing is not
+     * supported by the platform, this method falls back to filling each copy
+     * separately.
+     *
+     * @param bounds    The rectangle to copy (in local space)
+     * @param instances The per-instance data
+     * @param count     The number of instances
+     * @param transform The coordinate transform
+     */
+    void fillInstances(const Rect bounds, const SpriteInstance* instances, size_t count,
+                       const Mat4& transform);
+    
+    /**
+     * Fills many copies of the given rectangle with the current texture.
+     *
+     * Each copy is described by a {@link SpriteInstance}, which is applied
+     * to the rectangle in local space (scaled, then rotated, then offset)
+     * before the transform is applied. The instance frame selects the region
+     * of the texture for that copy, and the instance color is multiplied by
+     * the current active color. The texture is applied to the rectangle in
+     * the same way as {@link #fill(Rect)}.
+     *
+     * Unlike the other fill methods, the copies are not added to the vertex
+     * buffer. Instead, this method flushes the sprite batch and draws all
+     * copies with a single instanced draw call, uploading only one quad and
+     * 40 bytes per instance. This is significantly faster for large numbers
+     * of identical sprites, like pickups or tiles. Because of the flush, it
+     * should be used for groups of sprites, not single sprites.
+     *
+     * The current blend state, depth and scissor mask are respected. Gradients
+     * and blur are not supported, and are ignored. If instancing is not
+     * supported by the platform, this method falls back to filling each copy
+     * separately.
+     *
+     * @param bounds    The rectangle to copy (in local space)
+     * @param instances The per-instance data
+     * @param transform The coordinate transform
+     */
+    void fillInstances(const Rect bounds, const std::vector<SpriteInstance>& instances,
+                       const Mat4& transform) {
+        fillInstances(bounds, instances.data(), instances.size(), transform);
+    }
+
+
 #pragma mark -
 #pragma mark Outlines
     /**
@@ -1923,6 +2050,17 @@ private:
      * @param step      The blur step in pixels
      */
     void blurTexture(const std::shared_ptr<Texture>& texture, GLuint step);
+    
+    /**
+     * Allocates the shader and vertex buffer for instanced sprites.
+     *
+     * These are only allocated the first time that they are needed. If the
+     * shader fails to compile, this method records the failure so that later
+     * calls to {@link #fillInstances} fall back to normal quads.
+     *
+     * @return true if instancing is available.
+     */
+    bool initInstancing();
 
     /**
      * Returns the number of vertices added to the drawing buffer.
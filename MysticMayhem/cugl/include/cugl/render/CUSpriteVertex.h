@@ -34,6 +34,8 @@
 #include <cugl/math/CUVec2.h>
 #include <cugl/math/CUVec3.h>
 #include <cugl/math/CUVec4.h>
+#include <cugl/math/CURect.h>
+#include <cugl/math/CUColor4.h>
 
 namespace cugl {
 
@@ -97,6 +99,52 @@ public:
     static const GLvoid* texcoordOffset()   { return (GLvoid*)offsetof(SpriteVertex2, texcoord);  }
 };
 
+/**
+ * This class/struct is rendering information for an instanced sprite.
+ *
+ * The class is intended to be used as a struct.  It is the per-instance data
+ * for {@link SpriteBatch#fillInstances}, which draws many copies of the same
+ * quad with a single draw call.  The quad is scaled first, then rotated, and
+ * finally offset by the position.
+ *
+ * The frame is the region of the active texture to use, in normalized
+ * coordinates with the origin at the top left corner of the texture.  This
+ * makes it easy to select a frame of a sprite sheet.  The default frame is
+ * the entire texture.
+ *
+ * Each instance uses 40 bytes, compared to the 144 bytes of vertex data
+ * (plus 24 bytes of indices) for a quad drawn with {@link SpriteVertex3}.
+ */
+class SpriteInstance {
+public:
+    /** The instance position */
+    cugl::Vec2   position;
+    /** The instance scale */
+    cugl::Vec2   scale;
+    /** The instance rotation in radians (counter clockwise) */
+    float        angle;
+    /** The instance tint */
+    cugl::Color4 color;
+    /** The texture region in normalized coordinates */
+    cugl::Rect   frame;
+    
+    /**
+     * Creates an untransformed, untinted instance of the entire texture.
+     */
+    SpriteInstance() : scale(Vec2::ONE), angle(0), color(Color4::WHITE), frame(0,0,1,1) {}
+    
+    /** The memory offset of the instance position */
+    static const GLvoid* positionOffset()   { return (GLvoid*)offsetof(SpriteInstance, position);  }
+    /** The memory offset of the instance scale */
+    static const GLvoid* scaleOffset()      { return (GLvoid*)offsetof(SpriteInstance, scale);     }
+    /** The memory offset of the instance angle */
+    static const GLvoid* angleOffset()      { return (GLvoid*)offsetof(SpriteInstance, angle);     }
+    /** The memory offset of the instance color */
+    static const GLvoid* colorOffset()      { return (GLvoid*)offsetof(SpriteInstance, color);     }
+    /** The memory offset of the instance frame */
+    static const GLvoid* frameOffset()      { return (GLvoid*)offsetof(SpriteInstance, frame);     }
+};
+
 }
 
 #endif /* __CU_VERTEX_H__ */
@@ -46,6 +46,7 @@
 #define _CU_TEXTURE_H__
 #include <cugl/math/CUMathBase.h>
 #include <cugl/math/CUSize.h>
+#include <cugl/render/CUCompressedImage.h>
 
 namespace cugl {
 
@@ -175,6 +176,9 @@ private:
     /** Whether or not the texture has mip maps */
     bool _hasMipmaps;
 
+    /** The block compression format (0 if the texture is not compressed) */
+    GLenum _compression;
+
     /** An all purpose blank texture for coloring */
     static std::shared_ptr<Texture> _blank;
 
@@ -270,6 +274,8 @@ public:
      *
      * This method can load any file format supported by SDL_Image. This
      * includes (but is not limited to) PNG, JPEG, GIF, TIFF, BMP and PCX.
+     * It also loads block-compressed images from KTX and KTX2 containers
+     * (files ending in .ktx or .ktx2), as in {@link initWithImage}.
      *
      * The texture will be stored in RGBA format, even if it is a file format
      * that does not support transparency (e.g. JPEG).
@@ -284,6 +290,24 @@ public:
      */
     bool initWithFile(const std::string filename);
 
+    /**
+     * Initializes a texture with the given block-compressed image.
+     *
+     * Initializing a texture requires the use of the binding point at 0. Any
+     * texture bound to that point will be unbound. In addition, once
+     * initialization is done, this texture will not longer be bound as well.
+     *
+     * The blocks are uploaded as is, together with every mipmap level in the
+     * image. The graphics card must support the image format (see
+     * {@link CompressedImage#isSupported}). A compressed texture cannot be
+     * modified with {@link set}, and cannot build its own mipmaps.
+     *
+     * @param image     The compressed image
+     *
+     * @return true if initialization was successful.
+     */
+    bool initWithImage(const std::shared_ptr<CompressedImage>& image);
+
     
 #pragma mark -
 #pragma mark Static Constructors
@@ -340,6 +364,8 @@ public:
      *
      * This method can load any file format supported by SDL_Image.  This
      * includes (but is not limited to) PNG, JPEG, GIF, TIFF, BMP and PCX.
+     * It also loads block-compressed images from KTX and KTX2 containers
+     * (files ending in .ktx or .ktx2), as in {@link initWithImage}.
      *
      * The texture will be stored in RGBA format, even if it is a file format
      * that does not support transparency (e.g. JPEG).
@@ -352,6 +378,27 @@ public:
         std::shared_ptr<Texture> result = std::make_shared<Texture>();
         return (result->initWithFile(filename) ? result : nullptr);
     }
+
+    /**
+     * Returns a new texture with the given block-compressed image.
+     *
+     * Allocating a texture requires the use of the binding point at 0. Any
+     * texture bound to that point will be unbound. In addition, once
+     * allocation is done, this texture will not longer be bound as well.
+     *
+     * The blocks are uploaded as is, together with every mipmap level in the
+     * image. The graphics card must support the image format (see
+     * {@link CompressedImage#isSupported}). A compressed texture cannot be
+     * modified with {@link set}, and cannot build its own mipmaps.
+     *
+     * @param image     The compressed image
+     *
+     * @return a new texture with the given block-compressed image.
+     */
+    static std::shared_ptr<Texture> allocWithImage(const std::shared_ptr<CompressedImage>& image) {
+        std::shared_ptr<Texture> result = std::make_shared<Texture>();
+        return (result->initWithImage(image) ? result : nullptr);
+    }
     
     /**
      * Returns a blank texture that can be used to make solid shapes.
@@ -486,6 +533,26 @@ public:
         return (_parent != nullptr ? _parent->hasMipMaps() : _hasMipmaps);
     }
 
+    /**
+     * Returns true if this texture is block-compressed.
+     *
+     * A compressed texture cannot be modified with {@link set}, and cannot
+     * build its own mipmaps. Any mipmaps came with the compressed image.
+     *
+     * @return true if this texture is block-compressed.
+     */
+    bool isCompressed() const { return _compression != 0; }
+
+    /**
+     * Returns the block compression format of this texture.
+     *
+     * This is the OpenGL internal format of the compressed image. If the
+     * texture is not compressed, this method returns 0.
+     *
+     * @return the block compression format of this texture.
+     */
+    GLenum getCompression() const { return _compression; }
+
     /**
      * Builds mipmaps for the current texture.
      *
@@ -494,6 +561,8 @@ public:
      * texture size is a power of two.
      *
      * This method is only successful if the texture is currently active.
+     * It does nothing to a compressed texture, whose mipmaps (if any) came
+     * with the compressed image.
      */
     void buildMipMaps();
         
@@ -97,10 +97,14 @@ private:
         GLboolean norm;
         /** The offset of the attribute in the vertex buffer */
         GLsizeiptr offset;
+        /** Whether the attribute advances per instance (not per vertex) */
+        bool instanced;
     };
     
     /** The data stride of this buffer (0 if there is only one attribute) */
     GLsizei _stride;
+    /** The data stride of the instance buffer (0 if there is no instancing) */
+    GLsizei _instStride;
 
     /** The array buffer for drawing a the shape */
     GLuint _vertArray;
@@ -108,6 +112,8 @@ private:
     GLuint _vertBuffer;
     /** The index buffer for drawing a shape */
     GLuint _indxBuffer;
+    /** The per-instance attribute buffer (0 if there is no instancing) */
+    GLuint _instBuffer;
     
     /** The shader currently attached to this vertex buffer */
     std::shared_ptr<Shader> _shader;
@@ -174,6 +180,41 @@ public:
         std::shared_ptr<VertexBuffer> result = std::make_shared<VertexBuffer>();
         return (result->init(stride) ? result : nullptr);
     }
+    
+    /**
+     * Initializes this vertex buffer to support the given strides.
+     *
+     * The stride is the size of a single piece of vertex data. The instance
+     * stride is the size of a single piece of per-instance data. If the
+     * instance stride is positive, this vertex buffer has a second array
+     * buffer for attributes that advance once per instance instead of once
+     * per vertex. See {@link #setupInstanceAttribute}.
+     *
+     * @param stride    The size of a single piece of vertex data.
+     * @param istride   The size of a single piece of instance data.
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(GLsizei stride, GLsizei istride);
+    
+    /**
+     * Returns a new vertex buffer to support the given strides.
+     *
+     * The stride is the size of a single piece of vertex data. The instance
+     * stride is the size of a single piece of per-instance data. If the
+     * instance stride is positive, this vertex buffer has a second array
+     * buffer for attributes that advance once per instance instead of once
+     * per vertex. See {@link #setupInstanceAttribute}.
+     *
+     * @param stride    The size of a single piece of vertex data.
+     * @param istride   The size of a single piece of instance data.
+     *
+     * @return a new vertex buffer to support the given strides.
+     */
+    static std::shared_ptr<VertexBuffer> alloc(GLsizei stride, GLsizei istride) {
+        std::shared_ptr<VertexBuffer> result = std::make_shared<VertexBuffer>();
+        return (result->init(stride,istride) ? result : nullptr);
+    }
 
 
 #pragma mark -
@@ -252,6 +293,16 @@ public:
      */
      GLsizei getStride() const { return _stride; }
     
+    /**
+     * Returns the instance stride of this vertex buffer
+     *
+     * The instance stride is the size of a single piece of per-instance data.
+     * It is 0 if this vertex buffer does not support instancing.
+     *
+     * @return the instance stride of this vertex buffer
+     */
+    GLsizei getInstanceStride() const { return _instStride; }
+    
     /**
      * Loads the given vertex buffer with data.
      *
@@ -307,6 +358,24 @@ public:
      */
     void loadIndexData(const void * data, GLsizei size, GLenum usage=GL_STREAM_DRAW);
     
+    /**
+     * Loads the instance buffer with data.
+     *
+     * The data loaded is the per-instance data that will be used at the next
+     * call to {@link #drawInstanced}. It is expected to have the size of the
+     * instance stride. This method has no effect if this buffer does not
+     * support instancing.
+     *
+     * The data usage is one of GL_STATIC_DRAW, GL_STREAM_DRAW, or GL_DYNAMIC_DRAW.
+     *
+     * This method will only succeed if this buffer is actively bound.
+     *
+     * @param data  The data to load
+     * @param size  The number of instances to load
+     * @param usage The type of data load
+     */
+    void loadInstanceData(const void * data, GLsizei size, GLenum usage=GL_STREAM_DRAW);
+    
     /**
      * Draws to the active framebuffer using this vertex buffer
      *
@@ -398,6 +467,25 @@ public:
     void setupAttribute(const std::string name, GLint size, GLenum type,
                         GLboolean norm, GLsizei offset);
     
+    /**
+     * Initializes a per-instance attribute, assigning is a size, type and offset.
+     *
+     * This method is the same as {@link #setupAttribute}, except that the
+     * attribute is read from the instance buffer and advances once per
+     * instance in {@link #drawInstanced}. The attribute offset is measured
+     * in bytes from the start of the instance data structure.
+     *
+     * This method has no effect if this buffer does not support instancing.
+     *
+     * @param name      The attribute name
+     * @param size      The attribute size in byte.
+     * @param type      The attribute type
+     * @param norm      Whether to normalize the value (floating point only)
+     * @param offset    The attribute offset in the instance data structure
+     */
+    void setupInstanceAttribute(const std::string name, GLint size, GLenum type,
+                                GLboolean norm, GLsizei offset);
+    
     
     /**
      * Enables the given attribute
@@ -421,6 +509,18 @@ public:
      */
     void disableAttribute(const std::string name);
     
+private:
+    /**
+     * Links the given attribute data to the shader location.
+     *
+     * This method binds the attribute to the correct array buffer (vertex or
+     * instance) and sets its divisor. It restores the vertex array buffer
+     * when done.
+     *
+     * @param pos   The attribute location in the active shader
+     * @param data  The attribute settings
+     */
+    void linkAttribute(GLint pos, const AttribData& data);
 
 };
 
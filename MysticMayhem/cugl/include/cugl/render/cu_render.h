@@ -28,7 +28,10 @@
 #ifndef __CU_RENDER_PKG_H__
 #define __CU_RENDER_PKG_H__
 
+#include "CURenderBackend.h"
+#include "CURecordingBackend.h"
 #include "CUSpriteVertex.h"
+#include "CUCompressedImage.h"
 #include "CUTexture.h"
 #include "CUFont.h"
 #include "CUMesh.h"
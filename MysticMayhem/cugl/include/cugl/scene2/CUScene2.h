@@ -91,6 +91,13 @@ protected:
 
     /** Whether or note this scene is still active */
     bool _active;
+    
+    /** The number of node transforms recomputed in the last render pass */
+    Uint32 _multiplies;
+    /** Whether to render through a sorted draw queue */
+    bool _deferred;
+    /** The draw queue for deferred rendering (allocated on demand) */
+    std::shared_ptr<scene2::DrawQueue> _queue;
 
 #pragma mark -
 #pragma mark Constructors
@@ -927,6 +934,79 @@ public:
      */
     virtual void render(const std::shared_ptr<SpriteBatch>& batch);
     
+    /**
+     * Returns the number of matrix multiplications in the last render pass.
+     *
+     * Scene graph nodes cache their transforms, and only recompute them
+     * when the node (or one of its ancestors) has changed. This counter
+     * is the number of nodes whose cached transform was recomputed in the
+     * most recent call to {@link #render}. A static scene graph should
+     * have a count of 0.
+     *
+     * @return the number of matrix multiplications in the last render pass.
+     */
+    Uint32 getMultiplyCount() const { return _multiplies; }
+    
+    /**
+     * Returns true if this scene renders in deferred mode.
+     *
+     * In deferred mode, the scene graph is not drawn with a pre-order
+     * traversal. Instead, every visible node submits a draw command to a
+     * {@link scene2::DrawQueue}, which sorts the commands by texture and
+     * blend state before drawing them. Commands are only reordered when
+     * this does not change the final image. Custom nodes that override
+     * {@link scene2::SceneNode#draw} must also override
+     * {@link scene2::SceneNode#getDrawState}, or they are not drawn in
+     * deferred mode. Nodes that cannot describe their state act as barriers.
+     *
+     * Deferred mode is off by default.
+     *
+     * @return true if this scene renders in deferred mode.
+     */
+    bool isDeferred() const { return _deferred; }
+    
+    /**
+     * Sets whether this scene renders in deferred mode.
+     *
+     * In deferred mode, the scene graph is not drawn with a pre-order
+     * traversal. Instead, every visible node submits a draw command to a
+     * {@link scene2::DrawQueue}, which sorts the commands by texture and
+     * blend state before drawing them. Commands are only reordered when
+     * this does not change the final image. Custom nodes that override
+     * {@link scene2::SceneNode#draw} must also override
+     * {@link scene2::SceneNode#getDrawState}, or they are not drawn in
+     * deferred mode. Nodes that cannot describe their state act as barriers.
+     *
+     * Deferred mode is off by default.
+     *
+     * @param value Whether this scene renders in deferred mode.
+     */
+    void setDeferred(bool value) { _deferred = value; }
+    
+    /**
+     * Returns the draw queue used in the last deferred render pass.
+     *
+     * The queue records the number of batches before and after sorting,
+     * which is useful for profiling. This method returns nullptr if the
+     * scene has never been rendered in deferred mode.
+     *
+     * @return the draw queue used in the last deferred render pass.
+     */
+    const std::shared_ptr<scene2::DrawQueue>& getDrawQueue() const { return _queue; }
+    
+protected:
+    /**
+     * Draws all of the children in this scene with the given SpriteBatch.
+     *
+     * This method assumes that the sprite batch is actively drawing. It is
+     * used by {@link #render} once the batch has been set up, and draws the
+     * children either directly or through the draw queue, depending on
+     * whether this scene is deferred.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     */
+    void renderChildren(const std::shared_ptr<SpriteBatch>& batch);
+    
 private:
 #pragma mark -
 #pragma mark Internal Helpers
@@ -37,6 +37,7 @@
 #include "graph/CUPathNode.h"
 #include "graph/CUAnimationNode.h"
 #include "graph/CUOrderedNode.h"
+#include "graph/CUDrawQueue.h"
 #include "ui/CUButton.h"
 #include "ui/CULabel.h"
 #include "ui/CUProgressBar.h"
@@ -0,0 +1,397 @@
+//
+//  CUDrawQueue.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a deferred command list for rendering a scene graph.
+//  Normally a scene graph is drawn with a pre-order traversal, which forces a
+//  change of sprite batch state whenever two consecutive nodes use different
+//  textures or blend modes. In deferred mode, nodes emit draw commands into
+//  this queue instead. The queue sorts the commands by layer, texture, and
+//  blend state, and then replays them with as few state changes as possible.
+//
+//  Commands are only reordered when this is safe. Two commands may only swap
+//  their order if their bounding boxes do not overlap or if they share the
+//  same state. This guarantees that the final image is identical to the one
+//  produced by a pre-order traversal.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+#ifndef __CU_DRAW_QUEUE_H__
+#define __CU_DRAW_QUEUE_H__
+#include <cugl/math/CUMat4.h>
+#include <cugl/math/CURect.h>
+#include <cugl/math/CUColor4.h>
+#include <cugl/render/CUScissor.h>
+#include <cugl/render/CUMesh.h>
+#include <cugl/render/CUSpriteVertex.h>
+#include <unordered_map>
+#include <vector>
+
+namespace cugl {
+
+/** Forward references */
+class SpriteBatch;
+
+    namespace scene2 {
+
+/** Forward references */
+class SceneNode;
+
+/**
+ * This class represents the sprite batch state of a single scene graph node.
+ *
+ * This information is used by {@link DrawQueue} to decide which draw
+ * commands may be reordered. The state is provided by the method
+ * {@link SceneNode#getDrawState}, which should be overridden by any
+ * subclass that overrides {@link SceneNode#draw}.
+ *
+ * The texture is only used as an identifier, and is never dereferenced.
+ * Nodes that change batch state in the middle of their draw method (such
+ * as a gradient or a label background) should either supply a unique
+ * identifier (like the node itself) or mark themselves as a barrier.
+ */
+class DrawState {
+public:
+    /** The texture identifier (may be nullptr for the blank texture) */
+    const void* texture;
+    /** The blending equation */
+    GLenum blendEquation;
+    /** The source factor for the blend function */
+    GLenum srcFactor;
+    /** The destination factor for the blend function */
+    GLenum dstFactor;
+    /** The region touched by the draw method (in node space) */
+    Rect bounds;
+    /** Whether this node must be drawn in order with respect to all others */
+    bool barrier;
+
+    /**
+     * Creates a barrier draw state.
+     *
+     * A barrier state is never reordered with respect to any other command.
+     */
+    DrawState() :
+    texture(nullptr),
+    blendEquation(GL_FUNC_ADD),
+    srcFactor(GL_SRC_ALPHA),
+    dstFactor(GL_ONE_MINUS_SRC_ALPHA),
+    barrier(true) {}
+
+    /**
+     * Sets this state to batch with the given texture and blend state.
+     *
+     * The bounds are set to the bounding box of the mesh vertices. This
+     * method clears the barrier flag.
+     *
+     * @param texture   The texture identifier
+     * @param equation  The blending equation
+     * @param srcFactor The source factor for the blend function
+     * @param dstFactor The destination factor for the blend function
+     * @param mesh      The mesh drawn by the node
+     */
+    void set(const void* texture, GLenum equation, GLenum srcFactor, GLenum dstFactor,
+             const Mesh<SpriteVertex2>& mesh);
+};
+
+/**
+ * This class is a sorted command list for deferred scene graph rendering.
+ *
+ * In deferred mode, a {@link Scene2} does not render its nodes directly.
+ * Instead, each visible node submits a draw command to this queue with
+ * its cached transform, tint, scissor, and {@link DrawState}. When the queue
+ * is flushed, every command is assigned a layer. A command is placed in the
+ * lowest layer that keeps it above every earlier command that it overlaps,
+ * unless that earlier command has the same state (in which case they may
+ * share a layer). Overlap is computed conservatively on a coarse grid over
+ * the bounds of the frame.
+ *
+ * The commands are then radix-sorted on a 64 bit key of layer, texture,
+ * blend state, scissor, and submission order, and replayed to the sprite
+ * batch. Because the submission order is the least significant part of the
+ * key, commands with identical state are drawn in their original order.
+ *
+ * The queue keeps all of its storage between frames, so that a queue of
+ * a stable scene graph does not allocate any memory per frame.
+ */
+class DrawQueue {
+#pragma mark Values
+private:
+    /**
+     * An inner class storing a single draw command.
+     */
+    class Command {
+    public:
+        /** The node to draw */
+        SceneNode* node;
+        /** The transform to draw with (owned by the scene graph) */
+        const Mat4* transform;
+        /** The tint to draw with */
+        Color4 tint;
+        /** The bounds of the command in render space */
+        Rect bounds;
+        /** The dense identifier of the texture */
+        Uint32 texture;
+        /** The dense identifier of the blend state */
+        Uint32 blend;
+        /** The scissor index (0 if there is no scissor) */
+        Uint32 clip;
+        /** Whether this command must not be reordered */
+        bool barrier;
+        /** Whether to call render instead of draw on replay */
+        bool render;
+    };
+
+    /**
+     * An inner class storing the layer information of a grid cell.
+     */
+    class Cell {
+    public:
+        /** The highest layer touching this cell (-1 if none) */
+        Sint32 top;
+        /** The state of the commands in the highest layer */
+        Uint64 state;
+        /** Whether the highest layer has commands of different states */
+        bool mixed;
+    };
+
+    /** The commands for the current frame, in submission order */
+    std::vector<Command> _commands;
+    /** The scissor masks for the current frame (indexed by clip-1) */
+    std::vector<Scissor> _scissors;
+    /** The stack of active scissor indices */
+    std::vector<Uint32> _clipStack;
+    /** The sort keys for the current frame */
+    std::vector<Uint64> _keys;
+    /** The scratch buffer for radix sort */
+    std::vector<Uint64> _scratch;
+    /** The conservative overlap grid */
+    std::vector<Cell> _cells;
+    /** The dense texture identifiers for this frame */
+    std::unordered_map<const void*,Uint32> _textures;
+    /** The blend states for this frame, three enums per identifier */
+    std::vector<GLenum> _blends;
+
+    /** The number of state changes in submission order */
+    Uint32 _unsorted;
+    /** The number of state changes after sorting */
+    Uint32 _sorted;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates an empty draw queue.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a queue on
+     * the heap, use one of the static constructors instead.
+     */
+    DrawQueue();
+
+    /**
+     * Deletes this draw queue, disposing all resources
+     */
+    ~DrawQueue() { dispose(); }
+
+    /**
+     * Disposes all of the resources used by this queue.
+     *
+     * A disposed queue can be safely reinitialized.
+     */
+    void dispose();
+
+    /**
+     * Initializes an empty draw queue.
+     *
+     * @return true if initialization was successful.
+     */
+    bool init();
+
+    /**
+     * Returns a newly allocated draw queue.
+     *
+     * @return a newly allocated draw queue.
+     */
+    static std::shared_ptr<DrawQueue> alloc() {
+        std::shared_ptr<DrawQueue> result = std::make_shared<DrawQueue>();
+        return (result->init() ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Commands
+    /**
+     * Removes all commands from this queue.
+     *
+     * This method does not release any memory, so that the queue can be
+     * refilled without allocation.
+     */
+    void clear();
+
+    /**
+     * Adds a draw command for the given node.
+     *
+     * The transform is stored by reference, so it must remain valid until
+     * the queue is flushed. The cached transforms of the scene graph have
+     * this property.
+     *
+     * @param node      The node to draw
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to draw with.
+     * @param state     The sprite batch state of the node.
+     */
+    void push(SceneNode* node, const Mat4& transform, Color4 tint, const DrawState& state);
+
+    /**
+     * Adds a render barrier for the given node.
+     *
+     * On replay, the queue will call {@link SceneNode#render} with the given
+     * transform and tint. This is used by nodes like {@link OrderedNode}
+     * that manage the render order of their own subtree.
+     *
+     * @param node      The node to render
+     * @param transform The transform of the parent node.
+     * @param tint      The tint of the parent node.
+     */
+    void pushRender(SceneNode* node, const Mat4& transform, Color4 tint);
+
+    /**
+     * Pushes a scissor mask onto the queue.
+     *
+     * The mask is intersected with the current mask (if any), and applies to
+     * all commands until the matching call to {@link #popScissor}.
+     *
+     * @param scissor   The scissor mask in render space
+     */
+    void pushScissor(const Scissor& scissor);
+
+    /**
+     * Restores the scissor mask active before the last {@link #pushScissor}.
+     */
+    void popScissor();
+
+    /**
+     * Sorts and draws all commands in this queue with the given sprite batch.
+     *
+     * The sprite batch should be active. This method does not clear the queue,
+     * so that the statistics remain available until the next frame.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     */
+    void flush(const std::shared_ptr<SpriteBatch>& batch);
+
+#pragma mark -
+#pragma mark Statistics
+    /**
+     * Returns the number of commands in this queue.
+     *
+     * @return the number of commands in this queue.
+     */
+    size_t size() const { return _commands.size(); }
+
+    /**
+     * Returns the number of sprite batch state changes before sorting.
+     *
+     * This is the number of batches that a pre-order traversal would produce
+     * (ignoring flushes from a full vertex buffer). It is computed when the
+     * queue is flushed.
+     *
+     * @return the number of sprite batch state changes before sorting.
+     */
+    Uint32 getUnsortedBatches() const { return _unsorted; }
+
+    /**
+     * Returns the number of sprite batch state changes after sorting.
+     *
+     * This is the number of batches produced by the last call to {@link #flush}
+     * (ignoring flushes from a full vertex buffer).
+     *
+     * @return the number of sprite batch state changes after sorting.
+     */
+    Uint32 getSortedBatches() const { return _sorted; }
+
+private:
+#pragma mark -
+#pragma mark Internal Helpers
+    /**
+     * Returns the dense identifier for the given texture.
+     *
+     * @param texture   The texture identifier
+     *
+     * @return the dense identifier for the given texture.
+     */
+    Uint32 getTextureKey(const void* texture);
+
+    /**
+     * Returns the dense identifier for the given blend state.
+     *
+     * @param equation  The blending equation
+     * @param srcFactor The source factor for the blend function
+     * @param dstFactor The destination factor for the blend function
+     *
+     * @return the dense identifier for the given blend state.
+     */
+    Uint32 getBlendKey(GLenum equation, GLenum srcFactor, GLenum dstFactor);
+
+    /**
+     * Assigns a layer to every command in the queue.
+     *
+     * The layers are stored in the sort keys. This method returns false if
+     * the commands do not fit in the sort key, in which case the queue should
+     * be drawn in submission order.
+     *
+     * @return true if every command was assigned a layer
+     */
+    bool assignLayers();
+
+    /**
+     * Sorts the keys with a least-significant-digit radix sort.
+     *
+     * Passes over bytes that are the same in every key are skipped.
+     */
+    void radixSort();
+
+    /**
+     * Returns the number of state changes when drawing in the given order.
+     *
+     * @param sorted    Whether to use the sorted order
+     *
+     * @return the number of state changes when drawing in the given order.
+     */
+    Uint32 countBatches(bool sorted) const;
+
+    /** This macro disables the copy constructor (not allowed on scene graphs) */
+    CU_DISALLOW_COPY_AND_ASSIGN(DrawQueue);
+};
+
+    }
+}
+
+#endif /* __CU_DRAW_QUEUE_H__ */
@@ -185,8 +185,8 @@ protected:
         OrderedNode* parent;
         /** The node to be drawn at this step */
         std::shared_ptr<SceneNode> node;
-        /** The scissor value (possibly nullptr) */
-        std::shared_ptr<Scissor> scissor;
+        /** The index of the scissor value in the parent scissor list (-1 if none) */
+        Sint32 scissor;
         /** The drawing transform */
         Mat4 transform;
         /** The tint color */
@@ -224,8 +224,10 @@ protected:
 
     /** The render queue (always use a deque for this functionality) */
     std::deque<Context*> _entries;
-    /** The global scissor context (necessary as sprite batches manage this normally) */
-    std::shared_ptr<Scissor> _viewport;
+    /** The scissor values of the render queue (reused so that we do not allocate) */
+    std::vector<Scissor> _scissors;
+    /** The index of the global scissor context in _scissors (-1 if none) */
+    Sint32 _viewport;
     /** The current render order */
     Order _order;
     
@@ -629,6 +631,21 @@ public:
         render(batch,Mat4::IDENTITY,Color4::WHITE);
     }
 
+protected:
+    /**
+     * Submits this node and all of its children to the given draw queue.
+     *
+     * If the order is {@link Order#PRE_ORDER}, this reverts to the submit
+     * method of {@link SceneNode}. Otherwise, this node is a render barrier,
+     * and it is pushed to the queue as a single render command. Its subtree
+     * is then drawn by {@link #render} when the queue is flushed.
+     *
+     * @param queue     The draw queue to submit to.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     */
+    virtual void submit(DrawQueue& queue, const Mat4& transform, Color4 tint) override;
+
     /** This macro disables the copy constructor (not allowed on scene graphs) */
     CU_DISALLOW_COPY_AND_ASSIGN(OrderedNode);
 };
@@ -66,6 +66,8 @@ class Scene2Loader;
     namespace scene2 {
     
 class Layout;
+class DrawQueue;
+class DrawState;
     
     
 /**
@@ -177,6 +179,26 @@ protected:
      */
     Mat4  _combined;
     
+    /**
+     * The cached node-to-render transform.
+     *
+     * This is the product of the local transform with the transform passed
+     * to {@link #render}. It is only recomputed when {@link #_worldDirty} is
+     * set, or when the incoming transform differs from {@link #_worldBasis}.
+     */
+    Mat4  _worldCache;
+    
+    /** The render transform used to compute the cached world transform */
+    Mat4  _worldBasis;
+    
+    /**
+     * Whether the cached world transform is out of date.
+     *
+     * This flag is set whenever the local transform changes.  It is pushed
+     * down to the children whenever this node recomputes its cache.
+     */
+    bool  _worldDirty;
+    
     /** The array of children nodes */
     std::vector<std::shared_ptr<SceneNode>> _children;
 
@@ -1983,6 +2005,71 @@ public:
      */
     virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {}
     
+    /**
+     * Returns true if this node draws anything, storing its state in dst.
+     *
+     * This method is used by a {@link Scene2} in deferred mode to batch draw
+     * commands by texture and blend state. The state must describe the
+     * texture and blending used by {@link #draw}, as well as the region
+     * (in node space) that it touches. A node that cannot describe its
+     * state should return true and leave dst as a barrier. Barriers are
+     * never reordered with respect to any other node.
+     *
+     * The base SceneNode draws nothing and so returns false. Any subclass
+     * that overrides {@link #draw} MUST override this method as well, or it
+     * will not be drawn in deferred mode. If such a subclass cannot describe
+     * its state, its override should return true and leave dst unchanged so
+     * that it acts as a barrier.
+     *
+     * @param dst   The draw state to store the result
+     *
+     * @return true if this node draws anything
+     */
+    virtual bool getDrawState(DrawState* /*dst*/);
+    
+protected:
+    /**
+     * Submits this node and all of its children to the given draw queue.
+     *
+     * This method is the deferred analogue of {@link #render}. Instead of
+     * drawing, it pushes a command for this node (if {@link #getDrawState}
+     * says it draws anything) and then recursively submits its children.
+     * Nodes that override {@link #render} to control the drawing of their
+     * subtree should override this method as well.
+     *
+     * @param queue     The draw queue to submit to.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     */
+    virtual void submit(DrawQueue& queue, const Mat4& transform, Color4 tint);
+    
+    /**
+     * Returns the cached transform from node space to render space.
+     *
+     * The render space is the space of the transform passed to {@link #render}.
+     * This matrix is only recomputed if the local transform has changed, or
+     * if the given transform is not the one used to compute the cache. In that
+     * case, this method marks the children as dirty as well, so that the
+     * change propagates down the scene graph.
+     *
+     * If the transform is the cached world transform of the parent, this
+     * method trusts the dirty flag and does not compare matrices.
+     *
+     * @param transform The global transformation matrix of the parent.
+     *
+     * @return the cached transform from node space to render space.
+     */
+    const Mat4& getWorldCache(const Mat4& transform);
+    
+    /**
+     * Marks the cached world transform as out of date.
+     *
+     * This method should be called by any subclass that modifies the
+     * local transform {@link #_combined} directly.
+     */
+    void setWorldDirty() { _worldDirty = true; }
+
+public:
     
 #pragma mark -
 #pragma mark Layout Automation
@@ -2054,7 +2141,7 @@ private:
      *
      * @param parent    A pointer to the parent node.
      */
-    void setParent(SceneNode* parent) { _parent = parent; }
+    void setParent(SceneNode* parent) { _parent = parent; _worldDirty = true; }
 
     /**
      * Sets the scene graph.
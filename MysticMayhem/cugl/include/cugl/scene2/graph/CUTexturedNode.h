@@ -695,6 +695,20 @@ public:
     virtual void draw(const std::shared_ptr<SpriteBatch>& batch,
                       const Mat4& transform, Color4 tint) override = 0;
     
+    /**
+     * Returns true if this node draws anything, storing its state in dst.
+     *
+     * This method is used by a {@link Scene2} in deferred mode to batch draw
+     * commands by texture and blend state.  A node with a gradient
+     * uses itself as the texture identifier, as the gradient is part of the
+     * sprite batch state.
+     *
+     * @param dst   The draw state to store the result
+     *
+     * @return true if this node draws anything
+     */
+    virtual bool getDrawState(DrawState* dst) override;
+    
     /**
      * Refreshes this node to restore the render data.
      */
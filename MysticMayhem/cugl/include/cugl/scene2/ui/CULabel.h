@@ -232,6 +232,27 @@ protected:
     Rect _bounds;
     /** The underlying atlas texture */
     std::shared_ptr<Texture> _texture;
+    
+    /**
+     * An inner class storing the layout of a single character.
+     *
+     * The glyph run allows a label to replace individual glyphs without
+     * laying out the text again.
+     */
+    class Glyph {
+    public:
+        /** The pen position (after kerning) at the start of this glyph */
+        Vec2 offset;
+        /** The distance the pen advanced for this glyph */
+        float advance;
+        /** The index of the first glyph vertex in the mesh (-1 if none) */
+        Sint32 vertex;
+    };
+    
+    /** The glyph run of the rendered text (empty if it cannot be patched) */
+    std::vector<Glyph> _glyphs;
+    /** A scratch mesh for patching glyphs (reused to prevent allocation) */
+    Mesh<SpriteVertex2> _patch;
 
 public:
 #pragma mark -
@@ -478,7 +499,11 @@ public:
      * may be different than those displayed.
      *
      * Changing this value will regenerate the render data, and is potentially
-     * expensive, particularly if the font does not have an atlas.
+     * expensive, particularly if the font does not have an atlas. However,
+     * setting the same text again does nothing. In addition, if the font has
+     * an atlas and the only changes are digits of the same width (such as a
+     * score or a timer), this method replaces the quads of those digits in
+     * place without laying out the text again.
      *
      * @param text      The text for this label.
      * @param resize    Whether to resize the label to fit the new text.
@@ -900,6 +925,19 @@ public:
      */
     virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) override;
     
+    /**
+     * Returns true if this node draws anything, storing its state in dst.
+     *
+     * This method is used by a {@link Scene2} in deferred mode to batch draw
+     * commands by texture and blend state.  A label with a background
+     * color is a barrier, as it draws with two different textures.
+     *
+     * @param dst   The draw state to store the result
+     *
+     * @return true if this node draws anything
+     */
+    virtual bool getDrawState(DrawState* dst) override;
+    
 private:
 #pragma mark -
 #pragma mark Internal Helpers
@@ -932,6 +970,33 @@ private:
      * colors.
      */
     void updateColor();
+    
+    /**
+     * Returns true if the given text is the same as the current text.
+     *
+     * The comparison is made after unprintable characters are replaced by
+     * spaces, as in {@link #setText}.
+     *
+     * @param text  The text to compare
+     *
+     * @return true if the given text is the same as the current text.
+     */
+    bool matchesText(const std::string& text) const;
+    
+    /**
+     * Returns true if the text was changed by patching the glyph run.
+     *
+     * This method only succeeds if the render data is present, the text has
+     * the same length, and the only changes are digits with the same advance
+     * and kerning as the digits they replace. In that case, the quads for the
+     * changed digits are replaced in the mesh, and nothing else is laid out
+     * again. Otherwise, this method does nothing and returns false.
+     *
+     * @param text  The new text for this label
+     *
+     * @return true if the text was changed by patching the glyph run.
+     */
+    bool patchText(const std::string& text);
 };
     }  
 }
@@ -543,6 +543,18 @@ public:
     virtual void draw(const std::shared_ptr<SpriteBatch>& batch,
                       const Mat4& transform, Color4 tint) override;
     
+    /**
+     * Returns true if this node draws anything, storing its state in dst.
+     *
+     * This method is used by a {@link Scene2} in deferred mode to batch draw
+     * commands by texture and blend state.
+     *
+     * @param dst   The draw state to store the result
+     *
+     * @return true if this node draws anything
+     */
+    virtual bool getDrawState(DrawState* dst) override;
+    
     /**
      * Refreshes this node to restore the render data.
      */
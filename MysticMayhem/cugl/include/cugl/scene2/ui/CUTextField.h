@@ -555,6 +555,19 @@ protected:
      * @param tint      The tint to blend with the Node color.
      */
     virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) override;
+    
+    /**
+     * Returns true if this node draws anything, storing its state in dst.
+     *
+     * This method is used by a {@link Scene2} in deferred mode to batch draw
+     * commands by texture and blend state.  A text field with focus
+     * is a barrier, as the cursor is drawn with a different texture.
+     *
+     * @param dst   The draw state to store the result
+     *
+     * @return true if this node draws anything
+     */
+    virtual bool getDrawState(DrawState* dst) override;
 
     
 #pragma mark -
@@ -0,0 +1,260 @@
+//
+//  CURingQueue.h
+//  Cornell University Game Library (CUGL)
+//
+//  This header provides a template for a bounded, wait-free queue with a
+//  single producer and a single consumer. It is designed for communication
+//  with a real-time thread (such as the audio thread), which must never block
+//  on a lock or allocate memory. All memory is allocated when the queue is
+//  initialized, and neither push nor pop ever waits on the other thread.
+//
+//  The queue is safe for exactly one producer thread and exactly one consumer
+//  thread. It is not safe for multiple producers or multiple consumers.
+//
+//  This is not a class. It is a class template. Templates do not have cpp
+//  files. They only have a header file.  When you include the header, it
+//  compiles the specific template used by your program. Hence all of the code
+//  for this templated class is in this header.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#ifndef __CU_RING_QUEUE_H__
+#define __CU_RING_QUEUE_H__
+#include <cugl/util/CUDebug.h>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace cugl {
+
+#pragma mark -
+#pragma mark RingQueue Template
+
+/**
+ * Template for a single-producer, single-consumer ring queue.
+ *
+ * This queue has a fixed capacity, which is rounded up to a power of two. If
+ * the queue is full, {@link #push} fails immediately rather than waiting for
+ * the consumer. Similarly, if the queue is empty, {@link #pop} fails
+ * immediately. Hence neither thread ever blocks on the other.
+ *
+ * The elements are preallocated when the queue is initialized, so the type T
+ * must have a default constructor. Elements are moved into and out of the
+ * queue. When an element is popped, the slot is left in its moved-from state.
+ * For a shared pointer, this means the queue never holds a reference to a
+ * popped element, and the element is never deleted by the consumer unless
+ * the consumer drops it.
+ *
+ * The head and tail indices are padded apart so that the two threads do not
+ * contend on the same cache line.
+ */
+template <class T>
+class RingQueue {
+private:
+    /** The element storage */
+    T* _data;
+    /** The capacity minus one (the capacity is a power of two) */
+    size_t _mask;
+    /** The next position to read (written only by the consumer) */
+    std::atomic<size_t> _head;
+    /** Padding to keep the head and tail on separate cache lines */
+    char _padding[64-sizeof(std::atomic<size_t>)];
+    /** The next position to write (written only by the producer) */
+    std::atomic<size_t> _tail;
+
+public:
+#pragma mark Constructors
+    /**
+     * Creates a new ring queue with no capacity.
+     *
+     * You must initialize this queue before use.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a queue on
+     * the heap, use one of the static constructors instead.
+     */
+    RingQueue() : _data(nullptr), _mask(0), _head(0), _tail(0) {}
+
+    /**
+     * Deletes this queue, releasing all memory.
+     */
+    ~RingQueue() { dispose(); }
+
+    /**
+     * Disposes this queue, releasing all memory.
+     *
+     * A disposed queue can be safely reinitialized. This method is not
+     * thread-safe, and should only be called when no other thread is
+     * accessing the queue.
+     */
+    void dispose() {
+        if (_data != nullptr) {
+            delete[] _data;
+            _data = nullptr;
+        }
+        _mask = 0;
+        _head.store(0,std::memory_order_relaxed);
+        _tail.store(0,std::memory_order_relaxed);
+    }
+
+    /**
+     * Initializes a queue with the given capacity.
+     *
+     * The capacity is rounded up to the next power of two. It must be
+     * non-zero.
+     *
+     * @param capacity  The minimum number of elements the queue can hold
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(size_t capacity) {
+        CUAssertLog(capacity, "A ring queue must have non-zero capacity");
+        CUAssertLog(_data == nullptr, "Ring queue is already initialized");
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _data = new T[size];
+        _mask = size-1;
+        _head.store(0,std::memory_order_relaxed);
+        _tail.store(0,std::memory_order_relaxed);
+        return _data != nullptr;
+    }
+
+    /**
+     * Returns a newly allocated queue with the given capacity.
+     *
+     * The capacity is rounded up to the next power of two. It must be
+     * non-zero.
+     *
+     * @param capacity  The minimum number of elements the queue can hold
+     *
+     * @return a newly allocated queue with the given capacity.
+     */
+    static std::shared_ptr<RingQueue<T>> alloc(size_t capacity) {
+        std::shared_ptr<RingQueue<T>> result = std::make_shared<RingQueue<T>>();
+        return (result->init(capacity) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Producer Methods
+    /**
+     * Adds a copy of the element to the end of this queue.
+     *
+     * This method fails immediately if the queue is full. It should only be
+     * called by the producer thread.
+     *
+     * @param value The element to add
+     *
+     * @return true if the element was added
+     */
+    bool push(const T& value) {
+        T copy = value;
+        return push(std::move(copy));
+    }
+
+    /**
+     * Moves the element to the end of this queue.
+     *
+     * This method fails immediately if the queue is full, in which case the
+     * value is not moved. It should only be called by the producer thread.
+     *
+     * @param value The element to add
+     *
+     * @return true if the element was added
+     */
+    bool push(T&& value) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail-_head.load(std::memory_order_acquire) > _mask) {
+            return false;
+        }
+        _data[tail & _mask] = std::move(value);
+        _tail.store(tail+1,std::memory_order_release);
+        return true;
+    }
+
+#pragma mark -
+#pragma mark Consumer Methods
+    /**
+     * Removes the element at the front of this queue.
+     *
+     * The element is moved into value. This method fails immediately if the
+     * queue is empty. It should only be called by the consumer thread.
+     *
+     * @param value The object to store the element
+     *
+     * @return true if an element was removed
+     */
+    bool pop(T& value) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(_data[head & _mask]);
+        _head.store(head+1,std::memory_order_release);
+        return true;
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns true if this queue is empty.
+     *
+     * The result is only a snapshot if called from the producer thread, as
+     * the consumer may remove elements at any time.
+     *
+     * @return true if this queue is empty.
+     */
+    bool empty() const {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns the number of elements in this queue.
+     *
+     * The result is only a snapshot, as the other thread may change the
+     * queue at any time.
+     *
+     * @return the number of elements in this queue.
+     */
+    size_t size() const {
+        size_t tail = _tail.load(std::memory_order_acquire);
+        return tail-_head.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns the maximum number of elements in this queue.
+     *
+     * @return the maximum number of elements in this queue.
+     */
+    size_t capacity() const {
+        return _data == nullptr ? 0 : _mask+1;
+    }
+
+    /** Queues may not be copied (the threads would not share the copy) */
+    RingQueue(const RingQueue&) = delete;
+    /** Queues may not be copied (the threads would not share the copy) */
+    RingQueue& operator=(const RingQueue&) = delete;
+};
+
+}
+
+#endif /* __CU_RING_QUEUE_H__ */
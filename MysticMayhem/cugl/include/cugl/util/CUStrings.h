@@ -283,6 +283,45 @@ namespace cugl {
     std::string to_string(double* array, size_t length, size_t offset=0, int precision=-1);
     
     
+#pragma mark -
+#pragma mark IN-PLACE FORMATTING FUNCTIONS
+    /**
+     * Appends the decimal representation of value to dst.
+     *
+     * Unlike {@link to_string}, this function does not create a new string.
+     * If dst has enough capacity, it does not allocate any memory at all.
+     * This makes it suitable for text that changes every frame, like a
+     * score or a timer. Reserve the capacity once and clear the string
+     * before formatting it again.
+     *
+     * If width is positive, the number is padded with leading zeros to
+     * that many digits (not counting the sign).
+     *
+     * @param dst       the string to append to
+     * @param value     the numeric value to convert
+     * @param width     the minimum number of digits
+     */
+    void append_int(std::string& dst, Sint64 value, size_t width=0);
+    
+    /**
+     * Appends the fixed-point representation of value to dst.
+     *
+     * Unlike {@link to_string}, this function does not create a new string.
+     * If dst has enough capacity, it does not allocate any memory at all.
+     * This makes it suitable for text that changes every frame, like a
+     * speedometer. Reserve the capacity once and clear the string before
+     * formatting it again.
+     *
+     * The value is rounded to the given number of digits after the decimal
+     * point. The precision is capped at 9 digits.
+     *
+     * @param dst       the string to append to
+     * @param value     the numeric value to convert
+     * @param precision the number of digits after the decimal point
+     */
+    void append_fixed(std::string& dst, double value, int precision);
+    
+    
 #pragma mark -
 #pragma mark STRING TO NUMBER FUNCTIONS
     /**
@@ -38,6 +38,7 @@
 #include <SDL/SDL.h>
 #include <condition_variable>
 #include <functional>
+#include <atomic>
 #include <stdio.h>
 #include <queue>
 #include <vector>
@@ -93,7 +94,7 @@ private:
     /** Whether or not the thread pool has been marked for shutdown */
     bool _stop;
     /** The number of child threads that are completed */
-    int _complete;
+    std::atomic<int> _complete;
     
     /**
      * The body function of a single thread.
@@ -219,7 +220,7 @@ public:
      *
      * @return whether the thread pool has been shut down.
      */
-    bool isShutdown() const { return _workers.size() == _complete; }
+    bool isShutdown() const { return _workers.size() == (size_t)_complete.load(); }
   
 private:  
     /** Copying is only allowed via shared pointer. */
@@ -0,0 +1,500 @@
+//
+//  CUAssetCache.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an on-disk cache of decoded assets. Decoding a PNG,
+//  rasterizing a font atlas, or decompressing an OGG is the bulk of the work
+//  of loading an asset, and it produces the same result every launch. This
+//  cache stores that result in the save directory, so that a warm start only
+//  has to read it back.
+//
+//  Entries are content addressed. The key is a hash of the source file
+//  together with the loader settings that affect the result. Changing either
+//  changes the key, so there is no need to invalidate anything. Entries are
+//  memory mapped when read, and validated against their header and checksum
+//  before use. An entry that fails validation is deleted and treated as a
+//  miss.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#include <cugl/assets/CUAssetCache.h>
+#include <cugl/base/CUApplication.h>
+#include <cugl/util/CUFiletools.h>
+#include <cugl/util/CUDebug.h>
+#include <cstring>
+#include <cstdio>
+
+using namespace cugl;
+
+/** "CUAC" as a little-endian word */
+#define CACHE_MAGIC     0x43415543
+/** Bump this whenever the entry header changes */
+#define CACHE_VERSION   1
+/** The suffix of an entry file */
+#define CACHE_SUFFIX    ".cache"
+/** The suffix of a temporary file (before it is renamed to an entry) */
+#define TEMP_SUFFIX     ".tmp"
+
+/** The default limit on the size of the cache directory (in bytes) */
+const Uint64 AssetCache::DEFAULT_LIMIT = 256*1024*1024;
+
+/** The header of an entry file (the payload follows immediately) */
+typedef struct {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 kind;
+    Uint32 reserved;
+    Uint64 key;
+    Uint64 size;
+    Uint64 checksum;
+    Uint64 padding;
+} EntryHeader;
+
+// The payload must be aligned for any type a loader stores in it
+static_assert(sizeof(EntryHeader) % 16 == 0, "Cache payloads must be 16 byte aligned");
+
+/**
+ * Returns true if the file name ends with the given suffix
+ *
+ * @param file      The file name
+ * @param suffix    The suffix to check
+ *
+ * @return true if the file name ends with the given suffix
+ */
+static bool has_suffix(const std::string& file, const std::string& suffix) {
+    return file.size() > suffix.size() &&
+           file.compare(file.size()-suffix.size(),suffix.size(),suffix) == 0;
+}
+
+#pragma mark -
+#pragma mark Hashing
+/** Hash multipliers (from MurmurHash3) */
+#define HASH_C1 0x87c37b91114253d5ULL
+#define HASH_C2 0x4cf5ad432745937fULL
+
+/**
+ * Returns the value rotated left by the given number of bits
+ *
+ * @param value The value to rotate
+ * @param bits  The number of bits (0 < bits < 64)
+ *
+ * @return the value rotated left by the given number of bits
+ */
+static inline Uint64 rotl(Uint64 value, int bits) {
+    return (value << bits) | (value >> (64-bits));
+}
+
+/**
+ * Returns the hash with its bits fully mixed
+ *
+ * @param h     The hash to finalize
+ *
+ * @return the hash with its bits fully mixed
+ */
+static inline Uint64 fmix(Uint64 h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * This class computes a hash incrementally.
+ *
+ * The hash of data fed in several pieces is the same as the hash of the
+ * concatenation, so a payload can be hashed segment by segment.
+ */
+class CacheHasher {
+private:
+    /** The current hash value */
+    Uint64 _hash;
+    /** The bytes of a word not yet complete */
+    Uint8 _tail[8];
+    /** The number of bytes in the tail */
+    size_t _count;
+    /** The total number of bytes hashed */
+    Uint64 _size;
+
+    /**
+     * Mixes a complete word into the hash
+     *
+     * @param k     The word to mix
+     */
+    void mix(Uint64 k) {
+        k *= HASH_C1;
+        k  = rotl(k,31);
+        k *= HASH_C2;
+        _hash ^= k;
+        _hash  = rotl(_hash,27)*5+0x52dce729;
+    }
+
+public:
+    /**
+     * Creates a hasher with the given seed
+     *
+     * @param seed  The initial hash value
+     */
+    CacheHasher(Uint64 seed) : _hash(seed), _count(0), _size(0) {}
+
+    /**
+     * Adds the given data to the hash
+     *
+     * @param data  The data to hash
+     * @param size  The number of bytes to hash
+     */
+    void update(const void* data, size_t size) {
+        const Uint8* bytes = (const Uint8*)data;
+        _size += size;
+        while (_count > 0 && size > 0) {
+            _tail[_count++] = *bytes++;
+            size--;
+            if (_count == 8) {
+                Uint64 k;
+                std::memcpy(&k, _tail, 8);
+                mix(k);
+                _count = 0;
+            }
+        }
+        for(; size >= 8; size -= 8, bytes += 8) {
+            Uint64 k;
+            std::memcpy(&k, bytes, 8);
+            mix(k);
+        }
+        for(; size > 0; size--) {
+            _tail[_count++] = *bytes++;
+        }
+    }
+
+    /**
+     * Returns the hash of all of the data added
+     *
+     * @return the hash of all of the data added
+     */
+    Uint64 finish() {
+        Uint64 k = 0;
+        for(size_t ii = 0; ii < _count; ii++) {
+            k |= ((Uint64)_tail[ii]) << (8*ii);
+        }
+        mix(k);
+        _hash ^= _size;
+        return fmix(_hash);
+    }
+};
+
+/**
+ * Returns a 64 bit hash of the given data.
+ *
+ * This hash is not cryptographic. It is only intended to detect changes
+ * to a file, and corruption of a cache entry.
+ *
+ * @param data  The data to hash
+ * @param size  The number of bytes to hash
+ * @param seed  The initial hash value
+ *
+ * @return a 64 bit hash of the given data.
+ */
+Uint64 AssetCache::hash(const void* data, size_t size, Uint64 seed) {
+    CacheHasher hasher(seed);
+    hasher.update(data, size);
+    return hasher.finish();
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates a degenerate cache with no directory.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+AssetCache::AssetCache() :
+_limit(0),
+_writes(0),
+_hits(0),
+_misses(0) {
+}
+
+/**
+ * Releases this cache. The entries on disk are not affected.
+ *
+ * This object may be safely reinitialized.
+ */
+void AssetCache::dispose() {
+    _directory.clear();
+    _limit = 0;
+    _writes.store(0);
+    _hits.store(0);
+    _misses.store(0);
+}
+
+/**
+ * Initializes a cache in the given directory.
+ *
+ * If the directory is a relative path, it is relative to the application
+ * save directory {@see Application#getSaveDirectory()}. The directory is
+ * created if it does not exist. If it exists, it is pruned to the given
+ * size limit.
+ *
+ * @param directory The cache directory
+ * @param limit     The size limit of the cache directory (in bytes)
+ *
+ * @return true if the cache is initialized properly, false otherwise.
+ */
+bool AssetCache::init(const std::string& directory, Uint64 limit) {
+    if (!_directory.empty()) {
+        CUAssertLog(false, "Cache %s is already initialized",_directory.c_str());
+        return false;
+    }
+    std::string path = directory;
+    if (!filetool::is_absolute(path)) {
+        path = Application::get()->getSaveDirectory()+path;
+    }
+    path = filetool::normalize_path(path);
+    if (!filetool::is_dir(path) && !filetool::dir_create(path)) {
+        CULogError("Could not create asset cache %s",path.c_str());
+        return false;
+    }
+    if (path.back() != filetool::path_sep) {
+        path.push_back(filetool::path_sep);
+    }
+    _directory = path;
+    _limit = limit;
+    prune();
+    return true;
+}
+
+/**
+ * Returns the path of the entry with the given key
+ *
+ * @param key   The entry key
+ *
+ * @return the path of the entry with the given key
+ */
+std::string AssetCache::getPath(Uint64 key) const {
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+    return _directory+name+CACHE_SUFFIX;
+}
+
+#pragma mark -
+#pragma mark Cache Access
+/**
+ * Returns the key for the given source file and loader settings.
+ *
+ * The key is a hash of the file contents and the settings string. The
+ * settings should include everything that affects the decoded result
+ * (such as the pixel format or the font size), together with a version
+ * number for the payload layout. This method returns 0 if the file
+ * cannot be read; 0 is never a valid key.
+ *
+ * @param file      The (full) path to the source file
+ * @param settings  The loader settings
+ *
+ * @return the key for the given source file and loader settings.
+ */
+Uint64 AssetCache::getKey(const std::string& file, const std::string& settings) const {
+    std::shared_ptr<MappedFile> source = MappedFile::alloc(file);
+    if (source == nullptr) {
+        return 0;
+    }
+    Uint64 result = hash(source->data(), source->size(), CACHE_VERSION);
+    result = hash(settings.data(), settings.size(), result);
+    return (result == 0 ? 1 : result);
+}
+
+/**
+ * Returns true if there is a valid entry for the given key.
+ *
+ * If the entry exists but is not valid (because it was truncated, or it
+ * is of a different kind), it is deleted and this method returns false.
+ *
+ * @param key   The entry key
+ * @param kind  The kind of asset expected
+ * @param entry The entry to store the result
+ *
+ * @return true if there is a valid entry for the given key.
+ */
+bool AssetCache::read(Uint64 key, Kind kind, Entry& entry) {
+    entry.file = nullptr;
+    entry.data = nullptr;
+    entry.size = 0;
+    if (_directory.empty() || key == 0) {
+        return false;
+    }
+
+    std::string path = getPath(key);
+    std::shared_ptr<MappedFile> file = MappedFile::alloc(path);
+    if (file == nullptr) {
+        _misses++;
+        return false;
+    }
+
+    const char* error = nullptr;
+    EntryHeader header;
+    if (file->size() < sizeof(EntryHeader)) {
+        error = "truncated header";
+    } else {
+        std::memcpy(&header, file->data(), sizeof(EntryHeader));
+        const Uint8* payload = file->data()+sizeof(EntryHeader);
+        size_t size = file->size()-sizeof(EntryHeader);
+        if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION) {
+            error = "unknown format";
+        } else if (header.key != key || header.kind != (Uint32)kind) {
+            error = "wrong key or kind";
+        } else if (header.size != size) {
+            error = "truncated payload";
+        } else if (hash(payload, size) != header.checksum) {
+            error = "bad checksum";
+        } else {
+            entry.file = file;
+            entry.data = payload;
+            entry.size = size;
+            _hits++;
+            return true;
+        }
+    }
+
+    CULogError("Discarding cache entry %s: %s",path.c_str(),error);
+    file = nullptr;
+    filetool::file_delete(path);
+    _misses++;
+    return false;
+}
+
+/**
+ * Stores an entry with the given key, returning true on success.
+ *
+ * The payload is the concatenation of the segments. The entry is written
+ * to a temporary file and then renamed, so a concurrent (or interrupted)
+ * write never leaves a partial entry behind.
+ *
+ * @param key       The entry key
+ * @param kind      The kind of asset stored
+ * @param segments  The payload segments
+ *
+ * @return true if the entry was stored.
+ */
+bool AssetCache::write(Uint64 key, Kind kind, std::initializer_list<Segment> segments) {
+    if (_directory.empty() || key == 0) {
+        return false;
+    }
+
+    EntryHeader header;
+    std::memset(&header, 0, sizeof(EntryHeader));
+    header.magic = CACHE_MAGIC;
+    header.version = CACHE_VERSION;
+    header.kind = (Uint32)kind;
+    header.key = key;
+
+    // The checksum covers the concatenated payload
+    CacheHasher hasher(0);
+    for(auto it = segments.begin(); it != segments.end(); ++it) {
+        hasher.update(it->data, it->size);
+        header.size += it->size;
+    }
+    header.checksum = hasher.finish();
+
+    std::string path = getPath(key);
+    std::string temp = path+"."+std::to_string(_writes++)+TEMP_SUFFIX;
+    SDL_RWops* stream = SDL_RWFromFile(temp.c_str(), "wb");
+    if (!stream) {
+        return false;
+    }
+    bool success = SDL_RWwrite(stream, &header, sizeof(EntryHeader), 1) == 1;
+    for(auto it = segments.begin(); success && it != segments.end(); ++it) {
+        success = it->size == 0 || SDL_RWwrite(stream, it->data, it->size, 1) == 1;
+    }
+    success = (SDL_RWclose(stream) == 0) && success;
+
+    if (success) {
+        // Windows will not rename over an existing file
+        std::remove(path.c_str());
+        success = std::rename(temp.c_str(), path.c_str()) == 0;
+    }
+    if (!success) {
+        std::remove(temp.c_str());
+    }
+    return success;
+}
+
+/**
+ * Deletes every entry in this cache.
+ *
+ * This method should not be called while assets are loading.
+ */
+void AssetCache::clear() {
+    if (_directory.empty()) {
+        return;
+    }
+    std::vector<std::string> files = filetool::dir_contents(_directory, [&](const std::string file) {
+        return has_suffix(file,CACHE_SUFFIX);
+    });
+    for(auto it = files.begin(); it != files.end(); ++it) {
+        filetool::file_delete(*it);
+    }
+}
+
+/**
+ * Deletes every entry if the cache is over its size limit.
+ *
+ * This also deletes any temporary files left behind by an interrupted
+ * write. It returns the number of bytes used by the entries that remain.
+ * This method is called when the cache is initialized, and should not be
+ * called while assets are loading.
+ *
+ * @return the number of bytes used by the entries that remain.
+ */
+Uint64 AssetCache::prune() {
+    if (_directory.empty()) {
+        return 0;
+    }
+    Uint64 total = 0;
+    std::vector<std::string> files = filetool::dir_contents(_directory);
+    for(auto it = files.begin(); it != files.end(); ++it) {
+        if (has_suffix(*it,TEMP_SUFFIX)) {
+            filetool::file_delete(*it);
+        } else if (has_suffix(*it,CACHE_SUFFIX)) {
+            total += filetool::file_size(*it);
+        }
+    }
+    if (total > _limit) {
+        // Stale entries cannot be told apart from live ones, so start over
+        CULog("Asset cache is %llu bytes (limit %llu); clearing it",
+              (unsigned long long)total,(unsigned long long)_limit);
+        clear();
+        total = 0;
+    }
+    return total;
+}
@@ -46,17 +46,21 @@
 //  Version: 5/20/19
 //
 #include <cugl/cugl.h>
+#include <unordered_set>
+#include <set>
+#include <algorithm>
 
 using namespace cugl;
 
 #pragma mark -
 #pragma mark Constructors
 /**
- * Initializes a new asset manager with two auxiliary threads.
+ * Initializes a new asset manager with a thread for each spare core.
  *
- * The asset manager will have a thread pool of size 2, giving it two
- * threads to load assets asynchronously.  These threads have no effect on
- * synchronous loading and will sleep when no assets are being loaded.
+ * The asset manager will have one thread for each core, less the core
+ * used by the main thread (but always at least one).  These threads have
+ * no effect on synchronous loading and will sleep when no assets are
+ * being loaded.
  *
  * This initializer does not attach any loaders.  It simply creates an
  * object that is ready to accept loader objects.
@@ -64,7 +68,27 @@ using namespace cugl;
  * @return true if the asset manager was initialized successfully
  */
 bool AssetManager::init() {
-    _workers = ThreadPool::alloc(1);
+    int cores = SDL_GetCPUCount();
+    return init(cores > 2 ? cores-1 : 1);
+}
+
+/**
+ * Initializes a new asset manager with the given number of auxiliary threads.
+ *
+ * The asset manager will have a thread pool of the given size, allowing it
+ * load assets asynchronously.  These threads have no effect on synchronous
+ * loading and will sleep when no assets are being loaded.  If threads is
+ * 0, all assets must be loaded synchronously.
+ *
+ * This initializer does not attach any loaders.  It simply creates an
+ * object that is ready to accept loader objects.
+ *
+ * @param threads   The number of threads for asynchronous loading
+ *
+ * @return true if the asset manager was initialized successfully
+ */
+bool AssetManager::init(unsigned int threads) {
+    _workers = (threads ? ThreadPool::alloc(threads) : nullptr);
     return true;
 }
 
@@ -77,7 +101,11 @@ bool AssetManager::init() {
  */
 void AssetManager::dispose() {
     detachAll();
+    _dependents.clear();
+    _deferred.clear();
+    _groups.clear();
     _workers = nullptr;
+    _cache = nullptr;
 }
 
 #pragma mark -
@@ -99,6 +127,9 @@ void AssetManager::dispose() {
  * contains an asset for which there is no attached asset manager, those
  * specific assets will not be loaded.
  *
+ * Assets that belong to a group in the "groups" entry are skipped, as
+ * they are loaded on first access instead.
+ *
  * @param hash  The hash of the asset type
  * @param json  The child of asset directory with these assets
  *
@@ -119,7 +150,9 @@ bool AssetManager::readCategory(size_t hash, const std::shared_ptr<JsonValue>& j
     bool success = true;
     for(int ii = 0; ii < json->size(); ii++) {
         std::shared_ptr<JsonValue> child = json->get(ii);
-        success = loader->load(child) && success;
+        if (!isDeferred(hash,child->key())) {
+            success = loader->load(child) && success;
+        }
     }
     
     return success;
@@ -142,6 +175,9 @@ bool AssetManager::readCategory(size_t hash, const std::shared_ptr<JsonValue>& j
  * contains an asset for which there is no attached asset manager, those
  * specific assets will not be loaded.
  *
+ * Assets that belong to a group in the "groups" entry are skipped, as
+ * they are loaded on first access instead.
+ *
  * As an asynchronous read, all asset loading will take place outside of
  * the main thread.  However, assets such as fonts and textures will need
  * the OpenGL context to complete, so part of their asset loading may take
@@ -161,7 +197,7 @@ bool AssetManager::readCategory(size_t hash, const std::shared_ptr<JsonValue>& j
 void AssetManager::readCategory(size_t hash, const std::shared_ptr<JsonValue>& json,
                                 LoaderCallback callback) {
     auto it = _handlers.find(hash);
-    std::shared_ptr<BaseLoader> loader = it->second;
+    std::shared_ptr<BaseLoader> loader = (it == _handlers.end() ? nullptr : it->second);
     if (loader == nullptr) {
         if (callback) {
             Application::get()->schedule([=] {
@@ -174,7 +210,9 @@ void AssetManager::readCategory(size_t hash, const std::shared_ptr<JsonValue>& j
     
     for(int ii = 0; ii < json->size(); ii++) {
         std::shared_ptr<JsonValue> child = json->get(ii);
-        loader->loadAsync(child, callback);
+        if (!isDeferred(hash,child->key())) {
+            loader->loadAsync(child, callback);
+        }
     }
 }
 
@@ -205,6 +243,14 @@ bool AssetManager::purgeCategory(size_t hash, const std::shared_ptr<JsonValue>&
     bool success = true;
     for(int ii = 0; ii < json->size(); ii++) {
         std::shared_ptr<JsonValue> child = json->get(ii);
+        auto jt = _deferred.find(Dependency(hash,child->key()));
+        if (jt != _deferred.end()) {
+            // Deferred assets need not be loaded
+            _deferred.erase(jt);
+            if (!loader->contains(child->key())) {
+                continue;
+            }
+        }
         success = loader->unload(child) && success;
     }
     
@@ -212,49 +258,371 @@ bool AssetManager::purgeCategory(size_t hash, const std::shared_ptr<JsonValue>&
 }
 
 /**
- * Synchronizes the asset manager to wait until all assets have finished.
+ * Adds every string in the given JSON tree to the set
  *
- * This method is necessary for assets whose construction depends on
- * previously loaded assets (e.g. scene graphs).  In the current architecture,
- * this method is only correct if the asset manager loads assets in a
- * single thread.
+ * @param json      The JSON tree
+ * @param strings   The set to store the strings
  */
-void AssetManager::sync() {
-    _workers->addTask([=](void) {
-        this->block();
-        this->block(); // Two blocks force one complete cycle
-    });
+static void collect_strings(const std::shared_ptr<JsonValue>& json, std::unordered_set<std::string>& strings) {
+    if (json->isString()) {
+        strings.emplace(json->asString());
+    }
+    for(int ii = 0; ii < json->size(); ii++) {
+        collect_strings(json->get(ii),strings);
+    }
 }
 
 /**
- * Blocks the asset manager until the next animation frame.
+ * Returns the dependencies of a scene graph in an asset directory
  *
- * Any assets queued after a block will not be added to thread pool
- * until at least one animation frame has passed.  This method is used
- * to implement the {@link sync()} method.
+ * A scene graph depends on every texture, font or widget in the directory
+ * whose key appears as a string in the scene JSON. The contents of a
+ * widget are not known until it is loaded. So if the scene uses a widget,
+ * it also depends on all of the textures and fonts in the directory.
+ *
+ * @param scene     The JSON for the scene graph
+ * @param directory The JSON asset directory
+ *
+ * @return the dependencies of a scene graph in an asset directory
  */
-void AssetManager::block() {
-    Application::get()->schedule([=](void){
-        this->resume();
+std::vector<AssetManager::Dependency> AssetManager::getDependencies(const std::shared_ptr<JsonValue>& scene,
+                                                                    const std::shared_ptr<JsonValue>& directory) const {
+    std::unordered_set<std::string> strings;
+    collect_strings(scene,strings);
+    
+    std::vector<Dependency> result;
+    std::shared_ptr<JsonValue> widgets = directory->get("widgets");
+    bool all = false;
+    if (widgets) {
+        size_t hash = typeid(WidgetValue).hash_code();
+        for(int ii = 0; ii < widgets->size(); ii++) {
+            std::string key = widgets->get(ii)->key();
+            if (strings.find(key) != strings.end()) {
+                result.push_back(Dependency(hash,key));
+                all = true;
+            }
+        }
+    }
+    
+    std::shared_ptr<JsonValue> category = directory->get("textures");
+    if (category) {
+        size_t hash = typeid(Texture).hash_code();
+        for(int ii = 0; ii < category->size(); ii++) {
+            std::string key = category->get(ii)->key();
+            if (all || strings.find(key) != strings.end()) {
+                result.push_back(Dependency(hash,key));
+            }
+        }
+    }
+    category = directory->get("fonts");
+    if (category) {
+        size_t hash = typeid(Font).hash_code();
+        for(int ii = 0; ii < category->size(); ii++) {
+            std::string key = category->get(ii)->key();
+            if (all || strings.find(key) != strings.end()) {
+                result.push_back(Dependency(hash,key));
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Assigns upload priorities to the textures of prioritized scene graphs
+ *
+ * A scene graph with an integer "priority" attribute passes that priority
+ * to every texture it depends on, unless the texture already has a higher
+ * one. This has no effect if the attached texture loader is not a
+ * {@link TextureLoader}.
+ *
+ * @param directory The JSON asset directory
+ */
+void AssetManager::prioritize(const std::shared_ptr<JsonValue>& directory) {
+    std::shared_ptr<JsonValue> scenes = directory->get("scene2s");
+    std::shared_ptr<JsonValue> entries = directory->get("textures");
+    auto it = _handlers.find(typeid(Texture).hash_code());
+    if (scenes == nullptr || entries == nullptr || it == _handlers.end()) {
+        return;
+    }
+    std::shared_ptr<TextureLoader> loader = std::dynamic_pointer_cast<TextureLoader>(it->second);
+    if (loader == nullptr) {
+        return;
+    }
+    
+    size_t hash = typeid(Texture).hash_code();
+    for(int ii = 0; ii < scenes->size(); ii++) {
+        std::shared_ptr<JsonValue> scene = scenes->get(ii);
+        if (!scene->has("priority")) {
+            continue;
+        }
+        int priority = scene->getInt("priority");
+        std::vector<Dependency> edges = getDependencies(scene,directory);
+        for(auto jt = edges.begin(); jt != edges.end(); ++jt) {
+            if (jt->first != hash) {
+                continue;
+            }
+            int current = std::max(loader->getPriority(jt->second),
+                                   entries->get(jt->second)->getInt("priority",0));
+            if (priority > current) {
+                loader->setPriority(jt->second,priority);
+            }
+        }
+    }
+}
+
+/**
+ * Returns true if the given dependency is still loading.
+ *
+ * A dependency on an asset that is not pending (because it has already
+ * loaded, it failed, or it was never requested) is resolved.
+ *
+ * @param edge  The dependency to check
+ *
+ * @return true if the given dependency is still loading.
+ */
+bool AssetManager::isPending(const Dependency& edge) const {
+    auto it = _handlers.find(edge.first);
+    return it != _handlers.end() && it->second->isPending(edge.second);
+}
+
+/**
+ * Starts the given load once all of its dependencies have finished.
+ *
+ * If the dependencies are already resolved, the load starts immediately.
+ * Otherwise it is checked at the start of each animation frame.
+ *
+ * @param edges The assets that must finish before the load starts
+ * @param task  The function to start the load
+ */
+void AssetManager::defer(const std::vector<Dependency>& edges, const std::function<void()>& task) {
+    bool ready = true;
+    for(auto it = edges.begin(); ready && it != edges.end(); ++it) {
+        ready = !isPending(*it);
+    }
+    if (ready) {
+        task();
+        return;
+    }
+    
+    Dependent item;
+    item.edges = edges;
+    item.task = task;
+    _dependents.push_back(item);
+    if (!_polling) {
+        _polling = true;
+        Application::get()->schedule([=](void) {
+            return this->resolve();
+        });
+    }
+}
+
+/**
+ * Starts any deferred loads whose dependencies have finished.
+ *
+ * This method is scheduled with {@link Application#schedule}, and so it
+ * returns true as long as there are loads still waiting.
+ *
+ * @return true if there are loads still waiting on dependencies
+ */
+bool AssetManager::resolve() {
+    // Started loads may defer more loads, so pull the ready ones out first
+    std::vector<std::function<void()>> ready;
+    for(auto it = _dependents.begin(); it != _dependents.end(); ) {
+        auto jt = it->edges.begin();
+        while (jt != it->edges.end() && !isPending(*jt)) {
+            ++jt;
+        }
+        if (jt == it->edges.end()) {
+            ready.push_back(it->task);
+            it = _dependents.erase(it);
+        } else {
+            it->edges.erase(it->edges.begin(),jt);
+            ++it;
+        }
+    }
+    
+    for(auto it = ready.begin(); it != ready.end(); ++it) {
+        (*it)();
+    }
+    _polling = !_dependents.empty();
+    return _polling;
+}
+
+/**
+ * Returns the type hash for the given asset directory category.
+ *
+ * This method returns 0 if the category name is not recognized.
+ *
+ * @param name  The category name (e.g. "textures")
+ *
+ * @return the type hash for the given asset directory category.
+ */
+size_t AssetManager::category(const std::string& name) {
+    if (name == "textures") {
+        return typeid(Texture).hash_code();
+    } else if (name == "sounds") {
+        return typeid(Sound).hash_code();
+    } else if (name == "fonts") {
+        return typeid(Font).hash_code();
+    } else if (name == "jsons") {
+        return typeid(JsonValue).hash_code();
+    } else if (name == "widgets") {
+        return typeid(WidgetValue).hash_code();
+    } else if (name == "scene2s") {
+        return typeid(scene2::SceneNode).hash_code();
+    }
+    return 0;
+}
+
+/**
+ * Records the asset groups declared by the given asset directory.
+ *
+ * Every asset in a group is marked to load on first access, so that it
+ * is skipped when the rest of the directory is loaded.
+ *
+ * @param directory The JSON asset directory
+ */
+void AssetManager::declareGroups(const std::shared_ptr<JsonValue>& directory) {
+    std::shared_ptr<JsonValue> groups = directory->get("groups");
+    if (groups == nullptr) {
+        return;
+    }
+    
+    for(int ii = 0; ii < groups->size(); ii++) {
+        std::shared_ptr<JsonValue> spec = groups->get(ii);
+        if (_groups.find(spec->key()) != _groups.end()) {
+            CULogError("Asset group '%s' is already declared",spec->key().c_str());
+            continue;
+        }
+        
+        Group& group = _groups[spec->key()];
+        group.refs = 0;
+        group.stamp = 0;
+        for(int jj = 0; jj < spec->size(); jj++) {
+            std::shared_ptr<JsonValue> keys = spec->get(jj);
+            std::shared_ptr<JsonValue> entries = directory->get(keys->key());
+            size_t hash = category(keys->key());
+            if (hash == 0 || entries == nullptr) {
+                CULogError("Unknown asset category '%s' in group '%s'",
+                           keys->key().c_str(),spec->key().c_str());
+                continue;
+            }
+            for(int kk = 0; kk < keys->size(); kk++) {
+                std::string key = keys->get(kk)->asString();
+                std::shared_ptr<JsonValue> entry = entries->get(key);
+                if (entry == nullptr) {
+                    CULogError("No asset '%s' for group '%s'",key.c_str(),spec->key().c_str());
+                    continue;
+                }
+                Dependency edge(hash,key);
+                Deferred& asset = _deferred[edge];
+                asset.entry = entry;
+                asset.directory = directory;
+                group.assets.push_back(edge);
+            }
+        }
+    }
+}
+
+/**
+ * Synchronously loads an asset that is loaded on first access.
+ *
+ * The key may also belong to a descendant of a scene graph, or to a
+ * subtexture of an atlas. In that case, the parent asset is loaded. This
+ * method fails if the asset is unknown, already loaded, or still loading
+ * asynchronously.
+ *
+ * @param hash  The hash of the asset type
+ * @param key   The asset key
+ *
+ * @return true if an asset was loaded
+ */
+bool AssetManager::fetch(size_t hash, const std::string& key) const {
+    auto it = _deferred.find(Dependency(hash,key));
+    
+    // Children are keyed by the path from their parent
+    size_t pos = key.find('_');
+    while (it == _deferred.end() && pos != std::string::npos) {
+        it = _deferred.find(Dependency(hash,key.substr(0,pos)));
+        pos = key.find('_',pos+1);
+    }
+    auto jt = _handlers.find(hash);
+    if (it == _deferred.end() || jt == _handlers.end()) {
+        return false;
+    }
+    
+    const std::string& name = it->first.second;
+    std::shared_ptr<BaseLoader> loader = jt->second;
+    if (loader->contains(name)) {
+        return false;
+    } else if (loader->isPending(name)) {
+        CULogError("Asset '%s' was accessed while still loading",name.c_str());
         return false;
-    });
-    _wait = true;
-    while (_wait) {
-        int delay = (int)(500/Application::get()->getFPS());
-        SDL_Delay(delay);
     }
-    return;
+    
+    trim();
+    if (it->second.entry == nullptr) {
+        return loader->load(name,it->second.source);
+    }
+    return loader->load(it->second.entry);
 }
 
 /**
- * Resumes a previously blocked the asset manager.
+ * Unloads groups that are not acquired until memory is within budget.
  *
- * Any assets queued after a block will not be added to thread pool
- * until at least one animation frame has passed.  This method is used
- * to implement the {@link sync()} method.
+ * The budget applies to {@link #getIdleMemory}, so the assets of the
+ * acquired groups do not count against it. Groups are unloaded least
+ * recently used first. An asset is never unloaded while an acquired
+ * group contains it, and a group is never unloaded while any of its
+ * assets are still loading.
+ *
+ * This method is called before any asset is loaded on first access,
+ * and so it must be const like {@link #get}. It only changes the state
+ * of the loaders.
  */
-void AssetManager::resume() {
-    _wait = false;
+void AssetManager::trim() const {
+    if (_groups.empty() || _budget == SIZE_MAX) {
+        return;
+    }
+    size_t usage = getIdleMemory();
+    if (usage <= _budget) {
+        return;
+    }
+    
+    std::vector<std::pair<Uint64,const Group*>> victims;
+    for(auto it = _groups.begin(); it != _groups.end(); ++it) {
+        if (it->second.refs == 0) {
+            victims.push_back(std::make_pair(it->second.stamp,&(it->second)));
+        }
+    }
+    std::sort(victims.begin(), victims.end(), [](const std::pair<Uint64,const Group*>& a,
+                                                 const std::pair<Uint64,const Group*>& b) {
+        return a.first < b.first;
+    });
+    
+    for(auto it = victims.begin(); usage > _budget && it != victims.end(); ++it) {
+        const Group* group = it->second;
+        bool loading = false;
+        for(auto jt = group->assets.begin(); !loading && jt != group->assets.end(); ++jt) {
+            loading = isPending(*jt);
+        }
+        if (loading) {
+            continue;
+        }
+        
+        for(auto jt = group->assets.begin(); jt != group->assets.end(); ++jt) {
+            auto kt = _handlers.find(jt->first);
+            auto lt = _deferred.find(*jt);
+            if (kt == _handlers.end() || lt == _deferred.end() || lt->second.refs > 0 ||
+                !kt->second->contains(jt->second)) {
+                continue;
+            }
+            size_t bytes = kt->second->getAssetMemory(jt->second);
+            if (kt->second->unload(lt->second.entry)) {
+                usage -= std::min(bytes,usage);
+            }
+        }
+    }
 }
 
 #pragma mark -
@@ -276,6 +644,9 @@ void AssetManager::resume() {
  * contains an asset for which there is no attached asset manager, those
  * specific assets will not be loaded.
  *
+ * Assets that belong to a group in the "groups" entry are skipped, as
+ * they are loaded on first access instead.
+ *
  * This method will try to load as many assets from the directory as it
  * can.  If any asset fails to load, it will return false.  However, some
  * assets may still be loaded and safe to access.
@@ -285,6 +656,7 @@ void AssetManager::resume() {
  * @return true if all assets specified in the directory were successfully loaded.
  */
 bool AssetManager::loadDirectory(const std::shared_ptr<JsonValue>& json) {
+    declareGroups(json);
     bool success = true;
     for(int ii = 0; ii < json->size(); ii++) {
         std::shared_ptr<JsonValue> child = json->get(ii);
@@ -300,7 +672,7 @@ bool AssetManager::loadDirectory(const std::shared_ptr<JsonValue>& json) {
 			success = readCategory(typeid(WidgetValue).hash_code(), child) && success;
         } else if (child->key() == "scene2s") {
             success = readCategory(typeid(scene2::SceneNode).hash_code(),child) && success;
-        } else {
+        } else if (child->key() != "groups") {
             CULogError("Unknown asset category '%s'",child->key().c_str());
             success = false;
         }
@@ -325,6 +697,9 @@ bool AssetManager::loadDirectory(const std::shared_ptr<JsonValue>& json) {
  * contains an asset for which there is no attached asset manager, those
  * specific assets will not be loaded.
  *
+ * Assets that belong to a group in the "groups" entry are skipped, as
+ * they are loaded on first access instead.
+ *
  * This method will try to load as many assets from the directory as it
  * can.  If any asset fails to load, it will return false.  However, some
  * assets may still be loaded and safe to access.
@@ -334,7 +709,7 @@ bool AssetManager::loadDirectory(const std::shared_ptr<JsonValue>& json) {
  * @return true if all assets specified in the directory were successfully loaded.
  */
 bool AssetManager::loadDirectory(const std::string& directory) {
-    std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(directory);
+    std::shared_ptr<JsonReader> reader = JsonReader::allocMappedWithAsset(directory);
     if (reader == nullptr) {
         CULogError("No asset directory located at '%s'",directory.c_str());
         return false;
@@ -361,6 +736,9 @@ bool AssetManager::loadDirectory(const std::string& directory) {
  * contains an asset for which there is no attached asset manager, those
  * specific assets will not be loaded.
  *
+ * Assets that belong to a group in the "groups" entry are skipped, as
+ * they are loaded on first access instead.
+ *
  * As an asynchronous load, all asset loading will take place outside of
  * the main thread.  However, assets such as fonts and textures will need
  * the OpenGL context to complete, so part of their asset loading may take
@@ -377,6 +755,8 @@ bool AssetManager::loadDirectory(const std::string& directory) {
  * @param callback  An optional callback after each asset is loaded
  */
 void AssetManager::loadDirectoryAsync(const std::shared_ptr<JsonValue>& json, LoaderCallback callback) {
+    declareGroups(json);
+    prioritize(json);
     for(int ii = 0; ii < json->size(); ii++) {
         std::shared_ptr<JsonValue> child = json->get(ii);
         if (child->key() == "textures") {
@@ -389,16 +769,31 @@ void AssetManager::loadDirectoryAsync(const std::shared_ptr<JsonValue>& json, Lo
             readCategory(typeid(JsonValue).hash_code(),child,callback);
         } else if (child->key() == "widgets") {
             readCategory(typeid(WidgetValue).hash_code(),child,callback);
-        } else if (child->key() != "scene2s") {
+        } else if (child->key() != "scene2s" && child->key() != "groups") {
             CULogError("Unknown asset category '%s'",child->key().c_str());
         }
     }
     
-    // Scenes are read after everything else.
+    // Scenes wait on the assets that they reference.
     std::shared_ptr<JsonValue> child = json->get("scene2s");
-    sync();
     if (child) {
-        readCategory(typeid(scene2::SceneNode).hash_code(),child,callback);
+        size_t hash = typeid(scene2::SceneNode).hash_code();
+        auto it = _handlers.find(hash);
+        if (it == _handlers.end()) {
+            readCategory(hash,child,callback);
+            return;
+        }
+        
+        std::shared_ptr<BaseLoader> loader = it->second;
+        for(int ii = 0; ii < child->size(); ii++) {
+            std::shared_ptr<JsonValue> scene = child->get(ii);
+            if (isDeferred(hash,scene->key())) {
+                continue;
+            }
+            defer(getDependencies(scene,json),[=](void) {
+                loader->loadAsync(scene,callback);
+            });
+        }
     }
 }
 
@@ -419,6 +814,9 @@ void AssetManager::loadDirectoryAsync(const std::shared_ptr<JsonValue>& json, Lo
  * contains an asset for which there is no attached asset manager, those
  * specific assets will not be loaded.
  *
+ * Assets that belong to a group in the "groups" entry are skipped, as
+ * they are loaded on first access instead.
+ *
  * As an asynchronous load, all asset loading will take place outside of
  * the main thread.  However, assets such as fonts and textures will need
  * the OpenGL context to complete, so part of their asset loading may take
@@ -437,16 +835,26 @@ void AssetManager::loadDirectoryAsync(const std::shared_ptr<JsonValue>& json, Lo
 void AssetManager::loadDirectoryAsync(const std::string& directory, LoaderCallback callback) {
     _preload = true;
     
-    std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(directory);
+    std::shared_ptr<JsonReader> reader = JsonReader::allocMappedWithAsset(directory);
     if (reader == nullptr && callback != nullptr) {
         callback("",false);
         return;
     }
     
+    if (_workers == nullptr) {
+        loadDirectoryAsync(reader->readJson(),callback);
+        _preload = false;
+        return;
+    }
+    
+    // Parse in a worker, but queue the assets in the main thread
     _workers->addTask([=](void) {
         std::shared_ptr<JsonValue> json = reader->readJson();
-        loadDirectoryAsync(json,callback);
-        _preload = false;
+        Application::get()->schedule([=](void) {
+            this->loadDirectoryAsync(json,callback);
+            this->_preload = false;
+            return false;
+        });
     });
 }
 
@@ -476,6 +884,10 @@ bool AssetManager::unloadDirectory(const std::shared_ptr<JsonValue>& json) {
             success = purgeCategory(typeid(WidgetValue).hash_code(),child) && success;
         } else if (child->key() == "scene2s") {
             success = purgeCategory(typeid(scene2::SceneNode).hash_code(),child) && success;
+        } else if (child->key() == "groups") {
+            for(int jj = 0; jj < child->size(); jj++) {
+                _groups.erase(child->get(jj)->key());
+            }
         } else {
             CULogError("Unknown asset category '%s'",child->key().c_str());
             success = false;
@@ -496,7 +908,7 @@ bool AssetManager::unloadDirectory(const std::shared_ptr<JsonValue>& json) {
  * @param directory The path to the JSON asset directory
  */
 bool AssetManager::unloadDirectory(const std::string& directory) {
-    std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(directory);
+    std::shared_ptr<JsonReader> reader = JsonReader::allocMappedWithAsset(directory);
     if (reader == nullptr) {
         CULogError("No asset directory located at '%s'",directory.c_str());
         return false;
@@ -506,6 +918,176 @@ bool AssetManager::unloadDirectory(const std::string& directory) {
     return unloadDirectory(json);
 }
 
+#pragma mark -
+#pragma mark Residency
+/**
+ * Acquires the asset group with the given name.
+ *
+ * A group is acquired by the scenes that use it, and its assets are not
+ * unloaded until every acquire has a matching {@link #release}. This
+ * method does not load anything; the assets are loaded on first access
+ * (or by {@link #prefetch}).
+ *
+ * A scene should acquire all of its groups before accessing any assets.
+ * That way, the first asset load can evict the groups of the previous
+ * scene without touching those of this one.
+ *
+ * @param group The name of the asset group
+ *
+ * @return true if the group exists
+ */
+bool AssetManager::acquire(const std::string& group) {
+    auto it = _groups.find(group);
+    if (it == _groups.end()) {
+        CULogError("Unknown asset group '%s'",group.c_str());
+        return false;
+    }
+    
+    if (it->second.refs++ == 0) {
+        for(auto jt = it->second.assets.begin(); jt != it->second.assets.end(); ++jt) {
+            auto kt = _deferred.find(*jt);
+            if (kt != _deferred.end()) {
+                kt->second.refs++;
+            }
+        }
+    }
+    it->second.stamp = ++_clock;
+    return true;
+}
+
+/**
+ * Releases the asset group with the given name.
+ *
+ * Once a group is released as many times as it was acquired, its assets
+ * may be unloaded to stay within the memory budget. This does not happen
+ * immediately, but the next time that an asset is loaded. Groups are
+ * unloaded least recently used first, so recently used groups are the
+ * most likely to stay resident.
+ *
+ * @param group The name of the asset group
+ *
+ * @return true if the group was acquired
+ */
+bool AssetManager::release(const std::string& group) {
+    auto it = _groups.find(group);
+    if (it == _groups.end() || it->second.refs == 0) {
+        return false;
+    }
+    
+    if (--it->second.refs == 0) {
+        for(auto jt = it->second.assets.begin(); jt != it->second.assets.end(); ++jt) {
+            auto kt = _deferred.find(*jt);
+            if (kt != _deferred.end()) {
+                kt->second.refs--;
+            }
+        }
+        it->second.stamp = ++_clock;
+    }
+    return true;
+}
+
+/**
+ * Asynchronously loads the assets of the given group.
+ *
+ * This is a hint that the group will be needed soon (such as the next
+ * scene). Prefetching does not acquire the group. If the group is not
+ * acquired before it is evicted, it is simply loaded again on access.
+ * If the group is not declared yet because an asset directory is still
+ * being read, the prefetch starts once it is read.
+ *
+ * The optional callback function will be called each time an individual
+ * asset loads or fails to load.
+ *
+ * @param group     The name of the asset group
+ * @param callback  An optional callback after each asset is loaded
+ *
+ * @return true if the group exists
+ */
+bool AssetManager::prefetch(const std::string& group, LoaderCallback callback) {
+    auto it = _groups.find(group);
+    if (it == _groups.end() && _preload) {
+        // Try again once the directory declaring the group is read
+        Application::get()->schedule([=](void) {
+            if (this->_preload) {
+                return true;
+            }
+            this->prefetch(group,callback);
+            return false;
+        });
+        return true;
+    } else if (it == _groups.end()) {
+        CULogError("Unknown asset group '%s'",group.c_str());
+        return false;
+    }
+    
+    // Count this as a use, so the group is the last to be evicted
+    it->second.stamp = ++_clock;
+    
+    // Eviction only happens ahead of a load, so skip it if nothing is missing
+    bool missing = false;
+    for(auto jt = it->second.assets.begin(); !missing && jt != it->second.assets.end(); ++jt) {
+        auto kt = _handlers.find(jt->first);
+        missing = (kt != _handlers.end() && _deferred.find(*jt) != _deferred.end() &&
+                   !kt->second->contains(jt->second) && !isPending(*jt));
+    }
+    if (!missing) {
+        return true;
+    }
+    trim();
+    
+    size_t scenes = typeid(scene2::SceneNode).hash_code();
+    for(auto jt = it->second.assets.begin(); jt != it->second.assets.end(); ++jt) {
+        auto kt = _handlers.find(jt->first);
+        auto lt = _deferred.find(*jt);
+        if (kt == _handlers.end() || lt == _deferred.end() ||
+            kt->second->contains(jt->second) || isPending(*jt)) {
+            continue;
+        }
+        
+        std::shared_ptr<BaseLoader> loader = kt->second;
+        std::shared_ptr<JsonValue> entry = lt->second.entry;
+        std::shared_ptr<JsonValue> directory = lt->second.directory;
+        if (jt->first == scenes) {
+            // Scenes wait on the assets that they reference.
+            defer(getDependencies(entry,directory),[=](void) {
+                if (!loader->contains(entry->key())) {
+                    loader->loadAsync(entry,callback);
+                }
+            });
+        } else {
+            loader->loadAsync(entry,callback);
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns true if no asset of the given group is still loading.
+ *
+ * Once this method is true, {@link #get} may safely be called on any
+ * asset in the group, as any asset that is not loaded is loaded on the
+ * spot.
+ *
+ * @param group The name of the asset group
+ *
+ * @return true if no asset of the given group is still loading.
+ */
+bool AssetManager::isReady(const std::string& group) const {
+    auto it = _groups.find(group);
+    if (it == _groups.end()) {
+        return true;
+    }
+    
+    // A deferred scene is not pending until its dependencies finish
+    size_t scenes = typeid(scene2::SceneNode).hash_code();
+    for(auto jt = it->second.assets.begin(); jt != it->second.assets.end(); ++jt) {
+        if (isPending(*jt) || (jt->first == scenes && !_dependents.empty())) {
+            return false;
+        }
+    }
+    return true;
+}
+
 #pragma mark -
 #pragma mark Progress Monitoring
 /**
@@ -546,5 +1128,51 @@ size_t AssetManager::waitCount() const {
     for(auto it = _handlers.begin(); it != _handlers.end(); ++it) {
         result += it->second->waitCount();
     }
+    result += _dependents.size();
     return _preload ? result+1 : result;
 }
+
+/**
+ * Returns the number of bytes used by all of the loaded assets.
+ *
+ * This is the sum of the memory used by every attached loader.
+ *
+ * @return the number of bytes used by all of the loaded assets.
+ */
+size_t AssetManager::getMemoryUsage() const {
+    size_t result = 0;
+    for(auto it = _handlers.begin(); it != _handlers.end(); ++it) {
+        result += it->second->getMemoryUsage();
+    }
+    return result;
+}
+
+/**
+ * Returns the number of bytes used by the assets of idle groups.
+ *
+ * An idle group is one that is not acquired. This counts the loaded
+ * assets of the idle groups that no acquired group also contains, each
+ * asset once. These are the assets that may be unloaded, and this is the
+ * value compared against the memory budget.
+ *
+ * @return the number of bytes used by the assets of idle groups.
+ */
+size_t AssetManager::getIdleMemory() const {
+    std::set<Dependency> counted;
+    size_t result = 0;
+    for(auto it = _groups.begin(); it != _groups.end(); ++it) {
+        if (it->second.refs > 0) {
+            continue;
+        }
+        for(auto jt = it->second.assets.begin(); jt != it->second.assets.end(); ++jt) {
+            auto kt = _handlers.find(jt->first);
+            auto lt = _deferred.find(*jt);
+            if (kt == _handlers.end() || lt == _deferred.end() || lt->second.refs > 0 ||
+                !kt->second->contains(jt->second) || !counted.insert(*jt).second) {
+                continue;
+            }
+            result += kt->second->getAssetMemory(jt->second);
+        }
+    }
+    return result;
+}
@@ -44,8 +44,11 @@
 //  Version: 1/7/16
 //
 #include <cugl/assets/CUFontLoader.h>
+#include <cugl/assets/CUAssetCache.h>
 #include <cugl/base/CUApplication.h>
 #include <SDL/SDL_ttf.h>
+#include <unordered_set>
+#include <mutex>
 
 using namespace cugl;
 
@@ -55,6 +58,11 @@ using namespace cugl;
 #define UNKNOWN_CHARS   ""
 /** The default character set (ASCII) */
 #define UNKNOWN_SIZE    12
+/** The size of the reference font for a distance field atlas */
+#define DISTANCE_SIZE   64
+
+/** SDL_ttf shares one FreeType library, so fonts are preloaded one at a time */
+static std::mutex g_fontlock;
 
 #pragma mark -
 #pragma mark Constructor
@@ -81,13 +89,24 @@ _charset(UNKNOWN_CHARS) {
  * Hence this method does the maximum amount of work that can be done in
  * asynchronous font loading.
  *
+ * If there is an asset cache, the atlas image and glyph metrics are read
+ * from the cache when it has an entry for this font. Otherwise they are
+ * stored in the cache once the atlas is built.
+ *
+ * If distance is true, the font shares a distance field atlas with every
+ * other distance field font of the same file and character set. That atlas
+ * is rasterized once, at a reference size, and only the glyph metrics are
+ * computed for this size.
+ *
  * @param source    The pathname to the asset
  * @param charset   The atlas character set
- * @param charset   The font size
+ * @param size      The font size
+ * @param distance  Whether to use a distance field atlas
  *
  * @return the font asset with no generated atlas
  */
-std::shared_ptr<Font> FontLoader::preload(const std::string& source, const std::string& charset, int size) {
+std::shared_ptr<Font> FontLoader::preload(const std::string& source, const std::string& charset,
+                                          int size, bool distance) {
     // Make sure we reference the asset directory
 #if defined (__WINDOWS__)
     bool absolute = (bool)strstr(source.c_str(),":") || source[0] == '\\';
@@ -98,9 +117,32 @@ std::shared_ptr<Font> FontLoader::preload(const std::string& source, const std::
     
     std::string path = Application::get()->getAssetDirectory();
     path.append(source);
+    std::lock_guard<std::mutex> lock(g_fontlock);
     std::shared_ptr<Font> result = Font::alloc(path.c_str(),size);
     if (result == nullptr) {
         return result;
+    } else if (distance) {
+        std::shared_ptr<Font> field = preloadField(path, charset);
+        if (field == nullptr || !result->shareAtlas(field)) {
+            return nullptr;
+        }
+        return result;
+    }
+    
+    // The atlas depends on everything that affects rasterization
+    Uint64 key = 0;
+    if (_cache != nullptr) {
+        std::string settings = "font/2/"+std::to_string(size);
+        settings += "/"+std::to_string(*result->getStyle());
+        settings += "/"+std::to_string((int)result->getHinting());
+        settings += "/"+std::to_string((int)result->getResolution());
+        settings += "/"+charset;
+        key = _cache->getKey(path, settings);
+        AssetCache::Entry entry;
+        if (_cache->read(key, AssetCache::Kind::FONT, entry) &&
+            result->decodeAtlas(entry.data, entry.size)) {
+            return result;
+        }
     }
     
     if (charset.empty()) {
@@ -108,7 +150,78 @@ std::shared_ptr<Font> FontLoader::preload(const std::string& source, const std::
     } else {
         result->buildAtlasAsync(charset);
     }
-   
+    
+    std::vector<Uint8> data;
+    if (key != 0 && result->encodeAtlas(data)) {
+        _cache->write(key, AssetCache::Kind::FONT, { { data.data(), data.size() } });
+    }
+    return result;
+}
+
+/**
+ * Returns the distance field reference font for the given file
+ *
+ * The reference font is created (and its atlas built) the first time it is
+ * requested. It is shared by every distance field font with the same file
+ * and character set, regardless of their size. This loader does not own
+ * the reference font. It is released with the last font that shares it,
+ * and is built again (or read from the asset cache) if it is requested
+ * after that. The caller must hold the font lock.
+ *
+ * @param path      The (full) path to the font file
+ * @param charset   The atlas character set
+ *
+ * @return the distance field reference font for the given file
+ */
+std::shared_ptr<Font> FontLoader::preloadField(const std::string& path, const std::string& charset) {
+    std::string name = path+"/"+charset;
+    auto it = _fields.find(name);
+    if (it != _fields.end()) {
+        std::shared_ptr<Font> field = it->second.lock();
+        if (field != nullptr) {
+            return field;
+        }
+        _fields.erase(it);
+    }
+    
+    std::shared_ptr<Font> result = Font::alloc(path.c_str(),DISTANCE_SIZE);
+    if (result == nullptr) {
+        return result;
+    }
+    
+    Uint64 key = 0;
+    bool cached = false;
+    if (_cache != nullptr) {
+        std::string settings = "font/2/distance/"+std::to_string(DISTANCE_SIZE);
+        settings += "/"+std::to_string(*result->getStyle());
+        settings += "/"+std::to_string((int)result->getHinting());
+        settings += "/"+std::to_string((int)result->getResolution());
+        settings += "/"+charset;
+        key = _cache->getKey(path, settings);
+        AssetCache::Entry entry;
+        cached = (_cache->read(key, AssetCache::Kind::FONT, entry) &&
+                  result->decodeAtlas(entry.data, entry.size) &&
+                  result->isDistanceField());
+    }
+    
+    if (!cached) {
+        bool success;
+        if (charset.empty()) {
+            success = result->buildDistanceAtlasAsync(_loader);
+        } else {
+            success = result->buildDistanceAtlasAsync(charset,_loader);
+        }
+        if (!success) {
+            return nullptr;
+        }
+        
+        std::vector<Uint8> data;
+        if (key != 0 && result->encodeAtlas(data)) {
+            _cache->write(key, AssetCache::Kind::FONT, { { data.data(), data.size() } });
+        }
+    }
+    
+    _fields[name] = result;
     return result;
 }
 
@@ -172,7 +285,7 @@ bool FontLoader::read(const std::string& key, const std::string& source, int siz
     
     bool success = false;
     if (_loader == nullptr || !async) {
-        std::shared_ptr<Font> font = preload(source,_charset,size);
+        std::shared_ptr<Font> font = preload(source,_charset,size,false);
         if (font != nullptr) {
             success = true;
             materialize(key,font,callback);
@@ -181,7 +294,7 @@ bool FontLoader::read(const std::string& key, const std::string& source, int siz
         }
     } else {
         _loader->addTask([=](void) {
-            std::shared_ptr<Font> font = this->preload(source,_charset,size);
+            std::shared_ptr<Font> font = this->preload(source,_charset,size,false);
             Application::get()->schedule([=](void){
                 this->materialize(key,font,callback);
                 return false;
@@ -209,6 +322,7 @@ bool FontLoader::read(const std::string& key, const std::string& source, int siz
  *      "file":         The path to the asset
  *      "size":         This font size (int)
  *      "charset":      The set of characters for the font atlas (string)
+ *      "distance":     Whether to share a distance field atlas (bool)
  *
  * @param json      The directory entry for the asset
  * @param callback  An optional callback for asynchronous loading
@@ -226,10 +340,11 @@ bool FontLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback cal
     std::string source  = json->getString("file",UNKNOWN_SOURCE);
     std::string charset = json->getString("charset",UNKNOWN_CHARS);
     int size = json->getInt("size",UNKNOWN_SIZE);
+    bool distance = json->getBool("distance",false);
     
     bool success = false;
     if (_loader == nullptr || !async) {
-        std::shared_ptr<Font> font = preload(source,charset,size);
+        std::shared_ptr<Font> font = preload(source,charset,size,distance);
         if (font != nullptr) {
             success = true;
             materialize(key,font,callback);
@@ -238,7 +353,7 @@ bool FontLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback cal
         }
     } else {
         _loader->addTask([=](void) {
-            std::shared_ptr<Font> font = this->preload(source,charset,size);
+            std::shared_ptr<Font> font = this->preload(source,charset,size,distance);
             Application::get()->schedule([=](void){
                 this->materialize(key,font,callback);
                 return false;
@@ -248,3 +363,47 @@ bool FontLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback cal
     
     return success;
 }
+
+/**
+ * Returns the number of bytes used by the font for the given key.
+ *
+ * This is the size of the font atlas texture. A distance field font
+ * reports the size of the atlas that it shares.
+ *
+ * @param key   The key associated with the font
+ *
+ * @return the number of bytes used by the font for the given key.
+ */
+size_t FontLoader::measure(const std::string& key) const {
+    auto it = _assets.find(key);
+    if (it == _assets.end()) {
+        return 0;
+    }
+    std::shared_ptr<Texture> atlas = it->second->getAtlas();
+    if (atlas == nullptr) {
+        return 0;
+    }
+    return (size_t)atlas->getWidth()*atlas->getHeight()*atlas->getByteSize();
+}
+
+#pragma mark -
+#pragma mark Memory Usage
+/**
+ * Returns the number of bytes used by all of the loaded fonts.
+ *
+ * This is the size of the font atlas textures. An atlas shared by
+ * several distance field fonts is only counted once.
+ *
+ * @return the number of bytes used by all of the loaded fonts.
+ */
+size_t FontLoader::getMemoryUsage() const {
+    std::unordered_set<Texture*> atlases;
+    size_t result = 0;
+    for(auto it = _assets.begin(); it != _assets.end(); ++it) {
+        std::shared_ptr<Texture> atlas = it->second->getAtlas();
+        if (atlas != nullptr && atlases.emplace(atlas.get()).second) {
+            result += (size_t)atlas->getWidth()*atlas->getHeight()*atlas->getByteSize();
+        }
+    }
+    return result;
+}
@@ -44,44 +44,13 @@
 #include <cugl/assets/CUJsonValue.h>
 #include <cugl/util/CUDebug.h>
 #include <cugl/util/CUStrings.h>
+#include <cugl/io/CUJsonParser.h>
+#include <cstring>
 
 using namespace cugl;
 
-/**
- * Returns the line of JSON with the offending error.
- *
- * Error messages in this library correspond to the tail of the JSON after the error is encounterd.  These
- * can be hard to read if the error happens early.  This function truncates the error to only include the
- * first line of the error.  It also indicates (via the reference variable) the line on which the error occurred.
- *
- * @param data      The JSON value being parsed
- * @param error     The tail of the JSON after encountering an error
- * @param lineno    The variable to store the line number
- *
- * @return the line of JSON with the offending error.
- */
-std::string isolate_error(const char* data, const char* error, int& lineno) {
-    lineno = 1;
-    const char* pos = data;
-    while (pos != error) {
-        if (*pos == '\n') {
-            lineno++;
-        }
-        pos++;
-    }
-    size_t len = 0;
-    bool goon = true;
-    pos = error;
-    while (*pos && goon) {
-        if (*pos == '\n') {
-            goon = false;
-        } else {
-            len++;
-        }
-        pos++;
-    }
-    return std::string(error,len);
-}
+/** The number of children for an object to use a hash index */
+#define INDEX_THRESHOLD 8
 
 #pragma mark -
 #pragma mark JSON Conversions
@@ -181,6 +150,7 @@ std::shared_ptr<JsonValue> JsonValue::toJsonValue(const cJSON* node) {
         }
     }
     result->_children.assign(items.begin(),items.end());
+    result->reindex();
     
     return result;
 }
@@ -221,6 +191,7 @@ void JsonValue::toJsonValue(JsonValue* value, const cJSON* node) {
         }
     }
     value->_children.assign(items.begin(),items.end());
+    value->reindex();
 }
 
 /**
@@ -278,6 +249,99 @@ cJSON* JsonValue::toCJSON(const JsonValue* value) {
     return result;
 }
 
+#pragma mark -
+#pragma mark Key Index
+/**
+ * Returns the position of the child with the given key (or -1 if none)
+ *
+ * Objects with many children use a hash index, while small objects are
+ * searched linearly. If there is more than one child with the key, this
+ * returns the first one.
+ *
+ * @param key   The key identifying the child
+ *
+ * @return the position of the child with the given key (or -1 if none)
+ */
+int JsonValue::find(std::string_view key) const {
+    if (_index.empty()) {
+        for(size_t ii = 0; ii < _children.size(); ii++) {
+            if (_children[ii]->_key == key) {
+                return (int)ii;
+            }
+        }
+        return -1;
+    }
+    
+    size_t mask = _index.size()-1;
+    size_t slot = std::hash<std::string_view>()(key) & mask;
+    while (_index[slot]) {
+        Uint32 pos = _index[slot]-1;
+        if (_children[pos]->_key == key) {
+            return (int)pos;
+        }
+        slot = (slot+1) & mask;
+    }
+    return -1;
+}
+
+/**
+ * Rebuilds the hash index of the children
+ *
+ * This must be called whenever the children are reordered or rekeyed.
+ * The index is discarded if this node is not a large object.
+ */
+void JsonValue::reindex() {
+    _index.clear();
+    if (_type != Type::ObjectType || _children.size() < INDEX_THRESHOLD) {
+        return;
+    }
+    
+    // Keep the load factor at most 1/2
+    size_t capacity = 2*INDEX_THRESHOLD;
+    while (capacity < 2*_children.size()) {
+        capacity <<= 1;
+    }
+    _index.resize(capacity,0);
+    
+    size_t mask = capacity-1;
+    for(size_t ii = 0; ii < _children.size(); ii++) {
+        const std::string& key = _children[ii]->_key;
+        size_t slot = std::hash<std::string_view>()(key) & mask;
+        bool unique = true;
+        while (unique && _index[slot]) {
+            unique = _children[_index[slot]-1]->_key != key;
+            slot = (slot+1) & mask;
+        }
+        if (unique) {
+            _index[slot] = (Uint32)(ii+1);
+        }
+    }
+}
+
+/**
+ * Adds the last child to the hash index
+ *
+ * This should be called after appending a child. It is cheaper than
+ * a call to {@link #reindex}, unless the index must grow.
+ */
+void JsonValue::indexLast() {
+    if (_index.empty() || 2*_children.size() > _index.size()) {
+        reindex();
+        return;
+    }
+    
+    size_t mask = _index.size()-1;
+    const std::string& key = _children.back()->_key;
+    size_t slot = std::hash<std::string_view>()(key) & mask;
+    while (_index[slot]) {
+        if (_children[_index[slot]-1]->_key == key) {
+            return;
+        }
+        slot = (slot+1) & mask;
+    }
+    _index[slot] = (Uint32)_children.size();
+}
+
 #pragma mark -
 #pragma mark Constructors
 /**
@@ -400,20 +464,16 @@ bool JsonValue::init(double value) {
  * @return  true if the JSON node is initialized properly, false otherwise.
  */
 bool JsonValue::initWithJson(const char* json) {
-    const char *error = NULL;
-    cJSON* node = cJSON_ParseWithOpts(json, &error, 0);
-    if (node) {
-        toJsonValue(this,node);
-        cJSON_Delete(node);
-        return true;
-    }
-    if (error) {
-        int line = 0;
-        std::string source = isolate_error(json,error,line);
-        CUAssertLog(false, "Invalid token at line %d:\n  %s",line,source.c_str());
-    } else {
+    JsonParser parser;
+    if (!parser.initWithBuffer(json,strlen(json))) {
         CUAssertLog(false, "Invalid JSON");
+        return false;
     }
+    parser.next();
+    if (parser.readValue(this)) {
+        return true;
+    }
+    CUAssertLog(false, "%s", parser.getError().empty() ? "Invalid JSON" : parser.getError().c_str());
     return false; // If asserts turned off
 }
 
@@ -809,6 +869,7 @@ void JsonValue::setKey(const std::string& key) {
     if (_parent) {
         CUAssertLog(!_parent->has(key), "The key %s is already in use", key.c_str());
         _key = key;
+        _parent->reindex();
     }
 }
 
@@ -840,14 +901,9 @@ const int JsonValue::index() const {
  *
  * @return true if a child with the specified name exists.
  */
-bool JsonValue::has(const std::string& key) const {
+bool JsonValue::has(std::string_view key) const {
     CUAssertLog(isObject(), "Node is not an object type");
-    for(auto it = _children.begin(); it != _children.end(); it++) {
-        if ((*it)->_key == key) {
-            return true;
-        }
-    }
-    return false;
+    return find(key) >= 0;
 }
 
 /**
@@ -894,14 +950,10 @@ const std::shared_ptr<JsonValue> JsonValue::get(int index) const {
  *
  * @return the child with the specified key.
  */
-std::shared_ptr<JsonValue> JsonValue::get(const std::string& key) {
+std::shared_ptr<JsonValue> JsonValue::get(std::string_view key) {
     CUAssertLog(isObject(), "Node is not an object type");
-    for(auto it = _children.begin(); it != _children.end(); it++) {
-        if ((*it)->_key == key) {
-            return *it;
-        }
-    }
-    return nullptr;
+    int pos = find(key);
+    return pos < 0 ? nullptr : _children[pos];
 }
 
 /**
@@ -916,14 +968,10 @@ std::shared_ptr<JsonValue> JsonValue::get(const std::string& key) {
  *
  * @return the child with the specified key.
  */
-const std::shared_ptr<JsonValue> JsonValue::get(const std::string& key) const {
+const std::shared_ptr<JsonValue> JsonValue::get(std::string_view key) const {
     CUAssertLog(isObject(), "Node is not an object type");
-    for(auto it = _children.begin(); it != _children.end(); it++) {
-        if ((*it)->_key == key) {
-            return *it;
-        }
-    }
-    return nullptr;
+    int pos = find(key);
+    return pos < 0 ? nullptr : _children[pos];
 }
 
 #pragma mark -
@@ -941,8 +989,9 @@ const std::shared_ptr<JsonValue> JsonValue::get(const std::string& key) const {
  *
  * @return the string value of the child with the specified key.
  */
-const std::string JsonValue::getString (const std::string& key, const std::string& defaultValue) const {
-    JsonValue* child = get(key).get();
+const std::string JsonValue::getString (std::string_view key, const std::string& defaultValue) const {
+    int pos = find(key);
+    JsonValue* child = (pos < 0 ? nullptr : _children[pos].get());
     bool astr = (child != nullptr && child->isValue());
     return astr ? child->asString(defaultValue) : std::string(defaultValue);
 }
@@ -960,8 +1009,9 @@ const std::string JsonValue::getString (const std::string& key, const std::strin
  *
  * @return the float value of the child with the specified key.
  */
-float JsonValue::getFloat(const std::string& key, float defaultValue) const {
-    JsonValue* child = get(key).get();
+float JsonValue::getFloat(std::string_view key, float defaultValue) const {
+    int pos = find(key);
+    JsonValue* child = (pos < 0 ? nullptr : _children[pos].get());
     bool astr = (child != nullptr && child->isNumber());
     return astr ? child->asFloat(defaultValue) : defaultValue;
 }
@@ -979,8 +1029,9 @@ float JsonValue::getFloat(const std::string& key, float defaultValue) const {
  *
  * @return the double value of the child with the specified key.
  */
-double JsonValue::getDouble(const std::string& key, double defaultValue) const {
-    JsonValue* child = get(key).get();
+double JsonValue::getDouble(std::string_view key, double defaultValue) const {
+    int pos = find(key);
+    JsonValue* child = (pos < 0 ? nullptr : _children[pos].get());
     bool astr = (child != nullptr && child->isNumber());
     return astr ? child->asFloat(defaultValue) : defaultValue;
 }
@@ -998,8 +1049,9 @@ double JsonValue::getDouble(const std::string& key, double defaultValue) const {
  *
  * @return the long value of the child with the specified key.
  */
-long JsonValue::getLong(const std::string& key, long defaultValue) const {
-    JsonValue* child = get(key).get();
+long JsonValue::getLong(std::string_view key, long defaultValue) const {
+    int pos = find(key);
+    JsonValue* child = (pos < 0 ? nullptr : _children[pos].get());
     bool astr = (child != nullptr && child->isNumber());
     return astr ? child->asLong(defaultValue) : defaultValue;
 }
@@ -1017,8 +1069,9 @@ long JsonValue::getLong(const std::string& key, long defaultValue) const {
  *
  * @return the int value of the child with the specified key.
  */
-int JsonValue::getInt (const std::string& key, int defaultValue) const {
-    JsonValue* child = get(key).get();
+int JsonValue::getInt (std::string_view key, int defaultValue) const {
+    int pos = find(key);
+    JsonValue* child = (pos < 0 ? nullptr : _children[pos].get());
     bool astr = (child != nullptr && child->isNumber());
     return astr ? child->asInt(defaultValue) : defaultValue;
 }
@@ -1036,8 +1089,9 @@ int JsonValue::getInt (const std::string& key, int defaultValue) const {
  *
  * @return the boolean value of the child with the specified key.
  */
-bool JsonValue::getBool(const std::string& key, bool defaultValue) const {
-    JsonValue* child = get(key).get();
+bool JsonValue::getBool(std::string_view key, bool defaultValue) const {
+    int pos = find(key);
+    JsonValue* child = (pos < 0 ? nullptr : _children[pos].get());
     bool astr = (child != nullptr && child->isBool());
     return astr ? child->asBool(defaultValue) : defaultValue;
 }
@@ -1061,6 +1115,7 @@ std::shared_ptr<JsonValue> JsonValue::removeChild(int index) {
     std::shared_ptr<JsonValue> result = _children[index];
     _children.erase(_children.begin() + index);
     result->_parent = nullptr;
+    reindex();
     return result;
 }
 
@@ -1077,16 +1132,12 @@ std::shared_ptr<JsonValue> JsonValue::removeChild(int index) {
  * Returns the child with the specified key and removes it from this node.
  */
 std::shared_ptr<JsonValue> JsonValue::removeChild(const std::string& key) {
-    auto jt = _children.end();
-    for(auto it = _children.begin(); jt == _children.end() && it != _children.end(); it++) {
-        if ((*it)->_key == key) {
-            jt = it;
-        }
-    }
-    if (jt != _children.end()) {
-        std::shared_ptr<JsonValue> result = *jt;
-        _children.erase(jt);
+    int pos = find(key);
+    if (pos >= 0) {
+        std::shared_ptr<JsonValue> result = _children[pos];
+        _children.erase(_children.begin() + pos);
         result->_parent = nullptr;
+        reindex();
         return result;
     }
     return nullptr;
@@ -1107,6 +1158,7 @@ void JsonValue::merge(std::shared_ptr<JsonValue>& node) {
     node->_key = _key;
     _parent->removeChild(_key);
     node->_parent->_children.push_back(node);
+    node->_parent->indexLast();
 }
 
 
@@ -1132,6 +1184,7 @@ void JsonValue::appendChild(const std::shared_ptr<JsonValue>& child) {
                 "The key %s is already in use", child->key().c_str());
     _children.push_back(child);
     child->_parent = this;
+    indexLast();
 }
 
 /**
@@ -1157,6 +1210,7 @@ void JsonValue::appendChild(const std::string& key, const std::shared_ptr<JsonVa
     child->_key = key;
     _children.push_back(child);
     child->_parent = this;
+    indexLast();
 }
 
 /**
@@ -1181,6 +1235,7 @@ void JsonValue::insertChild(unsigned int index, const std::shared_ptr<JsonValue>
     CUAssertLog(isArray() || isObject(), "This node is a value type");
     _children.insert(_children.begin()+index,child);
     child->_parent = this;
+    reindex();
 }
 
 /**
@@ -1210,6 +1265,7 @@ void JsonValue::insertChild(unsigned int index, const std::string& key,
     child->_key = key;
     _children.insert(_children.begin()+index,child);
     child->_parent = this;
+    reindex();
 }
 
 
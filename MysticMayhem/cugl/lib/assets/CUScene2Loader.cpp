@@ -389,7 +389,7 @@ bool Scene2Loader::read(const std::string& key, const std::string& source,
 
     bool success = false;
     if (_loader == nullptr || !async) {
-        std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(source);
+        std::shared_ptr<JsonReader> reader = JsonReader::allocMappedWithAsset(source);
         std::shared_ptr<JsonValue> json = (reader == nullptr ? nullptr : reader->readJson());
         std::shared_ptr<scene2::SceneNode> node = build(key,json);
         node->doLayout();
@@ -401,7 +401,7 @@ bool Scene2Loader::read(const std::string& key, const std::string& source,
         }
     } else {
         _loader->addTask([=](void) {
-            std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(source);
+            std::shared_ptr<JsonReader> reader = JsonReader::allocMappedWithAsset(source);
             std::shared_ptr<JsonValue> json = (reader == nullptr ? nullptr : reader->readJson());
             std::shared_ptr<scene2::SceneNode> node = build(key,json);
             node->doLayout();
@@ -496,7 +496,43 @@ bool Scene2Loader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback c
  * @return true if the asset was successfully unloaded
  */
 bool Scene2Loader::purge(const std::shared_ptr<JsonValue>& json) {
-    return false;
+    return purge(json->key());
+}
+
+/**
+ * Unloads the asset for the given key
+ *
+ * An asset may still be available if it is referenced by a smart pointer.
+ * See the description of the specific implementation for how assets
+ * are released.
+ *
+ * Unloading a scene also unloads all of its descendants, as they are
+ * stored under keys that start with the key of the scene. You will
+ * notice that this method is essentially identical to unload.  We
+ * separated the methods because overloading and virtual methods do not
+ * place nice.
+ *
+ * @param key       The key associated with the asset
+ *
+ * @return true if the asset was successfully unloaded
+ */
+bool Scene2Loader::purge(const std::string& key) {
+    auto it = _assets.find(key);
+    if (it == _assets.end()) {
+        return false;
+    }
+    _assets.erase(it);
+    
+    // The children may have changed since loading, so match on the key
+    std::string prefix = key+"_";
+    for(it = _assets.begin(); it != _assets.end(); ) {
+        if (it->first.compare(0,prefix.size(),prefix) == 0) {
+            it = _assets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return true;
 }
 
 /**
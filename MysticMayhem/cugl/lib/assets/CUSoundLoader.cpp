@@ -44,11 +44,13 @@
 //  Version: 12/20/18
 //
 #include <cugl/assets/CUSoundLoader.h>
+#include <cugl/assets/CUAssetCache.h>
 #include <cugl/base/CUApplication.h>
 #include <cugl/audio/CUSound.h>
 #include <cugl/audio/CUAudioSample.h>
 #include <cugl/audio/CUAudioWaveform.h>
 #include <cugl/util/CUStrings.h>
+#include <cstring>
 
 using namespace cugl;
 
@@ -59,6 +61,13 @@ using namespace cugl;
 /** If the type is unknown */
 #define UNKNOWN_TYPE    "<unknown>"
 
+/** The header of a cached audio sample (the samples follow immediately) */
+typedef struct {
+    Uint32 channels;
+    Uint32 rate;
+    Uint64 frames;
+} SampleHeader;
+
 #pragma mark -
 #pragma mark Constructor
 
@@ -75,6 +84,67 @@ _volume(UNKNOWN_VOLUME) {
 
 #pragma mark -
 #pragma mark Asset Loading
+/**
+ * Loads an audio sample, using the asset cache if there is one.
+ *
+ * This method is safe to call outside of the main thread. It returns
+ * nullptr if the file is not a supported audio file, or if it cannot be
+ * loaded.
+ *
+ * @param source    The pathname to the asset
+ * @param stream    Whether to stream the audio from the file
+ * @param encoding  The storage format for an in-memory sample
+ *
+ * @return the audio sample for the given file
+ */
+std::shared_ptr<AudioSample> SoundLoader::preload(const std::string& source, bool stream,
+                                                  AudioSample::Encoding encoding) {
+    // Make sure we reference the asset directory
+#if defined (__WINDOWS__)
+    bool absolute = (bool)strstr(source.c_str(),":") || source[0] == '\\';
+#else
+    bool absolute = source[0] == '/';
+#endif
+    CUAssertLog(!absolute, "This loader does not accept absolute paths for assets");
+    
+    std::string path = Application::get()->getAssetDirectory();
+    path.append(source);
+    if (AudioSample::guessType(path) == AudioSample::Type::UNKNOWN) {
+        return nullptr;
+    }
+    
+    // Streamed samples have nothing decoded to cache
+    Uint64 key = 0;
+    if (_cache != nullptr && !stream) {
+        key = _cache->getKey(path, "sound/1/"+std::to_string((int)encoding));
+        AssetCache::Entry entry;
+        if (_cache->read(key, AssetCache::Kind::SOUND, entry) && entry.size >= sizeof(SampleHeader)) {
+            SampleHeader header;
+            std::memcpy(&header, entry.data, sizeof(SampleHeader));
+            std::shared_ptr<AudioSample> sample;
+            sample = AudioSample::allocWithSamples(path, (Uint8)header.channels, header.rate, header.frames,
+                                                   encoding, entry.data+sizeof(SampleHeader),
+                                                   entry.size-sizeof(SampleHeader));
+            if (sample != nullptr) {
+                return sample;
+            }
+        }
+    }
+    
+    std::shared_ptr<AudioSample> sample = AudioSample::alloc(path,stream,encoding);
+    if (sample != nullptr && key != 0) {
+        SampleHeader header;
+        header.channels = sample->getChannels();
+        header.rate = sample->getRate();
+        header.frames = (Uint64)sample->getLength();
+        _cache->write(key, AssetCache::Kind::SOUND, {
+            { &header, sizeof(SampleHeader) },
+            { sample->getSamples(), sample->getSampleBytes() }
+        });
+    }
+    return sample;
+}
+
 /**
  * Finishes loading the sound file, setting its default volume.
  *
@@ -129,24 +199,8 @@ bool SoundLoader::read(const std::string& key, const std::string& source, Loader
     _queue.emplace(key);
     
     bool success = false;
-    
-    // Make sure we reference the asset directory
-#if defined (__WINDOWS__)
-    bool absolute = (bool)strstr(source.c_str(),":") || source[0] == '\\';
-#else
-    bool absolute = source[0] == '/';
-#endif
-    CUAssertLog(!absolute, "This loader does not accept absolute paths for assets");
-    
-    std::string path = Application::get()->getAssetDirectory();
-    path.append(source);
-    
-    
     if (_loader == nullptr || !async) {
-        std::shared_ptr<Sound> sound = nullptr;
-        if (AudioSample::guessType(path) != AudioSample::Type::UNKNOWN) {
-            sound = AudioSample::alloc(path);
-        }
+        std::shared_ptr<Sound> sound = preload(source,false,AudioSample::Encoding::FLOAT);
         success = (sound != nullptr);
         if (success) {
             sound->setVolume(_volume);
@@ -154,10 +208,7 @@ bool SoundLoader::read(const std::string& key, const std::string& source, Loader
         }
     } else {
         _loader->addTask([=](void) {
-            std::shared_ptr<Sound> sound = nullptr;
-            if (AudioSample::guessType(path) != AudioSample::Type::UNKNOWN) {
-                sound = AudioSample::alloc(path);
-            }
+            std::shared_ptr<Sound> sound = this->preload(source,false,AudioSample::Encoding::FLOAT);
             if (sound != nullptr) {
                 sound->setVolume(_volume);
                 Application::get()->schedule([=](void){
@@ -200,6 +251,11 @@ bool SoundLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback ca
     float volume = json->getFloat("volume",_volume);
     type = cugl::strtool::tolower(type);
     
+    // Only used by samples
+    std::string source = json->getString("file","");
+    bool stream = json->getBool("stream",false);
+    AudioSample::Encoding encoding = AudioSample::parseEncoding(json->getString("encoding","float"));
+    
     if (_assets.find(key) != _assets.end() || _queue.find(key) != _queue.end()) {
         return false;
     }
@@ -208,7 +264,7 @@ bool SoundLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback ca
     if (_loader == nullptr || !async) {
         std::shared_ptr<Sound> sound = nullptr;
         if (type == "sample") {
-            sound = AudioSample::allocWithData(json);
+            sound = preload(source,stream,encoding);
         } else if (type == "waveform") {
             sound = AudioWaveform::allocWithData(json);
         }
@@ -221,7 +277,7 @@ bool SoundLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback ca
         _loader->addTask([=](void) {
             std::shared_ptr<Sound> sound = nullptr;
             if (type == "sample") {
-                sound = AudioSample::allocWithData(json);
+                sound = this->preload(source,stream,encoding);
             } else if (type == "waveform") {
                 sound = AudioWaveform::allocWithData(json);
             }
@@ -237,3 +293,22 @@ bool SoundLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback ca
     
     return success;
 }
+
+/**
+ * Returns the number of bytes used by the sound for the given key.
+ *
+ * This is the size of the decoded samples of an in-memory audio sample.
+ * Streamed samples and waveforms use no significant memory.
+ *
+ * @param key   The key associated with the sound
+ *
+ * @return the number of bytes used by the sound for the given key.
+ */
+size_t SoundLoader::measure(const std::string& key) const {
+    auto it = _assets.find(key);
+    if (it == _assets.end()) {
+        return 0;
+    }
+    std::shared_ptr<AudioSample> sample = std::dynamic_pointer_cast<AudioSample>(it->second);
+    return sample == nullptr ? 0 : sample->getSampleBytes();
+}
@@ -44,8 +44,15 @@
 //  Version: 1/7/16
 //
 #include <cugl/assets/CUTextureLoader.h>
+#include <cugl/assets/CUAssetCache.h>
 #include <cugl/base/CUApplication.h>
+#include <cugl/render/CURenderBackend.h>
+#include <cugl/util/CUTimestamp.h>
+#include <cugl/util/CUFiletools.h>
 #include <SDL/SDL_image.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
 
 using namespace cugl;
 
@@ -58,6 +65,10 @@ using namespace cugl;
 #define UNKNOWN_MAGFLT  "linear"
 /** The default wrap rule */
 #define UNKNOWN_WRAP    "clamp"
+/** The default time to spend uploading each frame (in microseconds) */
+#define UPLOAD_MICROS   4000
+/** The most bytes to stage ahead when there is no byte budget */
+#define STAGING_BYTES   (8 << 20)
 
 /**
  * Returns the OpenGL enum for the given min filter name
@@ -124,6 +135,45 @@ GLuint decodeWrap(const std::string& name) {
     return GL_CLAMP_TO_EDGE;
 }
 
+/**
+ * Returns a texture for the decoded image, or nullptr on failure
+ *
+ * If image is not nullptr, the texture is created from the compressed image
+ * instead. Otherwise, if buffer is not 0, the pixels are read from that pixel
+ * buffer object instead of the surface, and the buffer is deleted.
+ *
+ * @param surface   The decoded image (may be nullptr)
+ * @param image     The compressed image (may be nullptr)
+ * @param buffer    The pixel buffer staging the image (or 0)
+ *
+ * @return a texture for the decoded image, or nullptr on failure
+ */
+std::shared_ptr<Texture> createTexture(SDL_Surface* surface, const std::shared_ptr<CompressedImage>& image,
+                                       GLuint buffer) {
+    if (image != nullptr) {
+        return Texture::allocWithImage(image);
+    }
+    
+    bool direct = true;
+    std::shared_ptr<Texture> result = nullptr;
+    if (buffer != 0) {
+        RenderBackend* backend = RenderBackend::get();
+        backend->bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        // Unmapping only fails if the data store was lost
+        direct = backend->unmapBuffer(GL_PIXEL_UNPACK_BUFFER) != GL_TRUE;
+        if (!direct && surface != nullptr) {
+            // With an unpack buffer bound, the data pointer is an offset into it
+            result = Texture::allocWithData(nullptr, surface->w, surface->h);
+        }
+        backend->bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        backend->deleteBuffers(1, &buffer);
+    }
+    if (direct && surface != nullptr) {
+        result = Texture::allocWithData(surface->pixels, surface->w, surface->h);
+    }
+    return result;
+}
+
 #pragma mark -
 #pragma mark Constructor
 
@@ -138,7 +188,53 @@ _minfilter(GL_LINEAR),
 _magfilter(GL_LINEAR),
 _wraps(GL_CLAMP_TO_EDGE),
 _wrapt(GL_CLAMP_TO_EDGE),
-_mipmaps(false) {
+_mipmaps(false),
+_uploadCount(0),
+_pumping(false),
+_uploadBytes(0),
+_uploadMicros(UPLOAD_MICROS),
+_staging(false),
+_stagedBytes(0),
+_compression(true) {
+}
+
+/**
+ * Disposes all resources and assets of this loader
+ *
+ * Any assets loaded by this object will be immediately released by the
+ * loader.  However, a texture may still be available if it is referenced
+ * by another smart pointer.  OpenGL will only release a texture asset
+ * once all smart pointer attached to the asset are null.
+ *
+ * Once the loader is disposed, any attempts to load a new asset will
+ * fail.  You must reinitialize the loader to begin loading assets again.
+ * Any images still waiting to be uploaded are discarded, and their
+ * callbacks are not called.
+ */
+void TextureLoader::dispose() {
+    RenderBackend* backend = RenderBackend::get();
+    for(auto it = _uploads.begin(); it != _uploads.end(); ++it) {
+        Upload* upload = it->get();
+        if (upload->buffer != 0) {
+            // The worker must be done with the mapping before we release it
+            while (!upload->staged.load()) {
+                std::this_thread::yield();
+            }
+            backend->bindBuffer(GL_PIXEL_UNPACK_BUFFER, upload->buffer);
+            backend->unmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            backend->bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            backend->deleteBuffers(1, &upload->buffer);
+        }
+        if (upload->surface != nullptr) {
+            SDL_FreeSurface(upload->surface);
+        }
+        _queue.erase(upload->key);
+    }
+    _uploads.clear();
+    _stagedBytes = 0;
+    _priorities.clear();
+    _assets.clear();
+    _loader = nullptr;
 }
 
 
@@ -152,6 +248,10 @@ _mipmaps(false) {
  * we need to create an OpenGL texture.  Hence this method does the maximum
  * amount of work that can be done in asynchronous texture loading.
  *
+ * If there is an asset cache, the pixels are read from the cache when it
+ * has an entry for this file. Otherwise they are stored in the cache once
+ * decoded.
+ *
  * @param source    The pathname to the asset
  *
  * @return the SDL_Surface with the texture information
@@ -167,18 +267,49 @@ SDL_Surface* TextureLoader::preload(const std::string& source) {
     
     std::string path = Application::get()->getAssetDirectory();
     path.append(source);
+
+#if CU_MEMORY_ORDER == CU_ORDER_REVERSED
+    Uint32 format = SDL_PIXELFORMAT_ABGR8888;
+#else
+    Uint32 format = SDL_PIXELFORMAT_RGBA8888;
+#endif
+    
+    // A cached entry is the width, the height, and the converted pixels
+    Uint64 key = 0;
+    if (_cache != nullptr) {
+        key = _cache->getKey(path, "texture/1/"+std::to_string(format));
+        AssetCache::Entry entry;
+        if (_cache->read(key, AssetCache::Kind::TEXTURE, entry) && entry.size >= 2*sizeof(Uint32)) {
+            Uint32 size[2];
+            std::memcpy(size, entry.data, sizeof(size));
+            size_t bytes = (size_t)size[0]*size[1]*4;
+            if (entry.size == sizeof(size)+bytes) {
+                SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, size[0], size[1], 32, format);
+                if (surface != nullptr) {
+                    const Uint8* pixels = entry.data+sizeof(size);
+                    for(Uint32 row = 0; row < size[1]; row++) {
+                        std::memcpy((Uint8*)surface->pixels+row*surface->pitch, pixels+row*size[0]*4, size[0]*4);
+                    }
+                    return surface;
+                }
+            }
+        }
+    }
+    
     SDL_Surface* surface = IMG_Load(path.c_str());
     if (surface == nullptr) {
         return nullptr;
     }
     
-    SDL_Surface* normal;
-#if CU_MEMORY_ORDER == CU_ORDER_REVERSED
-    normal = SDL_ConvertSurfaceFormat(surface,SDL_PIXELFORMAT_ABGR8888,0);
-#else
-    normal = SDL_ConvertSurfaceFormat(surface,SDL_PIXELFORMAT_RGBA8888,0);
-#endif
+    SDL_Surface* normal = SDL_ConvertSurfaceFormat(surface,format,0);
     SDL_FreeSurface(surface);
+    if (normal != nullptr && key != 0 && normal->pitch == normal->w*4) {
+        Uint32 size[2] = { (Uint32)normal->w, (Uint32)normal->h };
+        _cache->write(key, AssetCache::Kind::TEXTURE, {
+            { size, sizeof(size) },
+            { normal->pixels, (size_t)normal->pitch*normal->h }
+        });
+    }
     return normal;
 }
 
@@ -195,12 +326,18 @@ SDL_Surface* TextureLoader::preload(const std::string& source) {
  * This method supports an optional callback function which reports whether
  * the asset was successfully materialized.
  *
+ * If buffer is not 0, the pixels are read from that pixel buffer object
+ * instead of the surface. The buffer is deleted by this method.
+ *
  * @param key       The key to access the asset after loading
  * @param surface   The SDL_Surface to convert
+ * @param image     The compressed image to use instead (or nullptr)
+ * @param buffer    The pixel buffer staging the surface (or 0)
  * @param callback  An optional callback for asynchronous loading
  */
-void TextureLoader::materialize(const std::string& key, SDL_Surface* surface, LoaderCallback callback) {
-    std::shared_ptr<Texture> texture = Texture::allocWithData(surface->pixels, surface->w, surface->h);
+void TextureLoader::materialize(const std::string& key, SDL_Surface* surface, const std::shared_ptr<CompressedImage>& image,
+                                GLuint buffer, LoaderCallback callback) {
+    std::shared_ptr<Texture> texture = createTexture(surface, image, buffer);
     
     bool success = false;
     if (texture != nullptr) {
@@ -218,7 +355,9 @@ void TextureLoader::materialize(const std::string& key, SDL_Surface* surface, Lo
     if (callback != nullptr) {
         callback(key,success);
     }
-    SDL_FreeSurface(surface);
+    if (surface != nullptr) {
+        SDL_FreeSurface(surface);
+    }
     _queue.erase(key);
 }
                                 
@@ -240,18 +379,25 @@ void TextureLoader::materialize(const std::string& key, SDL_Surface* surface, Lo
  *      "magfilter":    The name of the min filter ("nearest" or "linear")
  *      "wrapS":        The s-coord wrap rule ("clamp", "repeat", or "mirrored")
  *      "wrapT":        The t-coord wrap rule ("clamp", "repeat", or "mirrored")
+ *      "priority":     The upload priority (int; larger values are uploaded first)
  *
  * The asset key is the key for the JSON directory entry
  *
  * This method supports an optional callback function which reports whether
  * the asset was successfully materialized.
  *
+ * If buffer is not 0, the pixels are read from that pixel buffer object
+ * instead of the surface. The buffer is deleted by this method.
+ *
  * @param json      The asset directory entry
  * @param surface   The SDL_Surface to convert
+ * @param image     The compressed image to use instead (or nullptr)
+ * @param buffer    The pixel buffer staging the surface (or 0)
  * @param callback  An optional callback for asynchronous loading
  */
-void TextureLoader::materialize(const std::shared_ptr<JsonValue>& json, SDL_Surface* surface, LoaderCallback callback) {
-    std::shared_ptr<Texture> texture = Texture::allocWithData(surface->pixels, surface->w, surface->h);
+void TextureLoader::materialize(const std::shared_ptr<JsonValue>& json, SDL_Surface* surface, const std::shared_ptr<CompressedImage>& image,
+                                GLuint buffer, LoaderCallback callback) {
+    std::shared_ptr<Texture> texture = createTexture(surface, image, buffer);
     std::string key = json->key();
 
     bool success = false;
@@ -278,10 +424,200 @@ void TextureLoader::materialize(const std::shared_ptr<JsonValue>& json, SDL_Surf
     if (callback != nullptr) {
         callback(key,success);
     }
-    SDL_FreeSurface(surface);
+    if (surface != nullptr) {
+        SDL_FreeSurface(surface);
+    }
     _queue.erase(key);
 }
 
+/**
+ * Returns the compressed image for the given source, if there is one.
+ *
+ * If the source is a KTX or KTX2 container, this method loads it directly.
+ * Otherwise, if compression is enabled, it looks for a container with the
+ * same name as the source, preferring KTX2 over KTX. A container is only
+ * returned if the graphics card supports its format. This method is safe
+ * to call outside the main thread.
+ *
+ * @param source    The pathname to the asset
+ *
+ * @return the compressed image for the given source, if there is one.
+ */
+std::shared_ptr<CompressedImage> TextureLoader::preloadImage(const std::string& source) {
+    std::string suffix = filetool::base_suffix(source);
+    if (suffix == "ktx" || suffix == "ktx2") {
+        std::shared_ptr<CompressedImage> image = CompressedImage::allocWithAsset(source);
+        if (image != nullptr && !CompressedImage::isSupported(image->getFormat())) {
+            CULogError("Texture %s is in a format this device does not support.",source.c_str());
+            image = nullptr;
+        }
+        return image;
+    } else if (!_compression) {
+        return nullptr;
+    }
+    
+    // A device that cannot use one container may still be able to use the other
+    const char* containers[] = { "ktx2", "ktx" };
+    for(const char* container : containers) {
+        std::string path = filetool::set_suffix(source,container);
+        std::shared_ptr<CompressedImage> image = CompressedImage::allocWithAsset(path);
+        if (image != nullptr && CompressedImage::isSupported(image->getFormat())) {
+            return image;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Adds a decoded image to the upload queue.
+ *
+ * This method must be called on the main thread. The image will be
+ * materialized by a later call to {@link pump}, in priority order.
+ *
+ * @param key       The key to access the asset after loading
+ * @param json      The asset directory entry (nullptr if none)
+ * @param surface   The decoded image (nullptr if decoding failed)
+ * @param image     The compressed image (nullptr if none)
+ * @param callback  An optional callback for asynchronous loading
+ */
+void TextureLoader::enqueue(const std::string& key, const std::shared_ptr<JsonValue>& json,
+                            SDL_Surface* surface, const std::shared_ptr<CompressedImage>& image,
+                            LoaderCallback callback) {
+    std::shared_ptr<Upload> upload = std::make_shared<Upload>();
+    upload->key = key;
+    upload->json = json;
+    upload->surface = surface;
+    upload->image = image;
+    upload->callback = callback;
+    upload->order = _uploadCount++;
+    auto it = _priorities.find(key);
+    if (it != _priorities.end()) {
+        upload->priority = it->second;
+    } else if (json != nullptr) {
+        upload->priority = json->getInt("priority",0);
+    }
+    // Without staging (or pixels) there is nothing to wait for
+    upload->staged = !_staging || surface == nullptr;
+    _uploads.push_back(upload);
+    
+    if (!_pumping) {
+        _pumping = true;
+        Application::get()->schedule([=](void) {
+            return this->pump();
+        });
+    }
+}
+
+/**
+ * Copies the pixels of the given upload into a pixel buffer object.
+ *
+ * The buffer is mapped on the main thread, but the copy is performed by
+ * the loader thread pool. The upload is ready once its staged flag is set.
+ * If the buffer cannot be mapped, the upload is marked as staged with no
+ * buffer, and its pixels are uploaded directly.
+ *
+ * @param upload    The upload to stage
+ */
+void TextureLoader::stage(const std::shared_ptr<Upload>& upload) {
+    size_t size = upload->size();
+    void* pixels = nullptr;
+    if (_loader != nullptr && size > 0) {
+        RenderBackend* backend = RenderBackend::get();
+        backend->genBuffers(1, &upload->buffer);
+        backend->bindBuffer(GL_PIXEL_UNPACK_BUFFER, upload->buffer);
+        backend->bufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, nullptr, GL_STREAM_DRAW);
+        pixels = backend->mapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size,
+                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        // A mapping survives unbinding the buffer
+        backend->bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (pixels == nullptr) {
+            backend->deleteBuffers(1, &upload->buffer);
+            upload->buffer = 0;
+        }
+    }
+    
+    if (pixels == nullptr) {
+        upload->staged = true;
+        return;
+    }
+    
+    _stagedBytes += size;
+    std::shared_ptr<Upload> item = upload;
+    _loader->addTask([=](void) {
+        std::memcpy(pixels, item->surface->pixels, size);
+        item->staged = true;
+    });
+}
+
+/**
+ * Materializes queued images until the upload budget is spent.
+ *
+ * This method is scheduled with {@link Application#schedule}, and so it
+ * returns true as long as there are uploads still waiting. It always
+ * materializes at least one image (if one is ready), so that large
+ * images cannot stall the queue.
+ *
+ * @return true if there are uploads still waiting
+ */
+bool TextureLoader::pump() {
+    Timestamp start;
+    std::stable_sort(_uploads.begin(), _uploads.end(),
+                     [](const std::shared_ptr<Upload>& a, const std::shared_ptr<Upload>& b) {
+                         return a->priority != b->priority ? a->priority > b->priority : a->order < b->order;
+                     });
+    
+    // Stage at most a frame ahead, so the staging memory stays bounded
+    if (_staging) {
+        size_t limit = _uploadBytes > 0 ? _uploadBytes : STAGING_BYTES;
+        for(auto it = _uploads.begin(); it != _uploads.end(); ++it) {
+            if (_stagedBytes >= limit) {
+                break;
+            }
+            Upload* upload = it->get();
+            if (!upload->staged.load() && upload->buffer == 0) {
+                stage(*it);
+            }
+        }
+    }
+    
+    size_t bytes = 0;
+    size_t count = 0;
+    size_t ii = 0;
+    while (ii < _uploads.size()) {
+        std::shared_ptr<Upload> upload = _uploads[ii];
+        if (!upload->staged.load()) {
+            ii++;   // Still copying
+            continue;
+        }
+        
+        size_t size = upload->size();
+        if (count > 0) {
+            if (_uploadBytes > 0 && bytes+size > _uploadBytes) {
+                break;
+            }
+            Timestamp now;
+            if (_uploadMicros > 0 && now.ellapsedMicros(start) >= _uploadMicros) {
+                break;
+            }
+        }
+        
+        _uploads.erase(_uploads.begin()+ii);
+        if (upload->buffer != 0) {
+            _stagedBytes -= size;
+        }
+        if (upload->json != nullptr) {
+            materialize(upload->json, upload->surface, upload->image, upload->buffer, upload->callback);
+        } else {
+            materialize(upload->key, upload->surface, upload->image, upload->buffer, upload->callback);
+        }
+        bytes += size;
+        count++;
+    }
+    
+    _pumping = !_uploads.empty();
+    return _pumping;
+}
+
 /**
  * Internal method to support asset loading.
  *
@@ -306,9 +642,23 @@ bool TextureLoader::read(const std::string& key, const std::string& source, Load
     }
     _queue.emplace(key);
     
+    // The supported formats must be queried on this thread first
+    CompressedImage::isSupported(0);
+    
     bool success = false;
     if (_loader == nullptr || !async) {
-        std::shared_ptr<Texture> texture = Texture::allocWithFile(source);
+        std::shared_ptr<CompressedImage> image = preloadImage(source);
+        std::shared_ptr<Texture> texture = nullptr;
+        if (image == nullptr && _cache != nullptr) {
+            SDL_Surface* surface = preload(source);
+            texture = createTexture(surface,nullptr,0);
+            if (surface != nullptr) {
+                SDL_FreeSurface(surface);
+            }
+        } else {
+            texture = (image == nullptr ? Texture::allocWithFile(source)
+                                        : Texture::allocWithImage(image));
+        }
         success = (texture != nullptr);
         if (success) { 
 			_assets[key] = texture;
@@ -316,9 +666,10 @@ bool TextureLoader::read(const std::string& key, const std::string& source, Load
         _queue.erase(key);
     } else {
         _loader->addTask([=](void) {
-            SDL_Surface* surface = this->preload(source);
+            std::shared_ptr<CompressedImage> image = this->preloadImage(source);
+            SDL_Surface* surface = (image == nullptr ? this->preload(source) : nullptr);
             Application::get()->schedule([=](void){
-                this->materialize(key,surface,callback);
+                this->enqueue(key,nullptr,surface,image,callback);
                 return false;
             });
         });
@@ -360,6 +711,7 @@ bool TextureLoader::read(const std::string& key, const std::string& source, Load
  *      "magfilter":    The name of the min filter ("nearest" or "linear")
  *      "wrapS":        The s-coord wrap rule ("clamp", "repeat", or "mirrored")
  *      "wrapT":        The t-coord wrap rule ("clamp", "repeat", or "mirrored")
+ *      "priority":     The upload priority (int; larger values are uploaded first)
  *
  * @param json      The directory entry for the asset
  * @param callback  An optional callback for asynchronous loading
@@ -374,10 +726,24 @@ bool TextureLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback
     }
     _queue.emplace(key);
     
+    // The supported formats must be queried on this thread first
+    CompressedImage::isSupported(0);
+    
     std::string source = json->getString("file",UNKNOWN_SOURCE);
     bool success = false;
     if (_loader == nullptr || !async) {
-        std::shared_ptr<Texture> texture = Texture::allocWithFile(source);
+        std::shared_ptr<CompressedImage> image = preloadImage(source);
+        std::shared_ptr<Texture> texture = nullptr;
+        if (image == nullptr && _cache != nullptr) {
+            SDL_Surface* surface = preload(source);
+            texture = createTexture(surface,nullptr,0);
+            if (surface != nullptr) {
+                SDL_FreeSurface(surface);
+            }
+        } else {
+            texture = (image == nullptr ? Texture::allocWithFile(source)
+                                        : Texture::allocWithImage(image));
+        }
         success = (texture != nullptr);
         if (success) { 
 			_assets[key] = texture;
@@ -385,9 +751,10 @@ bool TextureLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback
         _queue.erase(key);
     } else {
         _loader->addTask([=](void) {
-            SDL_Surface* surface = this->preload(source);
+            std::shared_ptr<CompressedImage> image = this->preloadImage(source);
+            SDL_Surface* surface = (image == nullptr ? this->preload(source) : nullptr);
             Application::get()->schedule([=](void){
-                this->materialize(json,surface,callback);
+                this->enqueue(key,json,surface,image,callback);
                 return false;
             });
         });
@@ -456,6 +823,84 @@ bool TextureLoader::purge(const std::shared_ptr<JsonValue>& json) {
     return success;
 }
 
+/**
+ * Returns the number of bytes used by the texture for the given key.
+ *
+ * This is the size of the texture in graphics memory, including any
+ * mipmaps. Block-compressed textures are measured by their blocks. A
+ * subtexture of an atlas uses no memory of its own, as it shares the
+ * memory of its parent.
+ *
+ * @param key   The key associated with the texture
+ *
+ * @return the number of bytes used by the texture for the given key.
+ */
+size_t TextureLoader::measure(const std::string& key) const {
+    auto it = _assets.find(key);
+    if (it == _assets.end() || it->second->getParent() != nullptr) {
+        return 0;
+    }
+    
+    std::shared_ptr<Texture> texture = it->second;
+    size_t width  = texture->getWidth();
+    size_t height = texture->getHeight();
+    size_t result = 0;
+    if (texture->isCompressed()) {
+        GLenum format = texture->getCompression();
+        size_t bw = CompressedImage::getBlockWidth(format);
+        size_t bh = CompressedImage::getBlockHeight(format);
+        if (bw > 0 && bh > 0) {
+            result = ((width+bw-1)/bw)*((height+bh-1)/bh)*CompressedImage::getBlockBytes(format);
+        }
+    } else {
+        result = width*height*texture->getByteSize();
+    }
+    
+    // A full mipmap chain adds a third
+    if (texture->hasMipMaps()) {
+        result += result/3;
+    }
+    return result;
+}
+
+#pragma mark -
+#pragma mark Upload Budget
+/**
+ * Returns the upload priority assigned to the given key.
+ *
+ * Queued images with a higher priority are uploaded first. If no priority
+ * was assigned, this method returns 0. In that case, an image loaded from
+ * a directory entry uses the "priority" attribute of that entry instead.
+ *
+ * @param key   The asset key
+ *
+ * @return the upload priority for the given key.
+ */
+int TextureLoader::getPriority(const std::string& key) const {
+    auto it = _priorities.find(key);
+    return it == _priorities.end() ? 0 : it->second;
+}
+
+/**
+ * Sets the upload priority for the given key.
+ *
+ * Queued images with a higher priority are uploaded first. Images with
+ * the same priority are uploaded in the order they finished decoding.
+ * This value overrides the "priority" attribute of a directory entry,
+ * and applies to an image that is already waiting in the queue.
+ *
+ * @param key       The asset key
+ * @param priority  The upload priority
+ */
+void TextureLoader::setPriority(const std::string& key, int priority) {
+    _priorities[key] = priority;
+    for(auto it = _uploads.begin(); it != _uploads.end(); ++it) {
+        if ((*it)->key == key) {
+            (*it)->priority = priority;
+        }
+    }
+}
+
 #pragma mark -
 #pragma mark Atlas Support
 /**
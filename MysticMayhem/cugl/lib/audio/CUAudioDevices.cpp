@@ -36,6 +36,7 @@
 #include <cugl/audio/CUAudioDevices.h>
 #include <cugl/audio/graph/CUAudioOutput.h>
 #include <cugl/audio/graph/CUAudioInput.h>
+#include <cugl/math/dsp/CUPolyphaseResampler.h>
 #include <cugl/util/CUDebug.h>
 
 using namespace cugl;
@@ -117,6 +118,13 @@ bool AudioDevices::init(Uint32 output, Uint32 input) {
 #endif
         _output = output;
         _input  = input;
+        _streamer = audio::AudioStreamer::alloc();
+        _profiler = audio::AudioProfiler::alloc();
+        // Precompute the filter banks for the most common rate conversions
+        dsp::PolyphaseResampler::precompute(audio::AudioNode::DEFAULT_CHANNELS, 44100, 48000,
+                                            dsp::PolyphaseResampler::Quality::MEDIUM);
+        dsp::PolyphaseResampler::precompute(audio::AudioNode::DEFAULT_CHANNELS, 48000, 44100,
+                                            dsp::PolyphaseResampler::Quality::MEDIUM);
         return true;
     }
     return false;
@@ -134,6 +142,11 @@ void AudioDevices::dispose() {
         deactivate();
         _outputs.clear();
         _inputs.clear();
+        if (_streamer != nullptr) {
+            _streamer->dispose();
+            _streamer = nullptr;
+        }
+        _profiler = nullptr;
 
 #if CU_PLATFORM == CU_PLATFORM_MACOS
         AudioObjectRemovePropertyListener(kAudioObjectSystemObject, &test_address, device_unplugged, this);
@@ -240,6 +253,7 @@ void AudioDevices::stop() {
     }
     _gManager->dispose();
     delete _gManager;
+    _gManager = nullptr;
 }
 
 /**
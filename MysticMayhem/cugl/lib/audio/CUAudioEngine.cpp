@@ -54,8 +54,9 @@ AudioEngine* AudioEngine::_gEngine = nullptr;
  * The engine must be initialized before is can be used.
  */
 AudioEngine::AudioEngine() :
+_primary(false),
 _capacity(0),
-_primary(false) {
+_clock(0) {
     _output = nullptr;
     _mixer  = nullptr;
 }
@@ -86,6 +87,7 @@ bool AudioEngine::init(const std::shared_ptr<AudioOutput>& device, Uint32 slots)
         std::shared_ptr<AudioScheduler> channel;
         channel = audio::AudioScheduler::alloc(_mixer->getChannels(),_mixer->getRate());
         channel->setTag(ii);
+        channel->setClock(_output->getClock());
         _slots.push_back(channel);
         std::shared_ptr<AudioFader> cover;
         cover = audio::AudioFader::alloc(channel);
@@ -115,6 +117,14 @@ bool AudioEngine::init(const std::shared_ptr<AudioOutput>& device, Uint32 slots)
         _panPool.push_back(AudioPanner::alloc(_mixer->getChannels(),2,_mixer->getRate()));
     }
     
+    // Free voices are taken from the back, so lower slots are used first
+    _voices.resize(_capacity);
+    _freeVoices.reserve(_capacity);
+    for(size_t ii = _capacity; ii > 0; ii--) {
+        _freeVoices.push_back((Uint32)(ii-1));
+    }
+    _clock = 0;
+    
     _output->attach(_mixer);
     return true;
 }
@@ -145,8 +155,9 @@ void AudioEngine::dispose() {
         _mixer = nullptr;
         
         _queues.clear();
-		_actives.clear();
-        _evicts.clear();
+        _voices.clear();
+        _freeVoices.clear();
+        _keys.clear();
 	}
 }
 
@@ -162,15 +173,168 @@ void AudioEngine::dispose() {
  * @remove key  The key to purge from the list of active effects.
  */
 void AudioEngine::removeKey(const std::string key) {
-    _actives.erase(key);
-    for(auto it = _evicts.begin(); it != _evicts.end(); ) {
-        if (*it == key) {
-            it = _evicts.erase(it);
-            break;
-        } else {
-            it++;
+    auto it = _keys.find(key);
+    if (it != _keys.end()) {
+        _voices[it->second].key.clear();
+        _keys.erase(it);
+    }
+}
+
+/**
+ * Returns the slot of a voice for a sound of the given priority.
+ *
+ * If there is a free voice, this method takes constant time. Otherwise
+ * it looks for a voice to steal. Voices that have finished or are fading
+ * out are always available. Otherwise, the method picks the oldest voice
+ * of the lowest priority, and steals it only if that priority is less
+ * than the given one (or if force is true). The key of a stolen voice is
+ * released immediately.
+ *
+ * @param priority  The priority of the new sound
+ * @param force     Whether to steal a voice regardless of priority
+ *
+ * @return the slot of an available voice, or -1 if there is none
+ */
+Sint32 AudioEngine::acquireVoice(Sint32 priority, bool force) {
+    if (!_freeVoices.empty()) {
+        Uint32 slot = _freeVoices.back();
+        _freeVoices.pop_back();
+        return (Sint32)slot;
+    }
+    
+    // All voices are in use (this is bounded by the capacity)
+    Sint32 victim = -1;
+    bool done = false;
+    for(Uint32 ii = 0; !done && ii < _capacity; ii++) {
+        const Voice& voice = _voices[ii];
+        if (!_slots[ii]->isPlaying() || (voice.fader->isFadeOut() && !_slots[ii]->getTailSize())) {
+            // Finished or soon to be finished
+            victim = ii;
+            done = true;
+        } else if (victim == -1 || voice.priority < _voices[victim].priority ||
+                   (voice.priority == _voices[victim].priority && voice.stamp < _voices[victim].stamp)) {
+            victim = ii;
+        }
+    }
+    
+    if (victim == -1 || !(done || force || _voices[victim].priority < priority)) {
+        return -1;
+    }
+    
+    // The old sound is collected later, but no longer owns the voice
+    Voice& voice = _voices[victim];
+    if (!done) {
+        _slots[victim]->setLoops(0);
+        voice.fader->fadeOut(DEFAULT_FADE);
+    }
+    removeKey(voice.key);
+    return victim;
+}
+
+/**
+ * Returns a handle to a new sound playing the given instance.
+ *
+ * This method is the shared implementation of all of the play methods.
+ * It returns 0 if the sound could not be played.
+ *
+ * @param  key      The reference key for the sound effect (may be empty)
+ * @param  instance The audio instance to play
+ * @param  loop     Whether to loop the sound effect continuously
+ * @param  volume   The music volume (relative to the default instance volume)
+ * @param  priority The priority for voice stealing
+ * @param  force    Whether to force another sound to stop.
+ * @param  time     The sample time to start the sound (0 for immediately)
+ *
+ * @return a handle to a new sound playing the given instance.
+ */
+Uint64 AudioEngine::playInstance(const std::string& key, const std::shared_ptr<audio::AudioNode>& instance,
+                                 bool loop, float volume, Sint32 priority, bool force, Uint64 time) {
+    if (!key.empty()) {
+        auto it = _keys.find(key);
+        if (it != _keys.end()) {
+            if (force) {
+                clear(key,0);
+                removeKey(key);
+            } else {
+                CULogError("Sound effect key is in use");
+                return 0;
+            }
         }
     }
+    
+    Sint32 slot = acquireVoice(priority,force);
+    if (slot == -1) {
+        CULogError("No available sound channels");
+        return 0;
+    }
+    
+    Voice& voice = _voices[slot];
+    voice.fader = wrapInstance(instance);
+    voice.fader->setGain(volume);
+    voice.fader->setTag(slot);
+    voice.fader->setName(key);
+    voice.key = key;
+    voice.priority = priority;
+    voice.stamp = _clock++;
+    if (++voice.generation == 0) {
+        voice.generation = 1;
+    }
+    if (!key.empty()) {
+        _keys.emplace(key,(Uint32)slot);
+    }
+    
+    _slots[slot]->play(voice.fader, loop ? -1 : 0, time);
+    return ((Uint64)voice.generation << 32) | (Uint64)slot;
+}
+
+/**
+ * Returns the voice in the given slot to the free list.
+ *
+ * This method also releases the key (if any) for that voice.
+ *
+ * @param slot  The voice slot
+ */
+void AudioEngine::releaseVoice(Uint32 slot) {
+    Voice& voice = _voices[slot];
+    if (voice.fader != nullptr) {
+        removeKey(voice.key);
+        voice.fader = nullptr;
+        voice.priority = 0;
+        _freeVoices.push_back(slot);
+    }
+}
+
+/**
+ * Returns the fader for the sound effect with the given key.
+ *
+ * This method returns nullptr if there is no such sound effect.
+ *
+ * @param key   The reference key for the sound effect
+ *
+ * @return the fader for the sound effect with the given key.
+ */
+std::shared_ptr<audio::AudioFader> AudioEngine::getFader(const std::string& key) const {
+    auto it = _keys.find(key);
+    return it == _keys.end() ? nullptr : _voices[it->second].fader;
+}
+
+/**
+ * Returns the fader for the sound effect with the given voice handle.
+ *
+ * This method returns nullptr if the handle does not refer to an active
+ * sound effect.
+ *
+ * @param voice The voice handle for the sound effect
+ *
+ * @return the fader for the sound effect with the given voice handle.
+ */
+std::shared_ptr<audio::AudioFader> AudioEngine::getFader(Uint64 voice) const {
+    Uint32 slot = (Uint32)(voice & 0xffffffff);
+    Uint32 generation = (Uint32)(voice >> 32);
+    if (generation == 0 || slot >= _voices.size() || _voices[slot].generation != generation) {
+        return nullptr;
+    }
+    return _voices[slot].fader;
 }
 
 /**
@@ -305,13 +469,67 @@ std::shared_ptr<audio::AudioNode> AudioEngine::disposeWrapper(const std::shared_
  */
 void AudioEngine::gcollect(const std::shared_ptr<audio::AudioNode>& sound, bool status) {
     std::string key = sound->getName();
+    Uint32 slot = sound->getTag();
+    // A stolen voice already belongs to a new sound
+    if (slot < _voices.size() && _voices[slot].fader == sound) {
+        releaseVoice(slot);
+    }
     disposeWrapper(sound);
-    removeKey(key);
-    if (_callback) {
+    if (_callback && !key.empty()) {
         _callback(key,status);
     }
 }
 
+/**
+ * Returns the playback state of the sound effect with the given fader.
+ *
+ * @param fader The fader for the sound effect
+ *
+ * @return the playback state of the sound effect with the given fader.
+ */
+AudioEngine::State AudioEngine::getState(const std::shared_ptr<audio::AudioFader>& fader) const {
+    if (fader == nullptr) {
+        return State::INACTIVE;
+    }
+    
+    std::shared_ptr<audio::AudioScheduler> slot = _slots.at(fader->getTag());
+    if (!slot->isPlaying()) {
+        return State::INACTIVE;
+    } else if (fader->isPaused() || slot->isPaused()) {
+        return State::PAUSED;
+    }
+    
+    return State::PLAYING;
+}
+
+/**
+ * Sets the stereo pan of the sound effect with the given fader.
+ *
+ * @param fader The fader for the sound effect
+ * @param pan   The stereo pan of the sound effect
+ */
+void AudioEngine::setPanFactor(const std::shared_ptr<audio::AudioFader>& fader, float pan) {
+    if (fader != nullptr) {
+        std::shared_ptr<AudioPanner> panner = std::dynamic_pointer_cast<AudioPanner>(fader->getInput());
+        if (panner->getField() == 1) {
+            panner->setPan(0,0,0.5-pan/2.0);
+            panner->setPan(0,1,0.5+pan/2.0);
+        } else {
+            if (pan <= 0) {
+                panner->setPan(0,0,1);
+                panner->setPan(0,1,0);
+                panner->setPan(1,0,-pan);
+                panner->setPan(1,1,1+pan);
+            } else {
+                panner->setPan(1,1,1);
+                panner->setPan(1,0,0);
+                panner->setPan(0,0,1-pan);
+                panner->setPan(0,1,pan);
+            }
+        }
+    }
+}
+
 #pragma mark -
 #pragma mark Static Accessors
 /**
@@ -570,58 +788,9 @@ void AudioEngine::freeQueue(const std::shared_ptr<AudioQueue>& queue) {
 bool AudioEngine::play(const std::string key, const std::shared_ptr<Sound>& sound,
                        bool loop, float volume, bool force) {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-
-    if (isActive(key)) {
-        if (force) {
-            clear(key,0);
-            removeKey(key);
-        } else {
-            CULogError("Sound effect key is in use");
-            return false;
-        }
-    }
-    
-    // Find an empty scheduler
-    int audioID = -1;
-    for(auto it = _slots.begin()+1; audioID == -1 && it != _slots.end(); ++it) {
-        if (!(*it)->isPlaying()) {
-            audioID = (*it)->getTag();
-        }
-    }
-    
-    // Try again for soon to be deleted.
-    for(auto it = _actives.begin(); audioID == -1 && it != _actives.end(); ++it) {
-        if (it->second->isFadeOut()) {
-            Uint32 tag = it->second->getTag();
-            if (!_slots[tag]->getTailSize()) {
-                audioID = tag;
-            }
-        }
-    }
-    
-    if (audioID == -1) {
-        if (force) {
-            std::string altkey = _evicts.front();
-            audioID = _actives[altkey]->getTag();
-            clear(altkey);
-        } else {
-            // Fail if nothing available
-            CULogError("No available sound channels");
-            return false;
-        }
-    }
-    
     std::shared_ptr<audio::AudioNode> player = sound->createNode();
     player->setName("__engine_playback__");
-
-    std::shared_ptr<AudioFader> fader = wrapInstance(player);
-    fader->setGain(volume);
-    fader->setTag(audioID);
-    fader->setName(key);
-    _slots[audioID]->play(fader, loop ? -1 : 0);
-    _actives.emplace(key,fader);
-    _evicts.push_back(key);
-    return true;
+    return playInstance(key,player,loop,volume,0,force) != 0;
 }
 
 /**
@@ -659,55 +828,7 @@ bool AudioEngine::play(const std::string key, const std::shared_ptr<audio::Audio
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
     CUAssertLog(graph->getName() != "__engine_playback__",  "Audio node uses reserved name '__engine_playback__'");
     CUAssertLog(graph->getName() != "__engine_resampler__", "Audio node uses reserved name '__engine_resampler__'");
-
-    if (isActive(key)) {
-        if (force) {
-            clear(key,0);
-            removeKey(key);
-        } else {
-            CULogError("Sound effect key is in use");
-            return false;
-        }
-    }
-    
-    // Find an empty scheduler
-    int audioID = -1;
-    for(auto it = _slots.begin()+1; audioID == -1 && it != _slots.end(); ++it) {
-        if (!(*it)->isPlaying()) {
-            audioID = (*it)->getTag();
-        }
-    }
-    
-    // Try again for soon to be deleted.
-    for(auto it = _actives.begin(); audioID == -1 && it != _actives.end(); ++it) {
-        if (it->second->isFadeOut()) {
-            Uint32 tag = it->second->getTag();
-            if (!_slots[tag]->getTailSize()) {
-                audioID = tag;
-            }
-        }
-    }
-    
-    if (audioID == -1) {
-        if (force) {
-            std::string altkey = _evicts.front();
-            audioID = _actives[altkey]->getTag();
-            clear(altkey);
-        } else {
-            // Fail if nothing available
-            CULogError("No available sound channels");
-            return false;
-        }
-    }
-
-    std::shared_ptr<AudioFader> fader = wrapInstance(graph);
-    fader->setGain(volume);
-    fader->setTag(audioID);
-    fader->setName(key);
-    _slots[audioID]->play(fader, loop ? -1 : 0);
-    _actives.emplace(key,fader);
-    _evicts.push_back(key);
-    return true;
+    return playInstance(key,graph,loop,volume,0,force) != 0;
 }
 
 
@@ -723,19 +844,7 @@ bool AudioEngine::play(const std::string key, const std::shared_ptr<audio::Audio
  */
 AudioEngine::State AudioEngine::getState(const std::string key) const {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) == _actives.end()) {
-        return State::INACTIVE;
-    }
-    
-    std::shared_ptr<AudioNode> node = _actives.at(key);
-    std::shared_ptr<audio::AudioScheduler> slot = _slots.at(node->getTag());
-    if (!slot->isPlaying()) {
-        return State::INACTIVE;
-    } else if (node->isPaused() || slot->isPaused()) {
-        return State::PAUSED;
-    }
-    
-    return State::PLAYING;
+    return getState(getFader(key));
 }
 
 /**
@@ -751,11 +860,12 @@ AudioEngine::State AudioEngine::getState(const std::string key) const {
  */
 const std::string AudioEngine::getSource(const std::string key) const {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) == _actives.end()) {
+    std::shared_ptr<AudioFader> fader = getFader(key);
+    if (fader == nullptr) {
         return std::string();
     }
 
-    std::shared_ptr<AudioNode> source = accessInstance(_actives.at(key));
+    std::shared_ptr<AudioNode> source = accessInstance(fader);
     std::string id = source->getName();
     AudioPlayer* player = dynamic_cast<AudioPlayer*>(source.get());
     if (player && id == "__engine_playback__") {
@@ -777,8 +887,8 @@ const std::string AudioEngine::getSource(const std::string key) const {
  */
 bool AudioEngine::isLoop(const std::string key) const {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        std::shared_ptr<AudioNode> node = _actives.at(key);
+    std::shared_ptr<AudioFader> node = getFader(key);
+    if (node != nullptr) {
         return _slots.at(node->getTag())->getLoops() != 0;
     }
     return false;
@@ -796,8 +906,8 @@ bool AudioEngine::isLoop(const std::string key) const {
  */
 void AudioEngine::setLoop(const std::string key, bool loop) {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        std::shared_ptr<AudioNode> node = _actives.at(key);
+    std::shared_ptr<AudioFader> node = getFader(key);
+    if (node != nullptr) {
         _slots[node->getTag()]->setLoops(loop ? -1 : 0);
     }
 }
@@ -820,9 +930,8 @@ void AudioEngine::setLoop(const std::string key, bool loop) {
  */
 float AudioEngine::getVolume(const std::string key) const {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        Uint32 tag = _actives.at(key)->getTag();
-        std::shared_ptr<AudioNode> node = _slots[tag]->getCurrent();
+    std::shared_ptr<AudioFader> node = getFader(key);
+    if (node != nullptr) {
         return node->getGain();
     }
     return 0;
@@ -845,9 +954,8 @@ float AudioEngine::getVolume(const std::string key) const {
  */
 void AudioEngine::setVolume(const std::string key, float volume) {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        Uint32 tag = _actives.at(key)->getTag();
-        std::shared_ptr<AudioNode> node = _slots[tag]->getCurrent();
+    std::shared_ptr<AudioFader> node = getFader(key);
+    if (node != nullptr) {
         node->setGain(volume);
     }
 }
@@ -874,8 +982,8 @@ void AudioEngine::setVolume(const std::string key, float volume) {
  */
 float AudioEngine::getPanFactor(const std::string& key) const {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        std::shared_ptr<AudioFader> fader = _actives.at(key);
+    std::shared_ptr<AudioFader> fader = getFader(key);
+    if (fader != nullptr) {
         std::shared_ptr<AudioPanner> panner = std::dynamic_pointer_cast<AudioPanner>(fader->getInput());
         if (panner->getField() == 1) {
             return panner->getPan(0,1)-panner->getPan(0,0);
@@ -908,26 +1016,7 @@ float AudioEngine::getPanFactor(const std::string& key) const {
 void AudioEngine::setPanFactor(const std::string key, float pan) {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
     CUAssertLog(pan >= -1 && pan <= 1, "Pan value %f is out of range",pan);
-    if (_actives.find(key) != _actives.end()) {
-        std::shared_ptr<AudioFader> fader = _actives.at(key);
-        std::shared_ptr<AudioPanner> panner = std::dynamic_pointer_cast<AudioPanner>(fader->getInput());
-        if (panner->getField() == 1) {
-            panner->setPan(0,0,0.5-pan/2.0);
-            panner->setPan(0,1,0.5+pan/2.0);
-        } else {
-            if (pan <= 0) {
-                panner->setPan(0,0,1);
-                panner->setPan(0,1,0);
-                panner->setPan(1,0,-pan);
-                panner->setPan(1,1,1+pan);
-            } else {
-                panner->setPan(1,1,1);
-                panner->setPan(1,0,0);
-                panner->setPan(0,0,1-pan);
-                panner->setPan(0,1,pan);
-            }
-        }
-    }
+    setPanFactor(getFader(key),pan);
 }
 
 
@@ -946,8 +1035,9 @@ void AudioEngine::setPanFactor(const std::string key, float pan) {
  */
 float AudioEngine::getDuration(const std::string key) const  {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        std::shared_ptr<audio::AudioNode> source = accessInstance(_actives.at(key));
+    std::shared_ptr<AudioFader> fader = getFader(key);
+    if (fader != nullptr) {
+        std::shared_ptr<audio::AudioNode> source = accessInstance(fader);
         AudioPlayer* player = dynamic_cast<AudioPlayer*>(source.get());
         if (player && player->getName() == "__queue_playback__") {
             return player->getSource()->getDuration();
@@ -982,8 +1072,9 @@ float AudioEngine::getDuration(const std::string key) const  {
  */
 float AudioEngine::getTimeElapsed(const std::string key) const {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        return _actives.at(key)->getElapsed();
+    std::shared_ptr<AudioFader> fader = getFader(key);
+    if (fader != nullptr) {
+        return fader->getElapsed();
     }
     return -1;
 }
@@ -1007,8 +1098,9 @@ float AudioEngine::getTimeElapsed(const std::string key) const {
  */
 void AudioEngine::setTimeElapsed(const std::string key, float time) {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        _actives.at(key)->setElapsed(time);
+    std::shared_ptr<AudioFader> fader = getFader(key);
+    if (fader != nullptr) {
+        fader->setElapsed(time);
     }
 }
 
@@ -1030,8 +1122,9 @@ void AudioEngine::setTimeElapsed(const std::string key, float time) {
  */
 float AudioEngine::geTimeRemaining(const std::string key) const  {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        return _actives.at(key)->getRemaining();
+    std::shared_ptr<AudioFader> fader = getFader(key);
+    if (fader != nullptr) {
+        return fader->getRemaining();
     }
     return -1;
 }
@@ -1053,8 +1146,9 @@ float AudioEngine::geTimeRemaining(const std::string key) const  {
  */
 void AudioEngine::setTimeRemaining(const std::string key, float time) {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        _actives.at(key)->setRemaining(time);
+    std::shared_ptr<AudioFader> fader = getFader(key);
+    if (fader != nullptr) {
+        fader->setRemaining(time);
     }
 }
 
@@ -1079,8 +1173,8 @@ void AudioEngine::setTimeRemaining(const std::string key, float time) {
  */
 void AudioEngine::clear(const std::string key,float fade) {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        std::shared_ptr<AudioFader> node = _actives.at(key);
+    std::shared_ptr<AudioFader> node = getFader(key);
+    if (node != nullptr) {
         _slots[node->getTag()]->setLoops(0);
         node->fadeOut(fade);
     }
@@ -1105,8 +1199,8 @@ void AudioEngine::clear(const std::string key,float fade) {
  */
 void AudioEngine::pause(const std::string key,float fade) {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        std::shared_ptr<AudioFader> node = _actives.at(key);
+    std::shared_ptr<AudioFader> node = getFader(key);
+    if (node != nullptr) {
         node->fadePause(fade);
     }
 }
@@ -1120,13 +1214,173 @@ void AudioEngine::pause(const std::string key,float fade) {
  */
 void AudioEngine::resume(std::string key) {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    if (_actives.find(key) != _actives.end()) {
-        std::shared_ptr<AudioFader> node = _actives.at(key);
+    std::shared_ptr<AudioFader> node = getFader(key);
+    if (node != nullptr) {
         node->resume();
     }
 }
 
 
+#pragma mark -
+#pragma mark Voice Management
+/**
+ * Plays the given sound without a key, returning a voice handle.
+ *
+ * This method is for sound effects that are not referenced by name, such
+ * as short one-shot effects. It avoids the cost of managing a key. The
+ * handle returned can be used with the other voice methods. A handle is
+ * never 0, and it becomes invalid once the sound is finished; it will not
+ * refer to a later sound in the same slot.
+ *
+ * If all slots are in use, this sound steals the slot of the oldest
+ * sound with the lowest priority, provided that its priority is lower
+ * than this one. Keyed sounds played with {@link #play} have priority 0.
+ *
+ * If time is not 0, the sound starts at that frame of {@link #getSampleTime},
+ * rather than at the start of the next audio buffer.
+ *
+ * @param  sound    The sound effect to play
+ * @param  loop     Whether to loop the sound effect continuously
+ * @param  volume   The music volume (relative to the default asset volume)
+ * @param  priority The priority for voice stealing
+ * @param  time     The sample time to start the sound (0 for immediately)
+ *
+ * @return a voice handle for the sound, or 0 if it could not be played
+ */
+Uint64 AudioEngine::playVoice(const std::shared_ptr<Sound>& sound, bool loop,
+                              float volume, Sint32 priority, Uint64 time) {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    std::shared_ptr<audio::AudioNode> player = sound->createNode();
+    player->setName("__engine_playback__");
+    return playInstance(std::string(),player,loop,volume,priority,false,time);
+}
+
+/**
+ * Plays the given audio node without a key, returning a voice handle.
+ *
+ * This method is for sound effects that are not referenced by name, such
+ * as short one-shot effects. It avoids the cost of managing a key. The
+ * handle returned can be used with the other voice methods. A handle is
+ * never 0, and it becomes invalid once the sound is finished; it will not
+ * refer to a later sound in the same slot.
+ *
+ * If all slots are in use, this sound steals the slot of the oldest
+ * sound with the lowest priority, provided that its priority is lower
+ * than this one. Keyed sounds played with {@link #play} have priority 0.
+ *
+ * If time is not 0, the sound starts at that frame of {@link #getSampleTime},
+ * rather than at the start of the next audio buffer.
+ *
+ * @param  graph    The audio graph to play
+ * @param  loop     Whether to loop the sound effect continuously
+ * @param  volume   The music volume (relative to the default instance volume)
+ * @param  priority The priority for voice stealing
+ * @param  time     The sample time to start the sound (0 for immediately)
+ *
+ * @return a voice handle for the sound, or 0 if it could not be played
+ */
+Uint64 AudioEngine::playVoice(const std::shared_ptr<audio::AudioNode>& graph, bool loop,
+                              float volume, Sint32 priority, Uint64 time) {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    CUAssertLog(graph->getName() != "__engine_playback__",  "Audio node uses reserved name '__engine_playback__'");
+    CUAssertLog(graph->getName() != "__engine_resampler__", "Audio node uses reserved name '__engine_resampler__'");
+    return playInstance(std::string(),graph,loop,volume,priority,false,time);
+}
+
+/**
+ * Returns the current sample time of the output device.
+ *
+ * This is an estimate of the frame of the output clock at this instant
+ * (see {@link audio::AudioClock#estimate}). A sound played with this time
+ * starts exactly one audio buffer from now, no matter when in the buffer
+ * the request was made. Adding an offset schedules the sound that many
+ * frames later. Use {@link #getSampleRate} to convert from seconds.
+ *
+ * @return the current sample time of the output device.
+ */
+Uint64 AudioEngine::getSampleTime() const {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    return _output->getClock()->estimate();
+}
+
+/**
+ * Returns the sample rate of the output device.
+ *
+ * @return the sample rate of the output device.
+ */
+Uint32 AudioEngine::getSampleRate() const {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    return _output->getRate();
+}
+
+/**
+ * Returns the current state of the sound effect for the given voice.
+ *
+ * If the handle does not refer to an active sound effect, it returns
+ * State::INACTIVE.
+ *
+ * @param  voice    the voice handle for the sound effect
+ *
+ * @return the current state of the sound effect for the given voice.
+ */
+AudioEngine::State AudioEngine::getVoiceState(Uint64 voice) const {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    return getState(getFader(voice));
+}
+
+/**
+ * Sets the current volume of the sound effect for the given voice.
+ *
+ * If the handle does not refer to an active sound effect, this method
+ * does nothing.
+ *
+ * @param  voice    the voice handle for the sound effect
+ * @param  volume   the current volume of the sound effect
+ */
+void AudioEngine::setVoiceVolume(Uint64 voice, float volume) {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    std::shared_ptr<AudioFader> node = getFader(voice);
+    if (node != nullptr) {
+        node->setGain(volume);
+    }
+}
+
+/**
+ * Sets the stereo pan of the sound effect for the given voice.
+ *
+ * See {@link #setPanFactor} for a description of the pan value. If the
+ * handle does not refer to an active sound effect, this method does
+ * nothing.
+ *
+ * @param  voice    the voice handle for the sound effect
+ * @param  pan      the stereo pan of the sound effect
+ */
+void AudioEngine::setVoicePan(Uint64 voice, float pan) {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    CUAssertLog(pan >= -1 && pan <= 1, "Pan value %f is out of range",pan);
+    setPanFactor(getFader(voice),pan);
+}
+
+/**
+ * Stops the sound effect for the given voice.
+ *
+ * If the argument is 0, it will halt the sound immediately. Otherwise
+ * it will fade to completion over the given number of seconds (or until
+ * the end of the effect). If the handle does not refer to an active
+ * sound effect, this method does nothing.
+ *
+ * @param  voice    the voice handle for the sound effect
+ * @param  fade     the number of seconds to fade out
+ */
+void AudioEngine::stopVoice(Uint64 voice, float fade) {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    std::shared_ptr<AudioFader> node = getFader(voice);
+    if (node != nullptr) {
+        _slots[node->getTag()]->setLoops(0);
+        node->fadeOut(fade);
+    }
+}
+
 #pragma mark -
 #pragma mark Global Management
 /**
@@ -1145,11 +1399,13 @@ void AudioEngine::resume(std::string key) {
  */
 void AudioEngine::clearEffects(float fade) {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
-    for(auto it = _actives.begin(); it != _actives.end(); ++it) {
-        it->second->fadeOut(fade);
+    for(auto it = _voices.begin(); it != _voices.end(); ++it) {
+        if (it->fader != nullptr) {
+            it->fader->fadeOut(fade);
+            it->key.clear();
+        }
     }
-    _actives.clear();
-    _evicts.clear();
+    _keys.clear();
 }
 
 /**
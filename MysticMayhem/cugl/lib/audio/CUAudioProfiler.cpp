@@ -0,0 +1,340 @@
+//
+//  CUAudioProfiler.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides instrumentation for the audio thread. It records how
+//  long each output callback takes, how close that is to the deadline set by
+//  the buffer size, and how much of that time is spent in the mixer, spinner,
+//  fader and resampler nodes. It also counts stream underruns and the number
+//  of voices mixed. This is the information needed to tune the buffer size
+//  for a particular device.
+//
+//  All recording is lock-free and allocation-free, so it is safe for the
+//  audio thread. The main thread reads the results with a snapshot, and can
+//  optionally drain a per-callback trace to a BinaryWriter.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#include <cugl/audio/CUAudioProfiler.h>
+#include <cugl/io/CUBinaryWriter.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+using namespace cugl;
+using namespace cugl::audio;
+
+/** The default number of trace records buffered between dumps */
+const Uint32 AudioProfiler::DEFAULT_TRACE = 4096;
+
+/** The display names of the stages */
+static const char* STAGE_NAMES[] = { "output", "mixer", "spinner", "fader", "resampler" };
+
+/**
+ * Returns the time bucket for the given number of microseconds
+ *
+ * Bucket b holds the times less than 2^b microseconds (and at least half
+ * that, except for bucket 0).
+ *
+ * @param micros    The time in microseconds
+ *
+ * @return the time bucket for the given number of microseconds
+ */
+static Uint32 time_bucket(Uint64 micros) {
+    Uint32 bucket = 0;
+    while (micros) {
+        micros >>= 1;
+        bucket++;
+    }
+    return std::min(bucket,AudioProfiler::TIME_BUCKETS-1);
+}
+
+/**
+ * Stores the maximum of the atomic and the given value in the atomic
+ *
+ * @param atom  The atomic to update
+ * @param value The value to compare
+ */
+template <typename T>
+static void atomic_max(std::atomic<T>& atom, T value) {
+    T prev = atom.load(std::memory_order_relaxed);
+    while (prev < value && !atom.compare_exchange_weak(prev,value,std::memory_order_relaxed)) {}
+}
+
+#pragma mark -
+#pragma mark Histogram
+/**
+ * Returns an upper bound of the given percentile in microseconds
+ *
+ * The result is the upper limit of the bucket containing the
+ * percentile, so it is accurate to within a factor of two.
+ *
+ * @param percent   The percentile in [0,1]
+ *
+ * @return an upper bound of the given percentile in microseconds
+ */
+Uint64 AudioProfiler::Histogram::getPercentile(double percent) const {
+    if (count == 0) {
+        return 0;
+    }
+    Uint64 target = (Uint64)std::ceil(std::min(std::max(percent,0.0),1.0)*count);
+    Uint64 seen = 0;
+    for(Uint32 ii = 0; ii < TIME_BUCKETS; ii++) {
+        seen += buckets[ii];
+        if (seen >= target && seen > 0) {
+            return std::min(((Uint64)1) << ii,peak);
+        }
+    }
+    return peak;
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an uninitialized profiler.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a profiler
+ * on the heap, use one of the static constructors instead.
+ */
+AudioProfiler::AudioProfiler() :
+_enabled(false),
+_tracing(false),
+_currvoices(0),
+_currunders(0),
+_callbacks(0),
+_peakvoices(0),
+_underruns(0),
+_dropped(0) {
+    reset();
+}
+
+/**
+ * Initializes a disabled profiler with the given trace capacity.
+ *
+ * @param capacity  The number of trace records buffered between dumps
+ *
+ * @return true if initialization was successful
+ */
+bool AudioProfiler::init(Uint32 capacity) {
+    _start.mark();
+    return _trace.init(capacity);
+}
+
+/**
+ * Disposes all resources of this profiler.
+ *
+ * This method must not be called while an audio thread is recording.
+ */
+void AudioProfiler::dispose() {
+    _enabled.store(false);
+    _tracing.store(false);
+    _trace.dispose();
+}
+
+#pragma mark -
+#pragma mark Recording
+/**
+ * Adds a time to the given histogram
+ *
+ * @param counters  The histogram counters
+ * @param micros    The time in microseconds
+ */
+void AudioProfiler::accumulate(Counters& counters, Uint64 micros) {
+    counters.count.fetch_add(1,std::memory_order_relaxed);
+    counters.total.fetch_add(micros,std::memory_order_relaxed);
+    counters.buckets[time_bucket(micros)].fetch_add(1,std::memory_order_relaxed);
+    atomic_max(counters.peak,micros);
+}
+
+/**
+ * Completes the statistics for an output callback
+ *
+ * AUDIO THREAD ONLY: This method is called by {@link AudioOutput}. It
+ * adds the per-callback values to the histograms, and pushes a trace
+ * record if tracing.
+ *
+ * @param nanos     The total callback time in nanoseconds
+ * @param frames    The number of frames in the callback
+ * @param rate      The sample rate of the output device
+ */
+void AudioProfiler::endCallback(Uint64 nanos, Uint32 frames, Uint32 rate) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    Trace trace;
+    _current[(int)Stage::OUTPUT].store(nanos,std::memory_order_relaxed);
+    for(Uint32 ii = 0; ii < STAGES; ii++) {
+        Uint64 micros = _current[ii].exchange(0,std::memory_order_relaxed)/1000;
+        accumulate(_stages[ii],micros);
+        trace.stages[ii] = (Uint32)std::min(micros,(Uint64)UINT32_MAX);
+    }
+    _callbacks.fetch_add(1,std::memory_order_relaxed);
+
+    // The deadline is the time it takes to play the buffer
+    Uint64 deadline = rate ? ((Uint64)frames*1000000000)/rate : 0;
+    Uint32 bucket = LOAD_BUCKETS-1;
+    if (deadline && nanos <= deadline) {
+        bucket = std::min((Uint32)((nanos*(LOAD_BUCKETS-1))/deadline),LOAD_BUCKETS-2);
+    }
+    _load[bucket].fetch_add(1,std::memory_order_relaxed);
+
+    Uint32 voices = _currvoices.exchange(0,std::memory_order_relaxed);
+    _voices[std::min(voices,VOICE_BUCKETS-1)].fetch_add(1,std::memory_order_relaxed);
+    atomic_max(_peakvoices,voices);
+    Uint32 unders = _currunders.exchange(0,std::memory_order_relaxed);
+    _underruns.fetch_add(unders,std::memory_order_relaxed);
+
+    if (isTracing()) {
+        Timestamp now;
+        trace.time = Timestamp::ellapsedMicros(_start,now);
+        trace.frames = frames;
+        trace.deadline = (Uint32)(deadline/1000);
+        trace.voices = voices;
+        trace.underruns = unders;
+        if (!_trace.push(std::move(trace))) {
+            _dropped.fetch_add(1,std::memory_order_relaxed);
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Reporting
+/**
+ * Returns a copy of the current statistics.
+ *
+ * @return a copy of the current statistics.
+ */
+AudioProfiler::Snapshot AudioProfiler::snapshot() const {
+    Snapshot result;
+    result.callbacks = _callbacks.load(std::memory_order_relaxed);
+    for(Uint32 ii = 0; ii < STAGES; ii++) {
+        const Counters& src = _stages[ii];
+        Histogram& dst = result.stages[ii];
+        dst.count = src.count.load(std::memory_order_relaxed);
+        dst.total = src.total.load(std::memory_order_relaxed);
+        dst.peak  = src.peak.load(std::memory_order_relaxed);
+        for(Uint32 jj = 0; jj < TIME_BUCKETS; jj++) {
+            dst.buckets[jj] = src.buckets[jj].load(std::memory_order_relaxed);
+        }
+    }
+    for(Uint32 ii = 0; ii < LOAD_BUCKETS; ii++) {
+        result.load[ii] = _load[ii].load(std::memory_order_relaxed);
+    }
+    result.overruns = result.load[LOAD_BUCKETS-1];
+    for(Uint32 ii = 0; ii < VOICE_BUCKETS; ii++) {
+        result.voices[ii] = _voices[ii].load(std::memory_order_relaxed);
+    }
+    result.peakVoices = _peakvoices.load(std::memory_order_relaxed);
+    result.underruns  = _underruns.load(std::memory_order_relaxed);
+    result.dropped    = _dropped.load(std::memory_order_relaxed);
+    return result;
+}
+
+/**
+ * Resets all statistics to zero.
+ *
+ * This does not clear the trace queue.
+ */
+void AudioProfiler::reset() {
+    for(Uint32 ii = 0; ii < STAGES; ii++) {
+        Counters& counters = _stages[ii];
+        counters.count.store(0,std::memory_order_relaxed);
+        counters.total.store(0,std::memory_order_relaxed);
+        counters.peak.store(0,std::memory_order_relaxed);
+        for(Uint32 jj = 0; jj < TIME_BUCKETS; jj++) {
+            counters.buckets[jj].store(0,std::memory_order_relaxed);
+        }
+        _current[ii].store(0,std::memory_order_relaxed);
+    }
+    for(Uint32 ii = 0; ii < LOAD_BUCKETS; ii++) {
+        _load[ii].store(0,std::memory_order_relaxed);
+    }
+    for(Uint32 ii = 0; ii < VOICE_BUCKETS; ii++) {
+        _voices[ii].store(0,std::memory_order_relaxed);
+    }
+    _callbacks.store(0,std::memory_order_relaxed);
+    _peakvoices.store(0,std::memory_order_relaxed);
+    _underruns.store(0,std::memory_order_relaxed);
+    _dropped.store(0,std::memory_order_relaxed);
+}
+
+/**
+ * Returns a human-readable summary of the current statistics
+ *
+ * The summary gives the average, 99th percentile and peak of each stage,
+ * the load distribution, and the overrun, underrun and voice counts.
+ *
+ * @return a human-readable summary of the current statistics
+ */
+std::string AudioProfiler::report() const {
+    Snapshot stats = snapshot();
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    ss << "Audio profile (" << stats.callbacks << " callbacks, microseconds)";
+    for(Uint32 ii = 0; ii < STAGES; ii++) {
+        const Histogram& hist = stats.stages[ii];
+        ss << "\n" << std::left << std::setw(10) << STAGE_NAMES[ii] << std::right;
+        ss << "  avg " << hist.getAverage();
+        ss << "  p99 " << hist.getPercentile(0.99);
+        ss << "  peak " << hist.peak;
+    }
+    ss << "\nload     ";
+    for(Uint32 ii = 0; ii < LOAD_BUCKETS-1; ii++) {
+        ss << " " << ii*10 << "%:" << stats.load[ii];
+    }
+    ss << "\noverruns " << stats.overruns << "  underruns " << stats.underruns;
+    ss << "  peak voices " << stats.peakVoices;
+    if (stats.dropped) {
+        ss << "  dropped traces " << stats.dropped;
+    }
+    return ss.str();
+}
+
+/**
+ * Writes all pending trace records to the given writer.
+ *
+ * MAIN THREAD ONLY: The records are removed from the queue as they are
+ * written. See {@link Trace} for the record format. This method does not
+ * flush the writer.
+ *
+ * @param writer    The writer to store the trace
+ *
+ * @return the number of records written
+ */
+size_t AudioProfiler::dump(const std::shared_ptr<BinaryWriter>& writer) {
+    CUAssertLog(writer, "Attempt to dump a trace to a null writer");
+    size_t count = 0;
+    Trace trace;
+    while (_trace.pop(trace)) {
+        writer->writeUint64(trace.time);
+        writer->writeUint32(trace.frames);
+        writer->writeUint32(trace.deadline);
+        writer->write(trace.stages,STAGES);
+        writer->writeUint32(trace.voices);
+        writer->writeUint32(trace.underruns);
+        count++;
+    }
+    return count;
+}
@@ -39,10 +39,162 @@
 #include <cugl/audio/graph/CUAudioPlayer.h>
 #include <cugl/util/CUDebug.h>
 #include <cugl/util/CUFiletools.h>
+#include <cugl/math/dsp/CUDSPMath.h>
 #include <cugl/audio/codecs/cu_codecs.h>
+#include <algorithm>
+#include <cmath>
 
 using namespace cugl;
 
+/** The number of frames in a single ADPCM block */
+const Uint32 AudioSample::ADPCM_BLOCK = 256;
+
+#pragma mark -
+#pragma mark IMA ADPCM
+// Each ADPCM block stores ADPCM_BLOCK frames. It starts with a 4 byte header
+// per channel (the 16 bit predictor and the step index before the first
+// frame), followed by the 4 bit codes of each channel in turn. Since every
+// block records its own starting state, playback may start at any block.
+
+/** The number of header bytes for each channel of an ADPCM block */
+#define ADPCM_HEADER 4
+
+/** The IMA ADPCM quantizer step sizes */
+static const Sint16 IMA_STEPS[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+
+/** The IMA ADPCM step index adjustments (by code magnitude) */
+static const Sint8 IMA_INDEX[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+/**
+ * Returns the number of bytes in an ADPCM block with the given channels
+ *
+ * @param channels  The number of audio channels
+ *
+ * @return the number of bytes in an ADPCM block with the given channels
+ */
+static size_t adpcm_block_size(Uint32 channels) {
+    return channels*(ADPCM_HEADER+AudioSample::ADPCM_BLOCK/2);
+}
+
+/**
+ * Applies a single 4 bit code to the decoder state
+ *
+ * @param code      The 4 bit code
+ * @param predictor The predicted sample value
+ * @param index     The step index
+ */
+static inline void adpcm_step(Uint8 code, int& predictor, int& index) {
+    int step  = IMA_STEPS[index];
+    int delta = step >> 3;
+    if (code & 4) {
+        delta += step;
+    }
+    if (code & 2) {
+        delta += step >> 1;
+    }
+    if (code & 1) {
+        delta += step >> 2;
+    }
+    predictor += (code & 8) ? -delta : delta;
+    predictor = std::max(-32768,std::min(32767,predictor));
+    index += IMA_INDEX[code & 7];
+    index = std::max(0,std::min(88,index));
+}
+
+/**
+ * Encodes interleaved float samples as ADPCM blocks
+ *
+ * The output must have room for one block for every ADPCM_BLOCK frames
+ * (rounded up). Any unused codes in the last block are zero.
+ *
+ * @param input     The interleaved float samples
+ * @param frames    The number of frames to encode
+ * @param channels  The number of audio channels
+ * @param output    The buffer to store the blocks
+ */
+static void adpcm_encode(const float* input, Uint64 frames, Uint32 channels, Uint8* output) {
+    size_t blocksize = adpcm_block_size(channels);
+    Uint64 blocks = (frames+AudioSample::ADPCM_BLOCK-1)/AudioSample::ADPCM_BLOCK;
+    std::memset(output,0,blocks*blocksize);
+    for(Uint32 ch = 0; ch < channels; ch++) {
+        int predictor = 0;
+        int index = 0;
+        for(Uint64 block = 0; block < blocks; block++) {
+            Uint8* header = output+block*blocksize+ch*ADPCM_HEADER;
+            header[0] = (Uint8)(predictor & 0xff);
+            header[1] = (Uint8)((predictor >> 8) & 0xff);
+            header[2] = (Uint8)index;
+
+            Uint8* codes = output+block*blocksize+channels*ADPCM_HEADER+ch*AudioSample::ADPCM_BLOCK/2;
+            Uint64 first = block*AudioSample::ADPCM_BLOCK;
+            Uint32 count = (Uint32)std::min((Uint64)AudioSample::ADPCM_BLOCK,frames-first);
+            for(Uint32 ii = 0; ii < count; ii++) {
+                float value = input[(first+ii)*channels+ch]*32768.0f;
+                int sample = (int)std::lround(std::max(-32768.0f,std::min(32767.0f,value)));
+                int diff = sample-predictor;
+                Uint8 code = 0;
+                if (diff < 0) {
+                    code = 8;
+                    diff = -diff;
+                }
+                int step = IMA_STEPS[index];
+                if (diff >= step) {
+                    code |= 4;
+                    diff -= step;
+                }
+                step >>= 1;
+                if (diff >= step) {
+                    code |= 2;
+                    diff -= step;
+                }
+                step >>= 1;
+                if (diff >= step) {
+                    code |= 1;
+                }
+                adpcm_step(code,predictor,index);
+                codes[ii/2] |= (ii & 1) ? (code << 4) : code;
+            }
+        }
+    }
+}
+
+/**
+ * Decodes part of an ADPCM block into interleaved float samples
+ *
+ * The codes before the start frame must still be decoded to recover the
+ * predictor state, so decoding is cheapest at the start of a block.
+ *
+ * @param block     The ADPCM block
+ * @param channels  The number of audio channels
+ * @param start     The first frame in the block to output
+ * @param count     The number of frames to output
+ * @param output    The buffer to store the interleaved samples
+ */
+static void adpcm_decode(const Uint8* block, Uint32 channels, Uint32 start, Uint32 count, float* output) {
+    for(Uint32 ch = 0; ch < channels; ch++) {
+        const Uint8* header = block+ch*ADPCM_HEADER;
+        int predictor = (Sint16)(header[0] | (header[1] << 8));
+        int index = header[2];
+        const Uint8* codes = block+channels*ADPCM_HEADER+ch*AudioSample::ADPCM_BLOCK/2;
+        for(Uint32 ii = 0; ii < start+count; ii++) {
+            Uint8 code = (ii & 1) ? (codes[ii/2] >> 4) : (codes[ii/2] & 0xf);
+            adpcm_step(code,predictor,index);
+            if (ii >= start) {
+                output[(ii-start)*channels+ch] = predictor*(1.0f/32768.0f);
+            }
+        }
+    }
+}
+
+#pragma mark -
 #pragma mark Constructors
 
 /**
@@ -54,7 +206,13 @@ using namespace cugl;
 AudioSample::AudioSample() : Sound(),
 _frames(0),
 _stream(false),
-_buffer(nullptr) {
+_buffer(nullptr),
+_encoding(Encoding::FLOAT),
+_pcm16(nullptr),
+_adpcm(nullptr),
+_decoded(nullptr),
+_starts(0),
+_tracked(false) {
     _type = Type::UNKNOWN;
 }
 
@@ -63,14 +221,16 @@ _buffer(nullptr) {
  *
  * The choice of buffered or streaming is independent of the file type.
  * If the file is streamed, it will not be loaded into memory.  Otherwise,
- * this initializer will allocate memory to read the asset into memory.
+ * this initializer will allocate memory to read the asset into memory,
+ * storing it with the given encoding.
  *
  * @param file      The source file for the audio sample
  * @param stream    Wether to stream the audio from the file.
+ * @param encoding  The storage format for an in-memory sample
  *
  * @return true if the sound source was initialized successfully
  */
-bool AudioSample::init(const char* file, bool stream) {
+bool AudioSample::init(const char* file, bool stream, Encoding encoding) {
     CUAssertLog(filetool::file_exists(file), "Cannot find file %s",file);
     _file = file;
     _type = guessType(file);
@@ -86,9 +246,35 @@ bool AudioSample::init(const char* file, bool stream) {
     _rate   = decoder->getSampleRate();
     
     if (!_stream) {
-        _buffer = (float*)SDL_malloc((size_t)(_frames*_channels*sizeof(float)));
-        Sint64 size = decoder->decode(_buffer);
-        return size >= 0;
+        size_t size = (size_t)(_frames*_channels);
+        float* buffer = (float*)SDL_malloc(size*sizeof(float));
+        if (decoder->decode(buffer) < 0) {
+            SDL_free(buffer);
+            return false;
+        }
+
+        _encoding = encoding;
+        switch (encoding) {
+            case Encoding::PCM16:
+                _pcm16 = (Sint16*)SDL_malloc(size*sizeof(Sint16));
+                for(size_t ii = 0; ii < size; ii++) {
+                    float value = std::max(-32768.0f,std::min(32767.0f,buffer[ii]*32768.0f));
+                    _pcm16[ii] = (Sint16)std::lround(value);
+                }
+                SDL_free(buffer);
+                break;
+            case Encoding::ADPCM:
+            {
+                Uint64 blocks = (_frames+ADPCM_BLOCK-1)/ADPCM_BLOCK;
+                _adpcm = (Uint8*)SDL_malloc((size_t)(blocks*adpcm_block_size(_channels)));
+                adpcm_encode(buffer,_frames,_channels,_adpcm);
+                SDL_free(buffer);
+            }
+                break;
+            default:
+                _buffer = buffer;
+                break;
+        }
     }
     return true;
 }
@@ -116,6 +302,59 @@ bool AudioSample::init(Uint8 channels, Uint32 rate, Uint32 frames) {
     return true;
 }
 
+/**
+ * Initializes an in-memory audio sample from previously decoded samples.
+ *
+ * The samples must be in the given storage format, as returned by
+ * {@link getSamples} for a sample with the same encoding, channels and
+ * frames. They are copied, so the data may be released afterwards. The
+ * file is only recorded as the source; it is not read. This method fails
+ * if the size does not match the channels, frames and encoding.
+ *
+ * @param file      The source file for the audio sample
+ * @param channels  The number of audio channels
+ * @param rate      The sampling rate of this source
+ * @param frames    The number of frames in this source
+ * @param encoding  The storage format of the samples
+ * @param data      The samples in the storage format
+ * @param size      The number of bytes of samples
+ *
+ * @return true if the audio sample was initialized successfully
+ */
+bool AudioSample::initWithSamples(const std::string& file, Uint8 channels, Uint32 rate, Uint64 frames,
+                                  Encoding encoding, const void* data, size_t size) {
+    _file = file;
+    _type = guessType(file);
+    _stream = false;
+    _channels = channels;
+    _frames = frames;
+    _rate   = rate;
+    _encoding = encoding;
+    
+    if (size != getSampleBytes()) {
+        _channels = 0;
+        _frames = 0;
+        return false;
+    }
+    void* buffer = SDL_malloc(size);
+    if (buffer == nullptr) {
+        return false;
+    }
+    std::memcpy(buffer,data,size);
+    switch (encoding) {
+        case Encoding::PCM16:
+            _pcm16 = (Sint16*)buffer;
+            break;
+        case Encoding::ADPCM:
+            _adpcm = (Uint8*)buffer;
+            break;
+        default:
+            _buffer = (float*)buffer;
+            break;
+    }
+    return true;
+}
+
 /**
  * Returns a newly allocated audio sample with the given JSON specificaton.
  *
@@ -125,11 +364,13 @@ bool AudioSample::init(Uint8 channels, Uint32 rate, Uint32 frames) {
  *
  *      "file":     The path to the source, relative to the asset directory
  *      "stream":   A boolean, indicating whether to stream the sample
+ *      "encoding": One of "float", "pcm16", or "adpcm" (in-memory only)
  *      "volume":   A float, representing the volume
  *
  * All attributes are optional.  There are no required attributes. By default,
  * audio samples are not streamed, meaning they are fully loaded into memory.
- * This is recommended for sound effects, but not for music.
+ * This is recommended for sound effects, but not for music. In-memory
+ * samples are stored as floats unless another encoding is specified.
  *
  * @param data      The JSON object specifying the audio sample
  *
@@ -147,7 +388,29 @@ std::shared_ptr<AudioSample> AudioSample::allocWithData(const std::shared_ptr<Js
     CUAssertLog(!absolute, "The asset directory should not referece absolute paths.");
     
     bool stream = data->getBool("stream",false);
-    return AudioSample::alloc(source,stream);
+    Encoding encoding = parseEncoding(data->getString("encoding","float"));
+    return AudioSample::alloc(source,stream,encoding);
+}
+
+/**
+ * Returns the encoding with the given name.
+ *
+ * The name is one of "float", "pcm16", or "adpcm", as used by the JSON
+ * specification of {@link allocWithData}. Any other name is FLOAT.
+ *
+ * @param name  The encoding name
+ *
+ * @return the encoding with the given name.
+ */
+AudioSample::Encoding AudioSample::parseEncoding(const std::string& name) {
+    if (name == "pcm16") {
+        return Encoding::PCM16;
+    } else if (name == "adpcm") {
+        return Encoding::ADPCM;
+    } else if (name != "float") {
+        CUAssertLog(false, "Unknown audio sample encoding '%s'", name.c_str());
+    }
+    return Encoding::FLOAT;
 }
 
 /**
@@ -165,6 +428,20 @@ void AudioSample::dispose() {
         SDL_free(_buffer);
         _buffer = nullptr;
     }
+    if (_pcm16 != nullptr) {
+        SDL_free(_pcm16);
+        _pcm16 = nullptr;
+    }
+    if (_adpcm != nullptr) {
+        SDL_free(_adpcm);
+        _adpcm = nullptr;
+    }
+    float* decoded = _decoded.exchange(nullptr);
+    if (decoded != nullptr) {
+        SDL_free(decoded);
+    }
+    _starts.store(0);
+    _encoding = Encoding::FLOAT;
     _type = Type::UNKNOWN;
 }
 
@@ -264,3 +541,158 @@ std::shared_ptr<audio::AudioNode> AudioSample::createNode() {
     player->setGain(_volume);
     return std::dynamic_pointer_cast<audio::AudioNode>(player);
 }
+
+#pragma mark -
+#pragma mark Compact Encodings
+/**
+ * Returns the number of bytes of sample data resident in memory.
+ *
+ * This includes the decoded copy of an ADPCM sample, if the streamer
+ * currently holds one. Streamed samples have no resident data.
+ *
+ * @return the number of bytes of sample data resident in memory.
+ */
+size_t AudioSample::getMemoryUsage() const {
+    size_t size = (size_t)(_frames*_channels);
+    size_t result = 0;
+    if (_buffer != nullptr) {
+        result += size*sizeof(float);
+    }
+    if (_pcm16 != nullptr) {
+        result += size*sizeof(Sint16);
+    }
+    if (_adpcm != nullptr) {
+        Uint64 blocks = (_frames+ADPCM_BLOCK-1)/ADPCM_BLOCK;
+        result += (size_t)(blocks*adpcm_block_size(_channels));
+    }
+    if (_decoded.load(std::memory_order_relaxed) != nullptr) {
+        result += size*sizeof(float);
+    }
+    return result;
+}
+
+/**
+ * Returns the in-memory samples in their storage format.
+ *
+ * Depending on the encoding, this is an array of floats, an array of 16
+ * bit integers, or a sequence of ADPCM blocks. It is nullptr if the sample
+ * is streamed. The samples may be passed to {@link initWithSamples} to
+ * recreate this sample without decoding the file again.
+ *
+ * @return the in-memory samples in their storage format.
+ */
+const void* AudioSample::getSamples() const {
+    switch (_encoding) {
+        case Encoding::PCM16:
+            return _pcm16;
+        case Encoding::ADPCM:
+            return _adpcm;
+        default:
+            return _buffer;
+    }
+}
+
+/**
+ * Returns the number of bytes returned by {@link getSamples}.
+ *
+ * Unlike {@link getMemoryUsage}, this does not include the decoded copy
+ * of an ADPCM sample.
+ *
+ * @return the number of bytes returned by {@link getSamples}.
+ */
+size_t AudioSample::getSampleBytes() const {
+    if (_stream) {
+        return 0;
+    }
+    size_t size = (size_t)(_frames*_channels);
+    switch (_encoding) {
+        case Encoding::PCM16:
+            return size*sizeof(Sint16);
+        case Encoding::ADPCM:
+        {
+            Uint64 blocks = (_frames+ADPCM_BLOCK-1)/ADPCM_BLOCK;
+            return (size_t)(blocks*adpcm_block_size(_channels));
+        }
+        default:
+            return size*sizeof(float);
+    }
+}
+
+/**
+ * Reads frames from an in-memory sample, converting them to floats.
+ *
+ * This method is safe to call from the audio thread. It never allocates
+ * memory. If the sample has a compact encoding, the frames are converted
+ * as they are copied (unless the streamer holds a decoded copy). Reading
+ * from the start of the sample counts as a playback for the purposes of
+ * the decoded copy cache.
+ *
+ * The buffer must have room for frames * channels elements. This method
+ * does nothing if the sample is streamed.
+ *
+ * @param buffer    The buffer to store the frames
+ * @param frame     The absolute position of the first frame to read
+ * @param frames    The maximum number of frames to read
+ *
+ * @return the number of frames read
+ */
+Uint32 AudioSample::read(float* buffer, Uint64 frame, Uint32 frames) {
+    if (_stream || frame >= _frames) {
+        return 0;
+    }
+    
+    Uint32 amt = (Uint32)std::min((Uint64)frames,_frames-frame);
+    if (frame == 0) {
+        _starts.fetch_add(1,std::memory_order_relaxed);
+    }
+    
+    switch (_encoding) {
+        case Encoding::FLOAT:
+            std::memcpy(buffer,_buffer+frame*_channels,amt*_channels*sizeof(float));
+            break;
+        case Encoding::PCM16:
+            dsp::DSPMath::convert(_pcm16+frame*_channels,buffer,amt*_channels);
+            break;
+        case Encoding::ADPCM:
+        {
+            float* decoded = _decoded.load(std::memory_order_acquire);
+            if (decoded != nullptr) {
+                std::memcpy(buffer,decoded+frame*_channels,amt*_channels*sizeof(float));
+                break;
+            }
+            size_t blocksize = adpcm_block_size(_channels);
+            Uint32 done = 0;
+            while (done < amt) {
+                Uint64 pos = frame+done;
+                Uint32 start = (Uint32)(pos % ADPCM_BLOCK);
+                Uint32 count = std::min(ADPCM_BLOCK-start,amt-done);
+                adpcm_decode(_adpcm+(pos/ADPCM_BLOCK)*blocksize,_channels,start,count,
+                             buffer+done*_channels);
+                done += count;
+            }
+        }
+            break;
+    }
+    return amt;
+}
+
+/**
+ * Returns a newly allocated float copy of the ADPCM blocks
+ *
+ * The copy is allocated with SDL_malloc and contains channels * frames
+ * elements. This method returns nullptr if the sample is not ADPCM.
+ *
+ * @return a newly allocated float copy of the ADPCM blocks
+ */
+float* AudioSample::decodeADPCM() const {
+    if (_adpcm == nullptr) {
+        return nullptr;
+    }
+    float* result = (float*)SDL_malloc((size_t)(_frames*_channels*sizeof(float)));
+    size_t blocksize = adpcm_block_size(_channels);
+    for(Uint64 pos = 0; pos < _frames; pos += ADPCM_BLOCK) {
+        Uint32 count = (Uint32)std::min((Uint64)ADPCM_BLOCK,_frames-pos);
+        adpcm_decode(_adpcm+(pos/ADPCM_BLOCK)*blocksize,_channels,0,count,result+pos*_channels);
+    }
+    return result;
+}
@@ -0,0 +1,571 @@
+//
+//  CUAudioStreamer.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides support for decoding streamed audio samples off the
+//  audio thread. A streamed sample (such as OGG or MP3 music) is not loaded
+//  into memory. Previously, each player decoded its pages on demand inside
+//  of the audio callback, which meant that codec work (and file access) could
+//  cause the callback to miss its deadline.
+//
+//  Instead, each streamed player now owns a page cache. The cache holds a
+//  fixed number of decoded pages in a wait-free ring, filled ahead of the
+//  read position by a single background streamer thread. The audio thread
+//  only ever copies decoded frames out of the cache. The first few pages of
+//  the sample are decoded once (when the cache is created) and kept resident,
+//  so that loops and queued tracks can start without waiting on the decoder.
+//
+//  These classes use our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#include <cugl/audio/CUAudioStreamer.h>
+#include <cugl/audio/CUAudioSample.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+using namespace cugl::audio;
+using namespace cugl;
+
+/** The number of bits in a seek request reserved for the frame position */
+#define FRAME_BITS  40
+/** The mask for the frame position of a seek request */
+#define FRAME_MASK  ((((Uint64)1) << FRAME_BITS)-1)
+/** The mask for the epoch of a seek request */
+#define EPOCH_MASK  0xFFFFFF
+/** How long the streamer sleeps when every cache is full (in milliseconds) */
+#define POLL_INTERVAL 5
+/** How often the decoded copies are updated (in milliseconds) */
+#define CACHE_INTERVAL 100
+/** How long a released copy may still be read by the audio thread (in milliseconds) */
+#define GRACE_PERIOD 1000
+
+/** The default read-ahead time of the ring in seconds */
+const double AudioPageCache::DEFAULT_READAHEAD = 0.5;
+/** The minimum number of pages in the ring or anchor */
+const Uint32 AudioPageCache::MIN_PAGES = 4;
+/** The default memory budget for decoded copies in bytes */
+const size_t AudioStreamer::DEFAULT_CACHE_BUDGET = 1 << 20;
+
+/**
+ * Returns the current time in milliseconds
+ *
+ * @return the current time in milliseconds
+ */
+static Uint64 elapsed_millis() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return (Uint64)std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+}
+
+#pragma mark -
+#pragma mark Page Cache
+/**
+ * Creates an uninitialized page cache.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a cache on
+ * the heap, use one of the static constructors instead.
+ */
+AudioPageCache::AudioPageCache() :
+_decoder(nullptr),
+_channels(0),
+_pagesize(0),
+_anchor(nullptr),
+_anchorsize(0),
+_anchorpages(0),
+_pages(nullptr),
+_slots(nullptr),
+_capacity(0),
+_head(0),
+_tail(0),
+_request(0),
+_endframe(UINT64_MAX),
+_underruns(0),
+_epoch(EPOCH_MASK),
+_nextpage(0),
+_finished(false) {
+}
+
+/**
+ * Disposes this page cache, releasing all resources.
+ *
+ * This method is not thread-safe, and should only be called when no
+ * other thread is accessing the cache.
+ */
+void AudioPageCache::dispose() {
+    if (_decoder != nullptr) {
+        _decoder->dispose();
+        _decoder = nullptr;
+    }
+    if (_anchor != nullptr) {
+        free(_anchor);
+        _anchor = nullptr;
+    }
+    if (_pages != nullptr) {
+        free(_pages);
+        _pages = nullptr;
+    }
+    if (_slots != nullptr) {
+        delete[] _slots;
+        _slots = nullptr;
+    }
+    _channels = 0;
+    _pagesize = 0;
+    _anchorsize  = 0;
+    _anchorpages = 0;
+    _capacity = 0;
+    _head.store(0,std::memory_order_relaxed);
+    _tail.store(0,std::memory_order_relaxed);
+    _request.store(0,std::memory_order_relaxed);
+    _endframe.store(UINT64_MAX,std::memory_order_relaxed);
+    _underruns.store(0,std::memory_order_relaxed);
+    _epoch = EPOCH_MASK;
+    _nextpage = 0;
+    _finished = false;
+}
+
+/**
+ * Initializes a page cache for the given decoder.
+ *
+ * The cache takes ownership of the decoder, which should not be used by
+ * any other object. Both the anchor and the ring are sized to hold the
+ * given read-ahead time (but never fewer than {@link #MIN_PAGES} pages).
+ * The anchor is decoded immediately, so this method should be called on
+ * the main thread and not the audio thread.
+ *
+ * @param decoder   The decoder for the streamed sample
+ * @param readahead The read-ahead time in seconds
+ *
+ * @return true if initialization was successful.
+ */
+bool AudioPageCache::init(const std::shared_ptr<AudioDecoder>& decoder, double readahead) {
+    CUAssertLog(_decoder == nullptr, "Page cache is already initialized");
+    if (decoder == nullptr || decoder->getPageSize() == 0) {
+        return false;
+    }
+
+    _decoder  = decoder;
+    _channels = decoder->getChannels();
+    _pagesize = decoder->getPageSize();
+
+    Uint32 pages = (Uint32)std::ceil(readahead*decoder->getSampleRate()/_pagesize);
+    pages = std::max(pages,MIN_PAGES);
+    _capacity = 1;
+    while (_capacity < pages) {
+        _capacity <<= 1;
+    }
+
+    size_t pagelen = (size_t)_pagesize*_channels;
+    _pages = (float*)malloc(_capacity*pagelen*sizeof(float));
+    _slots = new Slot[_capacity];
+    std::memset(_pages,0,_capacity*pagelen*sizeof(float));
+
+    // Decode the anchor now, so the start never waits on the streamer
+    _anchorpages = std::min((Uint64)pages,decoder->getPageCount());
+    _anchor = (float*)malloc(std::max((Uint64)1,_anchorpages)*pagelen*sizeof(float));
+    _decoder->setPage(0);
+    for(Uint64 ii = 0; ii < _anchorpages; ii++) {
+        Sint32 amt = _decoder->pagein(_anchor+ii*pagelen);
+        amt = amt < 0 ? 0 : amt;
+        _anchorsize += amt;
+        if ((Uint32)amt < _pagesize) {
+            _anchorpages = ii+1;
+            _endframe.store(_anchorsize,std::memory_order_release);
+            break;
+        }
+    }
+    return true;
+}
+
+#pragma mark -
+#pragma mark Consumer Methods
+/**
+ * Copies up to the given number of frames starting at the given position.
+ *
+ * AUDIO THREAD ONLY: This method should only be called by the consumer.
+ *
+ * The frames are interleaved into the buffer, which must have room for
+ * frames * channels elements. Reads must be sequential: the position
+ * should be the end of the previous read unless {@link #seek} was called
+ * in between.
+ *
+ * This method never decodes. If the producer has not yet decoded the
+ * requested frames, it copies as many as are available and returns early.
+ * Use {@link #isEnded} to distinguish this from the end of the stream.
+ *
+ * @param buffer    The buffer to store the frames
+ * @param frame     The absolute position of the first frame to read
+ * @param frames    The maximum number of frames to read
+ *
+ * @return the number of frames copied
+ */
+Uint32 AudioPageCache::read(float* buffer, Uint64 frame, Uint32 frames) {
+    Uint32 epoch  = (Uint32)(_request.load(std::memory_order_acquire) >> FRAME_BITS);
+    Uint64 ending = _endframe.load(std::memory_order_acquire);
+    Uint32 head   = _head.load(std::memory_order_relaxed);
+    Uint32 mask   = _capacity-1;
+
+    Uint32 copied = 0;
+    while (copied < frames) {
+        Uint64 pos = frame+copied;
+        if (pos >= ending) {
+            return copied;
+        } else if (pos < _anchorsize) {
+            Uint32 amt = (Uint32)std::min((Uint64)(frames-copied),_anchorsize-pos);
+            std::memcpy(buffer+copied*_channels,_anchor+pos*_channels,amt*_channels*sizeof(float));
+            copied += amt;
+            continue;
+        }
+
+        // Discard stale pages until we find the one we need
+        Uint64 page = pos/_pagesize;
+        Slot* slot = nullptr;
+        while (slot == nullptr && head != _tail.load(std::memory_order_acquire)) {
+            Slot* next = _slots+(head & mask);
+            if (next->epoch != epoch || next->page < page) {
+                head++;
+                _head.store(head,std::memory_order_release);
+            } else if (next->page > page) {
+                // We got ahead of ourselves without a seek; resynchronize
+                seek(pos);
+                break;
+            } else {
+                slot = next;
+            }
+        }
+
+        Uint32 offset = (Uint32)(pos-page*_pagesize);
+        if (slot == nullptr || offset >= slot->frames) {
+            break;
+        }
+
+        Uint32 amt = std::min(frames-copied,slot->frames-offset);
+        float* input = _pages+((size_t)(head & mask)*_pagesize+offset)*_channels;
+        std::memcpy(buffer+copied*_channels,input,amt*_channels*sizeof(float));
+        copied += amt;
+        if (offset+amt == slot->frames) {
+            head++;
+            _head.store(head,std::memory_order_release);
+        }
+    }
+
+    if (copied < frames && !isEnded(frame+copied)) {
+        _underruns.fetch_add(1,std::memory_order_relaxed);
+    }
+    return copied;
+}
+
+/**
+ * Requests that future reads start at the given position.
+ *
+ * This method may be called from any thread. It discards all pages in the
+ * ring, and the producer restarts decoding at the page containing the
+ * given frame. If the frame is in the anchor, reads resume immediately.
+ *
+ * @param frame     The absolute frame position
+ */
+void AudioPageCache::seek(Uint64 frame) {
+    Uint64 request = _request.load(std::memory_order_relaxed);
+    Uint64 result;
+    do {
+        Uint64 epoch = ((request >> FRAME_BITS)+1) & EPOCH_MASK;
+        result = (epoch << FRAME_BITS) | (frame & FRAME_MASK);
+    } while (!_request.compare_exchange_weak(request,result,std::memory_order_acq_rel));
+}
+
+#pragma mark -
+#pragma mark Producer Methods
+/**
+ * Decodes at most one page into the ring.
+ *
+ * STREAMER THREAD ONLY: This method should only be called by the producer.
+ *
+ * If the read position was changed by {@link #seek}, the decoder is
+ * repositioned first. This method does nothing if the ring is full or
+ * the stream is finished.
+ *
+ * @return true if a page was decoded
+ */
+bool AudioPageCache::fill() {
+    Uint64 request = _request.load(std::memory_order_acquire);
+    Uint32 epoch = (Uint32)(request >> FRAME_BITS);
+    if (epoch != _epoch) {
+        // Pages in the anchor never need to be decoded again
+        _epoch = epoch;
+        _nextpage = std::max((request & FRAME_MASK)/_pagesize,_anchorpages);
+        _finished = false;
+    }
+
+    if (_finished || _nextpage*_pagesize >= _endframe.load(std::memory_order_relaxed)) {
+        _finished = true;
+        return false;
+    }
+
+    Uint32 tail = _tail.load(std::memory_order_relaxed);
+    if (tail-_head.load(std::memory_order_acquire) >= _capacity) {
+        return false;
+    }
+
+    if (_decoder->getPage() != _nextpage) {
+        _decoder->setPage(_nextpage);
+    }
+
+    Uint32 index = tail & (_capacity-1);
+    Sint32 amt = _decoder->pagein(_pages+(size_t)index*_pagesize*_channels);
+    amt = amt < 0 ? 0 : amt;
+
+    Slot* slot = _slots+index;
+    slot->page   = _nextpage;
+    slot->frames = (Uint32)amt;
+    slot->epoch  = epoch;
+    if ((Uint32)amt < _pagesize) {
+        _endframe.store(_nextpage*_pagesize+amt,std::memory_order_release);
+        _finished = true;
+    }
+    _nextpage++;
+    _tail.store(tail+1,std::memory_order_release);
+    return true;
+}
+
+#pragma mark -
+#pragma mark Streamer
+/**
+ * Creates an inactive streamer.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a streamer on
+ * the heap, use one of the static constructors instead.
+ */
+AudioStreamer::AudioStreamer() :
+_thread(nullptr),
+_running(false),
+_budget(DEFAULT_CACHE_BUDGET),
+_passes(0),
+_lastpass(0) {
+}
+
+/**
+ * Disposes this streamer, stopping the thread.
+ *
+ * This method blocks until the thread has finished. Any attached caches
+ * stop filling, though they remain valid for their players.
+ */
+void AudioStreamer::dispose() {
+    if (_thread != nullptr) {
+        {
+            std::unique_lock<std::mutex> lk(_mutex);
+            _running.store(false);
+            _condition.notify_all();
+        }
+        int status;
+        SDL_WaitThread(_thread,&status);
+        _thread = nullptr;
+    }
+    _pending.clear();
+    _active.clear();
+    _fresh.clear();
+    _samples.clear();
+    // The audio thread has stopped, so there is no need to wait
+    for(auto it = _retired.begin(); it != _retired.end(); ++it) {
+        SDL_free(it->buffer);
+    }
+    _retired.clear();
+}
+
+/**
+ * Initializes this streamer, starting the thread.
+ *
+ * @return true if initialization was successful.
+ */
+bool AudioStreamer::init() {
+    CUAssertLog(_thread == nullptr, "Streamer is already running");
+    _running.store(true);
+    _thread = SDL_CreateThread(AudioStreamer::threadFunc,"Audio Streamer",(void*)this);
+    if (_thread == nullptr) {
+        _running.store(false);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Attaches a page cache to this streamer.
+ *
+ * The streamer will start filling the cache immediately. The streamer
+ * only holds the cache until it is released by its owner.
+ *
+ * @param cache The page cache to fill
+ */
+void AudioStreamer::attach(const std::shared_ptr<AudioPageCache>& cache) {
+    std::unique_lock<std::mutex> lk(_mutex);
+    _pending.push_back(cache);
+    _condition.notify_one();
+}
+
+/**
+ * Tracks an ADPCM sample for the decoded copy cache.
+ *
+ * Once tracked, the streamer keeps a decoded copy of the sample while it
+ * is among the most recently played samples that fit in the budget. The
+ * streamer does not keep the sample alive. Tracking a sample twice, or
+ * tracking a sample that is not ADPCM, has no effect.
+ *
+ * @param sample    The sample to track
+ */
+void AudioStreamer::track(const std::shared_ptr<AudioSample>& sample) {
+    if (sample == nullptr || sample->_tracked || sample->getEncoding() != AudioSample::Encoding::ADPCM) {
+        return;
+    }
+    sample->_tracked = true;
+    std::unique_lock<std::mutex> lk(_mutex);
+    _fresh.push_back(sample);
+}
+
+/**
+ * The body function of the streamer thread.
+ *
+ * @param streamer  The streamer object
+ *
+ * @return the thread exit status
+ */
+int AudioStreamer::threadFunc(void* streamer) {
+    ((AudioStreamer*)streamer)->run();
+    return 0;
+}
+
+/**
+ * Runs the fill loop until this streamer is disposed.
+ */
+void AudioStreamer::run() {
+    while (_running.load()) {
+        {
+            std::unique_lock<std::mutex> lk(_mutex);
+            _active.insert(_active.end(),_pending.begin(),_pending.end());
+            _pending.clear();
+            for(auto it = _fresh.begin(); it != _fresh.end(); ++it) {
+                Entry entry;
+                entry.sample = *it;
+                entry.stamp = 0;
+                _samples.push_back(entry);
+            }
+            _fresh.clear();
+        }
+
+        // Drop the caches whose players are gone
+        _active.erase(std::remove_if(_active.begin(), _active.end(),
+                                     [](const std::shared_ptr<AudioPageCache>& cache) {
+                                         return cache.use_count() == 1;
+                                     }), _active.end());
+
+        // One page from each cache per pass, so no stream starves the others
+        bool working = true;
+        while (working && _running.load()) {
+            working = false;
+            for(auto it = _active.begin(); it != _active.end(); ++it) {
+                working = (*it)->fill() || working;
+            }
+        }
+
+        Uint64 now = elapsed_millis();
+        if (now-_lastpass >= CACHE_INTERVAL) {
+            update(now);
+            _lastpass = now;
+        }
+
+        std::unique_lock<std::mutex> lk(_mutex);
+        if (_running.load() && _pending.empty()) {
+            _condition.wait_for(lk,std::chrono::milliseconds(POLL_INTERVAL));
+        }
+    }
+}
+
+/**
+ * Updates the decoded copies of the tracked samples.
+ *
+ * This method decodes the most recently played samples that fit in the
+ * budget, and releases the rest. It also frees any released copies that
+ * are past the grace period.
+ *
+ * @param now   The current time in milliseconds
+ */
+void AudioStreamer::update(Uint64 now) {
+    _passes++;
+    for(auto it = _samples.begin(); it != _samples.end(); ) {
+        std::shared_ptr<AudioSample> sample = it->sample.lock();
+        if (sample == nullptr) {
+            it = _samples.erase(it);
+        } else {
+            if (sample->_starts.exchange(0,std::memory_order_relaxed) > 0) {
+                it->stamp = _passes;
+            }
+            ++it;
+        }
+    }
+
+    // Most recently played first
+    std::stable_sort(_samples.begin(), _samples.end(), [](const Entry& a, const Entry& b) {
+        return a.stamp > b.stamp;
+    });
+
+    size_t budget = _budget.load(std::memory_order_relaxed);
+    size_t used = 0;
+    for(auto it = _samples.begin(); it != _samples.end(); ++it) {
+        std::shared_ptr<AudioSample> sample = it->sample.lock();
+        if (sample == nullptr) {
+            continue;
+        }
+        size_t bytes = (size_t)(sample->getLength()*sample->getChannels()*sizeof(float));
+        if (it->stamp > 0 && used+bytes <= budget) {
+            if (sample->_decoded.load(std::memory_order_relaxed) == nullptr) {
+                sample->_decoded.store(sample->decodeADPCM(),std::memory_order_release);
+            }
+            used += bytes;
+        } else {
+            float* decoded = sample->_decoded.exchange(nullptr,std::memory_order_acq_rel);
+            if (decoded != nullptr) {
+                Retired retired;
+                retired.buffer = decoded;
+                retired.time = now;
+                _retired.push_back(retired);
+            }
+        }
+    }
+
+    for(auto it = _retired.begin(); it != _retired.end(); ) {
+        if (now-it->time >= GRACE_PERIOD) {
+            SDL_free(it->buffer);
+            it = _retired.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
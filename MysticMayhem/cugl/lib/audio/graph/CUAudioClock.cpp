@@ -0,0 +1,134 @@
+//
+//  CUAudioClock.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a sample clock for an audio graph. The clock counts
+//  the frames pulled from the graph by its terminal node (an AudioOutput or
+//  an AudioRenderer). Nodes such as AudioScheduler use this clock to start
+//  and swap audio at an exact sample, instead of at the start of the next
+//  buffer. The main thread uses the same clock to timestamp those events.
+//
+//  The clock is advanced by the audio thread once per buffer. The main thread
+//  can estimate the time between buffers, as the clock also records the wall
+//  time of each advance. All access is lock-free.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#include <cugl/audio/graph/CUAudioClock.h>
+#include <algorithm>
+
+using namespace cugl;
+using namespace cugl::audio;
+
+#pragma mark Constructors
+/**
+ * Creates a clock with no sample rate.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a clock on
+ * the heap, use the static constructor instead.
+ */
+AudioClock::AudioClock() :
+_rate(0),
+_sequence(0),
+_frames(0),
+_stamp(0),
+_block(0) {
+}
+
+/**
+ * Initializes a clock at time 0 for the given sample rate.
+ *
+ * @param rate  The sample rate (frequency) in HZ
+ *
+ * @return true if initialization was successful
+ */
+bool AudioClock::init(Uint32 rate) {
+    _rate = rate;
+    _origin.mark();
+    reset();
+    return rate > 0;
+}
+
+#pragma mark Time
+/**
+ * Returns the estimated time of this clock in frames.
+ *
+ * This value adds the wall time since the last advance to the current
+ * time. The addition is limited to the size of the last buffer, so the
+ * estimate never passes the start of the next buffer.
+ *
+ * @return the estimated time of this clock in frames.
+ */
+Uint64 AudioClock::estimate() const {
+    Uint64 frames, stamp;
+    Uint32 block, seq;
+    do {
+        seq = _sequence.load(std::memory_order_acquire);
+        frames = _frames.load(std::memory_order_relaxed);
+        stamp  = _stamp.load(std::memory_order_relaxed);
+        block  = _block.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) || seq != _sequence.load(std::memory_order_relaxed));
+
+    if (block == 0) {
+        return frames;
+    }
+
+    Timestamp now;
+    Uint64 nanos = Timestamp::ellapsedNanos(_origin,now);
+    nanos = nanos > stamp ? nanos-stamp : 0;
+    Uint64 ahead = (nanos*_rate)/1000000000;
+    return frames+std::min(ahead,(Uint64)block);
+}
+
+/**
+ * Advances the clock by the given number of frames.
+ *
+ * AUDIO THREAD ONLY: This method should only be called by the terminal
+ * node of the audio graph, after it has read the given number of frames.
+ *
+ * @param frames    The number of frames read
+ */
+void AudioClock::advance(Uint32 frames) {
+    Timestamp now;
+    Uint64 stamp = Timestamp::ellapsedNanos(_origin,now);
+
+    Uint32 seq = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(seq+1,std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _stamp.store(stamp,std::memory_order_relaxed);
+    _block.store(frames,std::memory_order_relaxed);
+    _frames.store(_frames.load(std::memory_order_relaxed)+frames,std::memory_order_release);
+    _sequence.store(seq+2,std::memory_order_release);
+}
+
+/**
+ * Resets the clock to time 0.
+ *
+ * This should only be called when the audio graph is not being read.
+ */
+void AudioClock::reset() {
+    _frames.store(0,std::memory_order_relaxed);
+    _stamp.store(0,std::memory_order_relaxed);
+    _block.store(0,std::memory_order_relaxed);
+    _sequence.store(0,std::memory_order_release);
+}
@@ -10,6 +10,12 @@
 //  results may exceed the range [-1,1], causing clipping.  The mixer provides
 //  a "soft-knee" option for confining the results to the range [-1,1].
 //
+//  The audio thread never blocks on the main thread in this node. Changes to
+//  the inputs are posted to a wait-free command queue and applied at the start
+//  of the next buffer. Operations that must touch the inputs directly use a
+//  short exclusive section in which the audio thread outputs silence rather
+//  than waiting.
+//
 //  CUGL MIT License:
 //
 //     This software is provided 'as-is', without any express or implied
@@ -38,6 +44,7 @@
 #include <cugl/math/dsp/CUDSPMath.h>
 #include <cugl/util/CUDebug.h>
 #include <atomic>
+#include <thread>
 
 using namespace cugl;
 using namespace cugl::audio;
@@ -46,6 +53,8 @@ using namespace cugl::audio;
 const Uint8 AudioMixer::DEFAULT_WIDTH = 8;
 /** The standard knee value for preventing clipping */
 const float AudioMixer::DEFAULT_KNEE  = 0.9;
+/** The number of input changes that may be pending at once */
+const Uint32 AudioMixer::COMMAND_CAPACITY = 256;
 
 
 #pragma mark -
@@ -61,7 +70,11 @@ _width(0),
 _knee(-1),
 _capacity(0),
 _inputs(nullptr),
-_buffer(nullptr) {
+_attached(nullptr),
+_reading(false),
+_editing(false),
+_buffer(nullptr),
+_sources(nullptr) {
     _classname = "AudioScheduler";
 #if CU_PLATFORM == CU_PLATFORM_ANDROID
 	// Android handles clipping very badly.
@@ -140,17 +153,51 @@ bool AudioMixer::init(Uint8 channels, Uint32 rate) {
  * @return true if initialization was successful
  */
 bool AudioMixer::init(Uint8 width, Uint8 channels, Uint32 rate) {
+    if (!AudioDevices::get()) {
+        CUAssertLog(false,"Attempt to allocate a mixer without an active audio device manager");
+        return false;
+    }
+    return init(width,channels,rate,AudioDevices::get()->getReadSize());
+}
+
+/**
+ * Initializes the mixer with the given channels, sample rate and capacity
+ *
+ * These values determine the buffer the structure for all {@link read}
+ * operations.  In addition, they also detemine exactly which audio nodes
+ * are supported by this mixer.  A mixer can only mix nodes that agree
+ * on both sample rate and frequency.
+ *
+ * The capacity is the largest number of frames the mixer will produce in
+ * a single read. The other initializers use the read size of the audio
+ * device manager. Graphs that are not attached to a device (such as one
+ * read by an {@link AudioRenderer}) should use this initializer instead.
+ *
+ * @param width     The number of audio nodes that may be attached to this mixer
+ * @param channels  The number of audio channels
+ * @param rate      The sample rate (frequency) in HZ
+ * @param capacity  The maximum number of frames in a single read
+ *
+ * @return true if initialization was successful
+ */
+bool AudioMixer::init(Uint8 width, Uint8 channels, Uint32 rate, Uint32 capacity) {
     if (AudioNode::init(channels,rate)) {
         CUAssertLog(width,"Mixer width is 0");
+        CUAssertLog(capacity,"Mixer capacity is 0");
         _width = width;
         _knee  = -1;
-        _capacity = AudioDevices::get()->getReadSize();
+        _capacity = capacity;
         _inputs = new std::shared_ptr<AudioNode>[_width];
+        _attached = new std::shared_ptr<AudioNode>[_width];
         for (int ii = 0; ii < _width; ii++) {
             _inputs[ii] = nullptr;
+            _attached[ii] = nullptr;
         }
-        _buffer = (float*)malloc(_capacity*_channels*sizeof(float));
-        return true;
+        _buffer = (float*)malloc(_width*_capacity*_channels*sizeof(float));
+        _sources = new float*[_width];
+        _reading.store(false);
+        _editing.store(false);
+        return _commands.init(COMMAND_CAPACITY) && _retired.init(COMMAND_CAPACITY);
     }
     return false;
 }
@@ -164,10 +211,16 @@ bool AudioMixer::init(Uint8 width, Uint8 channels, Uint32 rate) {
 void AudioMixer::dispose() {
     if (_booted) {
         AudioNode::dispose();
+        _commands.dispose();
+        _retired.dispose();
         delete[] _inputs;
+        delete[] _attached;
         free(_buffer);
+        delete[] _sources;
         _inputs = nullptr;
+        _attached = nullptr;
         _buffer = nullptr;
+        _sources = nullptr;
         _width = 0;
         _knee  = -1;
         _capacity = 0;
@@ -203,7 +256,21 @@ std::shared_ptr<AudioNode> AudioMixer::attach(Uint8 slot, const std::shared_ptr<
     }
     _marked.store(0,std::memory_order_relaxed);
     _offset.store(0,std::memory_order_relaxed);
-    return std::atomic_exchange_explicit(_inputs+slot,input,std::memory_order_relaxed);
+    collect();
+    
+    std::shared_ptr<AudioNode> result = _attached[slot];
+    _attached[slot] = input;
+    
+    Command command;
+    command.slot = slot;
+    command.node = input;
+    if (!_commands.push(std::move(command))) {
+        // The audio thread has fallen behind; apply the change ourselves
+        beginEdit();
+        assign(slot,command.node);
+        endEdit();
+    }
+    return result;
 }
 
 /**
@@ -217,7 +284,20 @@ std::shared_ptr<AudioNode> AudioMixer::attach(Uint8 slot, const std::shared_ptr<
  */
 std::shared_ptr<AudioNode> AudioMixer::detach(Uint8 slot) {
     CUAssertLog(slot < _width, "Slot %d is out of range",slot);
-    return std::atomic_exchange_explicit(_inputs+slot,{},std::memory_order_relaxed);
+    collect();
+    
+    std::shared_ptr<AudioNode> result = _attached[slot];
+    _attached[slot] = nullptr;
+    
+    Command command;
+    command.slot = slot;
+    if (!_commands.push(std::move(command))) {
+        // The audio thread has fallen behind; apply the change ourselves
+        beginEdit();
+        assign(slot,command.node);
+        endEdit();
+    }
+    return result;
 }
 
 /**
@@ -239,24 +319,40 @@ std::shared_ptr<AudioNode> AudioMixer::detach(Uint8 slot) {
  * @return the actual number of frames read
  */
 Uint32 AudioMixer::read(float* buffer, Uint32 frames) {
+    AudioProfiler::Scope scope(_profiler.get(),AudioProfiler::Stage::MIXER);
     std::memset(buffer,0,frames*_channels*sizeof(float));
     frames = std::min(frames,_capacity);
+    
+    // Announce the read before checking for an edit (see beginEdit)
+    _reading.store(true,std::memory_order_seq_cst);
+    if (_editing.load(std::memory_order_seq_cst)) {
+        // Never wait on the main thread; output silence instead
+        _reading.store(false,std::memory_order_release);
+        return frames;
+    }
+    
+    applyCommands();
     Uint32 actual = 0;
     if (!_paused.load(std::memory_order_relaxed)) {
-        std::lock_guard<std::mutex> lock(_mutex);
-        std::shared_ptr<AudioNode> temp;
+        // Read each input into its own slice, then sum and scale in one pass
+        size_t count = 0;
+        size_t slice = _capacity*_channels;
         for(int ii = 0; ii < _width; ii++) {
-            temp = std::atomic_load_explicit(_inputs+ii,std::memory_order_relaxed);
+            AudioNode* temp = _inputs[ii].get();
             if (temp) {
-                Uint32 amt = temp->read(_buffer,frames);
+                float* source = _buffer+count*slice;
+                Uint32 amt = temp->read(source,frames);
                 actual = std::max(amt,actual);
                 if (amt < frames) {
-                    std::memset(_buffer+amt,0,(frames-amt)*_channels*sizeof(float));
+                    std::memset(source+amt*_channels,0,(frames-amt)*_channels*sizeof(float));
                 }
-                dsp::DSPMath::add(_buffer,buffer,buffer,frames*_channels);
+                _sources[count++] = source;
             }
         }
-        dsp::DSPMath::scale(buffer,_ndgain.load(std::memory_order_relaxed),buffer,frames*_channels);
+        if (_profiler) {
+            _profiler->recordVoices((Uint32)count);
+        }
+        dsp::DSPMath::mix(_sources,count,_ndgain.load(std::memory_order_relaxed),buffer,frames*_channels);
         float knee = _knee.load(std::memory_order_relaxed);
         if (knee == 1) {
             dsp::DSPMath::clamp(buffer,-1,1,frames*_channels);
@@ -270,33 +366,51 @@ Uint32 AudioMixer::read(float* buffer, Uint32 frames) {
     
     Uint64 pos = _offset.load(std::memory_order_relaxed);
     _offset.store(pos+actual,std::memory_order_relaxed);
+    _reading.store(false,std::memory_order_release);
     return actual;
 }
 
 /**
  * Sets the width of this mixer.
  *
- * The width is the number of supported input slots. This method will only
- * succeed if the mixer is paused.  Otherwise, it will fail.
+ * The width is the number of supported input slots. This method may be
+ * called at any time. The audio thread outputs silence for (at most) one
+ * buffer while the inputs are reallocated.
  *
  * Once the width is adjusted, the children will be reassigned in order.
  * If the new width is less than the old width, children at the end of
  * the mixer will be dropped.
  *
+ * @param width The number of supported input slots
+ *
  * @return true if the mixer width was reset
  */
 bool AudioMixer::setWidth(Uint8 width) {
-    if (_paused.load(std::memory_order_relaxed)) {
-        std::shared_ptr<AudioNode>* replace = new std::shared_ptr<AudioNode>[width];
-        Uint32 min = width < _width ? width : _width;
-        for(int ii = 0; ii < width; ii++) {
-            replace[ii] = ii < min ? _inputs[ii] : nullptr;
-        }
-        delete[] _inputs;
-        _inputs = replace;
-        return true;
+    CUAssertLog(width,"Mixer width is 0");
+    std::shared_ptr<AudioNode>* inputs = new std::shared_ptr<AudioNode>[width];
+    std::shared_ptr<AudioNode>* attached = new std::shared_ptr<AudioNode>[width];
+    float* buffer = (float*)malloc(width*_capacity*_channels*sizeof(float));
+    float** sources = new float*[width];
+    
+    beginEdit();
+    Uint32 min = width < _width ? width : _width;
+    for(int ii = 0; ii < min; ii++) {
+        inputs[ii] = std::move(_inputs[ii]);
+        attached[ii] = std::move(_attached[ii]);
     }
-    return false;
+    std::swap(inputs,_inputs);
+    std::swap(attached,_attached);
+    std::swap(buffer,_buffer);
+    std::swap(sources,_sources);
+    _width = width;
+    endEdit();
+    
+    // Dropped children are released outside of the exclusive section
+    delete[] inputs;
+    delete[] attached;
+    free(buffer);
+    delete[] sources;
+    return true;
 }
 
 #pragma mark -
@@ -356,16 +470,16 @@ void AudioMixer::setKnee(float knee) {
  * @return true if the read position was marked across all inputs.
  */
 bool AudioMixer::mark() {
-    std::lock_guard<std::mutex> lock(_mutex);
+    beginEdit();
     bool success = true;
-    std::shared_ptr<AudioNode> temp;
     for(int ii = 0; ii < _width; ii++) {
-        temp = std::atomic_load_explicit(_inputs+ii,std::memory_order_relaxed);
+        AudioNode* temp = _inputs[ii].get();
         if (temp) {
             success = temp->mark() && success;
         }
     }
     _marked.store(_offset.load(std::memory_order_relaxed),std::memory_order_relaxed);
+    endEdit();
     return success;
 }
 
@@ -389,16 +503,16 @@ bool AudioMixer::mark() {
  * @return true if the read position was marked.
  */
 bool AudioMixer::unmark() {
-    std::lock_guard<std::mutex> lock(_mutex);
+    beginEdit();
     bool success = true;
-    std::shared_ptr<AudioNode> temp;
     for(int ii = 0; ii < _width; ii++) {
-        temp = std::atomic_load_explicit(_inputs+ii,std::memory_order_relaxed);
+        AudioNode* temp = _inputs[ii].get();
         if (temp) {
             success = temp->unmark() && success;
         }
     }
     _marked.store(0,std::memory_order_relaxed);
+    endEdit();
     return success;
 }
 
@@ -417,16 +531,16 @@ bool AudioMixer::unmark() {
  * @return true if the read position was moved.
  */
 bool AudioMixer::reset() {
-    std::lock_guard<std::mutex> lock(_mutex);
+    beginEdit();
     bool success = true;
-    std::shared_ptr<AudioNode> temp;
     for(int ii = 0; ii < _width; ii++) {
-        temp = std::atomic_load_explicit(_inputs+ii,std::memory_order_relaxed);
+        AudioNode* temp = _inputs[ii].get();
         if (temp) {
             success = temp->reset() && success;
         }
     }
     _offset.store(_marked.load(std::memory_order_relaxed),std::memory_order_relaxed);
+    endEdit();
     return success;
 }
 
@@ -447,12 +561,11 @@ bool AudioMixer::reset() {
  * @return the actual number of frames advanced; -1 if not supported
  */
 Sint64 AudioMixer::advance(Uint32 frames) {
-    std::lock_guard<std::mutex> lock(_mutex);
+    beginEdit();
     Sint64 actual = 0;
     bool fail = false;
-    std::shared_ptr<AudioNode> temp;
     for(int ii = 0; ii < _width; ii++) {
-        temp = std::atomic_load_explicit(_inputs+ii,std::memory_order_relaxed);
+        AudioNode* temp = _inputs[ii].get();
         if (temp) {
             Sint64 amt = temp->advance(frames);
             actual = std::max(actual,amt);
@@ -462,6 +575,7 @@ Sint64 AudioMixer::advance(Uint32 frames) {
     
     Uint64 pos = _offset.load(std::memory_order_relaxed);
     _offset.store(pos+actual,std::memory_order_relaxed);
+    endEdit();
     return fail ? -1 : actual;
 }
 
@@ -501,12 +615,11 @@ Sint64 AudioMixer::getPosition() const {
  * @return the new frame position of this audio node.
  */
 Sint64 AudioMixer::setPosition(Uint32 position) {
-    std::lock_guard<std::mutex> lock(_mutex);
+    beginEdit();
     Sint64 actual = 0;
     bool fail = false;
-    std::shared_ptr<AudioNode> temp;
     for(int ii = 0; ii < _width; ii++) {
-        temp = std::atomic_load_explicit(_inputs+ii,std::memory_order_relaxed);
+        AudioNode* temp = _inputs[ii].get();
         if (temp) {
             Sint64 amt = temp->setPosition(position);
             actual = std::max(actual,amt);
@@ -515,6 +628,7 @@ Sint64 AudioMixer::setPosition(Uint32 position) {
     }
     
     _offset.store(actual,std::memory_order_relaxed);
+    endEdit();
     return fail ? -1 : actual;
 }
 
@@ -578,9 +692,8 @@ double AudioMixer::getRemaining() const {
     // An unavoidable race condition has minor effects on accuracy
     double actual = 0;
     bool fail = false;
-    std::shared_ptr<AudioNode> temp;
     for(int ii = 0; ii < _width; ii++) {
-        temp = std::atomic_load_explicit(_inputs+ii,std::memory_order_relaxed);
+        AudioNode* temp = _attached[ii].get();
         if (temp) {
             double amt = temp->getRemaining();
             actual = std::max(actual,amt);
@@ -613,14 +726,13 @@ double AudioMixer::getRemaining() const {
  * @return the new remaining time in seconds.
  */
 double AudioMixer::setRemaining(double time) {
-    std::lock_guard<std::mutex> lock(_mutex);
+    beginEdit();
     
     // Get longest time remaining
     double actual = 0;
     bool fail = false;
-    std::shared_ptr<AudioNode> temp;
     for(int ii = 0; ii < _width; ii++) {
-        temp = std::atomic_load_explicit(_inputs+ii,std::memory_order_relaxed);
+        AudioNode* temp = _inputs[ii].get();
         if (temp) {
             double amt = temp->getRemaining();
             actual = std::max(actual,amt);
@@ -632,7 +744,7 @@ double AudioMixer::setRemaining(double time) {
     
     // Now push forward
     for(int ii = 0; ii < _width; ii++) {
-        temp = std::atomic_load_explicit(_inputs+ii,std::memory_order_relaxed);
+        AudioNode* temp = _inputs[ii].get();
         if (temp) {
             Uint64 off = temp->setPosition((Uint32)pos);
             if (off < 0) {
@@ -645,5 +757,86 @@ double AudioMixer::setRemaining(double time) {
     }
     
     _offset.store(pos,std::memory_order_relaxed);
+    endEdit();
     return fail ? -1 : actual;
 }
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Places the node in the given slot of the audio thread inputs.
+ *
+ * The node previously in that slot is passed back to the main thread for
+ * deletion. This method may only be called by the audio thread, or by the
+ * main thread inside of an exclusive section.
+ *
+ * @param slot  The slot to change
+ * @param node  The node to place in the slot
+ */
+void AudioMixer::assign(Uint8 slot, std::shared_ptr<AudioNode>& node) {
+    if (slot >= _width) {
+        // The mixer shrank after this change was posted
+        _retired.push(std::move(node));
+        return;
+    }
+    std::swap(_inputs[slot],node);
+    if (node != nullptr && !_retired.push(std::move(node))) {
+        // Only possible if the main thread has stalled; drop it here instead
+        node = nullptr;
+    }
+}
+
+/**
+ * Applies all pending input changes to the audio thread inputs.
+ *
+ * This method may only be called by the audio thread, or by the main
+ * thread inside of an exclusive section.
+ */
+void AudioMixer::applyCommands() {
+    Command command;
+    while (_commands.pop(command)) {
+        assign(command.slot,command.node);
+        command.node = nullptr;
+    }
+}
+
+/**
+ * Releases all input nodes removed by the audio thread.
+ *
+ * This method should only be called in the main thread. It guarantees
+ * that the last reference to a node is never dropped on the audio thread.
+ */
+void AudioMixer::collect() {
+    std::shared_ptr<AudioNode> node;
+    while (_retired.pop(node)) {
+        node = nullptr;
+    }
+}
+
+/**
+ * Begins an exclusive section for the main thread.
+ *
+ * This method waits for the current read (if any) to finish. Until the
+ * matching call to {@link #endEdit}, the audio thread will output silence
+ * instead of reading the inputs. Hence this method never causes the audio
+ * thread to block. Pending input changes are applied before this method
+ * returns, so the audio thread inputs are up to date.
+ */
+void AudioMixer::beginEdit() {
+    // Sequential consistency guarantees one of the threads sees the other
+    _editing.store(true,std::memory_order_seq_cst);
+    while (_reading.load(std::memory_order_seq_cst)) {
+        std::this_thread::yield();
+    }
+    applyCommands();
+}
+
+/**
+ * Ends an exclusive section for the main thread.
+ *
+ * This method also releases any input nodes removed in the section.
+ */
+void AudioMixer::endEdit() {
+    _editing.store(false,std::memory_order_release);
+    collect();
+}
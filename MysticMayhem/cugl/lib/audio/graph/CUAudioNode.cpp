@@ -116,12 +116,12 @@ bool AudioNode::init(Uint8 channels, Uint32 rate) {
     if (_booted) {
         CUAssertLog(false,"This node has already been initialized");
         return false;
-    } else if (!AudioDevices::get()) {
-        CUAssertLog(false,"Attempt to allocate a node without an active audio device manager");
-        return false;
     }
+    // Offline graphs (e.g. an AudioRenderer) may be built without a manager
+    AudioDevices* devices = AudioDevices::get();
     _channels = channels;
     _sampling = rate;
+    _profiler = devices ? devices->getProfiler() : nullptr;
     _booted = true;
     return true;
 }
@@ -139,6 +139,7 @@ void AudioNode::dispose() {
     _sampling  = 0;
     _callback = nullptr;
     _calling.store(false);
+    _profiler = nullptr;
     _ndgain.store(1.0f);
     _polling.store(false);
     _paused.store(false);
@@ -51,6 +51,7 @@
 #include <cugl/util/CUTimestamp.h>
 #include <atomic>
 #include <cstring>
+#include <algorithm>
 
 using namespace cugl::audio;
 
@@ -142,9 +143,11 @@ static int paddingSize(Uint32 inrate, Uint32 outrate) {
 AudioOutput::AudioOutput() : AudioNode(),
 _dvname(""),
 _overhd(0),
-_cvtratio(1.0f),
+_input(nullptr),
+_polyphase(nullptr),
 _cvtbuffer(nullptr),
-_input(nullptr) {
+_cvtratio(1.0f),
+_readsize(0) {
     _classname = "AudioOutput";
     _resampler = NULL;
     _bitrate = sizeof(float);
@@ -305,6 +308,7 @@ bool AudioOutput::init(const std::string& device) {
  */
 bool AudioOutput::init(const std::string& device, Uint8 channels, Uint32 rate, Uint32 buffer) {
     _dvname = device;
+    _readsize = buffer;
     
     SDL_AudioSpec want;
     want.freq = rate;
@@ -323,10 +327,17 @@ bool AudioOutput::init(const std::string& device, Uint8 channels, Uint32 rate, U
     } else if (!AudioNode::init(want.channels,want.freq)) {
         return false;
     }
+    _clock = AudioClock::alloc(want.freq);
     
     // Because mobile devices often have other ideas...
     _bitrate = sizeof(float);
-    if (want.format != _audiospec.format || want.freq != _audiospec.freq || want.channels != _audiospec.channels) {
+    if (want.format == _audiospec.format && want.channels == _audiospec.channels) {
+        if (want.freq != _audiospec.freq) {
+            _polyphase = std::make_shared<dsp::PolyphaseResampler>(want.channels, want.freq, _audiospec.freq,
+                                                                   dsp::PolyphaseResampler::Quality::MEDIUM,
+                                                                   _audiospec.samples);
+        }
+    } else {
         _resampler = SDL_NewAudioStream(want.format, want.channels, want.freq,
                                         _audiospec.format, _audiospec.channels, _audiospec.freq);
         if (_resampler == NULL) {
@@ -370,6 +381,8 @@ void AudioOutput::dispose() {
         AudioNode::dispose();
         _active.store(false);
         std::atomic_store_explicit(&_input,{},std::memory_order_relaxed);
+        _polyphase = nullptr;
+        _clock = nullptr;
         if (_resampler != NULL) {
             SDL_AudioStreamClear(_resampler);
             SDL_FreeAudioStream(_resampler);
@@ -543,16 +556,36 @@ Uint32 AudioOutput::read(float* buffer, Uint32 frames) {
     std::shared_ptr<AudioNode> input = std::atomic_load_explicit(&_input,std::memory_order_relaxed);
     if (input == nullptr || _paused.load(std::memory_order_relaxed)) {
         std::memset(realbuf,0,frames*realchan*_bitrate);
+        // The graph time passes even when it is not read
+        _clock->advance((Uint32)(((Uint64)frames*_sampling)/_audiospec.freq));
     } else {
         // SDL double buffers, so there is no need to put this in another thread
         // Latency on Apple devices is roughly equal to duration of sample buffer
         // At 512 sample frames, we can safely take 9ms to do this operation.
         Sint32 take = 0;
-        if (_resampler != NULL) {
+        if (_polyphase != nullptr) {
+            // The input is read directly into the filter history. The graph
+            // only produces a read buffer at a time, so read in chunks and
+            // continue as long as either the input or the filter progresses.
+            bool search = true;
+            while ((Uint32)take < frames && search) {
+                Uint32 need = std::min(_polyphase->getInputNeeded(frames-take),_readsize);
+                Uint32 got  = 0;
+                if (need) {
+                    got = input->read(_polyphase->getInputBuffer(), need);
+                    _clock->advance(got);
+                    _polyphase->commit(got);
+                }
+                Uint32 amt = _polyphase->pull(buffer+take*realchan, frames-take);
+                search = amt > 0 || got > 0;
+                take += amt;
+            }
+        } else if (_resampler != NULL) {
             bool search = true;
             while (take < frames && search) {
-                Sint32 amt = std::ceil(frames*_cvtratio);
-                amt = input->read(_cvtbuffer, amt);
+                Sint32 need = std::ceil(frames*_cvtratio);
+                Sint32 amt = input->read(_cvtbuffer, need);
+                _clock->advance(need);
                 if (SDL_AudioStreamPut(_resampler, _cvtbuffer, amt*sizeof(float)*_channels) < 0) {
                     CULogError("[AUDIO] Resampling error.");
                     std::memset(realbuf+take*realchan*_bitrate,0,(frames-take)*realchan*_bitrate);
@@ -574,6 +607,7 @@ Uint32 AudioOutput::read(float* buffer, Uint32 frames) {
             }
         } else {
             take = input->read(buffer, frames);
+            _clock->advance(frames);
         }
         if (take < frames) {
             std::memset(realbuf+take*realchan*_bitrate,0,(frames-take)*realchan*_bitrate);
@@ -582,6 +616,9 @@ Uint32 AudioOutput::read(float* buffer, Uint32 frames) {
     Timestamp end;
     Uint64 micros = Timestamp::ellapsedMicros(start,end);
     _overhd.store(micros,std::memory_order_relaxed);
+    if (_profiler) {
+        _profiler->endCallback(Timestamp::ellapsedNanos(start,end),frames,_audiospec.freq);
+    }
     return frames;
 }
 
@@ -65,6 +65,7 @@ _chunker(nullptr),
 _chklimt(0),
 _chklast(0),
 _chksize(0),
+_cache(nullptr),
 _dirty(false) {
     _classname = "AudioPlayer";
 }
@@ -86,8 +87,21 @@ bool AudioPlayer::init(const std::shared_ptr<AudioSample>& source) {
         _dirty  = false;
         
         // TODO: Require manager active and access buffer from it.
-        _decoder = source->getDecoder();
-        if (source->isStreamed() && _decoder != nullptr) {
+        _decoder = source->isStreamed() ? source->getDecoder() : nullptr;
+        AudioDevices* devices = AudioDevices::get();
+        if (!source->isStreamed()) {
+            if (devices != nullptr && devices->getStreamer() != nullptr) {
+                devices->getStreamer()->track(source);
+            }
+        } else if (_decoder != nullptr && devices != nullptr && devices->getStreamer() != nullptr) {
+            // The cache owns the decoder from now on
+            _cache = AudioPageCache::alloc(_decoder);
+            _decoder = nullptr;
+            if (_cache == nullptr) {
+                return false;
+            }
+            devices->getStreamer()->attach(_cache);
+        } else if (_decoder != nullptr) {
             Uint32 channels = _decoder->getChannels();
             _chksize  = _decoder->getPageSize();
             _chklimt  = _chksize;
@@ -111,6 +125,7 @@ void AudioPlayer::dispose() {
         AudioNode::dispose();
         _source = nullptr;
         _decoder = nullptr;
+        _cache = nullptr;
         _offset.store(0);
         _marked.store(0);
         _buffer  = nullptr;
@@ -159,12 +174,30 @@ Uint32 AudioPlayer::read(float* buffer, Uint32 frames) {
     }
     
     Uint32 amt = frames;
+    Uint32 moved = 0;
     if (_buffer) {
         float* input  = _buffer;
         input += off*_source->getChannels();
     
         amt = (Uint32)(off+amt > _source->getLength() ? _source->getLength()-off : amt);
         std::memcpy(buffer,input,sizeof(float)*amt*_source->getChannels());
+        moved = amt;
+    } else if (!_source->isStreamed()) {
+        // Compact encodings are converted as they are read
+        amt = _source->read(buffer,off,amt);
+        moved = amt;
+    } else if (_cache) {
+        amt = (Uint32)(off+amt > _source->getLength() ? _source->getLength()-off : amt);
+        moved = _cache->read(buffer,off,amt);
+        if (moved < amt && _cache->isEnded(off+moved)) {
+            amt = moved;
+        } else if (moved < amt) {
+            // Underrun: play silence and hold the position until the streamer catches up
+            std::memset(buffer+moved*_channels,0,(amt-moved)*_channels*sizeof(float));
+            if (_profiler) {
+                _profiler->recordUnderrun();
+            }
+        }
     } else {
         if (_dirty.load(std::memory_order_acquire)) {
             scan(off);
@@ -189,10 +222,11 @@ Uint32 AudioPlayer::read(float* buffer, Uint32 frames) {
             }
         }
         amt -= remnant;
+        moved = amt;
     }
 
     dsp::DSPMath::scale(buffer,_ndgain.load(std::memory_order_relaxed),buffer,amt*_channels);
-    _offset.store(off+amt,std::memory_order_release);
+    _offset.store(off+moved,std::memory_order_release);
     _polling.store(false);
     Timestamp end;
     return amt;
@@ -246,8 +280,9 @@ bool AudioPlayer::unmark() {
  * @return true if the read position was moved.
  */
 bool AudioPlayer::reset() {
-    _offset.store(_marked.load(std::memory_order_relaxed),std::memory_order_relaxed);
-    _dirty.store(true);
+    Uint64 off = _marked.load(std::memory_order_relaxed);
+    _offset.store(off,std::memory_order_relaxed);
+    reposition(off);
     return true;
 }
 
@@ -281,7 +316,7 @@ Sint64 AudioPlayer::advance(Uint32 frames) {
 Sint64 AudioPlayer::setPosition(Uint32 position) {
     Uint64 off  = position > _source->getLength() ? _source->getLength() : position;
     _offset.store(off, std::memory_order_release);
-    _dirty.store(true);
+    reposition(off);
     return off;
 }
 
@@ -319,7 +354,7 @@ double AudioPlayer::setElapsed(double time) {
         result = off/_source->getRate();
     }
     _offset.store(off, std::memory_order_relaxed);
-    _dirty.store(true);
+    reposition(off);
     return result;
 }
 
@@ -372,13 +407,30 @@ double AudioPlayer::setRemaining(double time) {
         result = (_source->getLength()-off)/_source->getRate();
     }
     _offset.store(off, std::memory_order_relaxed);
-    _dirty.store(true);
+    reposition(off);
     return result;
 }
 
 
 #pragma mark -
 #pragma mark Stream Decoding
+/**
+ * Repositions the stream decoding at the given frame.
+ *
+ * If this player reads from a page cache, the cache is asked to seek
+ * immediately so that the streamer can decode ahead of the new position.
+ * Otherwise, the decoder is repositioned on the next read.
+ *
+ * @param frame    The absolute frame to skip to
+ */
+void AudioPlayer::reposition(Uint64 frame) {
+    if (_cache) {
+        _cache->seek(frame);
+    } else {
+        _dirty.store(true);
+    }
+}
+
 /**
  * Decodes the audio stream up to the given position.
  *
@@ -0,0 +1,459 @@
+//
+//  CUAudioRenderer.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an offline terminal node for an audio graph. It plays
+//  the same role as AudioOutput, except that it has no device. Instead, the
+//  graph is pulled on the calling thread as fast as possible, and the result
+//  is written to a memory buffer or to a WAV file. This makes the output of
+//  the graph deterministic, which is useful for benchmarks and for comparing
+//  the mixer output against a reference file.
+//
+//  Because there is no audio thread, the graph attached to this node must not
+//  also be attached to an active output device. The main thread is the only
+//  thread that reads from it.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#include <cugl/audio/graph/CUAudioRenderer.h>
+#include <cugl/audio/graph/CUAudioFader.h>
+#include <cugl/audio/graph/CUAudioMixer.h>
+#include <cugl/audio/codecs/CUWAVDecoder.h>
+#include <cugl/audio/CUAudioDevices.h>
+#include <cugl/audio/CUAudioWaveform.h>
+#include <cugl/util/CUDebug.h>
+#include <cugl/util/CUTimestamp.h>
+#include <SDL/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+using namespace cugl;
+using namespace cugl::audio;
+
+// The WAV format constants (see CUWAVDecoder.cpp)
+#define RIFF            0x46464952      /* "RIFF" */
+#define WAVE            0x45564157      /* "WAVE" */
+#define FMT             0x20746D66      /* "fmt " */
+#define DATA            0x61746164      /* "data" */
+#define PCM_CODE        0x0001
+#define IEEE_FLOAT_CODE 0x0003
+
+/**
+ * Writes the RIFF header for a WAV file with the given format
+ *
+ * The header has a single format chunk, and is immediately followed by the
+ * data chunk of the given size.
+ *
+ * @param dest      The file to write to
+ * @param format    The WAV format
+ * @param size      The size of the data chunk in bytes
+ *
+ * @return true if the header was written successfully
+ */
+static bool writeHeader(SDL_RWops* dest, const WaveFMT& format, Uint32 size) {
+    size_t result = 1;
+    result &= SDL_WriteLE32(dest, RIFF);
+    result &= SDL_WriteLE32(dest, 4+(8+16)+(8+size));
+    result &= SDL_WriteLE32(dest, WAVE);
+    result &= SDL_WriteLE32(dest, FMT);
+    result &= SDL_WriteLE32(dest, 16);
+    result &= SDL_WriteLE16(dest, format.encoding);
+    result &= SDL_WriteLE16(dest, format.channels);
+    result &= SDL_WriteLE32(dest, format.frequency);
+    result &= SDL_WriteLE32(dest, format.byterate);
+    result &= SDL_WriteLE16(dest, format.blockalign);
+    result &= SDL_WriteLE16(dest, format.bitspersample);
+    result &= SDL_WriteLE32(dest, DATA);
+    result &= SDL_WriteLE32(dest, size);
+    return result != 0;
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates a degenerate audio renderer.
+ *
+ * The node has not been initialized, so it is not active.  The node
+ * must be initialized to be used.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a node on
+ * the heap, use one of the static constructors instead.
+ */
+AudioRenderer::AudioRenderer() : AudioNode(),
+_capacity(0),
+_rendered(0),
+_elapsed(0) {
+    _input = nullptr;
+    _classname = "AudioRenderer";
+}
+
+/**
+ * Initializes a renderer with 2 channels at 48000 Hz.
+ *
+ * The buffer size is {@link AudioDevices#DEFAULT_OUTPUT_BUFFER}.
+ *
+ * @return true if initialization was successful
+ */
+bool AudioRenderer::init() {
+    return init(DEFAULT_CHANNELS,DEFAULT_SAMPLING,AudioDevices::DEFAULT_OUTPUT_BUFFER);
+}
+
+/**
+ * Initializes a renderer with the given channels and sample rate.
+ *
+ * The buffer size is {@link AudioDevices#DEFAULT_OUTPUT_BUFFER}.
+ *
+ * @param channels  The number of audio channels
+ * @param rate      The sample rate (frequency) in HZ
+ *
+ * @return true if initialization was successful
+ */
+bool AudioRenderer::init(Uint8 channels, Uint32 rate) {
+    return init(channels,rate,AudioDevices::DEFAULT_OUTPUT_BUFFER);
+}
+
+/**
+ * Initializes a renderer with the given channels, sample rate and buffer.
+ *
+ * The buffer size is the number of frames pulled from the graph at a
+ * time. It should match the buffer size of the device being modeled.
+ *
+ * @param channels  The number of audio channels
+ * @param rate      The sample rate (frequency) in HZ
+ * @param buffer    The number of frames in each read of the graph
+ *
+ * @return true if initialization was successful
+ */
+bool AudioRenderer::init(Uint8 channels, Uint32 rate, Uint32 buffer) {
+    CUAssertLog(buffer > 0, "The buffer size must be positive");
+    if (!AudioNode::init(channels,rate)) {
+        return false;
+    }
+    _capacity = buffer;
+    _clock = AudioClock::alloc(rate);
+    _buffer.resize((size_t)buffer*channels);
+    resetStatistics();
+    return true;
+}
+
+/**
+ * Disposes any resources allocated for this renderer
+ *
+ * The state of the node is reset to that of an uninitialized constructor.
+ * Unlike the destructor, this method allows the node to be reinitialized.
+ */
+void AudioRenderer::dispose() {
+    if (_booted) {
+        AudioNode::dispose();
+        _input = nullptr;
+        _clock = nullptr;
+        _capacity = 0;
+        _buffer.clear();
+        _buffer.shrink_to_fit();
+        resetStatistics();
+    }
+}
+
+#pragma mark -
+#pragma mark Audio Graph
+/**
+ * Attaches an audio graph to this renderer.
+ *
+ * This method will fail if the channels or sample rate of the audio graph
+ * do not agree with this node.
+ *
+ * @param node  The terminal node of the audio graph
+ *
+ * @return true if the attachment was successful
+ */
+bool AudioRenderer::attach(const std::shared_ptr<AudioNode>& node) {
+    if (!_booted) {
+        CUAssertLog(_booted, "Cannot attach to an uninitialized renderer");
+        return false;
+    } else if (node == nullptr) {
+        detach();
+        return true;
+    } else if (node->getChannels() != _channels) {
+        CUAssertLog(false,"Terminal node of audio graph has wrong number of channels: %d",
+                    node->getChannels());
+        return false;
+    } else if (node->getRate() != _sampling) {
+        CUAssertLog(false,"Terminal node of audio graph has wrong sample rate: %d",
+                    node->getRate());
+        return false;
+    }
+    _input = node;
+    return true;
+}
+
+/**
+ * Detaches an audio graph from this renderer.
+ *
+ * If the method succeeds, it returns the terminal node of the audio graph.
+ *
+ * @return  the terminal node of the audio graph (or null if failed)
+ */
+std::shared_ptr<AudioNode> AudioRenderer::detach() {
+    if (!_booted) {
+        CUAssertLog(_booted, "Cannot detach from an uninitialized renderer");
+        return nullptr;
+    }
+    std::shared_ptr<AudioNode> result = _input;
+    _input = nullptr;
+    return result;
+}
+
+/**
+ * Returns true if this audio node has no more data.
+ *
+ * This is the case if there is no attached graph, or the graph is
+ * completed.
+ *
+ * @return true if this audio node has no more data.
+ */
+bool AudioRenderer::completed() {
+    return (_input == nullptr || _input->completed());
+}
+
+#pragma mark -
+#pragma mark Rendering
+/**
+ * Reads the given number of frames into the given buffer
+ *
+ * The graph is read one buffer at a time. A short read from the graph is
+ * followed by further reads until the buffer is full or the graph produces
+ * nothing, and only then is the remainder filled with silence. Hence this
+ * method always returns frames. The buffer should have enough room to
+ * store frames * channels elements.
+ *
+ * @param buffer    The read buffer to store the results
+ * @param frames    The number of frames to read
+ *
+ * @return the number of frames read
+ */
+Uint32 AudioRenderer::read(float* buffer, Uint32 frames) {
+    Uint32 offset = 0;
+    while (offset < frames) {
+        Timestamp start;
+        Uint32 block = std::min(frames-offset,_capacity);
+        float* output = buffer+(size_t)offset*_channels;
+        Uint32 take = 0;
+        if (_input != nullptr && !_paused.load(std::memory_order_relaxed)) {
+            // Nodes may return less than asked for (e.g. a capped mixer)
+            Uint32 amt = 1;
+            while (take < block && amt > 0) {
+                amt = _input->read(output+(size_t)take*_channels, block-take);
+                take += amt;
+            }
+        }
+        if (take < block) {
+            std::memset(output+(size_t)take*_channels,0,(size_t)(block-take)*_channels*sizeof(float));
+        }
+        _clock->advance(block);
+        Timestamp end;
+        Uint64 nanos = Timestamp::ellapsedNanos(start,end);
+        if (_profiler) {
+            _profiler->endCallback(nanos,block,_sampling);
+        }
+        _elapsed  += nanos;
+        _rendered += block;
+        offset += block;
+    }
+    return frames;
+}
+
+/**
+ * Renders the given number of frames into the given buffer
+ *
+ * This is the same as {@link #read}, except that the number of frames
+ * may exceed 32 bits.
+ *
+ * @param buffer    The buffer to store the results
+ * @param frames    The number of frames to render
+ *
+ * @return the number of frames rendered
+ */
+Uint64 AudioRenderer::render(float* buffer, Uint64 frames) {
+    // Keep each read a multiple of the capacity so the blocks stay aligned
+    const Uint64 limit = (UINT32_MAX/_capacity)*_capacity;
+    Uint64 offset = 0;
+    while (offset < frames) {
+        Uint32 amt = (Uint32)std::min(frames-offset,limit);
+        read(buffer+offset*_channels,amt);
+        offset += amt;
+    }
+    return frames;
+}
+
+/**
+ * Returns the given duration of the audio graph as a new buffer
+ *
+ * The result has the frames interleaved.
+ *
+ * @param seconds   The number of seconds to render
+ *
+ * @return the given duration of the audio graph as a new buffer
+ */
+std::vector<float> AudioRenderer::render(double seconds) {
+    Uint64 frames = (Uint64)(std::max(seconds,0.0)*_sampling);
+    std::vector<float> result((size_t)(frames*_channels));
+    render(result.data(),frames);
+    return result;
+}
+
+/**
+ * Renders the given number of frames to a WAV file
+ *
+ * The file is written one buffer at a time, so the memory used does not
+ * depend on the length of the file. The samples are stored as 32 bit IEEE
+ * floats, or as 16 bit PCM if pcm16 is true. Either format can be read
+ * back by {@link WAVDecoder}.
+ *
+ * @param file      The path to the WAV file
+ * @param frames    The number of frames to render
+ * @param pcm16     Whether to store the samples as 16 bit PCM
+ *
+ * @return true if the file was written successfully
+ */
+bool AudioRenderer::save(const std::string& file, Uint64 frames, bool pcm16) {
+    CUAssertLog(_booted, "Cannot render from an uninitialized renderer");
+    WaveFMT format;
+    format.encoding = pcm16 ? PCM_CODE : IEEE_FLOAT_CODE;
+    format.channels = _channels;
+    format.frequency = _sampling;
+    format.bitspersample = pcm16 ? 16 : 32;
+    format.blockalign = _channels*(format.bitspersample/8);
+    format.byterate = _sampling*format.blockalign;
+
+    Uint64 size = frames*format.blockalign;
+    if (size > UINT32_MAX-44) {
+        CULogError("[AUDIO] Render of %llu frames exceeds the WAV size limit.",
+                   (unsigned long long)frames);
+        return false;
+    }
+
+    SDL_RWops* dest = SDL_RWFromFile(file.c_str(), "wb");
+    if (dest == NULL) {
+        CULogError("[AUDIO] Could not open '%s': %s", file.c_str(), SDL_GetError());
+        return false;
+    }
+
+    bool success = writeHeader(dest, format, (Uint32)size);
+    std::vector<Sint16> samples;
+    if (pcm16) {
+        samples.resize(_buffer.size());
+    }
+
+    Uint64 offset = 0;
+    while (success && offset < frames) {
+        Uint32 amt = (Uint32)std::min(frames-offset,(Uint64)_capacity);
+        size_t len = (size_t)amt*_channels;
+        read(_buffer.data(),amt);
+        if (pcm16) {
+            for(size_t ii = 0; ii < len; ii++) {
+                float value = std::min(std::max(_buffer[ii],-1.0f),1.0f);
+                samples[ii] = SDL_SwapLE16((Sint16)(value*32767.0f));
+            }
+            success = SDL_RWwrite(dest, samples.data(), sizeof(Sint16), len) == len;
+        } else {
+            for(size_t ii = 0; ii < len; ii++) {
+                _buffer[ii] = SDL_SwapFloatLE(_buffer[ii]);
+            }
+            success = SDL_RWwrite(dest, _buffer.data(), sizeof(float), len) == len;
+        }
+        offset += amt;
+    }
+
+    if (SDL_RWclose(dest) != 0) {
+        success = false;
+    }
+    if (!success) {
+        CULogError("[AUDIO] Could not write '%s': %s", file.c_str(), SDL_GetError());
+    }
+    return success;
+}
+
+#pragma mark -
+#pragma mark Statistics
+/**
+ * Returns the number of seconds of audio rendered per second of work
+ *
+ * A value of 1 means that the graph renders in exactly real time. The
+ * value is 0 if nothing has been rendered.
+ *
+ * @return the number of seconds of audio rendered per second of work
+ */
+double AudioRenderer::getSpeed() const {
+    if (_rendered == 0 || _elapsed == 0) {
+        return 0;
+    }
+    return (_rendered*1e9)/((double)_elapsed*_sampling);
+}
+
+/**
+ * Returns a summary of the time to mix the given number of voices.
+ *
+ * This method builds a graph of sine wave players, each with its own
+ * fader, feeding a single mixer. It renders the given number of seconds
+ * offline, and reports both the cost per second of audio and the speed
+ * relative to real time. No device is used, so the audio device manager
+ * does not need to be active.
+ *
+ * @param voices    The number of voices to mix (at most 255)
+ * @param seconds   The number of seconds of audio to render
+ * @param channels  The number of audio channels
+ * @param rate      The sample rate (frequency) in HZ
+ * @param buffer    The number of frames in each read of the graph
+ *
+ * @return a summary of the time to mix the given number of voices.
+ */
+std::string AudioRenderer::benchmark(Uint32 voices, double seconds, Uint8 channels,
+                                     Uint32 rate, Uint32 buffer) {
+    voices = std::min(std::max(voices,(Uint32)1),(Uint32)255);
+
+    // The mixer must hold a full renderer buffer, whatever the device uses
+    std::shared_ptr<AudioMixer> mixer = AudioMixer::alloc((Uint8)voices,channels,rate,buffer);
+    for(Uint32 ii = 0; ii < voices; ii++) {
+        // Spread the voices over two octaves so that the mix is not degenerate
+        float freq = 220.0f*std::pow(2.0f,(2.0f*ii)/voices);
+        auto wave = AudioWaveform::alloc(channels,rate,AudioWaveform::Type::SINE,freq);
+        auto fader = AudioFader::alloc(wave->createNode());
+        fader->setGain(1.0f/voices);
+        mixer->attach((Uint8)ii,fader);
+    }
+
+    std::shared_ptr<AudioRenderer> renderer = AudioRenderer::alloc(channels,rate,buffer);
+    renderer->attach(mixer);
+    std::vector<float> output = renderer->render(seconds);
+
+    double audio = renderer->getRendered()/(double)rate;
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "Offline mix benchmark (" << voices << " voices, " << (Uint32)channels;
+    ss << " channels, " << rate << " Hz, " << buffer << " frame buffer)";
+    ss << "\n" << (audio > 0 ? renderer->getRenderTime()/(1000*audio) : 0) << " ms per second";
+    ss << "  " << std::setprecision(1) << renderer->getSpeed() << "x real time";
+    return ss.str();
+}
@@ -3,7 +3,7 @@
 //  Cornell University Game Library (CUGL)
 //
 //  This module provides a graph node for converting from one sample rate to
-//  another.  It uses SDL_AudioStream to perform continuous resampling on a
+//  another.  It uses a polyphase filter to perform continuous resampling on a
 //  potentially infinite audio stream.  This is is necessary for cross-platform
 //  reasons as iPhones are very stubborn about delivering any requested sampling
 //  rates other than 48000.
@@ -35,6 +35,11 @@
 #include <cugl/audio/CUAudioDevices.h>
 #include <cugl/math/dsp/CUDSPMath.h>
 #include <cugl/util/CUDebug.h>
+#include <cugl/util/CUTimestamp.h>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <vector>
 #include <cmath>
 
 using namespace cugl::audio;
@@ -49,7 +54,7 @@ using namespace cugl::audio;
  * Returns the padding size necessary to go from one sample rate to another
  *
  * This computation is done internally in SDL.  We needed to expose it so that we
- * can correcly "pre-fill" the buffer.
+ * can correcly "pre-fill" the buffer.  It is only used for benchmarking.
  *
  * @param inrate    The input sampling rate
  * @param outrate   The output sampling rate
@@ -78,11 +83,11 @@ static int paddingSize(Uint32 inrate, Uint32 outrate) {
  * the heap, use the factory in {@link AudioManager}.
  */
 AudioResampler::AudioResampler() : AudioNode(),
+_resampler(nullptr),
 _inputrate(0),
-_capacity(0),
+_quality(dsp::PolyphaseResampler::Quality::MEDIUM),
 _cvtratio(1.0f),
-_cvtbuffer(nullptr),
-_resampler(nullptr) {
+_tail(0) {
     _input = nullptr;
     _classname = "AudioResampler";
 }
@@ -114,10 +119,6 @@ bool AudioResampler::init() {
  */
 bool AudioResampler::init(Uint8 channels, Uint32 rate) {
     if (AudioNode::init(channels,rate)) {
-        _capacity = sizeof(float)*_channels*2*AudioDevices::get()->getReadSize();
-        _cvtbuffer = (float*)malloc(_capacity);
-        std::memset(_cvtbuffer,0,_capacity);
-        
         _inputrate = rate;
         return true;
     }
@@ -133,14 +134,7 @@ bool AudioResampler::init(Uint8 channels, Uint32 rate) {
 void AudioResampler::dispose() {
     if (_booted) {
         _input = nullptr;
-        if (_resampler != NULL) {
-            SDL_AudioStreamClear(_resampler);
-            SDL_FreeAudioStream(_resampler);
-            free(_cvtbuffer);
-            _resampler = NULL;
-            _cvtbuffer = nullptr;
-        }
-        _capacity  = 0;
+        std::atomic_store_explicit(&_resampler,{},std::memory_order_release);
         _cvtratio  = 1.0f;
         _inputrate = 0;
     }
@@ -163,7 +157,7 @@ void AudioResampler::dispose() {
 bool AudioResampler::attach(const std::shared_ptr<AudioNode>& node) {
     if (!_booted) {
         CUAssertLog(_booted, "Cannot attach to an uninitialized audio node");
-        return nullptr;
+        return false;
     } else if (node == nullptr) {
         detach();
         return true;
@@ -177,42 +171,13 @@ bool AudioResampler::attach(const std::shared_ptr<AudioNode>& node) {
         detach();
     }
 
-    {
-        std::unique_lock<std::mutex> lk(_buffmtex);
-        if (node->getRate() != _inputrate) {
-            _inputrate = node->getRate();
-            _cvtratio  = ((float)_inputrate)/getRate();
-            size_t bsize = sizeof(float)*_channels*std::ceil(_cvtratio*AudioDevices::get()->getReadSize());
-            if (bsize > _capacity) {
-                free(_cvtbuffer);
-                _capacity  = bsize;
-                _cvtbuffer = (float*)malloc(_capacity);
-            }
-            if (_resampler != NULL) {
-                SDL_AudioStreamClear(_resampler);
-                SDL_FreeAudioStream(_resampler);
-            }
-            if (_inputrate != getRate()) {
-                _resampler = SDL_NewAudioStream(AUDIO_F32SYS, _channels, _inputrate,
-                                                AUDIO_F32SYS, _channels, getRate());
-                if (_resampler == NULL) {
-                    CULogError("[AUDIO] Could not create a resampler.");
-                    return false;
-                }
-            }
-        }
-        
-        // Initial 0s (else it will pop)
-        std::memset(_cvtbuffer,0,_capacity);
-        Uint32 padding = paddingSize(_inputrate, getRate())*_channels;
-        if (padding) {
-            SDL_AudioStreamPut(_resampler, _cvtbuffer, padding*sizeof(float));
-        }
-        
-        std::atomic_store_explicit(&_input,node,std::memory_order_relaxed);
-        return true;
-    }
-    return false;
+    // A fresh filter starts with silence (else it will pop)
+    _inputrate = node->getRate();
+    _cvtratio  = ((float)_inputrate)/getRate();
+    rebuild();
+    
+    std::atomic_store_explicit(&_input,node,std::memory_order_relaxed);
+    return true;
 }
 
 /**
@@ -233,6 +198,203 @@ std::shared_ptr<AudioNode> AudioResampler::detach() {
     return result;
 }
 
+#pragma mark -
+#pragma mark Resampling
+/**
+ * Replaces the conversion resampler to match the current input rate.
+ *
+ * The new resampler starts with a silent history. It is null if the
+ * input rate matches the output rate.
+ */
+void AudioResampler::rebuild() {
+    std::shared_ptr<dsp::PolyphaseResampler> resampler = nullptr;
+    if (_inputrate != getRate()) {
+        resampler = std::make_shared<dsp::PolyphaseResampler>(_channels,_inputrate,getRate(),_quality,
+                                                              AudioDevices::get()->getReadSize());
+    }
+    _tail.store(0,std::memory_order_relaxed);
+    std::atomic_store_explicit(&_resampler,resampler,std::memory_order_release);
+}
+
+/**
+ * Sets the quality of the resampling filter.
+ *
+ * Higher qualities have less aliasing, but cost more CPU time and have
+ * more latency. Changing the quality while a node is attached replaces
+ * the filter, which will discard its history. So this should be set
+ * before the input is attached.
+ *
+ * @param quality   The quality of the resampling filter
+ */
+void AudioResampler::setQuality(dsp::PolyphaseResampler::Quality quality) {
+    if (_quality != quality) {
+        _quality = quality;
+        if (std::atomic_load_explicit(&_resampler,std::memory_order_acquire) != nullptr) {
+            rebuild();
+        }
+    }
+}
+
+/**
+ * Returns the latency of this resampler in output frames.
+ *
+ * This is the delay added by the resampling filter. It is 0 if the input
+ * rate matches the output rate.
+ *
+ * @return the latency of this resampler in output frames.
+ */
+Uint32 AudioResampler::getLatency() const {
+    std::shared_ptr<dsp::PolyphaseResampler> resampler;
+    resampler = std::atomic_load_explicit(&_resampler,std::memory_order_acquire);
+    return resampler ? resampler->getLatency() : 0;
+}
+
+/**
+ * Returns the measured latency of an impulse response in output frames
+ *
+ * The latency is the position of the impulse in the output, plus the
+ * input that was consumed but not yet output (converted to output frames).
+ * The latter is the read-ahead of the resampler.
+ *
+ * @param buffer    The interleaved impulse response
+ * @param channels  The number of channels
+ * @param consumed  The number of input frames consumed
+ * @param ratio     The output rate divided by the input rate
+ *
+ * @return the measured latency of an impulse response in output frames
+ */
+static double impulse_latency(const std::vector<float>& buffer, Uint32 channels,
+                              Uint64 consumed, double ratio) {
+    size_t best = 0;
+    for(size_t ii = 1; ii < buffer.size(); ii++) {
+        if (std::fabs(buffer[ii]) > std::fabs(buffer[best])) {
+            best = ii;
+        }
+    }
+    double produced = (double)buffer.size()/channels;
+    return best/channels+(consumed*ratio-produced);
+}
+
+/**
+ * Returns a report comparing this resampler to SDL_AudioStream
+ *
+ * This method converts the given number of seconds of noise between the
+ * two rates, in blocks of the default read size. It reports the CPU time
+ * (in milliseconds) per second of audio, and the latency in output frames
+ * measured from an impulse, for SDL_AudioStream and for each quality of
+ * the polyphase filter.
+ *
+ * This method does not require an audio device.
+ *
+ * @param inrate    The input sample rate
+ * @param outrate   The output sample rate
+ * @param channels  The number of audio channels
+ * @param seconds   The number of seconds of audio to convert
+ *
+ * @return a report comparing this resampler to SDL_AudioStream
+ */
+std::string AudioResampler::benchmark(Uint32 inrate, Uint32 outrate, Uint8 channels, double seconds) {
+    typedef dsp::PolyphaseResampler::Quality Quality;
+    const Uint32 block = AudioDevices::DEFAULT_OUTPUT_BUFFER;
+    Uint32 total = (Uint32)(seconds*outrate);
+    total -= total % block;
+    Uint32 inblock = (Uint32)std::ceil(block*((double)inrate/outrate));
+
+    // Noise in [-0.5,0.5], produced as needed (the cost is included for both)
+    Uint32 seed = 0x1234567;
+    auto noise = [&](float* buffer, Uint32 frames, Uint64 /*position*/) {
+        for(size_t ii = 0; ii < (size_t)frames*channels; ii++) {
+            seed = seed*1664525+1013904223;
+            buffer[ii] = (seed >> 8)/(float)(1 << 24)-0.5f;
+        }
+    };
+    auto impulse = [&](float* buffer, Uint32 frames, Uint64 position) {
+        std::memset(buffer,0,(size_t)frames*channels*sizeof(float));
+        if (position == 0) {
+            std::fill(buffer,buffer+channels,1.0f);
+        }
+    };
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "Resampler benchmark (" << inrate << " Hz to " << outrate << " Hz, ";
+    ss << (Uint32)channels << " channels, ms per second of audio)";
+
+    // The SDL path, structured as the node previously read
+    auto sdl = [&](const std::function<void(float*,Uint32,Uint64)>& source,
+                   std::vector<float>& output, Uint32 frames) -> Sint64 {
+        SDL_AudioStream* stream = SDL_NewAudioStream(AUDIO_F32SYS, channels, inrate,
+                                                     AUDIO_F32SYS, channels, outrate);
+        if (stream == NULL) {
+            return -1;
+        }
+        std::vector<float> cvtbuffer((size_t)(inblock+paddingSize(inrate,outrate))*channels,0.0f);
+        Uint32 padding = paddingSize(inrate,outrate)*channels;
+        if (padding) {
+            SDL_AudioStreamPut(stream, cvtbuffer.data(), padding*sizeof(float));
+        }
+        Uint64 position = 0;
+        for(Uint32 take = 0; take < frames; ) {
+            source(cvtbuffer.data(),inblock,position);
+            position += inblock;
+            SDL_AudioStreamPut(stream, cvtbuffer.data(), inblock*channels*sizeof(float));
+            int amt = SDL_AudioStreamGet(stream, output.data()+(size_t)take*channels,
+                                         (int)((frames-take)*channels*sizeof(float)));
+            if (amt < 0) {
+                break;
+            }
+            take += amt/(sizeof(float)*channels);
+        }
+        SDL_FreeAudioStream(stream);
+        return (Sint64)position;
+    };
+
+    // The polyphase path, structured as the node reads
+    auto polyphase = [&](Quality quality, const std::function<void(float*,Uint32,Uint64)>& source,
+                         std::vector<float>& output, Uint32 frames) -> Sint64 {
+        dsp::PolyphaseResampler resampler(channels,inrate,outrate,quality,block);
+        Uint64 position = 0;
+        for(Uint32 take = 0; take < frames; ) {
+            Uint32 want = std::min(block,frames-take);
+            Uint32 need = resampler.getInputNeeded(want);
+            source(resampler.getInputBuffer(),need,position);
+            position += need;
+            resampler.commit(need);
+            take += resampler.pull(output.data()+(size_t)take*channels,want);
+        }
+        return (Sint64)position;
+    };
+
+    double ratio = (double)outrate/inrate;
+    std::vector<float> output((size_t)total*channels);
+    std::vector<float> probe((size_t)block*channels);
+    {
+        Timestamp start;
+        Sint64 success = sdl(noise,output,total);
+        Timestamp end;
+        if (success >= 0) {
+            Sint64 consumed = sdl(impulse,probe,block);
+            ss << "\n" << std::left << std::setw(8) << "sdl" << std::right;
+            ss << "  cpu " << Timestamp::ellapsedMicros(start,end)/(1000.0*seconds);
+            ss << "  latency " << impulse_latency(probe,channels,consumed,ratio);
+        } else {
+            ss << "\nsdl       unavailable: " << SDL_GetError();
+        }
+    }
+    
+    const char* names[] = { "low", "medium", "high" };
+    for(Quality quality : {Quality::LOW, Quality::MEDIUM, Quality::HIGH}) {
+        Timestamp start;
+        polyphase(quality,noise,output,total);
+        Timestamp end;
+        Sint64 consumed = polyphase(quality,impulse,probe,block);
+        ss << "\n" << std::left << std::setw(8) << names[(int)quality] << std::right;
+        ss << "  cpu " << Timestamp::ellapsedMicros(start,end)/(1000.0*seconds);
+        ss << "  latency " << impulse_latency(probe,channels,consumed,ratio);
+    }
+    return ss.str();
+}
+
 #pragma mark -
 #pragma mark Playback Control
 /**
@@ -248,7 +410,17 @@ std::shared_ptr<AudioNode> AudioResampler::detach() {
  */
 bool AudioResampler::completed() {
     std::shared_ptr<AudioNode> input = std::atomic_load_explicit(&_input,std::memory_order_relaxed);
-    return (input == nullptr || input->completed());
+    if (input == nullptr) {
+        return true;
+    } else if (!input->completed()) {
+        return false;
+    }
+    
+    // The filter must be flushed and drained as well
+    std::shared_ptr<dsp::PolyphaseResampler> resampler;
+    resampler = std::atomic_load_explicit(&_resampler,std::memory_order_acquire);
+    return (resampler == nullptr ||
+            (_tail.load(std::memory_order_relaxed) == 0 && resampler->getInputNeeded(1) > 0));
 }
 
 /**
@@ -269,34 +441,37 @@ bool AudioResampler::completed() {
  * @return the actual number of frames read
  */
 Uint32 AudioResampler::read(float* buffer, Uint32 frames) {
+    AudioProfiler::Scope scope(_profiler.get(),AudioProfiler::Stage::RESAMPLER);
     std::shared_ptr<AudioNode> input = std::atomic_load_explicit(&_input,std::memory_order_relaxed);
     if (input == nullptr || _paused.load(std::memory_order_relaxed)) {
         std::memset(buffer,0,frames*_channels*sizeof(float));
     } else {
-        std::unique_lock<std::mutex> lk(_buffmtex);
-        Sint32 take = 0;
-        if (_resampler != NULL) {
+        std::shared_ptr<dsp::PolyphaseResampler> resampler;
+        resampler = std::atomic_load_explicit(&_resampler,std::memory_order_acquire);
+        Uint32 take = 0;
+        if (resampler != nullptr) {
+            // The input is read directly into the filter history. Continue
+            // as long as either the input or the filter makes progress.
             bool search = true;
             while (take < frames && search) {
-                Sint32 amt = std::ceil(frames*_cvtratio);
-                amt = input->read(_cvtbuffer, amt);
-                if (SDL_AudioStreamPut(_resampler, _cvtbuffer, amt*sizeof(float)*_channels) < 0) {
-                    CULogError("[AUDIO] Resampling error.");
-                    std::memset(buffer+take*_channels,0,(frames-take)*_channels*sizeof(float));
-                    take = frames;
-                } else {
-                    amt  = SDL_AudioStreamGet(_resampler, buffer+take*_channels,
-                                              (int)((frames-take)*_channels*sizeof(float)));
-                    if (amt == -1) {
-                        CULogError("[AUDIO] Resampling error.");
-                        std::memset(buffer+take*_channels,0,(frames-take)*_channels*sizeof(float));
-                        take = frames;
-                    } else if (amt == 0) {
-                        search = false;
-                    } else {
-                        take += amt/sizeof(float)*_channels;
+                Uint32 need = resampler->getInputNeeded(frames-take);
+                Uint32 got  = 0;
+                if (need) {
+                    float* dst = resampler->getInputBuffer();
+                    got = input->read(dst, need);
+                    if (got > 0) {
+                        _tail.store(resampler->getTaps()/2,std::memory_order_relaxed);
+                    } else if (input->completed()) {
+                        // Flush the end of the input through the filter with silence
+                        got = std::min(need,_tail.load(std::memory_order_relaxed));
+                        std::memset(dst,0,(size_t)got*_channels*sizeof(float));
+                        _tail.fetch_sub(got,std::memory_order_relaxed);
                     }
+                    resampler->commit(got);
                 }
+                Uint32 amt = resampler->pull(buffer+take*_channels, frames-take);
+                search = amt > 0 || got > 0;
+                take += amt;
             }
         } else {
             take = input->read(buffer, frames);
@@ -394,7 +569,6 @@ bool AudioResampler::reset() {
 Sint64 AudioResampler::advance(Uint32 frames) {
     std::shared_ptr<AudioNode> input = std::atomic_load_explicit(&_input,std::memory_order_relaxed);
     if (input) {
-        std::unique_lock<std::mutex> lk(_buffmtex);
         return input->advance(std::ceil(frames*_cvtratio));
     }
     return -1;
@@ -37,6 +37,7 @@
 #include <cugl/base/CUApplication.h>
 #include <cugl/util/CUDebug.h>
 #include <cmath>
+#include <thread>
 
 using namespace cugl::audio;
 
@@ -46,7 +47,7 @@ using namespace cugl::audio;
  */
 AudioNodeQueue::AudioNodeQueue() {
     // Add dummy separator
-    _first = new Entry(std::shared_ptr<AudioNode>(),0);
+    _first = new Entry(std::shared_ptr<AudioNode>(),0,0);
     _divide.store(_first, std::memory_order_relaxed);
     _last.store(_first, std::memory_order_relaxed);
 }
@@ -71,20 +72,24 @@ AudioNodeQueue::~AudioNodeQueue() {
  * (additional) times.  If it is negative, the audio node will be
  * looped indefinitely until it is stopped.
  *
+ * The time is the clock time at which the node should start. If it is 0,
+ * the node starts as soon as it reaches the front of the queue.
+ *
  * This method is thread-safe
  *
  * @param node  The node to be scheduled
  * @param loop  The number of times to loop the audio
+ * @param time  The clock time to start the node
  */
-void AudioNodeQueue::push(const std::shared_ptr<AudioNode>& node, Sint32 loops) {
+void AudioNodeQueue::push(const std::shared_ptr<AudioNode>& node, Sint32 loops, Uint64 time) {
     Entry* last = _last.load(std::memory_order_relaxed);
     
     // Add the new item
-    last->next = new Entry(node,loops);
-    _last.store(last->next, std::memory_order_relaxed);
+    last->next = new Entry(node,loops,time);
+    _last.store(last->next, std::memory_order_release);
     
     // Trim unused nodes
-    while( _first != _divide) {
+    while( _first != _divide.load(std::memory_order_acquire)) {
         Entry* tmp = _first;
         _first = _first->next;
         delete tmp;
@@ -106,16 +111,55 @@ void AudioNodeQueue::push(const std::shared_ptr<AudioNode>& node, Sint32 loops)
  * @return true if the operation was successful
  */
 bool AudioNodeQueue::pop(std::shared_ptr<AudioNode>& node, Sint32& loop) {
-    if ( _divide != _last ) {
-        Entry* div = _divide.load(std::memory_order_relaxed);
+    Uint64 time;
+    return pop(node,loop,time);
+}
+
+/**
+ * Removes an entry from the front of this queue.
+ *
+ * This version of the method also stores the start time of the entry.
+ * If there is nothing to remove, the pointer will store null and the
+ * method will return false.
+ *
+ * This method is thread-safe
+ *
+ * @param node  the pointer to store the audio node
+ * @param loop  the pointer to store the number of loops
+ * @param time  the pointer to store the start time
+ *
+ * @return true if the operation was successful
+ */
+bool AudioNodeQueue::pop(std::shared_ptr<AudioNode>& node, Sint32& loop, Uint64& time) {
+    Entry* div = _divide.load(std::memory_order_relaxed);
+    if ( div != _last.load(std::memory_order_acquire) ) {
         node = div->next->value;
         loop = div->next->loops;
-        _divide.store(div->next, std::memory_order_relaxed);
+        time = div->next->time;
+        _divide.store(div->next, std::memory_order_release);
         return true;
     }
     return false;
 }
 
+/**
+ * Returns the start time of the front element of this queue.
+ *
+ * This method returns 0 if the queue is empty, or if the front element
+ * starts as soon as it is reached.
+ *
+ * This method is thread-safe
+ *
+ * @return the start time of the front element of this queue.
+ */
+Uint64 AudioNodeQueue::peekTime() const {
+    Entry* div = _divide.load(std::memory_order_acquire);
+    if ( div != _last.load(std::memory_order_acquire) ) {
+        return div->next->time;
+    }
+    return 0;
+}
+
 /**
  * Looks at the front element this queue.
  *
@@ -131,8 +175,8 @@ bool AudioNodeQueue::pop(std::shared_ptr<AudioNode>& node, Sint32& loop) {
  * @return true if the operation was successful
  */
 bool AudioNodeQueue::peek(std::shared_ptr<AudioNode>& node, Sint32& loop) const {
-    if ( _divide != _last ) {
-        Entry* div = _divide.load(std::memory_order_relaxed);
+    Entry* div = _divide.load(std::memory_order_acquire);
+    if ( div != _last.load(std::memory_order_acquire) ) {
         node = div->next->value;
         loop = div->next->loops;
         return true;
@@ -154,8 +198,8 @@ bool AudioNodeQueue::peek(std::shared_ptr<AudioNode>& node, Sint32& loop) const
  * @return true if the operation was successful
  */
 bool AudioNodeQueue::fill(std::deque<std::shared_ptr<AudioNode>>& container) const {
-    if ( _divide != _last ) {
-        Entry* div = _divide.load(std::memory_order_relaxed);
+    Entry* div = _divide.load(std::memory_order_acquire);
+    if ( div != _last.load(std::memory_order_relaxed) ) {
         while (div->next) {
             div = div->next;
             container.push_back(div->value);
@@ -168,14 +212,12 @@ bool AudioNodeQueue::fill(std::deque<std::shared_ptr<AudioNode>>& container) con
 /**
  * Clears all elements in this queue.
  *
- * This method is thread-safe
+ * This is a consumer method. It should only be called in the audio
+ * thread (or when the audio thread is known not to be reading).
  */
 void AudioNodeQueue::clear() {
     // Defer clean up to push
-    while ( _divide != _last ) {
-        Entry* div = _divide.load(std::memory_order_relaxed);
-        _divide.store(div->next, std::memory_order_relaxed);
-    }
+    _divide.store(_last.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 
@@ -188,11 +230,13 @@ void AudioNodeQueue::clear() {
  */
 AudioScheduler::AudioScheduler() : AudioNode(),
 _previous(nullptr),
-_buffer(nullptr),
 _loops(0),
+_overlap(0),
+_buffer(nullptr),
+_start(0),
 _qsize(0),
 _qskip(0),
-_overlap(0),
+_qtrim(0),
 _mempos(-1) {
     _classname = "AudioScheduler";
 }
@@ -217,12 +261,7 @@ AudioScheduler::~AudioScheduler() {
  * @return true if initialization was successful
  */
 bool AudioScheduler::init() {
-    if (AudioNode::init()) {
-        Uint32 size   = AudioDevices::get()->getReadSize();
-        _buffer  = (float*)malloc(size*_channels*sizeof(float));
-        return true;
-    }
-    return false;
+    return init(DEFAULT_CHANNELS,DEFAULT_SAMPLING);
 }
 
 /**
@@ -238,9 +277,37 @@ bool AudioScheduler::init() {
  * @return true if initialization was successful
  */
 bool AudioScheduler::init(Uint8 channels, Uint32 rate) {
+    if (!AudioDevices::get()) {
+        CUAssertLog(false,"Attempt to allocate a scheduler without an active audio device manager");
+        return false;
+    }
+    return init(channels,rate,AudioDevices::get()->getReadSize());
+}
+
+/**
+ * Initializes the scheduler with the given channels, sample rate and capacity
+ *
+ * These values determine the buffer the structure for all {@link read}
+ * operations.  In addition, they also detemine whether this node can
+ * serve as an input to other nodes in the audio graph.
+ *
+ * The capacity is the largest number of frames the scheduler will produce
+ * in a single read. The other initializers use the read size of the audio
+ * device manager. Graphs that are not attached to a device (such as one
+ * read by an {@link AudioRenderer}) should use this initializer instead.
+ *
+ * @param channels  The number of audio channels
+ * @param rate      The sample rate (frequency) in HZ
+ * @param capacity  The maximum number of frames in a single read
+ *
+ * @return true if initialization was successful
+ */
+bool AudioScheduler::init(Uint8 channels, Uint32 rate, Uint32 capacity) {
     if (AudioNode::init(channels,rate)) {
-        Uint32 size   = AudioDevices::get()->getReadSize();
-        _buffer  = (float*)malloc(size*channels*sizeof(float));
+        CUAssertLog(capacity,"Scheduler capacity is 0");
+        _buffer  = (float*)malloc(capacity*channels*sizeof(float));
+        _local   = AudioClock::alloc(_sampling);
+        _clock   = _local;
         return true;
     }
     return false;
@@ -265,10 +332,14 @@ void AudioScheduler::dispose() {
         _loops = 0;
         _qsize = 0;
         _qskip = 0;
+        _qtrim = 0;
         _overlap = 0;
         _mempos = 0;
         _current  = nullptr;
         _previous = nullptr;
+        _start = 0;
+        std::atomic_store_explicit(&_clock,{},std::memory_order_relaxed);
+        _local = nullptr;
     }
 }
 
@@ -293,10 +364,16 @@ void AudioScheduler::dispose() {
  * called when the node is removed, either because it completed (defined
  * by {@link AudioNode#completed()}) or is interrupted.
  *
+ * If time is not 0, the node does not start until that time on the
+ * {@link #getClock} (the scheduler is silent until then). The previous
+ * node is still removed at the next render frame. To replace the active
+ * node at an exact time, use {@link #append} with a time instead.
+ *
  * @param node  The audio node for playback
  * @param loop  The number of times to loop the audio
+ * @param time  The clock time to start the node (0 for immediately)
  */
-void AudioScheduler::play(const std::shared_ptr<AudioNode>& node, Sint32 loop) {
+void AudioScheduler::play(const std::shared_ptr<AudioNode>& node, Sint32 loop, Uint64 time) {
     if (node->getChannels() != _channels) {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR,
                      "AudioNode has the wrong number of channels: %d",
@@ -308,10 +385,9 @@ void AudioScheduler::play(const std::shared_ptr<AudioNode>& node, Sint32 loop) {
                      node->getRate());
         return;
     }
-    _queue.push(node,loop);
-    _qsize.exchange(_qsize.load(std::memory_order_relaxed)+1,std::memory_order_release);
-    _qskip.store(_qsize.load(std::memory_order_relaxed),std::memory_order_release);
-
+    _queue.push(node,loop,time);
+    Uint32 size = _qsize.fetch_add(1,std::memory_order_acq_rel)+1;
+    _qskip.store(size,std::memory_order_release);
 }
 
 /**
@@ -331,10 +407,18 @@ void AudioScheduler::play(const std::shared_ptr<AudioNode>& node, Sint32 loop) {
  * called when the node is removed, either because it completed (defined
  * by {@link AudioNode#completed()}) or is interrupted.
  *
+ * If time is not 0, the node starts at that time on the {@link #getClock},
+ * accurate to the frame. If the node reaches the front of the queue
+ * before then, the scheduler is silent until that time. If the active
+ * node is still playing at that time, it is interrupted at that frame.
+ * Timed nodes still respect the order of the queue; they cannot start
+ * until all earlier nodes have started.
+ *
  * @param node  The audio node for playback
  * @param loop  The number of times to loop the audio
+ * @param time  The clock time to start the node (0 for when it is reached)
  */
-void AudioScheduler::append(const std::shared_ptr<AudioNode>& node, Sint32 loop) {
+void AudioScheduler::append(const std::shared_ptr<AudioNode>& node, Sint32 loop, Uint64 time) {
     if (node->getChannels() != _channels) {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR,
                      "AudioNode has the wrong number of channels: %d",
@@ -347,8 +431,41 @@ void AudioScheduler::append(const std::shared_ptr<AudioNode>& node, Sint32 loop)
         return;
     }
     
-    _queue.push(node,loop);
-    _qsize.store(_qsize.load(std::memory_order_relaxed)+1,std::memory_order_release);
+    _queue.push(node,loop,time);
+    _qsize.fetch_add(1,std::memory_order_acq_rel);
+}
+
+/**
+ * Returns the sample clock for timed playback.
+ *
+ * The times given to {@link #play} and {@link #append} are frames on
+ * this clock. By default, a scheduler has its own clock, which counts
+ * the frames read from this node. To place events relative to the
+ * output, this should be the clock of the {@link AudioOutput}.
+ *
+ * @return the sample clock for timed playback.
+ */
+std::shared_ptr<AudioClock> AudioScheduler::getClock() const {
+    return std::atomic_load_explicit(&_clock,std::memory_order_relaxed);
+}
+
+/**
+ * Sets the sample clock for timed playback.
+ *
+ * The times given to {@link #play} and {@link #append} are frames on
+ * this clock. This should typically be the clock of the terminal node
+ * of the audio graph (an {@link AudioOutput} or {@link AudioRenderer}),
+ * which must have the same sample rate. If the clock is null, the
+ * scheduler reverts to its own clock.
+ *
+ * This method should be called before any timed events are scheduled.
+ *
+ * @param clock The sample clock for timed playback
+ */
+void AudioScheduler::setClock(const std::shared_ptr<AudioClock>& clock) {
+    CUAssertLog(!clock || clock->getRate() == _sampling,
+                "Clock rate %d does not match the scheduler", clock ? clock->getRate() : 0);
+    std::atomic_store_explicit(&_clock,clock ? clock : _local,std::memory_order_release);
 }
 
 /**
@@ -376,18 +493,28 @@ std::shared_ptr<AudioNode> AudioScheduler::getCurrent() const {
  *
  * The optional force argument allows for sounds to be purged immediately
  * (such as during clean-up).  However, doing so will not invoke the callback
- * function, even if it is provided.
+ * function, even if it is provided. A forced clear waits for the current
+ * read (if any) to finish, and the audio thread outputs silence until the
+ * purge is complete.
  *
  * @param force whether to delete the queue immediately, in the current thread
  */
 void AudioScheduler::clear(bool force) {
     if (!force) {
-        _qskip.store(_qsize.load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+        _qskip.store(_qsize.load(std::memory_order_relaxed)+1,std::memory_order_release);
     } else {
-        bool orig = _paused.exchange(true,std::memory_order_relaxed);
+        // Sequential consistency guarantees read() sees the pause or we see the poll
+        bool orig = _paused.exchange(true,std::memory_order_seq_cst);
+        while (_polling.load(std::memory_order_seq_cst)) {
+            std::this_thread::yield();
+        }
         _queue.clear();
+        _qsize.store(0,std::memory_order_relaxed);
+        _qskip.store(0,std::memory_order_relaxed);
+        _qtrim.store(0,std::memory_order_relaxed);
         _current = nullptr;
-        _paused.store(orig, std::memory_order_relaxed);
+        _previous = nullptr;
+        _paused.store(orig, std::memory_order_release);
     }
 }
 
@@ -438,21 +565,21 @@ void AudioScheduler::skip(Uint32 n) {
  * Empties the queue without stopping the current playback.
  *
  * This method is useful when we want to clear the queue, but to smoothly
- * fade-out the current playback.
+ * fade-out the current playback. If size is non-negative, only that many
+ * elements are removed from the front of the queue.
+ *
+ * Like {@link #clear}, this method only posts a request. The elements are
+ * removed by the audio thread at its next read.
+ *
+ * @param size  The number of elements to remove (-1 for all)
  */
 void AudioScheduler::trim(Sint32 size) {
     if (size < 0) {
-        _queue.clear();
-    } else {
-        Uint32 qsize = _qsize.load(std::memory_order_relaxed);
-        Sint32 actly = (Sint32)qsize-size;
-        actly = std::max(actly,0);
-        actly = _qsize.exchange(actly,std::memory_order_relaxed);
-        size -= (qsize-actly);
-        std::shared_ptr<AudioNode> result;
-        while(size--) {
-            _queue.pop(result,actly);
-        }
+        _qtrim.store(-1,std::memory_order_release);
+    } else if (size > 0) {
+        // Accumulate with earlier requests, unless one already trims everything
+        Sint32 prev = _qtrim.load(std::memory_order_relaxed);
+        while (prev >= 0 && !_qtrim.compare_exchange_weak(prev,prev+size,std::memory_order_acq_rel)) {}
     }
 }
 
@@ -568,22 +695,49 @@ void AudioScheduler::setLoops(Sint32 loop) {
  * @return the actual number of frames read
  */
 Uint32 AudioScheduler::read(float* buffer, Uint32 frames) {
-    if (_paused.load(std::memory_order_relaxed)) {
+    // Announce the poll before checking the pause (see clear)
+    _polling.store(true,std::memory_order_seq_cst);
+    std::shared_ptr<AudioClock> clock = std::atomic_load_explicit(&_clock,std::memory_order_acquire);
+    if (_paused.load(std::memory_order_seq_cst)) {
         std::memset(buffer,0,frames*sizeof(float)*_channels);
+        if (clock == _local) {
+            clock->advance(frames);
+        }
+        _polling.store(false,std::memory_order_release);
         return frames;
     }
     
-    _polling.store(true);
+    applyTrim();
     Uint32 skip = _qskip.exchange(0);
     
     Sint32 loop;
     std::shared_ptr<AudioNode> previous = _previous;
     std::shared_ptr<AudioNode> current  = acquire(loop,skip,Action::INTERRUPT);
     Uint32 overlap = _overlap.load(std::memory_order_acquire);
+    Uint64 base = clock->getFrames();
     
     Uint32 amt = 0;
     while (amt < frames && current != nullptr) {
+        Uint64 now  = base+amt;
         Uint32 need = frames-amt;
+        if (_start > now) {
+            // Silence until a timed start
+            Uint32 wait = (Uint32)std::min(_start-now,(Uint64)need);
+            std::memset(buffer+amt*_channels,0,wait*_channels*sizeof(float));
+            amt += wait;
+            continue;
+        }
+        
+        // Split the block at the next timed entry (the size lags the push)
+        Uint64 next = _qsize.load(std::memory_order_acquire) ? _queue.peekTime() : 0;
+        if (next && next <= now) {
+            current = acquire(loop,1,Action::INTERRUPT);
+            continue;
+        } else if (next) {
+            need = (Uint32)std::min(next-now,(Uint64)need);
+        }
+        Uint32 goal = amt+need;
+        
         if (previous && current && overlap > 0) {
             // Continue an existing overlap
             float* output = buffer+amt*_channels;
@@ -626,7 +780,7 @@ Uint32 AudioScheduler::read(float* buffer, Uint32 frames) {
             if (current->completed()) {
                 current = acquire(loop,1,Action::COMPLETE);
             }
-        } else if (overlap > 0 && loop == 0 && _qsize.load(std::memory_order_acquire)) {
+        } else if (overlap > 0 && loop == 0 && !next && _qsize.load(std::memory_order_acquire)) {
             // Check whether we need to overlap
             Sint64 remain = current->getRemaining()*_sampling;
             if (remain >= 0 && remain-overlap <= need) {
@@ -635,18 +789,19 @@ Uint32 AudioScheduler::read(float* buffer, Uint32 frames) {
                 }
                 _previous = current;
                 previous = _previous;
-                _queue.pop(_current,loop);
+                _queue.pop(_current,loop,_start);
+                _qsize.fetch_sub(1,std::memory_order_acq_rel);
                 current = _current;
             } else {
                 amt += current->read(&(buffer[amt*_channels]),need);
-                if (amt < frames || current->completed()) {
+                if (amt < goal || current->completed()) {
                     current = acquire(loop,1,Action::COMPLETE);
                 }
             }
         } else {
             // Perform a normal read
             amt += current->read(&(buffer[amt*_channels]),need);
-            if (loop && amt < frames) {
+            if (loop && amt < goal) {
                 if (!current->reset()) {
                     current = nullptr;
                     _current = nullptr;
@@ -654,7 +809,7 @@ Uint32 AudioScheduler::read(float* buffer, Uint32 frames) {
                     notify(current,Action::LOOPBACK);
                 }
                 if (loop > 0) { loop--;}
-            } else if (amt < frames || (!loop && current->completed())) {
+            } else if (amt < goal || (!loop && current->completed())) {
                 current = acquire(loop,1,Action::COMPLETE);
             }
         }
@@ -666,7 +821,10 @@ Uint32 AudioScheduler::read(float* buffer, Uint32 frames) {
     }
     
     _loops.store(loop,std::memory_order_relaxed);
-    _polling.store(false);
+    if (clock == _local) {
+        clock->advance(frames);
+    }
+    _polling.store(false,std::memory_order_release);
     return frames;
 }
 
@@ -889,17 +1047,20 @@ std::shared_ptr<AudioNode> AudioScheduler::acquire(Sint32& loop, Uint32 skip, Au
     // But getting a local variable is good enough.
     std::shared_ptr<AudioNode> result = _current;
     Uint32 size = _qsize.load(std::memory_order_acquire);
+    Uint32 taken = 0;
     bool callback = _calling.load(std::memory_order_relaxed);
     bool change = false;
+    Uint64 start = _start;
     
     loop = _loops.load(std::memory_order_relaxed);
     while (skip && size) {
         if (result != nullptr && callback) {
             notify(result,action);
         }
-        _queue.pop(result,loop);
+        _queue.pop(result,loop,start);
         size--;
         skip--;
+        taken++;
         change = true;
     }
     if (skip) {
@@ -908,17 +1069,43 @@ std::shared_ptr<AudioNode> AudioScheduler::acquire(Sint32& loop, Uint32 skip, Au
         }
         result = nullptr;
         loop = 0;
+        start = 0;
         change = true;
     } else if (result == nullptr && size) {
-        _queue.pop(result,loop);
+        _queue.pop(result,loop,start);
         size--;
+        taken++;
         change = true;
     }
 
     if (change) {
-        _qsize.store(size,std::memory_order_release);
+        // The main thread may have pushed more entries in the meantime
+        _qsize.fetch_sub(taken,std::memory_order_acq_rel);
         _loops.store(loop,std::memory_order_relaxed);
         _current = result;
+        _start = start;
     }
     return result;
 }
+
+/**
+ * Removes the elements requested by {@link #trim} from the queue.
+ *
+ * AUDIO THREAD ONLY: This is an internal method for queue management.
+ * Only the audio thread is allowed to delete from the playback queue.
+ */
+void AudioScheduler::applyTrim() {
+    Sint32 trim = _qtrim.exchange(0,std::memory_order_acq_rel);
+    if (trim == 0) {
+        return;
+    }
+    
+    Uint32 size = _qsize.load(std::memory_order_acquire);
+    Uint32 amt  = (trim < 0 || (Uint32)trim > size) ? size : (Uint32)trim;
+    std::shared_ptr<AudioNode> node;
+    Sint32 loop;
+    for(Uint32 ii = 0; ii < amt; ii++) {
+        _queue.pop(node,loop);
+    }
+    _qsize.fetch_sub(amt,std::memory_order_acq_rel);
+}
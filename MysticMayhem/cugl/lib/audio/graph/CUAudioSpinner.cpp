@@ -577,6 +577,7 @@ bool AudioSpinner::completed() {
  * @return the actual number of frames read
  */
 Uint32 AudioSpinner::read(float* buffer, Uint32 frames) {
+    AudioProfiler::Scope scope(_profiler.get(),AudioProfiler::Stage::SPINNER);
     std::shared_ptr<AudioNode> input = std::atomic_load_explicit(&_input,std::memory_order_relaxed);
     if (input == nullptr || _paused.load(std::memory_order_relaxed)) {
         std::memset(buffer,0,frames*_channels*sizeof(float));
@@ -33,6 +33,7 @@
 #include <cugl/base/CUApplication.h>
 #include <cugl/base/CUDisplay.h>
 #include <cugl/render/CUTexture.h>
+#include <cugl/render/CURenderBackend.h>
 #include <cugl/input/CUInput.h>
 #include <cugl/util/CUDebug.h>
 #include <algorithm>
@@ -273,8 +274,9 @@ bool Application::step() {
         processCallbacks(((Uint32)micros)/1000);
         update(micros/1000000.0f);
 
-        glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
-        glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        RenderBackend* backend = RenderBackend::get();
+        backend->clearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
+        backend->clear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         draw();
         Display::get()->refresh();
@@ -17,6 +17,9 @@
 //  have proper file systems.  You should confine all files to either the asset
 //  or the save directory.
 //
+//  A reader may also map the file into memory rather than read it in chunks.
+//  Mapped readers are best for assets that are read from start to finish.
+//
 //  This class uses our standard shared-pointer architecture.
 //
 //  1. The constructor does not perform any initialization; it just sets all
@@ -55,11 +58,74 @@
 #include <cugl/base/CUApplication.h>
 #include <cugl/base/CUEndian.h>
 #include <cugl/util/CUFiletools.h>
+#include <cugl/io/CUMappedFile.h>
+#include <cugl/math/CUMathBase.h>
+#include <algorithm>
+#include <cstring>
 
 using namespace cugl;
 
 #define BUFFSIZE 1024
 
+#pragma mark -
+#pragma mark Byte Swapping
+/**
+ * Marshalls an array of values from network order in place.
+ *
+ * This is a bulk version of {@link marshall}. It does nothing on big-endian
+ * platforms. Otherwise, it reverses the bytes of each value, sixteen bytes
+ * at a time when vectorization is enabled.
+ *
+ * @param data  The array of values
+ * @param size  The number of bytes in a value (2, 4, or 8)
+ * @param count The number of values in the array
+ */
+static void marshall_array(Uint8* data, size_t size, size_t count) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    size_t bytes = size*count;
+    size_t pos = 0;
+#if defined (CU_MATH_VECTOR_NEON64)
+    switch (size) {
+        case 2:
+            for(; pos+16 <= bytes; pos += 16) {
+                vst1q_u8(data+pos, vrev16q_u8(vld1q_u8(data+pos)));
+            }
+            break;
+        case 4:
+            for(; pos+16 <= bytes; pos += 16) {
+                vst1q_u8(data+pos, vrev32q_u8(vld1q_u8(data+pos)));
+            }
+            break;
+        case 8:
+            for(; pos+16 <= bytes; pos += 16) {
+                vst1q_u8(data+pos, vrev64q_u8(vld1q_u8(data+pos)));
+            }
+            break;
+    }
+#elif defined (CU_MATH_VECTOR_SSE) && defined (__SSSE3__)
+    __m128i mask;
+    switch (size) {
+        case 2:
+            mask = _mm_setr_epi8(1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14);
+            break;
+        case 4:
+            mask = _mm_setr_epi8(3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12);
+            break;
+        default:
+            mask = _mm_setr_epi8(7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8);
+            break;
+    }
+    for(; pos+16 <= bytes; pos += 16) {
+        __m128i value = _mm_loadu_si128((const __m128i*)(data+pos));
+        _mm_storeu_si128((__m128i*)(data+pos), _mm_shuffle_epi8(value,mask));
+    }
+#endif
+    for(; pos < bytes; pos += size) {
+        std::reverse(data+pos, data+pos+size);
+    }
+#endif
+}
+
 #pragma mark -
 #pragma mark Constructors
 
@@ -109,6 +175,9 @@ bool BinaryReader::init(const std::string file, unsigned int capacity) {
     _buffer = new char[_capacity];
     _bufsize = 0;
     fill();
+    if (_bufoff < 0) {
+        _bufoff = 0;
+    }
     
     return _ssize >= 0;
 }
@@ -163,10 +232,59 @@ bool BinaryReader::initWithAsset(const std::string file, unsigned int capacity)
     _buffer = new char[_capacity];
     _bufsize = 0;
     fill();
+    if (_bufoff < 0) {
+        _bufoff = 0;
+    }
     
     return _ssize >= 0;
 }
 
+/**
+ * Initializes a mapped reader for the given file.
+ *
+ * A mapped reader has no read buffer. Instead, the entire file is mapped
+ * into memory {@see MappedFile}, and every read copies directly out of
+ * the mapping.
+ *
+ * If the file is a relative path, this reader will look for the file in
+ * the application save directory {@see Application#getSaveDirectory()}.
+ * If you wish to read a file in any other directory, you must provide
+ * an absolute path.
+ *
+ * @param file  the path (absolute or relative) to the file
+ *
+ * @return true if the reader is initialized properly, false otherwise.
+ */
+bool BinaryReader::initMapped(const std::string file) {
+    _name = filetool::normalize_path(file);
+    return map();
+}
+
+/**
+ * Initializes a mapped reader for the given file.
+ *
+ * A mapped reader has no read buffer. Instead, the entire file is mapped
+ * into memory {@see MappedFile}, and every read copies directly out of
+ * the mapping.
+ *
+ * This initializer assumes that the file name is a relative path. It will
+ * search the application assert directory {@see Application#getAssetDirectory()}
+ * for the file and return false if it cannot find it there.
+ *
+ * @param file  the relative path to the file
+ *
+ * @return true if the reader is initialized properly, false otherwise.
+ */
+bool BinaryReader::initMappedWithAsset(const std::string file) {
+    bool absolute = filetool::is_absolute(file);
+    CUAssertLog(!absolute, "This initializer does not accept absolute paths");
+    
+    _name = Application::get()->getAssetDirectory();
+    _name.append(file);
+    _name = filetool::normalize_path(_name);
+    return map();
+}
+
 
 #pragma mark -
 #pragma mark Stream Management
@@ -177,15 +295,22 @@ bool BinaryReader::initWithAsset(const std::string file, unsigned int capacity)
  * if the stream has been closed.
  */
 void BinaryReader::reset() {
-    if (_stream) {
-        close();
+    close();
+    if (_mapped) {
+        map();
+        return;
     }
+    
     _stream = SDL_RWFromFile(_name.c_str(), "rb");
     _ssize  = SDL_RWsize(_stream);
     _buffer = new char[_capacity];
     _bufsize = 0;
-    _bufoff  = 0;
+    _bufoff  = -1;
     _scursor = 0;
+    fill();
+    if (_bufoff < 0) {
+        _bufoff = 0;
+    }
 }
 
 /**
@@ -200,7 +325,12 @@ void BinaryReader::close() {
         _stream  = nullptr;
         _scursor = 0;
     }
-    if (_buffer) {
+    if (_mapping) {
+        _mapping = nullptr;
+        _buffer  = nullptr;
+        _bufsize = 0;
+        _bufoff  = 0;
+    } else if (_buffer) {
         delete[] _buffer;
         _buffer  = nullptr;
         _bufsize = 0;
@@ -254,6 +384,90 @@ void BinaryReader::fill(unsigned int bytes) {
     _scursor += amt;
 }
 
+/**
+ * Maps the file {@link #_name} into memory, returning true on success.
+ *
+ * The mapping takes the place of the read buffer, so that it holds the
+ * entire file.
+ *
+ * @return true if the file was mapped
+ */
+bool BinaryReader::map() {
+    _mapped  = true;
+    _mapping = MappedFile::alloc(_name);
+    if (_mapping == nullptr) {
+        return false;
+    }
+    CUAssertLog(_mapping->size() <= (size_t)SDL_MAX_SINT32, "File %s is too large to read", _name.c_str());
+    
+    // The mapping is read-only, but this reader never writes to the buffer without a stream
+    _buffer   = (char*)_mapping->data();
+    _capacity = (Uint32)_mapping->size();
+    _bufsize  = _capacity;
+    _bufoff   = 0;
+    _ssize    = (Sint64)_mapping->size();
+    _scursor  = _ssize;
+    return true;
+}
+
+/**
+ * Copies up to the given number of bytes from the stream to the buffer.
+ *
+ * Unlike the buffer refill, this method is not limited by the capacity.
+ * Once the buffer is empty, any request of at least the capacity is read
+ * directly into the destination.
+ *
+ * @param buffer    The array to store the data when read
+ * @param bytes     The number of bytes to read
+ *
+ * @return the number of bytes read
+ */
+size_t BinaryReader::copy(Uint8* buffer, size_t bytes) {
+    size_t total = 0;
+    while (total < bytes) {
+        size_t available = _bufsize-_bufoff;
+        if (available) {
+            size_t amt = std::min(available,bytes-total);
+            std::memcpy(buffer+total, _buffer+_bufoff, amt);
+            _bufoff += (Sint32)amt;
+            total += amt;
+        } else if (!_stream || _scursor >= _ssize) {
+            break;
+        } else if (bytes-total >= _capacity) {
+            size_t amt = SDL_RWread(_stream, buffer+total, 1, bytes-total);
+            if (!amt) {
+                break;
+            }
+            _scursor += amt;
+            total += amt;
+        } else {
+            fill(1);
+            if (_bufoff >= (Sint32)_bufsize) {
+                break;
+            }
+        }
+    }
+    return total;
+}
+
+/**
+ * Copies whole elements of the given size from the stream to the buffer.
+ *
+ * This method reads as many elements as remain in the stream, up to
+ * the given maximum. It does not marshall the elements.
+ *
+ * @param buffer    The array to store the data when read
+ * @param size      The number of bytes in an element
+ * @param maximum   The maximum number of elements to read from the stream
+ *
+ * @return the number of elements read
+ */
+size_t BinaryReader::copy(Uint8* buffer, size_t size, size_t maximum) {
+    size_t remain = (_bufsize-_bufoff)+(size_t)(_ssize-_scursor);
+    size_t count = std::min(maximum,remain/size);
+    return copy(buffer,count*size)/size;
+}
+
 #pragma mark -
 #pragma mark Single Element Reads
 /**
@@ -455,16 +669,7 @@ double BinaryReader::readDouble()  {
  */
 size_t BinaryReader::read(char* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    while (ready(1) && pos-offset < maximum) {
-        size_t available = _bufsize-_bufoff;
-        size_t wanted = maximum-(pos-offset);
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)wanted;
-    }
-    return pos-offset;
+    return copy((Uint8*)(buffer+offset),maximum);
 }
 
 /**
@@ -479,18 +684,9 @@ size_t BinaryReader::read(char* buffer, size_t maximum, size_t offset) {
  *
  * @return the number of bytes read from the stream
  */
-size_t BinaryReader::read(Uint8* buffer, size_t maximum, size_t offset)  {
+size_t BinaryReader::read(Uint8* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    while (ready(1) && pos-offset < maximum) {
-        size_t available = _bufsize-_bufoff;
-        size_t wanted = maximum-(pos-offset);
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)wanted;
-    }
-    return pos-offset;
+    return copy((Uint8*)(buffer+offset),maximum);
 }
 
 /**
@@ -500,7 +696,8 @@ size_t BinaryReader::read(Uint8* buffer, size_t maximum, size_t offset)  {
  * It will return the actual number of elements read (which may be 0).
  *
  * The values are marshalled from network order, ensuring that the binary
- * file is compatible against all platforms.
+ * file is compatible against all platforms. The values are swapped in
+ * bulk after they are read, and only on little-endian platforms.
  *
  * @param buffer    The array to store the data when read
  * @param maximum   The maximum number of elements to read from the stream
@@ -510,21 +707,9 @@ size_t BinaryReader::read(Uint8* buffer, size_t maximum, size_t offset)  {
  */
 size_t BinaryReader::read(Sint16* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 2;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    size_t amt = copy((Uint8*)(buffer+offset),sizeof(Sint16),maximum);
+    marshall_array((Uint8*)(buffer+offset),sizeof(Sint16),amt);
+    return amt;
 }
 
 /**
@@ -534,7 +719,8 @@ size_t BinaryReader::read(Sint16* buffer, size_t maximum, size_t offset) {
  * It will return the actual number of elements read (which may be 0).
  *
  * The values are marshalled from network order, ensuring that the binary
- * file is compatible against all platforms.
+ * file is compatible against all platforms. The values are swapped in
+ * bulk after they are read, and only on little-endian platforms.
  *
  * @param buffer    The array to store the data when read
  * @param maximum   The maximum number of elements to read from the stream
@@ -542,23 +728,11 @@ size_t BinaryReader::read(Sint16* buffer, size_t maximum, size_t offset) {
  *
  * @return the number of 16 bit unsigned integers read from the stream
  */
-size_t BinaryReader::read(Uint16* buffer, size_t maximum, size_t offset)  {
+size_t BinaryReader::read(Uint16* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 2;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    size_t amt = copy((Uint8*)(buffer+offset),sizeof(Uint16),maximum);
+    marshall_array((Uint8*)(buffer+offset),sizeof(Uint16),amt);
+    return amt;
 }
 
 
@@ -569,7 +743,8 @@ size_t BinaryReader::read(Uint16* buffer, size_t maximum, size_t offset)  {
  * It will return the actual number of elements read (which may be 0).
  *
  * The values are marshalled from network order, ensuring that the binary
- * file is compatible against all platforms.
+ * file is compatible against all platforms. The values are swapped in
+ * bulk after they are read, and only on little-endian platforms.
  *
  * @param buffer    The array to store the data when read
  * @param maximum   The maximum number of elements to read from the stream
@@ -579,21 +754,9 @@ size_t BinaryReader::read(Uint16* buffer, size_t maximum, size_t offset)  {
  */
 size_t BinaryReader::read(Sint32* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 4;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    size_t amt = copy((Uint8*)(buffer+offset),sizeof(Sint32),maximum);
+    marshall_array((Uint8*)(buffer+offset),sizeof(Sint32),amt);
+    return amt;
 }
 
 /**
@@ -603,7 +766,8 @@ size_t BinaryReader::read(Sint32* buffer, size_t maximum, size_t offset) {
  * It will return the actual number of elements read (which may be 0).
  *
  * The values are marshalled from network order, ensuring that the binary
- * file is compatible against all platforms.
+ * file is compatible against all platforms. The values are swapped in
+ * bulk after they are read, and only on little-endian platforms.
  *
  * @param buffer    The array to store the data when read
  * @param maximum   The maximum number of elements to read from the stream
@@ -613,21 +777,9 @@ size_t BinaryReader::read(Sint32* buffer, size_t maximum, size_t offset) {
  */
 size_t BinaryReader::read(Uint32* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 4;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    size_t amt = copy((Uint8*)(buffer+offset),sizeof(Uint32),maximum);
+    marshall_array((Uint8*)(buffer+offset),sizeof(Uint32),amt);
+    return amt;
 }
 
 /**
@@ -637,7 +789,8 @@ size_t BinaryReader::read(Uint32* buffer, size_t maximum, size_t offset) {
  * It will return the actual number of elements read (which may be 0).
  *
  * The values are marshalled from network order, ensuring that the binary
- * file is compatible against all platforms.
+ * file is compatible against all platforms. The values are swapped in
+ * bulk after they are read, and only on little-endian platforms.
  *
  * @param buffer    The array to store the data when read
  * @param maximum   The maximum number of elements to read from the stream
@@ -647,21 +800,9 @@ size_t BinaryReader::read(Uint32* buffer, size_t maximum, size_t offset) {
  */
 size_t BinaryReader::read(Sint64* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 8;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    size_t amt = copy((Uint8*)(buffer+offset),sizeof(Sint64),maximum);
+    marshall_array((Uint8*)(buffer+offset),sizeof(Sint64),amt);
+    return amt;
 }
 
 /**
@@ -671,7 +812,8 @@ size_t BinaryReader::read(Sint64* buffer, size_t maximum, size_t offset) {
  * It will return the actual number of elements read (which may be 0).
  *
  * The values are marshalled from network order, ensuring that the binary
- * file is compatible against all platforms.
+ * file is compatible against all platforms. The values are swapped in
+ * bulk after they are read, and only on little-endian platforms.
  *
  * @param buffer    The array to store the data when read
  * @param maximum   The maximum number of elements to read from the stream
@@ -681,21 +823,9 @@ size_t BinaryReader::read(Sint64* buffer, size_t maximum, size_t offset) {
  */
 size_t BinaryReader::read(Uint64* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 8;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    size_t amt = copy((Uint8*)(buffer+offset),sizeof(Uint64),maximum);
+    marshall_array((Uint8*)(buffer+offset),sizeof(Uint64),amt);
+    return amt;
 }
 
 /**
@@ -705,7 +835,8 @@ size_t BinaryReader::read(Uint64* buffer, size_t maximum, size_t offset) {
  * It will return the actual number of elements read (which may be 0).
  *
  * The values are marshalled from network order, ensuring that the binary
- * file is compatible against all platforms.
+ * file is compatible against all platforms. The values are swapped in
+ * bulk after they are read, and only on little-endian platforms.
  *
  * @param buffer    The array to store the data when read
  * @param maximum   The maximum number of elements to read from the stream
@@ -715,21 +846,9 @@ size_t BinaryReader::read(Uint64* buffer, size_t maximum, size_t offset) {
  */
 size_t BinaryReader::read(float* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 4;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    size_t amt = copy((Uint8*)(buffer+offset),sizeof(float),maximum);
+    marshall_array((Uint8*)(buffer+offset),sizeof(float),amt);
+    return amt;
 }
 
 /**
@@ -739,7 +858,8 @@ size_t BinaryReader::read(float* buffer, size_t maximum, size_t offset) {
  * It will return the actual number of elements read (which may be 0).
  *
  * The values are marshalled from network order, ensuring that the binary
- * file is compatible against all platforms.
+ * file is compatible against all platforms. The values are swapped in
+ * bulk after they are read, and only on little-endian platforms.
  *
  * @param buffer    The array to store the data when read
  * @param maximum   The maximum number of elements to read from the stream
@@ -749,20 +869,8 @@ size_t BinaryReader::read(float* buffer, size_t maximum, size_t offset) {
  */
 size_t BinaryReader::read(double* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 8;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    size_t amt = copy((Uint8*)(buffer+offset),sizeof(double),maximum);
+    marshall_array((Uint8*)(buffer+offset),sizeof(double),amt);
+    return amt;
 }
 
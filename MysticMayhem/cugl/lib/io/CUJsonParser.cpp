@@ -0,0 +1,794 @@
+//
+//  CUJsonParser.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a single pass, streaming JSON parser. It is a pull
+//  parser: the programmer asks for one token at a time, and string tokens are
+//  views into the source text wherever possible. This allows a large file to
+//  be consumed without building the entire JSON tree. When a tree is needed
+//  (for the whole file or just a single value), the parser builds JsonValue
+//  nodes directly, without the intermediate cJSON tree. These nodes are
+//  allocated from an arena that belongs to the document.
+//
+//  By default, this module (and every module in the io package) accesses the
+//  application save directory.  If you want to access another directory, you
+//  will need to specify an absolute path for the file name.  Keep in mind that
+//  absolute paths are very dangerous on mobile devices, because they do not
+//  have proper file systems.  You should confine all files to either the asset
+//  or the save directory.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#include <cugl/io/CUJsonParser.h>
+#include <cugl/util/CUDebug.h>
+#include <cugl/util/CUFiletools.h>
+#include <cugl/util/CUStrings.h>
+#include <cugl/base/CUApplication.h>
+#include <SDL/SDL.h>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+using namespace cugl;
+
+/** The size of the first block of a document arena */
+#define ARENA_BLOCK     4096
+/** The maximum size of a block of a document arena */
+#define ARENA_MAXBLOCK  65536
+/** The longest number literal that we accept */
+#define NUMBER_LIMIT    63
+
+#pragma mark -
+#pragma mark Arena
+namespace cugl {
+/**
+ * A bump allocator for the nodes of a single document.
+ *
+ * Memory is only released when the arena is deleted. The arena is shared
+ * by all of the nodes that it allocates, so it lives as long as any node in
+ * the document. It is only safe to allocate from one thread at a time.
+ */
+class JsonArena {
+private:
+    /** The memory blocks */
+    std::vector<std::unique_ptr<char[]>> _blocks;
+    /** The number of bytes used in the last block */
+    size_t _used;
+    /** The size of the last block */
+    size_t _size;
+
+public:
+    /**
+     * Creates an empty arena
+     */
+    JsonArena() : _used(0), _size(0) {}
+
+    /**
+     * Returns a pointer to the given number of bytes
+     *
+     * @param bytes The number of bytes to allocate
+     * @param align The alignment of the memory
+     *
+     * @return a pointer to the given number of bytes
+     */
+    void* allocate(size_t bytes, size_t align) {
+        size_t offset = (_used+align-1) & ~(align-1);
+        if (_blocks.empty() || offset+bytes > _size) {
+            _size = _blocks.empty() ? ARENA_BLOCK : std::min(2*_size,(size_t)ARENA_MAXBLOCK);
+            _size = std::max(_size,bytes);
+            _blocks.emplace_back(new char[_size]);
+            offset = 0;
+        }
+        _used = offset+bytes;
+        return _blocks.back().get()+offset;
+    }
+};
+}
+
+/**
+ * An STL allocator for a document arena.
+ *
+ * Deallocation does nothing, as the arena releases all memory at once. Each
+ * allocation keeps a reference to the arena (through the shared pointer
+ * control block), so the arena cannot be deleted before its nodes.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    /** The allocated type */
+    typedef T value_type;
+    /** The document arena */
+    std::shared_ptr<JsonArena> arena;
+
+    /**
+     * Creates an allocator for the given arena
+     *
+     * @param arena The document arena
+     */
+    explicit ArenaAllocator(const std::shared_ptr<JsonArena>& arena) : arena(arena) {}
+
+    /**
+     * Creates a copy of the given allocator
+     *
+     * @param other The allocator to copy
+     */
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    /**
+     * Returns storage for n objects of type T
+     *
+     * @param n The number of objects
+     *
+     * @return storage for n objects of type T
+     */
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n*sizeof(T),alignof(T)));
+    }
+
+    /**
+     * Releases storage (which does nothing)
+     */
+    void deallocate(T*, size_t) {}
+
+    /**
+     * Returns true if the allocators share an arena
+     */
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+    /**
+     * Returns true if the allocators have different arenas
+     */
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+/**
+ * Appends the given code point to the string as UTF-8
+ *
+ * @param code      The code point
+ * @param result    The string to modify
+ */
+static void append_utf8(Uint32 code, std::string& result) {
+    if (code < 0x80) {
+        result += (char)code;
+    } else if (code < 0x800) {
+        result += (char)(0xC0 | (code >> 6));
+        result += (char)(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        result += (char)(0xE0 | (code >> 12));
+        result += (char)(0x80 | ((code >> 6) & 0x3F));
+        result += (char)(0x80 | (code & 0x3F));
+    } else {
+        result += (char)(0xF0 | (code >> 18));
+        result += (char)(0x80 | ((code >> 12) & 0x3F));
+        result += (char)(0x80 | ((code >> 6) & 0x3F));
+        result += (char)(0x80 | (code & 0x3F));
+    }
+}
+
+/**
+ * Reads four hex digits, returning false if they are invalid
+ *
+ * @param pos   The position of the first digit
+ * @param end   The end of the text
+ * @param code  The variable to store the value
+ *
+ * @return true if the digits are valid
+ */
+static bool read_hex(const char* pos, const char* end, Uint32& code) {
+    if (end-pos < 4) {
+        return false;
+    }
+    code = 0;
+    for(int ii = 0; ii < 4; ii++) {
+        char c = pos[ii];
+        code <<= 4;
+        if ('0' <= c && c <= '9') {
+            code |= c-'0';
+        } else if ('a' <= c && c <= 'f') {
+            code |= c-'a'+10;
+        } else if ('A' <= c && c <= 'F') {
+            code |= c-'A'+10;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Reads a simple decimal number, returning false if it is not simple
+ *
+ * A number is simple if it has no exponent and at most 15 significant
+ * digits, with at most 22 after the decimal point. Such a number is exact
+ * as a quotient of two doubles, so the result is correctly rounded (just
+ * like strtod). Other numbers must use strtod.
+ *
+ * @param pos       The start of the number
+ * @param end       The end of the number
+ * @param result    The variable to store the value
+ *
+ * @return true if the number is simple
+ */
+static bool read_number(const char* pos, const char* end, double& result) {
+    static const double powers[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    bool negative = (pos < end && *pos == '-');
+    if (negative) {
+        pos++;
+    }
+    if (pos == end || !isdigit(*pos)) {
+        return false;
+    }
+    
+    Uint64 mantissa = 0;
+    int digits = 0;
+    int fraction = -1;
+    for(; pos < end; pos++) {
+        if (isdigit(*pos)) {
+            mantissa = mantissa*10+(*pos-'0');
+            digits += (mantissa > 0);
+            if (fraction >= 0) {
+                fraction++;
+            }
+        } else if (*pos == '.' && fraction < 0) {
+            fraction = 0;
+        } else {
+            return false;
+        }
+    }
+    if (digits > 15 || fraction == 0 || fraction > 22) {
+        return false;
+    }
+    
+    result = (double)mantissa;
+    if (fraction > 0) {
+        result /= powers[fraction];
+    }
+    if (negative) {
+        result = -result;
+    }
+    return true;
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates a parser with no text.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+JsonParser::JsonParser() :
+_begin(nullptr),
+_pos(nullptr),
+_end(nullptr),
+_token(Token::End),
+_number(0.0),
+_bool(false),
+_first(false),
+_done(false) {
+}
+
+/**
+ * Releases all resources of this parser.
+ *
+ * Any trees built by this parser are still valid.
+ */
+void JsonParser::dispose() {
+    _source.clear();
+    _begin = _pos = _end = nullptr;
+    _token = Token::End;
+    _key = std::string_view();
+    _string = std::string_view();
+    _scopes.clear();
+    _first = false;
+    _done = false;
+    _keyspace.clear();
+    _stringspace.clear();
+    _error.clear();
+    _arena = nullptr;
+}
+
+/**
+ * Initializes a parser with a copy of the given JSON text.
+ *
+ * @param json  The JSON text
+ *
+ * @return true if the parser was initialized successfully
+ */
+bool JsonParser::init(const std::string& json) {
+    _source = json;
+    return initWithBuffer(_source.data(),_source.size());
+}
+
+/**
+ * Initializes a parser for the given JSON text.
+ *
+ * The parser does not copy the text. It must remain valid for as long
+ * as the parser is in use. Trees built by {@link #readValue} do not
+ * reference the text, and may outlive it.
+ *
+ * @param json      The JSON text
+ * @param length    The number of characters in the text
+ *
+ * @return true if the parser was initialized successfully
+ */
+bool JsonParser::initWithBuffer(const char* json, size_t length) {
+    if (json == nullptr) {
+        return false;
+    }
+    _begin = _pos = json;
+    _end = json+length;
+    _token = Token::End;
+    _scopes.clear();
+    _scopes.reserve(16);
+    _first = false;
+    _done = false;
+    _error.clear();
+    _arena = std::make_shared<JsonArena>();
+    return true;
+}
+
+/**
+ * Initializes a parser for the given file.
+ *
+ * The file is read into memory in its entirety. By default, this method
+ * accesses the application save directory. If you want to access another
+ * directory, you will need to specify an absolute path for the file name.
+ *
+ * @param file  The path to the JSON file
+ *
+ * @return true if the parser was initialized successfully
+ */
+bool JsonParser::initWithFile(const std::string& file) {
+    std::string path = filetool::normalize_path(file);
+    SDL_RWops* stream = SDL_RWFromFile(path.c_str(), "r");
+    if (!stream) {
+        return false;
+    }
+
+    // Read the file in one pass
+    Sint64 size = SDL_RWsize(stream);
+    bool success = size >= 0;
+    if (success) {
+        _source.resize((size_t)size);
+        success = SDL_RWread(stream, &_source[0], 1, (size_t)size) == (size_t)size;
+    }
+    SDL_RWclose(stream);
+    return success && initWithBuffer(_source.data(),_source.size());
+}
+
+/**
+ * Initializes a parser for the given asset.
+ *
+ * The file is read into memory in its entirety. The file name is
+ * relative to the application asset directory.
+ *
+ * @param file  The path to the JSON asset
+ *
+ * @return true if the parser was initialized successfully
+ */
+bool JsonParser::initWithAsset(const std::string& file) {
+    CUAssertLog(!filetool::is_absolute(file), "This initializer does not accept absolute paths");
+    std::string path = Application::get()->getAssetDirectory();
+    path.append(file);
+    return initWithFile(path);
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Advances the read position past any whitespace
+ */
+void JsonParser::skipSpace() {
+    while (_pos < _end && (*_pos == ' ' || *_pos == '\n' || *_pos == '\r' || *_pos == '\t')) {
+        _pos++;
+    }
+}
+
+/**
+ * Reads a string literal at the current position.
+ *
+ * The result is a view into the source text if possible. Otherwise it is
+ * a view of the scratch string.
+ *
+ * @param result    The view to store the string
+ * @param scratch   The buffer for unescaped strings
+ *
+ * @return true if the string was read successfully
+ */
+bool JsonParser::readString(std::string_view& result, std::string& scratch) {
+    const char* start = ++_pos;
+    while (_pos < _end && *_pos != '"' && *_pos != '\\') {
+        _pos++;
+    }
+    if (_pos >= _end) {
+        return false;
+    } else if (*_pos == '"') {
+        result = std::string_view(start,_pos-start);
+        _pos++;
+        return true;
+    }
+
+    // Slow path for escape characters
+    scratch.assign(start,_pos);
+    while (_pos < _end && *_pos != '"') {
+        if (*_pos != '\\') {
+            scratch += *_pos++;
+            continue;
+        }
+        if (++_pos >= _end) {
+            return false;
+        }
+        Uint32 code;
+        switch (*_pos) {
+            case '"':  scratch += '"';  break;
+            case '\\': scratch += '\\'; break;
+            case '/':  scratch += '/';  break;
+            case 'b':  scratch += '\b'; break;
+            case 'f':  scratch += '\f'; break;
+            case 'n':  scratch += '\n'; break;
+            case 'r':  scratch += '\r'; break;
+            case 't':  scratch += '\t'; break;
+            case 'u':
+                if (!read_hex(_pos+1,_end,code)) {
+                    return false;
+                }
+                _pos += 4;
+                // Combine surrogate pairs
+                if (code >= 0xD800 && code < 0xDC00 && _end-_pos > 2 && _pos[1] == '\\' && _pos[2] == 'u') {
+                    Uint32 low;
+                    if (read_hex(_pos+3,_end,low) && low >= 0xDC00 && low < 0xE000) {
+                        code = 0x10000+((code-0xD800) << 10)+(low-0xDC00);
+                        _pos += 6;
+                    }
+                }
+                append_utf8(code,scratch);
+                break;
+            default:
+                return false;
+        }
+        _pos++;
+    }
+    if (_pos >= _end) {
+        return false;
+    }
+    _pos++;
+    result = scratch;
+    return true;
+}
+
+/**
+ * Reads the value at the current position, setting the current token.
+ *
+ * @return the current token
+ */
+JsonParser::Token JsonParser::readToken() {
+    if (_pos >= _end) {
+        return fail("Unexpected end of JSON");
+    }
+
+    switch (*_pos) {
+        case '{':
+            _pos++;
+            _scopes.push_back('{');
+            _first = true;
+            _token = Token::BeginObject;
+            return _token;
+        case '[':
+            _pos++;
+            _scopes.push_back('[');
+            _first = true;
+            _token = Token::BeginArray;
+            return _token;
+        case '"':
+            if (!readString(_string,_stringspace)) {
+                return fail("Invalid string");
+            }
+            _token = Token::String;
+            break;
+        case 't':
+            if (_end-_pos < 4 || strncmp(_pos,"true",4)) {
+                return fail("Invalid token");
+            }
+            _pos += 4;
+            _bool = true;
+            _token = Token::Bool;
+            break;
+        case 'f':
+            if (_end-_pos < 5 || strncmp(_pos,"false",5)) {
+                return fail("Invalid token");
+            }
+            _pos += 5;
+            _bool = false;
+            _token = Token::Bool;
+            break;
+        case 'n':
+            if (_end-_pos < 4 || strncmp(_pos,"null",4)) {
+                return fail("Invalid token");
+            }
+            _pos += 4;
+            _token = Token::Null;
+            break;
+        default:
+        {
+            const char* start = _pos;
+            while (_pos < _end && (isdigit(*_pos) || *_pos == '-' || *_pos == '+' ||
+                                   *_pos == '.' || *_pos == 'e' || *_pos == 'E')) {
+                _pos++;
+            }
+            size_t len = _pos-start;
+            if (len == 0 || len > NUMBER_LIMIT) {
+                return fail("Invalid token");
+            }
+            if (read_number(start,_pos,_number)) {
+                _token = Token::Number;
+                break;
+            }
+            // The text may not be null terminated
+            char digits[NUMBER_LIMIT+1];
+            memcpy(digits,start,len);
+            digits[len] = 0;
+            char* last = nullptr;
+            _number = strtod(digits,&last);
+            if (last != digits+len) {
+                _pos = start;
+                return fail("Invalid number");
+            }
+            _token = Token::Number;
+        }
+            break;
+    }
+
+    if (_scopes.empty()) {
+        _done = true;
+    }
+    return _token;
+}
+
+/**
+ * Marks the parser as failed with the given message
+ *
+ * @param message   The description of the error
+ *
+ * @return Token::Error
+ */
+JsonParser::Token JsonParser::fail(const char* message) {
+    int line = 1;
+    const char* start = _begin;
+    for(const char* pos = _begin; pos < _pos && pos < _end; pos++) {
+        if (*pos == '\n') {
+            line++;
+            start = pos+1;
+        }
+    }
+    const char* stop = start;
+    while (stop < _end && *stop != '\n') {
+        stop++;
+    }
+    _error = std::string(message)+" at line "+strtool::to_string(line)+":\n  "+std::string(start,stop);
+    _token = Token::Error;
+    _key = std::string_view();
+    _string = std::string_view();
+    return _token;
+}
+
+/**
+ * Returns a newly allocated JsonValue node from the document arena
+ *
+ * @return a newly allocated JsonValue node from the document arena
+ */
+std::shared_ptr<JsonValue> JsonParser::allocNode() {
+    if (_arena == nullptr) {
+        _arena = std::make_shared<JsonArena>();
+    }
+    return std::allocate_shared<JsonValue>(ArenaAllocator<JsonValue>(_arena));
+}
+
+#pragma mark -
+#pragma mark Streaming
+/**
+ * Advances to the next token, and returns it.
+ *
+ * Once the root value is finished, this method returns Token::End. If
+ * the text is not valid JSON, it returns Token::Error, and will continue
+ * to do so.
+ *
+ * @return the next token
+ */
+JsonParser::Token JsonParser::next() {
+    if (_token == Token::Error || _begin == nullptr) {
+        return _token;
+    }
+    _key = std::string_view();
+    _string = std::string_view();
+    if (_done) {
+        _token = Token::End;
+        return _token;
+    }
+
+    skipSpace();
+    if (_scopes.empty()) {
+        return readToken();
+    }
+
+    char close = (_scopes.back() == '{' ? '}' : ']');
+    if (_pos < _end && *_pos == close) {
+        _pos++;
+        _scopes.pop_back();
+        _first = false;
+        _done = _scopes.empty();
+        _token = (close == '}' ? Token::EndObject : Token::EndArray);
+        return _token;
+    }
+
+    if (!_first) {
+        if (_pos >= _end || *_pos != ',') {
+            return fail("Expected ','");
+        }
+        _pos++;
+        skipSpace();
+    }
+    _first = false;
+
+    if (_scopes.back() == '{') {
+        if (_pos >= _end || *_pos != '"') {
+            return fail("Expected key");
+        } else if (!readString(_key,_keyspace)) {
+            return fail("Invalid key");
+        }
+        skipSpace();
+        if (_pos >= _end || *_pos != ':') {
+            return fail("Expected ':'");
+        }
+        _pos++;
+        skipSpace();
+    }
+    return readToken();
+}
+
+/**
+ * Returns the nesting depth of the current token.
+ *
+ * The root value has depth 0. The values inside of it have depth 1, and
+ * so on. The begin and end tokens of a container have the same depth.
+ *
+ * @return the nesting depth of the current token.
+ */
+size_t JsonParser::depth() const {
+    size_t result = _scopes.size();
+    if (_token == Token::BeginObject || _token == Token::BeginArray) {
+        result--;
+    }
+    return result;
+}
+
+/**
+ * Skips over the current value.
+ *
+ * If the current token begins an object or array, this advances to the
+ * matching end token. Otherwise it does nothing.
+ *
+ * @return false if there was a parse error
+ */
+bool JsonParser::skip() {
+    if (_token != Token::BeginObject && _token != Token::BeginArray) {
+        return _token != Token::Error;
+    }
+    size_t level = _scopes.size();
+    while (_scopes.size() >= level) {
+        if (next() == Token::Error) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns a newly allocated JsonValue for the current value.
+ *
+ * If the current token begins an object or array, the parser advances to
+ * the matching end token, and the result contains all of the descendants.
+ * The nodes are allocated from the document arena. The result has no
+ * parent, and its key is empty.
+ *
+ * If there is a parsing error, this method will return nullptr.
+ *
+ * @return a newly allocated JsonValue for the current value.
+ */
+std::shared_ptr<JsonValue> JsonParser::readValue() {
+    std::shared_ptr<JsonValue> result = allocNode();
+    return (readValue(result.get()) ? result : nullptr);
+}
+
+/**
+ * Stores the current value in the given node.
+ *
+ * This method is the same as {@link #readValue}, except that the root of
+ * the tree is the given node (which is not in the document arena). Any
+ * children of the node are replaced.
+ *
+ * @param node  The node to store the value
+ *
+ * @return false if there was a parse error
+ */
+bool JsonParser::readValue(JsonValue* node) {
+    node->_children.clear();
+    node->_index.clear();
+    switch (_token) {
+        case Token::String:
+            node->_type = JsonValue::Type::StringType;
+            node->_stringValue.assign(_string.data(),_string.size());
+            return true;
+        case Token::Number:
+            node->_type = JsonValue::Type::NumberType;
+            node->_doubleValue = _number;
+            if (_number >= (double)LONG_MAX) {
+                node->_longValue = LONG_MAX;
+            } else if (_number <= (double)LONG_MIN) {
+                node->_longValue = LONG_MIN;
+            } else {
+                node->_longValue = (long)_number;
+            }
+            return true;
+        case Token::Bool:
+            node->_type = JsonValue::Type::BoolType;
+            node->_longValue = _bool;
+            return true;
+        case Token::Null:
+            node->_type = JsonValue::Type::NullType;
+            return true;
+        case Token::BeginObject:
+        case Token::BeginArray:
+            break;
+        default:
+            return false;
+    }
+
+    Token close = Token::EndArray;
+    node->_type = JsonValue::Type::ArrayType;
+    if (_token == Token::BeginObject) {
+        close = Token::EndObject;
+        node->_type = JsonValue::Type::ObjectType;
+    }
+
+    for(Token token = next(); token != close; token = next()) {
+        if (token == Token::Error || token == Token::End) {
+            return false;
+        }
+        std::shared_ptr<JsonValue> child = allocNode();
+        child->_key.assign(_key.data(),_key.size());
+        if (!readValue(child.get())) {
+            return false;
+        }
+        child->_parent = node;
+        node->_children.push_back(child);
+    }
+    node->reindex();
+    return true;
+}
@@ -47,6 +47,7 @@
 //  Version: 11/28/16
 //
 #include <cugl/io/CUJsonReader.h>
+#include <cugl/io/CUJsonParser.h>
 #include <cugl/util/CUDebug.h>
 
 using namespace cugl;
@@ -98,21 +99,45 @@ std::string JsonReader::readJsonString() {
 }
 
 /**
- * Returns a newly allocated JsonValue for the next available JSON string.
+ * Returns a newly allocated JsonValue for the next available JSON value.
  *
- * This method uses {@link readJsonString()} to extract the next available
- * JSON string and constructs a JsonValue from that.
+ * This method parses the first JSON value in the remainder of the stream
+ * in a single pass with {@link JsonParser}. A buffered reader reads the
+ * rest of the stream into memory first. A mapped reader parses the mapping
+ * in place. Either way, any text after that value is left in the stream,
+ * so it can still be read.
  *
  * If there is a parsing error, this  method will return nullptr.  Detailed
  * information about the parsing error will be passed to an assert.  Hence
  * error messages are suppressed if asserts are turned off.
  *
- * @return a newly allocated JsonValue for the next available JSON string.
+ * @return a newly allocated JsonValue for the next available JSON value.
  */
 std::shared_ptr<JsonValue> JsonReader::readJson() {
-    std::string data = readJsonString();
-    if (!data.empty()) {
-        return JsonValue::allocWithJson(data);
+    std::string data;
+    std::string_view text;
+    if (_mapped) {
+        text = ready() ? window().substr(_bufoff) : std::string_view();
+    } else {
+        readAll(data);
+        text = data;
+    }
+    
+    JsonParser parser;
+    if (text.empty() || !parser.initWithBuffer(text.data(),text.size())) {
+        return nullptr;
+    }
+    
+    parser.next();
+    std::shared_ptr<JsonValue> result = parser.readValue();
+    CUAssertLog(result, "%s", parser.getError().empty() ? "Invalid JSON" : parser.getError().c_str());
+
+    // Return the unread text to the stream
+    if (result && _mapped) {
+        _bufoff += (Sint32)parser.getOffset();
+    } else if (result) {
+        _sbuffer.assign(data,parser.getOffset(),std::string::npos);
+        _bufoff = 0;
     }
-    return nullptr;
+    return result;
 }
@@ -0,0 +1,248 @@
+//
+//  CUMappedFile.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides read-only access to the contents of a file as a
+//  single block of memory. Where the platform supports it, the file is mapped
+//  into the address space of the application, so nothing is read until it is
+//  touched, and the pages are shared with the OS file cache. Otherwise (e.g.
+//  for assets inside an Android APK), the file is read into a buffer in one
+//  pass. Either way the programmer sees the same pointer and size.
+//
+//  This is intended for files in a fixed binary layout that can be used in
+//  place, without parsing.
+//
+//  By default, this module (and every module in the io package) accesses the
+//  application save directory.  If you want to access another directory, you
+//  will need to specify an absolute path for the file name.  Keep in mind that
+//  absolute paths are very dangerous on mobile devices, because they do not
+//  have proper file systems.  You should confine all files to either the asset
+//  or the save directory.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#include <cugl/io/CUMappedFile.h>
+#include <cugl/util/CUFiletools.h>
+#include <cugl/util/CUDebug.h>
+#include <cugl/base/CUApplication.h>
+
+#if defined (__WINDOWS__)
+    #include <windows.h>
+#elif !defined (__ANDROID__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+using namespace cugl;
+
+#pragma mark Constructors
+/**
+ * Creates a mapped file with no assigned file.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+MappedFile::MappedFile() :
+_data(nullptr),
+_size(0),
+_mapped(false) {
+#if defined (__WINDOWS__)
+    _file = nullptr;
+    _mapping = nullptr;
+#endif
+}
+
+/**
+ * Initializes the contents with the given file.
+ *
+ * If the file is a relative path, this method will look for the file in
+ * the application save directory {@see Application#getSaveDirectory()}.
+ * If you wish to read a file in any other directory, you must provide
+ * an absolute path.
+ *
+ * @param file  the path (absolute or relative) to the file
+ *
+ * @return true if the file is initialized properly, false otherwise.
+ */
+bool MappedFile::init(const std::string& file) {
+    if (_data != nullptr) {
+        CUAssertLog(false, "File %s is already initialized",_name.c_str());
+        return false;
+    }
+    _name = filetool::normalize_path(file);
+    return map(_name) || buffer(_name);
+}
+
+/**
+ * Initializes the contents with the given asset.
+ *
+ * This initializer assumes that the file name is a relative path. It will
+ * search the application asset directory {@see Application#getAssetDirectory()}
+ * for the file and return false if it cannot find it there.
+ *
+ * @param file  the relative path to the file
+ *
+ * @return true if the file is initialized properly, false otherwise.
+ */
+bool MappedFile::initWithAsset(const std::string& file) {
+    bool absolute = filetool::is_absolute(file);
+    CUAssertLog(!absolute, "This initializer does not accept absolute paths");
+    std::string path = Application::get()->getAssetDirectory();
+    path.append(file);
+    return init(path);
+}
+
+/**
+ * Releases the file contents.
+ *
+ * Any pointers into the contents are invalid after this call. This object
+ * may be safely reinitialized.
+ */
+void MappedFile::dispose() {
+#if defined (__WINDOWS__)
+    if (_mapped) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mapping != nullptr) {
+        CloseHandle((HANDLE)_mapping);
+        _mapping = nullptr;
+    }
+    if (_file != nullptr) {
+        CloseHandle((HANDLE)_file);
+        _file = nullptr;
+    }
+#elif !defined (__ANDROID__)
+    if (_mapped) {
+        munmap((void*)_data,_size);
+    }
+#endif
+    _buffer = nullptr;
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+    _name.clear();
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Returns true if the file was memory mapped successfully
+ *
+ * @param path  The normalized path to the file
+ *
+ * @return true if the file was memory mapped successfully
+ */
+bool MappedFile::map(const std::string& path) {
+#if defined (__WINDOWS__)
+    std::wstring wide(path.begin(),path.end());
+    HANDLE file = CreateFileW(wide.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    _file = file;
+    _mapping = mapping;
+    _data = (const Uint8*)view;
+    _size = (size_t)size.QuadPart;
+    _mapped = true;
+    return true;
+#elif defined (__ANDROID__)
+    // Assets are in the APK; SDL reads them for us
+    return false;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps its own reference
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    _data = (const Uint8*)view;
+    _size = (size_t)info.st_size;
+    _mapped = true;
+    return true;
+#endif
+}
+
+/**
+ * Returns true if the file was read into memory successfully
+ *
+ * @param path  The normalized path to the file
+ *
+ * @return true if the file was read into memory successfully
+ */
+bool MappedFile::buffer(const std::string& path) {
+    SDL_RWops* stream = SDL_RWFromFile(path.c_str(), "rb");
+    if (!stream) {
+        return false;
+    }
+    Sint64 size = SDL_RWsize(stream);
+    bool success = size > 0;
+    if (success) {
+        _buffer.reset(new Uint8[(size_t)size]);
+        success = SDL_RWread(stream, _buffer.get(), 1, (size_t)size) == (size_t)size;
+    }
+    SDL_RWclose(stream);
+    if (!success) {
+        _buffer = nullptr;
+        return false;
+    }
+    _data = _buffer.get();
+    _size = (size_t)size;
+    return true;
+}
@@ -13,6 +13,9 @@
 //  have proper file systems.  You should confine all files to either the asset
 //  or the save directory.
 //
+//  A reader may also map the file into memory, in which case lines can be
+//  read as views into the mapping without copying them.
+//
 //  This class uses our standard shared-pointer architecture.
 //
 //  1. The constructor does not perform any initialization; it just sets all
@@ -50,6 +53,7 @@
 #include <cugl/util/CUDebug.h>
 #include <cugl/util/CUFiletools.h>
 #include <cugl/base/CUApplication.h>
+#include <cugl/io/CUMappedFile.h>
 #include <utf8/utf8.h>
 #include <cctype>
 
@@ -164,6 +168,52 @@ bool TextReader::initWithAsset(const std::string file, unsigned int capacity) {
     return _ssize >= 0;
 }
 
+/**
+ * Initializes a mapped reader for the given file.
+ *
+ * A mapped reader has no read buffer. Instead, the entire file is mapped
+ * into memory {@see MappedFile}, and lines are read directly from the
+ * mapping.
+ *
+ * If the file is a relative path, this reader will look for the file in
+ * the application save directory {@see Application#getSaveDirectory()}.
+ * If you wish to read a file in any other directory, you must provide
+ * an absolute path.
+ *
+ * @param file  the path (absolute or relative) to the file
+ *
+ * @return true if the reader is initialized properly, false otherwise.
+ */
+bool TextReader::initMapped(const std::string file) {
+    _name = filetool::normalize_path(file);
+    return map();
+}
+
+/**
+ * Initializes a mapped reader for the given file.
+ *
+ * A mapped reader has no read buffer. Instead, the entire file is mapped
+ * into memory {@see MappedFile}, and lines are read directly from the
+ * mapping.
+ *
+ * This initializer assumes that the file name is a relative path. It will
+ * search the application assert directory {@see Application#getAssetDirectory()}
+ * for the file and return false if it cannot find it there.
+ *
+ * @param file  the relative path to the file
+ *
+ * @return true if the reader is initialized properly, false otherwise.
+ */
+bool TextReader::initMappedWithAsset(const std::string file) {
+    bool absolute = filetool::is_absolute(file);
+    CUAssertLog(!absolute, "This initializer does not accept absolute paths");
+    
+    _name = Application::get()->getAssetDirectory();
+    _name.append(file);
+    _name = filetool::normalize_path(_name);
+    return map();
+}
+
 
 #pragma mark -
 #pragma mark Stream Management
@@ -174,9 +224,12 @@ bool TextReader::initWithAsset(const std::string file, unsigned int capacity) {
  * if the stream has been closed.
  */
 void TextReader::reset() {
-    if (_stream) {
-        close();
+    close();
+    if (_mapped) {
+        map();
+        return;
     }
+    
     _stream = SDL_RWFromFile(_name.c_str(), "r");
     _ssize  = SDL_RWsize(_stream);
     _cbuffer = new char[_capacity];
@@ -201,6 +254,10 @@ void TextReader::close() {
         delete[] _cbuffer;
         _cbuffer = nullptr;
     }
+    if (_mapping) {
+        _mapping = nullptr;
+        _bufoff  = 0;
+    }
 }
 
 /**
@@ -217,11 +274,49 @@ void TextReader::fill() {
 	}
 
     _bufoff = 0;
+    if (_sbuffer.size() >= _capacity) {
+        return;     // The buffer grew to hold a long line
+    }
     size_t amt = SDL_RWread(_stream, _cbuffer, 1, _capacity-_sbuffer.size());
     _sbuffer.append(_cbuffer,amt);
     _scursor += amt;
 }
 
+/**
+ * Maps the file {@link #_name} into memory, returning true on success.
+ *
+ * @return true if the file was mapped
+ */
+bool TextReader::map() {
+    _mapped  = true;
+    _mapping = MappedFile::alloc(_name);
+    if (_mapping == nullptr) {
+        return false;
+    }
+    CUAssertLog(_mapping->size() <= (size_t)SDL_MAX_SINT32, "File %s is too large to read", _name.c_str());
+    
+    _sbuffer.clear();
+    _bufoff  = 0;
+    _ssize   = (Sint64)_mapping->size();
+    _scursor = _ssize;
+    return true;
+}
+
+/**
+ * Returns the unread data available without another read from the file.
+ *
+ * For a mapped reader, this is the entire file. The offset {@link #_bufoff}
+ * is an index into this window. The window is invalidated by {@link #fill}.
+ *
+ * @return the unread data available without another read from the file.
+ */
+std::string_view TextReader::window() const {
+    if (_mapping) {
+        return std::string_view((const char*)_mapping->data(),_mapping->size());
+    }
+    return std::string_view(_sbuffer);
+}
+
 #pragma mark -
 #pragma mark Read Methods
 /**
@@ -254,11 +349,11 @@ char TextReader::read() {
  */
 std::string& TextReader::read(std::string& data) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    if (_bufoff >= _sbuffer.size()) {
+    if ((size_t)_bufoff >= window().size()) {
         fill();
     }
 
-    data.push_back(_sbuffer[_bufoff++]);
+    data.push_back(window()[_bufoff++]);
     return data;
 }
 
@@ -291,17 +386,17 @@ std::string TextReader::readUTF8() {
  */
 std::string& TextReader::readUTF8(std::string& data) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    if (_bufoff+3 >= _sbuffer.size()) { // Need a full UTF8 sequence
+    if ((size_t)(_bufoff+3) >= window().size()) { // Need a full UTF8 sequence
         fill();
     }
     
-    size_t orig = data.size();
+    std::string_view buffer = window();
+    const char* start = buffer.data()+_bufoff;
+    const char* end = start;
+    utf8::next(end,buffer.data()+buffer.size());
     
-    std::string::iterator start = _sbuffer.begin()+_bufoff;
-    utf8::next(start,_sbuffer.end());
-    
-    data.append(_sbuffer.begin()+_bufoff,start);
-    _bufoff += (Sint32)(data.size()-orig);
+    data.append(start,end);
+    _bufoff += (Sint32)(end-start);
     
     return data;
 }
@@ -339,25 +434,49 @@ std::string TextReader::readLine() {
  * @return the argument with a single line appended from the stream.
  */
 std::string& TextReader::readLine(std::string& data) {
+    data.append(readLineView());
+    return data;
+}
+
+/**
+ * Returns a single line for text from the stream, without copying it.
+ *
+ * This method is identical to {@link #readLine}, except that the line is
+ * a view into the reader. For a mapped reader, the view is valid until the
+ * reader is closed or reset. For a buffered reader, the view is only valid
+ * until the next read, and the buffer grows past its capacity if a line
+ * does not fit.
+ *
+ * @return a single line for text from the stream
+ */
+std::string_view TextReader::readLineView() {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    if (_bufoff >= _sbuffer.size()) {
+    if ((size_t)_bufoff >= window().size()) {
         fill();
     }
     
-    bool found = false;
-    while (!found) {
-        size_t pos = _sbuffer.find('\n',_bufoff);
-        if (pos != std::string::npos) {
-            data.append(_sbuffer.begin()+_bufoff,_sbuffer.begin()+pos);
-            _bufoff = (Sint32)(pos+1);
-            found = true;
-        } else {
-            data.append(_sbuffer.begin()+_bufoff,_sbuffer.end());
-            _bufoff = (Sint32)_sbuffer.size();
-            fill();
+    size_t pos = window().find('\n',_bufoff);
+    if (pos == std::string::npos && _stream && _scursor < _ssize) {
+        // Grow the buffer until it holds the entire line
+        _sbuffer.erase(0,_bufoff);
+        _bufoff = 0;
+        while (pos == std::string::npos && _scursor < _ssize) {
+            size_t searched = _sbuffer.size();
+            size_t amt = SDL_RWread(_stream, _cbuffer, 1, _capacity);
+            if (!amt) {
+                break;
+            }
+            _sbuffer.append(_cbuffer,amt);
+            _scursor += amt;
+            pos = _sbuffer.find('\n',searched);
         }
     }
-    return data;
+    
+    std::string_view buffer = window();
+    size_t end = (pos == std::string::npos ? buffer.size() : pos);
+    std::string_view result = buffer.substr(_bufoff,end-_bufoff);
+    _bufoff = (Sint32)(pos == std::string::npos ? end : pos+1);
+    return result;
 }
 
 /**
@@ -388,13 +507,13 @@ std::string TextReader::readAll() {
  */
 std::string& TextReader::readAll(std::string& data) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    if (_bufoff >= _sbuffer.size()) {
+    if ((size_t)_bufoff >= window().size()) {
         fill();
     }
     
     while (ready()) {
-        data.append(_sbuffer.begin()+_bufoff,_sbuffer.end());
-        _bufoff = (Sint32)_sbuffer.size();
+        data.append(window().substr(_bufoff));
+        _bufoff = (Sint32)window().size();
         fill();
     }
     return data;
@@ -408,14 +527,14 @@ std::string& TextReader::readAll(std::string& data) {
  */
 void TextReader::skip() {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    if (_bufoff >= _sbuffer.size()) {
+    if ((size_t)_bufoff >= window().size()) {
         fill();
     }
     
     bool found = false;
-    while (isspace(_sbuffer[_bufoff]) && !found) {
+    while (isspace(window()[_bufoff]) && !found) {
         _bufoff++;
-        if (_bufoff >= _sbuffer.size()) {
+        if ((size_t)_bufoff >= window().size()) {
             if (ready()) {
                 fill();
             } else {
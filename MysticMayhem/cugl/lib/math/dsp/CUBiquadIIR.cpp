@@ -198,7 +198,7 @@ void BiquadIIR::reset() {
     _c1[3] = -_a1*_c1[2]-_a2*_c1[1];
     _c1[7] = -_a1*_c1[6]-_a2*_c1[5];
     
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     _mm_store_ps(_d1,       _mm_setr_ps(   1,   _c1[4], _c1[5],      _c1[6]));
     _mm_store_ps(_d1+4,     _mm_setr_ps(   0,    1,     _c1[4],      _c1[5]));
     _mm_store_ps(_d1+8,     _mm_setr_ps(   0,    0,      1,          _c1[4]));
@@ -214,13 +214,8 @@ void BiquadIIR::reset() {
     _mm_store_ps(_d2+4,     _mm_setr_ps(   0,    1,      0,          _c2[13] ));
     _mm_store_ps(_d2+8,     _mm_setr_ps(   0,    0,      1,           0 ));
     _mm_store_ps(_d2+12,    _mm_setr_ps(   0,    0,      0,           1 ));
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if ( android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     {
-#endif
         float32x4_t temp;
         temp = {   1,   _c1[4], _c1[5],      _c1[6] };
         vst1q_f32(_d1   , temp);
@@ -645,31 +640,34 @@ void BiquadIIR::step(float gain, float* input, float* output) {
  * @param size      The input size in frames
  */
 void BiquadIIR::calculate(float gain, float* input, float* output, size_t size) {
-    size_t valid = VECTORIZE ? size-(size % 4) : size;
-    switch (_channels) {
-        case 1:
-            single(gain,input,output,valid);
-            break;
-        case 2:
-            dual(gain,input,output,valid);
-            break;
-        case 3:
-            trio(gain,input,output,valid);
-            break;
-        case 4:
-            quad(gain,input,output,valid);
-            break;
-        case 8:
-            quart(gain,input,output,valid);
-            break;
-        default:
-            for(int ii = 0; ii < _channels; ii++) {
-                stride(gain,input+ii,output+ii,valid,ii);
-            }
-            break;
+    // The block algorithms require at least four frames
+    size_t valid = size < 4 ? 0 : (VECTORIZE ? size-(size % 4) : size);
+    if (valid > 0) {
+        switch (_channels) {
+            case 1:
+                single(gain,input,output,valid);
+                break;
+            case 2:
+                dual(gain,input,output,valid);
+                break;
+            case 3:
+                trio(gain,input,output,valid);
+                break;
+            case 4:
+                quad(gain,input,output,valid);
+                break;
+            case 8:
+                quart(gain,input,output,valid);
+                break;
+            default:
+                for(int ii = 0; ii < _channels; ii++) {
+                    stride(gain,input+ii,output+ii,valid,ii);
+                }
+                break;
+        }
     }
     if (valid < size) {
-        for(size_t ii = size-valid; ii < size; ii++) {
+        for(size_t ii = valid; ii < size; ii++) {
             for(size_t ckk = 0; ckk < _channels; ckk++) {
                 output[ii*_channels+ckk] = _outs[ckk];
                 float temp = gain * _b0 * input[ii*_channels+ckk] + _b1 * _inns[ckk+_channels] +  _b2 * _inns[ckk];
@@ -749,7 +747,7 @@ size_t BiquadIIR::flush(float* output) {
  * @param channel   The specific channel to process
  */
 void BiquadIIR::stride(float gain, float* input, float* output, size_t size, unsigned channel) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 pout, pinn;
         __m128 tmp1, tmp2, tmp3;
@@ -762,11 +760,11 @@ void BiquadIIR::stride(float gain, float* input, float* output, size_t size, uns
     
         pout = _mm_set_ps(_outs[channel+stride],_outs[channel],0,0);
         pinn = _mm_set_ps(_inns[channel+stride],_inns[channel],0,0);
-        for(int ii = 0; ii < size; ii += 4) {
+        for(size_t ii = 0; ii < size; ii += 4) {
             // C[r] * y
             tmp2 = _mm_set1_ps(pout[2]);
             tmp3 = _mm_set1_ps(pout[3]);
-            tmp1 = _mm_fmadd_ps(tmp2,_mm_load_ps(_c1),_mm_mul_ps(tmp3,_mm_load_ps(_c1+4)));
+            tmp1 = _mm_muladd_ps(tmp2,_mm_load_ps(_c1),_mm_mul_ps(tmp3,_mm_load_ps(_c1+4)));
         
             // Pack to alignment
             data = _mm_mul_ps(_mm_set1_ps(gain),_mm_skipload_ps(input+ii*stride,stride));
@@ -780,9 +778,9 @@ void BiquadIIR::stride(float gain, float* input, float* output, size_t size, uns
 
             // D[r] * x
             tmp3 = _mm_mul_ps(_mm_set1_ps(tmp2[0]),_mm_load_ps(_d1));
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d1+4),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d1+8),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d1+12),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d1+4),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d1+8),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d1+12),tmp3);
         
             // Unpack to store
             tmp2 = _mm_add_ps(tmp1,tmp3);
@@ -796,13 +794,8 @@ void BiquadIIR::stride(float gain, float* input, float* output, size_t size, uns
         _inns[channel] = pinn[2];
         _inns[stride+channel] = pinn[3];
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         unsigned stride = _channels;
         float32x2_t pout, pinn;
         float32x4_t tmp1, tmp2, tmp3;
@@ -895,7 +888,7 @@ void BiquadIIR::stride(float gain, float* input, float* output, size_t size, uns
  * @param size      The input size in frames
  */
 void BiquadIIR::single(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 pout, pinn;
         __m128 tmp1, tmp2, tmp3;
@@ -907,14 +900,14 @@ void BiquadIIR::single(float gain, float* input, float* output, size_t size) {
     
         pout = _mm_set_ps(_outs[1],_outs[0],0,0);
         pinn = _mm_set_ps(_inns[1],_inns[0],0,0);
-        for(int ii = 0; ii < size; ii += 4) {
+        for(size_t ii = 0; ii < size; ii += 4) {
             // C[r] * y
             tmp2 = _mm_set1_ps(pout[2]);
             tmp3 = _mm_set1_ps(pout[3]);
-            tmp1 = _mm_fmadd_ps(tmp2,_mm_load_ps(_c1),_mm_mul_ps(tmp3,_mm_load_ps(_c1+4)));
+            tmp1 = _mm_muladd_ps(tmp2,_mm_load_ps(_c1),_mm_mul_ps(tmp3,_mm_load_ps(_c1+4)));
         
             // FIR
-            data = _mm_mul_ps(_mm_set1_ps(gain),_mm_load_ps(input+ii));
+            data = _mm_mul_ps(_mm_set1_ps(gain),_mm_loadu_ps(input+ii));
             shuf = _mm_shuffle_ps(pinn,data,_MM_SHUFFLE(1,0,3,2));
             tmp2 = _mm_add_ps(_mm_mul_ps(factor0,data),_mm_mul_ps(factor2,shuf));
             shuf = _mm_shuffle_ps(shuf,data,_MM_SHUFFLE(2,1,2,1));
@@ -923,14 +916,14 @@ void BiquadIIR::single(float gain, float* input, float* output, size_t size) {
         
             // D[r] * x
             tmp3 = _mm_mul_ps(_mm_set1_ps(tmp2[0]),_mm_load_ps(_d1));
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d1+4),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d1+8),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d1+12),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d1+4),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d1+8),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d1+12),tmp3);
         
             // Shift to output and repeat
             tmp2 = _mm_add_ps(tmp1,tmp3);
             tmp3 = _mm_shuffle_ps(pout, tmp2, _MM_SHUFFLE(1,0,3,2));
-            _mm_store_ps(output+ii, tmp3);
+            _mm_storeu_ps(output+ii, tmp3);
             pout = tmp2;
         }
     
@@ -939,13 +932,8 @@ void BiquadIIR::single(float gain, float* input, float* output, size_t size) {
         _inns[0] = pinn[2];
         _inns[1] = pinn[3];
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x2_t pout, pinn;
         float32x4_t tmp1, tmp2, tmp3;
         float32x4_t data, shuf;
@@ -1039,7 +1027,7 @@ void BiquadIIR::single(float gain, float* input, float* output, size_t size) {
  * @param size      The input size in frames
  */
 void BiquadIIR::dual(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 pout, pinn;
         __m128 tmp1, tmp2, tmp3;
@@ -1052,12 +1040,12 @@ void BiquadIIR::dual(float gain, float* input, float* output, size_t size) {
         __m128 factor1 = _mm_set1_ps(_b1);
         __m128 factor2 = _mm_set1_ps(_b2);
 
-        for(int ii = 0; ii < 2*size; ii += 4) {
+        for(size_t ii = 0; ii < 2*size; ii += 4) {
             // C[r] * y
             tmp1 = _mm_mul_ps(_mm_set1_ps(pout[0]),_mm_load_ps(_c2));
-            tmp1 = _mm_fmadd_ps(_mm_set1_ps(pout[1]),_mm_load_ps(_c2+4), tmp1);
-            tmp1 = _mm_fmadd_ps(_mm_set1_ps(pout[2]),_mm_load_ps(_c2+8), tmp1);
-            tmp1 = _mm_fmadd_ps(_mm_set1_ps(pout[3]),_mm_load_ps(_c2+12),tmp1);
+            tmp1 = _mm_muladd_ps(_mm_set1_ps(pout[1]),_mm_load_ps(_c2+4), tmp1);
+            tmp1 = _mm_muladd_ps(_mm_set1_ps(pout[2]),_mm_load_ps(_c2+8), tmp1);
+            tmp1 = _mm_muladd_ps(_mm_set1_ps(pout[3]),_mm_load_ps(_c2+12),tmp1);
         
             // FIR
             data = _mm_mul_ps(_mm_set1_ps(gain),_mm_loadu_ps(input+ii));
@@ -1068,26 +1056,21 @@ void BiquadIIR::dual(float gain, float* input, float* output, size_t size) {
         
             // D[r] * x
             tmp3 = _mm_mul_ps(_mm_set1_ps(tmp2[0]),_mm_load_ps(_d2));
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d2+4),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d2+8),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d2+12),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d2+4),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d2+8),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d2+12),tmp3);
         
             // Shift to output and repeat
             tmp2 = _mm_add_ps(tmp1,tmp3);
-            _mm_store_ps(output+ii, pout);
+            _mm_storeu_ps(output+ii, pout);
             pout = tmp2;
         }
     
         _mm_store_ps(_outs+0,pout);
         _mm_store_ps(_inns+0,pinn);
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4_t pout, pinn;
         float32x4_t tmp1, tmp2, tmp3;
         float32x4_t data, shuf;
@@ -1196,13 +1179,8 @@ void BiquadIIR::dual(float gain, float* input, float* output, size_t size) {
  * @param size      The input size in frames
  */
 void BiquadIIR::trio(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#if defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4x3_t data, outr;
         float32x4_t tmp1, tmp2, tmp3, shuf;
     
@@ -1335,7 +1313,7 @@ void BiquadIIR::trio(float gain, float* input, float* output, size_t size) {
  * @param size      The input size in frames
  */
 void BiquadIIR::quad(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 pout1,pout2;
         __m128 pinn1,pinn2;
@@ -1351,14 +1329,14 @@ void BiquadIIR::quad(float gain, float* input, float* output, size_t size) {
         __m128 factor1 = _mm_set1_ps(_b1);
         __m128 factor2 = _mm_set1_ps(_b2);
 
-        for(int ii = 0; ii < 4*size; ii += 4) {
+        for(size_t ii = 0; ii < 4*size; ii += 4) {
             data = _mm_mul_ps(_mm_set1_ps(gain),_mm_loadu_ps(input+ii));
             temp = _mm_add_ps(_mm_mul_ps(factor0,data),_mm_mul_ps(factor1,pinn1));
             temp = _mm_add_ps(temp,_mm_mul_ps(factor2,pinn2));
 
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a1),pout1,temp);
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a2),pout2,temp);
-            _mm_store_ps(output+ii, pout2);
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a1),pout1,temp);
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a2),pout2,temp);
+            _mm_storeu_ps(output+ii, pout2);
         
             pout2 = pout1;
             pout1 = temp;
@@ -1370,13 +1348,8 @@ void BiquadIIR::quad(float gain, float* input, float* output, size_t size) {
         _mm_store_ps(_inns+0,pinn2);
         _mm_store_ps(_inns+4,pinn1);
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4_t pout1,pout2;
         float32x4_t pinn1,pinn2;
         float32x4_t data, temp;
@@ -1469,7 +1442,7 @@ void BiquadIIR::quad(float gain, float* input, float* output, size_t size) {
  * @param size      The input size in frames
  */
 void BiquadIIR::quart(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 pout1a,pout2a,pout1b,pout2b;
         __m128 pinn1a,pinn2a,pinn1b,pinn2b;
@@ -1487,12 +1460,12 @@ void BiquadIIR::quart(float gain, float* input, float* output, size_t size) {
         __m128 factor0 = _mm_set1_ps(_b0);
         __m128 factor1 = _mm_set1_ps(_b1);
         __m128 factor2 = _mm_set1_ps(_b2);
-        for(int ii = 0; ii < 8*size; ii += 8) {
+        for(size_t ii = 0; ii < 8*size; ii += 8) {
             data = _mm_mul_ps(_mm_set1_ps(gain),_mm_loadu_ps(input+ii));
             temp = _mm_add_ps(_mm_mul_ps(factor0,data),_mm_mul_ps(factor1,pinn1a));
             temp = _mm_add_ps(temp,_mm_mul_ps(factor2,pinn2a));
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a1),pout1a,temp);
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a2),pout2a,temp);
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a1),pout1a,temp);
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a2),pout2a,temp);
             _mm_storeu_ps(output+ii, pout2a);
             pout2a = pout1a;
             pout1a = temp;
@@ -1502,8 +1475,8 @@ void BiquadIIR::quart(float gain, float* input, float* output, size_t size) {
             data = _mm_mul_ps(_mm_set1_ps(gain),_mm_loadu_ps(input+ii+4));
             temp = _mm_add_ps(_mm_mul_ps(factor0,data),_mm_mul_ps(factor1,pinn1b));
             temp = _mm_add_ps(temp,_mm_mul_ps(factor2,pinn2b));
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a1),pout1b,temp);
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a2),pout2b,temp);
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a1),pout1b,temp);
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a2),pout2b,temp);
             _mm_storeu_ps(output+ii+4, pout2b);
             pout2b = pout1b;
             pout1b = temp;
@@ -1520,13 +1493,8 @@ void BiquadIIR::quart(float gain, float* input, float* output, size_t size) {
         _mm_store_ps(_inns+8,pinn1a);
         _mm_store_ps(_inns+12,pinn1b);
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4_t pout1a,pout2a,pout1b,pout2b;
         float32x4_t pinn1a,pinn2a,pinn1b,pinn2b;
         float32x4_t data, temp;
@@ -3,11 +3,11 @@
 //  Cornell University Game Library (CUGL)
 //
 //  This class is represents a class of static methods for performing basic
-//  DSP calculations, like addition and multiplication.  As with the DSP
-//  filters, this class supports vector optimizations for SSE and Neon 64.
-//  Our implementation is limited to 128-bit words.  While 256-bit (e.g. AVX)
-//  are more performant, they are not better for DSP filters and so we keep
-//  the optimizations at the same level.
+//  DSP calculations, like addition and multiplication.  These methods are on
+//  the critical path of the audio thread, so they are vectorized with SSE2,
+//  AVX2, or Neon 64.  The vector backend is chosen at runtime from the
+//  features of the current CPU.  Unlike the DSP filters, these methods are
+//  simple enough to benefit from 256-bit (AVX) words.
 //
 //  CUGL MIT License:
 //      This software is provided 'as-is', without any express or implied
@@ -32,7 +32,16 @@
 //  Version: 10/11/18
 //
 #include <cugl/math/dsp/CUDSPMath.h>
+#include <cugl/math/dsp/CUBiquadIIR.h>
+#include <cugl/math/dsp/CUOnePoleIIR.h>
+#include <cugl/math/dsp/CUTwoPoleIIR.h>
 #include <cugl/util/CUDebug.h>
+#include <cugl/util/CUTimestamp.h>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <vector>
 #include "cuDSP128.inl"
 
 using namespace cugl;
@@ -41,6 +50,466 @@ using namespace cugl::dsp;
 /** Whether to use a vectorization algorithm */
 bool DSPMath::VECTORIZE = true;
 
+/** The active vector backend */
+DSPMath::Backend DSPMath::_backend = DSPMath::getNativeBackend();
+
+#pragma mark -
+#pragma mark SSE2 Kernels
+// Each vector kernel processes the largest prefix that fits in whole vector
+// words, and returns the size of that prefix. The caller finishes the rest
+// with the scalar algorithm.
+#if defined (CU_DSP_VECTOR_SSE2)
+/** Returns the prefix of output = input1+input2 computed with SSE2 */
+static size_t sse2_add(float* input1, float* input2, float* output, size_t size) {
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        _mm_storeu_ps(output+ii, _mm_add_ps(_mm_loadu_ps(input1+ii),_mm_loadu_ps(input2+ii)));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = input1*input2 computed with SSE2 */
+static size_t sse2_multiply(float* input1, float* input2, float* output, size_t size) {
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        _mm_storeu_ps(output+ii, _mm_mul_ps(_mm_loadu_ps(input1+ii),_mm_loadu_ps(input2+ii)));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = scalar*input computed with SSE2 */
+static size_t sse2_scale(float* input, float scalar, float* output, size_t size) {
+    const __m128 gain = _mm_set1_ps(scalar);
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        _mm_storeu_ps(output+ii, _mm_mul_ps(_mm_loadu_ps(input+ii),gain));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = scalar*input1+input2 computed with SSE2 */
+static size_t sse2_scale_add(float* input1, float* input2, float scalar, float* output, size_t size) {
+    const __m128 gain = _mm_set1_ps(scalar);
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        _mm_storeu_ps(output+ii, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input1+ii),gain),
+                                            _mm_loadu_ps(input2+ii)));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = gain*(inputs[0]+...+inputs[count-1]) computed with SSE2 */
+static size_t sse2_mix(float** inputs, size_t count, float gain, float* output, size_t size) {
+    const __m128 scalar = _mm_set1_ps(gain);
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        __m128 sum = _mm_setzero_ps();
+        for(size_t kk = 0; kk < count; kk++) {
+            sum = _mm_add_ps(sum,_mm_loadu_ps(inputs[kk]+ii));
+        }
+        _mm_storeu_ps(output+ii, _mm_mul_ps(sum,scalar));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = input/32768 computed with SSE2 */
+static size_t sse2_convert(const Sint16* input, float* output, size_t size) {
+    const __m128 scalar = _mm_set1_ps(1.0f/32768.0f);
+    size_t ii = 0;
+    for(; ii+8 <= size; ii += 8) {
+        __m128i words = _mm_loadu_si128((const __m128i*)(input+ii));
+        // Sign extend by placing each word in the top half and shifting down
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(words,words),16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(words,words),16);
+        _mm_storeu_ps(output+ii,   _mm_mul_ps(_mm_cvtepi32_ps(lo),scalar));
+        _mm_storeu_ps(output+ii+4, _mm_mul_ps(_mm_cvtepi32_ps(hi),scalar));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = (start+step*i)*input computed with SSE2 */
+static size_t sse2_slide(float* input, float start, float step, float* output, size_t size) {
+    const __m128 skip = _mm_setr_ps(0,step,2*step,3*step);
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        __m128 gain = _mm_add_ps(_mm_set1_ps(start+ii*step),skip);
+        _mm_storeu_ps(output+ii, _mm_mul_ps(_mm_loadu_ps(input+ii),gain));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = (start+step*i)*input1+input2 computed with SSE2 */
+static size_t sse2_slide_add(float* input1, float* input2, float start, float step, float* output, size_t size) {
+    const __m128 skip = _mm_setr_ps(0,step,2*step,3*step);
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        __m128 gain = _mm_add_ps(_mm_set1_ps(start+ii*step),skip);
+        _mm_storeu_ps(output+ii, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input1+ii),gain),
+                                            _mm_loadu_ps(input2+ii)));
+    }
+    return ii;
+}
+
+/** Returns the prefix of data clamped to [min,max] computed with SSE2 */
+static size_t sse2_clamp(float* data, float min, float max, size_t size) {
+    const __m128 vmin = _mm_set1_ps(min);
+    const __m128 vmax = _mm_set1_ps(max);
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        _mm_storeu_ps(data+ii, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data+ii),vmin),vmax));
+    }
+    return ii;
+}
+
+/** Returns the prefix of data soft clamped to [-bound,bound] computed with SSE2 */
+static size_t sse2_ease(float* data, float bound, float knee, float factor, size_t size) {
+    const __m128 gain = _mm_set1_ps(bound);
+    const __m128 uppr = _mm_set1_ps(knee);
+    const __m128 lowr = _mm_set1_ps(-knee);
+    const __m128 fact = _mm_set1_ps(factor);
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        __m128 value = _mm_loadu_ps(data+ii);
+        __m128 above = _mm_cmpgt_ps(value,uppr);
+        __m128 below = _mm_cmplt_ps(value,lowr);
+        __m128 outer = _mm_or_ps(above,below);
+        if (_mm_movemask_ps(outer)) {
+            // bound-factor/x above the knee, -bound-factor/x below it
+            __m128 ratio = _mm_div_ps(fact,value);
+            __m128 left  = _mm_and_ps(above,_mm_sub_ps(gain,ratio));
+            __m128 rght  = _mm_and_ps(below,_mm_sub_ps(_mm_setzero_ps(),_mm_add_ps(gain,ratio)));
+            _mm_storeu_ps(data+ii,_mm_or_ps(_mm_andnot_ps(outer,value),_mm_or_ps(left,rght)));
+        }
+    }
+    return ii;
+}
+#endif
+
+#pragma mark -
+#pragma mark AVX2 Kernels
+#if defined (CU_DSP_VECTOR_AVX2)
+/** Returns the prefix of output = input1+input2 computed with AVX2 */
+CU_DSP_AVX2_TARGET
+static size_t avx2_add(float* input1, float* input2, float* output, size_t size) {
+    size_t ii = 0;
+    for(; ii+8 <= size; ii += 8) {
+        _mm256_storeu_ps(output+ii, _mm256_add_ps(_mm256_loadu_ps(input1+ii),_mm256_loadu_ps(input2+ii)));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = input1*input2 computed with AVX2 */
+CU_DSP_AVX2_TARGET
+static size_t avx2_multiply(float* input1, float* input2, float* output, size_t size) {
+    size_t ii = 0;
+    for(; ii+8 <= size; ii += 8) {
+        _mm256_storeu_ps(output+ii, _mm256_mul_ps(_mm256_loadu_ps(input1+ii),_mm256_loadu_ps(input2+ii)));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = scalar*input computed with AVX2 */
+CU_DSP_AVX2_TARGET
+static size_t avx2_scale(float* input, float scalar, float* output, size_t size) {
+    const __m256 gain = _mm256_set1_ps(scalar);
+    size_t ii = 0;
+    for(; ii+8 <= size; ii += 8) {
+        _mm256_storeu_ps(output+ii, _mm256_mul_ps(_mm256_loadu_ps(input+ii),gain));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = scalar*input1+input2 computed with AVX2 */
+CU_DSP_AVX2_TARGET
+static size_t avx2_scale_add(float* input1, float* input2, float scalar, float* output, size_t size) {
+    const __m256 gain = _mm256_set1_ps(scalar);
+    size_t ii = 0;
+    for(; ii+8 <= size; ii += 8) {
+        _mm256_storeu_ps(output+ii, _mm256_fmadd_ps(_mm256_loadu_ps(input1+ii),gain,
+                                                    _mm256_loadu_ps(input2+ii)));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = gain*(inputs[0]+...+inputs[count-1]) computed with AVX2 */
+CU_DSP_AVX2_TARGET
+static size_t avx2_mix(float** inputs, size_t count, float gain, float* output, size_t size) {
+    const __m256 scalar = _mm256_set1_ps(gain);
+    size_t ii = 0;
+    for(; ii+8 <= size; ii += 8) {
+        __m256 sum = _mm256_setzero_ps();
+        for(size_t kk = 0; kk < count; kk++) {
+            sum = _mm256_add_ps(sum,_mm256_loadu_ps(inputs[kk]+ii));
+        }
+        _mm256_storeu_ps(output+ii, _mm256_mul_ps(sum,scalar));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = input/32768 computed with AVX2 */
+CU_DSP_AVX2_TARGET
+static size_t avx2_convert(const Sint16* input, float* output, size_t size) {
+    const __m256 scalar = _mm256_set1_ps(1.0f/32768.0f);
+    size_t ii = 0;
+    for(; ii+8 <= size; ii += 8) {
+        __m256i words = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(input+ii)));
+        _mm256_storeu_ps(output+ii, _mm256_mul_ps(_mm256_cvtepi32_ps(words),scalar));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = (start+step*i)*input computed with AVX2 */
+CU_DSP_AVX2_TARGET
+static size_t avx2_slide(float* input, float start, float step, float* output, size_t size) {
+    const __m256 skip = _mm256_setr_ps(0,step,2*step,3*step,4*step,5*step,6*step,7*step);
+    size_t ii = 0;
+    for(; ii+8 <= size; ii += 8) {
+        __m256 gain = _mm256_add_ps(_mm256_set1_ps(start+ii*step),skip);
+        _mm256_storeu_ps(output+ii, _mm256_mul_ps(_mm256_loadu_ps(input+ii),gain));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = (start+step*i)*input1+input2 computed with AVX2 */
+CU_DSP_AVX2_TARGET
+static size_t avx2_slide_add(float* input1, float* input2, float start, float step, float* output, size_t size) {
+    const __m256 skip = _mm256_setr_ps(0,step,2*step,3*step,4*step,5*step,6*step,7*step);
+    size_t ii = 0;
+    for(; ii+8 <= size; ii += 8) {
+        __m256 gain = _mm256_add_ps(_mm256_set1_ps(start+ii*step),skip);
+        _mm256_storeu_ps(output+ii, _mm256_fmadd_ps(_mm256_loadu_ps(input1+ii),gain,
+                                                    _mm256_loadu_ps(input2+ii)));
+    }
+    return ii;
+}
+
+/** Returns the prefix of data clamped to [min,max] computed with AVX2 */
+CU_DSP_AVX2_TARGET
+static size_t avx2_clamp(float* data, float min, float max, size_t size) {
+    const __m256 vmin = _mm256_set1_ps(min);
+    const __m256 vmax = _mm256_set1_ps(max);
+    size_t ii = 0;
+    for(; ii+8 <= size; ii += 8) {
+        _mm256_storeu_ps(data+ii, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data+ii),vmin),vmax));
+    }
+    return ii;
+}
+
+/** Returns the prefix of data soft clamped to [-bound,bound] computed with AVX2 */
+CU_DSP_AVX2_TARGET
+static size_t avx2_ease(float* data, float bound, float knee, float factor, size_t size) {
+    const __m256 gain = _mm256_set1_ps(bound);
+    const __m256 uppr = _mm256_set1_ps(knee);
+    const __m256 lowr = _mm256_set1_ps(-knee);
+    const __m256 fact = _mm256_set1_ps(factor);
+    size_t ii = 0;
+    for(; ii+8 <= size; ii += 8) {
+        __m256 value = _mm256_loadu_ps(data+ii);
+        __m256 above = _mm256_cmp_ps(value,uppr,_CMP_GT_OQ);
+        __m256 below = _mm256_cmp_ps(value,lowr,_CMP_LT_OQ);
+        __m256 outer = _mm256_or_ps(above,below);
+        if (_mm256_movemask_ps(outer)) {
+            // bound-factor/x above the knee, -bound-factor/x below it
+            __m256 ratio = _mm256_div_ps(fact,value);
+            __m256 clamp = _mm256_blendv_ps(_mm256_sub_ps(_mm256_setzero_ps(),_mm256_add_ps(gain,ratio)),
+                                            _mm256_sub_ps(gain,ratio),above);
+            _mm256_storeu_ps(data+ii,_mm256_blendv_ps(value,clamp,outer));
+        }
+    }
+    return ii;
+}
+#endif
+
+#pragma mark -
+#pragma mark NEON Kernels
+#if defined (CU_DSP_VECTOR_NEON64)
+/** Returns the prefix of output = input1+input2 computed with NEON */
+static size_t neon_add(float* input1, float* input2, float* output, size_t size) {
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        vst1q_f32(output+ii, vaddq_f32(vld1q_f32(input1+ii),vld1q_f32(input2+ii)));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = input1*input2 computed with NEON */
+static size_t neon_multiply(float* input1, float* input2, float* output, size_t size) {
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        vst1q_f32(output+ii, vmulq_f32(vld1q_f32(input1+ii),vld1q_f32(input2+ii)));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = scalar*input computed with NEON */
+static size_t neon_scale(float* input, float scalar, float* output, size_t size) {
+    const float32x4_t gain = vdupq_n_f32(scalar);
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        vst1q_f32(output+ii, vmulq_f32(vld1q_f32(input+ii),gain));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = scalar*input1+input2 computed with NEON */
+static size_t neon_scale_add(float* input1, float* input2, float scalar, float* output, size_t size) {
+    const float32x4_t gain = vdupq_n_f32(scalar);
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        vst1q_f32(output+ii, vmlaq_f32(vld1q_f32(input2+ii),vld1q_f32(input1+ii),gain));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = gain*(inputs[0]+...+inputs[count-1]) computed with NEON */
+static size_t neon_mix(float** inputs, size_t count, float gain, float* output, size_t size) {
+    const float32x4_t scalar = vdupq_n_f32(gain);
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        float32x4_t sum = vdupq_n_f32(0.0f);
+        for(size_t kk = 0; kk < count; kk++) {
+            sum = vaddq_f32(sum,vld1q_f32(inputs[kk]+ii));
+        }
+        vst1q_f32(output+ii, vmulq_f32(sum,scalar));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = input/32768 computed with NEON */
+static size_t neon_convert(const Sint16* input, float* output, size_t size) {
+    size_t ii = 0;
+    for(; ii+8 <= size; ii += 8) {
+        int16x8_t words = vld1q_s16(input+ii);
+        // Fixed point conversion with 15 fractional bits divides by 32768
+        vst1q_f32(output+ii,   vcvtq_n_f32_s32(vmovl_s16(vget_low_s16(words)),15));
+        vst1q_f32(output+ii+4, vcvtq_n_f32_s32(vmovl_s16(vget_high_s16(words)),15));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = (start+step*i)*input computed with NEON */
+static size_t neon_slide(float* input, float start, float step, float* output, size_t size) {
+    const float32x4_t skip = {0,step,2*step,3*step};
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        float32x4_t gain = vaddq_f32(vdupq_n_f32(start+ii*step),skip);
+        vst1q_f32(output+ii, vmulq_f32(vld1q_f32(input+ii),gain));
+    }
+    return ii;
+}
+
+/** Returns the prefix of output = (start+step*i)*input1+input2 computed with NEON */
+static size_t neon_slide_add(float* input1, float* input2, float start, float step, float* output, size_t size) {
+    const float32x4_t skip = {0,step,2*step,3*step};
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        float32x4_t gain = vaddq_f32(vdupq_n_f32(start+ii*step),skip);
+        vst1q_f32(output+ii, vmlaq_f32(vld1q_f32(input2+ii),vld1q_f32(input1+ii),gain));
+    }
+    return ii;
+}
+
+/** Returns the prefix of data clamped to [min,max] computed with NEON */
+static size_t neon_clamp(float* data, float min, float max, size_t size) {
+    const float32x4_t vmin = vdupq_n_f32(min);
+    const float32x4_t vmax = vdupq_n_f32(max);
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        vst1q_f32(data+ii, vminq_f32(vmaxq_f32(vld1q_f32(data+ii),vmin),vmax));
+    }
+    return ii;
+}
+
+/** Returns the prefix of data soft clamped to [-bound,bound] computed with NEON */
+static size_t neon_ease(float* data, float bound, float knee, float factor, size_t size) {
+    const float32x4_t gain = vdupq_n_f32(bound);
+    const float32x4_t uppr = vdupq_n_f32(knee);
+    const float32x4_t lowr = vdupq_n_f32(-knee);
+    const float32x4_t fact = vdupq_n_f32(factor);
+    size_t ii = 0;
+    for(; ii+4 <= size; ii += 4) {
+        float32x4_t value = vld1q_f32(data+ii);
+        uint32x4_t  above = vcgtq_f32(value,uppr);
+        uint32x4_t  outer = vorrq_u32(above,vcltq_f32(value,lowr));
+        if (vmaxvq_u32(outer)) {
+            // bound-factor/x above the knee, -bound-factor/x below it
+            float32x4_t ratio = vdivq_f32(fact,value);
+            float32x4_t clamp = vbslq_f32(above,vsubq_f32(gain,ratio),vnegq_f32(vaddq_f32(gain,ratio)));
+            vst1q_f32(data+ii,vbslq_f32(outer,clamp,value));
+        }
+    }
+    return ii;
+}
+#endif
+
+#pragma mark -
+#pragma mark Vector Backends
+/**
+ * Returns the best vector backend supported by this CPU
+ *
+ * This is the backend chosen when the program starts. It is SCALAR if
+ * the platform has no supported vector instructions.
+ *
+ * @return the best vector backend supported by this CPU
+ */
+DSPMath::Backend DSPMath::getNativeBackend() {
+#if defined (CU_DSP_VECTOR_NEON64)
+    return Backend::NEON;
+#elif defined (CU_DSP_VECTOR_SSE2)
+#if defined (CU_DSP_VECTOR_AVX2)
+    // This may be called before static constructors, so initialize explicitly
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return Backend::AVX2;
+    }
+#endif
+    return Backend::SSE2;
+#else
+    return Backend::SCALAR;
+#endif
+}
+
+/**
+ * Returns true if the given vector backend is supported by this CPU
+ *
+ * The scalar backend is always supported. On x86 processors, SSE2 is
+ * supported whenever AVX2 is supported.
+ *
+ * @param backend   The vector backend to test
+ *
+ * @return true if the given vector backend is supported by this CPU
+ */
+bool DSPMath::isSupported(Backend backend) {
+    Backend native = getNativeBackend();
+    switch (backend) {
+        case Backend::SCALAR:
+            return true;
+        case Backend::SSE2:
+            return native == Backend::SSE2 || native == Backend::AVX2;
+        default:
+            return native == backend;
+    }
+}
+
+/**
+ * Sets the active vector backend
+ *
+ * If the backend is not supported by this CPU, this method does nothing
+ * and returns false. This method is not thread safe, and should not be
+ * called while the audio thread is running.
+ *
+ * @param backend   The vector backend to use
+ *
+ * @return true if the backend was changed
+ */
+bool DSPMath::setBackend(Backend backend) {
+    if (!isSupported(backend)) {
+        return false;
+    }
+    _backend = backend;
+    return true;
+}
+
 #pragma mark -
 #pragma mark Arithmetic Methods
 /**
@@ -56,42 +525,28 @@ bool DSPMath::VECTORIZE = true;
  * @return the number of elements successfully added
  */
 size_t DSPMath::add(float* input1, float* input2, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
-    if (VECTORIZE) {
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            _mm_storeu_ps(output+ii, _mm_add_ps(_mm_loadu_ps(input1+ii),_mm_loadu_ps(input2+ii)));
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(Uint32 ii = (Uint32)(size-rem); ii < size; ii++) {
-                output[ii] = input1[ii]+input2[ii];
-            }
-        }
-    } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
-    if (VECTORIZE) {
+    size_t done = 0;
+    switch (VECTORIZE ? _backend : Backend::SCALAR) {
+#if defined (CU_DSP_VECTOR_AVX2)
+        case Backend::AVX2:
+            done = avx2_add(input1,input2,output,size);
+            break;
 #endif
-        int ii;
-        for(ii = 0; ii < (int)size-3; ii += 4) {
-            vst1q_f32(output+ii, vaddq_f32(vld1q_f32(input1+ii),vld1q_f32(input2+ii)));
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(Uint32 ii = (Uint32)(size-rem); ii < size; ii++) {
-                output[ii] = input1[ii]+input2[ii];
-            }
-        }
-    } else {
-#else
-    {
+#if defined (CU_DSP_VECTOR_SSE2)
+        case Backend::SSE2:
+            done = sse2_add(input1,input2,output,size);
+            break;
 #endif
-        for(int ii = 0; ii < size; ii++) {
-            output[ii] = input1[ii]+input2[ii];
-        }
+#if defined (CU_DSP_VECTOR_NEON64)
+        case Backend::NEON:
+            done = neon_add(input1,input2,output,size);
+            break;
+#endif
+        default:
+            break;
+    }
+    for(size_t ii = done; ii < size; ii++) {
+        output[ii] = input1[ii]+input2[ii];
     }
     return size;
 }
@@ -109,41 +564,28 @@ size_t DSPMath::add(float* input1, float* input2, float* output, size_t size) {
  * @return the number of elements successfully multiplied
  */
 size_t DSPMath::multiply(float* input1, float* input2, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
-    if (VECTORIZE) {
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            _mm_storeu_ps(output+ii, _mm_mul_ps(_mm_loadu_ps(input1+ii),_mm_loadu_ps(input2+ii)));
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(Uint32 ii = (Uint32)(size-rem); ii < size; ii++) {
-                output[ii] = input1[ii]*input2[ii];
-            }
-        }
-    } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
-    if (VECTORIZE) {
+    size_t done = 0;
+    switch (VECTORIZE ? _backend : Backend::SCALAR) {
+#if defined (CU_DSP_VECTOR_AVX2)
+        case Backend::AVX2:
+            done = avx2_multiply(input1,input2,output,size);
+            break;
 #endif
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            vst1q_f32(output+ii, vmulq_f32(vld1q_f32(input1+ii),vld1q_f32(input2+ii)));
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                output[ii] = input1[ii]*input2[ii];
-            }
-        }
-    } else {
-#else
-    {
+#if defined (CU_DSP_VECTOR_SSE2)
+        case Backend::SSE2:
+            done = sse2_multiply(input1,input2,output,size);
+            break;
 #endif
-        for(int ii = 0; ii < size; ii++) {
-            output[ii] = input1[ii]*input2[ii];
-        }
+#if defined (CU_DSP_VECTOR_NEON64)
+        case Backend::NEON:
+            done = neon_multiply(input1,input2,output,size);
+            break;
+#endif
+        default:
+            break;
+    }
+    for(size_t ii = done; ii < size; ii++) {
+        output[ii] = input1[ii]*input2[ii];
     }
     return size;
 }
@@ -161,43 +603,28 @@ size_t DSPMath::multiply(float* input1, float* input2, float* output, size_t siz
  * @return the number of elements successfully multiplied
  */
 size_t DSPMath::scale(float* input, float scalar, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
-    if (VECTORIZE) {
-        const __m128 gain = _mm_set1_ps(scalar);
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            _mm_storeu_ps(output+ii, _mm_mul_ps(_mm_loadu_ps(input+ii),gain));
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                output[ii] = input[ii]*scalar;
-            }
-        }
-    } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
-    if (VECTORIZE) {
+    size_t done = 0;
+    switch (VECTORIZE ? _backend : Backend::SCALAR) {
+#if defined (CU_DSP_VECTOR_AVX2)
+        case Backend::AVX2:
+            done = avx2_scale(input,scalar,output,size);
+            break;
 #endif
-        const float32x4_t gain = vld1q_dup_f32(&scalar);
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            vst1q_f32(output+ii, vmulq_f32(vld1q_f32(input+ii),gain));
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                output[ii] = input[ii]*scalar;
-            }
-        }
-    } else {
-#else
-    {
+#if defined (CU_DSP_VECTOR_SSE2)
+        case Backend::SSE2:
+            done = sse2_scale(input,scalar,output,size);
+            break;
 #endif
-        for(int ii = 0; ii < size; ii++) {
-            output[ii] = input[ii]*scalar;
-        }
+#if defined (CU_DSP_VECTOR_NEON64)
+        case Backend::NEON:
+            done = neon_scale(input,scalar,output,size);
+            break;
+#endif
+        default:
+            break;
+    }
+    for(size_t ii = done; ii < size; ii++) {
+        output[ii] = input[ii]*scalar;
     }
     return size;
 }
@@ -216,50 +643,120 @@ size_t DSPMath::scale(float* input, float scalar, float* output, size_t size) {
  * @return the number of elements successfully processed
  */
 size_t DSPMath::scale_add(float* input1, float* input2, float scalar, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
-    if (VECTORIZE) {
-        const __m128 gain = _mm_set1_ps(scalar);
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            _mm_storeu_ps(output+ii,
-                          _mm_fmadd_ps(_mm_loadu_ps(input1+ii),gain,_mm_loadu_ps(input2+ii)));
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                output[ii] = input1[ii]*scalar+input2[ii];
-            }
-        }
-    } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
-    if (VECTORIZE) {
+    size_t done = 0;
+    switch (VECTORIZE ? _backend : Backend::SCALAR) {
+#if defined (CU_DSP_VECTOR_AVX2)
+        case Backend::AVX2:
+            done = avx2_scale_add(input1,input2,scalar,output,size);
+            break;
 #endif
-        const float32x4_t gain = vld1q_dup_f32(&scalar);
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            vst1q_f32(output+ii,
-                      vmlaq_f32(vld1q_f32(input2+ii),vld1q_f32(input1+ii),gain));
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                output[ii] = input1[ii]*scalar+input2[ii];
-            }
-        }
-    } else {
-#else
-    {
+#if defined (CU_DSP_VECTOR_SSE2)
+        case Backend::SSE2:
+            done = sse2_scale_add(input1,input2,scalar,output,size);
+            break;
+#endif
+#if defined (CU_DSP_VECTOR_NEON64)
+        case Backend::NEON:
+            done = neon_scale_add(input1,input2,scalar,output,size);
+            break;
+#endif
+        default:
+            break;
+    }
+    for(size_t ii = done; ii < size; ii++) {
+        output[ii] = input1[ii]*scalar+input2[ii];
+    }
+    return size;
+}
+
+/**
+ * Adds several input signals together and scales the sum, storing the result in output
+ *
+ * This method is equivalent to repeated calls to {@link #add} followed
+ * by {@link #scale}. However, it makes a single pass over the output
+ * buffer, which is much faster when mixing many signals. If count is 0,
+ * the output is filled with zeroes.
+ *
+ * It is safe for output to be the same as one of the input buffers.
+ *
+ * @param inputs    The array of input buffers
+ * @param count     The number of input buffers
+ * @param gain      The scalar to multiply the sum by
+ * @param output    The output buffer
+ * @param size      The number of elements to process
+ *
+ * @return the number of elements successfully processed
+ */
+size_t DSPMath::mix(float** inputs, size_t count, float gain, float* output, size_t size) {
+    size_t done = 0;
+    switch (VECTORIZE ? _backend : Backend::SCALAR) {
+#if defined (CU_DSP_VECTOR_AVX2)
+        case Backend::AVX2:
+            done = avx2_mix(inputs,count,gain,output,size);
+            break;
+#endif
+#if defined (CU_DSP_VECTOR_SSE2)
+        case Backend::SSE2:
+            done = sse2_mix(inputs,count,gain,output,size);
+            break;
 #endif
-        for(int ii = 0; ii < size; ii++) {
-            output[ii] = input1[ii]*scalar+input2[ii];
+#if defined (CU_DSP_VECTOR_NEON64)
+        case Backend::NEON:
+            done = neon_mix(inputs,count,gain,output,size);
+            break;
+#endif
+        default:
+            break;
+    }
+    for(size_t ii = done; ii < size; ii++) {
+        float sum = 0.0f;
+        for(size_t kk = 0; kk < count; kk++) {
+            sum += inputs[kk][ii];
         }
+        output[ii] = sum*gain;
+    }
+    return size;
+}
+
+/**
+ * Converts signed 16 bit PCM samples to floats, storing the result in output
+ *
+ * Each sample is divided by 32768, so that the output is in the range
+ * [-1,1). This is used to play compact in-memory audio samples.
+ *
+ * @param input     The input buffer of 16 bit samples
+ * @param output    The output buffer
+ * @param size      The number of elements to process
+ *
+ * @return the number of elements successfully processed
+ */
+size_t DSPMath::convert(const Sint16* input, float* output, size_t size) {
+    size_t done = 0;
+    switch (VECTORIZE ? _backend : Backend::SCALAR) {
+#if defined (CU_DSP_VECTOR_AVX2)
+        case Backend::AVX2:
+            done = avx2_convert(input,output,size);
+            break;
+#endif
+#if defined (CU_DSP_VECTOR_SSE2)
+        case Backend::SSE2:
+            done = sse2_convert(input,output,size);
+            break;
+#endif
+#if defined (CU_DSP_VECTOR_NEON64)
+        case Backend::NEON:
+            done = neon_convert(input,output,size);
+            break;
+#endif
+        default:
+            break;
+    }
+    for(size_t ii = done; ii < size; ii++) {
+        output[ii] = input[ii]*(1.0f/32768.0f);
     }
     return size;
 }
-        
-        
+
 #pragma mark -
 #pragma mark Fade-In/Out Methods
 /**
@@ -281,55 +778,30 @@ size_t DSPMath::scale_add(float* input1, float* input2, float scalar, float* out
  */
 size_t DSPMath::slide(float* input, float start, float end, float* output, size_t size) {
     float step = (end-start)/size;
-    float curr = start;
-#if defined (CU_MATH_VECTOR_SSE)
-    if (VECTORIZE) {
-        __m128 left, rght;
-        __m128 skip = _mm_setr_ps(0,step,2*step,3*step);
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            left = _mm_loadu_ps(input+ii);
-            rght = _mm_add_ps(_mm_set1_ps(curr),skip);
-            _mm_storeu_ps(output+ii, _mm_mul_ps(left,rght));
-            curr += 4*step;
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                output[ii] = input[ii]*curr;
-                curr += step;
-            }
-        }
-    } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
-    if (VECTORIZE) {
-#endif
-        float32x4_t left, rght;
-        float32x4_t skip = {0,step,2*step,3*step};
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            left = vld1q_f32(input+ii);
-            rght = vaddq_f32(vld1q_dup_f32(&curr),skip);
-            vst1q_f32(output+ii, vmulq_f32(left,rght));
-            curr += 4*step;
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                output[ii] = input[ii]*curr;
-                curr += step;
-            }
-        }
-    } else {
-#else
-    {
+    size_t done = 0;
+    switch (VECTORIZE ? _backend : Backend::SCALAR) {
+#if defined (CU_DSP_VECTOR_AVX2)
+        case Backend::AVX2:
+            done = avx2_slide(input,start,step,output,size);
+            break;
 #endif
-        for(int ii = 0; ii < size; ii++) {
-            output[ii] = input[ii]*curr;
-            curr += step;
-        }
+#if defined (CU_DSP_VECTOR_SSE2)
+        case Backend::SSE2:
+            done = sse2_slide(input,start,step,output,size);
+            break;
+#endif
+#if defined (CU_DSP_VECTOR_NEON64)
+        case Backend::NEON:
+            done = neon_slide(input,start,step,output,size);
+            break;
+#endif
+        default:
+            break;
+    }
+    float curr = start+done*step;
+    for(size_t ii = done; ii < size; ii++) {
+        output[ii] = input[ii]*curr;
+        curr += step;
     }
     return size;
 }
@@ -354,62 +826,34 @@ size_t DSPMath::slide(float* input, float start, float end, float* output, size_
  */
 size_t DSPMath::slide_add(float* input1, float* input2, float start, float end, float* output, size_t size) {
     float step = (end-start)/size;
-    float curr = start;
-#if defined (CU_MATH_VECTOR_SSE)
-    if (VECTORIZE) {
-        __m128 left, rght, gain;
-        __m128 skip = _mm_setr_ps(0,step,2*step,3*step);
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            left = _mm_loadu_ps(input1+ii);
-            rght = _mm_loadu_ps(input2+ii);
-            gain = _mm_add_ps(_mm_set1_ps(curr),skip);
-            _mm_storeu_ps(output+ii, _mm_fmadd_ps(left,gain,rght));
-            curr += 4*step;
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                output[ii] = input1[ii]*curr+input2[ii];
-                curr += step;
-            }
-        }
-    } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
-    if (VECTORIZE) {
-#endif
-        float32x4_t left, rght, gain;
-        float32x4_t skip = {0,step,2*step,3*step};
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            left = vld1q_f32(input1+ii);
-            rght = vld1q_f32(input2+ii);
-            gain = vaddq_f32(vld1q_dup_f32(&curr),skip);
-            vst1q_f32(output+ii, vmlaq_f32(rght,left,gain));
-            curr += 4*step;
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                output[ii] = input1[ii]*curr+input2[ii];
-                curr += step;
-            }
-        }
-    } else {
-#else
-    {
+    size_t done = 0;
+    switch (VECTORIZE ? _backend : Backend::SCALAR) {
+#if defined (CU_DSP_VECTOR_AVX2)
+        case Backend::AVX2:
+            done = avx2_slide_add(input1,input2,start,step,output,size);
+            break;
 #endif
-        for(int ii = 0; ii < size; ii++) {
-            output[ii] = input1[ii]*curr+input2[ii];
-            curr += step;
-        }
+#if defined (CU_DSP_VECTOR_SSE2)
+        case Backend::SSE2:
+            done = sse2_slide_add(input1,input2,start,step,output,size);
+            break;
+#endif
+#if defined (CU_DSP_VECTOR_NEON64)
+        case Backend::NEON:
+            done = neon_slide_add(input1,input2,start,step,output,size);
+            break;
+#endif
+        default:
+            break;
+    }
+    float curr = start+done*step;
+    for(size_t ii = done; ii < size; ii++) {
+        output[ii] = input1[ii]*curr+input2[ii];
+        curr += step;
     }
     return size;
 }
 
-        
 #pragma mark -
 #pragma mark Clamp Methods
 /**
@@ -423,47 +867,28 @@ size_t DSPMath::slide_add(float* input1, float* input2, float start, float end,
  * @return the number of elements successfully clamped
  */
 size_t DSPMath::clamp(float* data, float min, float max, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
-    if (VECTORIZE) {
-        const __m128 vmin = _mm_set1_ps(min);
-        const __m128 vmax = _mm_set1_ps(max);
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            _mm_storeu_ps(data+ii, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data+ii),vmin),vmax));
-        }
-        if (size % 4 != 0) {
-            __m128 temp;
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                temp = _mm_min_ss(_mm_max_ss(_mm_set_ss(data[ii]),vmin),vmax);
-                data[ii] = temp[0];
-            }
-        }
-    } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
-    if (VECTORIZE) {
+    size_t done = 0;
+    switch (VECTORIZE ? _backend : Backend::SCALAR) {
+#if defined (CU_DSP_VECTOR_AVX2)
+        case Backend::AVX2:
+            done = avx2_clamp(data,min,max,size);
+            break;
 #endif
-        const float32x4_t vmin = vld1q_dup_f32(&min);
-        const float32x4_t vmax = vld1q_dup_f32(&max);
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            vst1q_f32(data+ii, vminq_f32(vmaxq_f32(vld1q_f32(data+ii),vmin),vmax));
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                data[ii] = std::min(std::max(data[ii],min),max);
-            }
-        }
-    } else {
-#else
-    {
+#if defined (CU_DSP_VECTOR_SSE2)
+        case Backend::SSE2:
+            done = sse2_clamp(data,min,max,size);
+            break;
 #endif
-        for(int ii = 0; ii < size; ii++) {
-            data[ii] = std::min(std::max(data[ii],min),max);
-        }
+#if defined (CU_DSP_VECTOR_NEON64)
+        case Backend::NEON:
+            done = neon_clamp(data,min,max,size);
+            break;
+#endif
+        default:
+            break;
+    }
+    for(size_t ii = done; ii < size; ii++) {
+        data[ii] = std::min(std::max(data[ii],min),max);
     }
     return size;
 }
@@ -477,6 +902,8 @@ size_t DSPMath::clamp(float* data, float min, float max, size_t size) {
  *
  *     y = (bound*x - knee+knee*knee)/x
  *
+ * for positive x (the clamp is symmetric for negative x).
+ *
  * @param data      The stream buffer
  * @param bound     The asymptotic bound
  * @param knee      The soft knee bound
@@ -486,89 +913,182 @@ size_t DSPMath::clamp(float* data, float min, float max, size_t size) {
  */
 size_t DSPMath::ease(float* data, float bound, float knee, size_t size) {
     float factor = bound*knee-knee*knee;
-#if defined (CU_MATH_VECTOR_SSE)
-    if (VECTORIZE) {
-        const __m128 gain = _mm_set1_ps(bound);
-        const __m128 uppr = _mm_set1_ps(knee);
-        const __m128 lowr = _mm_set1_ps(-knee);
-        const __m128 fact = _mm_set1_ps(factor);
-        const __m128i mask = _mm_set1_epi32(~0);
-        __m128 value, temp1, temp2, temp3, left, rght;
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            value = _mm_loadu_ps(data+ii);
-            temp1 = _mm_cmpgt_ps(value,uppr);
-            temp2 = _mm_cmplt_ps(value,lowr);
-            temp3 = _mm_or_ps(temp1,temp2);
-            if (!_mm_test_all_zeros(temp3,mask)) {
-                rght  = _mm_div_ps(fact,value);
-                left  = _mm_and_ps(temp1,_mm_sub_ps(gain,rght));
-                rght  = _mm_and_ps(temp2,_mm_add_ps(gain,rght));
-                _mm_storeu_ps(data+ii,_mm_or_ps(_mm_andnot_ps(temp3,value),
-                                                _mm_or_ps(left,rght)));
-            }
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                float tmp = data[ii];
-                if (tmp > knee) {
-                    data[ii] = (bound*tmp-factor)/tmp;
-                } else if (tmp < - knee) {
-                    data[ii] = (bound*tmp+factor)/tmp;
-                }
-            }
-        }
-    } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
-    if (VECTORIZE) {
-#endif
-        float bknee = -knee;
-        const float32x4_t gain = vld1q_dup_f32(&bound);
-        const float32x4_t uppr = vld1q_dup_f32(&knee);
-        const float32x4_t lowr = vld1q_dup_f32(&bknee);
-        const float32x4_t fact = vld1q_dup_f32(&factor);
-        uint32x4_t  temp1, temp2, temp3;
-        float32x4_t value, left, rght;
-        for(int ii = 0; ii < (int)size-3; ii += 4) {
-            value = vld1q_f32(data+ii);
-            temp1 = vcgtq_f32(value,uppr);
-            temp2 = vcltq_f32(value,lowr);
-            temp3 = vorrq_u32((uint32x4_t)temp1,(uint32x4_t)temp2);
-            if (vmaxvq_u32(temp3)) {
-                left  = vrecpeq_f32(value);
-                left  = vmulq_f32(vrecpsq_f32(value, left), left);
-                rght  = vmulq_f32(fact,left);
-                left  = vbslq_f32(temp1,vsubq_f32(gain,rght),vaddq_f32(gain,rght));
-                vst1q_f32(data+ii,vbslq_f32(temp3,left,value));
-            }
-        }
-        if (size % 4 != 0) {
-            Uint32 rem = size % 4;
-            for(int ii = (Uint32)(size-rem); ii < size; ii++) {
-                float tmp = data[ii];
-                if (tmp > knee) {
-                    data[ii] = (bound*tmp-factor)/tmp;
-                } else if (tmp < - knee) {
-                    data[ii] = (bound*tmp+factor)/tmp;
-                }
-            }
-        }
-    } else {
-#else
-    {
-#endif
-        for(int ii = 0; ii < size; ii++) {
-            float tmp = data[ii];
-            if (tmp > knee) {
-                data[ii] = (bound*tmp-factor)/tmp;
-            } else if (tmp < - knee) {
-                data[ii] = (bound*tmp+factor)/tmp;
-            }
+    size_t done = 0;
+    switch (VECTORIZE ? _backend : Backend::SCALAR) {
+#if defined (CU_DSP_VECTOR_AVX2)
+        case Backend::AVX2:
+            done = avx2_ease(data,bound,knee,factor,size);
+            break;
+#endif
+#if defined (CU_DSP_VECTOR_SSE2)
+        case Backend::SSE2:
+            done = sse2_ease(data,bound,knee,factor,size);
+            break;
+#endif
+#if defined (CU_DSP_VECTOR_NEON64)
+        case Backend::NEON:
+            done = neon_ease(data,bound,knee,factor,size);
+            break;
+#endif
+        default:
+            break;
+    }
+    for(size_t ii = done; ii < size; ii++) {
+        float tmp = data[ii];
+        if (tmp > knee) {
+            data[ii] = (bound*tmp-factor)/tmp;
+        } else if (tmp < - knee) {
+            data[ii] = -(bound*tmp+factor)/tmp;
         }
     }
     return size;
 }
+
+#pragma mark -
+#pragma mark Benchmarking
+/**
+ * Returns the throughput of the given kernel in frames per microsecond
+ *
+ * @param kernel    The kernel to time
+ * @param frames    The number of frames processed by each call
+ * @param trials    The number of times to call the kernel
+ *
+ * @return the throughput of the given kernel in frames per microsecond
+ */
+static double time_kernel(const std::function<void()>& kernel, Uint32 frames, Uint32 trials) {
+    kernel(); // Warm the cache
+    Timestamp start;
+    for(Uint32 ii = 0; ii < trials; ii++) {
+        kernel();
+    }
+    Timestamp end;
+    Uint64 nanos = Timestamp::ellapsedNanos(start,end);
+    return nanos == 0 ? 0.0 : (1000.0*frames*trials)/nanos;
+}
+
+/**
+ * Returns the lower case name of the given backend
+ *
+ * @param backend   The vector backend
+ *
+ * @return the lower case name of the given backend
+ */
+static const char* backend_name(DSPMath::Backend backend) {
+    switch (backend) {
+        case DSPMath::Backend::SSE2:
+            return "sse2";
+        case DSPMath::Backend::AVX2:
+            return "avx2";
+        case DSPMath::Backend::NEON:
+            return "neon";
+        default:
+            return "scalar";
+    }
+}
+
+/**
+ * Returns a report comparing the vector backends to the scalar algorithms
+ *
+ * This method times each of the methods in this class, as well as the
+ * calculate methods of {@link BiquadIIR}, {@link OnePoleIIR}, and
+ * {@link TwoPoleIIR}. Each method is timed on every supported backend
+ * (including the scalar backend). The report has one line per method,
+ * giving the throughput in frames per microsecond. The {@link #mix}
+ * method is timed with four inputs.
+ *
+ * The active backend and vectorization flags are restored when this
+ * method returns. This method is not thread safe, and should not be
+ * called while the audio thread is running.
+ *
+ * @param frames    The number of frames in each buffer
+ * @param channels  The number of interleaved channels
+ * @param trials    The number of times to run each method
+ *
+ * @return a report comparing the vector backends to the scalar algorithms
+ */
+std::string DSPMath::benchmark(Uint32 frames, Uint32 channels, Uint32 trials) {
+    const size_t MIX_INPUTS = 4;
+    size_t size = (size_t)frames*channels;
+
+    // Noise in [-1.5,1.5] so that the clamps do some work
+    std::vector<float> source((MIX_INPUTS+1)*size);
+    Uint32 seed = 0x1234567;
+    for(size_t ii = 0; ii < source.size(); ii++) {
+        seed = seed*1664525+1013904223;
+        source[ii] = 3.0f*(seed >> 8)/(float)(1 << 24)-1.5f;
+    }
+    std::vector<float> output(size);
+    float* input1 = source.data();
+    float* input2 = source.data()+size;
+    float* result = output.data();
+    float* inputs[MIX_INPUTS];
+    for(size_t ii = 0; ii < MIX_INPUTS; ii++) {
+        inputs[ii] = source.data()+(ii+1)*size;
+    }
+    std::vector<Sint16> pcm(size);
+    for(size_t ii = 0; ii < size; ii++) {
+        pcm[ii] = (Sint16)(input1[ii]*20000);
+    }
+
+    Backend active = _backend;
+    bool vectorize = VECTORIZE;
+    std::vector<Backend> backends;
+    backends.push_back(Backend::SCALAR);
+    for(Backend backend : {Backend::SSE2, Backend::AVX2, Backend::NEON}) {
+        if (isSupported(backend)) {
+            backends.push_back(backend);
+        }
+    }
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    ss << "DSP benchmark (" << frames << " frames x " << channels << " channels, frames/us)";
+    auto report = [&](const char* name, const std::function<void()>& kernel) {
+        ss << "\n" << std::left << std::setw(10) << name << std::right;
+        for(Backend backend : backends) {
+            _backend = backend;
+            VECTORIZE = backend != Backend::SCALAR;
+            ss << "  " << backend_name(backend) << " " << time_kernel(kernel,frames,trials);
+        }
+    };
+    report("add", [&]() { add(input1,input2,result,size); });
+    report("multiply", [&]() { multiply(input1,input2,result,size); });
+    report("scale", [&]() { scale(input1,0.5f,result,size); });
+    report("scale_add", [&]() { scale_add(input1,input2,0.5f,result,size); });
+    report("mix", [&]() { mix(inputs,MIX_INPUTS,0.5f,result,size); });
+    report("convert", [&]() { convert(pcm.data(),result,size); });
+    report("slide", [&]() { slide(input1,0.0f,1.0f,result,size); });
+    report("slide_add", [&]() { slide_add(input1,input2,0.0f,1.0f,result,size); });
+    report("clamp", [&]() {
+        std::memcpy(result,input1,size*sizeof(float));
+        clamp(result,-1.0f,1.0f,size);
+    });
+    report("ease", [&]() {
+        std::memcpy(result,input1,size*sizeof(float));
+        ease(result,1.0f,0.9f,size);
+    });
+    _backend = active;
+    VECTORIZE = vectorize;
+
+    // The filters have a single vector algorithm each
+    BiquadIIR biquad(channels,BiquadIIR::Type::LOWPASS,0.1f,0.0f);
+    OnePoleIIR onepole(channels,0.5f,-0.3f);
+    TwoPoleIIR twopole(channels,0.5f,-0.3f,0.2f);
+    bool flags[3] = { BiquadIIR::VECTORIZE, OnePoleIIR::VECTORIZE, TwoPoleIIR::VECTORIZE };
+    auto filter = [&](const char* name, bool& flag, const std::function<void()>& kernel) {
+        ss << "\n" << std::left << std::setw(10) << name << std::right;
+        flag = false;
+        ss << "  scalar " << time_kernel(kernel,frames,trials);
+#if defined (CU_DSP_VECTOR_SSE) || defined (CU_DSP_VECTOR_NEON64)
+        flag = true;
+        ss << "  vector " << time_kernel(kernel,frames,trials);
+#endif
+    };
+    filter("biquad", BiquadIIR::VECTORIZE, [&]() { biquad.calculate(1.0f,input1,result,frames); });
+    filter("onepole", OnePoleIIR::VECTORIZE, [&]() { onepole.calculate(1.0f,input1,result,frames); });
+    filter("twopole", TwoPoleIIR::VECTORIZE, [&]() { twopole.calculate(1.0f,input1,result,frames); });
+    BiquadIIR::VECTORIZE  = flags[0];
+    OnePoleIIR::VECTORIZE = flags[1];
+    TwoPoleIIR::VECTORIZE = flags[2];
+    return ss.str();
+}
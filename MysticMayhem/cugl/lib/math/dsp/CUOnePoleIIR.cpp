@@ -152,7 +152,7 @@ void OnePoleIIR::reset() {
     _c1[2] = -_a1*_c1[1];
     _c1[3] = -_a1*_c1[2];
     
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     _mm_store_ps(_d1,    _mm_setr_ps(1, _c1[0], _c1[1], _c1[2]));
     _mm_store_ps(_d1+4,  _mm_setr_ps(0,  1,     _c1[0], _c1[1]));
     _mm_store_ps(_d1+8,  _mm_setr_ps(0,  0,      1,     _c1[0]));
@@ -166,13 +166,8 @@ void OnePoleIIR::reset() {
     _mm_store_ps(_d2+4,  _mm_setr_ps(0.0f, 1.0f,  0.0f, _c2[5]));
     _mm_store_ps(_d2+8,  _mm_setr_ps(0.0f, 0.0f,  1.0f,  0.0f));
     _mm_store_ps(_d2+12, _mm_setr_ps(0.0f, 0.0f,  0.0f,  1.0f));
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if ( android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     {
-#endif
         float32x4_t temp;
         temp = {   1,   _c1[0], _c1[1],      _c1[2] };
         vst1q_f32(_d1   , temp);
@@ -467,31 +462,34 @@ void OnePoleIIR::step(float gain, float* input, float* output) {
  * @param size      The input size in frames
  */
 void OnePoleIIR::calculate(float gain,float* input, float* output, size_t size) {
-    size_t valid = VECTORIZE ? size-(size % 4) : size;
-    switch (_channels) {
-        case 1:
-            single(gain,input,output,valid);
-            break;
-        case 2:
-            dual(gain,input,output,valid);
-            break;
-        case 3:
-            trio(gain,input,output,valid);
-            break;
-        case 4:
-            quad(gain,input,output,valid);
-            break;
-        case 8:
-            quart(gain,input,output,valid);
-            break;
-        default:
-            for(int ii = 0; ii < _channels; ii++) {
-                stride(gain,input+ii,output+ii,valid,ii);
-            }
-            break;
+    // The block algorithms require at least four frames
+    size_t valid = size < 4 ? 0 : (VECTORIZE ? size-(size % 4) : size);
+    if (valid > 0) {
+        switch (_channels) {
+            case 1:
+                single(gain,input,output,valid);
+                break;
+            case 2:
+                dual(gain,input,output,valid);
+                break;
+            case 3:
+                trio(gain,input,output,valid);
+                break;
+            case 4:
+                quad(gain,input,output,valid);
+                break;
+            case 8:
+                quart(gain,input,output,valid);
+                break;
+            default:
+                for(int ii = 0; ii < _channels; ii++) {
+                    stride(gain,input+ii,output+ii,valid,ii);
+                }
+                break;
+        }
     }
     if (valid < size) {
-        for(size_t ii = size-valid; ii < size; ii++) {
+        for(size_t ii = valid; ii < size; ii++) {
             for(size_t ckk = 0; ckk < _channels; ckk++) {
                 output[ii*_channels+ckk] = _outs[ckk];
                 _outs[ckk]  = gain * _b0 * input[ii*_channels+ckk] -_a1 * _outs[ckk];
@@ -558,7 +556,7 @@ size_t OnePoleIIR::flush(float* output) {
  * @param channel   The specific channel to process
  */
 void OnePoleIIR::stride(float gain, float* input, float* output, size_t size, unsigned channel) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 prev;
         __m128 tmp1, tmp2, tmp3;
@@ -566,7 +564,7 @@ void OnePoleIIR::stride(float gain, float* input, float* output, size_t size, un
         
         unsigned stride = _channels;
         prev = _mm_set1_ps(_outs[channel]);
-        for(int ii = 0; ii < size; ii += 4) {
+        for(size_t ii = 0; ii < size; ii += 4) {
             // C[r] * y
             tmp1 = _mm_mul_ps(prev,_mm_load_ps(_c1));
 
@@ -576,9 +574,9 @@ void OnePoleIIR::stride(float gain, float* input, float* output, size_t size, un
 
             // D[r] * x
             tmp3 = _mm_mul_ps(_mm_set1_ps(tmp2[0]),_mm_load_ps(_d1));
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d1+4),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d1+8),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d1+12),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d1+4),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d1+8),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d1+12),tmp3);
 
             // Shift to output and repeat
             tmp2 = _mm_add_ps(tmp1,tmp3);
@@ -591,13 +589,8 @@ void OnePoleIIR::stride(float gain, float* input, float* output, size_t size, un
         
         _outs[channel] = prev[3];
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         unsigned stride = _channels;
         float32x4_t tmp1, tmp2, tmp3;
         float prev = _outs[channel];
@@ -662,42 +655,37 @@ void OnePoleIIR::stride(float gain, float* input, float* output, size_t size, un
  * @param size      The input size in frames
  */
 void OnePoleIIR::single(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 prev;
         __m128 tmp1, tmp2, tmp3;
         
         prev = _mm_set1_ps(_outs[0]);
-        for(int ii = 0; ii < size; ii += 4) {
+        for(size_t ii = 0; ii < size; ii += 4) {
             // C[r] * y
             tmp1 = _mm_mul_ps(prev,_mm_load_ps(_c1));
             
             // FIR
-            tmp2 = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_load_ps(input+ii));
+            tmp2 = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_loadu_ps(input+ii));
             
             // D[r] * x
             tmp3 = _mm_mul_ps(_mm_set1_ps(tmp2[0]),_mm_load_ps(_d1));
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d1+4),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d1+8),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d1+12),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d1+4),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d1+8),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d1+12),tmp3);
             
             // Shift to output and repeat
             tmp2 = _mm_add_ps(tmp1,tmp3);
             tmp3 = _mm_shuffle_ps(tmp2, tmp2, _MM_SHUFFLE(2,1,0,3));
             tmp3[0] = prev[3];
-            _mm_store_ps(output+ii, tmp3);
+            _mm_storeu_ps(output+ii, tmp3);
             prev = _mm_set1_ps(tmp2[3]);
         }
         
         _outs[0] = prev[3];
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-         (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
          float32x4_t tmp1, tmp2, tmp3;
          float prev = _outs[0];
         
@@ -761,24 +749,24 @@ void OnePoleIIR::single(float gain, float* input, float* output, size_t size) {
  * @param size      The input size in frames
  */
 void OnePoleIIR::dual(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 prev;
         __m128 tmp1, tmp2, tmp3;
         prev = _mm_set_ps(_outs[1],_outs[0],0.0f,0.0f);
-        for(int ii = 0; ii < 2*size; ii += 4) {
+        for(size_t ii = 0; ii < 2*size; ii += 4) {
             // C[r] * y
             tmp1 = _mm_mul_ps(_mm_set1_ps(prev[2]),_mm_loadu_ps(_c2));
-            tmp1 = _mm_fmadd_ps(_mm_set1_ps(prev[3]),_mm_load_ps(_c2+4), tmp1);
+            tmp1 = _mm_muladd_ps(_mm_set1_ps(prev[3]),_mm_load_ps(_c2+4), tmp1);
             
             // FIR
-            tmp2 = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_load_ps(input+ii));
+            tmp2 = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_loadu_ps(input+ii));
             
             // D[r] * x
             tmp3 = _mm_mul_ps(_mm_set1_ps(tmp2[0]),_mm_load_ps(_d2));
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d2+4),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d2+8),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d2+12),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d2+4),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d2+8),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d2+12),tmp3);
 
             // Shift to output and repeat
             tmp2 = _mm_add_ps(tmp1,tmp3);
@@ -791,13 +779,8 @@ void OnePoleIIR::dual(float gain, float* input, float* output, size_t size) {
         _outs[0] = prev[2];
         _outs[1] = prev[3];
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4_t tmp1, tmp2, tmp3;
         float32x4_t prev = { 0.0f, 0.0f, _outs[0], _outs[1] };
 
@@ -869,13 +852,8 @@ void OnePoleIIR::dual(float gain, float* input, float* output, size_t size) {
  * @param size      The input size in frames
  */
 void OnePoleIIR::trio(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#if defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4x3_t data, outr;
         float32x4_t tmp1, tmp2, tmp3;
         
@@ -985,27 +963,22 @@ void OnePoleIIR::trio(float gain, float* input, float* output, size_t size) {
  * @param size      The input size in frames
  */
 void OnePoleIIR::quad(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 prev;
         __m128 temp;
         
         prev = _mm_load_ps(_outs);
-        for(int ii = 0; ii < 4*size; ii += 4) {
-            temp = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_load_ps(input+ii));
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a1),prev,temp);
-            _mm_store_ps(output+ii, prev);
+        for(size_t ii = 0; ii < 4*size; ii += 4) {
+            temp = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_loadu_ps(input+ii));
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a1),prev,temp);
+            _mm_storeu_ps(output+ii, prev);
             prev = temp;
         }
         _mm_store_ps(_outs,prev);
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4_t prev;
         float32x4_t temp;
         
@@ -1065,34 +1038,29 @@ void OnePoleIIR::quad(float gain, float* input, float* output, size_t size) {
  * @param size      The input size in frames
  */
 void OnePoleIIR::quart(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 prva,prvb;
         __m128 temp;
         
         prva = _mm_load_ps(_outs);
         prvb = _mm_load_ps(_outs+4);
-        for(int ii = 0; ii < 8*size; ii += 8) {
-            temp = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_load_ps(input+ii));
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a1),prva,temp);
-            _mm_store_ps(output+ii, prva);
+        for(size_t ii = 0; ii < 8*size; ii += 8) {
+            temp = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_loadu_ps(input+ii));
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a1),prva,temp);
+            _mm_storeu_ps(output+ii, prva);
             prva = temp;
             
-            temp = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_load_ps(input+ii+4));
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a1),prvb,temp);
-            _mm_store_ps(output+ii+4, prvb);
+            temp = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_loadu_ps(input+ii+4));
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a1),prvb,temp);
+            _mm_storeu_ps(output+ii+4, prvb);
             prvb = temp;
         }
         _mm_store_ps(_outs,prva);
         _mm_store_ps(_outs+4,prvb);
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4_t prva,prvb;
         float32x4_t temp;
         
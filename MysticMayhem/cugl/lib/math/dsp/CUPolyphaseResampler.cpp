@@ -0,0 +1,531 @@
+//
+//  CUPolyphaseResampler.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This class is a streaming sample rate converter. It implements a polyphase
+//  windowed-sinc filter, which is the standard high quality algorithm for
+//  rational rate conversion (such as 44100 Hz to 48000 Hz). The filter bank
+//  for each conversion ratio is computed once and shared by all resamplers
+//  with that ratio, so creating a resampler is cheap.
+//
+//  The inner loop of the filter is a dot product, which is vectorized for
+//  SSE2, AVX2 and Neon 64 using the backend chosen by DSPMath. The number of
+//  filter taps is determined by a quality setting, which trades off CPU cost
+//  and latency against the quality of the anti-aliasing filter.
+//
+//  This class is NOT THREAD SAFE.  This is by design, for performance reasons.
+//  External locking may be required when the resampler is shared between
+//  multiple threads (such as between an audio thread and the main thread).
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#include <cugl/math/dsp/CUPolyphaseResampler.h>
+#include <cugl/math/dsp/CUDSPMath.h>
+#include <cugl/util/CUDebug.h>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <cmath>
+#include <mutex>
+#include "cuDSP128.inl"
+
+using namespace cugl;
+using namespace cugl::dsp;
+
+/** The maximum number of phases in a filter bank */
+const Uint32 PolyphaseResampler::MAX_PHASES = 512;
+
+#pragma mark -
+#pragma mark Filter Design
+/** The number of taps for each quality */
+static const Uint32 QUALITY_TAPS[]  = { 16, 32, 64 };
+/** The Kaiser window parameter for each quality (about 50, 70 and 90 dB) */
+static const double QUALITY_BETA[]  = { 5.0, 7.0, 9.0 };
+/** The cutoff frequency (relative to Nyquist) for each quality */
+static const double QUALITY_CUTOFF[] = { 0.85, 0.90, 0.94 };
+
+/** The cached filter banks, keyed by channels, quality and ratio */
+static std::unordered_map<Uint64, std::shared_ptr<const std::vector<float>>> bank_cache;
+/** The mutex protecting the cached filter banks */
+static std::mutex bank_mutex;
+
+/**
+ * Returns the zeroth order modified Bessel function of the first kind
+ *
+ * @param x The function argument
+ *
+ * @return the zeroth order modified Bessel function of the first kind
+ */
+static double bessel_i0(double x) {
+    double sum  = 1.0;
+    double term = 1.0;
+    double half = x/2.0;
+    for(int kk = 1; kk < 64 && term > sum*1e-12; kk++) {
+        term *= (half/kk)*(half/kk);
+        sum  += term;
+    }
+    return sum;
+}
+
+/**
+ * Returns the number of phases in the bank for the reduced output rate
+ *
+ * @param upsample  The reduced output rate
+ *
+ * @return the number of phases in the bank for the reduced output rate
+ */
+static Uint32 bank_phases(Uint32 upsample) {
+    return std::min(upsample,PolyphaseResampler::MAX_PHASES);
+}
+
+/**
+ * Returns a newly computed filter bank
+ *
+ * The bank has one row per phase, plus a guard row if the phases are
+ * interpolated. Each row has taps*channels coefficients, with each tap
+ * repeated once per channel so that it matches interleaved input.
+ *
+ * @param channels      The number of channels
+ * @param upsample      The reduced output rate
+ * @param downsample    The reduced input rate
+ * @param quality       The filter quality
+ *
+ * @return a newly computed filter bank
+ */
+static std::shared_ptr<const std::vector<float>> compute_bank(Uint32 channels, Uint32 upsample,
+                                                               Uint32 downsample, int quality) {
+    Uint32 taps   = QUALITY_TAPS[quality];
+    Uint32 phases = bank_phases(upsample);
+    Uint32 rows   = phases+(phases < upsample ? 1 : 0);
+    double beta   = QUALITY_BETA[quality];
+    double cutoff = QUALITY_CUTOFF[quality]*std::min(1.0,(double)upsample/downsample);
+    double half   = taps/2.0;
+    double scale  = bessel_i0(beta);
+
+    auto result = std::make_shared<std::vector<float>>((size_t)rows*taps*channels);
+    std::vector<double> row(taps);
+    for(Uint32 pp = 0; pp < rows; pp++) {
+        double frac = (double)pp/phases;
+        double sum  = 0;
+        for(Uint32 kk = 0; kk < taps; kk++) {
+            // The output frame lies between taps half-1 and half
+            double dist = kk-(half-1)-frac;
+            double x = cutoff*dist;
+            double sinc = (std::fabs(x) < 1e-9 ? 1.0 : std::sin(M_PI*x)/(M_PI*x));
+            double ratio = dist/half;
+            double window = ratio*ratio < 1 ? bessel_i0(beta*std::sqrt(1-ratio*ratio))/scale : 0;
+            row[kk] = sinc*window;
+            sum += row[kk];
+        }
+        float* dst = result->data()+(size_t)pp*taps*channels;
+        for(Uint32 kk = 0; kk < taps; kk++) {
+            float value = (float)(row[kk]/sum);
+            for(Uint32 ch = 0; ch < channels; ch++) {
+                *dst++ = value;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the shared filter bank for the given settings
+ *
+ * The bank is computed if it is not already cached.
+ *
+ * @param channels      The number of channels
+ * @param upsample      The reduced output rate
+ * @param downsample    The reduced input rate
+ * @param quality       The filter quality
+ *
+ * @return the shared filter bank for the given settings
+ */
+static std::shared_ptr<const std::vector<float>> acquire_bank(Uint32 channels, Uint32 upsample,
+                                                               Uint32 downsample, int quality) {
+    Uint64 key = ((Uint64)channels << 56) | ((Uint64)quality << 54) |
+                 ((Uint64)upsample << 27) | (Uint64)downsample;
+    std::lock_guard<std::mutex> lock(bank_mutex);
+    auto it = bank_cache.find(key);
+    if (it != bank_cache.end()) {
+        return it->second;
+    }
+    auto bank = compute_bank(channels,upsample,downsample,quality);
+    bank_cache.emplace(key,bank);
+    return bank;
+}
+
+#pragma mark -
+#pragma mark Vector Kernels
+// The dot product kernels require that the size is a multiple of the vector
+// width, and that the number of channels divides the vector width. Then lane
+// l of the accumulator only ever holds channel l % channels.
+#if defined (CU_DSP_VECTOR_SSE2)
+/** Computes the per-channel dot product of coef and data with SSE2 */
+static void sse2_dot(const float* coef, const float* data, size_t size, Uint32 channels, float* output) {
+    __m128 acc = _mm_setzero_ps();
+    for(size_t ii = 0; ii < size; ii += 4) {
+        acc = _mm_add_ps(acc,_mm_mul_ps(_mm_loadu_ps(coef+ii),_mm_loadu_ps(data+ii)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes,acc);
+    std::memset(output,0,channels*sizeof(float));
+    for(Uint32 ii = 0; ii < 4; ii++) {
+        output[ii % channels] += lanes[ii];
+    }
+}
+#endif
+
+#if defined (CU_DSP_VECTOR_AVX2)
+/** Computes the per-channel dot product of coef and data with AVX2 */
+CU_DSP_AVX2_TARGET
+static void avx2_dot(const float* coef, const float* data, size_t size, Uint32 channels, float* output) {
+    __m256 acc = _mm256_setzero_ps();
+    for(size_t ii = 0; ii < size; ii += 8) {
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(coef+ii),_mm256_loadu_ps(data+ii),acc);
+    }
+    float lanes[8];
+    _mm256_storeu_ps(lanes,acc);
+    std::memset(output,0,channels*sizeof(float));
+    for(Uint32 ii = 0; ii < 8; ii++) {
+        output[ii % channels] += lanes[ii];
+    }
+}
+#endif
+
+#if defined (CU_DSP_VECTOR_NEON64)
+/** Computes the per-channel dot product of coef and data with Neon */
+static void neon_dot(const float* coef, const float* data, size_t size, Uint32 channels, float* output) {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for(size_t ii = 0; ii < size; ii += 4) {
+        acc = vfmaq_f32(acc,vld1q_f32(coef+ii),vld1q_f32(data+ii));
+    }
+    float lanes[4];
+    vst1q_f32(lanes,acc);
+    std::memset(output,0,channels*sizeof(float));
+    for(Uint32 ii = 0; ii < 4; ii++) {
+        output[ii % channels] += lanes[ii];
+    }
+}
+#endif
+
+/**
+ * Computes the per-channel dot product of coef and data
+ *
+ * The arrays are interleaved, and size is the number of samples (not
+ * frames). The result for each channel is stored in output.
+ *
+ * @param coef      The expanded filter coefficients
+ * @param data      The interleaved input frames
+ * @param size      The number of samples in each array
+ * @param channels  The number of channels
+ * @param output    The array to store the result
+ */
+static void dot(const float* coef, const float* data, size_t size, Uint32 channels, float* output) {
+    switch (DSPMath::VECTORIZE ? DSPMath::getBackend() : DSPMath::Backend::SCALAR) {
+#if defined (CU_DSP_VECTOR_AVX2)
+        case DSPMath::Backend::AVX2:
+            if (8 % channels == 0) {
+                avx2_dot(coef,data,size,channels,output);
+                return;
+            }
+            break;
+#endif
+#if defined (CU_DSP_VECTOR_SSE2)
+        case DSPMath::Backend::SSE2:
+            if (4 % channels == 0) {
+                sse2_dot(coef,data,size,channels,output);
+                return;
+            }
+            break;
+#endif
+#if defined (CU_DSP_VECTOR_NEON64)
+        case DSPMath::Backend::NEON:
+            if (4 % channels == 0) {
+                neon_dot(coef,data,size,channels,output);
+                return;
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+    std::memset(output,0,channels*sizeof(float));
+    for(size_t ii = 0; ii < size; ii += channels) {
+        for(Uint32 ch = 0; ch < channels; ch++) {
+            output[ch] += coef[ii+ch]*data[ii+ch];
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an uninitialized resampler.
+ *
+ * The resampler must be initialized before use.
+ */
+PolyphaseResampler::PolyphaseResampler() :
+_channels(0),
+_inrate(0),
+_outrate(0),
+_quality(Quality::MEDIUM),
+_taps(0),
+_upsample(1),
+_downsample(1),
+_phases(1),
+_capacity(0),
+_avail(0),
+_index(0),
+_phase(0) {
+}
+
+/**
+ * Creates a resampler with the given settings.
+ *
+ * The capacity is the largest number of frames that will be pulled at
+ * once. The resampler can still output more, but will need several calls
+ * to {@link #pull}.
+ *
+ * @param channels  The number of channels
+ * @param inrate    The input sample rate
+ * @param outrate   The output sample rate
+ * @param quality   The filter quality
+ * @param capacity  The maximum number of output frames per pull
+ */
+PolyphaseResampler::PolyphaseResampler(Uint32 channels, Uint32 inrate, Uint32 outrate,
+                                       Quality quality, Uint32 capacity) : PolyphaseResampler() {
+    init(channels,inrate,outrate,quality,capacity);
+}
+
+/**
+ * Initializes a resampler with the given settings.
+ *
+ * The capacity is the largest number of frames that will be pulled at
+ * once. The resampler can still output more, but will need several calls
+ * to {@link #pull}.
+ *
+ * This method allocates memory, and should not be called on the audio
+ * thread.
+ *
+ * @param channels  The number of channels
+ * @param inrate    The input sample rate
+ * @param outrate   The output sample rate
+ * @param quality   The filter quality
+ * @param capacity  The maximum number of output frames per pull
+ *
+ * @return true if initialization was successful
+ */
+bool PolyphaseResampler::init(Uint32 channels, Uint32 inrate, Uint32 outrate,
+                              Quality quality, Uint32 capacity) {
+    CUAssertLog(channels && inrate && outrate && capacity, "Resampler settings must be non-zero");
+    if (!channels || !inrate || !outrate || !capacity) {
+        return false;
+    }
+    Uint32 divisor = std::gcd(inrate,outrate);
+    _channels   = channels;
+    _inrate     = inrate;
+    _outrate    = outrate;
+    _quality    = quality;
+    _taps       = getTaps(quality);
+    _upsample   = outrate/divisor;
+    _downsample = inrate/divisor;
+    _phases     = bank_phases(_upsample);
+    _bank = acquire_bank(channels,_upsample,_downsample,(int)quality);
+
+    // Room for a full pull plus the filter window
+    _capacity = (Uint32)(((Uint64)capacity*_downsample+_upsample-1)/_upsample)+_taps+2;
+    _history.assign((size_t)_capacity*_channels,0.0f);
+    _scratch.assign(_channels,0.0f);
+    clear();
+    return true;
+}
+
+/**
+ * Precomputes the filter bank for the given settings.
+ *
+ * Filter banks are computed the first time that they are needed. This
+ * method allows an application to compute the banks for common ratios
+ * (such as 44100 Hz to 48000 Hz) at start-up instead.
+ *
+ * @param channels  The number of channels
+ * @param inrate    The input sample rate
+ * @param outrate   The output sample rate
+ * @param quality   The filter quality
+ */
+void PolyphaseResampler::precompute(Uint32 channels, Uint32 inrate, Uint32 outrate, Quality quality) {
+    Uint32 divisor = std::gcd(inrate,outrate);
+    acquire_bank(channels,outrate/divisor,inrate/divisor,(int)quality);
+}
+
+#pragma mark -
+#pragma mark Attributes
+/**
+ * Returns the number of filter taps for the given quality
+ *
+ * @param quality   The filter quality
+ *
+ * @return the number of filter taps for the given quality
+ */
+Uint32 PolyphaseResampler::getTaps(Quality quality) {
+    return QUALITY_TAPS[(int)quality];
+}
+
+/**
+ * Returns the latency of this resampler in output frames
+ *
+ * This is the delay between an input frame and the output frame centered
+ * upon it, which is half the filter taps (converted to the output rate).
+ *
+ * @return the latency of this resampler in output frames
+ */
+Uint32 PolyphaseResampler::getLatency() const {
+    if (!_inrate) {
+        return 0;
+    }
+    return (Uint32)(((Uint64)(_taps/2)*_outrate+_inrate-1)/_inrate);
+}
+
+#pragma mark -
+#pragma mark Streaming
+/**
+ * Clears the input history.
+ *
+ * The history is replaced with silence, so the next output frame is
+ * centered on the next input frame.
+ */
+void PolyphaseResampler::clear() {
+    _avail = _taps/2-1;
+    _index = 0;
+    _phase = 0;
+    std::fill(_history.begin(),_history.begin()+(size_t)_avail*_channels,0.0f);
+}
+
+/**
+ * Returns the number of input frames needed to produce the given output
+ *
+ * The result is limited by the free space in the input buffer, so it may
+ * take several rounds to produce a large output.
+ *
+ * @param frames    The number of output frames desired
+ *
+ * @return the number of input frames needed to produce the given output
+ */
+Uint32 PolyphaseResampler::getInputNeeded(Uint32 frames) const {
+    if (frames == 0) {
+        return 0;
+    }
+    Uint64 last = _index+((Uint64)_phase+(Uint64)(frames-1)*_downsample)/_upsample;
+    Uint64 need = last+_taps;
+    if (need <= _avail) {
+        return 0;
+    }
+    return (Uint32)std::min(need-_avail,(Uint64)(_capacity-_avail));
+}
+
+/**
+ * Adds the given number of frames from the input buffer to the stream
+ *
+ * @param frames    The number of frames written to the input buffer
+ */
+void PolyphaseResampler::commit(Uint32 frames) {
+    CUAssertLog(_avail+frames <= _capacity, "Resampler input overflow");
+    _avail = std::min(_avail+frames,_capacity);
+}
+
+/**
+ * Copies the given input frames into the stream
+ *
+ * This is a convenience method that copies to {@link #getInputBuffer} and
+ * commits the result. It only accepts as many frames as fit in the input
+ * buffer.
+ *
+ * @param input     The interleaved input frames
+ * @param frames    The number of input frames
+ *
+ * @return the number of frames accepted
+ */
+Uint32 PolyphaseResampler::push(const float* input, Uint32 frames) {
+    Uint32 amt = std::min(frames,_capacity-_avail);
+    std::memcpy(getInputBuffer(),input,(size_t)amt*_channels*sizeof(float));
+    _avail += amt;
+    return amt;
+}
+
+/**
+ * Writes up to the given number of output frames
+ *
+ * This method produces as many frames as the current input allows. The
+ * frames are interleaved into the output buffer.
+ *
+ * @param output    The buffer to store the output
+ * @param frames    The maximum number of frames to write
+ *
+ * @return the number of frames written
+ */
+Uint32 PolyphaseResampler::pull(float* output, Uint32 frames) {
+    const float* bank = _bank->data();
+    const float* history = _history.data();
+    size_t rowsize = (size_t)_taps*_channels;
+    Uint32 step   = _downsample/_upsample;
+    Uint32 remain = _downsample % _upsample;
+    bool exact = _phases == _upsample;
+
+    Uint32 take = 0;
+    while (take < frames && _index+_taps <= _avail) {
+        const float* data = history+(size_t)_index*_channels;
+        float* out = output+(size_t)take*_channels;
+        if (exact) {
+            dot(bank+_phase*rowsize,data,rowsize,_channels,out);
+        } else {
+            // Interpolate between the two nearest phases of the bank
+            Uint64 pos = (Uint64)_phase*_phases;
+            Uint32 row = (Uint32)(pos/_upsample);
+            float  mix = (float)(pos % _upsample)/_upsample;
+            dot(bank+row*rowsize,data,rowsize,_channels,out);
+            dot(bank+(row+1)*rowsize,data,rowsize,_channels,_scratch.data());
+            for(Uint32 ch = 0; ch < _channels; ch++) {
+                out[ch] += mix*(_scratch[ch]-out[ch]);
+            }
+        }
+
+        _index += step;
+        _phase += remain;
+        if (_phase >= _upsample) {
+            _phase -= _upsample;
+            _index++;
+        }
+        take++;
+    }
+
+    // Discard the frames that no future output will use
+    if (_index >= _avail) {
+        _index -= _avail;
+        _avail = 0;
+    } else if (_index) {
+        std::memmove(_history.data(),history+(size_t)_index*_channels,
+                     (size_t)(_avail-_index)*_channels*sizeof(float));
+        _avail -= _index;
+        _index = 0;
+    }
+    return take;
+}
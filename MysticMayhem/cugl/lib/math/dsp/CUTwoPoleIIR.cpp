@@ -164,7 +164,7 @@ void TwoPoleIIR::reset() {
     _c1[3] = -_a1*_c1[2]-_a2*_c1[1];
     _c1[7] = -_a1*_c1[6]-_a2*_c1[5];
     
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     _mm_store_ps(_d1,       _mm_setr_ps(   1,   _c1[4], _c1[5],      _c1[6]));
     _mm_store_ps(_d1+4,     _mm_setr_ps(   0,    1,     _c1[4],      _c1[5]));
     _mm_store_ps(_d1+8,     _mm_setr_ps(   0,    0,      1,          _c1[4]));
@@ -180,13 +180,8 @@ void TwoPoleIIR::reset() {
     _mm_store_ps(_d2+4,     _mm_setr_ps(   0,    1,      0,          _c2[13] ));
     _mm_store_ps(_d2+8,     _mm_setr_ps(   0,    0,      1,           0 ));
     _mm_store_ps(_d2+12,    _mm_setr_ps(   0,    0,      0,           1 ));
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if ( android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     {
-#endif
         float32x4_t temp;
         temp = {   1,   _c1[4], _c1[5],      _c1[6] };
         vst1q_f32(_d1   , temp);
@@ -514,31 +509,34 @@ void TwoPoleIIR::step(float gain, float* input, float* output) {
  * @param size      The input size in frames
  */
 void TwoPoleIIR::calculate(float gain,float* input, float* output, size_t size) {
-    size_t valid = VECTORIZE ? size-(size % 4) : size;
-    switch (_channels) {
-        case 1:
-            single(gain,input,output,valid);
-            break;
-        case 2:
-            dual(gain,input,output,valid);
-            break;
-        case 3:
-            trio(gain,input,output,valid);
-            break;
-        case 4:
-            quad(gain,input,output,valid);
-            break;
-        case 8:
-            quart(gain,input,output,valid);
-            break;
-        default:
-            for(int ii = 0; ii < _channels; ii++) {
-                stride(gain,input+ii,output+ii,valid,ii);
-            }
-            break;
+    // The block algorithms require at least four frames
+    size_t valid = size < 4 ? 0 : (VECTORIZE ? size-(size % 4) : size);
+    if (valid > 0) {
+        switch (_channels) {
+            case 1:
+                single(gain,input,output,valid);
+                break;
+            case 2:
+                dual(gain,input,output,valid);
+                break;
+            case 3:
+                trio(gain,input,output,valid);
+                break;
+            case 4:
+                quad(gain,input,output,valid);
+                break;
+            case 8:
+                quart(gain,input,output,valid);
+                break;
+            default:
+                for(int ii = 0; ii < _channels; ii++) {
+                    stride(gain,input+ii,output+ii,valid,ii);
+                }
+                break;
+        }
     }
     if (valid < size) {
-        for(size_t ii = size-valid; ii < size; ii++) {
+        for(size_t ii = valid; ii < size; ii++) {
             for(size_t ckk = 0; ckk < _channels; ckk++) {
                 output[ii*_channels+ckk] = _outs[ckk];
                 float temp = gain * _b0 * input[ii*_channels+ckk] -_a1 * _outs[ckk+_channels] - _a2 * _outs[ckk] ;
@@ -607,7 +605,7 @@ size_t TwoPoleIIR::flush(float* output) {
  * @param channel   The specific channel to process
  */
 void TwoPoleIIR::stride(float gain, float* input, float* output, size_t size, unsigned channel) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 prev;
         __m128 tmp1, tmp2, tmp3;
@@ -619,7 +617,7 @@ void TwoPoleIIR::stride(float gain, float* input, float* output, size_t size, un
             // C[r] * y
             tmp2 = _mm_set1_ps(prev[2]);
             tmp3 = _mm_set1_ps(prev[3]);
-            tmp1 = _mm_fmadd_ps(tmp2,_mm_load_ps(_c1),_mm_mul_ps(tmp3,_mm_load_ps(_c1+4)));
+            tmp1 = _mm_muladd_ps(tmp2,_mm_load_ps(_c1),_mm_mul_ps(tmp3,_mm_load_ps(_c1+4)));
             
             // FIR
             data = _mm_skipload_ps(input+ii*stride,stride);
@@ -627,9 +625,9 @@ void TwoPoleIIR::stride(float gain, float* input, float* output, size_t size, un
 
             // D[r] * x
             tmp3 = _mm_mul_ps(_mm_set1_ps(tmp2[0]),_mm_load_ps(_d1));
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d1+4),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d1+8),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d1+12),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d1+4),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d1+8),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d1+12),tmp3);
             
             // Unpack to store
             tmp2 = _mm_add_ps(tmp1,tmp3);
@@ -641,13 +639,8 @@ void TwoPoleIIR::stride(float gain, float* input, float* output, size_t size, un
         _outs[channel] = prev[2];
         _outs[stride+channel] = prev[3];
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         unsigned stride = _channels;
         float32x4_t prev = { 0.0f, 0.0f, _outs[channel], _outs[channel+stride] };
         float32x4_t tmp1, tmp2, tmp3;
@@ -719,7 +712,7 @@ void TwoPoleIIR::stride(float gain, float* input, float* output, size_t size, un
  * @param size      The input size in frames
  */
 void TwoPoleIIR::single(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 prev;
         __m128 tmp1, tmp2, tmp3;
@@ -729,16 +722,16 @@ void TwoPoleIIR::single(float gain, float* input, float* output, size_t size) {
             // C[r] * y
             tmp2 = _mm_set1_ps(prev[2]);
             tmp3 = _mm_set1_ps(prev[3]);
-            tmp1 = _mm_fmadd_ps(tmp2,_mm_load_ps(_c1),_mm_mul_ps(tmp3,_mm_load_ps(_c1+4)));
+            tmp1 = _mm_muladd_ps(tmp2,_mm_load_ps(_c1),_mm_mul_ps(tmp3,_mm_load_ps(_c1+4)));
             
             // FIR
             tmp2 = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_loadu_ps(input+ii));
 
             // D[r] * x
             tmp3 = _mm_mul_ps(_mm_set1_ps(tmp2[0]),_mm_load_ps(_d1));
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d1+4),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d1+8),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d1+12),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d1+4),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d1+8),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d1+12),tmp3);
 
             // Shift to output and repeat
             tmp2 = _mm_add_ps(tmp1,tmp3);
@@ -750,13 +743,8 @@ void TwoPoleIIR::single(float gain, float* input, float* output, size_t size) {
         _outs[0] = prev[2];
         _outs[1] = prev[3];
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4_t prev = { 0.0f, 0.0f, _outs[0], _outs[1] };
         float32x4_t tmp1, tmp2, tmp3;
         
@@ -827,43 +815,38 @@ void TwoPoleIIR::single(float gain, float* input, float* output, size_t size) {
  * @param size      The input size in frames
  */
 void TwoPoleIIR::dual(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 prev;
         __m128 tmp1, tmp2, tmp3;
         
         prev = _mm_load_ps(_outs+0);
 
-        for(int ii = 0; ii < 2*size; ii += 4) {
+        for(size_t ii = 0; ii < 2*size; ii += 4) {
             // C[r] * y
             tmp1 = _mm_mul_ps(_mm_set1_ps(prev[0]),_mm_load_ps(_c2));
-            tmp1 = _mm_fmadd_ps(_mm_set1_ps(prev[1]),_mm_load_ps(_c2+4), tmp1);
-            tmp1 = _mm_fmadd_ps(_mm_set1_ps(prev[2]),_mm_load_ps(_c2+8), tmp1);
-            tmp1 = _mm_fmadd_ps(_mm_set1_ps(prev[3]),_mm_load_ps(_c2+12),tmp1);
+            tmp1 = _mm_muladd_ps(_mm_set1_ps(prev[1]),_mm_load_ps(_c2+4), tmp1);
+            tmp1 = _mm_muladd_ps(_mm_set1_ps(prev[2]),_mm_load_ps(_c2+8), tmp1);
+            tmp1 = _mm_muladd_ps(_mm_set1_ps(prev[3]),_mm_load_ps(_c2+12),tmp1);
 
             // D[r] * x
-            tmp2 = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_load_ps(input+ii));
+            tmp2 = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_loadu_ps(input+ii));
             
             tmp3 = _mm_mul_ps(_mm_set1_ps(tmp2[0]),_mm_load_ps(_d2));
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d2+4),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d2+8),tmp3);
-            tmp3 = _mm_fmadd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d2+12),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[1]),_mm_load_ps(_d2+4),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[2]),_mm_load_ps(_d2+8),tmp3);
+            tmp3 = _mm_muladd_ps(_mm_set1_ps(tmp2[3]),_mm_load_ps(_d2+12),tmp3);
 
             // Shift to output and repeat
             tmp2 = _mm_add_ps(tmp1,tmp3);
-            _mm_store_ps(output+ii, prev);
+            _mm_storeu_ps(output+ii, prev);
             prev = tmp2;
         }
         
         _mm_store_ps(_outs+0,prev);
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4_t prev = vld1q_f32(_outs+0);
         float32x4_t tmp1, tmp2, tmp3;
         
@@ -940,13 +923,8 @@ void TwoPoleIIR::dual(float gain, float* input, float* output, size_t size) {
  * @param size      The input size in frames
  */
 void TwoPoleIIR::trio(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#if defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4x3_t prev, data;
         float32x4x3_t outr;
         float32x4_t tmp1, tmp2, tmp3;
@@ -1066,17 +1044,17 @@ void TwoPoleIIR::trio(float gain, float* input, float* output, size_t size) {
  * @param size      The input size in frames
  */
 void TwoPoleIIR::quad(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 prev1,prev2;
         __m128 temp;
         
         prev2 = _mm_load_ps(_outs+0);
         prev1 = _mm_load_ps(_outs+4);
-        for(int ii = 0; ii < 4*size; ii += 4) {
+        for(size_t ii = 0; ii < 4*size; ii += 4) {
             temp = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_loadu_ps(input+ii));
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a1),prev1,temp);
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a2),prev2,temp);
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a1),prev1,temp);
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a2),prev2,temp);
             _mm_storeu_ps(output+ii, prev2);
             prev2 = prev1;
             prev1 = temp;
@@ -1084,13 +1062,8 @@ void TwoPoleIIR::quad(float gain, float* input, float* output, size_t size) {
         _mm_store_ps(_outs+0,prev2);
         _mm_store_ps(_outs+4,prev1);
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4_t prev1,prev2;
         float32x4_t temp;
         
@@ -1161,7 +1134,7 @@ void TwoPoleIIR::quad(float gain, float* input, float* output, size_t size) {
  * @param size      The input size in frames
  */
 void TwoPoleIIR::quart(float gain, float* input, float* output, size_t size) {
-#if defined (CU_MATH_VECTOR_SSE)
+#if defined (CU_DSP_VECTOR_SSE)
     if (VECTORIZE) {
         __m128 prev1a,prev1b,prev2a,prev2b;
         __m128 temp;
@@ -1170,17 +1143,17 @@ void TwoPoleIIR::quart(float gain, float* input, float* output, size_t size) {
         prev2b = _mm_load_ps(_outs+4);
         prev1a = _mm_load_ps(_outs+8);
         prev1b = _mm_load_ps(_outs+12);
-        for(int ii = 0; ii < 8*size; ii += 8) {
-            temp = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_load_ps(input+ii));
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a1),prev1a,temp);
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a2),prev2a,temp);
-            _mm_store_ps(output+ii, prev2a);
+        for(size_t ii = 0; ii < 8*size; ii += 8) {
+            temp = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_loadu_ps(input+ii));
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a1),prev1a,temp);
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a2),prev2a,temp);
+            _mm_storeu_ps(output+ii, prev2a);
             prev2a = prev1a;
             prev1a = temp;
-            temp = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_load_ps(input+ii+4));
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a1),prev1b,temp);
-            temp = _mm_fmadd_ps(_mm_set1_ps(-_a2),prev2b,temp);
-            _mm_store_ps(output+ii+4, prev2b);
+            temp = _mm_mul_ps(_mm_set1_ps(gain * _b0), _mm_loadu_ps(input+ii+4));
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a1),prev1b,temp);
+            temp = _mm_muladd_ps(_mm_set1_ps(-_a2),prev2b,temp);
+            _mm_storeu_ps(output+ii+4, prev2b);
             prev2b = prev1b;
             prev1b = temp;
         }
@@ -1189,13 +1162,8 @@ void TwoPoleIIR::quart(float gain, float* input, float* output, size_t size) {
         _mm_store_ps(_outs+8,prev1a);
         _mm_store_ps(_outs+12,prev1b);
     } else {
-#elif defined (CU_MATH_VECTOR_NEON64)
-#if defined (__ANDROID__)
-    if (VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
-        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
-#else
+#elif defined (CU_DSP_VECTOR_NEON64)
     if (VECTORIZE) {
-#endif
         float32x4_t prev1a,prev1b,prev2a,prev2b;
         float32x4_t temp;
         
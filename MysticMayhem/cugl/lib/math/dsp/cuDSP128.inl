@@ -29,7 +29,52 @@
 //  Version: 6/11/18
 //
 
-#if defined (CU_MATH_VECTOR_SSE)
+// The DSP kernels only load and store caller buffers unaligned, so they
+// are vectorized independently of CU_VECTORIZE (which also controls the
+// aligned Mat4 and Quaternion code). NEON is mandatory on 64 bit ARM. The
+// 128-bit filter algorithms only need SSE2 (they access vector lanes by
+// index, so they require GCC or Clang). They use FMA when the compiler
+// target has it. DSPMath dispatches to SSE2 or AVX2 at runtime.
+#if defined (CU_MATH_VECTOR_NEON64) || defined (__aarch64__) || defined (__arm64__)
+    #define CU_DSP_VECTOR_NEON64
+    #include <arm_neon.h>
+#elif defined (__SSE2__) && (defined (__GNUC__) || defined (__clang__))
+    #define CU_DSP_VECTOR_SSE
+    #include <immintrin.h>
+#endif
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CU_DSP_VECTOR_SSE2
+    #include <emmintrin.h>
+    #if defined (__GNUC__) || defined (__clang__)
+        #define CU_DSP_VECTOR_AVX2
+        #include <immintrin.h>
+        /** Compiles a function for AVX2 and FMA, regardless of the compiler target */
+        #define CU_DSP_AVX2_TARGET __attribute__((target("avx2,fma")))
+    #endif
+#endif
+
+#if defined (CU_MATH_VECTOR_SSE) || defined (CU_DSP_VECTOR_SSE)
+/**
+ * Returns the __m128 float vector a*b+c
+ *
+ * This function is a fused multiply-add if the compiler target supports
+ * FMA. Otherwise it is a multiply followed by an add.
+ *
+ * @param a         The first factor
+ * @param b         The second factor
+ * @param c         The addend
+ *
+ * @return the __m128 float vector a*b+c
+ */
+static inline __m128 _mm_muladd_ps(__m128 a, __m128 b, __m128 c) {
+#if defined (__FMA__)
+    return _mm_fmadd_ps(a,b,c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a,b),c);
+#endif
+}
+
 /**
  * Stores a __m128 float vector into a strided array
  *
@@ -61,7 +106,7 @@ static inline __m128 _mm_skipload_ps(float* src, size_t stride) {
     return result;
 }
 
-#elif defined (CU_MATH_VECTOR_NEON64)
+#elif defined (CU_DSP_VECTOR_NEON64)
 /**
  * Stores a float32x4_t vector into a strided array
  *
@@ -0,0 +1,536 @@
+//
+//  CUCompressedImage.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides support for block-compressed images stored in KTX
+//  (version 1) and KTX2 containers. These images are uploaded to the graphics
+//  card as is, without decoding, so they use a fraction of the memory of an
+//  RGBA texture. We support the ETC2 formats (standard on OpenGLES 3) and the
+//  ASTC formats (common on mobile devices).
+//
+//  The container is memory mapped where possible, and each mipmap level is a
+//  pointer into the mapping. Loading an image therefore reads nothing that is
+//  not uploaded, and is safe to do outside of the main thread. Only the upload
+//  itself (see Texture) requires the OpenGL context.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+//
+#include <cugl/render/CUCompressedImage.h>
+#include <cugl/render/CURenderBackend.h>
+#include <cugl/base/CUApplication.h>
+#include <cugl/util/CUFiletools.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace cugl;
+
+#pragma mark Internal Helpers
+/** The identifier that starts a KTX (version 1) container */
+static const Uint8 KTX1_ID[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+/** The identifier that starts a KTX2 container */
+static const Uint8 KTX2_ID[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+/** The byte order marker of a KTX (version 1) container written on this machine */
+#define KTX1_ENDIAN     0x04030201
+/** The size of a KTX (version 1) header, including the identifier */
+#define KTX1_HEADER     64
+/** The size of a KTX2 header and index, including the identifier */
+#define KTX2_HEADER     80
+/** The size of a KTX2 level index entry */
+#define KTX2_LEVEL      24
+/** The most mipmap levels a container may have */
+#define MAX_LEVELS      32
+
+/**
+ * A block compression format
+ *
+ * The OpenGL enums are written out, since not every platform header defines
+ * them (e.g. macOS stops at OpenGL 4.1, and ASTC is an extension in OpenGLES).
+ */
+typedef struct {
+    /** The OpenGL internal format */
+    GLenum format;
+    /** The OpenGL internal format of the sRGB variant */
+    GLenum srgb;
+    /** The Vulkan format (used by KTX2) */
+    Uint32 vkformat;
+    /** The Vulkan format of the sRGB variant */
+    Uint32 vksrgb;
+    /** The block width in pixels */
+    Uint32 width;
+    /** The block height in pixels */
+    Uint32 height;
+    /** The number of bytes in a block */
+    Uint32 bytes;
+    /** Whether the format has an alpha channel */
+    bool alpha;
+} BlockFormat;
+
+/** The supported block compression formats */
+static const BlockFormat BLOCK_FORMATS[] = {
+    { 0x9274, 0x9275, 147, 148,  4,  4,  8, false },    // ETC2 RGB8
+    { 0x9276, 0x9277, 149, 150,  4,  4,  8, true  },    // ETC2 RGB8 punchthrough A1
+    { 0x9278, 0x9279, 151, 152,  4,  4, 16, true  },    // ETC2 RGBA8 EAC
+    { 0x93B0, 0x93D0, 157, 158,  4,  4, 16, true  },    // ASTC 4x4
+    { 0x93B1, 0x93D1, 159, 160,  5,  4, 16, true  },    // ASTC 5x4
+    { 0x93B2, 0x93D2, 161, 162,  5,  5, 16, true  },    // ASTC 5x5
+    { 0x93B3, 0x93D3, 163, 164,  6,  5, 16, true  },    // ASTC 6x5
+    { 0x93B4, 0x93D4, 165, 166,  6,  6, 16, true  },    // ASTC 6x6
+    { 0x93B5, 0x93D5, 167, 168,  8,  5, 16, true  },    // ASTC 8x5
+    { 0x93B6, 0x93D6, 169, 170,  8,  6, 16, true  },    // ASTC 8x6
+    { 0x93B7, 0x93D7, 171, 172,  8,  8, 16, true  },    // ASTC 8x8
+    { 0x93B8, 0x93D8, 173, 174, 10,  5, 16, true  },    // ASTC 10x5
+    { 0x93B9, 0x93D9, 175, 176, 10,  6, 16, true  },    // ASTC 10x6
+    { 0x93BA, 0x93DA, 177, 178, 10,  8, 16, true  },    // ASTC 10x8
+    { 0x93BB, 0x93DB, 179, 180, 10, 10, 16, true  },    // ASTC 10x10
+    { 0x93BC, 0x93DC, 181, 182, 12, 10, 16, true  },    // ASTC 12x10
+    { 0x93BD, 0x93DD, 183, 184, 12, 12, 16, true  },    // ASTC 12x12
+};
+
+/**
+ * Returns the block format for the given OpenGL format (or nullptr)
+ *
+ * @param format    The OpenGL internal format (linear or sRGB)
+ *
+ * @return the block format for the given OpenGL format (or nullptr)
+ */
+static const BlockFormat* find_format(GLenum format) {
+    for(const BlockFormat& item : BLOCK_FORMATS) {
+        if (item.format == format || item.srgb == format) {
+            return &item;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Returns the block format for the given Vulkan format (or nullptr)
+ *
+ * @param vkformat  The Vulkan format (linear or sRGB)
+ *
+ * @return the block format for the given Vulkan format (or nullptr)
+ */
+static const BlockFormat* find_vkformat(Uint32 vkformat) {
+    for(const BlockFormat& item : BLOCK_FORMATS) {
+        if (item.vkformat == vkformat || item.vksrgb == vkformat) {
+            return &item;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Returns the (little-endian) 32-bit word at the given address
+ *
+ * @param data  The address, which need not be aligned
+ *
+ * @return the (little-endian) 32-bit word at the given address
+ */
+static Uint32 read32(const Uint8* data) {
+    Uint32 result;
+    std::memcpy(&result, data, sizeof(Uint32));
+    return SDL_SwapLE32(result);
+}
+
+/**
+ * Returns the (little-endian) 64-bit word at the given address
+ *
+ * @param data  The address, which need not be aligned
+ *
+ * @return the (little-endian) 64-bit word at the given address
+ */
+static Uint64 read64(const Uint8* data) {
+    Uint64 result;
+    std::memcpy(&result, data, sizeof(Uint64));
+    return SDL_SwapLE64(result);
+}
+
+/**
+ * Logs an error for an invalid container, and returns false
+ *
+ * @param name      The container name (may be empty)
+ * @param reason    The reason it is invalid
+ *
+ * @return false
+ */
+static bool invalid(const std::string& name, const char* reason) {
+    CULogError("Could not load %s. %s", name.empty() ? "KTX data" : name.c_str(), reason);
+    return false;
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an empty compressed image.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+CompressedImage::CompressedImage() :
+_format(0),
+_width(0),
+_height(0) {
+}
+
+/**
+ * Releases the image contents.
+ *
+ * Any level pointers are invalid after this call. This object may be
+ * safely reinitialized.
+ */
+void CompressedImage::dispose() {
+    _levels.clear();
+    _sizes.clear();
+    _file = nullptr;
+    _format = 0;
+    _width = 0;
+    _height = 0;
+    _name.clear();
+}
+
+/**
+ * Initializes this image from a container in memory.
+ *
+ * The image points into the given data, which must outlive this object.
+ *
+ * @param data  The container contents
+ * @param size  The number of bytes in the container
+ *
+ * @return true if the container is valid.
+ */
+bool CompressedImage::initWithData(const Uint8* data, size_t size) {
+    if (!_levels.empty()) {
+        CUAssertLog(false, "Image %s is already initialized", _name.c_str());
+        return false;
+    }
+
+    bool success = false;
+    if (size >= sizeof(KTX1_ID) && std::memcmp(data, KTX1_ID, sizeof(KTX1_ID)) == 0) {
+        success = parseKTX(data, size);
+    } else if (size >= sizeof(KTX2_ID) && std::memcmp(data, KTX2_ID, sizeof(KTX2_ID)) == 0) {
+        success = parseKTX2(data, size);
+    } else {
+        invalid(_name, "Not a KTX container.");
+    }
+
+    if (!success) {
+        _levels.clear();
+        _sizes.clear();
+        _format = 0;
+        _width = 0;
+        _height = 0;
+    }
+    return success;
+}
+
+/**
+ * Initializes this image from the given container file.
+ *
+ * If the file is a relative path, this method will look for the file in
+ * the application save directory {@see Application#getSaveDirectory()}.
+ * If you wish to read a file in any other directory, you must provide
+ * an absolute path.
+ *
+ * This method fails quietly if the file does not exist, but logs an
+ * error if it exists and is not valid.
+ *
+ * @param file  the path (absolute or relative) to the container
+ *
+ * @return true if the container is valid.
+ */
+bool CompressedImage::init(const std::string& file) {
+    if (!_levels.empty()) {
+        CUAssertLog(false, "Image %s is already initialized", _name.c_str());
+        return false;
+    }
+    std::shared_ptr<MappedFile> mapping = MappedFile::alloc(file);
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    _name = file;
+    if (!initWithData(mapping->data(), mapping->size())) {
+        _name.clear();
+        return false;
+    }
+    _file = mapping;
+    return true;
+}
+
+/**
+ * Initializes this image from the given container asset.
+ *
+ * This initializer assumes that the file name is a relative path. It will
+ * search the application asset directory {@see Application#getAssetDirectory()}
+ * for the file and return false if it cannot find it there.
+ *
+ * This method fails quietly if the file does not exist, but logs an
+ * error if it exists and is not valid.
+ *
+ * @param file  the relative path to the container
+ *
+ * @return true if the container is valid.
+ */
+bool CompressedImage::initWithAsset(const std::string& file) {
+    bool absolute = filetool::is_absolute(file);
+    CUAssertLog(!absolute, "This initializer does not accept absolute paths");
+    std::string path = Application::get()->getAssetDirectory();
+    path.append(file);
+    return init(path);
+}
+
+#pragma mark -
+#pragma mark Parsing
+/**
+ * Returns true if the data is a valid KTX (version 1) container.
+ *
+ * @param data  The container contents
+ * @param size  The number of bytes in the container
+ *
+ * @return true if the data is a valid KTX (version 1) container.
+ */
+bool CompressedImage::parseKTX(const Uint8* data, size_t size) {
+    if (size < KTX1_HEADER) {
+        return invalid(_name, "The header is truncated.");
+    } else if (read32(data+12) != KTX1_ENDIAN) {
+        return invalid(_name, "The container has the wrong byte order.");
+    }
+
+    Uint32 gltype   = read32(data+16);
+    Uint32 glformat = read32(data+24);
+    Uint32 internal = read32(data+28);
+    Uint32 depth    = read32(data+44);
+    Uint32 elements = read32(data+48);
+    Uint32 faces    = read32(data+52);
+    Uint32 levels   = std::max(read32(data+56), (Uint32)1);
+    Uint32 kvbytes  = read32(data+60);
+    _width  = read32(data+36);
+    _height = read32(data+40);
+
+    const BlockFormat* format = find_format(internal);
+    if (gltype != 0 || glformat != 0 || format == nullptr) {
+        return invalid(_name, "The image is not in a supported compressed format.");
+    } else if (depth > 1 || elements > 0 || faces != 1 || _width == 0 || _height == 0) {
+        return invalid(_name, "The container is not a 2D image.");
+    } else if (levels > MAX_LEVELS || (std::max(_width,_height) >> (levels-1)) == 0) {
+        return invalid(_name, "The container has too many mipmap levels.");
+    } else if (kvbytes > size-KTX1_HEADER) {
+        return invalid(_name, "The metadata is truncated.");
+    }
+    _format = format->format;
+
+    size_t offset = KTX1_HEADER+kvbytes;
+    for(Uint32 ii = 0; ii < levels; ii++) {
+        if (size-offset < sizeof(Uint32)) {
+            return invalid(_name, "The mipmap levels are truncated.");
+        }
+        size_t bytes = read32(data+offset);
+        offset += sizeof(Uint32);
+        if (bytes > size-offset) {
+            return invalid(_name, "The mipmap levels are truncated.");
+        } else if (!checkLevel(ii, bytes)) {
+            return invalid(_name, "A mipmap level has the wrong size.");
+        }
+        _levels.push_back(data+offset);
+        _sizes.push_back(bytes);
+
+        // Levels are padded to a word boundary
+        offset += std::min((bytes+3) & ~((size_t)3), size-offset);
+    }
+    return true;
+}
+
+/**
+ * Returns true if the data is a valid KTX2 container.
+ *
+ * @param data  The container contents
+ * @param size  The number of bytes in the container
+ *
+ * @return true if the data is a valid KTX2 container.
+ */
+bool CompressedImage::parseKTX2(const Uint8* data, size_t size) {
+    if (size < KTX2_HEADER) {
+        return invalid(_name, "The header is truncated.");
+    }
+
+    Uint32 vkformat = read32(data+12);
+    Uint32 depth    = read32(data+28);
+    Uint32 layers   = read32(data+32);
+    Uint32 faces    = read32(data+36);
+    Uint32 levels   = std::max(read32(data+40), (Uint32)1);
+    Uint32 scheme   = read32(data+44);
+    _width  = read32(data+20);
+    _height = read32(data+24);
+
+    const BlockFormat* format = find_vkformat(vkformat);
+    if (format == nullptr) {
+        return invalid(_name, "The image is not in a supported compressed format.");
+    } else if (scheme != 0) {
+        return invalid(_name, "Supercompressed containers are not supported.");
+    } else if (depth > 1 || layers > 1 || faces != 1 || _width == 0 || _height == 0) {
+        return invalid(_name, "The container is not a 2D image.");
+    } else if (levels > MAX_LEVELS || (std::max(_width,_height) >> (levels-1)) == 0) {
+        return invalid(_name, "The container has too many mipmap levels.");
+    } else if (size-KTX2_HEADER < (size_t)levels*KTX2_LEVEL) {
+        return invalid(_name, "The level index is truncated.");
+    }
+    _format = format->format;
+
+    for(Uint32 ii = 0; ii < levels; ii++) {
+        const Uint8* entry = data+KTX2_HEADER+ii*KTX2_LEVEL;
+        Uint64 offset = read64(entry);
+        Uint64 bytes  = read64(entry+8);
+        if (offset > size || bytes > size-offset) {
+            return invalid(_name, "The mipmap levels are truncated.");
+        } else if (!checkLevel(ii, (size_t)bytes)) {
+            return invalid(_name, "A mipmap level has the wrong size.");
+        }
+        _levels.push_back(data+offset);
+        _sizes.push_back((size_t)bytes);
+    }
+    return true;
+}
+
+/**
+ * Returns true if the given level is the correct size for the format.
+ *
+ * @param level The mipmap level
+ * @param size  The number of bytes in the level
+ *
+ * @return true if the given level is the correct size for the format.
+ */
+bool CompressedImage::checkLevel(Uint32 level, size_t size) const {
+    const BlockFormat* format = find_format(_format);
+    size_t width  = std::max(_width >> level, (Uint32)1);
+    size_t height = std::max(_height >> level, (Uint32)1);
+    size_t cols = (width+format->width-1)/format->width;
+    size_t rows = (height+format->height-1)/format->height;
+    return size == cols*rows*format->bytes;
+}
+
+#pragma mark -
+#pragma mark Attributes
+/**
+ * Returns the number of bytes in all of the mipmap levels.
+ *
+ * This is the amount of graphics memory the image uses once uploaded.
+ *
+ * @return the number of bytes in all of the mipmap levels.
+ */
+size_t CompressedImage::getByteSize() const {
+    size_t result = 0;
+    for(auto it = _sizes.begin(); it != _sizes.end(); ++it) {
+        result += *it;
+    }
+    return result;
+}
+
+/**
+ * Returns true if this image has an alpha channel.
+ *
+ * @return true if this image has an alpha channel.
+ */
+bool CompressedImage::hasAlpha() const {
+    const BlockFormat* format = find_format(_format);
+    return format != nullptr && format->alpha;
+}
+
+#pragma mark -
+#pragma mark Formats
+/**
+ * Returns the width of a block in the given format, or 0 if unsupported.
+ *
+ * The supported formats are the (linear and sRGB) variants of
+ *
+ *      GL_COMPRESSED_RGB8_ETC2
+ *      GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+ *      GL_COMPRESSED_RGBA8_ETC2_EAC
+ *      GL_COMPRESSED_RGBA_ASTC_4x4 through GL_COMPRESSED_RGBA_ASTC_12x12
+ *
+ * @param format    The OpenGL internal format
+ *
+ * @return the width of a block in the given format, or 0 if unsupported.
+ */
+Uint32 CompressedImage::getBlockWidth(GLenum format) {
+    const BlockFormat* item = find_format(format);
+    return item == nullptr ? 0 : item->width;
+}
+
+/**
+ * Returns the height of a block in the given format, or 0 if unsupported.
+ *
+ * @param format    The OpenGL internal format
+ *
+ * @return the height of a block in the given format, or 0 if unsupported.
+ */
+Uint32 CompressedImage::getBlockHeight(GLenum format) {
+    const BlockFormat* item = find_format(format);
+    return item == nullptr ? 0 : item->height;
+}
+
+/**
+ * Returns the number of bytes in a block in the given format, or 0 if unsupported.
+ *
+ * @param format    The OpenGL internal format
+ *
+ * @return the number of bytes in a block in the given format, or 0 if unsupported.
+ */
+Uint32 CompressedImage::getBlockBytes(GLenum format) {
+    const BlockFormat* item = find_format(format);
+    return item == nullptr ? 0 : item->bytes;
+}
+
+/**
+ * Returns true if the graphics card can sample the given format.
+ *
+ * This method queries the OpenGL context the first time it is called,
+ * and caches the answer. Therefore, the first call must happen on the
+ * rendering thread. Afterwards, it is safe to call from any thread.
+ *
+ * @param format    The OpenGL internal format
+ *
+ * @return true if the graphics card can sample the given format.
+ */
+bool CompressedImage::isSupported(GLenum format) {
+    static const std::vector<GLint> formats = [](void) {
+        RenderBackend* backend = RenderBackend::get();
+        GLint count = 0;
+        backend->getIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+        std::vector<GLint> result((size_t)std::max(count,0));
+        if (count > 0) {
+            backend->getIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, result.data());
+        }
+        return result;
+    }();
+    return std::find(formats.begin(), formats.end(), (GLint)format) != formats.end();
+}
@@ -6,6 +6,10 @@
 //  systems we decided to merge fonts and font atlases because it helps with
 //  asset management.
 //
+//  An atlas may also store signed distance fields instead of coverage. A
+//  distance field atlas renders cleanly at any scale, so one atlas can serve
+//  every size of the same font face.
+//
 //  This module makes heavy use of the cross-platform UTF8 utilities by
 //  Nemanja Trifunovic ( https://github.com/nemtrif/utfcpp ).
 //
@@ -45,16 +49,28 @@
 
 #include <deque>
 #include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <utf8/utf8.h>
 #include <cugl/util/CUDebug.h>
 #include <cugl/util/CUFiletools.h>
 #include <cugl/render/CUTexture.h>
 #include <cugl/render/CUFont.h>
+#include <cugl/util/CUThreadPool.h>
 
 using namespace cugl;
 
 /** The amount of border to put around a glyph to prevent bleeding. */
 #define GLYPH_BORDER    2
+/** The distance (in pixels) covered by a glyph distance field on each side */
+#define GLYPH_SPREAD    6
+/** The maximum number of pool tasks used to compute distance fields */
+#define DISTANCE_TASKS  4
+/** The initial squared distance in a distance transform */
+#define DISTANCE_INF    1e20f
 
 #pragma mark -
 #pragma mark Constructors
@@ -79,7 +95,10 @@ _style(Style::NORMAL),
 _hints(Hinting::NORMAL),
 _render(Resolution::BLENDED),
 _hasAtlas(false),
-_surface(nullptr) { }
+_surface(nullptr),
+_distance(false),
+_spread(0),
+_atlasScale(1.0f) { }
 
 /**
  * Deletes the font resources and resets all attributes.
@@ -109,6 +128,10 @@ void Font::dispose() {
     _glyphsize.clear();
     _glyphmap.clear();
     _kernmap.clear();
+    _distance = false;
+    _spread = 0;
+    _atlasScale = 1.0f;
+    _atlasSource = nullptr;
 }
 
 /**
@@ -393,6 +416,10 @@ void Font::clearAtlas() {
     _glyphsize.clear();
     _kernmap.clear();
     _hasAtlas = false;
+    _distance = false;
+    _spread = 0;
+    _atlasScale = 1.0f;
+    _atlasSource = nullptr;
 }
 
 /**
@@ -449,6 +476,269 @@ bool Font::buildAtlasAsync(const std::string charset) {
     return _hasAtlas;
 }
 
+/**
+ * Creates a signed distance field atlas for the ASCII characters in this font.
+ *
+ * Each glyph in a distance field atlas stores the distance to the glyph
+ * outline rather than its coverage. A {@link SpriteBatch} in distance
+ * field mode turns that distance back into a sharp edge at any scale.
+ * So other sizes of the same font face may share this atlas with
+ * {@link shareAtlas} instead of rasterizing their own.
+ *
+ * Computing the distance fields is much more expensive than rasterizing
+ * the glyphs. If a thread pool is provided, the glyphs are divided among
+ * its threads and the calling thread. The pool may be the one that is
+ * running this method.
+ *
+ * This method does not generate the OpenGL texture, and so it is thread
+ * safe (like {@link buildAtlasAsync}).
+ *
+ * @param threads   The thread pool to compute the distance fields
+ *
+ * @return true if the atlas was successfully created.
+ */
+bool Font::buildDistanceAtlasAsync(const std::shared_ptr<ThreadPool>& threads) {
+    clearAtlas();
+    _distance = true;
+    _spread = GLYPH_SPREAD;
+    if (buildAtlasAsync()) {
+        generateDistanceFields(threads);
+    } else {
+        clearAtlas();
+    }
+    return _hasAtlas;
+}
+
+/**
+ * Creates a signed distance field atlas for the given character set.
+ *
+ * Each glyph in a distance field atlas stores the distance to the glyph
+ * outline rather than its coverage. A {@link SpriteBatch} in distance
+ * field mode turns that distance back into a sharp edge at any scale.
+ * So other sizes of the same font face may share this atlas with
+ * {@link shareAtlas} instead of rasterizing their own.
+ *
+ * Computing the distance fields is much more expensive than rasterizing
+ * the glyphs. If a thread pool is provided, the glyphs are divided among
+ * its threads and the calling thread. The pool may be the one that is
+ * running this method.
+ *
+ * This method does not generate the OpenGL texture, and so it is thread
+ * safe (like {@link buildAtlasAsync}).
+ *
+ * @param charset   The set of characters in the atlas
+ * @param threads   The thread pool to compute the distance fields
+ *
+ * @return true if the atlas was successfully created.
+ */
+bool Font::buildDistanceAtlasAsync(const std::string charset,
+                                   const std::shared_ptr<ThreadPool>& threads) {
+    clearAtlas();
+    _distance = true;
+    _spread = GLYPH_SPREAD;
+    if (buildAtlasAsync(charset)) {
+        generateDistanceFields(threads);
+    } else {
+        clearAtlas();
+    }
+    return _hasAtlas;
+}
+
+/**
+ * Uses the distance field atlas of another font, returning true on success.
+ *
+ * The other font should have the same font file and style as this one,
+ * but it may have any size. The glyphs of the atlas are scaled to the size
+ * of this font, while the metrics and kerning still come from this font.
+ * No glyphs are rasterized, and the OpenGL texture is shared.
+ *
+ * This method fails if the other font does not have a distance field
+ * atlas. It is thread safe, provided that the other font has finished
+ * building its atlas.
+ *
+ * @param font  The font with the distance field atlas
+ *
+ * @return true if the atlas is now shared.
+ */
+bool Font::shareAtlas(const std::shared_ptr<Font>& font) {
+    if (font == nullptr || !font->_hasAtlas || !font->_distance) {
+        return false;
+    }
+    std::shared_ptr<Font> source = (font->_atlasSource == nullptr ? font : font->_atlasSource);
+    if (source.get() == this) {
+        return true;
+    }
+
+    clearAtlas();
+    _distance = true;
+    _spread = source->_spread;
+    _atlasScale = (float)_size/(float)source->_size;
+    _atlasSource = source;
+    _glyphmap = source->_glyphmap;
+    for(auto it = source->_glyphset.begin(); it != source->_glyphset.end(); ++it) {
+        _glyphset.push_back(*it);
+        _glyphsize.emplace(*it,computeMetrics(*it));
+    }
+    prepareAtlasKerning();
+    _hasAtlas = true;
+    return true;
+}
+
+/**
+ * Appends the given value to the buffer
+ *
+ * @param data  The buffer to append to
+ * @param value The value to append
+ */
+template <typename T>
+static void atlas_append(std::vector<Uint8>& data, const T& value) {
+    const Uint8* bytes = (const Uint8*)&value;
+    data.insert(data.end(), bytes, bytes+sizeof(T));
+}
+
+/**
+ * Reads a value from the buffer, returning false if it is exhausted
+ *
+ * @param data      The current position in the buffer (advanced on success)
+ * @param remain    The number of bytes left in the buffer (reduced on success)
+ * @param value     The value to store the result
+ *
+ * @return true if the value was read
+ */
+template <typename T>
+static bool atlas_read(const Uint8*& data, size_t& remain, T& value) {
+    if (remain < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    remain -= sizeof(T);
+    return true;
+}
+
+/**
+ * Stores the atlas in the given buffer, returning true on success.
+ *
+ * The buffer contains the glyph set, the glyph metrics and positions, the
+ * kerning, and the atlas image. It can be passed to {@link decodeAtlas}
+ * to restore the atlas without rasterizing any glyphs. The buffer is in
+ * native byte order, and so is not portable between devices.
+ *
+ * This method must be called after {@link buildAtlasAsync} but before
+ * the first call to {@link getAtlas()}, as it needs the atlas image.
+ * Like {@link buildAtlasAsync}, it is thread safe.
+ *
+ * @param data  The buffer to store the atlas
+ *
+ * @return true if the atlas was stored.
+ */
+bool Font::encodeAtlas(std::vector<Uint8>& data) const {
+    if (!_hasAtlas || _surface == nullptr) {
+        return false;
+    }
+    size_t count = _glyphset.size();
+    size_t rowbytes = (size_t)_surface->w*4;
+    data.clear();
+    data.reserve(5*sizeof(Uint32)+count*(sizeof(Uint32)+sizeof(Metrics)+4*sizeof(float))+
+                 count*count*sizeof(Uint32)+rowbytes*_surface->h);
+
+    atlas_append(data, (Uint32)_spread);
+    atlas_append(data, (Uint32)count);
+    for(auto it = _glyphset.begin(); it != _glyphset.end(); ++it) {
+        atlas_append(data, *it);
+        atlas_append(data, _glyphsize.at(*it));
+        // Rect is not trivially copyable, so store its four components
+        const Rect& bounds = _glyphmap.at(*it);
+        atlas_append(data, bounds.origin.x);
+        atlas_append(data, bounds.origin.y);
+        atlas_append(data, bounds.size.width);
+        atlas_append(data, bounds.size.height);
+    }
+    // Kerning is a dense matrix in glyph set order
+    for(auto it = _glyphset.begin(); it != _glyphset.end(); ++it) {
+        const std::unordered_map<Uint32, Uint32>& row = _kernmap.at(*it);
+        for(auto jt = _glyphset.begin(); jt != _glyphset.end(); ++jt) {
+            atlas_append(data, row.at(*jt));
+        }
+    }
+    atlas_append(data, (Uint32)_surface->w);
+    atlas_append(data, (Uint32)_surface->h);
+    const Uint8* pixels = (const Uint8*)_surface->pixels;
+    for(int row = 0; row < _surface->h; row++) {
+        data.insert(data.end(), pixels+row*_surface->pitch, pixels+row*_surface->pitch+rowbytes);
+    }
+    return true;
+}
+
+/**
+ * Restores an atlas stored by {@link encodeAtlas}, returning true on success.
+ *
+ * This method replaces any existing atlas. It is an alternative to
+ * {@link buildAtlasAsync}, and only valid for a font with the same file,
+ * size, style, hinting, and resolution as the one that stored the atlas.
+ * Like {@link buildAtlasAsync}, it does not create the OpenGL texture,
+ * and so it is thread safe.
+ *
+ * If the data is malformed, this method fails and the font is left with
+ * no atlas.
+ *
+ * @param data  The stored atlas
+ * @param size  The number of bytes in the stored atlas
+ *
+ * @return true if the atlas was restored.
+ */
+bool Font::decodeAtlas(const Uint8* data, size_t size) {
+    clearAtlas();
+    Uint32 spread = 0;
+    Uint32 count = 0;
+    bool success = atlas_read(data, size, spread) && atlas_read(data, size, count);
+    success = success && size/(sizeof(Uint32)+sizeof(Metrics)+4*sizeof(float)) >= count;
+    for(Uint32 ii = 0; success && ii < count; ii++) {
+        Uint32 thechar = 0;
+        Metrics metrics;
+        float x = 0, y = 0, w = 0, h = 0;
+        success = atlas_read(data, size, thechar) && atlas_read(data, size, metrics) &&
+                  atlas_read(data, size, x) && atlas_read(data, size, y) &&
+                  atlas_read(data, size, w) && atlas_read(data, size, h);
+        if (success) {
+            _glyphset.push_back(thechar);
+            _glyphsize.emplace(thechar, metrics);
+            _glyphmap.emplace(thechar, Rect(x, y, w, h));
+        }
+    }
+    success = success && size/sizeof(Uint32) >= (size_t)count*count;
+    for(auto it = _glyphset.begin(); success && it != _glyphset.end(); ++it) {
+        std::unordered_map<Uint32, Uint32>& row = _kernmap[*it];
+        for(auto jt = _glyphset.begin(); success && jt != _glyphset.end(); ++jt) {
+            Uint32 kerning = 0;
+            success = atlas_read(data, size, kerning);
+            if (success) {
+                row.emplace(*jt, kerning);
+            }
+        }
+    }
+
+    Uint32 width  = 0;
+    Uint32 height = 0;
+    success = success && atlas_read(data, size, width) && atlas_read(data, size, height);
+    success = success && width > 0 && height > 0 && size == (size_t)width*height*4;
+    if (success) {
+        _surface = allocSurface(width, height);
+        success = _surface != nullptr;
+    }
+    if (success) {
+        for(Uint32 row = 0; row < height; row++) {
+            std::memcpy((Uint8*)_surface->pixels+row*_surface->pitch, data+row*width*4, width*4);
+        }
+        _distance = spread > 0;
+        _spread = (int)spread;
+        _hasAtlas = true;
+    } else {
+        clearAtlas();
+    }
+    return _hasAtlas;
+}
+
 /**
  * Returns the OpenGL texture for the associated atlas.
  *
@@ -459,7 +749,9 @@ bool Font::buildAtlasAsync(const std::string charset) {
  * @return the OpenGL texture for the associated atlas.
  */
 const std::shared_ptr<Texture>& Font::getAtlas() {
-    if (_surface != nullptr) {
+    if (_atlasSource != nullptr) {
+        _texture = _atlasSource->getAtlas();
+    } else if (_surface != nullptr) {
         _texture = Texture::allocWithData(_surface->pixels, _surface->w, _surface->h);
         SDL_FreeSurface(_surface);
         _surface = nullptr;
@@ -959,12 +1251,15 @@ bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect rect, Mesh<Spri
     // Technically, this answer is correct
     if (!hasGlyph(thechar)) { return true; }
     
+    // Distance field glyphs are padded and may be scaled from another size
     Rect bounds = _glyphmap[thechar];
-    Rect quad(offset,bounds.size);
+    float advance = (_spread ? (float)_glyphsize[thechar].advance : bounds.size.width);
+    Vec2 corner(offset.x-_spread*_atlasScale,offset.y-_spread*_atlasScale);
+    Rect quad(corner,bounds.size*_atlasScale);
     
     // Skip over glyph, but recognize we may have later glyphs
     if (!rect.doesIntersect(quad)) {
-        offset.x += bounds.size.width;
+        offset.x += advance;
         return quad.getMaxX() <= rect.getMaxX();
     }
     
@@ -973,11 +1268,11 @@ bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect rect, Mesh<Spri
     bool result = quad.getMaxX() <= rect.getMaxX();
     
     // REMEMBER! Bounds and rect have different y-orientations.
-    bounds.origin.x += quad.origin.x-offset.x;
-    bounds.origin.y -= quad.origin.y+quad.size.height-offset.y-bounds.size.height;
+    bounds.origin.x += (quad.origin.x-corner.x)/_atlasScale;
+    bounds.origin.y -= (quad.origin.y+quad.size.height-corner.y)/_atlasScale-bounds.size.height;
     
-    offset.x += bounds.size.width;
-    bounds.size = quad.size;
+    offset.x += advance;
+    bounds.size = quad.size/_atlasScale;
     
     int width  = _texture->getWidth();
     int height = _texture->getHeight();
@@ -1330,12 +1625,15 @@ bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect rect, Mesh<Spri
     // Technically, this answer is correct
     if (!hasGlyph(thechar)) { return true; }
     
+    // Distance field glyphs are padded and may be scaled from another size
     Rect bounds = _glyphmap[thechar];
-    Rect quad(offset,bounds.size);
+    float advance = (_spread ? (float)_glyphsize[thechar].advance : bounds.size.width);
+    Vec2 corner(offset.x-_spread*_atlasScale,offset.y-_spread*_atlasScale);
+    Rect quad(corner,bounds.size*_atlasScale);
     
     // Skip over glyph, but recognize we may have later glyphs
     if (!rect.doesIntersect(quad)) {
-        offset.x += bounds.size.width;
+        offset.x += advance;
         return quad.getMaxX() <= rect.getMaxX();
     }
     
@@ -1344,11 +1642,11 @@ bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect rect, Mesh<Spri
     bool result = quad.getMaxX() <= rect.getMaxX();
     
     // REMEMBER! Bounds and rect have different y-orientations.
-    bounds.origin.x += quad.origin.x-offset.x;
-    bounds.origin.y -= quad.origin.y+quad.size.height-offset.y-bounds.size.height;
+    bounds.origin.x += (quad.origin.x-corner.x)/_atlasScale;
+    bounds.origin.y -= (quad.origin.y+quad.size.height-corner.y)/_atlasScale-bounds.size.height;
     
-    offset.x += bounds.size.width;
-    bounds.size = quad.size;
+    offset.x += advance;
+    bounds.size = quad.size/_atlasScale;
     
     int width  = _texture->getWidth();
     int height = _texture->getHeight();
@@ -1786,7 +2084,8 @@ int Font::prepareAtlas() {
         if (TTF_GlyphIsProvided(_data, (Uint16)ii)) {
             Metrics metrics = computeMetrics(ii);
             _glyphsize.emplace(ii,metrics);
-            _glyphmap.emplace(ii,Rect(0,0, (float)(metrics.advance+GLYPH_BORDER), (float)(_fontHeight+GLYPH_BORDER)));
+            _glyphmap.emplace(ii,Rect(0,0, (float)(metrics.advance+GLYPH_BORDER+2*_spread),
+                                      (float)(_fontHeight+GLYPH_BORDER+2*_spread)));
             _glyphset.push_back(ii);
             if (metrics.advance > maxwidth) {
                 maxwidth = metrics.advance;
@@ -1828,7 +2127,8 @@ int Font::prepareAtlas(std::string charset) {
         if (_glyphmap.find(thechar) == _glyphmap.end() && TTF_GlyphIsProvided(_data, (Uint16)thechar)) {
             Metrics metrics = computeMetrics(thechar);
             _glyphsize.emplace(thechar,metrics);
-            _glyphmap.emplace(thechar,Rect(0,0, (float)(metrics.advance+GLYPH_BORDER), (float)(_fontHeight+GLYPH_BORDER)));
+            _glyphmap.emplace(thechar,Rect(0,0, (float)(metrics.advance+GLYPH_BORDER+2*_spread),
+                                           (float)(_fontHeight+GLYPH_BORDER+2*_spread)));
             _glyphset.push_back(thechar);
             if (metrics.advance > maxwidth) {
                 maxwidth = metrics.advance;
@@ -1926,8 +2226,8 @@ int Font::computeKerning(Uint32 a, Uint32 b) const {
  */
 void Font::computeAtlasSize(int* width, int* height) {
     // Make enough room for largest glyph
-    *width  = nextPOT(*width+GLYPH_BORDER);
-    *height = nextPOT(_fontHeight+GLYPH_BORDER);
+    *width  = nextPOT(*width+GLYPH_BORDER+2*_spread);
+    *height = nextPOT(_fontHeight+GLYPH_BORDER+2*_spread);
     
     // Copy the glyphs to make a visited set
     int nrows  = 1;
@@ -1963,8 +2263,9 @@ void Font::computeAtlasSize(int* width, int* height) {
         bool found = false;
 		auto pos = copied.begin();
         for(auto it = copied.begin(); !found && it != copied.end(); ++it) {
-            if (_glyphsize[*it].advance < *width-used[line]) {
-                used[line] += _glyphsize[*it].advance+GLYPH_BORDER;
+            int glwidth = _glyphsize[*it].advance+2*_spread;
+            if (glwidth < *width-used[line]) {
+                used[line] += glwidth+GLYPH_BORDER;
 				pos = it;
                 found = true;
             }
@@ -2011,11 +2312,11 @@ std::vector< std::vector<Uint32> > Font::planAtlas(int width, int height) {
         
         // Find the largest glyph that will fit on line.
         bool found = false;
-        int fheight = _fontHeight+GLYPH_BORDER;
+        int fheight = _fontHeight+GLYPH_BORDER+2*_spread;
 		auto value = copied.begin();
         for(auto it = copied.begin(); !found && it != copied.end(); ++it) {
             wchar_t thechar = (wchar_t)(*it);
-            int glwidth = _glyphsize[*it].advance+GLYPH_BORDER;
+            int glwidth = _glyphsize[*it].advance+GLYPH_BORDER+2*_spread;
             if (glwidth < left) {
                 result[line].push_back(thechar);
                 _glyphmap[thechar].origin.x = (float)(width-left);
@@ -2057,7 +2358,7 @@ void Font::layoutAtlas(const std::vector< std::vector<Uint32> >& rectangle) {
     
     for(auto it = _glyphset.begin(); it != _glyphset.end(); ++it) {
 		SDL_Surface* temp = nullptr;
-        switch (_render) {
+        switch (_distance ? Resolution::BLENDED : _render) {
             case Resolution::SOLID:
                 temp = TTF_RenderGlyph_Solid(_data, *it, color);
                 break;
@@ -2073,12 +2374,12 @@ void Font::layoutAtlas(const std::vector< std::vector<Uint32> >& rectangle) {
         _glyphmap[*it].size.width  -= GLYPH_BORDER;
         _glyphmap[*it].size.height -= GLYPH_BORDER;
         
-        // Convert to SDL rects
-        dstrect.x = (int)_glyphmap[*it].origin.x;
-        dstrect.y = (int)_glyphmap[*it].origin.y;
+        // Convert to SDL rects (the glyph is centered in any distance padding)
+        dstrect.x = (int)_glyphmap[*it].origin.x+_spread;
+        dstrect.y = (int)_glyphmap[*it].origin.y+_spread;
         srcrect.x = srcrect.y = 0;
-        dstrect.w = srcrect.w = (int)_glyphmap[*it].size.width;
-        dstrect.h = srcrect.h = (int)_glyphmap[*it].size.height;
+        dstrect.w = srcrect.w = (int)_glyphmap[*it].size.width-2*_spread;
+        dstrect.h = srcrect.h = (int)_glyphmap[*it].size.height-2*_spread;
         
         // Blit on to atlas
         if (_render != Resolution::SHADED) {
@@ -2139,3 +2440,180 @@ SDL_Surface* Font::allocSurface(int width, int height) {
 }
 
 
+
+/**
+ * Computes a squared distance transform in one dimension, in place.
+ *
+ * This is the lower envelope algorithm of Felzenszwalb and Huttenlocher.
+ * The scratch buffers must have room for n values (n+1 for the boundaries).
+ *
+ * @param data      The squared distances to transform
+ * @param n         The number of values
+ * @param stride    The distance between values in the data
+ * @param f         Scratch buffer for the original values
+ * @param v         Scratch buffer for the parabola locations
+ * @param z         Scratch buffer for the parabola boundaries
+ */
+static void distance_pass(float* data, int n, int stride, float* f, int* v, float* z) {
+    for(int q = 0; q < n; q++) {
+        f[q] = data[q*stride];
+    }
+
+    int k = 0;
+    v[0] = 0;
+    z[0] = -DISTANCE_INF;
+    z[1] =  DISTANCE_INF;
+    for(int q = 1; q < n; q++) {
+        float s = ((f[q]+q*q)-(f[v[k]]+v[k]*v[k]))/(2*q-2*v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q]+q*q)-(f[v[k]]+v[k]*v[k]))/(2*q-2*v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k+1] = DISTANCE_INF;
+    }
+
+    k = 0;
+    for(int q = 0; q < n; q++) {
+        while (z[k+1] < q) {
+            k++;
+        }
+        data[q*stride] = (q-v[k])*(q-v[k])+f[v[k]];
+    }
+}
+
+/**
+ * Computes a squared distance transform in two dimensions, in place.
+ *
+ * Each value is replaced by the squared distance to the nearest value
+ * that is 0 (all other values should start as DISTANCE_INF).
+ *
+ * @param data      The squared distances to transform
+ * @param width     The number of columns
+ * @param height    The number of rows
+ */
+static void distance_transform(std::vector<float>& data, int width, int height) {
+    int n = std::max(width,height);
+    std::vector<float> f(n);
+    std::vector<float> z(n+1);
+    std::vector<int>   v(n);
+    for(int x = 0; x < width; x++) {
+        distance_pass(data.data()+x, height, width, f.data(), v.data(), z.data());
+    }
+    for(int y = 0; y < height; y++) {
+        distance_pass(data.data()+y*width, width, 1, f.data(), v.data(), z.data());
+    }
+}
+
+/**
+ * Replaces the coverage of a glyph with its signed distance field.
+ *
+ * The coverage is read from the alpha channel of the surface. The result
+ * stores 0.5 on the glyph outline, rising to 1 at spread pixels inside and
+ * falling to 0 at spread pixels outside. The color channels are set to
+ * white so the glyph may be tinted.
+ *
+ * @param surface   The atlas surface
+ * @param cell      The glyph cell, including its padding
+ * @param spread    The distance covered on each side of the outline
+ */
+static void distance_field(SDL_Surface* surface, const Rect& cell, int spread) {
+    int x0 = (int)cell.origin.x;
+    int y0 = (int)cell.origin.y;
+    int width  = (int)cell.size.width;
+    int height = (int)cell.size.height;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    // Alpha is the last byte of each pixel for either byte order (see allocSurface)
+    std::vector<float> inside(width*height);
+    std::vector<float> outside(width*height);
+    for(int y = 0; y < height; y++) {
+        const Uint8* row = (const Uint8*)surface->pixels+(y0+y)*surface->pitch+x0*4;
+        for(int x = 0; x < width; x++) {
+            bool in = row[4*x+3] >= 128;
+            inside[y*width+x]  = in ? 0 : DISTANCE_INF;
+            outside[y*width+x] = in ? DISTANCE_INF : 0;
+        }
+    }
+    distance_transform(inside, width, height);
+    distance_transform(outside, width, height);
+
+    float scale = 0.5f/spread;
+    for(int y = 0; y < height; y++) {
+        Uint8* row = (Uint8*)surface->pixels+(y0+y)*surface->pitch+x0*4;
+        for(int x = 0; x < width; x++) {
+            int pos = y*width+x;
+            float dist = (inside[pos] == 0 ? std::sqrt(outside[pos])-0.5f : 0.5f-std::sqrt(inside[pos]));
+            float value = std::min(std::max(0.5f+dist*scale,0.0f),1.0f);
+            row[4*x] = row[4*x+1] = row[4*x+2] = 255;
+            row[4*x+3] = (Uint8)(value*255.0f+0.5f);
+        }
+    }
+}
+
+/**
+ * Replaces the coverage of each glyph in the atlas with its distance field.
+ *
+ * The glyphs occupy disjoint regions of the surface, so they may be
+ * computed in parallel. If a thread pool is provided, the glyphs are
+ * divided among its threads and the calling thread. This method does
+ * not return until every glyph is done.
+ *
+ * @param threads   The thread pool to compute the distance fields
+ */
+void Font::generateDistanceFields(const std::shared_ptr<ThreadPool>& threads) {
+    if (_surface == nullptr) {
+        return;
+    }
+
+    // Shared with the pool tasks, which may outlive this call if they start late
+    struct Work {
+        SDL_Surface* surface;
+        std::vector<Rect> cells;
+        int spread;
+        std::atomic<size_t> next;
+        size_t done;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    std::shared_ptr<Work> work = std::make_shared<Work>();
+    work->surface = _surface;
+    work->spread = _spread;
+    work->next = 0;
+    work->done = 0;
+    for(auto it = _glyphset.begin(); it != _glyphset.end(); ++it) {
+        work->cells.push_back(_glyphmap[*it]);
+    }
+
+    // Glyphs are claimed one at a time, so no thread waits on a busy pool
+    auto task = [work]() {
+        size_t count = 0;
+        size_t ii;
+        while ((ii = work->next++) < work->cells.size()) {
+            distance_field(work->surface, work->cells[ii], work->spread);
+            count++;
+        }
+        if (count) {
+            std::lock_guard<std::mutex> lock(work->mutex);
+            work->done += count;
+            if (work->done == work->cells.size()) {
+                work->finished.notify_all();
+            }
+        }
+    };
+
+    if (threads != nullptr) {
+        size_t tasks = std::min((size_t)DISTANCE_TASKS,work->cells.size()/2);
+        for(size_t ii = 0; ii < tasks; ii++) {
+            threads->addTask(task);
+        }
+    }
+    task();
+
+    std::unique_lock<std::mutex> lock(work->mutex);
+    work->finished.wait(lock, [&]() { return work->done == work->cells.size(); });
+}
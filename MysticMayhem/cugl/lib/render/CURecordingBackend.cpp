@@ -0,0 +1,1529 @@
+//
+//  CURecordingBackend.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a render backend that records the graphics commands
+//  issued by the render classes. It can either forward these commands to
+//  OpenGL (to profile a running game) or drop them entirely (to exercise the
+//  render code on a machine with no graphics context). In the latter case it
+//  emulates just enough of the OpenGL state for the render classes to work:
+//  object names, bindings, and successful shader compilation.
+//
+//  The backend gathers statistics per frame. These include the number of
+//  draw calls, the number of indices drawn, buffer and texture uploads, and
+//  the number of state changes (with redundant changes counted separately).
+//  It also measures the CPU time spent between beginFrame and endFrame.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+#include <cugl/render/CURecordingBackend.h>
+#include <cugl/util/CUDebug.h>
+#include <sstream>
+#include <cstring>
+
+using namespace cugl;
+
+/** The capabilities tracked by the recording backend (in bit order) */
+static const GLenum TRACKED_CAPS[] = {
+    GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_SCISSOR_TEST, GL_STENCIL_TEST
+};
+
+/**
+ * Returns the number of bytes per pixel for the given pixel format.
+ *
+ * This is an estimate for the purpose of statistics. It assumes one byte
+ * per channel.
+ *
+ * @param format    The pixel format
+ *
+ * @return the number of bytes per pixel for the given pixel format.
+ */
+static Uint64 pixel_size(GLenum format) {
+    switch (format) {
+        case GL_RED:
+            return 1;
+        case GL_RG:
+            return 2;
+        case GL_RGB:
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+#pragma mark -
+#pragma mark Render Statistics
+/**
+ * Resets all statistics to zero.
+ */
+void RenderStats::reset() {
+    drawCalls = 0;
+    indices = 0;
+    instances = 0;
+    bufferUploads = 0;
+    bufferBytes = 0;
+    textureUploads = 0;
+    textureBytes = 0;
+    uniformUpdates = 0;
+    stateChanges = 0;
+    redundantChanges = 0;
+    clears = 0;
+    micros = 0;
+}
+
+/**
+ * Adds the given statistics to this one.
+ *
+ * @param stats The statistics to add
+ *
+ * @return this object, after modification
+ */
+RenderStats& RenderStats::operator+=(const RenderStats& stats) {
+    drawCalls += stats.drawCalls;
+    indices += stats.indices;
+    instances += stats.instances;
+    bufferUploads += stats.bufferUploads;
+    bufferBytes += stats.bufferBytes;
+    textureUploads += stats.textureUploads;
+    textureBytes += stats.textureBytes;
+    uniformUpdates += stats.uniformUpdates;
+    stateChanges += stats.stateChanges;
+    redundantChanges += stats.redundantChanges;
+    clears += stats.clears;
+    micros += stats.micros;
+    return *this;
+}
+
+/**
+ * Divides all statistics by the given number of frames.
+ *
+ * This method is used to compute the average of accumulated statistics.
+ * It does nothing if frames is 0.
+ *
+ * @param frames    The number of frames
+ *
+ * @return this object, after modification
+ */
+RenderStats& RenderStats::operator/=(Uint32 frames) {
+    if (frames == 0) {
+        return *this;
+    }
+    drawCalls /= frames;
+    indices /= frames;
+    instances /= frames;
+    bufferUploads /= frames;
+    bufferBytes /= frames;
+    textureUploads /= frames;
+    textureBytes /= frames;
+    uniformUpdates /= frames;
+    stateChanges /= frames;
+    redundantChanges /= frames;
+    clears /= frames;
+    micros /= frames;
+    return *this;
+}
+
+/**
+ * Returns a string representation of these statistics.
+ *
+ * The string is a single line, suitable for logging or for comparing
+ * the output of two benchmark runs.
+ *
+ * @return a string representation of these statistics.
+ */
+std::string RenderStats::toString() const {
+    std::stringstream ss;
+    ss << "draws=" << drawCalls;
+    ss << " indices=" << indices;
+    ss << " instances=" << instances;
+    ss << " uploads=" << bufferUploads << " (" << bufferBytes << " bytes)";
+    ss << " textures=" << textureUploads << " (" << textureBytes << " bytes)";
+    ss << " uniforms=" << uniformUpdates;
+    ss << " states=" << stateChanges;
+    ss << " redundant=" << redundantChanges;
+    ss << " clears=" << clears;
+    ss << " cpu=" << micros << "us";
+    return ss.str();
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an uninitialized recording backend.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a backend on
+ * the heap, use one of the static constructors instead.
+ */
+RecordingBackend::RecordingBackend() :
+_passthrough(false),
+_logging(false),
+_frames(0),
+_names(0),
+_caps(0),
+_program(0),
+_unit(0),
+_vertarray(0),
+_framebuffer(0),
+_blendEquation(GL_FUNC_ADD),
+_srcFactor(GL_ONE),
+_dstFactor(GL_ZERO),
+_depthFunc(GL_LESS),
+_depthMask(GL_TRUE) {
+    std::memset(_viewport, 0, sizeof(_viewport));
+    std::memset(_textures, 0, sizeof(_textures));
+    std::memset(_buffers, 0, sizeof(_buffers));
+    std::memset(_bindpoints, 0, sizeof(_bindpoints));
+}
+
+/**
+ * Disposes all of the resources used by this backend.
+ *
+ * A disposed backend can be safely reinitialized.
+ */
+void RecordingBackend::dispose() {
+    _passthrough = false;
+    _logging = false;
+    _log.clear();
+    _locations.clear();
+    resetStats();
+    _names = 0;
+    _caps = 0;
+    _program = 0;
+    _unit = 0;
+    _vertarray = 0;
+    _framebuffer = 0;
+    _blendEquation = GL_FUNC_ADD;
+    _srcFactor = GL_ONE;
+    _dstFactor = GL_ZERO;
+    _depthFunc = GL_LESS;
+    _depthMask = GL_TRUE;
+    std::memset(_viewport, 0, sizeof(_viewport));
+    std::memset(_textures, 0, sizeof(_textures));
+    std::memset(_buffers, 0, sizeof(_buffers));
+    std::memset(_bindpoints, 0, sizeof(_bindpoints));
+}
+
+/**
+ * Initializes a recording backend.
+ *
+ * If passthrough is true, every command is forwarded to OpenGL after it
+ * is recorded. Otherwise, the commands are dropped and the backend can
+ * be used without a graphics context.
+ *
+ * @param passthrough   Whether to forward commands to OpenGL
+ *
+ * @return true if initialization was successful.
+ */
+bool RecordingBackend::init(bool passthrough) {
+    _passthrough = passthrough;
+    if (passthrough) {
+        // Start from the actual state so redundancy is measured correctly
+        RenderBackend::getIntegerv(GL_VIEWPORT, _viewport);
+    }
+    _start.mark();
+    return true;
+}
+
+#pragma mark -
+#pragma mark Statistics
+/**
+ * Starts a new frame.
+ *
+ * This resets the statistics (and log) of the current frame and marks
+ * the start of the CPU time measurement.
+ */
+void RecordingBackend::beginFrame() {
+    _current.reset();
+    _log.clear();
+    _start.mark();
+}
+
+/**
+ * Completes the current frame.
+ *
+ * The statistics of the current frame are measured and added to the
+ * accumulated statistics.
+ */
+void RecordingBackend::endFrame() {
+    Timestamp end;
+    _current.micros = Timestamp::ellapsedMicros(_start, end);
+    _last = _current;
+    _total += _current;
+    _frames++;
+}
+
+/**
+ * Returns the average statistics per completed frame.
+ *
+ * @return the average statistics per completed frame.
+ */
+RenderStats RecordingBackend::getAverageStats() const {
+    RenderStats result = _total;
+    result /= _frames;
+    return result;
+}
+
+/**
+ * Resets all statistics, including the frame count.
+ */
+void RecordingBackend::resetStats() {
+    _current.reset();
+    _last.reset();
+    _total.reset();
+    _frames = 0;
+}
+
+#pragma mark -
+#pragma mark Command Log
+/**
+ * Sets whether this backend keeps a log of the commands.
+ *
+ * The log is cleared at the start of every frame. It is off by default,
+ * as it adds some overhead to every command.
+ *
+ * @param value Whether this backend keeps a log of the commands.
+ */
+void RecordingBackend::setLogging(bool value) {
+    _logging = value;
+    if (!value) {
+        _log.clear();
+    }
+}
+
+/**
+ * Returns the command log as a string, with one command per line.
+ *
+ * @return the command log as a string, with one command per line.
+ */
+std::string RecordingBackend::getTrace() const {
+    std::stringstream ss;
+    for(auto it = _log.begin(); it != _log.end(); ++it) {
+        ss << it->name << " " << it->value << "\n";
+    }
+    return ss.str();
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Returns true if the given capability is enabled.
+ *
+ * Capabilities not tracked by this backend are always reported as
+ * disabled, so that every change to them counts as a state change.
+ *
+ * @param cap   The capability to query
+ *
+ * @return true if the given capability is enabled.
+ */
+bool RecordingBackend::capability(GLenum cap) const {
+    for(size_t ii = 0; ii < sizeof(TRACKED_CAPS)/sizeof(GLenum); ii++) {
+        if (TRACKED_CAPS[ii] == cap) {
+            return (_caps & (1 << ii)) != 0;
+        }
+    }
+    return false;
+}
+
+/**
+ * Sets whether the given capability is enabled.
+ *
+ * @param cap   The capability to modify
+ * @param value Whether the capability is enabled
+ */
+void RecordingBackend::setCapability(GLenum cap, bool value) {
+    for(size_t ii = 0; ii < sizeof(TRACKED_CAPS)/sizeof(GLenum); ii++) {
+        if (TRACKED_CAPS[ii] == cap) {
+            if (value) {
+                _caps |= (1 << ii);
+            } else {
+                _caps &= ~(1 << ii);
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * Returns the binding slot for the given buffer target.
+ *
+ * This method returns nullptr if the target is not tracked.
+ *
+ * @param target    The buffer target
+ *
+ * @return the binding slot for the given buffer target.
+ */
+GLuint* RecordingBackend::bufferSlot(GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER:
+            return _buffers;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            return _buffers+1;
+        case GL_UNIFORM_BUFFER:
+            return _buffers+2;
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * Returns the emulated location of the given uniform or attribute.
+ *
+ * Locations are assigned by name, in the order they are first queried.
+ *
+ * @param name  The uniform or attribute name
+ *
+ * @return the emulated location of the given uniform or attribute.
+ */
+GLint RecordingBackend::location(const GLchar* name) {
+    std::string key(name);
+    auto it = _locations.find(key);
+    if (it != _locations.end()) {
+        return it->second;
+    }
+    GLint result = (GLint)_locations.size();
+    _locations.emplace(key, result);
+    return result;
+}
+
+#pragma mark -
+#pragma mark Object Management
+
+/**
+ * Generates buffer object names.
+ *
+ * This method mirrors {@code glGenBuffers}.
+ */
+void RecordingBackend::genBuffers(GLsizei n, GLuint* buffers) {
+    if (_passthrough) {
+        RenderBackend::genBuffers(n, buffers);
+    } else {
+        for(GLsizei ii = 0; ii < n; ii++) {
+            buffers[ii] = ++_names;
+        }
+    }
+}
+
+/**
+ * Deletes the named buffer objects.
+ *
+ * This method mirrors {@code glDeleteBuffers}.
+ */
+void RecordingBackend::deleteBuffers(GLsizei n, const GLuint* buffers) {
+    if (_passthrough) {
+        RenderBackend::deleteBuffers(n, buffers);
+    }
+}
+
+/**
+ * Generates vertex array object names.
+ *
+ * This method mirrors {@code glGenVertexArrays}.
+ */
+void RecordingBackend::genVertexArrays(GLsizei n, GLuint* arrays) {
+    if (_passthrough) {
+        RenderBackend::genVertexArrays(n, arrays);
+    } else {
+        for(GLsizei ii = 0; ii < n; ii++) {
+            arrays[ii] = ++_names;
+        }
+    }
+}
+
+/**
+ * Deletes the named vertex array objects.
+ *
+ * This method mirrors {@code glDeleteVertexArrays}.
+ */
+void RecordingBackend::deleteVertexArrays(GLsizei n, const GLuint* arrays) {
+    if (_passthrough) {
+        RenderBackend::deleteVertexArrays(n, arrays);
+    }
+}
+
+/**
+ * Generates texture names.
+ *
+ * This method mirrors {@code glGenTextures}.
+ */
+void RecordingBackend::genTextures(GLsizei n, GLuint* textures) {
+    if (_passthrough) {
+        RenderBackend::genTextures(n, textures);
+    } else {
+        for(GLsizei ii = 0; ii < n; ii++) {
+            textures[ii] = ++_names;
+        }
+    }
+}
+
+/**
+ * Deletes the named textures.
+ *
+ * This method mirrors {@code glDeleteTextures}.
+ */
+void RecordingBackend::deleteTextures(GLsizei n, const GLuint* textures) {
+    if (_passthrough) {
+        RenderBackend::deleteTextures(n, textures);
+    }
+}
+
+/**
+ * Generates framebuffer object names.
+ *
+ * This method mirrors {@code glGenFramebuffers}.
+ */
+void RecordingBackend::genFramebuffers(GLsizei n, GLuint* framebuffers) {
+    if (_passthrough) {
+        RenderBackend::genFramebuffers(n, framebuffers);
+    } else {
+        for(GLsizei ii = 0; ii < n; ii++) {
+            framebuffers[ii] = ++_names;
+        }
+    }
+}
+
+/**
+ * Deletes the named framebuffer objects.
+ *
+ * This method mirrors {@code glDeleteFramebuffers}.
+ */
+void RecordingBackend::deleteFramebuffers(GLsizei n, const GLuint* framebuffers) {
+    if (_passthrough) {
+        RenderBackend::deleteFramebuffers(n, framebuffers);
+    }
+}
+
+/**
+ * Generates renderbuffer object names.
+ *
+ * This method mirrors {@code glGenRenderbuffers}.
+ */
+void RecordingBackend::genRenderbuffers(GLsizei n, GLuint* renderbuffers) {
+    if (_passthrough) {
+        RenderBackend::genRenderbuffers(n, renderbuffers);
+    } else {
+        for(GLsizei ii = 0; ii < n; ii++) {
+            renderbuffers[ii] = ++_names;
+        }
+    }
+}
+
+/**
+ * Deletes the named renderbuffer objects.
+ *
+ * This method mirrors {@code glDeleteRenderbuffers}.
+ */
+void RecordingBackend::deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) {
+    if (_passthrough) {
+        RenderBackend::deleteRenderbuffers(n, renderbuffers);
+    }
+}
+
+
+#pragma mark -
+#pragma mark State Queries
+
+/**
+ * Returns (and clears) the current error flag.
+ *
+ * This method mirrors {@code glGetError}.
+ */
+GLenum RecordingBackend::getError() {
+    return _passthrough ? RenderBackend::getError() : GL_NO_ERROR;
+}
+
+/**
+ * Returns the value of the given integer parameter.
+ *
+ * This method mirrors {@code glGetIntegerv}.
+ */
+void RecordingBackend::getIntegerv(GLenum pname, GLint* data) {
+    if (_passthrough) {
+        RenderBackend::getIntegerv(pname, data);
+        return;
+    }
+    switch (pname) {
+        case GL_VIEWPORT:
+            for(int ii = 0; ii < 4; ii++) {
+                data[ii] = _viewport[ii];
+            }
+            break;
+        case GL_CURRENT_PROGRAM:
+            *data = (GLint)_program;
+            break;
+        case GL_ACTIVE_TEXTURE:
+            *data = (GLint)(GL_TEXTURE0+_unit);
+            break;
+        case GL_TEXTURE_BINDING_2D:
+            *data = (GLint)_textures[_unit];
+            break;
+        case GL_ARRAY_BUFFER_BINDING:
+            *data = (GLint)_buffers[0];
+            break;
+        case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+            *data = (GLint)_buffers[1];
+            break;
+        case GL_UNIFORM_BUFFER_BINDING:
+            *data = (GLint)_buffers[2];
+            break;
+        case GL_VERTEX_ARRAY_BINDING:
+            *data = (GLint)_vertarray;
+            break;
+        case GL_FRAMEBUFFER_BINDING:
+            *data = (GLint)_framebuffer;
+            break;
+        case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+            *data = 256;
+            break;
+        case GL_MAX_UNIFORM_BLOCK_SIZE:
+            *data = 16384;
+            break;
+        default:
+            *data = 0;
+    }
+}
+
+/**
+ * Returns the value of the given indexed integer parameter.
+ *
+ * This method mirrors {@code glGetIntegeri_v}.
+ */
+void RecordingBackend::getIntegeri_v(GLenum target, GLuint index, GLint* data) {
+    if (_passthrough) {
+        RenderBackend::getIntegeri_v(target, index, data);
+    } else if (target == GL_UNIFORM_BUFFER_BINDING && index < MAX_BINDPOINTS) {
+        *data = (GLint)_bindpoints[index];
+    } else {
+        *data = 0;
+    }
+}
+
+
+#pragma mark -
+#pragma mark Render State
+
+/**
+ * Enables the given server-side capability.
+ *
+ * This method mirrors {@code glEnable}.
+ */
+void RecordingBackend::enable(GLenum cap) {
+    change(!capability(cap), "glEnable", cap);
+    setCapability(cap, true);
+    if (_passthrough) {
+        RenderBackend::enable(cap);
+    }
+}
+
+/**
+ * Disables the given server-side capability.
+ *
+ * This method mirrors {@code glDisable}.
+ */
+void RecordingBackend::disable(GLenum cap) {
+    change(capability(cap), "glDisable", cap);
+    setCapability(cap, false);
+    if (_passthrough) {
+        RenderBackend::disable(cap);
+    }
+}
+
+/**
+ * Sets the blending equation.
+ *
+ * This method mirrors {@code glBlendEquation}.
+ */
+void RecordingBackend::blendEquation(GLenum mode) {
+    change(_blendEquation != mode, "glBlendEquation", mode);
+    _blendEquation = mode;
+    if (_passthrough) {
+        RenderBackend::blendEquation(mode);
+    }
+}
+
+/**
+ * Sets the blending function.
+ *
+ * This method mirrors {@code glBlendFunc}.
+ */
+void RecordingBackend::blendFunc(GLenum sfactor, GLenum dfactor) {
+    change(_srcFactor != sfactor || _dstFactor != dfactor, "glBlendFunc", sfactor);
+    _srcFactor = sfactor;
+    _dstFactor = dfactor;
+    if (_passthrough) {
+        RenderBackend::blendFunc(sfactor, dfactor);
+    }
+}
+
+/**
+ * Sets the depth comparison function.
+ *
+ * This method mirrors {@code glDepthFunc}.
+ */
+void RecordingBackend::depthFunc(GLenum func) {
+    change(_depthFunc != func, "glDepthFunc", func);
+    _depthFunc = func;
+    if (_passthrough) {
+        RenderBackend::depthFunc(func);
+    }
+}
+
+/**
+ * Enables or disables writing to the depth buffer.
+ *
+ * This method mirrors {@code glDepthMask}.
+ */
+void RecordingBackend::depthMask(GLboolean flag) {
+    change(_depthMask != flag, "glDepthMask", flag);
+    _depthMask = flag;
+    if (_passthrough) {
+        RenderBackend::depthMask(flag);
+    }
+}
+
+/**
+ * Sets the viewport.
+ *
+ * This method mirrors {@code glViewport}.
+ */
+void RecordingBackend::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    bool changed = _viewport[0] != x || _viewport[1] != y || _viewport[2] != width || _viewport[3] != height;
+    change(changed, "glViewport", width*height);
+    _viewport[0] = x;
+    _viewport[1] = y;
+    _viewport[2] = width;
+    _viewport[3] = height;
+    if (_passthrough) {
+        RenderBackend::viewport(x, y, width, height);
+    }
+}
+
+/**
+ * Sets the clear color.
+ *
+ * This method mirrors {@code glClearColor}.
+ */
+void RecordingBackend::clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+    record("glClearColor", 0);
+    if (_passthrough) {
+        RenderBackend::clearColor(red, green, blue, alpha);
+    }
+}
+
+/**
+ * Clears the given buffers of the current framebuffer.
+ *
+ * This method mirrors {@code glClear}.
+ */
+void RecordingBackend::clear(GLbitfield mask) {
+    _current.clears++;
+    record("glClear", mask);
+    if (_passthrough) {
+        RenderBackend::clear(mask);
+    }
+}
+
+
+#pragma mark -
+#pragma mark Buffers
+
+/**
+ * Binds a buffer object to the given target.
+ *
+ * This method mirrors {@code glBindBuffer}.
+ */
+void RecordingBackend::bindBuffer(GLenum target, GLuint buffer) {
+    GLuint* slot = bufferSlot(target);
+    change(slot == nullptr || *slot != buffer, "glBindBuffer", buffer);
+    if (slot) {
+        *slot = buffer;
+    }
+    if (_passthrough) {
+        RenderBackend::bindBuffer(target, buffer);
+    }
+}
+
+/**
+ * Creates and initializes the data store of the bound buffer.
+ *
+ * This method mirrors {@code glBufferData}.
+ */
+void RecordingBackend::bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    _current.bufferUploads++;
+    _current.bufferBytes += data == nullptr ? 0 : (Uint64)size;
+    record("glBufferData", size);
+    if (_passthrough) {
+        RenderBackend::bufferData(target, size, data, usage);
+    }
+}
+
+/**
+ * Updates a subset of the data store of the bound buffer.
+ *
+ * This method mirrors {@code glBufferSubData}.
+ */
+void RecordingBackend::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    _current.bufferUploads++;
+    _current.bufferBytes += (Uint64)size;
+    record("glBufferSubData", size);
+    if (_passthrough) {
+        RenderBackend::bufferSubData(target, offset, size, data);
+    }
+}
+
+/**
+ * Maps a range of the bound buffer into client memory.
+ *
+ * Without passthrough there is no buffer to map, so this returns nullptr.
+ *
+ * This method mirrors {@code glMapBufferRange}.
+ */
+void* RecordingBackend::mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    record("glMapBufferRange", length);
+    if (_passthrough) {
+        return RenderBackend::mapBufferRange(target, offset, length, access);
+    }
+    return nullptr;
+}
+
+/**
+ * Releases the mapping of the bound buffer.
+ *
+ * This method mirrors {@code glUnmapBuffer}.
+ */
+GLboolean RecordingBackend::unmapBuffer(GLenum target) {
+    record("glUnmapBuffer", 0);
+    if (_passthrough) {
+        return RenderBackend::unmapBuffer(target);
+    }
+    return GL_TRUE;
+}
+
+/**
+ * Binds a buffer object to an indexed target.
+ *
+ * This method mirrors {@code glBindBufferBase}.
+ */
+void RecordingBackend::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    bool changed = true;
+    if (target == GL_UNIFORM_BUFFER && index < MAX_BINDPOINTS) {
+        changed = _bindpoints[index] != buffer;
+        _bindpoints[index] = buffer;
+        _buffers[2] = buffer;
+    }
+    change(changed, "glBindBufferBase", buffer);
+    if (_passthrough) {
+        RenderBackend::bindBufferBase(target, index, buffer);
+    }
+}
+
+/**
+ * Binds a range of a buffer object to an indexed target.
+ *
+ * This method mirrors {@code glBindBufferRange}.
+ */
+void RecordingBackend::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    if (target == GL_UNIFORM_BUFFER && index < MAX_BINDPOINTS) {
+        _bindpoints[index] = buffer;
+        _buffers[2] = buffer;
+    }
+    change(true, "glBindBufferRange", offset);
+    if (_passthrough) {
+        RenderBackend::bindBufferRange(target, index, buffer, offset, size);
+    }
+}
+
+/**
+ * Binds a vertex array object.
+ *
+ * This method mirrors {@code glBindVertexArray}.
+ */
+void RecordingBackend::bindVertexArray(GLuint array) {
+    change(_vertarray != array, "glBindVertexArray", array);
+    _vertarray = array;
+    if (_passthrough) {
+        RenderBackend::bindVertexArray(array);
+    }
+}
+
+/**
+ * Enables the given vertex attribute array.
+ *
+ * This method mirrors {@code glEnableVertexAttribArray}.
+ */
+void RecordingBackend::enableVertexAttribArray(GLuint index) {
+    record("glEnableVertexAttribArray", index);
+    if (_passthrough) {
+        RenderBackend::enableVertexAttribArray(index);
+    }
+}
+
+/**
+ * Disables the given vertex attribute array.
+ *
+ * This method mirrors {@code glDisableVertexAttribArray}.
+ */
+void RecordingBackend::disableVertexAttribArray(GLuint index) {
+    record("glDisableVertexAttribArray", index);
+    if (_passthrough) {
+        RenderBackend::disableVertexAttribArray(index);
+    }
+}
+
+/**
+ * Defines the layout of the given vertex attribute.
+ *
+ * This method mirrors {@code glVertexAttribPointer}.
+ */
+void RecordingBackend::vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) {
+    record("glVertexAttribPointer", index);
+    if (_passthrough) {
+        RenderBackend::vertexAttribPointer(index, size, type, normalized, stride, pointer);
+    }
+}
+
+/**
+ * Sets the instance divisor of the given vertex attribute.
+ *
+ * This method mirrors {@code glVertexAttribDivisor}.
+ */
+void RecordingBackend::vertexAttribDivisor(GLuint index, GLuint divisor) {
+    record("glVertexAttribDivisor", index);
+    if (_passthrough) {
+        RenderBackend::vertexAttribDivisor(index, divisor);
+    }
+}
+
+
+#pragma mark -
+#pragma mark Drawing
+
+/**
+ * Draws primitives from the bound index buffer.
+ *
+ * This method mirrors {@code glDrawElements}.
+ */
+void RecordingBackend::drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+    _current.drawCalls++;
+    _current.indices += (Uint64)count;
+    record("glDrawElements", count);
+    if (_passthrough) {
+        RenderBackend::drawElements(mode, count, type, indices);
+    }
+}
+
+/**
+ * Draws multiple instances of primitives from the bound index buffer.
+ *
+ * This method mirrors {@code glDrawElementsInstanced}.
+ */
+void RecordingBackend::drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount) {
+    _current.drawCalls++;
+    _current.indices += (Uint64)count*(Uint64)instancecount;
+    _current.instances += (Uint64)instancecount;
+    record("glDrawElementsInstanced", instancecount);
+    if (_passthrough) {
+        RenderBackend::drawElementsInstanced(mode, count, type, indices, instancecount);
+    }
+}
+
+
+#pragma mark -
+#pragma mark Textures
+
+/**
+ * Selects the active texture unit.
+ *
+ * This method mirrors {@code glActiveTexture}.
+ */
+void RecordingBackend::activeTexture(GLenum texture) {
+    GLuint unit = texture-GL_TEXTURE0;
+    change(_unit != unit, "glActiveTexture", unit);
+    _unit = unit < MAX_TEXTURE_UNITS ? unit : 0;
+    if (_passthrough) {
+        RenderBackend::activeTexture(texture);
+    }
+}
+
+/**
+ * Binds a texture to the active texture unit.
+ *
+ * This method mirrors {@code glBindTexture}.
+ */
+void RecordingBackend::bindTexture(GLenum target, GLuint texture) {
+    change(_textures[_unit] != texture, "glBindTexture", texture);
+    _textures[_unit] = texture;
+    if (_passthrough) {
+        RenderBackend::bindTexture(target, texture);
+    }
+}
+
+/**
+ * Specifies the image of the bound texture.
+ *
+ * This method mirrors {@code glTexImage2D}.
+ */
+void RecordingBackend::texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) {
+    _current.textureUploads++;
+    _current.textureBytes += pixels == nullptr ? 0 : (Uint64)width*(Uint64)height*pixel_size(format);
+    record("glTexImage2D", width*height);
+    if (_passthrough) {
+        RenderBackend::texImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+    }
+}
+
+/**
+ * Specifies a compressed image of the bound texture.
+ *
+ * This method mirrors {@code glCompressedTexImage2D}.
+ */
+void RecordingBackend::compressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data) {
+    _current.textureUploads++;
+    _current.textureBytes += data == nullptr ? 0 : (Uint64)imageSize;
+    record("glCompressedTexImage2D", imageSize);
+    if (_passthrough) {
+        RenderBackend::compressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
+    }
+}
+
+/**
+ * Sets a parameter of the bound texture.
+ *
+ * This method mirrors {@code glTexParameteri}.
+ */
+void RecordingBackend::texParameteri(GLenum target, GLenum pname, GLint param) {
+    record("glTexParameteri", param);
+    if (_passthrough) {
+        RenderBackend::texParameteri(target, pname, param);
+    }
+}
+
+/**
+ * Generates the mipmaps of the bound texture.
+ *
+ * This method mirrors {@code glGenerateMipmap}.
+ */
+void RecordingBackend::generateMipmap(GLenum target) {
+    record("glGenerateMipmap", target);
+    if (_passthrough) {
+        RenderBackend::generateMipmap(target);
+    }
+}
+
+/**
+ * Reads back the image of the bound texture (not available in OpenGLES).
+ *
+ * This method mirrors {@code glGetTexImage}.
+ */
+void RecordingBackend::getTexImage(GLenum target, GLint level, GLenum format, GLenum type, void* pixels) {
+    if (_passthrough) {
+        RenderBackend::getTexImage(target, level, format, type, pixels);
+    }
+}
+
+
+#pragma mark -
+#pragma mark Framebuffers
+
+/**
+ * Binds a framebuffer object.
+ *
+ * This method mirrors {@code glBindFramebuffer}.
+ */
+void RecordingBackend::bindFramebuffer(GLenum target, GLuint framebuffer) {
+    change(_framebuffer != framebuffer, "glBindFramebuffer", framebuffer);
+    _framebuffer = framebuffer;
+    if (_passthrough) {
+        RenderBackend::bindFramebuffer(target, framebuffer);
+    }
+}
+
+/**
+ * Binds a renderbuffer object.
+ *
+ * This method mirrors {@code glBindRenderbuffer}.
+ */
+void RecordingBackend::bindRenderbuffer(GLenum target, GLuint renderbuffer) {
+    record("glBindRenderbuffer", renderbuffer);
+    if (_passthrough) {
+        RenderBackend::bindRenderbuffer(target, renderbuffer);
+    }
+}
+
+/**
+ * Allocates the storage of the bound renderbuffer.
+ *
+ * This method mirrors {@code glRenderbufferStorage}.
+ */
+void RecordingBackend::renderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) {
+    record("glRenderbufferStorage", width*height);
+    if (_passthrough) {
+        RenderBackend::renderbufferStorage(target, internalformat, width, height);
+    }
+}
+
+/**
+ * Attaches a texture to the bound framebuffer.
+ *
+ * This method mirrors {@code glFramebufferTexture2D}.
+ */
+void RecordingBackend::framebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) {
+    record("glFramebufferTexture2D", texture);
+    if (_passthrough) {
+        RenderBackend::framebufferTexture2D(target, attachment, textarget, texture, level);
+    }
+}
+
+/**
+ * Attaches a renderbuffer to the bound framebuffer.
+ *
+ * This method mirrors {@code glFramebufferRenderbuffer}.
+ */
+void RecordingBackend::framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) {
+    record("glFramebufferRenderbuffer", renderbuffer);
+    if (_passthrough) {
+        RenderBackend::framebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
+    }
+}
+
+/**
+ * Sets the draw buffers of the bound framebuffer.
+ *
+ * This method mirrors {@code glDrawBuffers}.
+ */
+void RecordingBackend::drawBuffers(GLsizei n, const GLenum* bufs) {
+    record("glDrawBuffers", n);
+    if (_passthrough) {
+        RenderBackend::drawBuffers(n, bufs);
+    }
+}
+
+/**
+ * Returns the completeness status of the bound framebuffer.
+ *
+ * This method mirrors {@code glCheckFramebufferStatus}.
+ */
+GLenum RecordingBackend::checkFramebufferStatus(GLenum target) {
+    return _passthrough ? RenderBackend::checkFramebufferStatus(target) : GL_FRAMEBUFFER_COMPLETE;
+}
+
+
+#pragma mark -
+#pragma mark Shader Programs
+
+/**
+ * Creates an empty program object.
+ *
+ * This method mirrors {@code glCreateProgram}.
+ */
+GLuint RecordingBackend::createProgram() {
+    return _passthrough ? RenderBackend::createProgram() : ++_names;
+}
+
+/**
+ * Creates an empty shader object.
+ *
+ * This method mirrors {@code glCreateShader}.
+ */
+GLuint RecordingBackend::createShader(GLenum type) {
+    return _passthrough ? RenderBackend::createShader(type) : ++_names;
+}
+
+/**
+ * Sets the source code of the given shader.
+ *
+ * This method mirrors {@code glShaderSource}.
+ */
+void RecordingBackend::shaderSource(GLuint shader, GLsizei count, const GLchar* const* sources, const GLint* length) {
+    if (_passthrough) {
+        RenderBackend::shaderSource(shader, count, sources, length);
+    }
+}
+
+/**
+ * Compiles the given shader.
+ *
+ * This method mirrors {@code glCompileShader}.
+ */
+void RecordingBackend::compileShader(GLuint shader) {
+    record("glCompileShader", shader);
+    if (_passthrough) {
+        RenderBackend::compileShader(shader);
+    }
+}
+
+/**
+ * Attaches a shader to the given program.
+ *
+ * This method mirrors {@code glAttachShader}.
+ */
+void RecordingBackend::attachShader(GLuint program, GLuint shader) {
+    if (_passthrough) {
+        RenderBackend::attachShader(program, shader);
+    }
+}
+
+/**
+ * Links the given program.
+ *
+ * This method mirrors {@code glLinkProgram}.
+ */
+void RecordingBackend::linkProgram(GLuint program) {
+    record("glLinkProgram", program);
+    if (_passthrough) {
+        RenderBackend::linkProgram(program);
+    }
+}
+
+/**
+ * Deletes the given shader object.
+ *
+ * This method mirrors {@code glDeleteShader}.
+ */
+void RecordingBackend::deleteShader(GLuint shader) {
+    if (_passthrough) {
+        RenderBackend::deleteShader(shader);
+    }
+}
+
+/**
+ * Installs the given program as part of the current render state.
+ *
+ * This method mirrors {@code glUseProgram}.
+ */
+void RecordingBackend::useProgram(GLuint program) {
+    change(_program != program, "glUseProgram", program);
+    _program = program;
+    if (_passthrough) {
+        RenderBackend::useProgram(program);
+    }
+}
+
+/**
+ * Returns true if the name is a shader object.
+ *
+ * This method mirrors {@code glIsShader}.
+ */
+GLboolean RecordingBackend::isShader(GLuint shader) {
+    return _passthrough ? RenderBackend::isShader(shader) : (GLboolean)(shader != 0);
+}
+
+/**
+ * Returns true if the name is a program object.
+ *
+ * This method mirrors {@code glIsProgram}.
+ */
+GLboolean RecordingBackend::isProgram(GLuint program) {
+    return _passthrough ? RenderBackend::isProgram(program) : (GLboolean)(program != 0);
+}
+
+/**
+ * Returns a parameter of the given shader.
+ *
+ * This method mirrors {@code glGetShaderiv}.
+ */
+void RecordingBackend::getShaderiv(GLuint shader, GLenum pname, GLint* params) {
+    if (_passthrough) {
+        RenderBackend::getShaderiv(shader, pname, params);
+    } else {
+        *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+    }
+}
+
+/**
+ * Returns a parameter of the given program.
+ *
+ * This method mirrors {@code glGetProgramiv}.
+ */
+void RecordingBackend::getProgramiv(GLuint program, GLenum pname, GLint* params) {
+    if (_passthrough) {
+        RenderBackend::getProgramiv(program, pname, params);
+    } else {
+        *params = pname == GL_LINK_STATUS ? GL_TRUE : 0;
+    }
+}
+
+/**
+ * Returns the information log of the given shader.
+ *
+ * This method mirrors {@code glGetShaderInfoLog}.
+ */
+void RecordingBackend::getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    if (_passthrough) {
+        RenderBackend::getShaderInfoLog(shader, bufSize, length, infoLog);
+    } else {
+        if (length) {
+            *length = 0;
+        }
+        if (bufSize > 0) {
+            infoLog[0] = 0;
+        }
+    }
+}
+
+/**
+ * Returns the information log of the given program.
+ *
+ * This method mirrors {@code glGetProgramInfoLog}.
+ */
+void RecordingBackend::getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    if (_passthrough) {
+        RenderBackend::getProgramInfoLog(program, bufSize, length, infoLog);
+    } else {
+        if (length) {
+            *length = 0;
+        }
+        if (bufSize > 0) {
+            infoLog[0] = 0;
+        }
+    }
+}
+
+/**
+ * Returns information about an active attribute.
+ *
+ * This method mirrors {@code glGetActiveAttrib}.
+ */
+void RecordingBackend::getActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name) {
+    if (_passthrough) {
+        RenderBackend::getActiveAttrib(program, index, bufSize, length, size, type, name);
+    } else {
+        if (length) {
+            *length = 0;
+        }
+        if (bufSize > 0) {
+            name[0] = 0;
+        }
+    }
+}
+
+/**
+ * Returns information about an active uniform.
+ *
+ * This method mirrors {@code glGetActiveUniform}.
+ */
+void RecordingBackend::getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name) {
+    if (_passthrough) {
+        RenderBackend::getActiveUniform(program, index, bufSize, length, size, type, name);
+    } else {
+        if (length) {
+            *length = 0;
+        }
+        if (bufSize > 0) {
+            name[0] = 0;
+        }
+    }
+}
+
+/**
+ * Returns the name of an active uniform block.
+ *
+ * This method mirrors {@code glGetActiveUniformBlockName}.
+ */
+void RecordingBackend::getActiveUniformBlockName(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name) {
+    if (_passthrough) {
+        RenderBackend::getActiveUniformBlockName(program, index, bufSize, length, name);
+    } else {
+        if (length) {
+            *length = 0;
+        }
+        if (bufSize > 0) {
+            name[0] = 0;
+        }
+    }
+}
+
+/**
+ * Returns a parameter of an active uniform block.
+ *
+ * This method mirrors {@code glGetActiveUniformBlockiv}.
+ */
+void RecordingBackend::getActiveUniformBlockiv(GLuint program, GLuint index, GLenum pname, GLint* params) {
+    if (_passthrough) {
+        RenderBackend::getActiveUniformBlockiv(program, index, pname, params);
+    } else {
+        *params = 0;
+    }
+}
+
+/**
+ * Returns the location of the given attribute.
+ *
+ * This method mirrors {@code glGetAttribLocation}.
+ */
+GLint RecordingBackend::getAttribLocation(GLuint program, const GLchar* name) {
+    return _passthrough ? RenderBackend::getAttribLocation(program, name) : location(name);
+}
+
+/**
+ * Returns the location of the given uniform.
+ *
+ * This method mirrors {@code glGetUniformLocation}.
+ */
+GLint RecordingBackend::getUniformLocation(GLuint program, const GLchar* name) {
+    return _passthrough ? RenderBackend::getUniformLocation(program, name) : location(name);
+}
+
+/**
+ * Returns the location of the given fragment output.
+ *
+ * This method mirrors {@code glGetFragDataLocation}.
+ */
+GLint RecordingBackend::getFragDataLocation(GLuint program, const GLchar* name) {
+    return _passthrough ? RenderBackend::getFragDataLocation(program, name) : 0;
+}
+
+/**
+ * Returns the index of the given uniform block.
+ *
+ * This method mirrors {@code glGetUniformBlockIndex}.
+ */
+GLuint RecordingBackend::getUniformBlockIndex(GLuint program, const GLchar* name) {
+    return _passthrough ? RenderBackend::getUniformBlockIndex(program, name) : GL_INVALID_INDEX;
+}
+
+/**
+ * Assigns a bind point to a uniform block.
+ *
+ * This method mirrors {@code glUniformBlockBinding}.
+ */
+void RecordingBackend::uniformBlockBinding(GLuint program, GLuint index, GLuint binding) {
+    record("glUniformBlockBinding", binding);
+    if (_passthrough) {
+        RenderBackend::uniformBlockBinding(program, index, binding);
+    }
+}
+
+
+#pragma mark -
+#pragma mark Uniforms
+/**
+ * Sets the value of a float uniform (or uniform array).
+ *
+ * @param location      The uniform location
+ * @param components    The number of components (1 to 4)
+ * @param count         The number of array elements
+ * @param value         The uniform value
+ */
+void RecordingBackend::uniformfv(GLint location, GLint components, GLsizei count, const GLfloat* value) {
+    _current.uniformUpdates++;
+    record("glUniformfv", location);
+    if (_passthrough) {
+        RenderBackend::uniformfv(location, components, count, value);
+    }
+}
+
+/**
+ * Sets the value of an int uniform (or uniform array).
+ *
+ * @param location      The uniform location
+ * @param components    The number of components (1 to 4)
+ * @param count         The number of array elements
+ * @param value         The uniform value
+ */
+void RecordingBackend::uniformiv(GLint location, GLint components, GLsizei count, const GLint* value) {
+    _current.uniformUpdates++;
+    record("glUniformiv", location);
+    if (_passthrough) {
+        RenderBackend::uniformiv(location, components, count, value);
+    }
+}
+
+/**
+ * Sets the value of an unsigned int uniform (or uniform array).
+ *
+ * @param location      The uniform location
+ * @param components    The number of components (1 to 4)
+ * @param count         The number of array elements
+ * @param value         The uniform value
+ */
+void RecordingBackend::uniformuiv(GLint location, GLint components, GLsizei count, const GLuint* value) {
+    _current.uniformUpdates++;
+    record("glUniformuiv", location);
+    if (_passthrough) {
+        RenderBackend::uniformuiv(location, components, count, value);
+    }
+}
+
+/**
+ * Sets the value of a matrix uniform (or uniform array).
+ *
+ * @param location      The uniform location
+ * @param columns       The number of matrix columns (2 to 4)
+ * @param rows          The number of matrix rows (2 to 4)
+ * @param count         The number of array elements
+ * @param transpose     Whether to transpose the matrix
+ * @param value         The uniform value
+ */
+void RecordingBackend::uniformMatrixfv(GLint location, GLint columns, GLint rows, GLsizei count,
+                                       GLboolean transpose, const GLfloat* value) {
+    _current.uniformUpdates++;
+    record("glUniformMatrixfv", location);
+    if (_passthrough) {
+        RenderBackend::uniformMatrixfv(location, columns, rows, count, transpose, value);
+    }
+}
+
+/**
+ * Returns the value of a float uniform.
+ *
+ * Uniform values are not emulated, so this method leaves params unchanged
+ * unless this backend is a passthrough.
+ */
+void RecordingBackend::getUniformfv(GLuint program, GLint location, GLfloat* params) {
+    if (_passthrough) {
+        RenderBackend::getUniformfv(program, location, params);
+    }
+}
+
+/**
+ * Returns the value of an int uniform.
+ *
+ * Uniform values are not emulated, so this method leaves params unchanged
+ * unless this backend is a passthrough.
+ */
+void RecordingBackend::getUniformiv(GLuint program, GLint location, GLint* params) {
+    if (_passthrough) {
+        RenderBackend::getUniformiv(program, location, params);
+    }
+}
+
+/**
+ * Returns the value of an unsigned int uniform.
+ *
+ * Uniform values are not emulated, so this method leaves params unchanged
+ * unless this backend is a passthrough.
+ */
+void RecordingBackend::getUniformuiv(GLuint program, GLint location, GLuint* params) {
+    if (_passthrough) {
+        RenderBackend::getUniformuiv(program, location, params);
+    }
+}
@@ -0,0 +1,945 @@
+//
+//  CURenderBackend.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an indirection layer between the render classes and
+//  OpenGL. Every OpenGL call made by SpriteBatch, VertexBuffer, UniformBuffer,
+//  Shader, Texture, and RenderTarget goes through the active backend. The
+//  default backend simply forwards each call to OpenGL. However, the backend
+//  can be swapped out for one that records (or ignores) these calls. This
+//  allows the render code to be exercised and measured on a machine with no
+//  graphics context.
+//
+//  The methods of this class mirror the OpenGL functions of the same name
+//  (minus the gl prefix), so that they have the same semantics. The uniform
+//  setters are the exception. They are funneled through four generic methods
+//  so that a backend does not need to override each variant separately.
+//
+//  This class is a singleton in spirit, but it is not managed by the
+//  shared-pointer architecture. The active backend is accessed with the
+//  static method get(), which is cheap enough to call for every command.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+#include <cugl/render/CURenderBackend.h>
+#include <cugl/util/CUDebug.h>
+
+using namespace cugl;
+
+/**
+ * Returns the default backend, which forwards to OpenGL.
+ *
+ * The backend is allocated on first use and never deleted.
+ *
+ * @return the default backend, which forwards to OpenGL.
+ */
+static RenderBackend* hardware() {
+    static RenderBackend* backend = new RenderBackend();
+    return backend;
+}
+
+/** The active backend (never nullptr) */
+RenderBackend* RenderBackend::_active = hardware();
+/** The owner of the active backend (nullptr for the OpenGL backend) */
+std::shared_ptr<RenderBackend> RenderBackend::_owner = nullptr;
+
+#pragma mark Backend Management
+/**
+ * Sets the active render backend.
+ *
+ * If backend is nullptr, this restores the default OpenGL backend. This
+ * method should only be called when there are no live graphics objects,
+ * as the object names are not shared between backends.
+ *
+ * @param backend   The new render backend
+ */
+void RenderBackend::set(const std::shared_ptr<RenderBackend>& backend) {
+    _owner  = backend;
+    _active = backend == nullptr ? hardware() : backend.get();
+}
+
+#pragma mark -
+#pragma mark Object Management
+
+/**
+ * Generates buffer object names.
+ *
+ * This method mirrors {@code glGenBuffers}.
+ */
+void RenderBackend::genBuffers(GLsizei n, GLuint* buffers) {
+    glGenBuffers(n, buffers);
+}
+
+/**
+ * Deletes the named buffer objects.
+ *
+ * This method mirrors {@code glDeleteBuffers}.
+ */
+void RenderBackend::deleteBuffers(GLsizei n, const GLuint* buffers) {
+    glDeleteBuffers(n, buffers);
+}
+
+/**
+ * Generates vertex array object names.
+ *
+ * This method mirrors {@code glGenVertexArrays}.
+ */
+void RenderBackend::genVertexArrays(GLsizei n, GLuint* arrays) {
+    glGenVertexArrays(n, arrays);
+}
+
+/**
+ * Deletes the named vertex array objects.
+ *
+ * This method mirrors {@code glDeleteVertexArrays}.
+ */
+void RenderBackend::deleteVertexArrays(GLsizei n, const GLuint* arrays) {
+    glDeleteVertexArrays(n, arrays);
+}
+
+/**
+ * Generates texture names.
+ *
+ * This method mirrors {@code glGenTextures}.
+ */
+void RenderBackend::genTextures(GLsizei n, GLuint* textures) {
+    glGenTextures(n, textures);
+}
+
+/**
+ * Deletes the named textures.
+ *
+ * This method mirrors {@code glDeleteTextures}.
+ */
+void RenderBackend::deleteTextures(GLsizei n, const GLuint* textures) {
+    glDeleteTextures(n, textures);
+}
+
+/**
+ * Generates framebuffer object names.
+ *
+ * This method mirrors {@code glGenFramebuffers}.
+ */
+void RenderBackend::genFramebuffers(GLsizei n, GLuint* framebuffers) {
+    glGenFramebuffers(n, framebuffers);
+}
+
+/**
+ * Deletes the named framebuffer objects.
+ *
+ * This method mirrors {@code glDeleteFramebuffers}.
+ */
+void RenderBackend::deleteFramebuffers(GLsizei n, const GLuint* framebuffers) {
+    glDeleteFramebuffers(n, framebuffers);
+}
+
+/**
+ * Generates renderbuffer object names.
+ *
+ * This method mirrors {@code glGenRenderbuffers}.
+ */
+void RenderBackend::genRenderbuffers(GLsizei n, GLuint* renderbuffers) {
+    glGenRenderbuffers(n, renderbuffers);
+}
+
+/**
+ * Deletes the named renderbuffer objects.
+ *
+ * This method mirrors {@code glDeleteRenderbuffers}.
+ */
+void RenderBackend::deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) {
+    glDeleteRenderbuffers(n, renderbuffers);
+}
+
+
+#pragma mark -
+#pragma mark State Queries
+
+/**
+ * Returns (and clears) the current error flag.
+ *
+ * This method mirrors {@code glGetError}.
+ */
+GLenum RenderBackend::getError() {
+    return glGetError();
+}
+
+/**
+ * Returns the value of the given integer parameter.
+ *
+ * This method mirrors {@code glGetIntegerv}.
+ */
+void RenderBackend::getIntegerv(GLenum pname, GLint* data) {
+    glGetIntegerv(pname, data);
+}
+
+/**
+ * Returns the value of the given indexed integer parameter.
+ *
+ * This method mirrors {@code glGetIntegeri_v}.
+ */
+void RenderBackend::getIntegeri_v(GLenum target, GLuint index, GLint* data) {
+    glGetIntegeri_v(target, index, data);
+}
+
+
+#pragma mark -
+#pragma mark Render State
+
+/**
+ * Enables the given server-side capability.
+ *
+ * This method mirrors {@code glEnable}.
+ */
+void RenderBackend::enable(GLenum cap) {
+    glEnable(cap);
+}
+
+/**
+ * Disables the given server-side capability.
+ *
+ * This method mirrors {@code glDisable}.
+ */
+void RenderBackend::disable(GLenum cap) {
+    glDisable(cap);
+}
+
+/**
+ * Sets the blending equation.
+ *
+ * This method mirrors {@code glBlendEquation}.
+ */
+void RenderBackend::blendEquation(GLenum mode) {
+    glBlendEquation(mode);
+}
+
+/**
+ * Sets the blending function.
+ *
+ * This method mirrors {@code glBlendFunc}.
+ */
+void RenderBackend::blendFunc(GLenum sfactor, GLenum dfactor) {
+    glBlendFunc(sfactor, dfactor);
+}
+
+/**
+ * Sets the depth comparison function.
+ *
+ * This method mirrors {@code glDepthFunc}.
+ */
+void RenderBackend::depthFunc(GLenum func) {
+    glDepthFunc(func);
+}
+
+/**
+ * Enables or disables writing to the depth buffer.
+ *
+ * This method mirrors {@code glDepthMask}.
+ */
+void RenderBackend::depthMask(GLboolean flag) {
+    glDepthMask(flag);
+}
+
+/**
+ * Sets the viewport.
+ *
+ * This method mirrors {@code glViewport}.
+ */
+void RenderBackend::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    glViewport(x, y, width, height);
+}
+
+/**
+ * Sets the clear color.
+ *
+ * This method mirrors {@code glClearColor}.
+ */
+void RenderBackend::clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+    glClearColor(red, green, blue, alpha);
+}
+
+/**
+ * Clears the given buffers of the current framebuffer.
+ *
+ * This method mirrors {@code glClear}.
+ */
+void RenderBackend::clear(GLbitfield mask) {
+    glClear(mask);
+}
+
+
+#pragma mark -
+#pragma mark Buffers
+
+/**
+ * Binds a buffer object to the given target.
+ *
+ * This method mirrors {@code glBindBuffer}.
+ */
+void RenderBackend::bindBuffer(GLenum target, GLuint buffer) {
+    glBindBuffer(target, buffer);
+}
+
+/**
+ * Creates and initializes the data store of the bound buffer.
+ *
+ * This method mirrors {@code glBufferData}.
+ */
+void RenderBackend::bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    glBufferData(target, size, data, usage);
+}
+
+/**
+ * Updates a subset of the data store of the bound buffer.
+ *
+ * This method mirrors {@code glBufferSubData}.
+ */
+void RenderBackend::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    glBufferSubData(target, offset, size, data);
+}
+
+/**
+ * Maps a range of the bound buffer into client memory.
+ *
+ * The pointer may be written from any thread, but the buffer must be
+ * unmapped (on the rendering thread) before OpenGL uses it. A backend
+ * without a graphics context may return nullptr.
+ *
+ * This method mirrors {@code glMapBufferRange}.
+ */
+void* RenderBackend::mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    return glMapBufferRange(target, offset, length, access);
+}
+
+/**
+ * Releases the mapping of the bound buffer.
+ *
+ * This method mirrors {@code glUnmapBuffer}.
+ */
+GLboolean RenderBackend::unmapBuffer(GLenum target) {
+    return glUnmapBuffer(target);
+}
+
+/**
+ * Binds a buffer object to an indexed target.
+ *
+ * This method mirrors {@code glBindBufferBase}.
+ */
+void RenderBackend::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    glBindBufferBase(target, index, buffer);
+}
+
+/**
+ * Binds a range of a buffer object to an indexed target.
+ *
+ * This method mirrors {@code glBindBufferRange}.
+ */
+void RenderBackend::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    glBindBufferRange(target, index, buffer, offset, size);
+}
+
+/**
+ * Binds a vertex array object.
+ *
+ * This method mirrors {@code glBindVertexArray}.
+ */
+void RenderBackend::bindVertexArray(GLuint array) {
+    glBindVertexArray(array);
+}
+
+/**
+ * Enables the given vertex attribute array.
+ *
+ * This method mirrors {@code glEnableVertexAttribArray}.
+ */
+void RenderBackend::enableVertexAttribArray(GLuint index) {
+    glEnableVertexAttribArray(index);
+}
+
+/**
+ * Disables the given vertex attribute array.
+ *
+ * This method mirrors {@code glDisableVertexAttribArray}.
+ */
+void RenderBackend::disableVertexAttribArray(GLuint index) {
+    glDisableVertexAttribArray(index);
+}
+
+/**
+ * Defines the layout of the given vertex attribute.
+ *
+ * This method mirrors {@code glVertexAttribPointer}.
+ */
+void RenderBackend::vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) {
+    glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+}
+
+/**
+ * Sets the instance divisor of the given vertex attribute.
+ *
+ * This method mirrors {@code glVertexAttribDivisor}.
+ */
+void RenderBackend::vertexAttribDivisor(GLuint index, GLuint divisor) {
+    glVertexAttribDivisor(index, divisor);
+}
+
+
+#pragma mark -
+#pragma mark Drawing
+
+/**
+ * Draws primitives from the bound index buffer.
+ *
+ * This method mirrors {@code glDrawElements}.
+ */
+void RenderBackend::drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+    glDrawElements(mode, count, type, indices);
+}
+
+/**
+ * Draws multiple instances of primitives from the bound index buffer.
+ *
+ * This method mirrors {@code glDrawElementsInstanced}.
+ */
+void RenderBackend::drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount) {
+    glDrawElementsInstanced(mode, count, type, indices, instancecount);
+}
+
+
+#pragma mark -
+#pragma mark Textures
+
+/**
+ * Selects the active texture unit.
+ *
+ * This method mirrors {@code glActiveTexture}.
+ */
+void RenderBackend::activeTexture(GLenum texture) {
+    glActiveTexture(texture);
+}
+
+/**
+ * Binds a texture to the active texture unit.
+ *
+ * This method mirrors {@code glBindTexture}.
+ */
+void RenderBackend::bindTexture(GLenum target, GLuint texture) {
+    glBindTexture(target, texture);
+}
+
+/**
+ * Specifies the image of the bound texture.
+ *
+ * This method mirrors {@code glTexImage2D}.
+ */
+void RenderBackend::texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) {
+    glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+}
+
+/**
+ * Specifies a compressed image of the bound texture.
+ *
+ * This method mirrors {@code glCompressedTexImage2D}.
+ */
+void RenderBackend::compressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data) {
+    glCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
+}
+
+/**
+ * Sets a parameter of the bound texture.
+ *
+ * This method mirrors {@code glTexParameteri}.
+ */
+void RenderBackend::texParameteri(GLenum target, GLenum pname, GLint param) {
+    glTexParameteri(target, pname, param);
+}
+
+/**
+ * Generates the mipmaps of the bound texture.
+ *
+ * This method mirrors {@code glGenerateMipmap}.
+ */
+void RenderBackend::generateMipmap(GLenum target) {
+    glGenerateMipmap(target);
+}
+
+/**
+ * Reads back the image of the bound texture (not available in OpenGLES).
+ *
+ * This method mirrors {@code glGetTexImage}.
+ */
+void RenderBackend::getTexImage(GLenum target, GLint level, GLenum format, GLenum type, void* pixels) {
+#if CU_GL_PLATFORM == CU_GL_OPENGLES
+    CUAssertLog(false, "Texture read back is not supported in OpenGLES");
+#else
+    glGetTexImage(target, level, format, type, pixels);
+#endif
+}
+
+
+#pragma mark -
+#pragma mark Framebuffers
+
+/**
+ * Binds a framebuffer object.
+ *
+ * This method mirrors {@code glBindFramebuffer}.
+ */
+void RenderBackend::bindFramebuffer(GLenum target, GLuint framebuffer) {
+    glBindFramebuffer(target, framebuffer);
+}
+
+/**
+ * Binds a renderbuffer object.
+ *
+ * This method mirrors {@code glBindRenderbuffer}.
+ */
+void RenderBackend::bindRenderbuffer(GLenum target, GLuint renderbuffer) {
+    glBindRenderbuffer(target, renderbuffer);
+}
+
+/**
+ * Allocates the storage of the bound renderbuffer.
+ *
+ * This method mirrors {@code glRenderbufferStorage}.
+ */
+void RenderBackend::renderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) {
+    glRenderbufferStorage(target, internalformat, width, height);
+}
+
+/**
+ * Attaches a texture to the bound framebuffer.
+ *
+ * This method mirrors {@code glFramebufferTexture2D}.
+ */
+void RenderBackend::framebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) {
+    glFramebufferTexture2D(target, attachment, textarget, texture, level);
+}
+
+/**
+ * Attaches a renderbuffer to the bound framebuffer.
+ *
+ * This method mirrors {@code glFramebufferRenderbuffer}.
+ */
+void RenderBackend::framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) {
+    glFramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
+}
+
+/**
+ * Sets the draw buffers of the bound framebuffer.
+ *
+ * This method mirrors {@code glDrawBuffers}.
+ */
+void RenderBackend::drawBuffers(GLsizei n, const GLenum* bufs) {
+    glDrawBuffers(n, bufs);
+}
+
+/**
+ * Returns the completeness status of the bound framebuffer.
+ *
+ * This method mirrors {@code glCheckFramebufferStatus}.
+ */
+GLenum RenderBackend::checkFramebufferStatus(GLenum target) {
+    return glCheckFramebufferStatus(target);
+}
+
+
+#pragma mark -
+#pragma mark Shader Programs
+
+/**
+ * Creates an empty program object.
+ *
+ * This method mirrors {@code glCreateProgram}.
+ */
+GLuint RenderBackend::createProgram() {
+    return glCreateProgram();
+}
+
+/**
+ * Creates an empty shader object.
+ *
+ * This method mirrors {@code glCreateShader}.
+ */
+GLuint RenderBackend::createShader(GLenum type) {
+    return glCreateShader(type);
+}
+
+/**
+ * Sets the source code of the given shader.
+ *
+ * This method mirrors {@code glShaderSource}.
+ */
+void RenderBackend::shaderSource(GLuint shader, GLsizei count, const GLchar* const* sources, const GLint* length) {
+    glShaderSource(shader, count, sources, length);
+}
+
+/**
+ * Compiles the given shader.
+ *
+ * This method mirrors {@code glCompileShader}.
+ */
+void RenderBackend::compileShader(GLuint shader) {
+    glCompileShader(shader);
+}
+
+/**
+ * Attaches a shader to the given program.
+ *
+ * This method mirrors {@code glAttachShader}.
+ */
+void RenderBackend::attachShader(GLuint program, GLuint shader) {
+    glAttachShader(program, shader);
+}
+
+/**
+ * Links the given program.
+ *
+ * This method mirrors {@code glLinkProgram}.
+ */
+void RenderBackend::linkProgram(GLuint program) {
+    glLinkProgram(program);
+}
+
+/**
+ * Deletes the given shader object.
+ *
+ * This method mirrors {@code glDeleteShader}.
+ */
+void RenderBackend::deleteShader(GLuint shader) {
+    glDeleteShader(shader);
+}
+
+/**
+ * Installs the given program as part of the current render state.
+ *
+ * This method mirrors {@code glUseProgram}.
+ */
+void RenderBackend::useProgram(GLuint program) {
+    glUseProgram(program);
+}
+
+/**
+ * Returns true if the name is a shader object.
+ *
+ * This method mirrors {@code glIsShader}.
+ */
+GLboolean RenderBackend::isShader(GLuint shader) {
+    return glIsShader(shader);
+}
+
+/**
+ * Returns true if the name is a program object.
+ *
+ * This method mirrors {@code glIsProgram}.
+ */
+GLboolean RenderBackend::isProgram(GLuint program) {
+    return glIsProgram(program);
+}
+
+/**
+ * Returns a parameter of the given shader.
+ *
+ * This method mirrors {@code glGetShaderiv}.
+ */
+void RenderBackend::getShaderiv(GLuint shader, GLenum pname, GLint* params) {
+    glGetShaderiv(shader, pname, params);
+}
+
+/**
+ * Returns a parameter of the given program.
+ *
+ * This method mirrors {@code glGetProgramiv}.
+ */
+void RenderBackend::getProgramiv(GLuint program, GLenum pname, GLint* params) {
+    glGetProgramiv(program, pname, params);
+}
+
+/**
+ * Returns the information log of the given shader.
+ *
+ * This method mirrors {@code glGetShaderInfoLog}.
+ */
+void RenderBackend::getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    glGetShaderInfoLog(shader, bufSize, length, infoLog);
+}
+
+/**
+ * Returns the information log of the given program.
+ *
+ * This method mirrors {@code glGetProgramInfoLog}.
+ */
+void RenderBackend::getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    glGetProgramInfoLog(program, bufSize, length, infoLog);
+}
+
+/**
+ * Returns information about an active attribute.
+ *
+ * This method mirrors {@code glGetActiveAttrib}.
+ */
+void RenderBackend::getActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name) {
+    glGetActiveAttrib(program, index, bufSize, length, size, type, name);
+}
+
+/**
+ * Returns information about an active uniform.
+ *
+ * This method mirrors {@code glGetActiveUniform}.
+ */
+void RenderBackend::getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name) {
+    glGetActiveUniform(program, index, bufSize, length, size, type, name);
+}
+
+/**
+ * Returns the name of an active uniform block.
+ *
+ * This method mirrors {@code glGetActiveUniformBlockName}.
+ */
+void RenderBackend::getActiveUniformBlockName(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name) {
+    glGetActiveUniformBlockName(program, index, bufSize, length, name);
+}
+
+/**
+ * Returns a parameter of an active uniform block.
+ *
+ * This method mirrors {@code glGetActiveUniformBlockiv}.
+ */
+void RenderBackend::getActiveUniformBlockiv(GLuint program, GLuint index, GLenum pname, GLint* params) {
+    glGetActiveUniformBlockiv(program, index, pname, params);
+}
+
+/**
+ * Returns the location of the given attribute.
+ *
+ * This method mirrors {@code glGetAttribLocation}.
+ */
+GLint RenderBackend::getAttribLocation(GLuint program, const GLchar* name) {
+    return glGetAttribLocation(program, name);
+}
+
+/**
+ * Returns the location of the given uniform.
+ *
+ * This method mirrors {@code glGetUniformLocation}.
+ */
+GLint RenderBackend::getUniformLocation(GLuint program, const GLchar* name) {
+    return glGetUniformLocation(program, name);
+}
+
+/**
+ * Returns the location of the given fragment output.
+ *
+ * This method mirrors {@code glGetFragDataLocation}.
+ */
+GLint RenderBackend::getFragDataLocation(GLuint program, const GLchar* name) {
+    return glGetFragDataLocation(program, name);
+}
+
+/**
+ * Returns the index of the given uniform block.
+ *
+ * This method mirrors {@code glGetUniformBlockIndex}.
+ */
+GLuint RenderBackend::getUniformBlockIndex(GLuint program, const GLchar* name) {
+    return glGetUniformBlockIndex(program, name);
+}
+
+/**
+ * Assigns a bind point to a uniform block.
+ *
+ * This method mirrors {@code glUniformBlockBinding}.
+ */
+void RenderBackend::uniformBlockBinding(GLuint program, GLuint index, GLuint binding) {
+    glUniformBlockBinding(program, index, binding);
+}
+
+
+#pragma mark -
+#pragma mark Uniforms
+/**
+ * Sets the value of a float uniform (or uniform array).
+ *
+ * The value of components is the vector size, from 1 to 4. This method
+ * stands in for {@code glUniform1fv} through {@code glUniform4fv}. All of
+ * the float uniform setters below are funneled through this method.
+ *
+ * @param location      The uniform location
+ * @param components    The number of components (1 to 4)
+ * @param count         The number of array elements
+ * @param value         The uniform value
+ */
+void RenderBackend::uniformfv(GLint location, GLint components, GLsizei count, const GLfloat* value) {
+    switch (components) {
+        case 1:
+            glUniform1fv(location, count, value);
+            break;
+        case 2:
+            glUniform2fv(location, count, value);
+            break;
+        case 3:
+            glUniform3fv(location, count, value);
+            break;
+        case 4:
+            glUniform4fv(location, count, value);
+            break;
+        default:
+            CUAssertLog(false, "Invalid uniform size %d", components);
+    }
+}
+
+/**
+ * Sets the value of an int uniform (or uniform array).
+ *
+ * The value of components is the vector size, from 1 to 4. This method
+ * stands in for {@code glUniform1iv} through {@code glUniform4iv}. All of
+ * the int uniform setters below are funneled through this method.
+ *
+ * @param location      The uniform location
+ * @param components    The number of components (1 to 4)
+ * @param count         The number of array elements
+ * @param value         The uniform value
+ */
+void RenderBackend::uniformiv(GLint location, GLint components, GLsizei count, const GLint* value) {
+    switch (components) {
+        case 1:
+            glUniform1iv(location, count, value);
+            break;
+        case 2:
+            glUniform2iv(location, count, value);
+            break;
+        case 3:
+            glUniform3iv(location, count, value);
+            break;
+        case 4:
+            glUniform4iv(location, count, value);
+            break;
+        default:
+            CUAssertLog(false, "Invalid uniform size %d", components);
+    }
+}
+
+/**
+ * Sets the value of an unsigned int uniform (or uniform array).
+ *
+ * The value of components is the vector size, from 1 to 4. This method
+ * stands in for {@code glUniform1uiv} through {@code glUniform4uiv}. All
+ * of the unsigned uniform setters below are funneled through this method.
+ *
+ * @param location      The uniform location
+ * @param components    The number of components (1 to 4)
+ * @param count         The number of array elements
+ * @param value         The uniform value
+ */
+void RenderBackend::uniformuiv(GLint location, GLint components, GLsizei count, const GLuint* value) {
+    switch (components) {
+        case 1:
+            glUniform1uiv(location, count, value);
+            break;
+        case 2:
+            glUniform2uiv(location, count, value);
+            break;
+        case 3:
+            glUniform3uiv(location, count, value);
+            break;
+        case 4:
+            glUniform4uiv(location, count, value);
+            break;
+        default:
+            CUAssertLog(false, "Invalid uniform size %d", components);
+    }
+}
+
+/**
+ * Sets the value of a matrix uniform (or uniform array).
+ *
+ * The matrix dimensions are given as columns by rows, following the
+ * OpenGL naming scheme (so {@code glUniformMatrix2x3fv} has 2 columns and
+ * 3 rows). This method stands in for all of the matrix uniform setters.
+ *
+ * @param location      The uniform location
+ * @param columns       The number of matrix columns (2 to 4)
+ * @param rows          The number of matrix rows (2 to 4)
+ * @param count         The number of array elements
+ * @param transpose     Whether to transpose the matrix
+ * @param value         The uniform value
+ */
+void RenderBackend::uniformMatrixfv(GLint location, GLint columns, GLint rows, GLsizei count,
+                                    GLboolean transpose, const GLfloat* value) {
+    switch (columns*10+rows) {
+        case 22:
+            glUniformMatrix2fv(location, count, transpose, value);
+            break;
+        case 23:
+            glUniformMatrix2x3fv(location, count, transpose, value);
+            break;
+        case 24:
+            glUniformMatrix2x4fv(location, count, transpose, value);
+            break;
+        case 32:
+            glUniformMatrix3x2fv(location, count, transpose, value);
+            break;
+        case 33:
+            glUniformMatrix3fv(location, count, transpose, value);
+            break;
+        case 34:
+            glUniformMatrix3x4fv(location, count, transpose, value);
+            break;
+        case 42:
+            glUniformMatrix4x2fv(location, count, transpose, value);
+            break;
+        case 43:
+            glUniformMatrix4x3fv(location, count, transpose, value);
+            break;
+        case 44:
+            glUniformMatrix4fv(location, count, transpose, value);
+            break;
+        default:
+            CUAssertLog(false, "Invalid matrix size %dx%d", columns, rows);
+    }
+}
+
+/**
+ * Returns the value of a float uniform.
+ *
+ * This method mirrors {@code glGetUniformfv}.
+ */
+void RenderBackend::getUniformfv(GLuint program, GLint location, GLfloat* params) {
+    glGetUniformfv(program, location, params);
+}
+
+/**
+ * Returns the value of an int uniform.
+ *
+ * This method mirrors {@code glGetUniformiv}.
+ */
+void RenderBackend::getUniformiv(GLuint program, GLint location, GLint* params) {
+    glGetUniformiv(program, location, params);
+}
+
+/**
+ * Returns the value of an unsigned int uniform.
+ *
+ * This method mirrors {@code glGetUniformuiv}.
+ */
+void RenderBackend::getUniformuiv(GLuint program, GLint location, GLuint* params) {
+    glGetUniformuiv(program, location, params);
+}
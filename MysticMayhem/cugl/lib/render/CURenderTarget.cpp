@@ -42,6 +42,7 @@
 
 #include <cugl/render/CURenderTarget.h>
 #include <cugl/render/CUTexture.h>
+#include <cugl/render/CURenderBackend.h>
 #include <cugl/base/CUDisplay.h>
 #include <cugl/util/CUDebug.h>
 
@@ -61,21 +62,21 @@ using namespace cugl;
  * @return true if initialization was successful.
  */
 bool RenderTarget::prepareBuffer() {
-    glGetIntegerv(GL_VIEWPORT, _viewport);
+    RenderBackend::get()->getIntegerv(GL_VIEWPORT, _viewport);
     
     GLenum error;
-    glGenFramebuffers(1, &_framebo);
+    RenderBackend::get()->genFramebuffers(1, &_framebo);
     if (!_framebo) {
-        error = glGetError();
+        error = RenderBackend::get()->getError();
         CULogError("Could not create frame buffer. %s", gl_error_name(error).c_str());
         return false;
     }
     
-    glBindFramebuffer(GL_FRAMEBUFFER, _framebo);
+    RenderBackend::get()->bindFramebuffer(GL_FRAMEBUFFER, _framebo);
 
     // Attach the depth buffer first
     _depthst = Texture::alloc(_width,_height,Texture::PixelFormat::DEPTH_STENCIL);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+    RenderBackend::get()->framebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
                            GL_TEXTURE_2D,  _depthst->getBuffer(), 0);
     if (_depthst == nullptr) {
         dispose();
@@ -83,20 +84,20 @@ bool RenderTarget::prepareBuffer() {
         return false;
     }
     
-    glGenRenderbuffers(1, &_renderbo);
+    RenderBackend::get()->genRenderbuffers(1, &_renderbo);
     if (!_renderbo) {
-        error = glGetError();
+        error = RenderBackend::get()->getError();
         CULogError("Could not create render buffer. %s", gl_error_name(error).c_str());
         dispose();
         Display::get()->restoreRenderTarget();
         return false;
     }
     
-    glBindRenderbuffer(GL_RENDERBUFFER, _renderbo);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, _width, _height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+    RenderBackend::get()->bindRenderbuffer(GL_RENDERBUFFER, _renderbo);
+    RenderBackend::get()->renderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, _width, _height);
+    RenderBackend::get()->framebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
                               GL_RENDERBUFFER, _renderbo);
-    error = glGetError();
+    error = RenderBackend::get()->getError();
     if (error) {
         CULogError("Could not attach render buffer to frame buffer. %s",
                    gl_error_name(error).c_str());
@@ -134,9 +135,9 @@ bool RenderTarget::attachTexture(GLuint index, Texture::PixelFormat format) {
         Display::get()->restoreRenderTarget();
         return false;
     }
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0+(GLint)index,
+    RenderBackend::get()->framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0+(GLint)index,
                            GL_TEXTURE_2D,  texture->getBuffer(), 0);
-    error = glGetError();
+    error = RenderBackend::get()->getError();
     if (error) {
         CULogError("Could not attach output textures to frame buffer. %s",
                    gl_error_name(error).c_str());
@@ -159,8 +160,8 @@ bool RenderTarget::attachTexture(GLuint index, Texture::PixelFormat format) {
  * @return true if the framebuffer was successfully finalized.
  */
 bool RenderTarget::completeBuffer() {
-    glDrawBuffers((int)_outsize, _bindpoints.data());
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    RenderBackend::get()->drawBuffers((int)_outsize, _bindpoints.data());
+    GLenum status = RenderBackend::get()->checkFramebufferStatus(GL_FRAMEBUFFER);
     if (status != GL_FRAMEBUFFER_COMPLETE) {
         CULogError("Could not bind frame buffer. %s",
                    gl_error_name(status).c_str());
@@ -389,11 +390,11 @@ bool RenderTarget::init(int width, int height, Texture::PixelFormat* outputs, si
  */
 void RenderTarget::dispose() {
     if (_framebo) {
-        glDeleteFramebuffers(1, &_framebo);
+        RenderBackend::get()->deleteFramebuffers(1, &_framebo);
         _framebo = 0;
     }
     if (_renderbo) {
-        glDeleteRenderbuffers(1, &_renderbo);
+        RenderBackend::get()->deleteRenderbuffers(1, &_renderbo);
         _renderbo = 0;
     }
     _outputs.clear();
@@ -435,13 +436,13 @@ const std::shared_ptr<Texture>& RenderTarget::getTexture(size_t index) const {
  * return control to the default render target (the screen) when done.
  */
 void RenderTarget::begin() {
-    glGetIntegerv(GL_VIEWPORT, _viewport);
-    glBindFramebuffer(GL_FRAMEBUFFER, _framebo);
+    RenderBackend::get()->getIntegerv(GL_VIEWPORT, _viewport);
+    RenderBackend::get()->bindFramebuffer(GL_FRAMEBUFFER, _framebo);
     //glBindRenderbuffer(GL_RENDERBUFFER, _renderbo);
 
-    glViewport(0, 0, _width, _height);
-    glClearColor(_clearcol.r, _clearcol.g, _clearcol.b, _clearcol.a);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    RenderBackend::get()->viewport(0, 0, _width, _height);
+    RenderBackend::get()->clearColor(_clearcol.r, _clearcol.g, _clearcol.b, _clearcol.a);
+    RenderBackend::get()->clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 }
 
 /**
@@ -456,6 +457,6 @@ void RenderTarget::begin() {
  */
 void RenderTarget::end() {
     Display::get()->restoreRenderTarget();
-    glViewport(_viewport[0], _viewport[1], _viewport[2], _viewport[3]);
+    RenderBackend::get()->viewport(_viewport[0], _viewport[1], _viewport[2], _viewport[3]);
 }
 
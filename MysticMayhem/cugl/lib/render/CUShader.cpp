@@ -33,6 +33,7 @@
 #include <cugl/util/CUStrings.h>
 #include <cugl/render/CUShader.h>
 #include <cugl/render/CUTexture.h>
+#include <cugl/render/CURenderBackend.h>
 
 using namespace cugl;
 
@@ -67,17 +68,17 @@ bool Shader::compile() {
     CUAssertLog(!_fragSource.empty(), "Fragment shader source is not defined");
     CUAssertLog(!_program,   "This shader is already compiled");
     
-    _program = glCreateProgram();
+    _program = RenderBackend::get()->createProgram();
     if (!_program) {
         CULogError("Unable to allocate shader program");
         return false;
     }
     
     //Create vertex shader and compile it
-    _vertShader = glCreateShader( GL_VERTEX_SHADER );
+    _vertShader = RenderBackend::get()->createShader( GL_VERTEX_SHADER );
     const char* source = _vertSource.c_str();
-    glShaderSource( _vertShader, 1, &source, nullptr );
-    glCompileShader( _vertShader );
+    RenderBackend::get()->shaderSource( _vertShader, 1, &source, nullptr );
+    RenderBackend::get()->compileShader( _vertShader );
     
     // Validate and quit if failed
     if (!validateShader(_vertShader, "vertex")) {
@@ -86,10 +87,10 @@ bool Shader::compile() {
     }
 
     //Create fragment shader and compile it
-    _fragShader = glCreateShader( GL_FRAGMENT_SHADER );
+    _fragShader = RenderBackend::get()->createShader( GL_FRAGMENT_SHADER );
     source = _fragSource.c_str();
-    glShaderSource( _fragShader, 1, &source, nullptr );
-    glCompileShader( _fragShader );
+    RenderBackend::get()->shaderSource( _fragShader, 1, &source, nullptr );
+    RenderBackend::get()->compileShader( _fragShader );
     
     // Validate and quit if failed
     if (!validateShader(_fragShader, "fragment")) {
@@ -98,13 +99,13 @@ bool Shader::compile() {
     }
     
     // Now kiss
-    glAttachShader( _program, _vertShader );
-    glAttachShader( _program, _fragShader );
-    glLinkProgram( _program );
+    RenderBackend::get()->attachShader( _program, _vertShader );
+    RenderBackend::get()->attachShader( _program, _fragShader );
+    RenderBackend::get()->linkProgram( _program );
     
     //Check for errors
     GLint programSuccess = GL_TRUE;
-    glGetProgramiv( _program, GL_LINK_STATUS, &programSuccess );
+    RenderBackend::get()->getProgramiv( _program, GL_LINK_STATUS, &programSuccess );
     if( programSuccess != GL_TRUE ) {
         CULogError( "Unable to link program %d.\n", _program );
         logProgramError(_program);
@@ -121,10 +122,10 @@ bool Shader::compile() {
  * You must reinitialize the shader to use it.
  */
 void Shader::dispose() {
-    glUseProgram(NULL);
-    if (_fragShader) { glDeleteShader(_fragShader); _fragShader = 0;}
-    if (_vertShader) { glDeleteShader(_vertShader); _vertShader = 0;}
-    if (_program) { glDeleteShader(_program); _program = 0;}
+    RenderBackend::get()->useProgram(0);
+    if (_fragShader) { RenderBackend::get()->deleteShader(_fragShader); _fragShader = 0;}
+    if (_vertShader) { RenderBackend::get()->deleteShader(_vertShader); _vertShader = 0;}
+    if (_program) { RenderBackend::get()->deleteShader(_program); _program = 0;}
     _vertSource.clear();
     _fragSource.clear();
 
@@ -150,9 +151,9 @@ void Shader::dispose() {
  * @return true if the shader was compiled properly.
  */
 bool Shader::validateShader(GLuint shader, const std::string type) {
-    CUAssertLog( glIsShader( shader ), "Shader %d is not a valid shader", shader);
+    CUAssertLog( RenderBackend::get()->isShader( shader ), "Shader %d is not a valid shader", shader);
     GLint shaderCompiled = GL_FALSE;
-    glGetShaderiv( shader, GL_COMPILE_STATUS, &shaderCompiled );
+    RenderBackend::get()->getShaderiv( shader, GL_COMPILE_STATUS, &shaderCompiled );
     if( shaderCompiled != GL_TRUE ) {
         CULogError( "Unable to compile %s shader %d.\n", type.c_str(), shader );
         logShaderError(shader);
@@ -169,7 +170,7 @@ bool Shader::validateShader(GLuint shader, const std::string type) {
  * @param shader    The shader to test
  */
 void Shader::logShaderError(GLuint shader) {
-    CUAssertLog( glIsShader( shader ), "Shader %d is not a valid shader", shader);
+    CUAssertLog( RenderBackend::get()->isShader( shader ), "Shader %d is not a valid shader", shader);
     //Make sure name is shader
 
     //Shader log length
@@ -177,13 +178,13 @@ void Shader::logShaderError(GLuint shader) {
     int maxLength = infoLogLength;
         
     //Get info string length
-    glGetShaderiv( shader, GL_INFO_LOG_LENGTH, &maxLength );
+    RenderBackend::get()->getShaderiv( shader, GL_INFO_LOG_LENGTH, &maxLength );
         
     //Allocate string
     char* infoLog = new char[ maxLength ];
         
     //Get info log
-    glGetShaderInfoLog( shader, maxLength, &infoLogLength, infoLog );
+    RenderBackend::get()->getShaderInfoLog( shader, maxLength, &infoLogLength, infoLog );
     if( infoLogLength > 0 ) {
         // Print Log
         CULog( "%s\n", infoLog );
@@ -201,20 +202,20 @@ void Shader::logShaderError(GLuint shader) {
  * @param shader    The program to test
  */
 void Shader::logProgramError( GLuint program ) {
-    CUAssertLog( glIsProgram( program ), "Program %d is not a valid program", program);
+    CUAssertLog( RenderBackend::get()->isProgram( program ), "Program %d is not a valid program", program);
 
     //Program log length
     int infoLogLength = 0;
     int maxLength = infoLogLength;
         
     //Get info string length
-    glGetProgramiv( program, GL_INFO_LOG_LENGTH, &maxLength );
+    RenderBackend::get()->getProgramiv( program, GL_INFO_LOG_LENGTH, &maxLength );
         
     //Allocate string
     char* infoLog = new char[ maxLength ];
         
     //Get info log
-    glGetProgramInfoLog( program, maxLength, &infoLogLength, infoLog );
+    RenderBackend::get()->getProgramInfoLog( program, maxLength, &infoLogLength, infoLog );
     if( infoLogLength > 0 ) {
         // Print Log
         CULogError( "%s\n", infoLog );
@@ -237,10 +238,10 @@ void Shader::cacheAttributes() {
     GLchar name[bufSize];       // variable name in GLSL
     GLsizei length;             // name length
     
-    glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTES, &count);
+    RenderBackend::get()->getProgramiv(_program, GL_ACTIVE_ATTRIBUTES, &count);
     for (GLuint ii = 0; ii < count; ii++) {
-        glGetActiveAttrib(_program, ii, bufSize, &length, &size, &type, name);
-        GLenum error = glGetError();
+        RenderBackend::get()->getActiveAttrib(_program, ii, bufSize, &length, &size, &type, name);
+        GLenum error = RenderBackend::get()->getError();
         if (!error) {
             std::string key(name);
             _attribtypes[key] = type;
@@ -265,10 +266,10 @@ void Shader::cacheUniforms() {
     GLchar name[bufSize];       // variable name in GLSL
     GLsizei length;             // name length
     
-    glGetProgramiv(_program, GL_ACTIVE_UNIFORMS, &count);
+    RenderBackend::get()->getProgramiv(_program, GL_ACTIVE_UNIFORMS, &count);
     for (GLuint ii = 0; ii < count; ii++) {
-        glGetActiveUniform(_program, ii, bufSize, &length, &size, &type, name);
-        GLenum error = glGetError();
+        RenderBackend::get()->getActiveUniform(_program, ii, bufSize, &length, &size, &type, name);
+        GLenum error = RenderBackend::get()->getError();
         if (!error) {
             std::string key(name);
             _uniformtypes[key] = type;
@@ -277,20 +278,20 @@ void Shader::cacheUniforms() {
         }
     }
     
-    glGetProgramiv(_program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    RenderBackend::get()->getProgramiv(_program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
     for (GLuint ii = 0; ii < count; ii++) {
-        glGetActiveUniformBlockName(_program, ii, bufSize, &length, name);
-        GLenum error = glGetError();
+        RenderBackend::get()->getActiveUniformBlockName(_program, ii, bufSize, &length, name);
+        GLenum error = RenderBackend::get()->getError();
         if (!error) {
             std::string key(name);
-            glGetActiveUniformBlockiv(_program, ii, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+            RenderBackend::get()->getActiveUniformBlockiv(_program, ii, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
             _uniblocksizes[key] = size;
             _uniblocknames[ii]  = key;
             
             // Link the block to uniforms
-            glGetActiveUniformBlockiv(_program, ii, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &size);
+            RenderBackend::get()->getActiveUniformBlockiv(_program, ii, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &size);
             int* ans = new int[size];
-            glGetActiveUniformBlockiv(_program, ii, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, ans);
+            RenderBackend::get()->getActiveUniformBlockiv(_program, ii, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, ans);
             for(int jj = 0; jj < size; jj++) {
                 _uniblockfields[ans[jj]] = ii;
             }
@@ -336,7 +337,7 @@ bool Shader::init(const std::string vsource, const std::string fsource) {
  */
 void Shader::bind() {
     CUAssertLog(_program, "Shader has not been initialized.");
-    glUseProgram( _program );
+    RenderBackend::get()->useProgram( _program );
 }
 
 /**
@@ -347,7 +348,7 @@ void Shader::bind() {
 void Shader::unbind() {
     CUAssertLog(_program, "Shader has not been initialized.");
     if (isBound()) {
-        glUseProgram( NULL );
+        RenderBackend::get()->useProgram( 0 );
     }
 }
 
@@ -360,7 +361,7 @@ void Shader::unbind() {
  */
 bool Shader::isBound() const {
     GLint prog;
-    glGetIntegerv(GL_CURRENT_PROGRAM,&prog);
+    RenderBackend::get()->getIntegerv(GL_CURRENT_PROGRAM,&prog);
     return prog == _program;
 }
  
@@ -390,7 +391,7 @@ std::vector<std::string> Shader::getAttributes() const {
  * @return the program offset of the given attribute
  */
 GLint Shader::getAttributeLocation(const std::string name) const {
-    return glGetAttribLocation(_program,name.c_str());
+    return RenderBackend::get()->getAttribLocation(_program,name.c_str());
 }
 
 /**
@@ -447,7 +448,7 @@ GLenum Shader::getAttributeType(const std::string name) const  {
  * @return the program offset of the given output variable.
  */
 GLint Shader::getOutputLocation(const std::string name) const {
-    return glGetFragDataLocation(_program, name.c_str());
+    return RenderBackend::get()->getFragDataLocation(_program, name.c_str());
 }
 
 
@@ -476,7 +477,7 @@ std::vector<std::string> Shader::getUniforms() const {
  * @return the program offset of the given uniform
  */
 GLint Shader::getUniformLocation(const std::string name) const {
-    return glGetUniformLocation(_program,name.c_str());
+    return RenderBackend::get()->getUniformLocation(_program,name.c_str());
 }
 
 /**
@@ -549,7 +550,7 @@ std::vector<std::string> Shader::getSamplers() const {
  * @return the program offset of the given sampler variable
  */
 GLint Shader::getSamplerLocation(const std::string name) const {
-    GLint result =  glGetUniformLocation(_program,name.c_str());
+    GLint result =  RenderBackend::get()->getUniformLocation(_program,name.c_str());
     if (result != -1 && _uniformtypes.at(name) != GL_SAMPLER_2D) {
         result = -1;
     }
@@ -731,7 +732,7 @@ std::vector<std::string> Shader::getUniformsForBlock(GLint pos) const {
  */
 std::vector<std::string> Shader::getUniformsForBlock(std::string name) const {
     std::vector<std::string> result;
-    GLuint index = glGetUniformBlockIndex(_program, name.c_str());
+    GLuint index = RenderBackend::get()->getUniformBlockIndex(_program, name.c_str());
     if (index == GL_INVALID_INDEX) {
         return result;
     }
@@ -757,7 +758,7 @@ std::vector<std::string> Shader::getUniformsForBlock(std::string name) const {
  * @param bpoint   The bindpoint for the uniform block
  */
 void Shader::setUniformBlock(GLint pos, GLuint bindpoint) {
-    glUniformBlockBinding(_program, pos, bindpoint);
+    RenderBackend::get()->uniformBlockBinding(_program, pos, bindpoint);
 }
 
 /**
@@ -774,9 +775,9 @@ void Shader::setUniformBlock(GLint pos, GLuint bindpoint) {
  * @param bpoint   The bindpoint for the uniform block
  */
 void Shader::setUniformBlock(const std::string name, GLuint bindpoint) {
-    GLuint index = glGetUniformBlockIndex(_program, name.c_str());
+    GLuint index = RenderBackend::get()->getUniformBlockIndex(_program, name.c_str());
     if (index != GL_INVALID_INDEX) {
-        glUniformBlockBinding(_program, index, bindpoint);
+        RenderBackend::get()->uniformBlockBinding(_program, index, bindpoint);
     }
 }
 
@@ -829,7 +830,7 @@ void Shader::setUniformBlock(GLint pos, const std::shared_ptr<UniformBuffer>& bu
     }
     
     // Now bind
-    glUniformBlockBinding(_program, pos, bpoint);
+    RenderBackend::get()->uniformBlockBinding(_program, pos, bpoint);
 }
 
 /**
@@ -852,7 +853,7 @@ void Shader::setUniformBlock(GLint pos, const std::shared_ptr<UniformBuffer>& bu
  */
 void Shader::setUniformBlock(const std::string name,
                              const std::shared_ptr<UniformBuffer>& buffer) {
-    GLuint index = glGetUniformBlockIndex(_program, name.c_str());
+    GLuint index = RenderBackend::get()->getUniformBlockIndex(_program, name.c_str());
     if (index != GL_INVALID_INDEX) {
         setUniformBlock(index, buffer);
     }
@@ -871,7 +872,7 @@ void Shader::setUniformBlock(const std::string name,
  */
 GLuint Shader::getUniformBlock(GLint pos) const {
     GLint block;
-    glGetActiveUniformBlockiv(_program,pos,GL_UNIFORM_BLOCK_BINDING,&block);
+    RenderBackend::get()->getActiveUniformBlockiv(_program,pos,GL_UNIFORM_BLOCK_BINDING,&block);
     return block;
 }
 
@@ -887,13 +888,13 @@ GLuint Shader::getUniformBlock(GLint pos) const {
  * @return the buffer bindpoint associated with the given uniform block.
  */
 GLuint Shader::getUniformBlock(const std::string name) const {
-    GLuint index = glGetUniformBlockIndex(_program, name.c_str());
+    GLuint index = RenderBackend::get()->getUniformBlockIndex(_program, name.c_str());
     if (index == GL_INVALID_INDEX) {
         return 0;
     }
     
     GLint block;
-    glGetActiveUniformBlockiv(_program,index,GL_UNIFORM_BLOCK_BINDING,&block);
+    RenderBackend::get()->getActiveUniformBlockiv(_program,index,GL_UNIFORM_BLOCK_BINDING,&block);
     return block;
 }
 
@@ -910,7 +911,7 @@ GLuint Shader::getUniformBlock(const std::string name) const {
  */
 void Shader::setUniformVec2(GLint pos, const Vec2 vec) {
     CUAssertLog(isBound(), "Shader is not active.");
-    glUniform2f(pos,vec.x,vec.y);
+    RenderBackend::get()->uniform2f(pos,vec.x,vec.y);
 }
 
 /**
@@ -924,7 +925,7 @@ void Shader::setUniformVec2(GLint pos, const Vec2 vec) {
 void Shader::setUniformVec2(const std::string name, const Vec2 vec) {
     CUAssertLog(isBound(), "Shader is not active.");
     GLint locale = getUniformLocation(name.c_str());
-    if (locale >= 0) glUniform2f(locale,vec.x,vec.y);
+    if (locale >= 0) RenderBackend::get()->uniform2f(locale,vec.x,vec.y);
 }
 
 /**
@@ -969,7 +970,7 @@ bool Shader::getUniformVec2(const std::string name, Vec2& vec) const {
  */
 void Shader::setUniformVec3(GLint pos, const Vec3 vec) {
     CUAssertLog(isBound(), "Shader is not active.");
-    glUniform3f(pos,vec.x,vec.y,vec.z);
+    RenderBackend::get()->uniform3f(pos,vec.x,vec.y,vec.z);
 }
 
 /**
@@ -983,7 +984,7 @@ void Shader::setUniformVec3(GLint pos, const Vec3 vec) {
 void Shader::setUniformVec3(const std::string name, const Vec3 vec) {
     CUAssertLog(isBound(), "Shader is not active.");
     GLint locale = getUniformLocation(name.c_str());
-    if (locale >= 0) glUniform3f(locale,vec.x,vec.y,vec.z);
+    if (locale >= 0) RenderBackend::get()->uniform3f(locale,vec.x,vec.y,vec.z);
 }
 
 /**
@@ -1028,7 +1029,7 @@ bool Shader::getUniformVec3(const std::string name, Vec3& vec) const {
  */
 void Shader::setUniformVec4(GLint pos, const Vec4 vec) {
     CUAssertLog(isBound(), "Shader is not active.");
-    glUniform4f(pos,vec.x,vec.y,vec.z,vec.w);
+    RenderBackend::get()->uniform4f(pos,vec.x,vec.y,vec.z,vec.w);
 }
 
 /**
@@ -1042,7 +1043,7 @@ void Shader::setUniformVec4(GLint pos, const Vec4 vec) {
 void Shader::setUniformVec4(const std::string name, const Vec4 vec) {
     CUAssertLog(isBound(), "Shader is not active.");
     GLint locale = getUniformLocation(name.c_str());
-    if (locale >= 0) glUniform4f(locale,vec.x,vec.y,vec.z,vec.w);
+    if (locale >= 0) RenderBackend::get()->uniform4f(locale,vec.x,vec.y,vec.z,vec.w);
 }
 
 /**
@@ -1206,7 +1207,7 @@ bool Shader::getUniformColor4f(const std::string name, Color4f& color) const {
  */
 void Shader::setUniformMat4(GLint pos, const Mat4& mat) {
     CUAssertLog(isBound(), "Shader is not active.");
-    glUniformMatrix4fv(pos,1,false,mat.m);
+    RenderBackend::get()->uniformMatrix4fv(pos,1,false,mat.m);
 }
 
 /**
@@ -1222,7 +1223,7 @@ void Shader::setUniformMat4(GLint pos, const Mat4& mat) {
 void Shader::setUniformMat4(const std::string name, const Mat4& mat) {
     CUAssertLog(isBound(), "Shader is not active.");
     GLint locale = getUniformLocation(name.c_str());
-    if (locale >= 0) glUniformMatrix4fv(locale,1,false,mat.m);
+    if (locale >= 0) RenderBackend::get()->uniformMatrix4fv(locale,1,false,mat.m);
 }
 
 /**
@@ -1270,7 +1271,7 @@ void Shader::setUniformAffine2(GLint pos, const Affine2& mat) {
     CUAssertLog(isBound(), "Shader is not active.");
     float data[9];
     mat.get3x3(data);
-    glUniformMatrix3fv(pos,1,false,data);
+    RenderBackend::get()->uniformMatrix3fv(pos,1,false,data);
 }
 
 /**
@@ -1290,7 +1291,7 @@ void Shader::setUniformAffine2(const std::string name, const Affine2& mat) {
     if (locale >= 0) {
         float data[9];
         mat.get3x3(data);
-        glUniformMatrix3fv(locale,1,false,data);
+        RenderBackend::get()->uniformMatrix3fv(locale,1,false,data);
     }
 }
 
@@ -1405,7 +1406,7 @@ bool Shader::getUniformQuaternion(const std::string name, Quaternion& quat) cons
  */
 void Shader::setUniform1f(GLint pos, GLfloat v0) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform1f(pos, v0);
+	RenderBackend::get()->uniform1f(pos, v0);
 }
 
 /**
@@ -1421,7 +1422,7 @@ void Shader::setUniform1f(GLint pos, GLfloat v0) {
 void Shader::setUniform1f(const std::string name, GLfloat v0) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform1f(locale, v0);
+	if (locale >= 0) RenderBackend::get()->uniform1f(locale, v0);
 }
 
 /**
@@ -1435,7 +1436,7 @@ void Shader::setUniform1f(const std::string name, GLfloat v0) {
  */
 void Shader::setUniform2f(GLint pos, GLfloat v0, GLfloat v1) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform2f(pos, v0, v1);
+	RenderBackend::get()->uniform2f(pos, v0, v1);
 }
 
 /**
@@ -1452,7 +1453,7 @@ void Shader::setUniform2f(GLint pos, GLfloat v0, GLfloat v1) {
 void Shader::setUniform2f(const std::string name, GLfloat v0, GLfloat v1) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform2f(locale, v0, v1);
+	if (locale >= 0) RenderBackend::get()->uniform2f(locale, v0, v1);
 }
 
 /**
@@ -1467,7 +1468,7 @@ void Shader::setUniform2f(const std::string name, GLfloat v0, GLfloat v1) {
  */
 void Shader::setUniform3f(GLint pos, GLfloat v0, GLfloat v1, GLfloat v2) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform3f(pos, v0, v1, v2);
+	RenderBackend::get()->uniform3f(pos, v0, v1, v2);
 }
 
 /**
@@ -1485,7 +1486,7 @@ void Shader::setUniform3f(GLint pos, GLfloat v0, GLfloat v1, GLfloat v2) {
 void Shader::setUniform3f(const std::string name, GLfloat v0, GLfloat v1, GLfloat v2) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform3f(locale, v0, v1, v2);
+	if (locale >= 0) RenderBackend::get()->uniform3f(locale, v0, v1, v2);
 }
 
 /**
@@ -1501,7 +1502,7 @@ void Shader::setUniform3f(const std::string name, GLfloat v0, GLfloat v1, GLfloa
  */
 void Shader::setUniform4f(GLint pos, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform4f(pos, v0, v1, v2, v3);
+	RenderBackend::get()->uniform4f(pos, v0, v1, v2, v3);
 }
 
 /**
@@ -1520,7 +1521,7 @@ void Shader::setUniform4f(GLint pos, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat
 void Shader::setUniform4f(const std::string name, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform4f(locale, v0, v1, v2, v3);
+	if (locale >= 0) RenderBackend::get()->uniform4f(locale, v0, v1, v2, v3);
 }
 
 /**
@@ -1533,7 +1534,7 @@ void Shader::setUniform4f(const std::string name, GLfloat v0, GLfloat v1, GLfloa
  */
 void Shader::setUniform1i(GLint pos, GLint v0) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform1i(pos, v0);
+	RenderBackend::get()->uniform1i(pos, v0);
 }
 
 /**
@@ -1549,7 +1550,7 @@ void Shader::setUniform1i(GLint pos, GLint v0) {
 void Shader::setUniform1i(const std::string name, GLint v0) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform1i(locale, v0);
+	if (locale >= 0) RenderBackend::get()->uniform1i(locale, v0);
 }
 
 /**
@@ -1563,7 +1564,7 @@ void Shader::setUniform1i(const std::string name, GLint v0) {
  */
 void Shader::setUniform2i(GLint pos, GLint v0, GLint v1) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform2i(pos, v0, v1);
+	RenderBackend::get()->uniform2i(pos, v0, v1);
 }
 
 /**
@@ -1580,7 +1581,7 @@ void Shader::setUniform2i(GLint pos, GLint v0, GLint v1) {
 void Shader::setUniform2i(const std::string name, GLint v0, GLint v1) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform2i(locale, v0, v1);
+	if (locale >= 0) RenderBackend::get()->uniform2i(locale, v0, v1);
 }
 
 /**
@@ -1595,7 +1596,7 @@ void Shader::setUniform2i(const std::string name, GLint v0, GLint v1) {
  */
 void Shader::setUniform3i(GLint pos, GLint v0, GLint v1, GLint v2) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform3i(pos, v0, v1, v2);
+	RenderBackend::get()->uniform3i(pos, v0, v1, v2);
 }
 
 /**
@@ -1613,7 +1614,7 @@ void Shader::setUniform3i(GLint pos, GLint v0, GLint v1, GLint v2) {
 void Shader::setUniform3i(const std::string name, GLint v0, GLint v1, GLint v2) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform3i(locale, v0, v1, v2);
+	if (locale >= 0) RenderBackend::get()->uniform3i(locale, v0, v1, v2);
 }
 
 /**
@@ -1629,7 +1630,7 @@ void Shader::setUniform3i(const std::string name, GLint v0, GLint v1, GLint v2)
  */
 void Shader::setUniform4i(GLint pos, GLint v0, GLint v1, GLint v2, GLint v3) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform4i(pos, v0, v1, v2, v3);
+	RenderBackend::get()->uniform4i(pos, v0, v1, v2, v3);
 }
 
 /**
@@ -1648,7 +1649,7 @@ void Shader::setUniform4i(GLint pos, GLint v0, GLint v1, GLint v2, GLint v3) {
 void Shader::setUniform4i(const std::string name, GLint v0, GLint v1, GLint v2, GLint v3) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform4i(locale, v0, v1, v2, v3);
+	if (locale >= 0) RenderBackend::get()->uniform4i(locale, v0, v1, v2, v3);
 }
 
 /**
@@ -1661,7 +1662,7 @@ void Shader::setUniform4i(const std::string name, GLint v0, GLint v1, GLint v2,
  */
 void Shader::setUniform1ui(GLint pos, GLuint v0) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform1ui(pos, v0);
+	RenderBackend::get()->uniform1ui(pos, v0);
 }
 
 /**
@@ -1677,7 +1678,7 @@ void Shader::setUniform1ui(GLint pos, GLuint v0) {
 void Shader::setUniform1ui(const std::string name, GLuint v0) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform1ui(locale, v0);
+	if (locale >= 0) RenderBackend::get()->uniform1ui(locale, v0);
 }
 
 /**
@@ -1691,7 +1692,7 @@ void Shader::setUniform1ui(const std::string name, GLuint v0) {
  */
 void Shader::setUniform2ui(GLint pos, GLuint v0, GLuint v1) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform2ui(pos, v0, v1);
+	RenderBackend::get()->uniform2ui(pos, v0, v1);
 }
 
 /**
@@ -1708,7 +1709,7 @@ void Shader::setUniform2ui(GLint pos, GLuint v0, GLuint v1) {
 void Shader::setUniform2ui(const std::string name, GLuint v0, GLuint v1) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform2ui(locale, v0, v1);
+	if (locale >= 0) RenderBackend::get()->uniform2ui(locale, v0, v1);
 }
 
 /**
@@ -1723,7 +1724,7 @@ void Shader::setUniform2ui(const std::string name, GLuint v0, GLuint v1) {
  */
 void Shader::setUniform3ui(GLint pos, GLuint v0, GLuint v1, GLuint v2) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform3ui(pos, v0, v1, v2);
+	RenderBackend::get()->uniform3ui(pos, v0, v1, v2);
 }
 
 /**
@@ -1741,7 +1742,7 @@ void Shader::setUniform3ui(GLint pos, GLuint v0, GLuint v1, GLuint v2) {
 void Shader::setUniform3ui(const std::string name, GLuint v0, GLuint v1, GLuint v2) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform3ui(locale, v0, v1, v2);
+	if (locale >= 0) RenderBackend::get()->uniform3ui(locale, v0, v1, v2);
 }
 
 /**
@@ -1757,7 +1758,7 @@ void Shader::setUniform3ui(const std::string name, GLuint v0, GLuint v1, GLuint
  */
 void Shader::setUniform4ui(GLint pos, GLuint v0, GLuint v1, GLuint v2, GLuint v3) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform4ui(pos, v0, v1, v2, v3);
+	RenderBackend::get()->uniform4ui(pos, v0, v1, v2, v3);
 }
 
 /**
@@ -1776,7 +1777,7 @@ void Shader::setUniform4ui(GLint pos, GLuint v0, GLuint v1, GLuint v2, GLuint v3
 void Shader::setUniform4ui(const std::string name, GLuint v0, GLuint v1, GLuint v2, GLuint v3) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform4ui(locale, v0, v1, v2, v3);
+	if (locale >= 0) RenderBackend::get()->uniform4ui(locale, v0, v1, v2, v3);
 }
 
 /**
@@ -1790,7 +1791,7 @@ void Shader::setUniform4ui(const std::string name, GLuint v0, GLuint v1, GLuint
  */
 void Shader::setUniform1fv(GLint pos, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform1fv(pos, count, value);
+	RenderBackend::get()->uniform1fv(pos, count, value);
 }
 
 /**
@@ -1807,7 +1808,7 @@ void Shader::setUniform1fv(GLint pos, GLsizei count, const GLfloat *value) {
 void Shader::setUniform1fv(const std::string name, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform1fv(locale, count, value);
+	if (locale >= 0) RenderBackend::get()->uniform1fv(locale, count, value);
 }
 
 /**
@@ -1821,7 +1822,7 @@ void Shader::setUniform1fv(const std::string name, GLsizei count, const GLfloat
  */
 void Shader::setUniform2fv(GLint pos, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform2fv(pos, count, value);
+	RenderBackend::get()->uniform2fv(pos, count, value);
 }
 
 /**
@@ -1838,7 +1839,7 @@ void Shader::setUniform2fv(GLint pos, GLsizei count, const GLfloat *value) {
 void Shader::setUniform2fv(const std::string name, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform2fv(locale, count, value);
+	if (locale >= 0) RenderBackend::get()->uniform2fv(locale, count, value);
 }
 
 /**
@@ -1852,7 +1853,7 @@ void Shader::setUniform2fv(const std::string name, GLsizei count, const GLfloat
  */
 void Shader::setUniform3fv(GLint pos, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform3fv(pos, count, value);
+	RenderBackend::get()->uniform3fv(pos, count, value);
 }
 
 /**
@@ -1869,7 +1870,7 @@ void Shader::setUniform3fv(GLint pos, GLsizei count, const GLfloat *value) {
 void Shader::setUniform3fv(const std::string name, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform3fv(locale, count, value);
+	if (locale >= 0) RenderBackend::get()->uniform3fv(locale, count, value);
 }
 
 /**
@@ -1883,7 +1884,7 @@ void Shader::setUniform3fv(const std::string name, GLsizei count, const GLfloat
  */
 void Shader::setUniform4fv(GLint pos, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform4fv(pos, count, value);
+	RenderBackend::get()->uniform4fv(pos, count, value);
 }
 
 /**
@@ -1900,7 +1901,7 @@ void Shader::setUniform4fv(GLint pos, GLsizei count, const GLfloat *value) {
 void Shader::setUniform4fv(const std::string name, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform4fv(locale, count, value);
+	if (locale >= 0) RenderBackend::get()->uniform4fv(locale, count, value);
 }
 
 /**
@@ -1914,7 +1915,7 @@ void Shader::setUniform4fv(const std::string name, GLsizei count, const GLfloat
  */
 void Shader::setUniform1iv(GLint pos, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform1iv(pos, count, value);
+	RenderBackend::get()->uniform1iv(pos, count, value);
 }
 
 /**
@@ -1931,7 +1932,7 @@ void Shader::setUniform1iv(GLint pos, GLsizei count, const GLint *value) {
 void Shader::setUniform1iv(const std::string name, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform1iv(locale, count, value);
+	if (locale >= 0) RenderBackend::get()->uniform1iv(locale, count, value);
 }
 
 /**
@@ -1945,7 +1946,7 @@ void Shader::setUniform1iv(const std::string name, GLsizei count, const GLint *v
  */
 void Shader::setUniform2iv(GLint pos, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform2iv(pos, count, value);
+	RenderBackend::get()->uniform2iv(pos, count, value);
 }
 
 /**
@@ -1962,7 +1963,7 @@ void Shader::setUniform2iv(GLint pos, GLsizei count, const GLint *value) {
 void Shader::setUniform2iv(const std::string name, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform2iv(locale, count, value);
+	if (locale >= 0) RenderBackend::get()->uniform2iv(locale, count, value);
 }
 
 /**
@@ -1976,7 +1977,7 @@ void Shader::setUniform2iv(const std::string name, GLsizei count, const GLint *v
  */
 void Shader::setUniform3iv(GLint pos, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform3iv(pos, count, value);
+	RenderBackend::get()->uniform3iv(pos, count, value);
 }
 
 /**
@@ -1993,7 +1994,7 @@ void Shader::setUniform3iv(GLint pos, GLsizei count, const GLint *value) {
 void Shader::setUniform3iv(const std::string name, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform3iv(locale, count, value);
+	if (locale >= 0) RenderBackend::get()->uniform3iv(locale, count, value);
 }
 
 /**
@@ -2007,7 +2008,7 @@ void Shader::setUniform3iv(const std::string name, GLsizei count, const GLint *v
  */
 void Shader::setUniform4iv(GLint pos, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform4iv(pos, count, value);
+	RenderBackend::get()->uniform4iv(pos, count, value);
 }
 
 /**
@@ -2024,7 +2025,7 @@ void Shader::setUniform4iv(GLint pos, GLsizei count, const GLint *value) {
 void Shader::setUniform4iv(const std::string name, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform4iv(locale, count, value);
+	if (locale >= 0) RenderBackend::get()->uniform4iv(locale, count, value);
 }
 
 /**
@@ -2038,7 +2039,7 @@ void Shader::setUniform4iv(const std::string name, GLsizei count, const GLint *v
  */
 void Shader::setUniform1uiv(GLint pos, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform1uiv(pos, count, value);
+	RenderBackend::get()->uniform1uiv(pos, count, value);
 }
 
 /**
@@ -2055,7 +2056,7 @@ void Shader::setUniform1uiv(GLint pos, GLsizei count, const GLuint *value) {
 void Shader::setUniform1uiv(const std::string name, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform1uiv(locale, count, value);
+	if (locale >= 0) RenderBackend::get()->uniform1uiv(locale, count, value);
 }
 
 /**
@@ -2069,7 +2070,7 @@ void Shader::setUniform1uiv(const std::string name, GLsizei count, const GLuint
  */
 void Shader::setUniform2uiv(GLint pos, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform2uiv(pos, count, value);
+	RenderBackend::get()->uniform2uiv(pos, count, value);
 }
 
 /**
@@ -2086,7 +2087,7 @@ void Shader::setUniform2uiv(GLint pos, GLsizei count, const GLuint *value) {
 void Shader::setUniform2uiv(const std::string name, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform2uiv(locale, count, value);
+	if (locale >= 0) RenderBackend::get()->uniform2uiv(locale, count, value);
 }
 
 /**
@@ -2100,7 +2101,7 @@ void Shader::setUniform2uiv(const std::string name, GLsizei count, const GLuint
  */
 void Shader::setUniform3uiv(GLint pos, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform3uiv(pos, count, value);
+	RenderBackend::get()->uniform3uiv(pos, count, value);
 }
 
 /**
@@ -2117,7 +2118,7 @@ void Shader::setUniform3uiv(GLint pos, GLsizei count, const GLuint *value) {
 void Shader::setUniform3uiv(const std::string name, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform3uiv(locale, count, value);
+	if (locale >= 0) RenderBackend::get()->uniform3uiv(locale, count, value);
 }
 
 /**
@@ -2131,7 +2132,7 @@ void Shader::setUniform3uiv(const std::string name, GLsizei count, const GLuint
  */
 void Shader::setUniform4uiv(GLint pos, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniform4uiv(pos, count, value);
+	RenderBackend::get()->uniform4uiv(pos, count, value);
 }
 
 /**
@@ -2148,7 +2149,7 @@ void Shader::setUniform4uiv(GLint pos, GLsizei count, const GLuint *value) {
 void Shader::setUniform4uiv(const std::string name, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform4uiv(locale, count, value);
+	if (locale >= 0) RenderBackend::get()->uniform4uiv(locale, count, value);
 }
 
 /**
@@ -2163,7 +2164,7 @@ void Shader::setUniform4uiv(const std::string name, GLsizei count, const GLuint
  */
 void Shader::setUniformMatrix2fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniformMatrix2fv(pos, count, tpose, value);
+	RenderBackend::get()->uniformMatrix2fv(pos, count, tpose, value);
 }
 
 /**
@@ -2181,7 +2182,7 @@ void Shader::setUniformMatrix2fv(GLint pos, GLsizei count, const GLfloat *value,
 void Shader::setUniformMatrix2fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix2fv(locale, count, tpose, value);
+	if (locale >= 0) RenderBackend::get()->uniformMatrix2fv(locale, count, tpose, value);
 }
 
 /**
@@ -2196,7 +2197,7 @@ void Shader::setUniformMatrix2fv(const std::string name, GLsizei count, const GL
  */
 void Shader::setUniformMatrix3fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniformMatrix3fv(pos, count, tpose, value);
+	RenderBackend::get()->uniformMatrix3fv(pos, count, tpose, value);
 }
 
 /**
@@ -2214,7 +2215,7 @@ void Shader::setUniformMatrix3fv(GLint pos, GLsizei count, const GLfloat *value,
 void Shader::setUniformMatrix3fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix3fv(locale, count, tpose, value);
+	if (locale >= 0) RenderBackend::get()->uniformMatrix3fv(locale, count, tpose, value);
 }
 
 /**
@@ -2229,7 +2230,7 @@ void Shader::setUniformMatrix3fv(const std::string name, GLsizei count, const GL
  */
 void Shader::setUniformMatrix4fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniformMatrix4fv(pos, count, tpose, value);
+	RenderBackend::get()->uniformMatrix4fv(pos, count, tpose, value);
 }
 
 /**
@@ -2247,7 +2248,7 @@ void Shader::setUniformMatrix4fv(GLint pos, GLsizei count, const GLfloat *value,
 void Shader::setUniformMatrix4fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix4fv(locale, count, tpose, value);
+	if (locale >= 0) RenderBackend::get()->uniformMatrix4fv(locale, count, tpose, value);
 }
 
 /**
@@ -2262,7 +2263,7 @@ void Shader::setUniformMatrix4fv(const std::string name, GLsizei count, const GL
  */
 void Shader::setUniformMatrix2x3fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniformMatrix2x3fv(pos, count, tpose, value);
+	RenderBackend::get()->uniformMatrix2x3fv(pos, count, tpose, value);
 }
 
 /**
@@ -2280,7 +2281,7 @@ void Shader::setUniformMatrix2x3fv(GLint pos, GLsizei count, const GLfloat *valu
 void Shader::setUniformMatrix2x3fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix2x3fv(locale, count, tpose, value);
+	if (locale >= 0) RenderBackend::get()->uniformMatrix2x3fv(locale, count, tpose, value);
 }
 
 /**
@@ -2295,7 +2296,7 @@ void Shader::setUniformMatrix2x3fv(const std::string name, GLsizei count, const
  */
 void Shader::setUniformMatrix3x2fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniformMatrix3x2fv(pos, count, tpose, value);
+	RenderBackend::get()->uniformMatrix3x2fv(pos, count, tpose, value);
 }
 
 /**
@@ -2313,7 +2314,7 @@ void Shader::setUniformMatrix3x2fv(GLint pos, GLsizei count, const GLfloat *valu
 void Shader::setUniformMatrix3x2fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix3x2fv(locale, count, tpose, value);
+	if (locale >= 0) RenderBackend::get()->uniformMatrix3x2fv(locale, count, tpose, value);
 }
 
 /**
@@ -2328,7 +2329,7 @@ void Shader::setUniformMatrix3x2fv(const std::string name, GLsizei count, const
  */
 void Shader::setUniformMatrix2x4fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniformMatrix2x4fv(pos, count, tpose, value);
+	RenderBackend::get()->uniformMatrix2x4fv(pos, count, tpose, value);
 }
 
 /**
@@ -2346,7 +2347,7 @@ void Shader::setUniformMatrix2x4fv(GLint pos, GLsizei count, const GLfloat *valu
 void Shader::setUniformMatrix2x4fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix2x4fv(locale, count, tpose, value);
+	if (locale >= 0) RenderBackend::get()->uniformMatrix2x4fv(locale, count, tpose, value);
 }
 
 /**
@@ -2361,7 +2362,7 @@ void Shader::setUniformMatrix2x4fv(const std::string name, GLsizei count, const
  */
 void Shader::setUniformMatrix4x2fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniformMatrix4x2fv(pos, count, tpose, value);
+	RenderBackend::get()->uniformMatrix4x2fv(pos, count, tpose, value);
 }
 
 /**
@@ -2379,7 +2380,7 @@ void Shader::setUniformMatrix4x2fv(GLint pos, GLsizei count, const GLfloat *valu
 void Shader::setUniformMatrix4x2fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix4x2fv(locale, count, tpose, value);
+	if (locale >= 0) RenderBackend::get()->uniformMatrix4x2fv(locale, count, tpose, value);
 }
 
 /**
@@ -2394,7 +2395,7 @@ void Shader::setUniformMatrix4x2fv(const std::string name, GLsizei count, const
  */
 void Shader::setUniformMatrix3x4fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniformMatrix3x4fv(pos, count, tpose, value);
+	RenderBackend::get()->uniformMatrix3x4fv(pos, count, tpose, value);
 }
 
 /**
@@ -2412,7 +2413,7 @@ void Shader::setUniformMatrix3x4fv(GLint pos, GLsizei count, const GLfloat *valu
 void Shader::setUniformMatrix3x4fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix3x4fv(locale, count, tpose, value);
+	if (locale >= 0) RenderBackend::get()->uniformMatrix3x4fv(locale, count, tpose, value);
 }
 
 /**
@@ -2427,7 +2428,7 @@ void Shader::setUniformMatrix3x4fv(const std::string name, GLsizei count, const
  */
 void Shader::setUniformMatrix4x3fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
-	glUniformMatrix4x3fv(pos, count, tpose, value);
+	RenderBackend::get()->uniformMatrix4x3fv(pos, count, tpose, value);
 }
 
 /**
@@ -2445,7 +2446,7 @@ void Shader::setUniformMatrix4x3fv(GLint pos, GLsizei count, const GLfloat *valu
 void Shader::setUniformMatrix4x3fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-    if (locale >= 0) glUniformMatrix4x3fv(locale, count, tpose, value);
+    if (locale >= 0) RenderBackend::get()->uniformMatrix4x3fv(locale, count, tpose, value);
 }
 
 /**
@@ -2461,8 +2462,8 @@ void Shader::setUniformMatrix4x3fv(const std::string name, GLsizei count, const
  */
 bool Shader::getUniformfv(GLint pos, GLsizei size, GLfloat *value) const {
     CUAssertLog(isBound(), "Shader is not active.");
-    glGetUniformfv(_program,pos,value);
-    return !(glGetError());
+    RenderBackend::get()->getUniformfv(_program,pos,value);
+    return !(RenderBackend::get()->getError());
 }
 
 /**
@@ -2482,8 +2483,8 @@ bool Shader::getUniformfv(const std::string name, GLsizei size, GLfloat *value)
     CUAssertLog(isBound(), "Shader is not active.");
     GLint locale = getUniformLocation(name.c_str());
     if (locale >= 0) {
-        glGetUniformfv(_program,locale,value);
-        return !(glGetError());
+        RenderBackend::get()->getUniformfv(_program,locale,value);
+        return !(RenderBackend::get()->getError());
     }
     return false;
 }
@@ -2501,8 +2502,8 @@ bool Shader::getUniformfv(const std::string name, GLsizei size, GLfloat *value)
  */
 bool Shader::getUniformiv(GLint pos, GLsizei size, GLint *value) const {
     CUAssertLog(isBound(), "Shader is not active.");
-    glGetUniformiv(_program,pos,value);
-    return !(glGetError());
+    RenderBackend::get()->getUniformiv(_program,pos,value);
+    return !(RenderBackend::get()->getError());
 }
 
 /**
@@ -2522,8 +2523,8 @@ bool Shader::getUniformiv(const std::string name, GLsizei size, GLint *value) co
     CUAssertLog(isBound(), "Shader is not active.");
     GLint locale = getUniformLocation(name.c_str());
     if (locale >= 0) {
-        glGetUniformiv(_program,locale,value);
-        return !(glGetError());
+        RenderBackend::get()->getUniformiv(_program,locale,value);
+        return !(RenderBackend::get()->getError());
     }
     return false;
 }
@@ -2541,8 +2542,8 @@ bool Shader::getUniformiv(const std::string name, GLsizei size, GLint *value) co
  */
 bool Shader::getUniformuiv(GLint pos, GLsizei size, GLuint *value) const {
     CUAssertLog(isBound(), "Shader is not active.");
-    glGetUniformuiv(_program,pos,value);
-    return !(glGetError());
+    RenderBackend::get()->getUniformuiv(_program,pos,value);
+    return !(RenderBackend::get()->getError());
 }
 
 /**
@@ -2562,8 +2563,8 @@ bool Shader::getUniformuiv(const std::string name, GLsizei size, GLuint *value)
     CUAssertLog(isBound(), "Shader is not active.");
     GLint locale = getUniformLocation(name.c_str());
     if (locale >= 0) {
-        glGetUniformuiv(_program,locale,value);
-        return !(glGetError());
+        RenderBackend::get()->getUniformuiv(_program,locale,value);
+        return !(RenderBackend::get()->getError());
     }
     return false;
 }
@@ -50,6 +50,7 @@
 #include <cugl/render/CUShader.h>
 #include <cugl/render/CUGradient.h>
 #include <cugl/render/CUScissor.h>
+#include <cugl/render/CURenderBackend.h>
 
 /**
  * Default fragment shader
@@ -75,6 +76,17 @@ const std::string oglShaderVert =
 #include "shaders/SpriteShader.vert"
 ;
 
+/**
+ * Instanced vertex shader
+ *
+ * This shader is paired with the default fragment shader to draw instanced
+ * sprites. Like the default shaders, the #include statement below MUST be
+ * on its own separate line.
+ */
+const std::string oglInstanceVert =
+#include "shaders/InstanceShader.vert"
+;
+
 using namespace cugl;
 
 
@@ -88,6 +100,8 @@ using namespace cugl;
 #define TYPE_SCISSOR    4
 /** The drawing type for a (simple) texture blur */
 #define TYPE_GAUSSBLUR  8
+/** The drawing type for a signed distance field texture */
+#define TYPE_DISTANCE   16
 
 /** The drawing command has changed */
 #define DIRTY_COMMAND       1
@@ -177,6 +191,7 @@ SpriteBatch::Context::~Context() {
 SpriteBatch::SpriteBatch() :
 _initialized(false),
 _active(false),
+_instFailed(false),
 _inflight(false),
 _vertData(nullptr),
 _indxData(nullptr),
@@ -192,8 +207,11 @@ _callTotal(0) {
     _shader = nullptr;
     _vertbuff = nullptr;
     _unifbuff = nullptr;
+    _instShader = nullptr;
+    _instbuff = nullptr;
     _gradient = nullptr;
     _scissor  = nullptr;
+    _scissorCache = nullptr;
 }
 
 /**
@@ -214,8 +232,12 @@ void SpriteBatch::dispose() {
     _shader = nullptr;
     _vertbuff = nullptr;
     _unifbuff = nullptr;
+    _instShader = nullptr;
+    _instbuff = nullptr;
+    _instFailed = false;
     _gradient = nullptr;
     _scissor  = nullptr;
+    _scissorCache = nullptr;
     
     _vertMax  = 0;
     _vertSize = 0;
@@ -561,19 +583,59 @@ void SpriteBatch::setScissor(const std::shared_ptr<Scissor>& scissor) {
         return;
     }
     
-    if (_inflight) { record(); }
     if (scissor == nullptr) {
+        if (_inflight) { record(); }
         // Active gradient is not null
         _context->dirty = _context->dirty | DIRTY_UNIBLOCK | DIRTY_DRAWTYPE;
         _context->type = _context->type & ~TYPE_SCISSOR;
         _scissor = nullptr;
     } else {
-        _context->dirty = _context->dirty | DIRTY_UNIBLOCK | DIRTY_DRAWTYPE;
-        _context->type = _context->type | TYPE_SCISSOR;
-        _scissor = Scissor::alloc(scissor);
+        setScissor(*scissor);
     }
 }
 
+/**
+ * Sets the active scissor mask of this sprite batch
+ *
+ * This method is identical to {@link #setScissor(const std::shared_ptr<Scissor>&)}
+ * except that it takes a scissor by reference. The scissor is copied
+ * into storage owned by the sprite batch, so this method does not
+ * allocate any memory once a scissor mask has been used.
+ *
+ * @param scissor   The active scissor mask for this sprite batch
+ */
+void SpriteBatch::setScissor(const Scissor& scissor) {
+    if (_inflight) { record(); }
+    _context->dirty = _context->dirty | DIRTY_UNIBLOCK | DIRTY_DRAWTYPE;
+    _context->type = _context->type | TYPE_SCISSOR;
+    // The internal scissor is never shared (getScissor returns a copy)
+    if (_scissorCache == nullptr) {
+        _scissorCache = std::make_shared<Scissor>(scissor);
+    } else {
+        _scissorCache->set(scissor);
+    }
+    _scissor = _scissorCache;
+}
+
+/**
+ * Copies the active scissor mask of this sprite batch into dst
+ *
+ * This method is an allocation-free alternative to {@link #getScissor()}.
+ * If there is no active scissor mask, dst is unchanged and this method
+ * returns false.
+ *
+ * @param dst   The scissor mask to store the result
+ *
+ * @return true if there is an active scissor mask
+ */
+bool SpriteBatch::getScissor(Scissor* dst) const {
+    if (_scissor == nullptr) {
+        return false;
+    }
+    dst->set(*_scissor);
+    return true;
+}
+
 /**
  * Sets the blending function for this sprite batch
  *
@@ -700,6 +762,50 @@ void SpriteBatch::setBlurStep(GLuint step) {
     _context->blurstep = step;
 }
 
+/**
+ * Sets whether textures are drawn as signed distance fields.
+ *
+ * In this mode, the alpha channel of the texture is the distance to an
+ * edge, with the edge itself at 0.5. The sprite batch draws a sharp,
+ * antialiased edge at any scale. This is the mode for the distance field
+ * font atlases {@see Font#buildDistanceAtlasAsync}. It has no effect on
+ * drawing without a texture.
+ *
+ * This value is false by default.
+ *
+ * @param value Whether textures are drawn as signed distance fields
+ */
+void SpriteBatch::setDistanceField(bool value) {
+    if (isDistanceField() == value) {
+        return;
+    }
+    
+    if (_inflight) { record(); }
+    if (value) {
+        _context->type = _context->type | TYPE_DISTANCE;
+    } else {
+        _context->type = _context->type & ~TYPE_DISTANCE;
+    }
+    _context->dirty = _context->dirty | DIRTY_DRAWTYPE;
+}
+
+/**
+ * Returns true if textures are drawn as signed distance fields.
+ *
+ * In this mode, the alpha channel of the texture is the distance to an
+ * edge, with the edge itself at 0.5. The sprite batch draws a sharp,
+ * antialiased edge at any scale. This is the mode for the distance field
+ * font atlases {@see Font#buildDistanceAtlasAsync}. It has no effect on
+ * drawing without a texture.
+ *
+ * This value is false by default.
+ *
+ * @return true if textures are drawn as signed distance fields.
+ */
+bool SpriteBatch::isDistanceField() const {
+    return (_context->type & TYPE_DISTANCE) != 0;
+}
+
 
 #pragma mark -
 #pragma mark Rendering
@@ -712,9 +818,9 @@ void SpriteBatch::setBlurStep(GLuint step) {
  * Calling this method will reset the vertex and OpenGL call counters to 0.
  */
 void SpriteBatch::begin() {
-    glDisable(GL_CULL_FACE);
-    glDepthMask(true);
-    glEnable(GL_BLEND);
+    RenderBackend::get()->disable(GL_CULL_FACE);
+    RenderBackend::get()->depthMask(true);
+    RenderBackend::get()->enable(GL_BLEND);
 
     // DO NOT CLEAR.  This responsibility lies elsewhere
     _shader->bind();
@@ -765,20 +871,20 @@ void SpriteBatch::flush() {
     for(auto it = _history.begin(); it != _history.end(); ++it) {
         Context* next = *it;
         if (next->dirty & DIRTY_EQUATION) {
-            glBlendEquation(next->blendEquation);
+            RenderBackend::get()->blendEquation(next->blendEquation);
         }
         if (next->dirty & DIRTY_BLENDFACTOR) {
-            glBlendFunc(next->srcFactor, next->dstFactor);
+            RenderBackend::get()->blendFunc(next->srcFactor, next->dstFactor);
         }
         if (next->dirty & DIRTY_BLENDFACTOR) {
-            glBlendFunc(next->srcFactor, next->dstFactor);
+            RenderBackend::get()->blendFunc(next->srcFactor, next->dstFactor);
         }
         if (next->dirty & DIRTY_DEPTHTEST) {
             if (next->depthFunc == GL_ALWAYS) {
-                glDisable(GL_DEPTH_TEST);
+                RenderBackend::get()->disable(GL_DEPTH_TEST);
             } else {
-                glEnable(GL_DEPTH_TEST);
-                glDepthFunc(next->depthFunc);
+                RenderBackend::get()->enable(GL_DEPTH_TEST);
+                RenderBackend::get()->depthFunc(next->depthFunc);
             }
         }
         if (next->dirty & DIRTY_DRAWTYPE) {
@@ -1127,6 +1233,140 @@ void SpriteBatch::fill(const Mesh<SpriteVertex3>& mesh, const Mat4& transform, b
 }
 
 
+#pragma mark -
+#pragma mark Instanced Sprites
+/**
+ * Fills many copies of the given rectangle with the current texture.
+ *
+ * Each copy is described by a {@link SpriteInstance}, which is applied
+ * to the rectangle in local space (scaled, then rotated, then offset)
+ * before the transform is applied. The instance frame selects the region
+ * of the texture for that copy, and the instance color is multiplied by
+ * the current active color. The texture is applied to the rectangle in
+ * the same way as {@link #fill(Rect)}.
+ *
+ * Unlike the other fill methods, the copies are not added to the vertex
+ * buffer. Instead, this method flushes the sprite batch and draws all
+ * copies with a single instanced draw call, uploading only one quad and
+ * 40 bytes per instance. This is significantly faster for large numbers
+ * of identical sprites, like pickups or tiles. Because of the flush, it
+ * should be used for groups of sprites, not single sprites.
+ *
+ * The current blend state, depth and scissor mask are respected. Gradients
+ * and blur are not supported, and are ignored. If instancing is not
+ * supported by the platform, this method falls back to filling each copy
+ * separately.
+ *
+ * @param bounds    The rectangle to copy (in local space)
+ * @param instances The per-instance data
+ * @param count     The number of instances
+ * @param transform The coordinate transform
+ */
+void SpriteBatch::fillInstances(const Rect bounds, const SpriteInstance* instances, size_t count,
+                                const Mat4& transform) {
+    CUAssertLog(_active, "SpriteBatch is not active");
+    if (count == 0) {
+        return;
+    }
+    
+    // The quad, with texture coordinates normalized to the quad
+    static const GLuint indices[6] = { 0, 1, 2, 2, 3, 0 };
+    static const float corners[8]  = { 0, 0, 1, 0, 1, 1, 0, 1 };
+    SpriteVertex3 quad[4];
+    for(int ii = 0; ii < 4; ii++) {
+        quad[ii].position.x = bounds.origin.x+corners[2*ii  ]*bounds.size.width;
+        quad[ii].position.y = bounds.origin.y+corners[2*ii+1]*bounds.size.height;
+        quad[ii].position.z = _depth;
+        quad[ii].color = (Vec4)_color;
+        quad[ii].texcoord.x = corners[2*ii];
+        quad[ii].texcoord.y = 1-corners[2*ii+1];
+    }
+    
+    Texture* texture = _context->texture.get();
+    Vec4 texbounds(0,0,1,1);
+    if (texture != nullptr) {
+        texbounds.set(texture->getMinS(),texture->getMinT(),texture->getMaxS(),texture->getMaxT());
+    }
+    
+    if (_instFailed || (_instbuff == nullptr && !initInstancing())) {
+        // Apply the instance math on the CPU instead
+        Mesh<SpriteVertex2> mesh;
+        mesh.command = GL_TRIANGLES;
+        mesh.vertices.resize(4);
+        mesh.indices.assign(indices,indices+6);
+        for(size_t jj = 0; jj < count; jj++) {
+            const SpriteInstance& inst = instances[jj];
+            float c = cosf(inst.angle);
+            float s = sinf(inst.angle);
+            Vec4 tint = (Vec4)Color4f(inst.color);
+            for(int ii = 0; ii < 4; ii++) {
+                Vec2 local(quad[ii].position.x*inst.scale.x,quad[ii].position.y*inst.scale.y);
+                mesh.vertices[ii].position.set(c*local.x-s*local.y+inst.position.x,
+                                               s*local.x+c*local.y+inst.position.y);
+                mesh.vertices[ii].color = tint;
+                Vec2 coord = inst.frame.origin;
+                coord.x += quad[ii].texcoord.x*inst.frame.size.width;
+                coord.y += quad[ii].texcoord.y*inst.frame.size.height;
+                mesh.vertices[ii].texcoord.x = coord.x*texbounds.z+(1-coord.x)*texbounds.x;
+                mesh.vertices[ii].texcoord.y = coord.y*texbounds.w+(1-coord.y)*texbounds.y;
+            }
+            fill(mesh,transform,true);
+        }
+        return;
+    }
+    
+    // Draw everything batched so far, so that order is preserved
+    flush();
+    
+    // Apply the current context to the instance shader
+    _instbuff->attach(_instShader);
+    _instShader->setUniformMat4("uPerspective",*(_context->perspective.get()));
+    _instShader->setUniformMat4("uTransform",transform);
+    _instShader->setUniformVec4("uTexBounds",texbounds);
+    _instShader->setUniform2f("uBlur", 0, 0);
+    
+    GLint type = _context->type & (TYPE_TEXTURE | TYPE_SCISSOR);
+    _instShader->setUniform1i("uType", type);
+    RenderBackend::get()->blendEquation(_context->blendEquation);
+    RenderBackend::get()->blendFunc(_context->srcFactor, _context->dstFactor);
+    if (_context->depthFunc == GL_ALWAYS) {
+        RenderBackend::get()->disable(GL_DEPTH_TEST);
+    } else {
+        RenderBackend::get()->enable(GL_DEPTH_TEST);
+        RenderBackend::get()->depthFunc(_context->depthFunc);
+    }
+    if (texture != nullptr) {
+        texture->bind();
+    }
+    if (type & TYPE_SCISSOR) {
+        // Everything is flushed, so the first block is free
+        float data[40];
+        _scissor->getData(data);
+        std::memset(data+16,0,24*sizeof(float));
+        _unifbuff->setUniformfv(0,0,40,data);
+        _unifbuff->activate();
+        _unifbuff->flush();
+        _unifbuff->setBlock(0);
+    }
+    
+    _instbuff->loadVertexData(quad, 4);
+    _instbuff->loadIndexData(indices, 6);
+    _instbuff->loadInstanceData(instances, (GLsizei)count);
+    _instbuff->drawInstanced(GL_TRIANGLES, 6, (GLsizei)count);
+    if (type & TYPE_SCISSOR) {
+        _unifbuff->deactivate();
+    }
+    
+    _vertTotal += 6*(unsigned int)count;
+    _callTotal++;
+    
+    // Restore the standard pipeline, reapplying all uniforms on next flush
+    _shader->bind();
+    _vertbuff->bind();
+    _context->dirty = DIRTY_ALL_VALS;
+}
+
+
 #pragma mark -
 #pragma mark Outlines
 /**
@@ -2094,6 +2334,51 @@ void SpriteBatch::blurTexture(const std::shared_ptr<Texture>& texture, GLuint st
     _shader->setUniform2f("uBlur",size.width,size.height);
 }
 
+/**
+ * Allocates the shader and vertex buffer for instanced sprites.
+ *
+ * These are only allocated the first time that they are needed. If the
+ * shader fails to compile, this method records the failure so that later
+ * calls to {@link #fillInstances} fall back to normal quads.
+ *
+ * @return true if instancing is available.
+ */
+bool SpriteBatch::initInstancing() {
+    _instShader = Shader::alloc(SHADER(oglInstanceVert),SHADER(oglShaderFrag));
+    if (_instShader != nullptr) {
+        _instbuff = VertexBuffer::alloc(sizeof(SpriteVertex3),sizeof(SpriteInstance));
+    }
+    if (_instbuff == nullptr) {
+        CUWarn("Instanced sprites are not supported; drawing quads instead");
+        _instShader = nullptr;
+        _instFailed = true;
+        return false;
+    }
+    
+    _instbuff->setupAttribute("aPosition", 3, GL_FLOAT, GL_FALSE, 0);
+    _instbuff->setupAttribute("aColor",    4, GL_FLOAT, GL_TRUE,
+                              offsetof(cugl::SpriteVertex3,color));
+    _instbuff->setupAttribute("aTexCoord", 2, GL_FLOAT, GL_FALSE,
+                              offsetof(cugl::SpriteVertex3,texcoord));
+    _instbuff->setupInstanceAttribute("aOffset", 2, GL_FLOAT, GL_FALSE,
+                                      offsetof(cugl::SpriteInstance,position));
+    _instbuff->setupInstanceAttribute("aScale",  2, GL_FLOAT, GL_FALSE,
+                                      offsetof(cugl::SpriteInstance,scale));
+    _instbuff->setupInstanceAttribute("aAngle",  1, GL_FLOAT, GL_FALSE,
+                                      offsetof(cugl::SpriteInstance,angle));
+    _instbuff->setupInstanceAttribute("aTint",   4, GL_UNSIGNED_BYTE, GL_TRUE,
+                                      offsetof(cugl::SpriteInstance,color));
+    _instbuff->setupInstanceAttribute("aFrame",  4, GL_FLOAT, GL_FALSE,
+                                      offsetof(cugl::SpriteInstance,frame));
+    _instbuff->attach(_instShader);
+    _instShader->setUniformBlock("uContext",_unifbuff);
+    
+    // Restore the standard pipeline
+    _shader->bind();
+    _vertbuff->bind();
+    return true;
+}
+
 /**
  * Returns the number of vertices added to the drawing buffer.
  *
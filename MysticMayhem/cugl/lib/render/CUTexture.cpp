@@ -32,9 +32,11 @@
 #include <SDL/SDL.h>
 #include <SDL/SDL_image.h>
 #include <sstream>
+#include <algorithm>
 #include <cugl/util/CUDebug.h>
 #include <cugl/util/CUFiletools.h>
 #include <cugl/render/CUTexture.h>
+#include <cugl/render/CURenderBackend.h>
 
 using namespace cugl;
 
@@ -177,6 +179,7 @@ _magFilter(GL_LINEAR),
 _wrapS(GL_CLAMP_TO_EDGE),
 _wrapT(GL_CLAMP_TO_EDGE),
 _hasMipmaps(false),
+_compression(0),
 _parent(nullptr),
 _bindpoint(0),
 _minS(0),
@@ -194,7 +197,7 @@ void Texture::dispose() {
     if (_buffer != 0) {
         // Do we own the texture?
         if (_parent == nullptr) {
-            glDeleteTextures(1, &_buffer);
+            RenderBackend::get()->deleteTextures(1, &_buffer);
         }
         _buffer = 0;
         _width = 0; _height = 0;
@@ -206,6 +209,7 @@ void Texture::dispose() {
         _minS = _minT = 0;
         _maxS = _maxT = 1;
         _hasMipmaps = false;
+        _compression = 0;
         _bindpoint  = 0;
         _dirty = false;
     }
@@ -238,9 +242,9 @@ bool Texture::initWithData(const void *data, int width, int height, Texture::Pix
         return false; // In case asserts are off.
     }
     
-    glGenTextures(1, &_buffer);
+    RenderBackend::get()->genTextures(1, &_buffer);
     if (_buffer == 0) {
-        error = glGetError();
+        error = RenderBackend::get()->getError();
         CULogError("Could not allocate texture. %s", gl_error_name(error).c_str());
         return false;
     }
@@ -248,27 +252,27 @@ bool Texture::initWithData(const void *data, int width, int height, Texture::Pix
     _width  = width;
     _height = height;
     _pixelFormat = format;
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, _buffer);
+    RenderBackend::get()->activeTexture(GL_TEXTURE0);
+    RenderBackend::get()->bindTexture(GL_TEXTURE_2D, _buffer);
 
     GLint  internal = internal_format(format);
     GLenum datatype = format_type(format);
-    glTexImage2D(GL_TEXTURE_2D, 0, internal, width, height, 0, (GLenum)format, datatype, data);
+    RenderBackend::get()->texImage2D(GL_TEXTURE_2D, 0, internal, width, height, 0, (GLenum)format, datatype, data);
     
-    error = glGetError();
+    error = RenderBackend::get()->getError();
     if (error) {
         CULogError("Could not initialize texture. %s", gl_error_name(error).c_str());
-        glDeleteTextures(1, &_buffer);
+        RenderBackend::get()->deleteTextures(1, &_buffer);
         _buffer = 0;
         return false;
     }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _minFilter);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _magFilter);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _wrapS);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _wrapT);
+    RenderBackend::get()->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _minFilter);
+    RenderBackend::get()->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _magFilter);
+    RenderBackend::get()->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _wrapS);
+    RenderBackend::get()->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _wrapT);
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    RenderBackend::get()->bindTexture(GL_TEXTURE_2D, 0);
     std::stringstream ss;
     ss << "@" << data;
     setName(ss.str());
@@ -284,6 +288,8 @@ bool Texture::initWithData(const void *data, int width, int height, Texture::Pix
  *
  * This method can load any file format supported by SDL_Image.  This
  * includes (but is not limited to) PNG, JPEG, GIF, TIFF, BMP and PCX.
+ * It also loads block-compressed images from KTX and KTX2 containers
+ * (files ending in .ktx or .ktx2), as in {@link initWithImage}.
  *
  * The texture will be stored in RGBA format, even if it is a file format
  * that does not support transparency (e.g. JPEG).
@@ -294,6 +300,18 @@ bool Texture::initWithData(const void *data, int width, int height, Texture::Pix
  */
 bool Texture::initWithFile(const std::string filename) {
     std::string fullpath = filetool::normalize_path(filename);
+    std::string suffix = filetool::base_suffix(fullpath);
+    if (suffix == "ktx" || suffix == "ktx2") {
+        std::shared_ptr<CompressedImage> image = CompressedImage::alloc(fullpath);
+        if (image == nullptr) {
+            CULogError("Could not load file %s.", filename.c_str());
+            return false;
+        }
+        bool result = initWithImage(image);
+        if (result) setName(filename);
+        return result;
+    }
+    
     SDL_Surface* surface = IMG_Load(fullpath.c_str());
     if (surface == nullptr) {
         CULogError("Could not load file %s. %s", filename.c_str(), SDL_GetError());
@@ -318,6 +336,79 @@ bool Texture::initWithFile(const std::string filename) {
     return result;
 }
 
+/**
+ * Initializes a texture with the given block-compressed image.
+ *
+ * Initializing a texture requires the use of texture offset 0.  Any texture
+ * bound to that offset will be unbound.  In addition, once initialization
+ * is done, this texture will not longer be bound as well.
+ *
+ * The blocks are uploaded as is, together with every mipmap level in the
+ * image. The graphics card must support the image format (see
+ * {@link CompressedImage#isSupported}). A compressed texture cannot be
+ * modified with {@link set}, and cannot build its own mipmaps.
+ *
+ * @param image     The compressed image
+ *
+ * @return true if initialization was successful.
+ */
+bool Texture::initWithImage(const std::shared_ptr<CompressedImage>& image) {
+    GLenum error;
+    if (_buffer) {
+        CUAssertLog(false, "Texture is already initialized");
+        return false; // In case asserts are off.
+    } else if (image == nullptr || image->getLevelCount() == 0) {
+        CUAssertLog(false, "The compressed image is empty");
+        return false;
+    }
+    
+    RenderBackend* backend = RenderBackend::get();
+    backend->genTextures(1, &_buffer);
+    if (_buffer == 0) {
+        error = backend->getError();
+        CULogError("Could not allocate texture. %s", gl_error_name(error).c_str());
+        return false;
+    }
+    
+    _width  = image->getWidth();
+    _height = image->getHeight();
+    _pixelFormat = image->hasAlpha() ? PixelFormat::RGBA : PixelFormat::RGB;
+    _compression = image->getFormat();
+    backend->activeTexture(GL_TEXTURE0);
+    backend->bindTexture(GL_TEXTURE_2D, _buffer);
+    
+    Uint32 levels = image->getLevelCount();
+    for(Uint32 ii = 0; ii < levels; ii++) {
+        GLsizei width  = std::max(_width >> ii, (GLuint)1);
+        GLsizei height = std::max(_height >> ii, (GLuint)1);
+        backend->compressedTexImage2D(GL_TEXTURE_2D, ii, _compression, width, height, 0,
+                                      (GLsizei)image->getLevelSize(ii), image->getLevel(ii));
+    }
+    
+    error = backend->getError();
+    if (error) {
+        CULogError("Could not initialize texture. %s", gl_error_name(error).c_str());
+        backend->deleteTextures(1, &_buffer);
+        _buffer = 0;
+        _compression = 0;
+        return false;
+    }
+    
+    // The texture is only complete up to the levels that we have
+    _hasMipmaps = levels > 1;
+    backend->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels-1);
+    backend->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _minFilter);
+    backend->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _magFilter);
+    backend->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _wrapS);
+    backend->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _wrapT);
+    
+    backend->bindTexture(GL_TEXTURE_2D, 0);
+    std::stringstream ss;
+    ss << "@" << image.get();
+    setName(ss.str());
+    return true;
+}
+
 /**
  * Returns a blank texture that can be used to make solid shapes.
  *
@@ -366,9 +457,12 @@ const Texture& Texture::set(const void *data) {
     if (!isActive()) {
         CUAssertLog(false,"Texture %s is not currently active.",_name.c_str());
         return *this;
+    } else if (_compression) {
+        CUAssertLog(false,"Texture %s is compressed.",_name.c_str());
+        return *this;
     }
 
-    glTexImage2D(GL_TEXTURE_2D, 0, (GLenum)_pixelFormat, _width, _height, 0,
+    RenderBackend::get()->texImage2D(GL_TEXTURE_2D, 0, (GLenum)_pixelFormat, _width, _height, 0,
                  (GLenum)_pixelFormat, GL_UNSIGNED_BYTE, data);
     return *this;
 }
@@ -412,13 +506,19 @@ unsigned int Texture::getByteSize() const {
  * texture size is a power of two.
  *
  * This method is only successful if the texture is currently active.
+ * It does nothing to a compressed texture, whose mipmaps (if any) came
+ * with the compressed image.
  */
 void Texture::buildMipMaps() {
+    if (_compression) {
+        // Compressed formats cannot be rendered to; the mipmaps come from the file
+        return;
+    }
     CUAssertLog(nextPOT(_width)  == _width,  "Width  %d is not a power of two", _width);
     CUAssertLog(nextPOT(_height) == _height, "Height %d is not a power of two", _height);
     CUAssertLog(_parent == nullptr, "Cannot build mipmaps for a subtexture");
     CUAssertLog(isActive(), "Texture is not active");
-    glGenerateMipmap(GL_TEXTURE_2D);
+    RenderBackend::get()->generateMipmap(GL_TEXTURE_2D);
     _hasMipmaps = true;
 }
 
@@ -440,7 +540,7 @@ void Texture::setMinFilter(GLuint minFilter) {
     CUAssertLog(_parent == nullptr, "Cannot set filters for a subtexture");
     _minFilter = minFilter;
     if (isActive()) {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _minFilter);
+        RenderBackend::get()->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _minFilter);
     } else {
     	_dirty = true;
     }
@@ -464,7 +564,7 @@ void Texture::setMagFilter(GLuint magFilter) {
     CUAssertLog(_parent == nullptr, "Cannot set filters for a subtexture");
     _magFilter = magFilter;
     if (isActive()) {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _magFilter);
+        RenderBackend::get()->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _magFilter);
 	} else {
     	_dirty = true;
     }
@@ -487,7 +587,7 @@ void Texture::setWrapS(GLuint wrap) {
     CUAssertLog(_parent == nullptr, "Cannot set wrap S for a subtexture");
     _wrapS = wrap;
     if (isActive()) {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _wrapS);
+        RenderBackend::get()->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _wrapS);
 	} else {
     	_dirty = true;
     }
@@ -510,7 +610,7 @@ void Texture::setWrapT(GLuint wrap) {
     CUAssertLog(_parent == nullptr, "Cannot set wrap T for a subtexture");
     _wrapT = wrap;
     if (isActive()) {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _wrapT);
+        RenderBackend::get()->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _wrapT);
 	} else {
     	_dirty = true;
     }
@@ -558,6 +658,7 @@ std::shared_ptr<Texture> Texture::getSubTexture(GLfloat minS, GLfloat maxS,
     result->_buffer = source->_buffer;
     result->_parent = source;
     result->_pixelFormat = source->_pixelFormat;
+    result->_compression = source->_compression;
     result->_name = source->_name;
     
     // Filters, wrap, and binding defer to parent.
@@ -594,19 +695,19 @@ std::shared_ptr<Texture> Texture::getSubTexture(GLfloat minS, GLfloat maxS,
  */
 void Texture::setBindPoint(GLuint point) {
     GLint orig;
-    glGetIntegerv(GL_ACTIVE_TEXTURE,&orig);
+    RenderBackend::get()->getIntegerv(GL_ACTIVE_TEXTURE,&orig);
     if (orig != _bindpoint+GL_TEXTURE0) {
-        glActiveTexture(GL_TEXTURE0+_bindpoint);
+        RenderBackend::get()->activeTexture(GL_TEXTURE0+_bindpoint);
     }
     GLint bind;
-    glGetIntegerv(GL_TEXTURE_BINDING_2D, &bind);
+    RenderBackend::get()->getIntegerv(GL_TEXTURE_BINDING_2D, &bind);
     if (bind == _buffer) {
-        glBindTexture(GL_TEXTURE_2D, 0);
+        RenderBackend::get()->bindTexture(GL_TEXTURE_2D, 0);
     }
     if (orig != _bindpoint+GL_TEXTURE0) {
-        glActiveTexture(orig);
+        RenderBackend::get()->activeTexture(orig);
     }
-    GLenum error = glGetError();
+    GLenum error = RenderBackend::get()->getError();
     CUAssertLog(error == GL_NO_ERROR, "Texture: %s", gl_error_name(error).c_str());
     _bindpoint = point;
 }
@@ -633,13 +734,13 @@ void Texture::bind() {
         return;
     }
     
-    glActiveTexture(GL_TEXTURE0+_bindpoint);
-    glBindTexture(GL_TEXTURE_2D,_buffer);
+    RenderBackend::get()->activeTexture(GL_TEXTURE0+_bindpoint);
+    RenderBackend::get()->bindTexture(GL_TEXTURE_2D,_buffer);
     if (_dirty) {
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _minFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _magFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _wrapS);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _wrapT);
+		RenderBackend::get()->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _minFilter);
+		RenderBackend::get()->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _magFilter);
+		RenderBackend::get()->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _wrapS);
+		RenderBackend::get()->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _wrapT);
 		_dirty = false;    
     }
 }
@@ -662,13 +763,13 @@ void Texture::unbind() {
     }
 
     GLint orig;
-    glGetIntegerv(GL_ACTIVE_TEXTURE,&orig);
+    RenderBackend::get()->getIntegerv(GL_ACTIVE_TEXTURE,&orig);
     if (orig != _bindpoint+GL_TEXTURE0) {
-        glActiveTexture(GL_TEXTURE0+_bindpoint);
+        RenderBackend::get()->activeTexture(GL_TEXTURE0+_bindpoint);
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
+    RenderBackend::get()->bindTexture(GL_TEXTURE_2D, 0);
     if (orig != _bindpoint+GL_TEXTURE0) {
-        glActiveTexture(orig);
+        RenderBackend::get()->activeTexture(orig);
     }
 }
 
@@ -691,15 +792,15 @@ bool Texture::isBound() const {
     }
     
     GLint orig;
-    glGetIntegerv(GL_ACTIVE_TEXTURE,&orig);
+    RenderBackend::get()->getIntegerv(GL_ACTIVE_TEXTURE,&orig);
     if (orig != _bindpoint+GL_TEXTURE0) {
-        glActiveTexture(GL_TEXTURE0+_bindpoint);
+        RenderBackend::get()->activeTexture(GL_TEXTURE0+_bindpoint);
     }
     GLint bind;
-    glGetIntegerv(GL_TEXTURE_BINDING_2D, &bind);
+    RenderBackend::get()->getIntegerv(GL_TEXTURE_BINDING_2D, &bind);
     bool result = (bind == _buffer);
     if (orig != _bindpoint+GL_TEXTURE0) {
-        glActiveTexture(orig);
+        RenderBackend::get()->activeTexture(orig);
     }
     return result;
 }
@@ -722,12 +823,12 @@ bool Texture::isActive() const {
         return false;
     }
     GLint orig;
-    glGetIntegerv(GL_ACTIVE_TEXTURE,&orig);
+    RenderBackend::get()->getIntegerv(GL_ACTIVE_TEXTURE,&orig);
     if (orig != _bindpoint+GL_TEXTURE0) {
         return false;
     }
     GLint bind;
-    glGetIntegerv(GL_TEXTURE_BINDING_2D, &bind);
+    RenderBackend::get()->getIntegerv(GL_TEXTURE_BINDING_2D, &bind);
     return (bind == _buffer);
 }
 
@@ -785,6 +886,12 @@ bool Texture::save(const std::string file) {
     } else if (!filetool::is_absolute(file)) {
         CUAssertLog(false, "Data may not be saved to the asset directory.");
         return false;
+    } else if (!RenderBackend::get()->isHardware()) {
+        CULogError("Could not write file %s. No graphics context.", file.c_str());
+        return false;
+    } else if (_compression) {
+        CULogError("Could not write file %s. Texture %s is compressed.", file.c_str(), _name.c_str());
+        return false;
     }
 
     // Make sure file is named properly.
@@ -810,8 +917,8 @@ bool Texture::save(const std::string file) {
     SDL_Surface* surface;
     unsigned int bsize = getByteSize();
     unsigned char* buffer = (unsigned char*)malloc(bsize*_width*_height);
-    glGetTexImage(GL_TEXTURE_2D,0,(GLenum)_pixelFormat,format_type(_pixelFormat),buffer);
-    GLenum error = glGetError();
+    RenderBackend::get()->getTexImage(GL_TEXTURE_2D,0,(GLenum)_pixelFormat,format_type(_pixelFormat),buffer);
+    GLenum error = RenderBackend::get()->getError();
     if (error) {
         CULogError("Could not write file %s. %s", file.c_str(), gl_error_name(error).c_str());
         free(buffer);
@@ -44,6 +44,7 @@
 //  Version: 2/29/20
 #include <cugl/util/CUDebug.h>
 #include <cugl/render/CUUniformBuffer.h>
+#include <cugl/render/CURenderBackend.h>
 
 using namespace cugl;
 
@@ -116,13 +117,13 @@ bool UniformBuffer::init(GLsizei capacity, GLuint blocks) {
     _blocksize = capacity;
     
     GLint value;
-    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &value);
+    RenderBackend::get()->getIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &value);
     while (_blockstride < _blocksize) {
         _blockstride += value;
     }
     
     // Quit if the memory request is too high
-    glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &value);
+    RenderBackend::get()->getIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &value);
     if (_blockstride > value) {
         CUAssertLog(false,"Capacity exceeds maximum value of %d bytes",value);
         _blockcount  = 0;
@@ -132,26 +133,26 @@ bool UniformBuffer::init(GLsizei capacity, GLuint blocks) {
     }    
     
     GLenum error;
-    glGenBuffers(1, &_dataBuffer);
+    RenderBackend::get()->genBuffers(1, &_dataBuffer);
     if (!_dataBuffer) {
-        error = glGetError();
+        error = RenderBackend::get()->getError();
         CULogError("Could not create uniform buffer. %s", gl_error_name(error).c_str());
         return false;
     }
 
     _bytebuffer = (char*)malloc(_blockstride*_blockcount);
-    glBindBuffer(GL_UNIFORM_BUFFER, _dataBuffer);
-    glBufferData(GL_UNIFORM_BUFFER, _blockstride*_blockcount, NULL, _drawtype);
-    error = glGetError();
+    RenderBackend::get()->bindBuffer(GL_UNIFORM_BUFFER, _dataBuffer);
+    RenderBackend::get()->bufferData(GL_UNIFORM_BUFFER, _blockstride*_blockcount, NULL, _drawtype);
+    error = RenderBackend::get()->getError();
     if (error) {
-        glDeleteBuffers(1, &_dataBuffer);
+        RenderBackend::get()->deleteBuffers(1, &_dataBuffer);
         _dataBuffer = 0;
         CULogError("Could not allocate memory for uniform buffer. %s",
                    gl_error_name(error).c_str());
         return false;
     }
     
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    RenderBackend::get()->bindBuffer(GL_UNIFORM_BUFFER, 0);
     return true;
 }
 
@@ -162,7 +163,7 @@ bool UniformBuffer::init(GLsizei capacity, GLuint blocks) {
  */
 void UniformBuffer::dispose() {
     if (_dataBuffer) {
-        glDeleteBuffers(1,&_dataBuffer);
+        RenderBackend::get()->deleteBuffers(1,&_dataBuffer);
         _dataBuffer = 0;
     }
     if (_bytebuffer) {
@@ -199,9 +200,9 @@ void UniformBuffer::dispose() {
  */
 void UniformBuffer::setBindPoint(GLuint point) {
     GLint bound;
-    glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING,_bindpoint,&bound);
+    RenderBackend::get()->getIntegeri_v(GL_UNIFORM_BUFFER_BINDING,_bindpoint,&bound);
     if (bound == _dataBuffer) {
-        glBindBufferBase(GL_UNIFORM_BUFFER, _bindpoint, 0);
+        RenderBackend::get()->bindBufferBase(GL_UNIFORM_BUFFER, _bindpoint, 0);
     }
     _bindpoint = point;
 }
@@ -230,7 +231,7 @@ void UniformBuffer::bind(bool activate) {
     if (activate) {
         this->activate();
     }
-    glBindBufferBase(GL_UNIFORM_BUFFER, _bindpoint, _dataBuffer);
+    RenderBackend::get()->bindBufferBase(GL_UNIFORM_BUFFER, _bindpoint, _dataBuffer);
 }
 
 /**
@@ -248,9 +249,9 @@ void UniformBuffer::bind(bool activate) {
  */
 void UniformBuffer::unbind() {
     GLint bound;
-    glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING,_bindpoint,&bound);
+    RenderBackend::get()->getIntegeri_v(GL_UNIFORM_BUFFER_BINDING,_bindpoint,&bound);
     if (bound == _dataBuffer) {
-        glBindBufferBase(GL_UNIFORM_BUFFER, _bindpoint, 0);
+        RenderBackend::get()->bindBufferBase(GL_UNIFORM_BUFFER, _bindpoint, 0);
     }
 }
 
@@ -269,9 +270,9 @@ void UniformBuffer::unbind() {
  * This call is reentrant.  If can be safely called multiple times.
  */
 void UniformBuffer::activate() {
-    glBindBuffer(GL_UNIFORM_BUFFER, _dataBuffer);
+    RenderBackend::get()->bindBuffer(GL_UNIFORM_BUFFER, _dataBuffer);
     if (_autoflush && _dirty) {
-        glBufferData(GL_UNIFORM_BUFFER,_blockstride*_blockcount,_bytebuffer,_drawtype);
+        RenderBackend::get()->bufferData(GL_UNIFORM_BUFFER,_blockstride*_blockcount,_bytebuffer,_drawtype);
         _dirty = false;
     }
 }
@@ -290,12 +291,12 @@ void UniformBuffer::activate() {
 void UniformBuffer::deactivate() {
 #if CU_PLATFORM == CU_PLATFORM_ANDROID
  	// There are problems with this query on emulator
- 	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+ 	RenderBackend::get()->bindBuffer(GL_UNIFORM_BUFFER, 0);
 #else
 	GLint bound;
-    glGetIntegerv(GL_UNIFORM_BUFFER_BINDING,&bound);
+    RenderBackend::get()->getIntegerv(GL_UNIFORM_BUFFER_BINDING,&bound);
     if (bound == _dataBuffer) {
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        RenderBackend::get()->bindBuffer(GL_UNIFORM_BUFFER, 0);
     }
 #endif
 }
@@ -311,7 +312,7 @@ void UniformBuffer::deactivate() {
  */
 bool UniformBuffer::isBound() const {
     GLint bound;
-    glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING,_bindpoint,&bound);
+    RenderBackend::get()->getIntegeri_v(GL_UNIFORM_BUFFER_BINDING,_bindpoint,&bound);
     return bound == _dataBuffer;
 }
     
@@ -330,7 +331,7 @@ bool UniformBuffer::isBound() const {
  */
 bool UniformBuffer::isActive() const {
     GLint bound;
-    glGetIntegerv(GL_UNIFORM_BUFFER_BINDING,&bound);
+    RenderBackend::get()->getIntegerv(GL_UNIFORM_BUFFER_BINDING,&bound);
     return bound == _dataBuffer;
 }
 
@@ -347,7 +348,7 @@ void UniformBuffer::setBlock(GLuint block) {
     CUAssertLog(isBound(), "Buffer is not bound.");
     if (_blockpntr != block) {
         _blockpntr = block;
-        glBindBufferRange(GL_UNIFORM_BUFFER,_bindpoint,_dataBuffer,
+        RenderBackend::get()->bindBufferRange(GL_UNIFORM_BUFFER,_bindpoint,_dataBuffer,
                           block*_blockstride,_blocksize);
     }
 }
@@ -362,7 +363,7 @@ void UniformBuffer::setBlock(GLuint block) {
  */
 void UniformBuffer::flush() {
     // CUAssertLog(isActive(), "Buffer is not active."); // Problems on android emulator for now
-    glBufferData(GL_UNIFORM_BUFFER,_blockstride*_blockcount,_bytebuffer,_drawtype);
+    RenderBackend::get()->bufferData(GL_UNIFORM_BUFFER,_blockstride*_blockcount,_bytebuffer,_drawtype);
     _dirty = false;
 }
 
@@ -1237,7 +1238,7 @@ void UniformBuffer::setUniformfv(GLint block, GLsizei offset, GLsizei size, cons
         GLsizei position = block*_blockstride+offset;
         std::memcpy(_bytebuffer+position, values, size*sizeof(float));
         if (_autoflush && isActive()) {
-            glBufferSubData(GL_UNIFORM_BUFFER, position, size*sizeof(float), values);
+            RenderBackend::get()->bufferSubData(GL_UNIFORM_BUFFER, position, size*sizeof(float), values);
         } else {
             _dirty = true;
         }
@@ -1252,7 +1253,7 @@ void UniformBuffer::setUniformfv(GLint block, GLsizei offset, GLsizei size, cons
             GLsizei position = block*_blockstride+offset;
             std::memcpy(_bytebuffer+position, values, size*sizeof(float));
             if (active) {
-                glBufferSubData(GL_UNIFORM_BUFFER, position, size*sizeof(float), values);
+                RenderBackend::get()->bufferSubData(GL_UNIFORM_BUFFER, position, size*sizeof(float), values);
             }
         }
     }
@@ -1354,7 +1355,7 @@ void UniformBuffer::setUniformiv(GLint block, GLsizei offset, GLsizei size, cons
         GLsizei position = block*_blockstride+offset;
         std::memcpy(_bytebuffer+position, values, size*sizeof(GLint));
         if (_autoflush && isActive()) {
-            glBufferSubData(GL_UNIFORM_BUFFER, position, size*sizeof(GLint), values);
+            RenderBackend::get()->bufferSubData(GL_UNIFORM_BUFFER, position, size*sizeof(GLint), values);
         } else {
             _dirty = true;
         }
@@ -1369,7 +1370,7 @@ void UniformBuffer::setUniformiv(GLint block, GLsizei offset, GLsizei size, cons
             GLsizei position = block*_blockstride+offset;
             std::memcpy(_bytebuffer+position, values, size*sizeof(GLint));
             if (active) {
-                glBufferSubData(GL_UNIFORM_BUFFER, position, size*sizeof(GLint), values);
+                RenderBackend::get()->bufferSubData(GL_UNIFORM_BUFFER, position, size*sizeof(GLint), values);
             }
         }
     }
@@ -1471,7 +1472,7 @@ void UniformBuffer::setUniformuiv(GLint block, GLsizei offset, GLsizei size, con
         GLsizei position = block*_blockstride+offset;
         std::memcpy(_bytebuffer+position, values, size*sizeof(GLuint));
         if (_autoflush && isActive()) {
-            glBufferSubData(GL_UNIFORM_BUFFER, position, size*sizeof(GLuint), values);
+            RenderBackend::get()->bufferSubData(GL_UNIFORM_BUFFER, position, size*sizeof(GLuint), values);
         } else {
             _dirty = true;
         }
@@ -1486,7 +1487,7 @@ void UniformBuffer::setUniformuiv(GLint block, GLsizei offset, GLsizei size, con
             GLsizei position = block*_blockstride+offset;
             std::memcpy(_bytebuffer+position, values, size*sizeof(GLuint));
             if (active) {
-                glBufferSubData(GL_UNIFORM_BUFFER, position, size*sizeof(GLuint), values);
+                RenderBackend::get()->bufferSubData(GL_UNIFORM_BUFFER, position, size*sizeof(GLuint), values);
             }
         }
     }
@@ -33,6 +33,7 @@
 #include <cugl/render/CUVertexBuffer.h>
 #include <cugl/render/CUShader.h>
 #include <cugl/render/CUTexture.h>
+#include <cugl/render/CURenderBackend.h>
 
 using namespace cugl;
 
@@ -46,7 +47,9 @@ VertexBuffer::VertexBuffer() :
 _vertArray(0),
 _vertBuffer(0),
 _indxBuffer(0),
-_stride(0) {
+_instBuffer(0),
+_stride(0),
+_instStride(0) {
     _shader = nullptr;
 }
 
@@ -73,32 +76,63 @@ VertexBuffer::~VertexBuffer() {
  * @return true if initialization was successful.
  */
 bool VertexBuffer::init(GLsizei stride) {
+    return init(stride,0);
+}
+
+/**
+ * Initializes this vertex buffer to support the given strides.
+ *
+ * The stride is the size of a single piece of vertex data. The instance
+ * stride is the size of a single piece of per-instance data. If the
+ * instance stride is positive, this vertex buffer has a second array
+ * buffer for attributes that advance once per instance instead of once
+ * per vertex. See {@link #setupInstanceAttribute}.
+ *
+ * @param stride    The size of a single piece of vertex data.
+ * @param istride   The size of a single piece of instance data.
+ *
+ * @return true if initialization was successful.
+ */
+bool VertexBuffer::init(GLsizei stride, GLsizei istride) {
     _stride = stride;
-    glGenVertexArrays (1, &_vertArray);
+    _instStride = istride;
+    RenderBackend::get()->genVertexArrays(1, &_vertArray);
     if (!_vertArray) {
-        GLenum error = glGetError();
+        GLenum error = RenderBackend::get()->getError();
         CULogError("Could not create vertex array. %s", gl_error_name(error).c_str());
         return false;
     }
 
     // Generate the buffers
-    glGenBuffers(1, &_vertBuffer);
+    RenderBackend::get()->genBuffers(1, &_vertBuffer);
     if (!_vertBuffer) {
-        GLenum error = glGetError();
-        glDeleteVertexArrays(1,&_vertArray);
+        GLenum error = RenderBackend::get()->getError();
+        RenderBackend::get()->deleteVertexArrays(1,&_vertArray);
         CULogError("Could not create vertex buffer. %s", gl_error_name(error).c_str());
         return false;
     }
     
-    glGenBuffers(1, &_indxBuffer);
+    RenderBackend::get()->genBuffers(1, &_indxBuffer);
     if (!_indxBuffer) {
-        GLenum error = glGetError();
+        GLenum error = RenderBackend::get()->getError();
         CULogError("Could not create index buffer. %s", gl_error_name(error).c_str());
-        glDeleteVertexArrays(1,&_vertArray);
-        glDeleteBuffers(1,&_vertBuffer);
+        RenderBackend::get()->deleteVertexArrays(1,&_vertArray);
+        RenderBackend::get()->deleteBuffers(1,&_vertBuffer);
         return false;
     }
     
+    if (istride > 0) {
+        RenderBackend::get()->genBuffers(1, &_instBuffer);
+        if (!_instBuffer) {
+            GLenum error = RenderBackend::get()->getError();
+            CULogError("Could not create instance buffer. %s", gl_error_name(error).c_str());
+            RenderBackend::get()->deleteVertexArrays(1,&_vertArray);
+            RenderBackend::get()->deleteBuffers(1,&_vertBuffer);
+            RenderBackend::get()->deleteBuffers(1,&_indxBuffer);
+            return false;
+        }
+    }
+    
     return true;
 }
 
@@ -113,14 +147,19 @@ void VertexBuffer::dispose() {
     }
     _enabled.clear();
     _attributes.clear();
-    glDeleteBuffers(1,&_indxBuffer);
-    glDeleteBuffers(1,&_vertBuffer);
-    glDeleteVertexArrays(1,&_vertArray);
+    if (_instBuffer) {
+        RenderBackend::get()->deleteBuffers(1,&_instBuffer);
+    }
+    RenderBackend::get()->deleteBuffers(1,&_indxBuffer);
+    RenderBackend::get()->deleteBuffers(1,&_vertBuffer);
+    RenderBackend::get()->deleteVertexArrays(1,&_vertArray);
+    _instBuffer = 0;
     _indxBuffer = 0;
     _vertBuffer = 0;
     _vertArray  = 0;
     _shader = nullptr;
     _stride = 0;
+    _instStride = 0;
 }
 
 
@@ -139,9 +178,9 @@ void VertexBuffer::dispose() {
  */
 void VertexBuffer::bind() {
     CUAssertLog(_vertBuffer, "VertexBuffer has not be initialized.");
-    glBindVertexArray(_vertArray);
-	glBindBuffer( GL_ARRAY_BUFFER, _vertBuffer );
-	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _indxBuffer );
+    RenderBackend::get()->bindVertexArray(_vertArray);
+	RenderBackend::get()->bindBuffer( GL_ARRAY_BUFFER, _vertBuffer );
+	RenderBackend::get()->bindBuffer( GL_ELEMENT_ARRAY_BUFFER, _indxBuffer );
     if (_shader != nullptr) {
         _shader->bind();
     }
@@ -160,9 +199,9 @@ void VertexBuffer::bind() {
  */
 void VertexBuffer::unbind() {
     if (isBound()) {
-        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
-        glBindBuffer( GL_ARRAY_BUFFER, 0 );
-        glBindVertexArray(0);
+        RenderBackend::get()->bindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+        RenderBackend::get()->bindBuffer( GL_ARRAY_BUFFER, 0 );
+        RenderBackend::get()->bindVertexArray(0);
     }
 }
 
@@ -185,20 +224,18 @@ void VertexBuffer::attach(const std::shared_ptr<Shader>& shader) {
         // Link up attributes on the first time
         for(auto it = _attributes.begin(); it != _attributes.end(); ++it) {
             std::string name = it->first;
-			GLint pos = glGetAttribLocation(_shader->getProgram(), name.c_str());
+			GLint pos = RenderBackend::get()->getAttribLocation(_shader->getProgram(), name.c_str());
 			if (pos == -1) {
 				CUWarn("Active shader has no attribute %s", name.c_str());
 			} else if (_enabled[name]) {
-				glEnableVertexAttribArray(pos);
-				glVertexAttribPointer(pos,it->second.size,it->second.type,
-									  it->second.norm,_stride,
-									  reinterpret_cast<void*>(it->second.offset));
+				RenderBackend::get()->enableVertexAttribArray(pos);
+				linkAttribute(pos, it->second);
 			} else {
-				glDisableVertexAttribArray(pos);
+				RenderBackend::get()->disableVertexAttribArray(pos);
 			}
         }
 
-        GLenum error = glGetError();
+        GLenum error = RenderBackend::get()->getError();
         CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
     } else {
         bind();
@@ -226,7 +263,7 @@ std::shared_ptr<Shader> VertexBuffer::detach() {
  */
 bool VertexBuffer::isBound() const {
     GLint vao;
-    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vao);
+    RenderBackend::get()->getIntegerv(GL_VERTEX_ARRAY_BINDING, &vao);
     return vao == _vertArray;
 }
 
@@ -260,9 +297,9 @@ bool VertexBuffer::isBound() const {
  */
 void VertexBuffer::loadVertexData(const void * data, GLsizei size, GLenum usage) {
     //CUAssertLog(isBound(), "Vertex buffer is not bound"); // Problems on android emulator for now
-    glBufferData( GL_ARRAY_BUFFER, _stride * size, data, usage );
+    RenderBackend::get()->bufferData( GL_ARRAY_BUFFER, _stride * size, data, usage );
     
-    GLenum error = glGetError();
+    GLenum error = RenderBackend::get()->getError();
     CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
 }
 
@@ -294,8 +331,36 @@ void VertexBuffer::loadVertexData(const void * data, GLsizei size, GLenum usage)
  */
 void VertexBuffer::loadIndexData(const void * data, GLsizei size, GLenum usage) {
     //CUAssertLog(isBound(), "Vertex buffer is not bound"); // Problems on android emulator for now
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, size * sizeof(GLuint), data, usage );
-    GLenum error = glGetError();
+    RenderBackend::get()->bufferData( GL_ELEMENT_ARRAY_BUFFER, size * sizeof(GLuint), data, usage );
+    GLenum error = RenderBackend::get()->getError();
+    CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
+}
+
+/**
+ * Loads the instance buffer with data.
+ *
+ * The data loaded is the per-instance data that will be used at the next
+ * call to {@link #drawInstanced}. It is expected to have the size of the
+ * instance stride. This method has no effect if this buffer does not
+ * support instancing.
+ *
+ * The data usage is one of GL_STATIC_DRAW, GL_STREAM_DRAW, or GL_DYNAMIC_DRAW.
+ *
+ * This method will only succeed if this buffer is actively bound.
+ *
+ * @param data  The data to load
+ * @param size  The number of instances to load
+ * @param usage The type of data load
+ */
+void VertexBuffer::loadInstanceData(const void * data, GLsizei size, GLenum usage) {
+    if (!_instBuffer) {
+        return;
+    }
+    RenderBackend::get()->bindBuffer( GL_ARRAY_BUFFER, _instBuffer );
+    RenderBackend::get()->bufferData( GL_ARRAY_BUFFER, _instStride * size, data, usage );
+    RenderBackend::get()->bindBuffer( GL_ARRAY_BUFFER, _vertBuffer );
+    
+    GLenum error = RenderBackend::get()->getError();
     CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
 }
 
@@ -304,14 +369,14 @@ void VertexBuffer::loadIndexData(const void * data, GLsizei size, GLenum usage)
  *
  * Any call to this command will use the current texture and uniforms. If
  * the texture and/or uniforms need to be changed, then this draw command
- * will need to be broken up into chunks. Use the optional parameter 
+ * will need to be broken up into chunks. Use the optional parameter
  * offset to chunk up the draw calls without having to reload data.
  *
- * The drawing mode can be any of  GL_POINTS, GL_LINE_STRIP, GL_LINE_LOOP, 
+ * The drawing mode can be any of  GL_POINTS, GL_LINE_STRIP, GL_LINE_LOOP,
  * GL_LINES, GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN or GL_TRIANGLES.  These
  * are the only modes accepted by both OpenGL and OpenGLES. See the OpenGL
  * documentation for the number of indices required for each type.  In
- * practice the {@link Poly2} class is designed to support GL_POINTS, 
+ * practice the {@link Poly2} class is designed to support GL_POINTS,
  * GL_LINES, and GL_TRIANGLES only.
  *
  * This method will only succeed if this buffer is actively bound.
@@ -322,7 +387,7 @@ void VertexBuffer::loadIndexData(const void * data, GLsizei size, GLenum usage)
  */
 void VertexBuffer::draw(GLenum mode, GLsizei count, GLsizei offset) {
     //CUAssertLog(isBound(), "Vertex buffer is not bound"); // Problems on android emulator for now
-    glDrawElements(mode, count, GL_UNSIGNED_INT, (void*)(offset * sizeof(GLuint)));
+    RenderBackend::get()->drawElements(mode, count, GL_UNSIGNED_INT, (void*)(offset * sizeof(GLuint)));
 }
 
 /**
@@ -356,7 +421,7 @@ void VertexBuffer::draw(GLenum mode, GLsizei count, GLsizei offset) {
  */
 void VertexBuffer::drawInstanced(GLenum mode, GLsizei count, GLsizei instance, GLsizei offset) {
     //CUAssertLog(isBound(), "Vertex buffer is not bound"); // Problems on android emulator for now
-    glDrawElementsInstanced(mode, count, GL_UNSIGNED_INT, (void*)(offset * sizeof(GLuint)), instance);
+    RenderBackend::get()->drawElementsInstanced(mode, count, GL_UNSIGNED_INT, (void*)(offset * sizeof(GLuint)), instance);
 }
 
 
@@ -387,21 +452,68 @@ void VertexBuffer::setupAttribute(const std::string name, GLint size, GLenum typ
     data.norm = norm;
     data.type = type;
     data.offset = offset;
+    data.instanced = false;
+    _attributes[name] = data;
+    _enabled[name] = true;
+    
+    if (_shader != nullptr) {
+        _shader->bind();
+        GLint pos = RenderBackend::get()->getAttribLocation(_shader->getProgram(), name.c_str());
+        if (pos == -1) {
+            CUWarn("Active shader has no attribute %s", name.c_str());
+        } else {
+            RenderBackend::get()->enableVertexAttribArray(pos);
+            linkAttribute(pos, data);
+        }
+        
+        GLenum error = RenderBackend::get()->getError();
+        CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
+    }
+}
+
+/**
+ * Initializes a per-instance attribute, assigning is a size, type and offset.
+ *
+ * This method is the same as {@link #setupAttribute}, except that the
+ * attribute is read from the instance buffer and advances once per
+ * instance in {@link #drawInstanced}. The attribute offset is measured
+ * in bytes from the start of the instance data structure.
+ *
+ * This method has no effect if this buffer does not support instancing.
+ *
+ * @param name      The attribute name
+ * @param size      The attribute size in byte.
+ * @param type      The attribute type
+ * @param norm      Whether to normalize the value (floating point only)
+ * @param offset    The attribute offset in the instance data structure
+ */
+void VertexBuffer::setupInstanceAttribute(const std::string name, GLint size, GLenum type,
+                                          GLboolean norm, GLsizei offset) {
+    if (!_instBuffer) {
+        CUWarn("Vertex buffer does not support instancing");
+        return;
+    }
+    
+    AttribData data;
+    data.size = size;
+    data.norm = norm;
+    data.type = type;
+    data.offset = offset;
+    data.instanced = true;
     _attributes[name] = data;
     _enabled[name] = true;
     
     if (_shader != nullptr) {
         _shader->bind();
-        GLint pos = glGetAttribLocation(_shader->getProgram(), name.c_str());
+        GLint pos = RenderBackend::get()->getAttribLocation(_shader->getProgram(), name.c_str());
         if (pos == -1) {
             CUWarn("Active shader has no attribute %s", name.c_str());
         } else {
-            glEnableVertexAttribArray(pos);
-            glVertexAttribPointer(pos,data.size,data.type,data.norm,_stride,
-                                  reinterpret_cast<void*>(data.offset));
+            RenderBackend::get()->enableVertexAttribArray(pos);
+            linkAttribute(pos, data);
         }
         
-        GLenum error = glGetError();
+        GLenum error = RenderBackend::get()->getError();
         CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
     }
 }
@@ -423,7 +535,7 @@ void VertexBuffer::enableAttribute(const std::string name) {
 		_enabled[name] = true;
 		if (_shader != nullptr) {
 			GLint locale = _shader->getUniformLocation(name);
-			glEnableVertexAttribArray(locale);
+			RenderBackend::get()->enableVertexAttribArray(locale);
 		}
 	}
 }
@@ -445,7 +557,34 @@ void VertexBuffer::disableAttribute(const std::string name) {
 		_enabled[name] = false;
 		if (_shader != nullptr) {
 			GLint locale = _shader->getUniformLocation(name);
-			glDisableVertexAttribArray(locale);
+			RenderBackend::get()->disableVertexAttribArray(locale);
 		}
 	}    
 }
+
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Links the given attribute data to the shader location.
+ *
+ * This method binds the attribute to the correct array buffer (vertex or
+ * instance) and sets its divisor. It restores the vertex array buffer
+ * when done.
+ *
+ * @param pos   The attribute location in the active shader
+ * @param data  The attribute settings
+ */
+void VertexBuffer::linkAttribute(GLint pos, const AttribData& data) {
+    if (data.instanced) {
+        RenderBackend::get()->bindBuffer( GL_ARRAY_BUFFER, _instBuffer );
+        RenderBackend::get()->vertexAttribPointer(pos,data.size,data.type,data.norm,_instStride,
+                              reinterpret_cast<void*>(data.offset));
+        RenderBackend::get()->vertexAttribDivisor(pos, 1);
+        RenderBackend::get()->bindBuffer( GL_ARRAY_BUFFER, _vertBuffer );
+    } else {
+        RenderBackend::get()->vertexAttribPointer(pos,data.size,data.type,data.norm,_stride,
+                              reinterpret_cast<void*>(data.offset));
+        RenderBackend::get()->vertexAttribDivisor(pos, 0);
+    }
+}
@@ -0,0 +1,73 @@
+R"(////////// SHADER BEGIN /////////
+//  InstanceShader.vert
+//  Cornell University Game Library (CUGL)
+//
+//  This is an instanced SpriteBatch vertex shader for both OpenGL and OpenGL ES.
+//  It draws many copies of a single quad, where each copy has its own position,
+//  scale, rotation, tint, and texture frame. It is paired with the fragment
+//  shader SpriteShader.frag, so it supports textures and scissor masks in the
+//  same way that the standard sprite batch shader does. Gradients and blurs
+//  are not supported.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+
+// Positions (of the quad, in local space)
+in vec4 aPosition;
+out vec2 outPosition;
+
+// Colors (the sprite batch color)
+in  vec4 aColor;
+out vec4 outColor;
+
+// Texture coordinates (normalized to the quad)
+in  vec2 aTexCoord;
+out vec2 outTexCoord;
+
+// Per-instance attributes
+in vec2  aOffset;
+in vec2  aScale;
+in float aAngle;
+in vec4  aTint;
+in vec4  aFrame;
+
+// Matrices
+uniform mat4 uPerspective;
+uniform mat4 uTransform;
+
+// The texture bounds (min s, min t, max s, max t)
+uniform vec4 uTexBounds;
+
+// Transform each instance and pass through
+void main(void) {
+    vec2 scaled = aPosition.xy*aScale;
+    float c = cos(aAngle);
+    float s = sin(aAngle);
+    vec2 local = vec2(c*scaled.x-s*scaled.y, s*scaled.x+c*scaled.y)+aOffset;
+    vec4 world = uTransform*vec4(local,aPosition.z,1.0);
+    gl_Position = uPerspective*world;
+    outPosition = world.xy; // Need untransformed for scissor
+    outColor = aColor*aTint;
+    vec2 coord = aFrame.xy+aTexCoord*aFrame.zw;
+    outTexCoord = mix(uTexBounds.xy,uTexBounds.zw,coord);
+}
+
+/////////// SHADER END //////////)"
@@ -7,7 +7,7 @@ R"(////////// SHADER BEGIN /////////
 //  (which can be used simulataneously with textures, but not with colors), as
 //  well as a scissor mask.  Gradients use the color inputs as their texture
 //  coordinates. Finally, there is support for very simple blur effects, which
-//  are used for font labels.
+//  are used for font labels, and for signed distance field textures.
 //
 //  CUGL MIT License:
 //      This software is provided 'as-is', without any express or implied
@@ -35,7 +35,7 @@ R"(////////// SHADER BEGIN /////////
 precision highp float;  // highp required for gradient precision
 #endif
 
-// Bit vector for texturing, gradients, and scissoring
+// Bit vector for texturing, gradients, scissoring, blur, and distance fields
 uniform int  uType;
 // Blur offset for simple kernel blur
 uniform vec2 uBlur;
@@ -177,11 +177,18 @@ void main(void) {
     
     if (mod(fType, 2.0) == 1.0) {
         // Include texture (tinted by color or gradient)
-        if (uType >= 8) {
-            result *= blursample(outTexCoord);
+        vec4 texel;
+        if (mod(fType, 16.0) >= 8.0) {
+            texel = blursample(outTexCoord);
         } else {
-            result *= texture(uTexture, outTexCoord);
+            texel = texture(uTexture, outTexCoord);
         }
+        if (uType >= 16) {
+            // Signed distance field with the edge at 0.5
+            float edge = max(fwidth(texel.a)*0.75, 0.001);
+            texel.a = smoothstep(0.5-edge, 0.5+edge, texel.a);
+        }
+        result *= texel;
     }
     
     if (mod(fType, 8.0) >= 4.0) {
@@ -40,6 +40,7 @@
 //  Version: 7/1/16
 
 #include <cugl/scene2/CUScene2.h>
+#include <cugl/scene2/graph/CUDrawQueue.h>
 #include <cugl/util/CUStrings.h>
 #include <sstream>
 #include <algorithm>
@@ -61,7 +62,9 @@ _color(Color4::WHITE),
 _blendEquation(GL_FUNC_ADD),
 _srcFactor(GL_SRC_ALPHA),
 _dstFactor(GL_ONE_MINUS_SRC_ALPHA),
-_active(false)
+_active(false),
+_multiplies(0),
+_deferred(false)
 {}
 
 /**
@@ -76,6 +79,7 @@ void Scene2::dispose() {
     _name = "";
     _color = Color4::WHITE;
     _active = false;
+    _queue = nullptr;
 }
 
 /**
@@ -414,13 +418,38 @@ void Scene2::sortZOrder() {
  * @param batch     The SpriteBatch to draw with.
  */
 void Scene2::render(const std::shared_ptr<SpriteBatch>& batch) {
+    _multiplies = 0;
     batch->begin(_camera->getCombined());
     batch->setBlendFunc(_srcFactor, _dstFactor);
     batch->setBlendEquation(_blendEquation);
+    renderChildren(batch);
+    batch->end();
+}
 
+/**
+ * Draws all of the children in this scene with the given SpriteBatch.
+ *
+ * This method assumes that the sprite batch is actively drawing. It is
+ * used by {@link #render} once the batch has been set up, and draws the
+ * children either directly or through the draw queue, depending on
+ * whether this scene is deferred.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ */
+void Scene2::renderChildren(const std::shared_ptr<SpriteBatch>& batch) {
+    if (!_deferred) {
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            (*it)->render(batch, Mat4::IDENTITY, _color);
+        }
+        return;
+    }
+    
+    if (_queue == nullptr) {
+        _queue = scene2::DrawQueue::alloc();
+    }
+    _queue->clear();
     for(auto it = _children.begin(); it != _children.end(); ++it) {
-        (*it)->render(batch, Mat4::IDENTITY, _color);
+        (*it)->submit(*_queue, Mat4::IDENTITY, _color);
     }
-
-    batch->end();
+    _queue->flush(batch);
 }
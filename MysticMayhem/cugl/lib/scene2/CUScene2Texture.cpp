@@ -114,16 +114,13 @@ bool Scene2Texture::init(float x, float y, float width, float height) {
 void Scene2Texture::render(const std::shared_ptr<SpriteBatch>& batch) {
     Mat4 matrix = _camera->getCombined();
     matrix.scale(1, -1, 1); // Flip the y axis for texture write
+    _multiplies = 0;
     
     _target->begin();
     batch->begin(matrix);
     batch->setBlendFunc(_srcFactor, _dstFactor);
     batch->setBlendEquation(_blendEquation);
-
-    for(auto it = _children.begin(); it != _children.end(); ++it) {
-        (*it)->render(batch, Mat4::IDENTITY, _color);
-    }
-
+    renderChildren(batch);
     batch->end();
     _target->end();
 }
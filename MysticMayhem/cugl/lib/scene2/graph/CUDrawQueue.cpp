@@ -0,0 +1,490 @@
+//
+//  CUDrawQueue.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a deferred command list for rendering a scene graph.
+//  Normally a scene graph is drawn with a pre-order traversal, which forces a
+//  change of sprite batch state whenever two consecutive nodes use different
+//  textures or blend modes. In deferred mode, nodes emit draw commands into
+//  this queue instead. The queue sorts the commands by layer, texture, and
+//  blend state, and then replays them with as few state changes as possible.
+//
+//  Commands are only reordered when this is safe. Two commands may only swap
+//  their order if their bounding boxes do not overlap or if they share the
+//  same state. This guarantees that the final image is identical to the one
+//  produced by a pre-order traversal.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+#include <cugl/scene2/graph/CUDrawQueue.h>
+#include <cugl/scene2/graph/CUSceneNode.h>
+#include <cugl/render/CUSpriteBatch.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace cugl;
+using namespace cugl::scene2;
+
+/** The number of grid cells along each axis for overlap tests */
+#define GRID_SIZE   32
+
+// The sort key layout (most significant first)
+/** The number of bits for the layer */
+#define LAYER_BITS  12
+/** The number of bits for the texture identifier */
+#define TEXTR_BITS  14
+/** The number of bits for the blend identifier */
+#define BLEND_BITS  6
+/** The number of bits for the scissor index */
+#define CLIPS_BITS  8
+/** The number of bits for the submission order */
+#define ORDER_BITS  24
+
+#define ORDER_SHIFT 0
+#define CLIPS_SHIFT (ORDER_SHIFT+ORDER_BITS)
+#define BLEND_SHIFT (CLIPS_SHIFT+CLIPS_BITS)
+#define TEXTR_SHIFT (BLEND_SHIFT+BLEND_BITS)
+#define LAYER_SHIFT (TEXTR_SHIFT+TEXTR_BITS)
+
+#define ORDER_MASK  ((((Uint64)1) << ORDER_BITS)-1)
+
+#pragma mark DrawState
+/**
+ * Sets this state to batch with the given texture and blend state.
+ *
+ * The bounds are set to the bounding box of the mesh vertices. This
+ * method clears the barrier flag.
+ *
+ * @param texture   The texture identifier
+ * @param equation  The blending equation
+ * @param srcFactor The source factor for the blend function
+ * @param dstFactor The destination factor for the blend function
+ * @param mesh      The mesh drawn by the node
+ */
+void DrawState::set(const void* texture, GLenum equation, GLenum srcFactor, GLenum dstFactor,
+                    const Mesh<SpriteVertex2>& mesh) {
+    this->texture = texture;
+    blendEquation = equation;
+    this->srcFactor = srcFactor;
+    this->dstFactor = dstFactor;
+    barrier = false;
+    if (mesh.vertices.empty()) {
+        bounds = Rect::ZERO;
+        return;
+    }
+    Vec2 min = mesh.vertices[0].position;
+    Vec2 max = min;
+    for(auto it = mesh.vertices.begin()+1; it != mesh.vertices.end(); ++it) {
+        min.x = std::min(min.x, it->position.x);
+        min.y = std::min(min.y, it->position.y);
+        max.x = std::max(max.x, it->position.x);
+        max.y = std::max(max.y, it->position.y);
+    }
+    bounds.set(min, max-min);
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an empty draw queue.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a queue on
+ * the heap, use one of the static constructors instead.
+ */
+DrawQueue::DrawQueue() :
+_unsorted(0),
+_sorted(0) {
+}
+
+/**
+ * Disposes all of the resources used by this queue.
+ *
+ * A disposed queue can be safely reinitialized.
+ */
+void DrawQueue::dispose() {
+    _commands.clear();
+    _scissors.clear();
+    _clipStack.clear();
+    _keys.clear();
+    _scratch.clear();
+    _cells.clear();
+    _textures.clear();
+    _blends.clear();
+    _unsorted = 0;
+    _sorted = 0;
+}
+
+/**
+ * Initializes an empty draw queue.
+ *
+ * @return true if initialization was successful.
+ */
+bool DrawQueue::init() {
+    _cells.resize(GRID_SIZE*GRID_SIZE);
+    return true;
+}
+
+#pragma mark -
+#pragma mark Commands
+/**
+ * Removes all commands from this queue.
+ *
+ * This method does not release any memory, so that the queue can be
+ * refilled without allocation.
+ */
+void DrawQueue::clear() {
+    _commands.clear();
+    _scissors.clear();
+    _clipStack.clear();
+    _textures.clear();
+    _blends.clear();
+}
+
+/**
+ * Adds a draw command for the given node.
+ *
+ * The transform is stored by reference, so it must remain valid until
+ * the queue is flushed. The cached transforms of the scene graph have
+ * this property.
+ *
+ * @param node      The node to draw
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to draw with.
+ * @param state     The sprite batch state of the node.
+ */
+void DrawQueue::push(SceneNode* node, const Mat4& transform, Color4 tint, const DrawState& state) {
+    _commands.emplace_back();
+    Command& cmd = _commands.back();
+    cmd.node = node;
+    cmd.transform = &transform;
+    cmd.tint = tint;
+    cmd.barrier = state.barrier;
+    cmd.render = false;
+    cmd.clip = _clipStack.empty() ? 0 : _clipStack.back();
+    if (state.barrier) {
+        cmd.texture = 0;
+        cmd.blend = 0;
+    } else {
+        cmd.texture = getTextureKey(state.texture);
+        cmd.blend = getBlendKey(state.blendEquation, state.srcFactor, state.dstFactor);
+        Mat4::transform(transform, state.bounds, &cmd.bounds);
+    }
+}
+
+/**
+ * Adds a render barrier for the given node.
+ *
+ * On replay, the queue will call {@link SceneNode#render} with the given
+ * transform and tint. This is used by nodes like {@link OrderedNode}
+ * that manage the render order of their own subtree.
+ *
+ * @param node      The node to render
+ * @param transform The transform of the parent node.
+ * @param tint      The tint of the parent node.
+ */
+void DrawQueue::pushRender(SceneNode* node, const Mat4& transform, Color4 tint) {
+    DrawState state;
+    push(node, transform, tint, state);
+    _commands.back().render = true;
+}
+
+/**
+ * Pushes a scissor mask onto the queue.
+ *
+ * The mask is intersected with the current mask (if any), and applies to
+ * all commands until the matching call to {@link #popScissor}.
+ *
+ * @param scissor   The scissor mask in render space
+ */
+void DrawQueue::pushScissor(const Scissor& scissor) {
+    if (_clipStack.empty()) {
+        _scissors.push_back(scissor);
+    } else {
+        Scissor next(_scissors[_clipStack.back()-1]);
+        next.intersect(scissor, false);
+        _scissors.push_back(next);
+    }
+    _clipStack.push_back((Uint32)_scissors.size());
+}
+
+/**
+ * Restores the scissor mask active before the last {@link #pushScissor}.
+ */
+void DrawQueue::popScissor() {
+    CUAssertLog(!_clipStack.empty(), "Scissor stack underflow");
+    _clipStack.pop_back();
+}
+
+/**
+ * Sorts and draws all commands in this queue with the given sprite batch.
+ *
+ * The sprite batch should be active. This method does not clear the queue,
+ * so that the statistics remain available until the next frame.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ */
+void DrawQueue::flush(const std::shared_ptr<SpriteBatch>& batch) {
+    if (!assignLayers()) {
+        // Too many commands for the key; keep the submission order
+        for(size_t ii = 0; ii < _keys.size(); ii++) {
+            _keys[ii] = ii;
+        }
+    } else {
+        radixSort();
+    }
+    _unsorted = countBatches(false);
+    _sorted = countBatches(true);
+
+    // Capture any scissor applied outside of the scene graph
+    Scissor base;
+    bool hasBase = batch->getScissor(&base);
+
+    Uint32 clip = 0;
+    for(auto it = _keys.begin(); it != _keys.end(); ++it) {
+        const Command& cmd = _commands[(*it) & ORDER_MASK];
+        if (cmd.clip != clip) {
+            if (cmd.clip == 0) {
+                if (hasBase) {
+                    batch->setScissor(base);
+                } else {
+                    batch->setScissor(nullptr);
+                }
+            } else if (hasBase) {
+                Scissor local(base);
+                local.intersect(_scissors[cmd.clip-1], false);
+                batch->setScissor(local);
+            } else {
+                batch->setScissor(_scissors[cmd.clip-1]);
+            }
+            clip = cmd.clip;
+        }
+
+        if (cmd.render) {
+            cmd.node->render(batch, *cmd.transform, cmd.tint);
+        } else {
+            cmd.node->draw(batch, *cmd.transform, cmd.tint);
+        }
+    }
+
+    if (clip != 0) {
+        if (hasBase) {
+            batch->setScissor(base);
+        } else {
+            batch->setScissor(nullptr);
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Returns the dense identifier for the given texture.
+ *
+ * @param texture   The texture identifier
+ *
+ * @return the dense identifier for the given texture.
+ */
+Uint32 DrawQueue::getTextureKey(const void* texture) {
+    auto it = _textures.find(texture);
+    if (it != _textures.end()) {
+        return it->second;
+    }
+    Uint32 key = (Uint32)_textures.size();
+    _textures.emplace(texture, key);
+    return key;
+}
+
+/**
+ * Returns the dense identifier for the given blend state.
+ *
+ * @param equation  The blending equation
+ * @param srcFactor The source factor for the blend function
+ * @param dstFactor The destination factor for the blend function
+ *
+ * @return the dense identifier for the given blend state.
+ */
+Uint32 DrawQueue::getBlendKey(GLenum equation, GLenum srcFactor, GLenum dstFactor) {
+    // There are rarely more than two or three of these
+    for(size_t ii = 0; ii < _blends.size(); ii += 3) {
+        if (_blends[ii] == equation && _blends[ii+1] == srcFactor && _blends[ii+2] == dstFactor) {
+            return (Uint32)(ii/3);
+        }
+    }
+    _blends.push_back(equation);
+    _blends.push_back(srcFactor);
+    _blends.push_back(dstFactor);
+    return (Uint32)(_blends.size()/3-1);
+}
+
+/**
+ * Assigns a layer to every command in the queue.
+ *
+ * The layers are stored in the sort keys. This method returns false if
+ * the commands do not fit in the sort key, in which case the queue should
+ * be drawn in submission order.
+ *
+ * @return true if every command was assigned a layer
+ */
+bool DrawQueue::assignLayers() {
+    _keys.resize(_commands.size());
+    if (_commands.size() > ORDER_MASK || _textures.size() >= (1 << TEXTR_BITS) ||
+        _blends.size()/3 >= (1 << BLEND_BITS) || _scissors.size() >= (1 << CLIPS_BITS)) {
+        return false;
+    }
+
+    // The grid covers the bounds of every reorderable command
+    Rect extents;
+    bool empty = true;
+    for(auto it = _commands.begin(); it != _commands.end(); ++it) {
+        if (!it->barrier) {
+            if (empty) {
+                extents = it->bounds;
+                empty = false;
+            } else {
+                extents.merge(it->bounds);
+            }
+        }
+    }
+    float cellw = extents.size.width  > 0 ? extents.size.width/GRID_SIZE  : 1.0f;
+    float cellh = extents.size.height > 0 ? extents.size.height/GRID_SIZE : 1.0f;
+    for(auto it = _cells.begin(); it != _cells.end(); ++it) {
+        it->top = -1;
+        it->state = 0;
+        it->mixed = false;
+    }
+
+    for(size_t ii = 0; ii < _commands.size(); ii++) {
+        const Command& cmd = _commands[ii];
+        int x0 = 0, y0 = 0;
+        int x1 = GRID_SIZE-1, y1 = GRID_SIZE-1;
+        if (!cmd.barrier) {
+            x0 = (int)((cmd.bounds.getMinX()-extents.getMinX())/cellw);
+            x1 = (int)((cmd.bounds.getMaxX()-extents.getMinX())/cellw);
+            y0 = (int)((cmd.bounds.getMinY()-extents.getMinY())/cellh);
+            y1 = (int)((cmd.bounds.getMaxY()-extents.getMinY())/cellh);
+            x0 = std::max(0,std::min(x0,GRID_SIZE-1));
+            x1 = std::max(0,std::min(x1,GRID_SIZE-1));
+            y0 = std::max(0,std::min(y0,GRID_SIZE-1));
+            y1 = std::max(0,std::min(y1,GRID_SIZE-1));
+        }
+
+        Uint64 state = (((Uint64)cmd.texture) << 40) | (((Uint64)cmd.blend) << 32) | cmd.clip;
+        Sint32 layer = 0;
+        for(int yy = y0; yy <= y1; yy++) {
+            for(int xx = x0; xx <= x1; xx++) {
+                const Cell& cell = _cells[yy*GRID_SIZE+xx];
+                if (cell.top >= 0) {
+                    bool same = !cmd.barrier && !cell.mixed && cell.state == state;
+                    layer = std::max(layer, same ? cell.top : cell.top+1);
+                }
+            }
+        }
+        if (layer >= (1 << LAYER_BITS)) {
+            return false;
+        }
+
+        // A cell only keeps one state per layer (or is mixed at a barrier)
+        for(int yy = y0; yy <= y1; yy++) {
+            for(int xx = x0; xx <= x1; xx++) {
+                Cell& cell = _cells[yy*GRID_SIZE+xx];
+                if (layer > cell.top) {
+                    cell.top = layer;
+                    cell.state = state;
+                    cell.mixed = cmd.barrier;
+                }
+            }
+        }
+
+        _keys[ii] = (((Uint64)layer) << LAYER_SHIFT) | (((Uint64)cmd.texture) << TEXTR_SHIFT) |
+                    (((Uint64)cmd.blend) << BLEND_SHIFT) | (((Uint64)cmd.clip) << CLIPS_SHIFT) | ii;
+    }
+    return true;
+}
+
+/**
+ * Sorts the keys with a least-significant-digit radix sort.
+ *
+ * Passes over bytes that are the same in every key are skipped.
+ */
+void DrawQueue::radixSort() {
+    size_t size = _keys.size();
+    _scratch.resize(size);
+    Uint64* src = _keys.data();
+    Uint64* dst = _scratch.data();
+
+    // The submission order is already sorted, so skip those bytes
+    size_t counts[256];
+    for(int shift = ORDER_BITS; shift < 64; shift += 8) {
+        std::memset(counts, 0, sizeof(counts));
+        for(size_t ii = 0; ii < size; ii++) {
+            counts[(src[ii] >> shift) & 0xff]++;
+        }
+        if (size == 0 || counts[(src[0] >> shift) & 0xff] == size) {
+            continue;
+        }
+        size_t total = 0;
+        for(int ii = 0; ii < 256; ii++) {
+            size_t temp = counts[ii];
+            counts[ii] = total;
+            total += temp;
+        }
+        for(size_t ii = 0; ii < size; ii++) {
+            dst[counts[(src[ii] >> shift) & 0xff]++] = src[ii];
+        }
+        std::swap(src, dst);
+    }
+    if (src != _keys.data()) {
+        std::memcpy(_keys.data(), src, size*sizeof(Uint64));
+    }
+}
+
+/**
+ * Returns the number of state changes when drawing in the given order.
+ *
+ * @param sorted    Whether to use the sorted order
+ *
+ * @return the number of state changes when drawing in the given order.
+ */
+Uint32 DrawQueue::countBatches(bool sorted) const {
+    Uint32 result = 0;
+    const Command* prev = nullptr;
+    for(size_t ii = 0; ii < _commands.size(); ii++) {
+        const Command* next = &_commands[sorted ? (_keys[ii] & ORDER_MASK) : ii];
+        if (prev == nullptr || next->barrier || prev->barrier ||
+            next->texture != prev->texture || next->blend != prev->blend ||
+            next->clip != prev->clip) {
+            result++;
+        }
+        prev = next;
+    }
+    return result;
+}
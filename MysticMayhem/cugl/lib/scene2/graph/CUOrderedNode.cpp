@@ -44,6 +44,7 @@
 //  Author: Walker White
 //  Version: 3/7/21
 #include <cugl/scene2/graph/CUOrderedNode.h>
+#include <cugl/scene2/graph/CUDrawQueue.h>
 #include <cugl/render/CUScissor.h>
 
 using namespace cugl;
@@ -57,7 +58,7 @@ using namespace cugl::scene2;
  */
 OrderedNode::Context::Context(OrderedNode* parent) :
 node(nullptr),
-scissor(nullptr),
+scissor(-1),
 canonical(0) {
     this->parent = parent;
     tint = Color4::WHITE;
@@ -82,7 +83,7 @@ OrderedNode::Context::Context(const Context& copy) {
  */
 OrderedNode::Context::~Context() {
     node = nullptr;
-    scissor = nullptr;
+    scissor = -1;
 }
 
 /**
@@ -143,7 +144,7 @@ bool OrderedNode::Context::sortCompare(Context* a, Context* b) {
  * on the heap, use one of the static constructors instead.
  */
 OrderedNode::OrderedNode() :
-_viewport(nullptr),
+_viewport(-1),
 _order(PRE_ORDER) {
 }
 
@@ -162,7 +163,7 @@ void OrderedNode::dispose() {
         *it = nullptr;
     }
     _entries.clear();
-    _viewport = nullptr;
+    _viewport = -1;
     SceneNode::dispose();
 }
 
@@ -297,15 +298,18 @@ void OrderedNode::visit(const std::shared_ptr<SceneNode>& node, const Mat4& tran
     }
     
     // We need to capture the important sprite batch state
-    std::shared_ptr<Scissor> previous = _viewport;
-    std::shared_ptr<Scissor> current = nullptr;
+    Sint32 previous = _viewport;
     if (node->getScissor()) {
-        current = Scissor::alloc(node->getScissor());
-        current->setTransform(matrix);
-        if (previous) {
-            current = previous->getIntersection(current, false);
+        Scissor local(*node->getScissor());
+        local.setTransform(matrix);
+        if (previous >= 0) {
+            Scissor clip(_scissors[previous]);
+            clip.intersect(local, false);
+            _scissors.push_back(clip);
+        } else {
+            _scissors.push_back(local);
         }
-        _viewport = current;
+        _viewport = (Sint32)_scissors.size()-1;
     }
     
     // Identify pre or post. Block at child ordered nodes
@@ -360,23 +364,30 @@ void OrderedNode::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4&
         // Drop to standard for efficiency
         SceneNode::render(batch,transform,tint);
     } else {
-        Mat4 matrix;
-        Mat4::multiply(_combined,transform,&matrix);
+        const Mat4& matrix = getWorldCache(transform);
         Color4 color = _tintColor;
         if (_hasParentColor) {
             color *= tint;
         }
         
-        // Capture sprite batch context
-        std::shared_ptr<Scissor> active = batch->getScissor();
-        _viewport = active;
+        // Capture sprite batch context (on the stack so that we do not allocate)
+        Scissor active;
+        bool restore = batch->getScissor(&active);
+        _viewport = -1;
         if (_scissor) {
-            std::shared_ptr<Scissor> local = Scissor::alloc(_scissor);
-            local->setTransform(matrix);
-            if (active) {
-                local = active->getIntersection(local, false);
+            Scissor local(*_scissor);
+            local.setTransform(matrix);
+            if (restore) {
+                Scissor clip(active);
+                clip.intersect(local, false);
+                _scissors.push_back(clip);
+            } else {
+                _scissors.push_back(local);
             }
-            _viewport = local;
+            _viewport = 0;
+        } else if (restore) {
+            _scissors.push_back(active);
+            _viewport = 0;
         }
 
         // Build and sort
@@ -387,7 +398,12 @@ void OrderedNode::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4&
         std::sort(_entries.begin(), _entries.end(), Context::sortCompare);
         for(auto it = _entries.begin(); it != _entries.end(); ++it) {
             Context* context = *it;
-            batch->setScissor(context->scissor); // This is in render, so must be applied
+            // This is in render, so must be applied
+            if (context->scissor >= 0) {
+                batch->setScissor(_scissors[context->scissor]);
+            } else {
+                batch->setScissor(nullptr);
+            }
             if (context->node->getClassName() == getClassName()) {
                 // Render barrier at an ordered node
                 context->node->render(batch, context->transform, context->tint);
@@ -402,7 +418,34 @@ void OrderedNode::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4&
             *it = nullptr;
         }
         _entries.clear();
-        _viewport = nullptr;
-        batch->setScissor(active);
+        _scissors.clear();
+        _viewport = -1;
+        if (restore) {
+            batch->setScissor(active);
+        } else {
+            batch->setScissor(nullptr);
+        }
+    }
+}
+
+/**
+ * Submits this node and all of its children to the given draw queue.
+ *
+ * If the order is {@link Order#PRE_ORDER}, this reverts to the submit
+ * method of {@link SceneNode}. Otherwise, this node is a render barrier,
+ * and it is pushed to the queue as a single render command. Its subtree
+ * is then drawn by {@link #render} when the queue is flushed.
+ *
+ * @param queue     The draw queue to submit to.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ */
+void OrderedNode::submit(DrawQueue& queue, const Mat4& transform, Color4 tint) {
+    if (!_isVisible) { return; }
+    
+    if (_order == PRE_ORDER) {
+        SceneNode::submit(queue,transform,tint);
+    } else {
+        queue.pushRender(this,transform,tint);
     }
 }
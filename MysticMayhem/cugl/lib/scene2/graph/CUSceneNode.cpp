@@ -35,6 +35,7 @@
 //  Version: 8/20/20
 
 #include <cugl/scene2/graph/CUSceneNode.h>
+#include <cugl/scene2/graph/CUDrawQueue.h>
 #include <cugl/scene2/CUScene2.h>
 #include <cugl/scene2/layout/CULayout.h>
 #include <cugl/render/CUCamera.h>
@@ -66,6 +67,7 @@ _anchor(Vec2::ANCHOR_BOTTOM_LEFT),
 _scale(Vec2::ONE),
 _angle(0),
 _useTransform(false),
+_worldDirty(true),
 _parent(nullptr),
 _graph(nullptr),
 _zOrder(0),
@@ -266,6 +268,7 @@ void SceneNode::dispose() {
     _transform = Mat4::IDENTITY;
     _useTransform = false;
     _combined = Mat4::IDENTITY;
+    _worldDirty = true;
     _parent = nullptr;
     _graph = nullptr;
     _childOffset = -2;
@@ -300,6 +303,7 @@ SceneNode* SceneNode::copy(SceneNode* dst) {
     dst->_transform = _transform;
     dst->_useTransform = _useTransform;
     dst->_combined = _combined;
+    dst->_worldDirty = true;
     dst->_tag = _tag;
     dst->_name = _name;
     dst->_hashOfName = _hashOfName;
@@ -327,6 +331,7 @@ void SceneNode::setPosition(float x, float y) {
     _combined.m[12] += (x-_position.x);
     _combined.m[13] += (y-_position.y);
     _position.set(x,y);
+    _worldDirty = true;
 }
 
 /**
@@ -502,6 +507,7 @@ void SceneNode::updateTransform() {
     }
     _combined.m[12] += _position.x-offset.x;
     _combined.m[13] += _position.y-offset.y;
+    _worldDirty = true;
 }
 
 
@@ -900,21 +906,26 @@ void SceneNode::sortZOrder() {
 void SceneNode::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {
     if (!_isVisible) { return; }
     
-    Mat4 matrix;
-    Mat4::multiply(_combined,transform,&matrix);
+    const Mat4& matrix = getWorldCache(transform);
     Color4 color = _tintColor;
     if (_hasParentColor) {
         color *= tint;
     }
     
-    std::shared_ptr<Scissor> active = batch->getScissor();
+    // Scissors are intersected on the stack so that we do not allocate
+    Scissor active;
+    bool restore = false;
     if (_scissor) {
-        std::shared_ptr<Scissor> local = Scissor::alloc(_scissor);
-        local->setTransform(matrix);
-        if (active) {
-            local = active->getIntersection(local, false);
+        Scissor local(*_scissor);
+        local.setTransform(matrix);
+        restore = batch->getScissor(&active);
+        if (restore) {
+            Scissor clip(active);
+            clip.intersect(local, false);
+            batch->setScissor(clip);
+        } else {
+            batch->setScissor(local);
         }
-        batch->setScissor(local);
     }
 
     draw(batch,matrix,color);
@@ -922,9 +933,103 @@ void SceneNode::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4& tr
         (*it)->render(batch, matrix, color);
     }
 
-    if (_scissor) {
+    if (restore) {
         batch->setScissor(active);
+    } else if (_scissor) {
+        batch->setScissor(nullptr);
+    }
+}
+
+/**
+ * Returns true if this node draws anything, storing its state in dst.
+ *
+ * The base SceneNode draws nothing and so returns false. Any subclass
+ * that overrides {@link #draw} MUST override this method as well, or it
+ * will not be drawn in deferred mode. If such a subclass cannot describe
+ * its state, its override should return true and leave dst unchanged so
+ * that it acts as a barrier.
+ *
+ * @param dst   The draw state to store the result
+ *
+ * @return true if this node draws anything
+ */
+bool SceneNode::getDrawState(DrawState* /*dst*/) {
+    return false;
+}
+
+/**
+ * Submits this node and all of its children to the given draw queue.
+ *
+ * This method is the deferred analogue of {@link #render}. Instead of
+ * drawing, it pushes a command for this node (if {@link #getDrawState}
+ * says it draws anything) and then recursively submits its children.
+ * Nodes that override {@link #render} to control the drawing of their
+ * subtree should override this method as well.
+ *
+ * @param queue     The draw queue to submit to.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ */
+void SceneNode::submit(DrawQueue& queue, const Mat4& transform, Color4 tint) {
+    if (!_isVisible) { return; }
+    
+    const Mat4& matrix = getWorldCache(transform);
+    Color4 color = _tintColor;
+    if (_hasParentColor) {
+        color *= tint;
+    }
+    
+    if (_scissor) {
+        Scissor local(*_scissor);
+        local.setTransform(matrix);
+        queue.pushScissor(local);
+    }
+    
+    DrawState state;
+    if (getDrawState(&state)) {
+        queue.push(this, matrix, color, state);
+    }
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        (*it)->submit(queue, matrix, color);
+    }
+    
+    if (_scissor) {
+        queue.popScissor();
+    }
+}
+
+/**
+ * Returns the cached transform from node space to render space.
+ *
+ * The render space is the space of the transform passed to {@link #render}.
+ * This matrix is only recomputed if the local transform has changed, or
+ * if the given transform is not the one used to compute the cache. In that
+ * case, this method marks the children as dirty as well, so that the
+ * change propagates down the scene graph.
+ *
+ * If the transform is the cached world transform of the parent, this
+ * method trusts the dirty flag and does not compare matrices.
+ *
+ * @param transform The global transformation matrix of the parent.
+ *
+ * @return the cached transform from node space to render space.
+ */
+const Mat4& SceneNode::getWorldCache(const Mat4& transform) {
+    bool inherited = (_parent != nullptr && &transform == &(_parent->_worldCache));
+    if (!_worldDirty && (inherited || transform == _worldBasis)) {
+        return _worldCache;
+    }
+    
+    Mat4::multiply(_combined,transform,&_worldCache);
+    _worldBasis = transform;
+    _worldDirty = false;
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        (*it)->_worldDirty = true;
+    }
+    if (_graph != nullptr) {
+        _graph->_multiplies++;
     }
+    return _worldCache;
 }
 
 /**
@@ -33,6 +33,7 @@
 
 #include <algorithm>
 #include <cugl/scene2/graph/CUTexturedNode.h>
+#include <cugl/scene2/graph/CUDrawQueue.h>
 #include <cugl/util/CUStrings.h>
 #include <cugl/assets/CUScene2Loader.h>
 #include <cugl/assets/CUAssetManager.h>
@@ -445,6 +446,30 @@ void TexturedNode::setGradient(const std::shared_ptr<Gradient>& gradient) {
 }
 
 
+#pragma mark -
+#pragma mark Rendering
+/**
+ * Returns true if this node draws anything, storing its state in dst.
+ *
+ * This method is used by a {@link Scene2} in deferred mode to batch draw
+ * commands by texture and blend state.  A node with a gradient
+ * uses itself as the texture identifier, as the gradient is part of the
+ * sprite batch state.
+ *
+ * @param dst   The draw state to store the result
+ *
+ * @return true if this node draws anything
+ */
+bool TexturedNode::getDrawState(DrawState* dst) {
+    if (!_rendered) {
+        generateRenderData();
+    }
+    const void* texture = _gradient ? (const void*)this : (const void*)_texture.get();
+    dst->set(texture, _blendEquation, _srcFactor, _dstFactor, _mesh);
+    return true;
+}
+
+
 #pragma mark -
 #pragma mark Internal Helpers
 
@@ -39,11 +39,55 @@
 //  Author: Walker White
 //  Version: 8/20/20
 #include <cugl/scene2/ui/CULabel.h>
+#include <cugl/scene2/graph/CUDrawQueue.h>
 #include <cugl/assets/CUScene2Loader.h>
 #include <cugl/assets/CUAssetManager.h>
 
 using namespace cugl::scene2;
 
+/**
+ * Returns the character to display for c
+ *
+ * Unprintable characters (including tabs and newlines) are replaced by spaces.
+ *
+ * @param c The character to display
+ *
+ * @return the character to display for c
+ */
+static inline char printable(char c) {
+    return (((Uint32)c) > 32 && c != 127) ? c : ' ';
+}
+
+/**
+ * Returns true if c is a decimal digit
+ *
+ * @param c The character to test
+ *
+ * @return true if c is a decimal digit
+ */
+static inline bool isdecimal(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * Returns the kerning between a and b in the given font
+ *
+ * This is the kerning used to lay out atlas meshes. Characters that are not
+ * supported by the font have no kerning.
+ *
+ * @param font  The font to query
+ * @param a     The first character
+ * @param b     The second character
+ *
+ * @return the kerning between a and b in the given font
+ */
+static inline unsigned int kerning(const std::shared_ptr<cugl::Font>& font, char a, char b) {
+    if (font->hasGlyph(a) && font->hasGlyph(b)) {
+        return font->getKerning(a,b);
+    }
+    return 0;
+}
+
 
 #define UNKNOWN_STR "<unknown>"
 #pragma mark Constructors
@@ -289,15 +333,18 @@ bool Label::initWithData(const Scene2Loader* loader, const std::shared_ptr<JsonV
  * @oaram resize    Whether to resize the label to fit the new text.
  */
 void Label::setText(const std::string& text, bool resize) {
+    // Skip the layout if the size is stable and the glyphs are unchanged (or patchable)
+    if (!resize || getContentSize() == _textbounds.size) {
+        if (matchesText(text) || patchText(text)) {
+            return;
+        }
+    }
+    
     // Let's strip the non-printable characters first
     _text.clear();
     _text.reserve(text.size());
     for(auto it = text.begin(); it != text.end(); ++it) {
-        if (((Uint32)*it) > 32 && *it != 127) {
-            _text.push_back(*it);
-        } else {
-            _text.push_back(' ');
-        }
+        _text.push_back(printable(*it));
     }
     
     computeSize();
@@ -528,7 +575,34 @@ void Label::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transfor
     }
     batch->setTexture(_texture);
     batch->setColor(tint);
-    batch->fill(_mesh, transform);
+    if (_font->isDistanceField()) {
+        batch->setDistanceField(true);
+        batch->fill(_mesh, transform);
+        batch->setDistanceField(false);
+    } else {
+        batch->fill(_mesh, transform);
+    }
+}
+
+/**
+ * Returns true if this node draws anything, storing its state in dst.
+ *
+ * This method is used by a {@link Scene2} in deferred mode to batch draw
+ * commands by texture and blend state.  A label with a background
+ * color is a barrier, as it draws with two different textures.
+ *
+ * @param dst   The draw state to store the result
+ *
+ * @return true if this node draws anything
+ */
+bool Label::getDrawState(DrawState* dst) {
+    if (!_rendered) {
+        generateRenderData();
+    }
+    if (_background == Color4::CLEAR) {
+        dst->set(_texture.get(), _blendEquation, _srcFactor, _dstFactor, _mesh);
+    }
+    return true;
 }
 
 
@@ -561,7 +635,36 @@ void Label::generateRenderData() {
     _bounds = Rect(Vec2::ZERO,getContentSize());
 
     // Glyphs are defined by _textbounds, regardless of alignment
-    _texture = _font->getMesh(_text, _textbounds.origin, _mesh);
+    bool ascii = _font->hasAtlas();
+    for(auto it = _text.begin(); ascii && it != _text.end(); ++it) {
+        ascii = ((Uint8)*it) < 128;
+    }
+    
+    _glyphs.clear();
+    if (ascii) {
+        // Lay out one glyph at a time to record the glyph run
+        _texture = _font->getAtlas();
+        _glyphs.reserve(_text.size());
+        Rect rect(_textbounds.origin,_textbounds.size);
+        Vec2 offset = _textbounds.origin;
+        for(size_t ii = 0; ii < _text.size(); ii++) {
+            if (ii > 0) {
+                offset.x -= kerning(_font,_text[ii-1],_text[ii]);
+            }
+            Glyph glyph;
+            glyph.offset = offset;
+            GLuint start = (GLuint)_mesh.vertices.size();
+            _font->getQuad((Uint32)_text[ii], offset, rect, _mesh);
+            glyph.advance = offset.x-glyph.offset.x;
+            glyph.vertex  = _mesh.vertices.size() > start ? (Sint32)start : -1;
+            _glyphs.push_back(glyph);
+            if (offset.x > rect.getMaxX()) {
+                break;
+            }
+        }
+    } else {
+        _texture = _font->getMesh(_text, _textbounds.origin, _mesh);
+    }
     for(auto it = _mesh.vertices.begin(); it != _mesh.vertices.end(); ++it) {
         it->color = _foreground;
     }
@@ -575,6 +678,7 @@ void Label::generateRenderData() {
 void Label::clearRenderData() {
     _mesh.clear();
     _mesh.command = GL_TRIANGLES;
+    _glyphs.clear();
     _rendered = false;
 }
 
@@ -593,3 +697,100 @@ void Label::updateColor() {
         it->color = _foreground;
     }
 }
+
+/**
+ * Returns true if the given text is the same as the current text.
+ *
+ * The comparison is made after unprintable characters are replaced by
+ * spaces, as in {@link #setText}.
+ *
+ * @param text  The text to compare
+ *
+ * @return true if the given text is the same as the current text.
+ */
+bool Label::matchesText(const std::string& text) const {
+    if (text.size() != _text.size()) {
+        return false;
+    }
+    for(size_t ii = 0; ii < text.size(); ii++) {
+        if (printable(text[ii]) != _text[ii]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns true if the text was changed by patching the glyph run.
+ *
+ * This method only succeeds if the render data is present, the text has
+ * the same length, and the only changes are digits with the same advance
+ * and kerning as the digits they replace. In that case, the quads for the
+ * changed digits are replaced in the mesh, and nothing else is laid out
+ * again. Otherwise, this method does nothing and returns false.
+ *
+ * @param text  The new text for this label
+ *
+ * @return true if the text was changed by patching the glyph run.
+ */
+bool Label::patchText(const std::string& text) {
+    if (!_rendered || text.size() != _text.size() || _glyphs.size() != _text.size()) {
+        return false;
+    }
+    
+    // The true bounds depend on the glyph shapes, so these alignments must relayout
+    bool softh = _halign == HAlign::LEFT || _halign == HAlign::CENTER || _halign == HAlign::RIGHT;
+    bool softv = _valign == VAlign::BOTTOM || _valign == VAlign::MIDDLE || _valign == VAlign::TOP;
+    if (!softh || !softv) {
+        return false;
+    }
+    
+    // Build the new quads first, so we can back out safely
+    _patch.clear();
+    _patch.command = GL_TRIANGLES;
+    Rect rect(_textbounds.origin,_textbounds.size);
+    size_t size = text.size();
+    for(size_t ii = 0; ii < size; ii++) {
+        char prev = _text[ii];
+        char next = printable(text[ii]);
+        if (prev == next) {
+            continue;
+        } else if (!isdecimal(prev) || !isdecimal(next)) {
+            return false;
+        }
+        
+        if (ii > 0 && kerning(_font,_text[ii-1],prev) != kerning(_font,printable(text[ii-1]),next)) {
+            return false;
+        } else if (ii+1 < size && kerning(_font,prev,_text[ii+1]) != kerning(_font,next,printable(text[ii+1]))) {
+            return false;
+        }
+        
+        const Glyph& glyph = _glyphs[ii];
+        Vec2 offset = glyph.offset;
+        size_t start = _patch.vertices.size();
+        _font->getQuad((Uint32)next, offset, rect, _patch);
+        size_t made = _patch.vertices.size()-start;
+        if (offset.x-glyph.offset.x != glyph.advance || made != (glyph.vertex < 0 ? 0 : 4)) {
+            return false;
+        }
+    }
+    
+    // Commit the new quads
+    size_t pos = 0;
+    for(size_t ii = 0; ii < size; ii++) {
+        char next = printable(text[ii]);
+        if (_text[ii] == next) {
+            continue;
+        }
+        _text[ii] = next;
+        if (_glyphs[ii].vertex >= 0) {
+            SpriteVertex2* dst = &(_mesh.vertices[_glyphs[ii].vertex]);
+            for(int jj = 0; jj < 4; jj++) {
+                dst[jj].position = _patch.vertices[pos].position;
+                dst[jj].texcoord = _patch.vertices[pos].texcoord;
+                pos++;
+            }
+        }
+    }
+    return true;
+}
@@ -42,6 +42,7 @@
 //  Version: 11/8/17
 //
 #include <cugl/scene2/ui/CUNinePatch.h>
+#include <cugl/scene2/graph/CUDrawQueue.h>
 #include <cugl/util/CUStrings.h>
 #include <cugl/assets/CUScene2Loader.h>
 #include <cugl/assets/CUAssetManager.h>
@@ -562,3 +563,21 @@ void NinePatch::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& tran
     batch->fill(_mesh, transform);
 }
 
+/**
+ * Returns true if this node draws anything, storing its state in dst.
+ *
+ * This method is used by a {@link Scene2} in deferred mode to batch draw
+ * commands by texture and blend state.
+ *
+ * @param dst   The draw state to store the result
+ *
+ * @return true if this node draws anything
+ */
+bool NinePatch::getDrawState(DrawState* dst) {
+    if (!_rendered) {
+        generateRenderData();
+    }
+    dst->set(_texture.get(), _blendEquation, _srcFactor, _dstFactor, _mesh);
+    return true;
+}
+
@@ -47,6 +47,7 @@
 //
 #include <cugl/input/cu_input.h>
 #include <cugl/scene2/ui/CUTextField.h>
+#include <cugl/scene2/graph/CUDrawQueue.h>
 #include <cugl/base/CUApplication.h>
 
 using namespace cugl::scene2;
@@ -569,6 +570,24 @@ void TextField::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& tran
 	}
 }
 
+/**
+ * Returns true if this node draws anything, storing its state in dst.
+ *
+ * This method is used by a {@link Scene2} in deferred mode to batch draw
+ * commands by texture and blend state.  A text field with focus
+ * is a barrier, as the cursor is drawn with a different texture.
+ *
+ * @param dst   The draw state to store the result
+ *
+ * @return true if this node draws anything
+ */
+bool TextField::getDrawState(DrawState* dst) {
+    if (_focused) {
+        return true;
+    }
+    return Label::getDrawState(dst);
+}
+
 
 #pragma mark -
 #pragma mark Internal Helpers
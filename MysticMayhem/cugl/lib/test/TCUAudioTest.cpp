@@ -0,0 +1,181 @@
+//
+//  TCUAudioTest.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a unit test suite for the audio graph classes. These tests
+//  do not open an audio device. Instead, an AudioRenderer stands in for the
+//  device on a separate thread, pulling the graph in real time, while the main
+//  thread changes the graph as a game would.
+//
+//  These test classes only use asserts and have no audible side-effects.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+
+#include "TCUAudioTest.h"
+#include <cugl/cugl.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace cugl;
+using namespace cugl::audio;
+
+/** The number of channels in the stress test graph */
+#define STRESS_CHANNELS 2
+/** The sample rate of the stress test graph */
+#define STRESS_RATE     48000
+/** The buffer size of the modeled device */
+#define STRESS_BUFFER   512
+/** The number of mixer slots (slot 0 is the scheduler) */
+#define STRESS_SLOTS    8
+/** The number of graph changes per second */
+#define STRESS_CHANGES  500
+/** The number of seconds to run the stress test */
+#define STRESS_SECONDS  5
+
+#pragma mark -
+#pragma mark Stress Test
+/**
+ * Stress test for the mixer and scheduler of an audio graph
+ *
+ * The main thread calls play() on a scheduler, and attaches and detaches
+ * mixer inputs, hundreds of times a second. Meanwhile a second thread reads
+ * the graph with an AudioRenderer, one buffer per buffer period, as a device
+ * would. The test fails on an underrun (a buffer that took longer than one
+ * buffer period to read) or on an invalid sample.
+ */
+void cugl::testAudioStress() {
+    CULog("Running stress test for AudioMixer and AudioScheduler.\n");
+
+    std::vector<std::shared_ptr<AudioWaveform>> waves;
+    for(int ii = 0; ii < STRESS_SLOTS; ii++) {
+        float freq = 220.0f*std::pow(2.0f,ii/(float)STRESS_SLOTS);
+        waves.push_back(AudioWaveform::alloc(STRESS_CHANNELS,STRESS_RATE,
+                                             AudioWaveform::Type::SINE,freq));
+    }
+
+    auto mixer = AudioMixer::alloc(STRESS_SLOTS,STRESS_CHANNELS,STRESS_RATE,STRESS_BUFFER);
+    auto scheduler = AudioScheduler::alloc(STRESS_CHANNELS,STRESS_RATE,STRESS_BUFFER);
+    auto renderer  = AudioRenderer::alloc(STRESS_CHANNELS,STRESS_RATE,STRESS_BUFFER);
+    CUAssertAlwaysLog(mixer && scheduler && renderer, "Graph allocation failed");
+    mixer->attach(0,scheduler);
+    CUAssertAlwaysLog(renderer->attach(mixer), "Renderer attachment failed");
+
+    // The renderer thread plays the role of the device callback
+    std::atomic<bool> running(true);
+    std::atomic<Uint32> buffers(0);
+    std::atomic<Uint32> xruns(0);
+    std::atomic<Uint32> invalid(0);
+    std::atomic<Uint64> slowest(0);
+    std::thread device([&] {
+        typedef std::chrono::steady_clock clock;
+        const auto period = std::chrono::nanoseconds((Uint64)STRESS_BUFFER*1000000000/STRESS_RATE);
+        std::vector<float> buffer(STRESS_BUFFER*STRESS_CHANNELS);
+        auto wakeup = clock::now();
+        while (running.load(std::memory_order_acquire)) {
+            // A device gives the callback one period to fill the buffer
+            auto start = clock::now();
+            renderer->read(buffer.data(),STRESS_BUFFER);
+            auto end = clock::now();
+
+            Uint64 nanos = (Uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count();
+            if (nanos > slowest.load()) {
+                slowest.store(nanos);
+            }
+            if (end-start > period) {
+                xruns.fetch_add(1);
+            }
+            for(auto it = buffer.begin(); it != buffer.end(); ++it) {
+                if (!std::isfinite(*it)) {
+                    invalid.fetch_add(1);
+                    break;
+                }
+            }
+            buffers.fetch_add(1);
+
+            // Wait for the next period, as a device would
+            wakeup += period;
+            std::this_thread::sleep_until(wakeup);
+        }
+    });
+
+    // The main thread changes the graph as fast as a busy game might
+    Uint32 changes = 0;
+    const auto interval = std::chrono::microseconds(1000000/STRESS_CHANGES);
+    auto next = std::chrono::steady_clock::now();
+    for(int ii = 0; ii < STRESS_CHANGES*STRESS_SECONDS; ii++) {
+        const std::shared_ptr<AudioWaveform>& wave = waves[ii % STRESS_SLOTS];
+        switch (ii % 5) {
+            case 0:
+            case 1:
+                scheduler->play(wave->createNode());
+                break;
+            case 2:
+                scheduler->append(wave->createNode(),ii % 3);
+                break;
+            case 3:
+                mixer->attach(1+(ii % (STRESS_SLOTS-1)),AudioFader::alloc(wave->createNode()));
+                break;
+            case 4:
+                mixer->detach(1+((ii/5) % (STRESS_SLOTS-1)));
+                if (ii % 25 == 4) {
+                    scheduler->trim(1);
+                }
+                break;
+        }
+        changes++;
+        next += interval;
+        std::this_thread::sleep_until(next);
+    }
+
+    running.store(false,std::memory_order_release);
+    device.join();
+
+    CULog("%u changes over %u buffers, %u underruns, slowest buffer %.3f ms",
+          changes, buffers.load(), xruns.load(), slowest.load()/1000000.0);
+    CUAssertAlwaysLog(buffers.load() > 0,   "The renderer never read the graph");
+    CUAssertAlwaysLog(xruns.load() == 0,    "The renderer missed %u buffer deadlines", xruns.load());
+    CUAssertAlwaysLog(invalid.load() == 0,  "The renderer produced %u invalid buffers", invalid.load());
+    CUAssertAlwaysLog(scheduler->isPlaying(), "The scheduler stopped playing");
+
+    // Tear down on the main thread, now that nothing reads the graph
+    scheduler->clear();
+    for(Uint8 ii = 0; ii < STRESS_SLOTS; ii++) {
+        mixer->detach(ii);
+    }
+    renderer->detach();
+
+#pragma mark Complete
+    CULog("Audio stress test complete.\n");
+}
+
+#pragma mark -
+#pragma mark Main
+
+/**
+ * Master unit test that invokes all others in this module.
+ */
+void cugl::audioUnitTest() {
+    testAudioStress();
+}
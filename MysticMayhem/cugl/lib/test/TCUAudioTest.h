@@ -0,0 +1,56 @@
+//
+//  TCUAudioTest.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a unit test suite for the audio graph classes. These tests
+//  do not open an audio device. Instead, an AudioRenderer stands in for the
+//  device on a separate thread, pulling the graph in real time, while the main
+//  thread changes the graph as a game would.
+//
+//  These test classes only use asserts and have no audible side-effects.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/18/26
+
+#ifndef __T_CU_AUDIO_TEST_H__
+#define __T_CU_AUDIO_TEST_H__
+
+namespace cugl {
+
+/**
+ * Stress test for the mixer and scheduler of an audio graph
+ *
+ * The main thread calls play() on a scheduler, and attaches and detaches
+ * mixer inputs, hundreds of times a second. Meanwhile a second thread reads
+ * the graph with an AudioRenderer, one buffer per buffer period, as a device
+ * would. The test fails on an underrun (a buffer that took longer than one
+ * buffer period to read) or on an invalid sample.
+ */
+void testAudioStress();
+
+/**
+ * Master unit test that invokes all others in this module.
+ */
+void audioUnitTest();
+
+}
+
+#endif /* __T_CU_AUDIO_TEST_H__ */
@@ -0,0 +1,164 @@
+//
+//  TCUIOTest.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a unit test suite for the readers in the io package. Each
+//  test writes a small file to the save directory, and then reads it back
+//  both with a small buffer and with a mapping.
+//
+//  These test classes only use asserts and have no visible side-effects.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+
+#include "TCUIOTest.h"
+#include <cugl/cugl.h>
+#include <string>
+#include <vector>
+
+using namespace cugl;
+
+/** The number of elements in each test array */
+#define IO_ARRAY    4096
+/** The (deliberately tiny) buffer capacity of the buffered readers */
+#define IO_CAPACITY 64
+/** The length of the long line in the text test */
+#define IO_LINE     300
+
+#pragma mark -
+#pragma mark Binary Reader
+/**
+ * Array test for BinaryReader
+ *
+ * The arrays are much longer than the read buffer, and start at an odd
+ * offset so that elements straddle the end of the buffer. Reading such an
+ * array once looped forever, because the buffer was never refilled.
+ */
+void cugl::testBinaryArrays() {
+    CULog("Running tests for BinaryReader.\n");
+
+    std::vector<Uint32> words(IO_ARRAY);
+    std::vector<Sint16> shorts(IO_ARRAY);
+    std::vector<double> reals(IO_ARRAY);
+    for(int ii = 0; ii < IO_ARRAY; ii++) {
+        words[ii]  = (Uint32)ii*2654435761u;
+        shorts[ii] = (Sint16)(ii*37-5000);
+        reals[ii]  = ii*0.25-100.0;
+    }
+
+    std::shared_ptr<BinaryWriter> writer = BinaryWriter::alloc("iotest.b");
+    CUAssertAlwaysLog(writer, "Could not create the test file");
+    writer->writeUint8(7);
+    writer->write(words.data(),IO_ARRAY);
+    writer->write(shorts.data(),IO_ARRAY);
+    writer->write(reals.data(),IO_ARRAY);
+    writer->close();
+
+    std::shared_ptr<BinaryReader> readers[2];
+    readers[0] = BinaryReader::alloc("iotest.b",IO_CAPACITY);
+    readers[1] = BinaryReader::allocMapped("iotest.b");
+    for(int rr = 0; rr < 2; rr++) {
+        std::shared_ptr<BinaryReader> reader = readers[rr];
+        const char* mode = rr ? "mapped" : "buffered";
+        CUAssertAlwaysLog(reader, "Could not open the %s reader", mode);
+        CUAssertAlwaysLog(reader->readByte() == 7, "Leading byte is wrong (%s)", mode);
+
+        std::vector<Uint32> words2(IO_ARRAY);
+        size_t amt = reader->read(words2.data(),IO_ARRAY);
+        CUAssertAlwaysLog(amt == IO_ARRAY, "Read %zu of %d Uint32 values (%s)", amt, IO_ARRAY, mode);
+        CUAssertAlwaysLog(words2 == words, "Uint32 array is wrong (%s)", mode);
+
+        std::vector<Sint16> shorts2(IO_ARRAY);
+        amt = reader->read(shorts2.data(),IO_ARRAY);
+        CUAssertAlwaysLog(amt == IO_ARRAY, "Read %zu of %d Sint16 values (%s)", amt, IO_ARRAY, mode);
+        CUAssertAlwaysLog(shorts2 == shorts, "Sint16 array is wrong (%s)", mode);
+
+        // Ask for more than the file has left
+        std::vector<double> reals2(IO_ARRAY+IO_CAPACITY);
+        amt = reader->read(reals2.data(),IO_ARRAY+IO_CAPACITY);
+        CUAssertAlwaysLog(amt == IO_ARRAY, "Read %zu of %d double values (%s)", amt, IO_ARRAY, mode);
+        reals2.resize(amt);
+        CUAssertAlwaysLog(reals2 == reals, "double array is wrong (%s)", mode);
+        CUAssertAlwaysLog(!reader->ready(), "Reader did not reach the end of the file (%s)", mode);
+        reader->close();
+    }
+
+#pragma mark Complete
+    CULog("BinaryReader tests complete.\n");
+}
+
+#pragma mark -
+#pragma mark Json Reader
+/**
+ * Test for JsonReader and TextReader
+ *
+ * This reads a JSON value followed by plain text, once with a read buffer
+ * smaller than either, and once from a mapping. It checks that the text
+ * after the JSON value is left in the stream.
+ */
+void cugl::testJsonReader() {
+    CULog("Running tests for JsonReader.\n");
+
+    std::string line(IO_LINE,'x');
+    std::shared_ptr<TextWriter> writer = TextWriter::alloc("iotest.json");
+    CUAssertAlwaysLog(writer, "Could not create the test file");
+    writer->writeLine("{\"name\" : \"test\", \"values\" : [1, 2, 3]}");
+    writer->writeLine(line);
+    writer->write("tail");
+    writer->close();
+
+    std::shared_ptr<JsonReader> readers[2];
+    readers[0] = JsonReader::alloc("iotest.json",IO_CAPACITY/4);
+    readers[1] = JsonReader::allocMapped("iotest.json");
+    for(int rr = 0; rr < 2; rr++) {
+        std::shared_ptr<JsonReader> reader = readers[rr];
+        const char* mode = rr ? "mapped" : "buffered";
+        CUAssertAlwaysLog(reader, "Could not open the %s reader", mode);
+        CUAssertAlwaysLog(reader->isMapped() == (rr == 1), "Reader has the wrong mode (%s)", mode);
+
+        std::shared_ptr<JsonValue> json = reader->readJson();
+        CUAssertAlwaysLog(json && json->isObject(), "JSON value is missing (%s)", mode);
+        CUAssertAlwaysLog(json->getString("name") == "test", "JSON string is wrong (%s)", mode);
+        CUAssertAlwaysLog(json->get("values") && json->get("values")->size() == 3, "JSON array is wrong (%s)", mode);
+
+        // The text after the JSON value is still in the stream
+        reader->skip();
+        std::string_view view = reader->readLineView();
+        CUAssertAlwaysLog(view == line, "Long line is wrong (%s)", mode);
+        CUAssertAlwaysLog(reader->readLine() == "tail", "Last line is wrong (%s)", mode);
+        CUAssertAlwaysLog(!reader->ready(), "Reader did not reach the end of the file (%s)", mode);
+        reader->close();
+    }
+
+#pragma mark Complete
+    CULog("JsonReader tests complete.\n");
+}
+
+#pragma mark -
+#pragma mark Main
+
+/**
+ * Master unit test that invokes all others in this module.
+ */
+void cugl::ioUnitTest() {
+    testBinaryArrays();
+    testJsonReader();
+}
@@ -0,0 +1,62 @@
+//
+//  TCUIOTest.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a unit test suite for the readers in the io package. Each
+//  test writes a small file to the save directory, and then reads it back
+//  both with a small buffer and with a mapping.
+//
+//  These test classes only use asserts and have no visible side-effects.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+
+#ifndef __T_CU_IO_TEST_H__
+#define __T_CU_IO_TEST_H__
+
+namespace cugl {
+
+/**
+ * Array test for BinaryReader
+ *
+ * The arrays are much longer than the read buffer, and start at an odd
+ * offset so that elements straddle the end of the buffer. Reading such an
+ * array once looped forever, because the buffer was never refilled.
+ */
+void testBinaryArrays();
+
+/**
+ * Test for JsonReader and TextReader
+ *
+ * This reads a JSON value followed by plain text, once with a read buffer
+ * smaller than either, and once from a mapping. It checks that the text
+ * after the JSON value is left in the stream.
+ */
+void testJsonReader();
+
+/**
+ * Master unit test that invokes all others in this module.
+ */
+void ioUnitTest();
+
+}
+
+#endif /* __T_CU_IO_TEST_H__ */
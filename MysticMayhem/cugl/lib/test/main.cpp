@@ -14,6 +14,8 @@
 
 #include "TCUMathTest.h"
 #include "TCU2DTest.h"
+#include "TCUAudioTest.h"
+#include "TCUIOTest.h"
 
 #include <Accelerate/Accelerate.h>
 
@@ -196,6 +198,8 @@ int main(int argc, char * argv[]) {
 #endif
     
     cugl::mathUnitTest();
+    cugl::audioUnitTest();
+    cugl::ioUnitTest();
 
     //cugl::sceneUnitTest();
     //testBinary();
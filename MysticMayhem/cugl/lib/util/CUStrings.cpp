@@ -441,6 +441,85 @@ std::string to_string(double* array, size_t length, size_t offset, int precision
 }
 
 
+#pragma mark -
+#pragma mark IN-PLACE FORMATTING FUNCTIONS
+/**
+ * Appends the decimal representation of value to dst.
+ *
+ * Unlike {@link to_string}, this function does not create a new string.
+ * If dst has enough capacity, it does not allocate any memory at all.
+ * This makes it suitable for text that changes every frame, like a
+ * score or a timer. Reserve the capacity once and clear the string
+ * before formatting it again.
+ *
+ * If width is positive, the number is padded with leading zeros to
+ * that many digits (not counting the sign).
+ *
+ * @param dst       the string to append to
+ * @param value     the numeric value to convert
+ * @param width     the minimum number of digits
+ */
+void append_int(std::string& dst, Sint64 value, size_t width) {
+    // Work with the magnitude so that the minimum value is safe
+    Uint64 magnitude = value < 0 ? (Uint64)0-(Uint64)value : (Uint64)value;
+    char buffer[24];
+    size_t pos = sizeof(buffer);
+    do {
+        buffer[--pos] = (char)('0'+(magnitude % 10));
+        magnitude /= 10;
+    } while (magnitude > 0);
+    
+    if (value < 0) {
+        dst.push_back('-');
+    }
+    for(size_t ii = sizeof(buffer)-pos; ii < width; ii++) {
+        dst.push_back('0');
+    }
+    dst.append(buffer+pos,sizeof(buffer)-pos);
+}
+
+/**
+ * Appends the fixed-point representation of value to dst.
+ *
+ * Unlike {@link to_string}, this function does not create a new string.
+ * If dst has enough capacity, it does not allocate any memory at all.
+ * This makes it suitable for text that changes every frame, like a
+ * speedometer. Reserve the capacity once and clear the string before
+ * formatting it again.
+ *
+ * The value is rounded to the given number of digits after the decimal
+ * point. The precision is capped at 9 digits.
+ *
+ * @param dst       the string to append to
+ * @param value     the numeric value to convert
+ * @param precision the number of digits after the decimal point
+ */
+void append_fixed(std::string& dst, double value, int precision) {
+    static const double scales[10] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+    precision = std::max(0,std::min(precision,9));
+    double scale = scales[precision];
+    double magnitude = value < 0 ? -value : value;
+    if (!(magnitude*scale < 9.0e18)) {
+        // Too large (or not a number), so let the C library handle it
+        char buffer[64];
+        int size = snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
+        dst.append(buffer,std::min((size_t)std::max(size,0),sizeof(buffer)-1));
+        return;
+    }
+    
+    Uint64 scaled = (Uint64)(magnitude*scale+0.5);
+    Uint64 units  = (Uint64)scale;
+    if (value < 0 && scaled > 0) {
+        dst.push_back('-');
+    }
+    append_int(dst, (Sint64)(scaled/units));
+    if (precision > 0) {
+        dst.push_back('.');
+        append_int(dst, (Sint64)(scaled % units), precision);
+    }
+}
+
+
 #pragma mark -
 #pragma mark STRING TO NUMBER FUNCTIONS
 
@@ -22,6 +22,11 @@ using namespace cugl;
 void App::onStartup() {
     srand((unsigned) time(0));
     _assets = AssetManager::alloc();
+    if (globals::RENDER_BENCHMARK) {
+        // Must be installed before any graphics objects are allocated
+        _recorder = RecordingBackend::alloc(globals::RENDER_BENCHMARK == 1);
+        RenderBackend::set(_recorder);
+    }
     _batch  = SpriteBatch::alloc();
     auto cam = OrthographicCamera::alloc(getDisplaySize());
 
@@ -36,8 +41,15 @@ void App::onStartup() {
     Input::activate<Keyboard>();
 #endif
 
+    // Keep decoded textures, font atlases and sounds between launches
+    _assets->setCache(AssetCache::alloc("cache"));
+    // Scene asset groups load on first use, and idle ones are evicted past this budget
+    _assets->setMemoryBudget(globals::ASSET_BUDGET);
     _assets->attach<Font>(FontLoader::alloc()->getHook());
-    _assets->attach<Texture>(TextureLoader::alloc()->getHook());
+    // Stage texture uploads off the main thread so the loading bar stays smooth
+    std::shared_ptr<TextureLoader> textures = TextureLoader::alloc();
+    textures->setStaging(true);
+    _assets->attach<Texture>(textures->getHook());
     _assets->attach<Sound>(SoundLoader::alloc()->getHook());
     _assets->attach<scene2::SceneNode>(Scene2Loader::alloc()->getHook());
     _assets->attach<World>(GenericLoader<World>::alloc()->getHook());
@@ -46,14 +58,28 @@ void App::onStartup() {
     _currentScene = SceneSelect::Loading;
     _loading.init(_assets);
 
-    // Queue up the other assets
+    // Queue up the other assets (only the menu is needed right away)
     _assets->loadDirectoryAsync("json/assets.json",nullptr);
-    _assets->loadAsync<World>(GRASS_MAP_KEY,GRASS_MAP_JSON,nullptr);
-    _assets->loadAsync<World>(GRASS_MAP2_KEY, GRASS_MAP2_JSON, nullptr);
-    _assets->loadAsync<World>(GRASS_MAP3_KEY, GRASS_MAP3_JSON, nullptr);
-    _assets->loadAsync<World>(GRASS_MAP4_KEY, GRASS_MAP4_JSON, nullptr);
+    _assets->prefetch("menu");
+    _assets->prefetch("settings");
+    _assets->declare<World>(GRASS_MAP_KEY,GRASS_MAP_JSON);
+    _assets->declare<World>(GRASS_MAP2_KEY, GRASS_MAP2_JSON);
+    _assets->declare<World>(GRASS_MAP3_KEY, GRASS_MAP3_JSON);
+    _assets->declare<World>(GRASS_MAP4_KEY, GRASS_MAP4_JSON);
 
+    if (globals::DSP_BENCHMARK) {
+        // Must run before the audio thread starts (512 stereo frames per buffer)
+        CULog("%s", dsp::DSPMath::benchmark(512,2,2000).c_str());
+        CULog("%s", audio::AudioResampler::benchmark(44100,48000,2,10.0).c_str());
+    }
     AudioEngine::start();
+    if (globals::DSP_BENCHMARK) {
+        // Offline, so it does not disturb the output device
+        CULog("%s", audio::AudioRenderer::benchmark(32,10.0).c_str());
+    }
+    if (globals::AUDIO_PROFILE_INTERVAL > 0) {
+        AudioDevices::get()->getProfiler()->setEnabled(true);
+    }
     SoundController::init(_assets);
 
     Application::onStartup(); // YOU MUST END with call to parent
@@ -68,6 +94,10 @@ void App::onShutdown() {
     _lobby.dispose();
     _assets = nullptr;
     _batch = nullptr;
+    if (_recorder != nullptr) {
+        RenderBackend::set(nullptr);
+        _recorder = nullptr;
+    }
 
     // Shutdown input
 #ifdef CU_MOBILE
@@ -79,6 +109,7 @@ void App::onShutdown() {
     Input::deactivate<Keyboard>();
 #endif
 
+    SoundController::dispose();
     AudioEngine::stop();
     Application::onShutdown();
 }
@@ -113,6 +144,32 @@ void App::onResume() {
     AudioEngine::get()->resume();
 }
 
+/**
+ * Returns true if no asset group of the given scene is still loading.
+ *
+ * A group that was prefetched may still be loading when its scene is
+ * due. Until it finishes, the asset manager returns nullptr for its
+ * assets, so the transition to that scene must wait.
+ *
+ * @param scene The scene to check
+ *
+ * @return true if no asset group of the given scene is still loading.
+ */
+bool App::isSceneReady(SceneSelect scene) const {
+    switch (scene) {
+        case SceneSelect::Menu:
+            return _assets->isReady("menu") && _assets->isReady("settings");
+        case SceneSelect::Lobby:
+            return _assets->isReady("lobby") && _assets->isReady("settings") && _assets->isReady("player");
+        case SceneSelect::Game:
+            return _assets->isReady("game") && _assets->isReady("settings") && _assets->isReady("player");
+        case SceneSelect::Results:
+            return _assets->isReady("end");
+        default:
+            return true;
+    }
+}
+
 /**
  * The method called to update the application data.
  *
@@ -125,11 +182,20 @@ void App::onResume() {
  * @param timestep  The amount of time (in seconds) since the last frame
  */
  void App::update(float timestep) {
+     if (globals::AUDIO_PROFILE_INTERVAL > 0) {
+         _profileTime += timestep;
+         if (_profileTime >= globals::AUDIO_PROFILE_INTERVAL) {
+             auto profiler = AudioDevices::get()->getProfiler();
+             CULog("%s", profiler->report().c_str());
+             profiler->reset();
+             _profileTime = 0;
+         }
+     }
      switch (_currentScene) {
          case SceneSelect::Loading:{
              if (_loading.isActive()) {
                  _loading.update(0.01f);
-             } else {
+             } else if (isSceneReady(SceneSelect::Menu)) {
                  _loading.dispose(); // Disables the input listeners in this mode
                  _menu.init(_assets);
                  _currentScene = SceneSelect::Menu;
@@ -143,7 +209,8 @@ void App::onResume() {
  //                _menu.update(0.01f);
                  NetworkController::step();
  //                CULog("menu scene");
-                 if((_menu.createPressed() || _menu.joinPressed()) && NetworkController::getStatus() == cugl::CUNetworkConnection::NetStatus::Connected){
+                 if((_menu.createPressed() || _menu.joinPressed()) && NetworkController::getStatus() == cugl::CUNetworkConnection::NetStatus::Connected &&
+                   isSceneReady(SceneSelect::Lobby)){
                      _menu.setActive(false);
                      _menu.getSettings()->removeAllChildren();
                      _menu.getSettings()->dispose();
@@ -155,7 +222,7 @@ void App::onResume() {
                      _currentScene = SceneSelect::Lobby;
                  }
              }
-             else {
+             else if (isSceneReady(SceneSelect::Lobby)) {
                  _menu.setActive(false);
                  _menu.removeAllChildren();
                  _menu.dispose();
@@ -168,7 +235,7 @@ void App::onResume() {
          case SceneSelect::Lobby:{
              if (_lobby.isActive()) {
                  _lobby.update(0.01f);
-             } else {
+             } else if (isSceneReady(SceneSelect::Game)) {
                  _lobby.setActive(false);
                  _lobby.getSettings()->removeAllChildren();
                  _lobby.getSettings()->dispose();
@@ -185,6 +252,9 @@ void App::onResume() {
          case SceneSelect::Game:{
              _gameplay.update(timestep);
              if (time(NULL) - startTimer >= gameTimer) {
+                 if (!isSceneReady(SceneSelect::Results)) {
+                     break;
+                 }
                  _results.init(_assets, _gameplay.getResults(), _gameplay.getWinner());
                  _gameplay.getSettings()->removeAllChildren();
                  _gameplay.getSettings()->dispose();
@@ -194,7 +264,7 @@ void App::onResume() {
                  
              }
              else {
-                 if (_gameplay.getSettings()->leaveGamePressed()) {
+                 if (_gameplay.getSettings()->leaveGamePressed() && isSceneReady(SceneSelect::Menu)) {
                      CULog("leave game in app");
                      NetworkController::destroyConn();
                      _gameplay.getSettings()->removeAllChildren();
@@ -208,14 +278,14 @@ void App::onResume() {
              break;
          }
          case SceneSelect::Results: {
-             if (_results.playAgain()) {
+             if (_results.playAgain() && isSceneReady(SceneSelect::Lobby)) {
                  _results.dispose();
                  _lobby.init(_assets);
                  _lobby.setActive(true);
                  _lobby.setPlayAgain(true);
                  _currentScene = SceneSelect::Lobby;
              }
-             else if (_results.mainMenu()) {
+             else if (_results.mainMenu() && isSceneReady(SceneSelect::Menu)) {
                  NetworkController::destroyConn();
                  _results.dispose();
                  _menu.init(_assets);
@@ -240,6 +310,9 @@ void App::onResume() {
  * at all. The default implmentation does nothing.
  */
 void App::draw() {
+    if (_recorder != nullptr) {
+        _recorder->beginFrame();
+    }
     switch (_currentScene) {
         case SceneSelect::Loading:
             _loading.render(_batch);
@@ -258,4 +331,12 @@ void App::draw() {
             break;
     }
 
+    if (_recorder != nullptr) {
+        _recorder->endFrame();
+        if (_recorder->getFrameCount() >= globals::RENDER_BENCHMARK_FRAMES) {
+            CULog("Render [scene %d]: %s", (int)_currentScene,
+                  _recorder->getAverageStats().toString().c_str());
+            _recorder->resetStats();
+        }
+    }
 }
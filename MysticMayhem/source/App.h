@@ -26,6 +26,10 @@ protected:
     std::shared_ptr<cugl::SpriteBatch> _batch;
     /** The global asset manager */
     std::shared_ptr<cugl::AssetManager> _assets;
+    /** The render benchmark recorder (nullptr if the benchmark is disabled) */
+    std::shared_ptr<cugl::RecordingBackend> _recorder;
+    /** The time since the last audio profile report */
+    float _profileTime = 0;
 
     // Player modes
     /** The primary controller for the game world */
@@ -51,6 +55,19 @@ protected:
     
     SceneSelect _currentScene;
     
+    /**
+     * Returns true if no asset group of the given scene is still loading.
+     *
+     * A group that was prefetched may still be loading when its scene is
+     * due. Until it finishes, the asset manager returns nullptr for its
+     * assets, so the transition to that scene must wait.
+     *
+     * @param scene The scene to check
+     *
+     * @return true if no asset group of the given scene is still loading.
+     */
+    bool isSceneReady(SceneSelect scene) const;
+    
 public:
     /**
      * Creates, but does not initialized a new application.
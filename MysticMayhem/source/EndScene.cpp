@@ -40,7 +40,12 @@ bool EndScene::init(const std::shared_ptr<cugl::AssetManager>& assets, std::map<
     }
 
     _assets = assets;
+    _assets->acquire("end");
     auto layer = assets->get<scene2::SceneNode>("end");
+    if (layer == nullptr) {
+        CULogError("Scene 'end' is not loaded");
+        return false;
+    }
     layer->setContentSize(dimen);
     layer->doLayout(); // This rearranges the children to fit the screen
     addChild(layer);
@@ -123,6 +128,9 @@ bool EndScene::init(const std::shared_ptr<cugl::AssetManager>& assets, std::map<
 void EndScene::dispose() {
     CULog("Results dispose");
     removeAllChildren();
+    if (_assets != nullptr) {
+        _assets->release("end");
+    }
     _assets = nullptr;
     _playAgainButton = nullptr;
     _mainMenuButton = nullptr;
@@ -57,6 +57,12 @@ using namespace std;
  * @return true if the controller is initialized properly, false otherwise.
  */
 bool GameScene::init(const std::shared_ptr<cugl::AssetManager>& assets) {
+    // Claim our asset groups before the map load can evict them
+    _assets = assets;
+    _assets->acquire("game");
+    _assets->acquire("settings");
+    _assets->acquire("player");
+
     // Initialize the scene to a locked width
     //create world
     CULog("map selected is %d", NetworkController::getMapSelected());
@@ -75,6 +81,7 @@ bool GameScene::init(const std::shared_ptr<cugl::AssetManager>& assets) {
         mapKey = GRASS_MAP4_KEY;
         break;
     }
+    _mapKey = mapKey;
     _world = assets->get<World>(mapKey);
     if (_world == nullptr) {
         CULog("Fail!");
@@ -94,6 +101,8 @@ bool GameScene::init(const std::shared_ptr<cugl::AssetManager>& assets) {
         return false;
     }
     
+    // Sort the sprites by texture so the map and players batch together
+    setDeferred(true);
     
     NetworkController::setWorld(_world);
     _world->setNumPlayers(NetworkController::getNumPlayers());
@@ -102,7 +111,6 @@ bool GameScene::init(const std::shared_ptr<cugl::AssetManager>& assets) {
     SpawnController::setWorld(_world);
     
     // Start up the input handler
-    _assets = assets;
     _playerController.init();
     
     auto world = _world->getPhysicsWorld();
@@ -134,6 +142,10 @@ bool GameScene::init(const std::shared_ptr<cugl::AssetManager>& assets) {
     _rootnode->setContentSize(Size(w,h));
 
     _UInode = _assets->get<scene2::SceneNode>("ui");
+    if (_UInode == nullptr) {
+        CULogError("Scene 'ui' is not loaded");
+        return false;
+    }
     _UInode->setAnchor(Vec2::ANCHOR_CENTER);
     _UInode->setPosition(_worldOffset);
     _UInode->setContentSize(Application::get()->getDisplaySize() * 2.0);
@@ -150,6 +162,9 @@ bool GameScene::init(const std::shared_ptr<cugl::AssetManager>& assets) {
     _framesHUD = std::dynamic_pointer_cast<scene2::Label>(_assets->get<scene2::SceneNode>("ui_frames"));
     _framesHUD->setPositionX(_framesHUD->getPositionX() + 100);
     _timerHUD  = std::dynamic_pointer_cast<scene2::Label>(_assets->get<scene2::SceneNode>("ui_timer"));
+    _scoreText.reserve(32);
+    _framesText.reserve(32);
+    _timerText.reserve(32);
     
     _hatchbar = std::dynamic_pointer_cast<scene2::ProgressBar>(assets->get<scene2::SceneNode>("ui_bar"));
     _hatchbar->setVisible(false);
@@ -214,7 +229,6 @@ void GameScene::dispose() {
     _timerHUD = nullptr;
     //_framesHUD = nullptr;
     _debug = false;
-    _assets = nullptr;
 //        Scene2::dispose();
     if (_world != nullptr) {
         _world->clearRootNode();
@@ -222,6 +236,14 @@ void GameScene::dispose() {
         _world->getPhysicsWorld()->clear();
         _world = nullptr;
     }
+    if (_assets != nullptr) {
+        // The map is declared, so the next game reloads it fresh
+        _assets->unload<World>(_mapKey);
+        _assets->release("game");
+        _assets->release("settings");
+        _assets->release("player");
+    }
+    _assets = nullptr;
     _active = false;
     _rootnode = nullptr;
 }
@@ -533,28 +555,26 @@ Size GameScene::computeActiveSize(float w, float h) const {
     return dimen;
 }
 
-std::string GameScene::updateScoreText(const int score) {
-    stringstream ss;
-    ss << "Score: " << score;
-    return ss.str();
+const std::string& GameScene::updateScoreText(const int score) {
+    _scoreText.clear();
+    _scoreText.append("Score: ");
+    strtool::append_int(_scoreText, score);
+    return _scoreText;
 }
 
-std::string GameScene::updateFramesText(const double score) {
-    stringstream ss;
-    ss << "Speed: " << score;
-    return ss.str();
+const std::string& GameScene::updateFramesText(const double score) {
+    _framesText.clear();
+    _framesText.append("Speed: ");
+    strtool::append_fixed(_framesText, score, 2);
+    return _framesText;
 }
 
-std::string GameScene::updateTimerText(const time_t time) {
-    stringstream ss;
-    time_t sec = time % 60;
-    if (sec < 10) {
-        ss << (time / 60) << ":0" << sec;
-    }
-    else {
-        ss << (time / 60) << ":" << sec;
-    }
-    return ss.str();
+const std::string& GameScene::updateTimerText(const time_t time) {
+    _timerText.clear();
+    strtool::append_int(_timerText, time / 60);
+    _timerText.push_back(':');
+    strtool::append_int(_timerText, time % 60, 2);
+    return _timerText;
 }
 
 std::map<std::string, int> GameScene::getResults() {
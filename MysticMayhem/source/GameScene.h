@@ -36,6 +36,8 @@ protected:
     std::shared_ptr<cugl::scene2::SceneNode> _rootnode; 
     
     std::shared_ptr<World> _world;
+    /** The asset key of the current map */
+    std::string _mapKey;
     
     /** Reference to the UI node that moves synchronously with the camera */
     std::shared_ptr<cugl::scene2::SceneNode> _UInode;
@@ -72,6 +74,10 @@ protected:
 
     std::shared_ptr<cugl::scene2::Label> _scoreHUD;
     std::shared_ptr<cugl::scene2::Label> _timerHUD;
+    /** The reusable text buffers for the HUD (so that updates do not allocate) */
+    std::string _scoreText;
+    std::string _framesText;
+    std::string _timerText;
     
     /** Whether or not debug mode is active */
     bool _debug;
@@ -89,9 +95,9 @@ protected:
 
     bool swap = false;
     
-    std::string updateScoreText(const int score);
-    std::string updateFramesText(const double score);
-    std::string updateTimerText(const time_t time);
+    const std::string& updateScoreText(const int score);
+    const std::string& updateFramesText(const double score);
+    const std::string& updateTimerText(const time_t time);
     
     bool isDebug( ) const { return _debug; }
     
@@ -40,6 +40,27 @@ constexpr float  BOX2D_TO_SCENE = 40.0f;
 
 constexpr int MAX_CHARS_IN_USERNAME = 15;
 
+/**
+ * Render benchmark mode.
+ *
+ * 0 disables the benchmark. 1 records every graphics command and still draws
+ * the frame. 2 records the commands but never sends them to the GPU, which
+ * measures the CPU cost of rendering alone (the screen stays blank).
+ */
+constexpr int RENDER_BENCHMARK = 0;
+
+/** The number of frames averaged in each render benchmark report */
+constexpr int RENDER_BENCHMARK_FRAMES = 300;
+
+/** Whether to log the audio DSP kernel throughput and resampler cost at startup */
+constexpr bool DSP_BENCHMARK = false;
+
+/** Seconds between audio thread profile reports (0 disables the profiler) */
+constexpr float AUDIO_PROFILE_INTERVAL = 0;
+
+/** Bytes of assets kept for idle scenes (fits the ~32MB of small groups, not the ~154MB player group) */
+constexpr size_t ASSET_BUDGET = 64*1024*1024;
+
 }
 
 #endif /* Globals_h */
@@ -51,7 +51,16 @@ bool LobbyScene::init(const std::shared_ptr<AssetManager>& assets) {
     }
     
     _assets = assets;
+    _assets->acquire("lobby");
+    _assets->acquire("settings");
+    _assets->acquire("player");
+    // The game starts from here, so load it while the players gather
+    _assets->prefetch("game");
     auto layer = assets->get<scene2::SceneNode>("lobby");
+    if (layer == nullptr) {
+        CULogError("Scene 'lobby' is not loaded");
+        return false;
+    }
     layer->setContentSize(dimen);
     layer->doLayout(); // This rearranges the children to fit the screen
     addChild(layer);
@@ -241,7 +250,9 @@ bool LobbyScene::init(const std::shared_ptr<AssetManager>& assets) {
     _playerCustom->setStaffKey("player_staff");
     _playerCustom->setStaffTagKey("player_staff_tag");
     _playerCustom->setRingKey("player_direction");
-    _playerCustom->setTextures(_assets);
+    if (!_playerCustom->setTextures(_assets)) {
+        return false;
+    }
     _playerCustom->setDrawScale(100.0f);
     _playerCustom->flipHorizontal(false);
     _playerCustom->setSkin(1);
@@ -374,6 +385,11 @@ void LobbyScene::dispose() {
     _mapNextButton = nullptr;
     _mapPrevButton = nullptr;
     _playerLabels.clear();
+    if (_assets != nullptr) {
+        _assets->release("lobby");
+        _assets->release("settings");
+        _assets->release("player");
+    }
     _assets = nullptr;
     _active = false;
     _playAgain = false;
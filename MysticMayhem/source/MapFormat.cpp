@@ -0,0 +1,456 @@
+//
+//  MapFormat.cpp
+//  Roshamboogie
+//
+//  Created on 10/18/26.
+//  Copyright © 2026 Game Design Initiative at Cornell. All rights reserved.
+//
+
+#include "MapFormat.h"
+#include "Globals.h"
+#include "World.h"
+#include <cstring>
+#include <unordered_map>
+
+using namespace cugl;
+using namespace mapfile;
+
+#pragma mark -
+#pragma mark Loading
+
+/**
+ * Releases the level data, returning this object to its empty state.
+ */
+void MapFile::dispose() {
+    _file = nullptr;
+    _data = nullptr;
+    _size = 0;
+    _header = nullptr;
+}
+
+/**
+ * Initializes this level from a compiled level in memory.
+ *
+ * The data is not copied, and it must outlive this object.
+ *
+ * @param data  The compiled level
+ * @param size  The size of the data in bytes
+ *
+ * @return true if the data is a valid compiled level
+ */
+bool MapFile::initWithData(const Uint8* data, size_t size) {
+    _data = data;
+    _size = size;
+    _header = reinterpret_cast<const Header*>(data);
+    if (!validate()) {
+        dispose();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Initializes this level by mapping a file in the asset directory.
+ *
+ * @param file  The path to the file, relative to the asset directory
+ *
+ * @return true if the file is a valid compiled level
+ */
+bool MapFile::initWithAsset(const std::string& file) {
+    std::shared_ptr<MappedFile> mapped = MappedFile::allocWithAsset(file);
+    if (mapped == nullptr || !initWithData(mapped->data(), mapped->size())) {
+        return false;
+    }
+    _file = mapped;
+    return true;
+}
+
+/**
+ * Returns the hash stored in the header for the given JSON text.
+ *
+ * This is the 32-bit FNV-1a hash of the text.
+ *
+ * @param text      The JSON text
+ * @param length    The length of the text in bytes
+ *
+ * @return the hash stored in the header for the given JSON text.
+ */
+Uint32 MapFile::hashSource(const char* text, size_t length) {
+    Uint32 hash = 2166136261u;
+    for(size_t ii = 0; ii < length; ii++) {
+        hash = (hash ^ (Uint8)text[ii])*16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Returns true if this level was compiled from the given JSON text.
+ *
+ * @param text      The JSON text
+ * @param length    The length of the text in bytes
+ *
+ * @return true if this level was compiled from the given JSON text.
+ */
+bool MapFile::matchesSource(const char* text, size_t length) const {
+    return _header->sourceSize == length && _header->sourceHash == hashSource(text, length);
+}
+
+/**
+ * Returns true if the data is a well-formed compiled level.
+ *
+ * This checks the header and every offset and index in the file once,
+ * so that the accessors do not need to.
+ *
+ * @return true if the data is a well-formed compiled level.
+ */
+bool MapFile::validate() {
+    if (_data == nullptr || _size < sizeof(Header)) {
+        return false;
+    }
+    const Header& head = *_header;
+    if (head.magic != MAP_MAGIC || head.version != MAP_VERSION || head.fileSize != _size) {
+        CULogError("Level is not a version %d compiled map", MAP_VERSION);
+        return false;
+    }
+    if (head.tileScale != globals::TILE_TO_BOX2D || head.sceneScale != globals::SCENE_TO_BOX2D) {
+        CULogError("Level was compiled with different physics scales; recompile it");
+        return false;
+    }
+
+    auto fits = [this](const Section& section, size_t stride) {
+        return section.offset % 4 == 0 && section.offset <= _size &&
+               section.count <= (_size-section.offset)/stride;
+    };
+    if (!fits(head.names, sizeof(Name)) || !fits(head.walls, sizeof(Wall)) ||
+        !fits(head.vertices, sizeof(Vec2)) || !fits(head.indices, sizeof(Uint32)) ||
+        !fits(head.objects, sizeof(Object)) || !fits(head.tiles, sizeof(Sprite)) ||
+        !fits(head.chunks, sizeof(Chunk)) || !fits(head.chunkTiles, sizeof(Uint32)) ||
+        !fits(head.decorations, sizeof(Sprite)) ||
+        head.chunks.count != head.chunkCols*head.chunkRows) {
+        CULogError("Level has a corrupt section table");
+        return false;
+    }
+
+    const Name* names = get<Name>(head.names);
+    for(Uint32 ii = 0; ii < head.names.count; ii++) {
+        if (memchr(names[ii].text, 0, MAP_NAME_LENGTH) == nullptr) {
+            return false;
+        }
+    }
+    const Wall* walls = getWalls();
+    const Uint32* indices = getIndices();
+    for(Uint32 ii = 0; ii < head.walls.count; ii++) {
+        const Wall& wall = walls[ii];
+        if (wall.firstVertex > head.vertices.count || wall.vertexCount > head.vertices.count-wall.firstVertex ||
+            wall.firstIndex > head.indices.count || wall.indexCount > head.indices.count-wall.firstIndex) {
+            return false;
+        }
+        for(Uint32 jj = 0; jj < wall.indexCount; jj++) {
+            if (indices[wall.firstIndex+jj] >= wall.vertexCount) {
+                return false;
+            }
+        }
+    }
+    const Object* objects = getObjects();
+    for(Uint32 ii = 0; ii < head.objects.count; ii++) {
+        if (objects[ii].element != MAP_NO_NAME && objects[ii].element >= head.names.count) {
+            return false;
+        }
+    }
+    for(const Section* section : { &head.tiles, &head.decorations }) {
+        const Sprite* sprites = get<Sprite>(*section);
+        for(Uint32 ii = 0; ii < section->count; ii++) {
+            if (sprites[ii].asset >= head.names.count) {
+                return false;
+            }
+        }
+    }
+    const Chunk* chunks = get<Chunk>(head.chunks);
+    const Uint32* chunkTiles = getChunkTiles();
+    for(Uint32 ii = 0; ii < head.chunks.count; ii++) {
+        if (chunks[ii].first > head.chunkTiles.count || chunks[ii].count > head.chunkTiles.count-chunks[ii].first) {
+            return false;
+        }
+    }
+    for(Uint32 ii = 0; ii < head.chunkTiles.count; ii++) {
+        if (chunkTiles[ii] >= head.tiles.count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#pragma mark -
+#pragma mark Compiler
+
+/**
+ * Returns the game object type for the given JSON type name.
+ *
+ * Unknown names are player spawns, as in the original JSON loader.
+ *
+ * @param name  The type field of a game object
+ *
+ * @return the game object type for the given JSON type name.
+ */
+GameObjectType MapFile::getObjectType(const std::string& name) {
+    if (name == SWAP_STATION) {
+        return GameObjectType::Station;
+    } else if (name == BOOSTER) {
+        return GameObjectType::Booster;
+    } else if (name == EGG_SPAWN) {
+        return GameObjectType::EggSpawn;
+    }  else if (name == ORB_ACTIVE) {
+        return GameObjectType::OrbActive;
+    } else if (name == ORB_INACTIVE) {
+        return GameObjectType::OrbInactive;
+    } else {
+        return GameObjectType::PlayerSpawn;
+    }
+}
+
+namespace {
+    /** Name table built up while compiling */
+    struct NameTable {
+        std::vector<Name> names;
+        std::unordered_map<std::string,Uint32> lookup;
+
+        bool add(const std::string& name, Uint32& index, std::string& error) {
+            auto it = lookup.find(name);
+            if (it != lookup.end()) {
+                index = it->second;
+                return true;
+            } else if (name.size() >= MAP_NAME_LENGTH) {
+                error = "Name is too long: "+name;
+                return false;
+            }
+            Name entry;
+            memset(entry.text, 0, MAP_NAME_LENGTH);
+            memcpy(entry.text, name.c_str(), name.size());
+            index = (Uint32)names.size();
+            names.push_back(entry);
+            lookup[name] = index;
+            return true;
+        }
+    };
+
+    /** Appends a section to the output, returning its table entry */
+    template <typename T>
+    Section append(std::vector<Uint8>& result, const std::vector<T>& items) {
+        Section section;
+        section.offset = (Uint32)result.size();
+        section.count = (Uint32)items.size();
+        const Uint8* bytes = reinterpret_cast<const Uint8*>(items.data());
+        result.insert(result.end(), bytes, bytes+items.size()*sizeof(T));
+        return section;
+    }
+
+    bool readSprites(const std::shared_ptr<JsonValue>& json, float scale, NameTable& table,
+                     std::vector<Sprite>& result, std::string& error) {
+        for(size_t ii = 0; ii < json->size(); ii++) {
+            auto item = json->get((int)ii);
+            Sprite sprite;
+            sprite.x = item->getFloat(X_FIELD)*scale;
+            sprite.y = item->getFloat(Y_FIELD)*scale;
+            if (!table.add(item->getString(ASSET_FIELD), sprite.asset, error)) {
+                return false;
+            }
+            result.push_back(sprite);
+        }
+        return true;
+    }
+
+    std::vector<Vec2> readWall(const std::shared_ptr<JsonValue>& json) {
+        std::vector<Vec2> points;
+        for(size_t jj = 0; jj < json->size(); jj++) {
+            auto point = json->get((int)jj);
+            points.push_back(Vec2(point->getFloat(X_FIELD)*globals::SCENE_TO_BOX2D,
+                                  point->getFloat(Y_FIELD)*globals::SCENE_TO_BOX2D));
+        }
+        return points;
+    }
+
+    Uint32 chunkIndex(float coord, Uint32 limit) {
+        int cell = (int)std::floor(coord/globals::TILE_TO_BOX2D)/MAP_CHUNK_SIZE;
+        return (Uint32)std::max(0,std::min(cell,(int)limit-1));
+    }
+}
+
+/**
+ * Compiles the text of a Tiled JSON export into a level.
+ *
+ * @param source    The JSON text
+ * @param result    The buffer to store the compiled level
+ * @param error     The message on failure
+ *
+ * @return true if the level was compiled
+ */
+bool MapFile::compile(const std::string& source, std::vector<Uint8>& result, std::string& error) {
+    std::shared_ptr<JsonValue> json = JsonValue::allocWithJson(source);
+    if (json == nullptr) {
+        error = "Invalid JSON";
+        return false;
+    }
+    for(const char* field : { WIDTH_FIELD, HEIGHT_FIELD, GAME_OBJECTS_FIELD, WALLS_FIELD, TILES_FIELD, DECORATIONS_FIELD }) {
+        if (!json->has(field)) {
+            error = std::string("Missing field: ")+field;
+            return false;
+        }
+    }
+
+    Header head;
+    memset(&head, 0, sizeof(Header));
+    head.magic = MAP_MAGIC;
+    head.version = MAP_VERSION;
+    head.sourceSize = (Uint32)source.size();
+    head.sourceHash = hashSource(source.data(), source.size());
+    head.tileScale = globals::TILE_TO_BOX2D;
+    head.sceneScale = globals::SCENE_TO_BOX2D;
+    head.width  = json->getFloat(WIDTH_FIELD);
+    head.height = json->getFloat(HEIGHT_FIELD);
+    head.totalOrbs = json->getInt("totalOrbs");
+    head.totalEggs = json->getInt("totalEggs");
+    head.chunkCols = (Uint32)head.width/MAP_CHUNK_SIZE+1;
+    head.chunkRows = (Uint32)head.height/MAP_CHUNK_SIZE+1;
+
+    NameTable table;
+
+    // Triangulate the walls now, so the game never has to
+    std::vector<Wall> walls;
+    std::vector<Vec2> vertices;
+    std::vector<Uint32> indices;
+    auto jwalls = json->get(WALLS_FIELD);
+    SimpleTriangulator triangulator;
+    for(size_t ii = 0; ii < jwalls->size(); ii++) {
+        std::vector<Vec2> points = readWall(jwalls->get((int)ii));
+        triangulator.set(points);
+        triangulator.calculate();
+        std::vector<Uint32> triangles = triangulator.getTriangulation();
+        triangulator.reset();
+
+        Wall wall;
+        wall.firstVertex = (Uint32)vertices.size();
+        wall.vertexCount = (Uint32)points.size();
+        wall.firstIndex = (Uint32)indices.size();
+        wall.indexCount = (Uint32)triangles.size();
+        vertices.insert(vertices.end(), points.begin(), points.end());
+        indices.insert(indices.end(), triangles.begin(), triangles.end());
+        walls.push_back(wall);
+    }
+
+    std::vector<Object> objects;
+    auto jobjects = json->get(GAME_OBJECTS_FIELD);
+    for(size_t ii = 0; ii < jobjects->size(); ii++) {
+        auto item = jobjects->get((int)ii);
+        Object object;
+        object.type = (Uint32)getObjectType(item->getString(TYPE_FIELD));
+        object.element = MAP_NO_NAME;
+        object.x = item->getFloat(X_FIELD)*globals::SCENE_TO_BOX2D;
+        object.y = item->getFloat(Y_FIELD)*globals::SCENE_TO_BOX2D;
+        if (item->has("element") && !table.add(item->getString("element"), object.element, error)) {
+            return false;
+        }
+        objects.push_back(object);
+    }
+
+    std::vector<Sprite> tiles;
+    std::vector<Sprite> decorations;
+    if (!readSprites(json->get(TILES_FIELD), globals::TILE_TO_BOX2D, table, tiles, error) ||
+        !readSprites(json->get(DECORATIONS_FIELD), globals::SCENE_TO_BOX2D, table, decorations, error)) {
+        return false;
+    }
+
+    // Bucket the tiles into chunks, keeping export order within each chunk
+    std::vector<std::vector<Uint32>> buckets(head.chunkCols*head.chunkRows);
+    for(Uint32 ii = 0; ii < tiles.size(); ii++) {
+        Uint32 col = chunkIndex(tiles[ii].x, head.chunkCols);
+        Uint32 row = chunkIndex(tiles[ii].y, head.chunkRows);
+        buckets[row*head.chunkCols+col].push_back(ii);
+    }
+    std::vector<Chunk> chunks;
+    std::vector<Uint32> chunkTiles;
+    for(auto it = buckets.begin(); it != buckets.end(); ++it) {
+        Chunk chunk;
+        chunk.first = (Uint32)chunkTiles.size();
+        chunk.count = (Uint32)it->size();
+        chunkTiles.insert(chunkTiles.end(), it->begin(), it->end());
+        chunks.push_back(chunk);
+    }
+
+    // Every struct is a multiple of 4 bytes, so each section stays aligned
+    result.assign(sizeof(Header), 0);
+    head.names = append(result, table.names);
+    head.walls = append(result, walls);
+    head.vertices = append(result, vertices);
+    head.indices = append(result, indices);
+    head.objects = append(result, objects);
+    head.tiles = append(result, tiles);
+    head.chunks = append(result, chunks);
+    head.chunkTiles = append(result, chunkTiles);
+    head.decorations = append(result, decorations);
+    head.fileSize = (Uint32)result.size();
+    memcpy(result.data(), &head, sizeof(Header));
+    return true;
+}
+
+#pragma mark -
+#pragma mark Verification
+
+/**
+ * Returns true if the level loads the same World as its JSON text.
+ *
+ * This loads one World from the compiled level and another by streaming
+ * the JSON, and compares them with {@link World#matches}. It also checks
+ * that every tile is in exactly one chunk.
+ *
+ * @param map       The compiled level
+ * @param source    The JSON text it was compiled from
+ * @param error     The message on failure
+ *
+ * @return true if the level loads the same World as its JSON text.
+ */
+bool MapFile::verify(const std::shared_ptr<MapFile>& map, const std::string& source, std::string& error) {
+    if (!map->matchesSource(source.data(), source.size())) {
+        error = "Level was not compiled from this JSON";
+        return false;
+    }
+
+    // Load the level both ways the game can, and compare the results. As in
+    // GenericLoader, construct the worlds directly: World::alloc() would try
+    // to load an empty asset path.
+    std::shared_ptr<World> compiled = std::make_shared<World>();
+    if (!compiled->preload(map)) {
+        error = "Compiled level does not load";
+        return false;
+    }
+    std::shared_ptr<World> exported = std::make_shared<World>();
+    JsonParser parser;
+    if (!parser.initWithBuffer(source.data(), source.size()) || !exported->preload(parser)) {
+        error = "JSON level does not load";
+        return false;
+    } else if (!compiled->matches(*exported, error)) {
+        return false;
+    }
+
+    // Each tile must be in exactly one chunk
+    const Header& head = map->getHeader();
+    std::vector<Uint32> seen(head.tiles.count, 0);
+    for(Uint32 row = 0; row < head.chunkRows; row++) {
+        for(Uint32 col = 0; col < head.chunkCols; col++) {
+            const Chunk& chunk = map->getChunk(col, row);
+            for(Uint32 ii = 0; ii < chunk.count; ii++) {
+                Uint32 tile = map->getChunkTiles()[chunk.first+ii];
+                if (chunkIndex(map->getTiles()[tile].x, head.chunkCols) != col ||
+                    chunkIndex(map->getTiles()[tile].y, head.chunkRows) != row) {
+                    error = "Tile "+strtool::to_string(tile)+" is in the wrong chunk";
+                    return false;
+                }
+                seen[tile]++;
+            }
+        }
+    }
+    if (std::count(seen.begin(), seen.end(), 1) != (long)seen.size()) {
+        error = "Tile chunks do not cover the tiles";
+        return false;
+    }
+    return true;
+}
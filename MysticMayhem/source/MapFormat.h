@@ -0,0 +1,335 @@
+//
+//  MapFormat.h
+//  Roshamboogie
+//
+//  Created on 10/18/26.
+//  Copyright © 2026 Game Design Initiative at Cornell. All rights reserved.
+//
+//  Compiled level format. A compiled level is the Tiled JSON export with the
+//  walls already triangulated, every position already in Box2D units, and
+//  every asset name replaced by an index into a name table. Each section is
+//  a packed array of the structs below, so the file is used where it is
+//  mapped, with no parsing. Values are little-endian (every target is).
+//
+//  The header records the size and hash of the JSON export it was compiled
+//  from, so a level whose JSON has since been re-exported is detected as
+//  stale and the JSON is loaded instead.
+//
+
+#ifndef MapFormat_h
+#define MapFormat_h
+
+#include <cugl/cugl.h>
+#include <cugl/io/CUMappedFile.h>
+#include "MapConstants.h"
+
+/** "MLVL" as a little-endian word */
+#define MAP_MAGIC           0x4C564C4D
+/** Bump this whenever a struct below changes */
+#define MAP_VERSION         2
+#define MAP_EXTENSION       ".lvl"
+/** Tiles per side of a tile chunk */
+#define MAP_CHUNK_SIZE      8
+/** Longest asset or element name, including the terminator */
+#define MAP_NAME_LENGTH     32
+/** Name index for objects with no element */
+#define MAP_NO_NAME         0xFFFFFFFF
+
+namespace mapfile {
+
+/** A packed array, offset in bytes from the start of the file */
+struct Section {
+    /** The offset of the first element in bytes */
+    Uint32 offset;
+    /** The number of elements */
+    Uint32 count;
+};
+
+/** The file header, which is always at offset 0 */
+struct Header {
+    /** Always MAP_MAGIC */
+    Uint32 magic;
+    /** The MAP_VERSION the level was compiled with */
+    Uint32 version;
+    /** The size of the whole file in bytes */
+    Uint32 fileSize;
+    /** The size and FNV-1a hash of the JSON export this was compiled from */
+    Uint32 sourceSize;
+    Uint32 sourceHash;
+    /** The scale factors the level was compiled with (must match Globals.h) */
+    float tileScale;
+    float sceneScale;
+    /** Level size in tiles */
+    float width;
+    float height;
+    /** The totalOrbs field of the export */
+    Uint32 totalOrbs;
+    /** The totalEggs field of the export */
+    Uint32 totalEggs;
+    /** Dimensions of the chunk grid */
+    Uint32 chunkCols;
+    Uint32 chunkRows;
+    Section names;          // Name
+    Section walls;          // Wall
+    Section vertices;       // cugl::Vec2
+    Section indices;        // Uint32
+    Section objects;        // Object
+    Section tiles;          // Sprite, in export order
+    Section chunks;         // Chunk, row-major
+    Section chunkTiles;     // Uint32 tile index
+    Section decorations;    // Sprite, in draw order
+};
+
+/** An asset or element name, padded with zeros */
+struct Name {
+    /** The name, which is always null terminated */
+    char text[MAP_NAME_LENGTH];
+};
+
+/** A wall polygon; indices are relative to its first vertex */
+struct Wall {
+    /** The position of the first vertex in the vertices section */
+    Uint32 firstVertex;
+    /** The number of vertices in this wall */
+    Uint32 vertexCount;
+    /** The position of the first index in the indices section */
+    Uint32 firstIndex;
+    /** The number of triangulation indices in this wall */
+    Uint32 indexCount;
+};
+
+/** A game object (spawn point, station or booster) */
+struct Object {
+    /** A GameObjectType */
+    Uint32 type;
+    /** Name index of the spawn element, or MAP_NO_NAME */
+    Uint32 element;
+    /** The x position in Box2D units */
+    float x;
+    /** The y position in Box2D units */
+    float y;
+};
+
+/** A tile or decoration */
+struct Sprite {
+    /** The x position in Box2D units */
+    float x;
+    /** The y position in Box2D units */
+    float y;
+    /** Name index of the texture */
+    Uint32 asset;
+};
+
+/** A range of the chunkTiles section */
+struct Chunk {
+    /** The position of the first entry in the chunkTiles section */
+    Uint32 first;
+    /** The number of tiles in this chunk */
+    Uint32 count;
+};
+
+}
+
+/**
+ * A compiled level, either mapped from a file or pointing at a buffer.
+ *
+ * The level is validated once when initialized; after that every accessor
+ * is a pointer into the data, which is valid as long as this object is.
+ */
+class MapFile {
+protected:
+    /** The mapped file (nullptr if this points at a buffer) */
+    std::shared_ptr<cugl::MappedFile> _file;
+    /** The start of the compiled level */
+    const Uint8* _data;
+    /** The size of the compiled level in bytes */
+    size_t _size;
+    /** The header at the start of the data */
+    const mapfile::Header* _header;
+
+    /**
+     * Returns true if the data is a well-formed compiled level.
+     *
+     * This checks the header and every offset and index in the file once,
+     * so that the accessors do not need to.
+     *
+     * @return true if the data is a well-formed compiled level.
+     */
+    bool validate();
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates an empty compiled level. Use an init method to load one.
+     */
+    MapFile() : _data(nullptr), _size(0), _header(nullptr) {}
+
+    /**
+     * Deletes this compiled level, releasing the mapped file if any.
+     */
+    ~MapFile() { dispose(); }
+
+    /**
+     * Releases the level data, returning this object to its empty state.
+     */
+    void dispose();
+
+    /**
+     * Initializes this level from a compiled level in memory.
+     *
+     * The data is not copied, and it must outlive this object.
+     *
+     * @param data  The compiled level
+     * @param size  The size of the data in bytes
+     *
+     * @return true if the data is a valid compiled level
+     */
+    bool initWithData(const Uint8* data, size_t size);
+
+    /**
+     * Initializes this level by mapping a file in the asset directory.
+     *
+     * @param file  The path to the file, relative to the asset directory
+     *
+     * @return true if the file is a valid compiled level
+     */
+    bool initWithAsset(const std::string& file);
+
+    /**
+     * Returns a newly mapped level for the given asset file.
+     *
+     * @param file  The path to the file, relative to the asset directory
+     *
+     * @return a newly mapped level (or nullptr if the file is missing or invalid)
+     */
+    static std::shared_ptr<MapFile> allocWithAsset(const std::string& file) {
+        std::shared_ptr<MapFile> result = std::make_shared<MapFile>();
+        return (result->initWithAsset(file) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Accessors
+    /**
+     * Returns the header of this level.
+     *
+     * @return the header of this level.
+     */
+    const mapfile::Header& getHeader() const { return *_header; }
+
+    /**
+     * Returns the hash stored in the header for the given JSON text.
+     *
+     * This is the 32-bit FNV-1a hash of the text.
+     *
+     * @param text      The JSON text
+     * @param length    The length of the text in bytes
+     *
+     * @return the hash stored in the header for the given JSON text.
+     */
+    static Uint32 hashSource(const char* text, size_t length);
+
+    /**
+     * Returns true if this level was compiled from the given JSON text.
+     *
+     * @param text      The JSON text
+     * @param length    The length of the text in bytes
+     *
+     * @return true if this level was compiled from the given JSON text.
+     */
+    bool matchesSource(const char* text, size_t length) const;
+
+    /**
+     * Returns the first element of the given section.
+     *
+     * @param section   A section of the header
+     *
+     * @return the first element of the given section.
+     */
+    template <typename T>
+    const T* get(const mapfile::Section& section) const {
+        return reinterpret_cast<const T*>(_data+section.offset);
+    }
+
+    /**
+     * Returns the name at the given index of the name table.
+     *
+     * @param index The name index (or MAP_NO_NAME)
+     *
+     * @return the name at the given index (or "" for MAP_NO_NAME)
+     */
+    const char* getName(Uint32 index) const {
+        return index == MAP_NO_NAME ? "" : get<mapfile::Name>(_header->names)[index].text;
+    }
+
+    /** Returns the walls, in export order */
+    const mapfile::Wall* getWalls() const { return get<mapfile::Wall>(_header->walls); }
+    /** Returns the wall vertices in Box2D units */
+    const cugl::Vec2* getVertices() const { return get<cugl::Vec2>(_header->vertices); }
+    /** Returns the wall triangulations, relative to the first vertex of each wall */
+    const Uint32* getIndices() const { return get<Uint32>(_header->indices); }
+    /** Returns the game objects, in export order */
+    const mapfile::Object* getObjects() const { return get<mapfile::Object>(_header->objects); }
+    /** Returns the background tiles, in export order */
+    const mapfile::Sprite* getTiles() const { return get<mapfile::Sprite>(_header->tiles); }
+    /** Returns the decorations, in draw order */
+    const mapfile::Sprite* getDecorations() const { return get<mapfile::Sprite>(_header->decorations); }
+
+    /**
+     * Returns the chunk at the given grid cell.
+     *
+     * Row 0 is the bottom of the level.
+     *
+     * @param col   The chunk column
+     * @param row   The chunk row
+     *
+     * @return the chunk at the given grid cell.
+     */
+    const mapfile::Chunk& getChunk(Uint32 col, Uint32 row) const {
+        return get<mapfile::Chunk>(_header->chunks)[row*_header->chunkCols+col];
+    }
+
+    /** Returns the tile indices referenced by the chunks */
+    const Uint32* getChunkTiles() const { return get<Uint32>(_header->chunkTiles); }
+
+#pragma mark -
+#pragma mark Compiler
+    /**
+     * Returns the game object type for the given JSON type name.
+     *
+     * Unknown names are player spawns, as in the original JSON loader.
+     *
+     * @param name  The type field of a game object
+     *
+     * @return the game object type for the given JSON type name.
+     */
+    static GameObjectType getObjectType(const std::string& name);
+
+    /**
+     * Compiles the text of a Tiled JSON export into a level.
+     *
+     * @param source    The JSON text
+     * @param result    The buffer to store the compiled level
+     * @param error     The message on failure
+     *
+     * @return true if the level was compiled
+     */
+    static bool compile(const std::string& source, std::vector<Uint8>& result, std::string& error);
+
+    /**
+     * Returns true if the level loads the same World as its JSON text.
+     *
+     * This loads one World from the compiled level and another by streaming
+     * the JSON, and compares them with {@link World#matches}. It also checks
+     * that every tile is in exactly one chunk.
+     *
+     * @param map       The compiled level
+     * @param source    The JSON text it was compiled from
+     * @param error     The message on failure
+     *
+     * @return true if the level loads the same World as its JSON text.
+     */
+    static bool verify(const std::shared_ptr<MapFile>& map, const std::string& source, std::string& error);
+};
+
+#endif /* MapFormat_h */
@@ -45,7 +45,13 @@ bool MenuScene::init(const std::shared_ptr<AssetManager>& assets) {
     }
     
     _assets = assets;
+    _assets->acquire("menu");
+    _assets->acquire("settings");
     auto layer = assets->get<scene2::SceneNode>("menu");
+    if (layer == nullptr) {
+        CULogError("Scene 'menu' is not loaded");
+        return false;
+    }
     layer->setContentSize(dimen);
     layer->doLayout(); // This rearranges the children to fit the screen
     addChild(layer);
@@ -59,6 +65,9 @@ bool MenuScene::init(const std::shared_ptr<AssetManager>& assets) {
     _hostButton = std::dynamic_pointer_cast<scene2::Button>(assets->get<scene2::SceneNode>("menu_host"));
     _hostButton->addListener([=](const std::string& name, bool down) {
         _host = true;
+        // Load the lobby while the game is being created
+        _assets->prefetch("lobby");
+        _assets->prefetch("player");
         NetworkController::createGame();
         _joinButton->deactivate();
         _usernameField->deactivate();
@@ -75,6 +84,9 @@ bool MenuScene::init(const std::shared_ptr<AssetManager>& assets) {
     _joinButton->addListener([=](const std::string& name, bool down) {
         CULog("join button pressed");
         _host = false;
+        // Load the lobby while the room code is entered
+        _assets->prefetch("lobby");
+        _assets->prefetch("player");
 //        _slider->setVisible(false);
 //        _slider->deactivate();
 //        _label->setVisible(false);
@@ -206,6 +218,10 @@ void MenuScene::dispose() {
     _codeField = nullptr;
     _usernameField = nullptr;
     _slider = nullptr;
+    if (_assets != nullptr) {
+        _assets->release("menu");
+        _assets->release("settings");
+    }
     _assets = nullptr;
     _active = false;
     _create = false;
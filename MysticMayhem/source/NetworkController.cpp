@@ -161,7 +161,7 @@ struct GameHandler {
         tagged->setIsTagged(true);
         tagged->setTimeLastTagged(t.timestamp);
         tagger->incScore(globals::TAG_SCORE);
-        SoundController::playSound(SoundController::Type::TAG, tagger->getPosition() - self->getPosition());
+        SoundController::playSound(SoundController::Type::TAG, tagger->getPosition(), self->getPosition());
         if (tagged->getCurrElement() == Element::None && !t.dropEgg) {
             auto egg = world->getEgg(tagged->getEggId());
             egg->setPID(tagger->getID());
@@ -196,7 +196,7 @@ struct GameHandler {
         e->setCollected(true);
         e->setPID(data.playerId);
         auto self = world->getPlayer(network->getPlayerID().value());
-        SoundController::playSound(SoundController::Type::EGG, e->getPosition() - self->getPosition());
+        SoundController::playSound(SoundController::Type::EGG, e->getPosition(), self->getPosition());
     }
     void operator()(NetworkData::EggHatch & data) const {
         auto p = world->getPlayer(data.playerId);
@@ -214,7 +214,7 @@ struct GameHandler {
         auto p = world->getPlayer(data.playerId);
         p->setOrbScore(p->getOrbScore() + 1);
         auto self = world->getPlayer(network->getPlayerID().value());
-        SoundController::playSound(SoundController::Type::ORB, o->getPosition() - self->getPosition());
+        SoundController::playSound(SoundController::Type::ORB, o->getPosition(), self->getPosition());
     }
     void operator()(NetworkData::Swap & data) const {
         world->getPlayer(data.playerId)->setElement(data.newElement);
@@ -222,7 +222,7 @@ struct GameHandler {
         s->setLastUsed(clock());
         s->setActive(false);
         auto self = world->getPlayer(network->getPlayerID().value());
-        SoundController::playSound(SoundController::Type::SWAP, s->getPosition() - self->getPosition());
+        SoundController::playSound(SoundController::Type::SWAP, s->getPosition(), self->getPosition());
     }
     void operator()(NetworkData::Position & data) const {
         auto p = world->getPlayer(data.playerId);
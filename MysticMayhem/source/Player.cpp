@@ -97,11 +97,24 @@ using namespace cugl;
 #define RING_RUN_RATE       0.02f
 
 /**
- * Sets the textures for this player.
+ * Sets the textures for this player, returning true on success.
  *
- * @param player      The texture for the player filmstrip
+ * This method fails, without creating any scene graph nodes, if any of
+ * the player textures is not loaded.
+ *
+ * @param assets    The asset manager with the player textures
+ *
+ * @return true if every player texture was loaded
  */
-void Player::setTextures(const std::shared_ptr<AssetManager>& assets) {
+bool Player::setTextures(const std::shared_ptr<AssetManager>& assets) {
+    const std::string keys[] = { "player", _skinKey, _colorKey, _faceKey, _bodyKey,
+                                 _hatKey, _staffKey, _staffTagKey, _ringKey };
+    for(const std::string& key : keys) {
+        if (assets->get<Texture>(key) == nullptr) {
+            CULogError("Player texture '%s' is not loaded", key.c_str());
+            return false;
+        }
+    }
 
     _sceneNode = scene2::PolygonNode::alloc();
     _sceneNode->setAnchor(Vec2::ANCHOR_CENTER);
@@ -164,7 +177,7 @@ void Player::setTextures(const std::shared_ptr<AssetManager>& assets) {
     _tagAnimationTimer = time(NULL);
     
     setElement(_currElt);
-
+    return true;
 }
 
 void Player::setBody() {
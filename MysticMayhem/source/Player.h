@@ -224,11 +224,16 @@ public:
     
     
     /**
-     * Sets the textures for this player.
+     * Sets the textures for this player, returning true on success.
      *
-     * @param player      The texture for the player filmstrip
+     * This method fails, without creating any scene graph nodes, if any of
+     * the player textures is not loaded.
+     *
+     * @param assets    The asset manager with the player textures
+     *
+     * @return true if every player texture was loaded
      */
-    void setTextures(const std::shared_ptr<cugl::AssetManager>& assets);
+    bool setTextures(const std::shared_ptr<cugl::AssetManager>& assets);
     
     void setBody();
     
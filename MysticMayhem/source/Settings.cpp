@@ -52,6 +52,10 @@ bool Settings::init(const std::shared_ptr<AssetManager>& assets, bool inGame) {
     
 //    _assets = assets;
     auto layer = assets->get<scene2::SceneNode>("settings");
+    if (layer == nullptr) {
+        CULogError("Scene 'settings' is not loaded");
+        return false;
+    }
     layer->setContentSize(Size(dimen.height,dimen.height));
 //    layer->doLayout(); // This rearranges the children to fit the screen
     addChild(layer);
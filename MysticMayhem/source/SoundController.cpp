@@ -9,15 +9,108 @@
 #include "SoundController.h"
 #include <cugl/cugl.h>
 #include <cstdlib>
+#include <cmath>
 
-#define NUM_ORB_SOUNDS 4
-#define NUM_TAG_SOUNDS 3
+// Spare voices per variant, so a new sound can start while an old one fades
+#define SPARE_VOICES 1
+// How far sounds are pushed to the side (1 is hard left/right)
+#define PAN_SPREAD 0.75f
 
 namespace SoundController{
 std::shared_ptr<cugl::AssetManager> _assets;
 bool spatialAudioEnabled = true;
 float soundVolume = 0.5;
 
+// The default curve matches the old hand-tuned gain of 12.5/distance
+Falloff falloff = Falloff::INVERSE;
+float falloffRef = 12.5f;
+float falloffMax = 1000.0f;
+float falloffRolloff = 1.0f;
+
+// A pre-built player for one sound variant
+struct Voice {
+    std::shared_ptr<cugl::audio::AudioNode> player;
+    Uint64 handle = 0;
+    Uint64 stamp = 0;
+};
+
+// The voice pool for one sound type (indexed by Type)
+struct Category {
+    const char* name;
+    int variants;
+    int limit;
+    Sint32 priority;
+    // Voice i plays variant i % variants
+    std::vector<Voice> voices;
+};
+
+// A full engine drops the least important sound first
+Category categories[] = {
+    { "orb",  4, 4, 0, {} },
+    { "egg",  1, 2, 2, {} },
+    { "tag",  3, 3, 3, {} },
+    { "swap", 1, 3, 1, {} }
+};
+
+bool poolsBuilt = false;
+Uint64 voiceClock = 0;
+
+std::string variantKey(const Category& cat, int variant) {
+    return cat.variants == 1 ? std::string(cat.name) : cat.name+std::to_string(variant+1);
+}
+
+// Builds every player up front. The sounds load asynchronously, so this waits
+// until they are all available; it only allocates once.
+bool buildPools() {
+    if (poolsBuilt) {
+        return true;
+    } else if (_assets == nullptr) {
+        return false;
+    }
+    for(Category& cat : categories) {
+        for(int ii = 0; ii < cat.variants; ii++) {
+            if (_assets->get<cugl::Sound>(variantKey(cat,ii)) == nullptr) {
+                return false;
+            }
+        }
+    }
+    for(Category& cat : categories) {
+        int size = (cat.limit+SPARE_VOICES)*cat.variants;
+        cat.voices.resize(size);
+        for(int ii = 0; ii < size; ii++) {
+            std::shared_ptr<cugl::Sound> sample = _assets->get<cugl::Sound>(variantKey(cat,ii % cat.variants));
+            cat.voices[ii].player = sample->createNode();
+            cat.voices[ii].handle = 0;
+        }
+    }
+    poolsBuilt = true;
+    return true;
+}
+
+// A player is free once the engine has released the graph wrapping it
+bool isFree(const Voice& voice) {
+    return voice.player.use_count() == 1;
+}
+
+float attenuate(float distance) {
+    if (falloff == Falloff::NONE || distance <= falloffRef) {
+        return 1;
+    }
+    distance = std::min(distance,falloffMax);
+    switch (falloff) {
+        case Falloff::LINEAR:
+            if (falloffMax <= falloffRef) {
+                return 1;
+            }
+            return std::max(0.0f,1-falloffRolloff*(distance-falloffRef)/(falloffMax-falloffRef));
+        case Falloff::INVERSE:
+            return falloffRef/(falloffRef+falloffRolloff*(distance-falloffRef));
+        case Falloff::EXPONENTIAL:
+            return std::pow(distance/falloffRef,-falloffRolloff);
+        default:
+            return 1;
+    }
+}
 
 void useSpatialAudio(bool useSpatialAudio){
     spatialAudioEnabled = useSpatialAudio;
@@ -25,53 +118,84 @@ void useSpatialAudio(bool useSpatialAudio){
 
 void init(std::shared_ptr<cugl::AssetManager> assets){
     _assets = assets;
+    poolsBuilt = false;
+}
+
+void dispose(){
+    for(Category& cat : categories) {
+        cat.voices.clear();
+    }
+    poolsBuilt = false;
+    _assets = nullptr;
+}
+
+void setFalloff(Falloff curve, float ref, float max, float rolloff){
+    falloff = curve;
+    falloffRef = std::max(ref,0.001f);
+    falloffMax = std::max(max,falloffRef);
+    falloffRolloff = rolloff;
 }
 
 void playSound(Type s, cugl::Vec2 pos){
-    std::shared_ptr<cugl::Sound> sample;
-    switch(s){
-        case Type::EGG:
-            sample = _assets->get<cugl::Sound>("egg");
-            break;
-        case Type::ORB:
-        {
-            int soundnum = (rand() % NUM_ORB_SOUNDS) + 1;
-            sample = _assets->get<cugl::Sound>("orb"+std::to_string(soundnum));
-            break;
+    playSound(s, pos, cugl::Vec2::ZERO);
+}
+
+void playSound(Type s, cugl::Vec2 emitter, cugl::Vec2 listener){
+    cugl::AudioEngine* engine = cugl::AudioEngine::get();
+    if (engine == nullptr || !buildPools()) {
+        return;
+    }
+    Category& cat = categories[(int)s];
+    
+    // Enforce the voice limit by fading out the oldest sound of this type
+    int active = 0;
+    Voice* oldest = nullptr;
+    for(Voice& voice : cat.voices) {
+        if (voice.handle && engine->isVoiceActive(voice.handle)) {
+            active++;
+            if (oldest == nullptr || voice.stamp < oldest->stamp) {
+                oldest = &voice;
+            }
         }
-        case Type::TAG:
-        {
-            int soundnum = (rand() % NUM_TAG_SOUNDS) + 1;
-            sample = _assets->get<cugl::Sound>("tag"+std::to_string(soundnum));
-            break;
+    }
+    if (active >= cat.limit && oldest != nullptr) {
+        engine->stopVoice(oldest->handle);
+        oldest->handle = 0;
+    }
+    
+    // Pick a random variant, falling back to any free variant
+    int size = (int)cat.voices.size();
+    int start = rand() % cat.variants;
+    Voice* choice = nullptr;
+    for(int ii = 0; choice == nullptr && ii < size; ii++) {
+        int pos = (start+ii) % size;
+        if (isFree(cat.voices[pos])) {
+            choice = &cat.voices[pos];
         }
-        case Type::SWAP:
-            sample = _assets->get<cugl::Sound>("swap");
-            break;
-        default:
-            return;
     }
-    std::shared_ptr<cugl::audio::AudioNode> node = sample->createNode();
+    if (choice == nullptr) {
+        return;
+    }
     
+    float gain = 1;
+    float pan  = 0;
     if(spatialAudioEnabled){
-        std::shared_ptr<cugl::audio::AudioSpinner> spatial = cugl::audio::AudioSpinner::alloc();
-//        spatial->setChannelPlan(cugl::audio::AudioSpinner::Plan::SIDE_STEREO);
-        spatial->attach(node);
-//        spatial->setAngle(pos.getAngle());
-        float gain = pos.length() * (4.0/50.0);
-//        float gain = std::pos(pos.length() * (4.0/50.0), 2.0);
-        if(gain <= 1){
-            node->setGain(1);
-        }else{
-            node->setGain(1/gain);
-        }
-        //TODO: replace with key
-        cugl::AudioEngine::get()->play(std::to_string(rand()), spatial, false, soundVolume);
-    }else{
-        //TODO: replace with key
-        cugl::AudioEngine::get()->play(std::to_string(rand()), node, false, soundVolume);
+        cugl::Vec2 offset = emitter-listener;
+        float distance = offset.length();
+        gain = attenuate(distance);
+        pan = PAN_SPREAD*offset.x/std::max(distance,falloffRef);
+        pan = std::max(-1.0f,std::min(1.0f,pan));
     }
     
+    choice->player->reset();
+    // Stamp with the output clock so onsets keep their spacing across buffers
+    Uint64 handle = engine->playVoice(choice->player, false, soundVolume*gain, cat.priority,
+                                      engine->getSampleTime());
+    if (handle) {
+        engine->setVoicePan(handle, pan);
+        choice->handle = handle;
+        choice->stamp = voiceClock++;
+    }
 }
 
 void setSoundVolume(float volume){
@@ -17,13 +17,37 @@ enum class Type {
     ORB, EGG, TAG, SWAP
 };
 
+//distance attenuation curves for positional sounds
+enum class Falloff {
+    //no attenuation
+    NONE,
+    //fades linearly from the reference distance to silence at the max distance
+    LINEAR,
+    //ref/(ref + rolloff*(d-ref)), the classic inverse distance curve
+    INVERSE,
+    //(d/ref)^-rolloff
+    EXPONENTIAL
+};
+
 //call this before calling any other SoundController method
 void init(std::shared_ptr<cugl::AssetManager> assets);
 
+//releases the voice pools; call this before stopping the AudioEngine
+void dispose();
+
 //play a sound at given position
 //pos is relative to the player, with (0,0) being on the player
 void playSound(Type s, cugl::Vec2 pos);
 
+//play a sound emitted at the given position, heard from the listener position
+//sounds are played from pre-built voices, so this never builds audio graph nodes
+//if a type is at its voice limit, its oldest sound is faded out to make room
+void playSound(Type s, cugl::Vec2 emitter, cugl::Vec2 listener);
+
+//set the distance attenuation curve for positional sounds
+//distances below ref are played at full volume; max is where attenuation stops
+void setFalloff(Falloff curve, float ref, float max, float rolloff);
+
 //void playMusic();
 
 //void pauseMusic();
@@ -267,8 +267,98 @@ void World::showDebug(bool flag) {
  * @return true if successfully loaded the asset from a file
  */
 bool World::preload(const std::string& file) {
-    std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(file);
-    return preload(reader->readJson());
+    // Prefer a compiled level (see tools/MapCompiler.cpp) next to the JSON export
+    std::shared_ptr<MappedFile> source = MappedFile::allocWithAsset(file);
+    size_t dot = file.rfind('.');
+    std::string compiled = file.substr(0,dot)+MAP_EXTENSION;
+    if (compiled != file) {
+        std::shared_ptr<MapFile> map = MapFile::allocWithAsset(compiled);
+        if (map != nullptr && (source == nullptr ||
+                               map->matchesSource(reinterpret_cast<const char*>(source->data()), source->size()))) {
+            return preload(map);
+        } else if (map != nullptr) {
+            CULogError("%s is out of date with %s; recompile it", compiled.c_str(), file.c_str());
+        }
+    }
+    
+    // Stream the file so that tiles and walls never become JsonValue trees
+    JsonParser parser;
+    if (source == nullptr ||
+        !parser.initWithBuffer(reinterpret_cast<const char*>(source->data()), source->size())) {
+        CUAssertLog(false, "Failed to load level file");
+        return false;
+    }
+    return preload(parser);
+}
+
+/**
+ * Loads this game level by streaming a source Json file.
+ *
+ * This load method should NEVER access the AssetManager.  Assets are loaded in
+ * parallel, not in sequence.  If an asset (like a game level) has references to
+ * other assets, then these should be connected later, during scene initialization.
+ *
+ * @return true if successfully loaded the asset from the parser
+ */
+bool World::preload(JsonParser& parser) {
+    if (parser.next() != JsonParser::Token::BeginObject) {
+        CUAssertLog(false, "Failed to load level file");
+        return false;
+    }
+    
+    float w = 0;
+    float h = 0;
+    bool hasObjects = false;
+    bool hasWalls = false;
+    bool hasTiles = false;
+    bool hasDecorations = false;
+    for(auto token = parser.next(); token != JsonParser::Token::EndObject; token = parser.next()) {
+        if (token == JsonParser::Token::Error || token == JsonParser::Token::End) {
+            CUAssertLog(false, "%s", parser.getError().c_str());
+            return false;
+        }
+        std::string_view key = parser.key();
+        if (key == WIDTH_FIELD) {
+            w = parser.asFloat();
+        } else if (key == HEIGHT_FIELD) {
+            h = parser.asFloat();
+        } else if (key == GAME_OBJECTS_FIELD && token == JsonParser::Token::BeginArray) {
+            hasObjects = true;
+            while (parser.next() == JsonParser::Token::BeginObject) {
+                loadGameObject(parser.readValue());
+            }
+        } else if (key == WALLS_FIELD && token == JsonParser::Token::BeginArray) {
+            hasWalls = loadWalls(parser);
+        } else if (key == TILES_FIELD && token == JsonParser::Token::BeginArray) {
+            hasTiles = loadPlacements(parser, _bgTiles, globals::TILE_TO_BOX2D);
+        } else if (key == DECORATIONS_FIELD && token == JsonParser::Token::BeginArray) {
+            hasDecorations = loadPlacements(parser, _decorations, globals::SCENE_TO_BOX2D);
+        } else {
+            parser.skip();
+        }
+    }
+    
+    _bounds.size.set(w * globals::TILE_TO_BOX2D , h* globals::TILE_TO_BOX2D);
+    
+    _sceneSize = Vec2(w*globals::TILE_TO_SCENE, h*globals::TILE_TO_SCENE);
+    
+    _physicsWorld = physics2::ObstacleWorld::alloc(getBounds(),Vec2::ZERO);
+    
+    if (!hasObjects) {
+        CUAssertLog(false, "Failed to load game objects");
+        return false;
+    } else if (!hasWalls) {
+        CUAssertLog(false, "Failed to load walls");
+        return false;
+    } else if (!hasTiles) {
+        CUAssertLog(false, "Failed to load tiles");
+        return false;
+    } else if (!hasDecorations) {
+        CUAssertLog(false, "Failed to load decorations");
+        return false;
+    }
+    
+    return true;
 }
 
 /**
@@ -342,6 +432,126 @@ bool World::preload(const std::shared_ptr<cugl::JsonValue>& json) {
 }
 
 
+bool World::preload(const std::shared_ptr<MapFile>& map) {
+    const mapfile::Header& head = map->getHeader();
+    float w = head.width;
+    float h = head.height;
+    
+    _bounds.size.set(w * globals::TILE_TO_BOX2D , h* globals::TILE_TO_BOX2D);
+    
+    _sceneSize = Vec2(w*globals::TILE_TO_SCENE, h*globals::TILE_TO_SCENE);
+    
+    _physicsWorld = physics2::ObstacleWorld::alloc(getBounds(),Vec2::ZERO);
+    
+    const mapfile::Object* objects = map->getObjects();
+    for(Uint32 ii = 0; ii < head.objects.count; ii++) {
+        const mapfile::Object& obj = objects[ii];
+        loadGameObject((GameObjectType)obj.type, Vec2(obj.x,obj.y), map->getName(obj.element));
+    }
+    
+    // Walls are pre-triangulated
+    const mapfile::Wall* walls = map->getWalls();
+    for(Uint32 ii = 0; ii < head.walls.count; ii++) {
+        const mapfile::Wall& info = walls[ii];
+        Poly2 wall(reinterpret_cast<const float*>(map->getVertices()+info.firstVertex), info.vertexCount*2,
+                   map->getIndices()+info.firstIndex, info.indexCount);
+        addWall(wall, ii);
+    }
+    
+    const mapfile::Sprite* tiles = map->getTiles();
+    _bgTiles.reserve(head.tiles.count);
+    for(Uint32 ii = 0; ii < head.tiles.count; ii++) {
+        _bgTiles.push_back(std::make_tuple(std::string(map->getName(tiles[ii].asset)),Vec2(tiles[ii].x,tiles[ii].y)));
+    }
+    
+    const mapfile::Sprite* decorations = map->getDecorations();
+    _decorations.reserve(head.decorations.count);
+    for(Uint32 ii = 0; ii < head.decorations.count; ii++) {
+        _decorations.push_back(std::make_tuple(std::string(map->getName(decorations[ii].asset)),Vec2(decorations[ii].x,decorations[ii].y)));
+    }
+    
+    return true;
+}
+
+
+namespace {
+    /** Slack for positions, since the two loaders parse numbers differently */
+    const float LAYOUT_EPSILON = 0.0001f;
+
+    template <typename T>
+    std::vector<Vec2> positionsOf(const std::vector<std::shared_ptr<T>>& items) {
+        std::vector<Vec2> result;
+        for(auto it = items.begin(); it != items.end(); ++it) {
+            result.push_back((*it)->getPosition());
+        }
+        return result;
+    }
+
+    template <typename T>
+    bool samePoints(const std::vector<T>& a, const std::vector<T>& b, const char* what, std::string& error) {
+        if (a.size() != b.size()) {
+            error = std::string(what)+" count differs";
+            return false;
+        }
+        for(size_t ii = 0; ii < a.size(); ii++) {
+            if (!a[ii].equals(b[ii], LAYOUT_EPSILON)) {
+                error = std::string(what)+" "+strtool::to_string(ii)+" differs";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool samePlacements(const std::vector<std::tuple<std::string,Vec2>>& a,
+                        const std::vector<std::tuple<std::string,Vec2>>& b,
+                        const char* what, std::string& error) {
+        if (a.size() != b.size()) {
+            error = std::string(what)+" count differs";
+            return false;
+        }
+        for(size_t ii = 0; ii < a.size(); ii++) {
+            if (std::get<0>(a[ii]) != std::get<0>(b[ii]) ||
+                !std::get<1>(a[ii]).equals(std::get<1>(b[ii]), LAYOUT_EPSILON)) {
+                error = std::string(what)+" "+strtool::to_string(ii)+" differs";
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+bool World::matches(const World& other, std::string& error) const {
+    if (!_bounds.equals(other._bounds, LAYOUT_EPSILON) || !_sceneSize.equals(other._sceneSize, LAYOUT_EPSILON)) {
+        error = "Level size differs";
+        return false;
+    }
+    
+    if (_walls.size() != other._walls.size()) {
+        error = "Wall count differs";
+        return false;
+    }
+    for(size_t ii = 0; ii < _walls.size(); ii++) {
+        const Poly2& mine = _walls[ii]->getPolygon();
+        const Poly2& theirs = other._walls[ii]->getPolygon();
+        if (mine.indices() != theirs.indices() ||
+            !samePoints(mine.vertices(), theirs.vertices(), "Wall vertex", error)) {
+            error = "Wall "+strtool::to_string(ii)+" differs";
+            return false;
+        }
+    }
+    
+    return (samePoints(positionsOf(_swapStations), positionsOf(other._swapStations), "Swap station", error) &&
+            samePoints(positionsOf(_boosters), positionsOf(other._boosters), "Booster", error) &&
+            samePoints(positionsOf(_orbs), positionsOf(other._orbs), "Orb", error) &&
+            samePoints(_initOrbLocs, other._initOrbLocs, "Inactive orb", error) &&
+            samePoints(_eggSpawns, other._eggSpawns, "Egg spawn", error) &&
+            samePoints(_playerSpawns, other._playerSpawns, "Player spawn", error) &&
+            samePoints(_NPCSpawns, other._NPCSpawns, "NPC spawn", error) &&
+            samePlacements(_bgTiles, other._bgTiles, "Tile", error) &&
+            samePlacements(_decorations, other._decorations, "Decoration", error));
+}
+
+
 //Used to unload objects for memory, likely will not need for now.
 void World::unload()  {
     CULog("Unloading world");
@@ -419,40 +629,100 @@ bool World::loadBackground(const std::shared_ptr<JsonValue> &json) {
 bool World::loadWalls(const std::shared_ptr<JsonValue> &json) {
     bool success = true;
     
-    std::string wname = "wall";
-    
     auto wsize = json->size();
     std::vector<Vec2> points;
     for (int ii = 0; ii<wsize ; ii++) {
         for (int jj = 0; jj<json->get(ii)->size(); jj++) {
             points.push_back(Vec2(json->get(ii)->get(jj)->getFloat("x")*globals::SCENE_TO_BOX2D,json->get(ii)->get(jj)->getFloat("y")*globals::SCENE_TO_BOX2D));
         }
-        std::shared_ptr<physics2::PolygonObstacle> wallobj;
-        Poly2 wall(points);
-        SimpleTriangulator triangulator;
-        triangulator.set(wall);
-        triangulator.calculate();
-        wall.setIndices(triangulator.getTriangulation());
-        wall.setGeometry(Geometry::SOLID);
-
-        wallobj = physics2::PolygonObstacle::alloc(wall);
-        wallobj->setDebugColor(Color4::WHITE);
-        // You cannot add constant "".  Must stringify
-        wallobj->setName(std::string("wall")+cugl::strtool::to_string(ii));
-        wallobj->setName(wname);
-        wallobj->setFriction(0.0);
-        wallobj->setRestitution(0.4);
-        // Set the physics attributes
-        wallobj->setBodyType(b2_staticBody);
-
-        wall *= _scale;
-        _walls.push_back(wallobj);
+        success = buildWall(points, ii) && success;
         points.clear();
     }
     
     return success;
 }
 
+// Streams the wall vertices, starting at the array of walls
+bool World::loadWalls(JsonParser& parser) {
+    bool success = true;
+    
+    int index = 0;
+    std::vector<Vec2> points;
+    while (parser.next() == JsonParser::Token::BeginArray) {
+        while (parser.next() == JsonParser::Token::BeginObject) {
+            Vec2 point;
+            for(auto token = parser.next(); token == JsonParser::Token::Number; token = parser.next()) {
+                if (parser.key() == X_FIELD) {
+                    point.x = parser.asFloat()*globals::SCENE_TO_BOX2D;
+                } else if (parser.key() == Y_FIELD) {
+                    point.y = parser.asFloat()*globals::SCENE_TO_BOX2D;
+                }
+            }
+            if (parser.token() != JsonParser::Token::EndObject) {
+                return false;
+            }
+            points.push_back(point);
+        }
+        success = buildWall(points, index++) && success;
+        points.clear();
+    }
+    
+    return success && parser.token() == JsonParser::Token::EndArray;
+}
+
+bool World::buildWall(const std::vector<Vec2>& points, int index) {
+    Poly2 wall(points);
+    SimpleTriangulator triangulator;
+    triangulator.set(wall);
+    triangulator.calculate();
+    wall.setIndices(triangulator.getTriangulation());
+    return addWall(wall, index);
+}
+
+bool World::addWall(Poly2& wall, int index) {
+    std::string wname = "wall";
+    
+    std::shared_ptr<physics2::PolygonObstacle> wallobj;
+    wall.setGeometry(Geometry::SOLID);
+
+    wallobj = physics2::PolygonObstacle::alloc(wall);
+    wallobj->setDebugColor(Color4::WHITE);
+    // You cannot add constant "".  Must stringify
+    wallobj->setName(std::string("wall")+cugl::strtool::to_string(index));
+    wallobj->setName(wname);
+    wallobj->setFriction(0.0);
+    wallobj->setRestitution(0.4);
+    // Set the physics attributes
+    wallobj->setBodyType(b2_staticBody);
+
+    wall *= _scale;
+    _walls.push_back(wallobj);
+    return true;
+}
+
+// Streams an array of {x, y, asset} objects, scaling each position
+bool World::loadPlacements(JsonParser& parser, std::vector<std::tuple<std::string,Vec2>>& result, float scale) {
+    while (parser.next() == JsonParser::Token::BeginObject) {
+        Vec2 pos;
+        std::string assetName;
+        for(auto token = parser.next(); token != JsonParser::Token::EndObject; token = parser.next()) {
+            if (token == JsonParser::Token::Error || token == JsonParser::Token::End) {
+                return false;
+            } else if (parser.key() == X_FIELD) {
+                pos.x = parser.asFloat()*scale;
+            } else if (parser.key() == Y_FIELD) {
+                pos.y = parser.asFloat()*scale;
+            } else if (parser.key() == ASSET_FIELD) {
+                assetName = parser.asString();
+            } else {
+                parser.skip();
+            }
+        }
+        result.push_back(std::make_tuple(assetName,pos));
+    }
+    return parser.token() == JsonParser::Token::EndArray;
+}
+
 bool World::loadDecoration(const std::shared_ptr<JsonValue> &json) {
     float xCoord = json->getFloat(X_FIELD) * globals::SCENE_TO_BOX2D;
     float yCoord = json->getFloat(Y_FIELD) * globals::SCENE_TO_BOX2D;
@@ -464,9 +734,9 @@ bool World::loadDecoration(const std::shared_ptr<JsonValue> &json) {
     return true;
 }
 
-bool World::loadStation(const std::shared_ptr<JsonValue> &json) {
-    float xCoord = json->getFloat(X_FIELD) * globals::SCENE_TO_BOX2D;
-    float yCoord = json->getFloat(Y_FIELD) * globals::SCENE_TO_BOX2D;
+bool World::loadStation(const Vec2& pos) {
+    float xCoord = pos.x;
+    float yCoord = pos.y;
     
     // **** NEED TO CHANGE SIZE, CANNOT ACCESS _ASSETS IN LOADS
     Vec2 swapStPos = Vec2(xCoord,yCoord);
@@ -475,9 +745,9 @@ bool World::loadStation(const std::shared_ptr<JsonValue> &json) {
     return true;
 }
 
-bool World::loadBooster(const std::shared_ptr<JsonValue>& json) {
-    float xCoord = json->getFloat(X_FIELD) * globals::SCENE_TO_BOX2D;
-    float yCoord = json->getFloat(Y_FIELD) * globals::SCENE_TO_BOX2D;
+bool World::loadBooster(const Vec2& pos) {
+    float xCoord = pos.x;
+    float yCoord = pos.y;
 
     // **** NEED TO CHANGE SIZE, CANNOT ACCESS _ASSETS IN LOADS
     Vec2 boosterPos = Vec2(xCoord, yCoord);
@@ -486,9 +756,9 @@ bool World::loadBooster(const std::shared_ptr<JsonValue>& json) {
     return true;
 }
 
-bool World::loadEgg(const std::shared_ptr<JsonValue> &json){
-    float xCoord = json->getFloat(X_FIELD) * globals::SCENE_TO_BOX2D;
-    float yCoord = json->getFloat(Y_FIELD) * globals::SCENE_TO_BOX2D;
+bool World::loadEgg(const Vec2& pos){
+    float xCoord = pos.x;
+    float yCoord = pos.y;
     
     // **** NEED TO CHANGE SIZE, CANNOT ACCESS _ASSETS IN LOADS
     
@@ -504,9 +774,9 @@ bool World::loadEgg(const std::shared_ptr<JsonValue> &json){
 }
 
 
-bool World::loadOrbActive(const std::shared_ptr<JsonValue> &json){
-    float xCoord = json->getFloat(X_FIELD) * globals::SCENE_TO_BOX2D;
-    float yCoord = json->getFloat(Y_FIELD) * globals::SCENE_TO_BOX2D;
+bool World::loadOrbActive(const Vec2& pos){
+    float xCoord = pos.x;
+    float yCoord = pos.y;
     
     // **** NEED TO CHANGE SIZE, CANNOT ACCESS _ASSETS IN LOADS
     
@@ -519,9 +789,9 @@ bool World::loadOrbActive(const std::shared_ptr<JsonValue> &json){
     return true;
 }
 
-bool World::loadOrbInactive(const std::shared_ptr<JsonValue> &json){
-    float xCoord = json->getFloat(X_FIELD) * globals::SCENE_TO_BOX2D;
-    float yCoord = json->getFloat(Y_FIELD) * globals::SCENE_TO_BOX2D;
+bool World::loadOrbInactive(const Vec2& pos){
+    float xCoord = pos.x;
+    float yCoord = pos.y;
     
     Vec2 orbPos = Vec2(xCoord,yCoord);
     
@@ -531,11 +801,10 @@ bool World::loadOrbInactive(const std::shared_ptr<JsonValue> &json){
 
 
 //Only get spawn locations from json. wait to load players until numplayers
-bool World::loadPlayerSpawn(const std::shared_ptr<JsonValue> &json) {
-    float xCoord = json->getFloat(X_FIELD) * globals::SCENE_TO_BOX2D;
-    float yCoord = json->getFloat(Y_FIELD) * globals::SCENE_TO_BOX2D;
+bool World::loadPlayerSpawn(const Vec2& pos, const std::string& e) {
+    float xCoord = pos.x;
+    float yCoord = pos.y;
     
-    auto e = json->getString("element");
     float ret = 0;
     if(e == "fire") {
         ret = 1;
@@ -556,49 +825,40 @@ bool World::loadPlayerSpawn(const std::shared_ptr<JsonValue> &json) {
 }
 
 GameObjectType World::getObjectType(std::string obj) {
-    if (obj == SWAP_STATION) {
-        return GameObjectType::Station;
-    } else if (obj == BOOSTER) {
-        return GameObjectType::Booster;
-    } else if (obj == EGG_SPAWN) {
-        return GameObjectType::EggSpawn;
-    }  else if (obj == ORB_ACTIVE) {
-        return GameObjectType::OrbActive;
-    } else if (obj == ORB_INACTIVE) {
-        return GameObjectType::OrbInactive;
-    } else {
-        return GameObjectType::PlayerSpawn;
-    }
+    return MapFile::getObjectType(obj);
 }
 
 //GameObjects are an array in json, need to sort loading by type
 bool World::loadGameObject(const std::shared_ptr<JsonValue>& json) {
+    Vec2 pos(json->getFloat(X_FIELD) * globals::SCENE_TO_BOX2D, json->getFloat(Y_FIELD) * globals::SCENE_TO_BOX2D);
+    return loadGameObject(getObjectType(json->getString(TYPE_FIELD)), pos, json->getString("element"));
+}
+
+bool World::loadGameObject(GameObjectType objectType, const Vec2& pos, const std::string& element) {
     bool success = false;
-    auto gameObject = json->getString(TYPE_FIELD);
-    GameObjectType objectType = getObjectType(gameObject);
     switch (objectType) {
         case GameObjectType::Station:
-            success = loadStation(json);
+            success = loadStation(pos);
             break;
 
         case GameObjectType::Booster:
-            success = loadBooster(json);
+            success = loadBooster(pos);
             break;
             
         case GameObjectType::EggSpawn:
-            success = loadEgg(json);
+            success = loadEgg(pos);
             break;
             
         case GameObjectType::OrbActive:
-            success = loadOrbActive(json);
+            success = loadOrbActive(pos);
             break;
             
         case  GameObjectType::OrbInactive:
-            success = loadOrbInactive(json);
+            success = loadOrbInactive(pos);
             break;
             
         case GameObjectType::PlayerSpawn:
-            success = loadPlayerSpawn(json);
+            success = loadPlayerSpawn(pos, element);
             break;
             
         default:
@@ -12,11 +12,13 @@
 #include <cugl/cugl.h>
 #include <cugl/assets/CUAsset.h>
 #include <cugl/io/CUJsonReader.h>
+#include <cugl/io/CUJsonParser.h>
 #include "Player.h"
 #include "Orb.h"
 #include "SwapStation.h"
 #include "Egg.h"
 #include "MapConstants.h"
+#include "MapFormat.h"
 #include "Booster.h"
 #include "Projectile.h"
 
@@ -89,21 +91,31 @@ protected:
 #pragma mark Internal Helpers
     bool loadPlayer(const int i, Vec2 loc);
     
-    bool loadPlayerSpawn(const std::shared_ptr<JsonValue>& json);
+    bool loadPlayerSpawn(const Vec2& pos, const std::string& element);
     
     bool loadWalls(const std::shared_ptr<JsonValue>& json);
     
+    bool loadWalls(JsonParser& parser);
+    
+    bool buildWall(const std::vector<Vec2>& points, int index);
+    
+    bool addWall(Poly2& wall, int index);
+    
+    bool loadPlacements(JsonParser& parser, std::vector<std::tuple<std::string,Vec2>>& result, float scale);
+    
     bool loadGameObject(const std::shared_ptr<JsonValue>& json);
     
-    bool loadOrbActive(const std::shared_ptr<JsonValue>& json);
+    bool loadGameObject(GameObjectType type, const Vec2& pos, const std::string& element);
     
-    bool loadOrbInactive(const std::shared_ptr<JsonValue>& json);
+    bool loadOrbActive(const Vec2& pos);
     
-    bool loadStation(const std::shared_ptr<JsonValue>& json);
+    bool loadOrbInactive(const Vec2& pos);
+    
+    bool loadStation(const Vec2& pos);
 
-    bool loadBooster(const std::shared_ptr<JsonValue>& json);
+    bool loadBooster(const Vec2& pos);
     
-    bool loadEgg(const std::shared_ptr<JsonValue>& json);
+    bool loadEgg(const Vec2& pos);
     
     bool loadBackground(const std::shared_ptr<JsonValue>& json);
     
@@ -365,12 +377,28 @@ public:
      * parallel, not in sequence.  If an asset (like a game level) has references to
      * other assets, then these should be connected later, during scene initialization.
      *
+     * If a compiled level (see MapFormat.h) sits next to the file, and it was
+     * compiled from the current contents of the file, it is loaded instead.
+     *
      * @param file the name of the source file to load from
      *
      * @return true if successfully loaded the asset from a file
      */
     virtual bool preload(const std::string& file) override;
 
+    /**
+     * Loads this game level by streaming a source Json file.
+     *
+     * This load method should NEVER access the AssetManager.  Assets are loaded in
+     * parallel, not in sequence.  If an asset (like a game level) has references to
+     * other assets, then these should be connected later, during scene initialization.
+     *
+     * @param parser the parser for the source file, positioned at the start
+     *
+     * @return true if successfully loaded the asset from the parser
+     */
+    bool preload(cugl::JsonParser& parser);
+
 
     /**
      * Loads this game level from a JsonValue containing all data from a source Json file.
@@ -385,6 +413,32 @@ public:
      */
     virtual bool preload(const std::shared_ptr<cugl::JsonValue>& json) override;
 
+    /**
+     * Loads this game level from a compiled level.
+     *
+     * The walls are already triangulated and every position is already in
+     * physics coordinates, so this only copies data out of the level.
+     *
+     * @param map the compiled level
+     *
+     * @return true if successfully loaded the asset from the compiled level
+     */
+    bool preload(const std::shared_ptr<MapFile>& map);
+
+    /**
+     * Returns true if this level has the same layout as the given one.
+     *
+     * This compares everything the loaders produce: the bounds, the walls, the
+     * game objects, the spawn points, the tiles and the decorations. It is used
+     * to check that a compiled level loads the same as its source file.
+     *
+     * @param other the level to compare against
+     * @param error set to the first difference found (if any)
+     *
+     * @return true if this level has the same layout as the given one
+     */
+    bool matches(const World& other, std::string& error) const;
+
     /**
      * Unloads this game level, releasing all sources
      *
@@ -0,0 +1,116 @@
+//
+//  MapCompiler.cpp
+//  Roshamboogie
+//
+//  Created on 10/18/26.
+//  Copyright © 2026 Game Design Initiative at Cornell. All rights reserved.
+//
+//  Offline compiler from Tiled JSON exports to compiled levels (MapFormat.h).
+//  Each input foo.json is written next to itself as foo.lvl, read back, and
+//  loaded into a World alongside the JSON as a sanity check. World::preload
+//  picks up the .lvl automatically, but ignores it once the JSON is re-exported,
+//  so rerun this whenever a map changes, commit the .lvl, and run maptest
+//  (MapTest.cpp) to check every shipped map.
+//
+//  This is a desktop tool, not part of the game build. The round trip loads
+//  World objects, so build it with every game source except main.cpp against
+//  the desktop CUGL library, e.g.
+//
+//      SOURCES=$(ls ../source/*.cpp | grep -v main.cpp)
+//      c++ -std=c++17 -I../cugl/include -I../source MapCompiler.cpp $SOURCES -L<cugl build> -lcugl -lSDL2 -o mapc
+//
+//  Usage: mapc [-o output.lvl] input.json...
+//
+
+#include <cugl/cugl.h>
+#include "MapFormat.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace cugl;
+
+static bool readFile(const std::string& path, std::string& result) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    result = ss.str();
+    return true;
+}
+
+static bool compileMap(const std::string& source, const std::string& dest) {
+    std::string text;
+    if (!readFile(source, text)) {
+        std::cerr << source << ": cannot read file\n";
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Uint8> bytes;
+    std::string error;
+    if (!MapFile::compile(text, bytes, error)) {
+        std::cerr << source << ": " << error << "\n";
+        return false;
+    }
+    std::ofstream out(dest, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    out.close();
+    if (!out) {
+        std::cerr << dest << ": cannot write file\n";
+        return false;
+    }
+
+    // Round trip: read the file back and compare what it loads with the JSON
+    std::string written;
+    std::shared_ptr<MapFile> map = std::make_shared<MapFile>();
+    if (!readFile(dest, written) ||
+        !map->initWithData(reinterpret_cast<const Uint8*>(written.data()), written.size())) {
+        std::cerr << dest << ": compiled level does not load\n";
+        return false;
+    } else if (!MapFile::verify(map, text, error)) {
+        std::cerr << dest << ": round trip failed: " << error << "\n";
+        return false;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const mapfile::Header& head = map->getHeader();
+    std::cout << dest << ": " << bytes.size() << " bytes, " << head.walls.count << " walls, "
+              << head.objects.count << " objects, " << head.tiles.count << " tiles in "
+              << head.chunkCols << "x" << head.chunkRows << " chunks, " << head.decorations.count
+              << " decorations (" << std::chrono::duration<double,std::milli>(end-start).count() << " ms)\n";
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string output;
+    std::vector<std::string> inputs;
+    for(int ii = 1; ii < argc; ii++) {
+        std::string arg = argv[ii];
+        if (arg == "-o" && ii+1 < argc) {
+            output = argv[++ii];
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty() || (!output.empty() && inputs.size() > 1)) {
+        std::cerr << "Usage: " << argv[0] << " [-o output" << MAP_EXTENSION << "] input.json...\n";
+        return 2;
+    }
+
+    bool success = true;
+    for(auto it = inputs.begin(); it != inputs.end(); ++it) {
+        std::string dest = output;
+        if (dest.empty()) {
+            size_t dot = it->rfind('.');
+            size_t slash = it->find_last_of("/\\");
+            dest = (dot == std::string::npos || (slash != std::string::npos && dot < slash)) ? *it : it->substr(0, dot);
+            dest += MAP_EXTENSION;
+        }
+        success = compileMap(*it, dest) && success;
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+//
+//  MapTest.cpp
+//  Roshamboogie
+//
+//  Created on 10/18/26.
+//  Copyright © 2026 Game Design Initiative at Cornell. All rights reserved.
+//
+//  Round-trip test for the compiled levels (MapFormat.h). For every map the
+//  game ships (MapConstants.h), this compiles the JSON export in memory, loads
+//  the result and the JSON into two Worlds, and checks that they match. It
+//  then does the same for the .lvl file checked in next to the JSON, which
+//  also fails if that file is stale. Run it after re-exporting a map (and
+//  rerunning mapc) or after changing World, MapFile or the physics scales.
+//
+//  This is a desktop tool, not part of the game build. Build it like mapc
+//  (see MapCompiler.cpp), e.g.
+//
+//      SOURCES=$(ls ../source/*.cpp | grep -v main.cpp)
+//      c++ -std=c++17 -I../cugl/include -I../source MapTest.cpp $SOURCES -L<cugl build> -lcugl -lSDL2 -o maptest
+//
+//  Usage: maptest [assets directory]     (default ../assets)
+//
+
+#include <cugl/cugl.h>
+#include "MapFormat.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace cugl;
+
+/** The maps loaded by the game, relative to the asset directory */
+static const char* SHIPPED_MAPS[] = {
+    GRASS_MAP_JSON, GRASS_MAP2_JSON, GRASS_MAP3_JSON, GRASS_MAP4_JSON
+};
+
+static bool readFile(const std::string& path, std::string& result) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    result = ss.str();
+    return true;
+}
+
+// Compiles the map in memory, and checks that it loads the same World as the JSON
+static bool testCompile(const std::string& source, const std::string& text) {
+    std::vector<Uint8> bytes;
+    std::string error;
+    if (!MapFile::compile(text, bytes, error)) {
+        std::cerr << source << ": does not compile: " << error << "\n";
+        return false;
+    }
+    std::shared_ptr<MapFile> map = std::make_shared<MapFile>();
+    if (!map->initWithData(bytes.data(), bytes.size())) {
+        std::cerr << source << ": compiled level does not load\n";
+        return false;
+    } else if (!MapFile::verify(map, text, error)) {
+        std::cerr << source << ": round trip failed: " << error << "\n";
+        return false;
+    }
+    return true;
+}
+
+// Checks that the .lvl file shipped with the map is current and loads the same World
+static bool testShipped(const std::string& source, const std::string& text) {
+    size_t dot = source.rfind('.');
+    std::string compiled = source.substr(0, dot)+MAP_EXTENSION;
+    std::string bytes;
+    std::string error;
+    std::shared_ptr<MapFile> map = std::make_shared<MapFile>();
+    if (!readFile(compiled, bytes)) {
+        std::cerr << compiled << ": missing; run mapc on " << source << "\n";
+        return false;
+    } else if (!map->initWithData(reinterpret_cast<const Uint8*>(bytes.data()), bytes.size())) {
+        std::cerr << compiled << ": does not load; run mapc on " << source << "\n";
+        return false;
+    } else if (!map->matchesSource(text.data(), text.size())) {
+        std::cerr << compiled << ": out of date; run mapc on " << source << "\n";
+        return false;
+    } else if (!MapFile::verify(map, text, error)) {
+        std::cerr << compiled << ": round trip failed: " << error << "\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string assets = argc > 1 ? argv[1] : "../assets";
+    if (argc > 2) {
+        std::cerr << "Usage: " << argv[0] << " [assets directory]\n";
+        return 2;
+    }
+
+    int failures = 0;
+    for(const char* name : SHIPPED_MAPS) {
+        std::string source = assets+"/"+name;
+        std::string text;
+        if (!readFile(source, text)) {
+            std::cerr << source << ": cannot read file\n";
+            failures++;
+            continue;
+        }
+        bool success = testCompile(source, text);
+        success = testShipped(source, text) && success;
+        std::cout << source << ": " << (success ? "ok" : "FAILED") << "\n";
+        failures += success ? 0 : 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+#!/bin/sh
+#
+#  compress_textures.sh
+#  Roshamboogie
+#
+#  Created on 10/18/26.
+#  Copyright © 2026 Game Design Initiative at Cornell. All rights reserved.
+#
+#  Offline converter from the PNGs in assets/textures to GPU compressed
+#  textures. Each foo.png is written next to itself as foo.ktx (ETC2) or
+#  foo.ktx2 (ASTC). TextureLoader picks up the compressed sibling whenever the
+#  graphics card supports its format, and falls back to the PNG otherwise, so
+#  the PNGs must stay in the asset directory. Rerun this whenever a texture
+#  changes; textures whose output is newer than the PNG are skipped.
+#
+#  This wraps the standard encoders, which must be on the PATH:
+#
+#      etc2    EtcTool (github.com/google/etc2comp)
+#      astc    toktx (KTX-Software 4.x, github.com/KhronosGroup/KTX-Software)
+#
+#  Textures that use mipmaps in assets.json should be converted with -m, as
+#  the compressed file must carry its own mipmap chain.
+#
+#  Usage: compress_textures.sh [-f etc2|astc] [-b blocksize] [-m] [directory]
+#
+#      -f   the output format (default etc2, which every OpenGLES 3 device has)
+#      -b   the ASTC block size (default 6x6; 4x4 is sharper, 8x8 smaller)
+#      -m   include a full mipmap chain
+#
+
+FORMAT=etc2
+BLOCK=6x6
+MIPMAPS=0
+
+while getopts "f:b:m" opt; do
+    case $opt in
+        f) FORMAT=$OPTARG ;;
+        b) BLOCK=$OPTARG ;;
+        m) MIPMAPS=1 ;;
+        *) sed -n 's/^#  Usage: //p' "$0"; exit 1 ;;
+    esac
+done
+shift $((OPTIND-1))
+
+DIR=${1:-$(dirname "$0")/../assets/textures}
+
+case $FORMAT in
+    etc2) SUFFIX=ktx;  TOOL=EtcTool ;;
+    astc) SUFFIX=ktx2; TOOL=toktx ;;
+    *) echo "Unknown format $FORMAT (expected etc2 or astc)"; exit 1 ;;
+esac
+
+if ! command -v $TOOL > /dev/null 2>&1; then
+    echo "$TOOL is not on the PATH"
+    exit 1
+fi
+
+# Number of levels down to 1x1 for the given image (EtcTool needs a count)
+levels() {
+    size=$(file "$1" | sed -n 's/.*, \([0-9]*\) x \([0-9]*\),.*/\1 \2/p')
+    set -- $size
+    n=1
+    m=$(( $1 > $2 ? $1 : $2 ))
+    while [ "$m" -gt 1 ]; do
+        m=$((m/2))
+        n=$((n+1))
+    done
+    echo $n
+}
+
+converted=0
+skipped=0
+failed=0
+before=0
+after=0
+for png in "$DIR"/*.png; do
+    [ -e "$png" ] || continue
+    out="${png%.png}.$SUFFIX"
+    if [ -e "$out" ] && [ "$out" -nt "$png" ]; then
+        skipped=$((skipped+1))
+        continue
+    fi
+
+    if [ $FORMAT = etc2 ]; then
+        set -- -format RGBA8 -effort 60
+        if [ $MIPMAPS = 1 ]; then
+            set -- "$@" -mipmaps $(levels "$png")
+        fi
+        EtcTool "$png" "$@" -output "$out" > /dev/null
+    else
+        set -- --t2 --encode astc --astc_blk_d $BLOCK --astc_quality medium --assign_oetf linear
+        if [ $MIPMAPS = 1 ]; then
+            set -- "$@" --genmipmap
+        fi
+        toktx "$@" "$out" "$png"
+    fi
+
+    if [ $? -ne 0 ] || [ ! -s "$out" ]; then
+        echo "Failed to convert $png"
+        rm -f "$out"
+        failed=$((failed+1))
+        continue
+    fi
+    before=$((before+$(wc -c < "$png")))
+    after=$((after+$(wc -c < "$out")))
+    converted=$((converted+1))
+done
+
+echo "Converted $converted textures ($before bytes of PNG to $after bytes of $SUFFIX)"
+echo "Skipped $skipped up-to-date textures, $failed failures"
+[ $failed -eq 0 ]